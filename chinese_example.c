@@ -1,104 +1,41 @@
 #include <gst/gst.h>
-#include <gst/codecparsers/gsth264parser.h>
 #include <stdint-gcc.h>
 
+#include "gst_sei_ntp.h"
 #include "h264_sei_ntp.h"
 
 // Taken from: https://blog.csdn.net/Cheers724/article/details/99822937
 
-static void need_data_callback(GstElement *appsrc, guint unused,
-                               gpointer udata) {
-  g_print("need_data_callback\r\n");
-  GstBuffer *buffer;
-  GstFlowReturn ret;
-  static uint64_t next_ms_time_insert_sei = 0;
-  struct timespec one_ms;
-  struct timespec rem;
-  uint8_t *h264_sei = NULL;
-  size_t length = 0;
-
-  one_ms.tv_sec = 0;
-  one_ms.tv_nsec = 10000000;
-
-  while(now_ms() <= next_ms_time_insert_sei) {
-    //g_print("sleep to wait time trigger\r\n");
-    nanosleep(&one_ms, &rem);
-  }
-
-  if(!h264_sei_ntp_new(&h264_sei, &length)) {
-    g_warning("h264_sei_ntp_new failed\r\n");
-    return;
-  }
-
-  if(h264_sei != NULL && length > 0) {
-    buffer = gst_buffer_new_allocate(NULL, START_CODE_PREFIX_BYTES + length, NULL);
-
-    if(buffer != NULL) {
-      uint8_t start_code_prefix[] = START_CODE_PREFIX;
-      size_t bytes_copied = gst_buffer_fill(buffer, START_CODE_PREFIX_BYTES, h264_sei, length);
-
-      if(bytes_copied == length) {
-        g_signal_emit_by_name(appsrc, "push-buffer", buffer, &ret);
-        g_print("H264 SEI NTP timestamp inserted\r\n");
-      } else {
-        g_warning("GstBuffer.fill without all bytes copied\r\n");
-      }
-    } else {
-      g_warning("gst_buffer_new_allocate failed\r\n");
-    }
-
-    gst_buffer_unref(buffer);
-  }
-
-  next_ms_time_insert_sei = now_ms() + 1000;
-  free(h264_sei);
-}
-
-static void handoff_callback(GstElement *identity, GstBuffer *buffer,
-                             gpointer user_data) {
-  //g_print("handoff_callback\r\n");
-  GstMapInfo info = GST_MAP_INFO_INIT;
-  GstH264NalParser *nalparser = NULL;
-  GstH264NalUnit nalu;
-
-  if(gst_buffer_map(buffer, &info, GST_MAP_READ)) {
-    nalparser = gst_h264_nal_parser_new();
-    if(nalparser != NULL) {
-      if(gst_h264_parser_identify_nalu_unchecked(nalparser, info.data, 0, info.size, &nalu) == GST_H264_PARSER_OK) {
-        if(nalu.type == GST_H264_NAL_SEI) {
-          g_print("identify sei nalu with size: %d offset: %d sc_offset: %d\r\n", nalu.size, nalu.offset, nalu.sc_offset);
-          int64_t delay = -1;
-
-          if(h264_sei_ntp_parse(nalu.data + nalu.offset, nalu.size, &delay)) {
-            g_print("delay: %ld ms\r\n", delay);
-          }
-        }
-      } else {
-        g_warning("gst_h264_parser_identify_nalu_unchecked failed");
-      }
-
-      gst_h264_nal_parser_free(nalparser);
-
-    } else {
-      g_warning("gst_h264_nal_parser_new failed\r\n");
-    }
-
-    gst_buffer_unmap(buffer, &info);
-  } else {
-    g_warning("gst_buffer_map failed\r\n");
-  }
-}
-/* OUT
-funnel name=f appsrc name=appsrc-h264-sei do-timestamp=true block=true is-live=true ! video/x-h264, stream-format=byte-stream, alignment=au ! queue ! f. \
-videotestsrc is-live=true ! x264enc ! video/x-h264, stream-format=byte-stream, alignment=au, profile=baseline ! queue ! f. \
-f. ! queue ! h264parse ! video/x-h264, stream-format=byte-stream, alignment=au ! rtph264pay ! udpsink sync=false clients=127.0.0.1:5004
+/* OUT, h264seistamp writes an SEI every 30 access units and every keyframe, right after the AUD
+videotestsrc is-live=true ! x264enc ! video/x-h264, stream-format=byte-stream, alignment=au, profile=baseline ! \
+h264seistamp interval=30 ! queue ! h264parse ! video/x-h264, stream-format=byte-stream, alignment=au ! rtph264pay ! udpsink sync=false clients=127.0.0.1:5004
 */
 
 /* IN
-udpsrc uri=udp://127.0.0.1:5004 caps="application/x-rtp, media=video, encoding-name=H264" ! rtph264depay ! video/x-h264, stream-format=byte-stream, alignment=nal ! identity name=identity ! fakesink
+udpsrc uri=udp://127.0.0.1:5004 caps="application/x-rtp, media=video, encoding-name=H264" ! rtph264depay ! video/x-h264, stream-format=byte-stream, alignment=nal ! h264seiextract ! fakesink
 */
 
-
+/* print the h264seiextract-stats element message */
+static void print_stats(const GstStructure *s) {
+  guint64 span = 0, count = 0, p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;
+
+  gst_structure_get_uint64(s, "span", &span);
+  gst_structure_get_uint64(s, "count", &count);
+  gst_structure_get_uint64(s, "p50", &p50);
+  gst_structure_get_uint64(s, "p90", &p90);
+  gst_structure_get_uint64(s, "p99", &p99);
+  gst_structure_get_uint64(s, "p999", &p999);
+  gst_structure_get_uint64(s, "max", &max);
+  g_print("delay over %" G_GUINT64_FORMAT " s: %" G_GUINT64_FORMAT " samples, p50 %.3f p90 %.3f p99 %.3f p999 %.3f max %.3f ms\r\n",
+          span / GST_SECOND, count, p50 / 1e6, p90 / 1e6, p99 / 1e6, p999 / 1e6, max / 1e6);
+  for(int i = H264_SEI_NTP_OK + 1; i < H264_SEI_NTP_STATUS_COUNT; i++) {
+    guint64 failures = 0;
+
+    if(gst_structure_get_uint64(s, h264_sei_ntp_status_name(i), &failures) && failures > 0) {
+      g_print("  %s: %" G_GUINT64_FORMAT "\r\n", h264_sei_ntp_status_name(i), failures);
+    }
+  }
+}
 
 int main(int argc, char **argv) {
   GstElement *pipeline;
@@ -108,36 +45,36 @@ int main(int argc, char **argv) {
   /* Initialize GStreamer */
   gst_init (&argc, &argv);
 
+  if(!gst_sei_ntp_register_static()) {
+    g_error("failed to register h264seistamp and h264seiextract");
+    return -1;
+  }
+
   /* Build the pipeline */
   pipeline =
     gst_parse_launch
-      ("funnel name=f appsrc name=appsrc-h264-sei do-timestamp=true block=true is-live=true ! video/x-h264, stream-format=byte-stream, alignment=au ! queue ! f. videotestsrc is-live=true ! x264enc ! video/x-h264, stream-format=byte-stream, alignment=au, profile=baseline ! queue ! f. f. ! queue ! h264parse ! video/x-h264, stream-format=byte-stream, alignment=au ! rtph264pay ! queue ! rtph264depay ! video/x-h264, stream-format=byte-stream, alignment=nal ! identity name=identity ! h264parse ! nvv4l2decoder ! nvvidconv ! xvimagesink",
+      ("videotestsrc is-live=true ! x264enc ! video/x-h264, stream-format=byte-stream, alignment=au, profile=baseline ! h264seistamp interval=30 ! queue ! h264parse ! video/x-h264, stream-format=byte-stream, alignment=au ! rtph264pay ! queue ! rtph264depay ! video/x-h264, stream-format=byte-stream, alignment=nal ! h264seiextract stats-interval=5000000000 ! h264parse ! nvv4l2decoder ! nvvidconv ! xvimagesink",
        NULL);
 
-  GstElement *appsrc = gst_bin_get_by_name(GST_BIN(pipeline), "appsrc-h264-sei");
-
-  if(!appsrc) {
-    g_error("failed to get appsrc");
+  if(!pipeline) {
+    g_error("failed to build the pipeline");
     return -1;
   }
 
-  g_signal_connect (appsrc, "need-data", G_CALLBACK (need_data_callback), NULL);
-
-  GstElement *identity = gst_bin_get_by_name(GST_BIN(pipeline), "identity");
-
-  if(!identity) {
-    g_error("failed to get identity");
-    return -1;
-  }
-
-  g_signal_connect (identity, "handoff", G_CALLBACK (handoff_callback), NULL);
-
   /* Start playing */
   gst_element_set_state (pipeline, GST_STATE_PLAYING);
 
-  /* Wait until error or EOS */
+  /* Wait until error or EOS, printing the stats h264seiextract posts on the way */
   bus = gst_element_get_bus (pipeline);
-  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE, GST_MESSAGE_ERROR | GST_MESSAGE_EOS);
+  while((msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE, GST_MESSAGE_ERROR | GST_MESSAGE_EOS | GST_MESSAGE_ELEMENT)) != NULL &&
+        GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ELEMENT) {
+    const GstStructure *s = gst_message_get_structure (msg);
+
+    if(s != NULL && gst_structure_has_name (s, "h264seiextract-stats")) {
+      print_stats (s);
+    }
+    gst_message_unref (msg);
+  }
 
   /* See next tutorial for proper error message handling/parsing */
   if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
@@ -0,0 +1,621 @@
+#include "gst_sei_ntp.h"
+#include <gst/base/gstbasetransform.h>
+#include <string.h>
+
+#include "h264bitstream/h264_stream.h"
+#include "h264_sei_ntp.h"
+#include "h264_sei_ntp_stats.h"
+
+#define GST_SEI_NTP_PACKAGE "videofilemetadata"
+#define GST_SEI_NTP_VERSION "1.0"
+#define GST_SEI_NTP_ORIGIN "https://github.com/DanHodge-Sechoia/VideoFileMetadata"
+
+#define DEFAULT_INTERVAL 30
+#define DEFAULT_KEYFRAMES TRUE
+#define DEFAULT_WINDOW 60
+#define DEFAULT_STATS_INTERVAL GST_SECOND
+#define DEFAULT_POST_DELAYS FALSE
+
+/* NALs looked at per find_nal_units() call */
+#define MAX_NALS_PER_SCAN 32
+
+#define H264_CAPS "video/x-h264, stream-format = (string) byte-stream, alignment = (string) { au, nal }"
+#define H265_CAPS "video/x-h265, stream-format = (string) byte-stream, alignment = (string) { au, nal }"
+
+static GstStaticPadTemplate h264_sink_template =
+  GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS(H264_CAPS));
+static GstStaticPadTemplate h264_src_template =
+  GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS(H264_CAPS));
+static GstStaticPadTemplate h265_sink_template =
+  GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS(H265_CAPS));
+static GstStaticPadTemplate h265_src_template =
+  GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS(H265_CAPS));
+
+/* H.265 NAL unit types, 7.4.2.2 */
+#define H265_NAL_UNIT_TYPE_BLA_W_LP 16
+#define H265_NAL_UNIT_TYPE_RSV_IRAP_23 23
+#define H265_NAL_UNIT_TYPE_RSV_VCL_31 31
+#define H265_NAL_UNIT_TYPE_AUD 35
+
+/* true if the caps say one NAL per buffer */
+static gboolean sei_ntp_caps_nal_aligned(GstCaps *caps) {
+  const gchar *alignment = gst_structure_get_string(gst_caps_get_structure(caps, 0), "alignment");
+  return g_strcmp0(alignment, "nal") == 0;
+}
+
+static int sei_ntp_nal_type(GstSeiNtpCodec codec, const guint8 *nal) {
+  return (codec == GST_SEI_NTP_H265) ? (nal[0] >> 1) & 0x3F : nal[0] & 0x1F;
+}
+
+static gboolean sei_ntp_is_sei(GstSeiNtpCodec codec, const guint8 *nal) {
+  return sei_ntp_nal_type(codec, nal) == ((codec == GST_SEI_NTP_H265) ? H265_NAL_UNIT_TYPE_PREFIX_SEI : NAL_UNIT_TYPE_SEI);
+}
+
+/*
+ * first slice of a picture: an H.264 coded slice whose first_mb_in_slice, ue(v) right after the header, is 0,
+ * or an H.265 VCL NAL with first_slice_segment_in_pic_flag set
+ */
+static gboolean sei_ntp_first_slice(GstSeiNtpCodec codec, const guint8 *nal, gsize size) {
+  int type = sei_ntp_nal_type(codec, nal);
+
+  if(codec == GST_SEI_NTP_H265) {
+    return type <= H265_NAL_UNIT_TYPE_RSV_VCL_31 && size > 2 && (nal[2] & 0x80);
+  }
+  return (type == NAL_UNIT_TYPE_CODED_SLICE_NON_IDR || type == NAL_UNIT_TYPE_CODED_SLICE_IDR) &&
+         size > 1 && (nal[1] & 0x80);
+}
+
+/* IDR slice, or H.265 IRAP picture */
+static gboolean sei_ntp_keyframe(GstSeiNtpCodec codec, const guint8 *nal) {
+  int type = sei_ntp_nal_type(codec, nal);
+
+  if(codec == GST_SEI_NTP_H265) {
+    return type >= H265_NAL_UNIT_TYPE_BLA_W_LP && type <= H265_NAL_UNIT_TYPE_RSV_IRAP_23;
+  }
+  return type == NAL_UNIT_TYPE_CODED_SLICE_IDR;
+}
+
+GstMemory *gst_sei_ntp_memory_new(GstSeiNtpCodec codec) {
+  uint8_t start_code[START_CODE_PREFIX_BYTES] = START_CODE_PREFIX;
+  GstMemory *memory;
+  GstMapInfo map;
+  size_t length;
+
+  memory = gst_allocator_alloc(NULL, START_CODE_PREFIX_BYTES + H264_SEI_NTP_MAX_SIZE, NULL);
+  if(memory == NULL) {
+    return NULL;
+  }
+  if(!gst_memory_map(memory, &map, GST_MAP_WRITE)) {
+    gst_memory_unref(memory);
+    return NULL;
+  }
+  memcpy(map.data, start_code, START_CODE_PREFIX_BYTES);
+  if(codec == GST_SEI_NTP_H265) {
+    length = h265_sei_ntp_write_ns(map.data + START_CODE_PREFIX_BYTES, H264_SEI_NTP_MAX_SIZE, h264_sei_ntp_now_ns());
+  } else {
+    length = h264_sei_ntp_write_ns(map.data + START_CODE_PREFIX_BYTES, H264_SEI_NTP_MAX_SIZE, h264_sei_ntp_now_ns());
+  }
+  gst_memory_unmap(memory, &map);
+  gst_memory_resize(memory, 0, START_CODE_PREFIX_BYTES + length);
+  return memory;
+}
+
+/*
+ * offset just past a leading access unit delimiter (start code, header, pic_type), 0 if there is none;
+ * the AUD NAL is 2 bytes in H.264 and 3 in H.265
+ */
+static gsize sei_ntp_splice_offset(GstSeiNtpCodec codec, GstBuffer *buffer) {
+  guint8 head[8];
+  gsize n = gst_buffer_extract(buffer, 0, head, sizeof(head));
+  gsize aud_size = (codec == GST_SEI_NTP_H265) ? 3 : 2;
+  int aud_type = (codec == GST_SEI_NTP_H265) ? H265_NAL_UNIT_TYPE_AUD : NAL_UNIT_TYPE_AUD;
+  gsize i = 0;
+
+  while(i < n && head[i] == 0x00) {
+    i++;
+  }
+  if(i < 2 || i + aud_size >= n || head[i] != 0x01 || sei_ntp_nal_type(codec, head + i + 1) != aud_type) {
+    return 0;
+  }
+  return i + 1 + aud_size;
+}
+
+gboolean gst_sei_ntp_splice(GstSeiNtpCodec codec, GstBuffer *buffer, GstMemory *sei) {
+  gsize offset = sei_ntp_splice_offset(codec, buffer);
+  guint idx, length;
+  gsize skip;
+
+  if(offset == 0) {
+    gst_buffer_prepend_memory(buffer, sei);
+    return TRUE;
+  }
+  if(offset >= gst_buffer_get_size(buffer)) {
+    gst_buffer_append_memory(buffer, sei);
+    return TRUE;
+  }
+  if(!gst_buffer_find_memory(buffer, offset, 1, &idx, &length, &skip)) {
+    gst_memory_unref(sei);
+    return FALSE;
+  }
+
+  /* the block holding the AUD is split where it ends, both halves share the original bytes */
+  if(skip > 0) {
+    GstMemory *memory = gst_buffer_peek_memory(buffer, idx);
+    GstMemory *tail = gst_memory_share(memory, skip, -1);
+
+    gst_buffer_replace_memory_range(buffer, idx, 1, gst_memory_share(memory, 0, skip));
+    gst_buffer_insert_memory(buffer, idx + 1, tail);
+    idx++;
+  }
+  gst_buffer_insert_memory(buffer, idx, sei);
+  return TRUE;
+}
+
+/*
+ * GstSeiNtpStamp, base of h264seistamp and h265seistamp
+ */
+
+typedef struct {
+  GstBaseTransform parent;
+  GstSeiNtpCodec codec;
+
+  guint interval;
+  gboolean keyframes;
+
+  gboolean nal_aligned;
+  guint units_since_stamp;
+} GstSeiNtpStamp;
+
+typedef struct {
+  GstBaseTransformClass parent_class;
+} GstSeiNtpStampClass;
+
+enum {
+  PROP_STAMP_0,
+  PROP_STAMP_INTERVAL,
+  PROP_STAMP_KEYFRAMES
+};
+
+G_DEFINE_ABSTRACT_TYPE(GstSeiNtpStamp, gst_sei_ntp_stamp, GST_TYPE_BASE_TRANSFORM);
+
+static void gst_sei_ntp_stamp_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec) {
+  GstSeiNtpStamp *self = (GstSeiNtpStamp *)object;
+
+  switch(prop_id) {
+    case PROP_STAMP_INTERVAL:
+      self->interval = g_value_get_uint(value);
+      break;
+    case PROP_STAMP_KEYFRAMES:
+      self->keyframes = g_value_get_boolean(value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+      break;
+  }
+}
+
+static void gst_sei_ntp_stamp_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec) {
+  GstSeiNtpStamp *self = (GstSeiNtpStamp *)object;
+
+  switch(prop_id) {
+    case PROP_STAMP_INTERVAL:
+      g_value_set_uint(value, self->interval);
+      break;
+    case PROP_STAMP_KEYFRAMES:
+      g_value_set_boolean(value, self->keyframes);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean gst_sei_ntp_stamp_set_caps(GstBaseTransform *trans, GstCaps *incaps, GstCaps *outcaps) {
+  GstSeiNtpStamp *self = (GstSeiNtpStamp *)trans;
+
+  self->nal_aligned = sei_ntp_caps_nal_aligned(incaps);
+  return TRUE;
+}
+
+static gboolean gst_sei_ntp_stamp_start(GstBaseTransform *trans) {
+  GstSeiNtpStamp *self = (GstSeiNtpStamp *)trans;
+
+  /* the first access unit is always stamped */
+  self->units_since_stamp = G_MAXUINT - 1;
+  return TRUE;
+}
+
+/* count one access unit, true if it gets a stamp */
+static gboolean gst_sei_ntp_stamp_due(GstSeiNtpStamp *self, gboolean keyframe) {
+  if(self->units_since_stamp < G_MAXUINT) {
+    self->units_since_stamp++;
+  }
+  if((keyframe && self->keyframes) || (self->interval > 0 && self->units_since_stamp >= self->interval)) {
+    self->units_since_stamp = 0;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static GstFlowReturn gst_sei_ntp_stamp_transform_ip(GstBaseTransform *trans, GstBuffer *buffer) {
+  GstSeiNtpStamp *self = (GstSeiNtpStamp *)trans;
+  GstMemory *memory;
+
+  if(!self->nal_aligned) {
+    /* one access unit per buffer: the SEI is spliced into the buffer, the frame is not copied */
+    if(!gst_sei_ntp_stamp_due(self, !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT))) {
+      return GST_FLOW_OK;
+    }
+    memory = gst_sei_ntp_memory_new(self->codec);
+    if(memory == NULL) {
+      GST_WARNING_OBJECT(self, "failed to allocate SEI");
+      return GST_FLOW_OK;
+    }
+    if(!gst_sei_ntp_splice(self->codec, buffer, memory)) {
+      GST_WARNING_OBJECT(self, "failed to splice SEI");
+    }
+    return GST_FLOW_OK;
+  }
+
+  /* one NAL per buffer: the SEI goes out as its own buffer just before the first slice of the picture */
+  GstMapInfo map;
+  gboolean first_slice = FALSE;
+  gboolean keyframe = FALSE;
+
+  if(gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    nal_pos_t nal;
+    if(find_nal_units(map.data, (int)map.size, &nal, 1, 1) == 1) {
+      first_slice = sei_ntp_first_slice(self->codec, map.data + nal.start, nal.end - nal.start);
+      keyframe = sei_ntp_keyframe(self->codec, map.data + nal.start);
+    }
+    gst_buffer_unmap(buffer, &map);
+  }
+  if(!first_slice || !gst_sei_ntp_stamp_due(self, keyframe)) {
+    return GST_FLOW_OK;
+  }
+
+  memory = gst_sei_ntp_memory_new(self->codec);
+  if(memory == NULL) {
+    GST_WARNING_OBJECT(self, "failed to allocate SEI");
+    return GST_FLOW_OK;
+  }
+
+  GstBuffer *sei = gst_buffer_new();
+  gst_buffer_append_memory(sei, memory);
+  GST_BUFFER_PTS(sei) = GST_BUFFER_PTS(buffer);
+  GST_BUFFER_DTS(sei) = GST_BUFFER_DTS(buffer);
+  GST_BUFFER_FLAG_SET(sei, GST_BUFFER_FLAG_DELTA_UNIT);
+  return gst_pad_push(GST_BASE_TRANSFORM_SRC_PAD(trans), sei);
+}
+
+static void gst_sei_ntp_stamp_class_init(GstSeiNtpStampClass *klass) {
+  GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+  GstBaseTransformClass *trans_class = GST_BASE_TRANSFORM_CLASS(klass);
+
+  gobject_class->set_property = gst_sei_ntp_stamp_set_property;
+  gobject_class->get_property = gst_sei_ntp_stamp_get_property;
+
+  g_object_class_install_property(gobject_class, PROP_STAMP_INTERVAL,
+    g_param_spec_uint("interval", "Interval", "Access units from one stamp to the next, 0 for keyframes only",
+                      0, G_MAXUINT, DEFAULT_INTERVAL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property(gobject_class, PROP_STAMP_KEYFRAMES,
+    g_param_spec_boolean("keyframes", "Keyframes", "Stamp every keyframe as well",
+                         DEFAULT_KEYFRAMES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  trans_class->set_caps = GST_DEBUG_FUNCPTR(gst_sei_ntp_stamp_set_caps);
+  trans_class->start = GST_DEBUG_FUNCPTR(gst_sei_ntp_stamp_start);
+  trans_class->transform_ip = GST_DEBUG_FUNCPTR(gst_sei_ntp_stamp_transform_ip);
+}
+
+static void gst_sei_ntp_stamp_init(GstSeiNtpStamp *self) {
+  self->interval = DEFAULT_INTERVAL;
+  self->keyframes = DEFAULT_KEYFRAMES;
+  gst_base_transform_set_in_place(GST_BASE_TRANSFORM(self), TRUE);
+}
+
+/*
+ * GstSeiNtpExtract, base of h264seiextract and h265seiextract
+ */
+
+typedef struct {
+  GstBaseTransform parent;
+  GstSeiNtpCodec codec;
+
+  guint window;
+  GstClockTime stats_interval;
+  gboolean post_delays;
+
+  h264_sei_ntp_stats_t *stats;
+  uint64_t next_stats_ns;
+} GstSeiNtpExtract;
+
+typedef struct {
+  GstBaseTransformClass parent_class;
+} GstSeiNtpExtractClass;
+
+enum {
+  PROP_EXTRACT_0,
+  PROP_EXTRACT_WINDOW,
+  PROP_EXTRACT_STATS_INTERVAL,
+  PROP_EXTRACT_POST_DELAYS
+};
+
+G_DEFINE_ABSTRACT_TYPE(GstSeiNtpExtract, gst_sei_ntp_extract, GST_TYPE_BASE_TRANSFORM);
+
+static void gst_sei_ntp_extract_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec) {
+  GstSeiNtpExtract *self = (GstSeiNtpExtract *)object;
+
+  switch(prop_id) {
+    case PROP_EXTRACT_WINDOW:
+      self->window = g_value_get_uint(value);
+      break;
+    case PROP_EXTRACT_STATS_INTERVAL:
+      self->stats_interval = g_value_get_uint64(value);
+      break;
+    case PROP_EXTRACT_POST_DELAYS:
+      self->post_delays = g_value_get_boolean(value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+      break;
+  }
+}
+
+static void gst_sei_ntp_extract_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec) {
+  GstSeiNtpExtract *self = (GstSeiNtpExtract *)object;
+
+  switch(prop_id) {
+    case PROP_EXTRACT_WINDOW:
+      g_value_set_uint(value, self->window);
+      break;
+    case PROP_EXTRACT_STATS_INTERVAL:
+      g_value_set_uint64(value, self->stats_interval);
+      break;
+    case PROP_EXTRACT_POST_DELAYS:
+      g_value_set_boolean(value, self->post_delays);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean gst_sei_ntp_extract_start(GstBaseTransform *trans) {
+  GstSeiNtpExtract *self = (GstSeiNtpExtract *)trans;
+
+  /* 1 s windows, window of them */
+  self->stats = h264_sei_ntp_stats_new(GST_SECOND, self->window > 0 ? (int)self->window : 1);
+  if(self->stats == NULL) {
+    GST_ELEMENT_ERROR(self, RESOURCE, FAILED, ("failed to allocate stats"), (NULL));
+    return FALSE;
+  }
+  self->next_stats_ns = h264_sei_ntp_now_ns() + self->stats_interval;
+  return TRUE;
+}
+
+static gboolean gst_sei_ntp_extract_stop(GstBaseTransform *trans) {
+  GstSeiNtpExtract *self = (GstSeiNtpExtract *)trans;
+
+  h264_sei_ntp_stats_free(self->stats);
+  self->stats = NULL;
+  return TRUE;
+}
+
+/*
+ * Element message "h264seiextract-stats" ("h265seiextract-stats"): count, p50, p90, p99, p999, max and span
+ * in ns over the window, and the failure counts since start by h264_sei_ntp_status_name().
+ */
+static void gst_sei_ntp_extract_post_stats(GstSeiNtpExtract *self) {
+  h264_sei_ntp_stats_snapshot_t snapshot;
+  GstStructure *s;
+
+  h264_sei_ntp_stats_snapshot(self->stats, 0, &snapshot);
+  s = gst_structure_new(self->codec == GST_SEI_NTP_H265 ? "h265seiextract-stats" : "h264seiextract-stats",
+                        "span", G_TYPE_UINT64, snapshot.span_ns,
+                        "count", G_TYPE_UINT64, snapshot.count,
+                        "p50", G_TYPE_UINT64, snapshot.p50_ns,
+                        "p90", G_TYPE_UINT64, snapshot.p90_ns,
+                        "p99", G_TYPE_UINT64, snapshot.p99_ns,
+                        "p999", G_TYPE_UINT64, snapshot.p999_ns,
+                        "max", G_TYPE_UINT64, snapshot.max_ns,
+                        NULL);
+  for(int i = H264_SEI_NTP_OK + 1; i < H264_SEI_NTP_STATUS_COUNT; i++) {
+    gst_structure_set(s, h264_sei_ntp_status_name(i), G_TYPE_UINT64, snapshot.status[i], NULL);
+  }
+  gst_element_post_message(GST_ELEMENT(self), gst_message_new_element(GST_OBJECT(self), s));
+}
+
+/* Element message "h264seiextract-delay" ("h265seiextract-delay"): delay in ns, the pts of the buffer it came in */
+static void gst_sei_ntp_extract_post_delay(GstSeiNtpExtract *self, GstBuffer *buffer, int64_t delay_ns) {
+  GstStructure *s = gst_structure_new(self->codec == GST_SEI_NTP_H265 ? "h265seiextract-delay" : "h264seiextract-delay",
+                                      "delay", G_TYPE_INT64, delay_ns,
+                                      "pts", G_TYPE_UINT64, GST_BUFFER_PTS(buffer),
+                                      NULL);
+  gst_element_post_message(GST_ELEMENT(self), gst_message_new_element(GST_OBJECT(self), s));
+}
+
+static GstFlowReturn gst_sei_ntp_extract_transform_ip(GstBaseTransform *trans, GstBuffer *buffer) {
+  GstSeiNtpExtract *self = (GstSeiNtpExtract *)trans;
+  nal_pos_t nals[MAX_NALS_PER_SCAN];
+  GstMapInfo map;
+  int offset = 0;
+  int n;
+
+  if(!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    return GST_FLOW_OK;
+  }
+
+  /* alignment=au or alignment=nal, every NAL in the buffer */
+  do {
+    n = find_nal_units(map.data + offset, (int)map.size - offset, nals, MAX_NALS_PER_SCAN, 1);
+    for(int i = 0; i < n; i++) {
+      const guint8 *nal = map.data + offset + nals[i].start;
+
+      int length = nals[i].end - nals[i].start;
+      int64_t delay_ns;
+      h264_sei_ntp_status_t status;
+
+      if(!sei_ntp_is_sei(self->codec, nal)) {
+        continue;
+      }
+      if(self->codec == GST_SEI_NTP_H265) {
+        status = h265_sei_ntp_check(nal, length, &delay_ns);
+      } else {
+        status = h264_sei_ntp_check(nal, length, &delay_ns);
+      }
+      if(status != H264_SEI_NTP_OK) {
+        h264_sei_ntp_stats_fail(self->stats, status);
+        continue;
+      }
+      h264_sei_ntp_stats_record(self->stats, delay_ns);
+      if(self->post_delays) {
+        gst_sei_ntp_extract_post_delay(self, buffer, delay_ns);
+      }
+    }
+    if(n > 0) {
+      offset += nals[n - 1].end;
+    }
+  } while(n == MAX_NALS_PER_SCAN);
+
+  gst_buffer_unmap(buffer, &map);
+
+  if(self->stats_interval > 0) {
+    uint64_t now = h264_sei_ntp_now_ns();
+    if(now >= self->next_stats_ns) {
+      self->next_stats_ns = now + self->stats_interval;
+      gst_sei_ntp_extract_post_stats(self);
+    }
+  }
+  return GST_FLOW_OK;
+}
+
+static void gst_sei_ntp_extract_class_init(GstSeiNtpExtractClass *klass) {
+  GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+  GstBaseTransformClass *trans_class = GST_BASE_TRANSFORM_CLASS(klass);
+
+  gobject_class->set_property = gst_sei_ntp_extract_set_property;
+  gobject_class->get_property = gst_sei_ntp_extract_get_property;
+
+  g_object_class_install_property(gobject_class, PROP_EXTRACT_WINDOW,
+    g_param_spec_uint("window", "Window", "Seconds of delays the percentiles are over",
+                      1, 3600, DEFAULT_WINDOW, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property(gobject_class, PROP_EXTRACT_STATS_INTERVAL,
+    g_param_spec_uint64("stats-interval", "Stats interval", "Time in ns from one stats message to the next, 0 for none",
+                        0, G_MAXUINT64, DEFAULT_STATS_INTERVAL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property(gobject_class, PROP_EXTRACT_POST_DELAYS,
+    g_param_spec_boolean("post-delays", "Post delays", "Post a message for every timestamp found",
+                         DEFAULT_POST_DELAYS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  trans_class->start = GST_DEBUG_FUNCPTR(gst_sei_ntp_extract_start);
+  trans_class->stop = GST_DEBUG_FUNCPTR(gst_sei_ntp_extract_stop);
+  trans_class->transform_ip = GST_DEBUG_FUNCPTR(gst_sei_ntp_extract_transform_ip);
+}
+
+static void gst_sei_ntp_extract_init(GstSeiNtpExtract *self) {
+  self->window = DEFAULT_WINDOW;
+  self->stats_interval = DEFAULT_STATS_INTERVAL;
+  self->post_delays = DEFAULT_POST_DELAYS;
+  /* reads only, buffers go through untouched */
+  gst_base_transform_set_passthrough(GST_BASE_TRANSFORM(self), TRUE);
+}
+
+/*
+ * h264seistamp, h265seistamp, h264seiextract, h265seiextract
+ */
+
+typedef struct {
+  GstSeiNtpStamp parent;
+} GstH264SeiStamp, GstH265SeiStamp;
+
+typedef struct {
+  GstSeiNtpStampClass parent_class;
+} GstH264SeiStampClass, GstH265SeiStampClass;
+
+typedef struct {
+  GstSeiNtpExtract parent;
+} GstH264SeiExtract, GstH265SeiExtract;
+
+typedef struct {
+  GstSeiNtpExtractClass parent_class;
+} GstH264SeiExtractClass, GstH265SeiExtractClass;
+
+G_DEFINE_TYPE(GstH264SeiStamp, gst_h264_sei_stamp, gst_sei_ntp_stamp_get_type());
+G_DEFINE_TYPE(GstH265SeiStamp, gst_h265_sei_stamp, gst_sei_ntp_stamp_get_type());
+G_DEFINE_TYPE(GstH264SeiExtract, gst_h264_sei_extract, gst_sei_ntp_extract_get_type());
+G_DEFINE_TYPE(GstH265SeiExtract, gst_h265_sei_extract, gst_sei_ntp_extract_get_type());
+
+static void gst_h264_sei_stamp_class_init(GstH264SeiStampClass *klass) {
+  GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+
+  gst_element_class_set_static_metadata(element_class, "H.264 SEI NTP timestamp stamper", "Filter/Video",
+                                        "Writes NTP timestamp SEI NALs into an H.264 stream", GST_SEI_NTP_ORIGIN);
+  gst_element_class_add_static_pad_template(element_class, &h264_sink_template);
+  gst_element_class_add_static_pad_template(element_class, &h264_src_template);
+}
+
+static void gst_h264_sei_stamp_init(GstH264SeiStamp *self) {
+  self->parent.codec = GST_SEI_NTP_H264;
+}
+
+static void gst_h265_sei_stamp_class_init(GstH265SeiStampClass *klass) {
+  GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+
+  gst_element_class_set_static_metadata(element_class, "H.265 SEI NTP timestamp stamper", "Filter/Video",
+                                        "Writes NTP timestamp prefix SEI NALs into an H.265 stream", GST_SEI_NTP_ORIGIN);
+  gst_element_class_add_static_pad_template(element_class, &h265_sink_template);
+  gst_element_class_add_static_pad_template(element_class, &h265_src_template);
+}
+
+static void gst_h265_sei_stamp_init(GstH265SeiStamp *self) {
+  self->parent.codec = GST_SEI_NTP_H265;
+}
+
+static void gst_h264_sei_extract_class_init(GstH264SeiExtractClass *klass) {
+  GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+
+  gst_element_class_set_static_metadata(element_class, "H.264 SEI NTP timestamp extractor", "Filter/Video",
+                                        "Measures the delay from NTP timestamp SEI NALs in an H.264 stream",
+                                        GST_SEI_NTP_ORIGIN);
+  gst_element_class_add_static_pad_template(element_class, &h264_sink_template);
+  gst_element_class_add_static_pad_template(element_class, &h264_src_template);
+}
+
+static void gst_h264_sei_extract_init(GstH264SeiExtract *self) {
+  self->parent.codec = GST_SEI_NTP_H264;
+}
+
+static void gst_h265_sei_extract_class_init(GstH265SeiExtractClass *klass) {
+  GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+
+  gst_element_class_set_static_metadata(element_class, "H.265 SEI NTP timestamp extractor", "Filter/Video",
+                                        "Measures the delay from NTP timestamp prefix SEI NALs in an H.265 stream",
+                                        GST_SEI_NTP_ORIGIN);
+  gst_element_class_add_static_pad_template(element_class, &h265_sink_template);
+  gst_element_class_add_static_pad_template(element_class, &h265_src_template);
+}
+
+static void gst_h265_sei_extract_init(GstH265SeiExtract *self) {
+  self->parent.codec = GST_SEI_NTP_H265;
+}
+
+/*
+ * plugin
+ */
+
+static gboolean plugin_init(GstPlugin *plugin) {
+  return gst_element_register(plugin, "h264seistamp", GST_RANK_NONE, GST_TYPE_H264_SEI_STAMP) &&
+         gst_element_register(plugin, "h264seiextract", GST_RANK_NONE, GST_TYPE_H264_SEI_EXTRACT) &&
+         gst_element_register(plugin, "h265seistamp", GST_RANK_NONE, GST_TYPE_H265_SEI_STAMP) &&
+         gst_element_register(plugin, "h265seiextract", GST_RANK_NONE, GST_TYPE_H265_SEI_EXTRACT);
+}
+
+gboolean gst_sei_ntp_register_static(void) {
+  return gst_plugin_register_static(GST_VERSION_MAJOR, GST_VERSION_MINOR, "seintp",
+                                    "SEI NTP timestamp stamping and extraction", plugin_init, GST_SEI_NTP_VERSION,
+                                    "LGPL", GST_SEI_NTP_PACKAGE, GST_SEI_NTP_PACKAGE, GST_SEI_NTP_ORIGIN);
+}
+
+#ifdef GST_SEI_NTP_PLUGIN
+GST_PLUGIN_DEFINE(GST_VERSION_MAJOR, GST_VERSION_MINOR, seintp, "SEI NTP timestamp stamping and extraction",
+                  plugin_init, GST_SEI_NTP_VERSION, "LGPL", GST_SEI_NTP_PACKAGE, GST_SEI_NTP_ORIGIN)
+#endif
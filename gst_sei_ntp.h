@@ -0,0 +1,44 @@
+#ifndef VIDEOFILEMETADATA__GST_SEI_NTP_H
+#define VIDEOFILEMETADATA__GST_SEI_NTP_H
+
+#include <gst/gst.h>
+
+/*
+ * GStreamer elements around h264_sei_ntp.c, for H.264 or H.265 byte-stream with alignment=au or alignment=nal:
+ *
+ * h264seistamp, h265seistamp      write an NTP timestamp SEI into every interval-th access unit and every keyframe
+ * h264seiextract, h265seiextract  find the NTP timestamp SEIs, record the delays and post them as element messages
+ *
+ * They work in place on the buffers going through, there is no signal emission per buffer.
+ */
+
+#define GST_TYPE_H264_SEI_STAMP (gst_h264_sei_stamp_get_type())
+#define GST_TYPE_H264_SEI_EXTRACT (gst_h264_sei_extract_get_type())
+#define GST_TYPE_H265_SEI_STAMP (gst_h265_sei_stamp_get_type())
+#define GST_TYPE_H265_SEI_EXTRACT (gst_h265_sei_extract_get_type())
+
+GType gst_h264_sei_stamp_get_type(void);
+GType gst_h264_sei_extract_get_type(void);
+GType gst_h265_sei_stamp_get_type(void);
+GType gst_h265_sei_extract_get_type(void);
+
+typedef enum {
+  GST_SEI_NTP_H264,
+  GST_SEI_NTP_H265
+} GstSeiNtpCodec;
+
+/* Start code and NTP timestamp SEI NAL stamped now, in a GstMemory of its own. NULL if allocation fails. */
+GstMemory *gst_sei_ntp_memory_new(GstSeiNtpCodec codec);
+
+/*
+ * Splice an SEI NAL (with start code, e.g. from gst_sei_ntp_memory_new()) into a writable access unit
+ * buffer in byte-stream format: right after the access unit delimiter if there is one, else in front.
+ * Only memory blocks are added and shared, the frame bytes are never copied; the cost does not depend
+ * on the frame size. Takes ownership of sei. FALSE if the buffer could not be split.
+ */
+gboolean gst_sei_ntp_splice(GstSeiNtpCodec codec, GstBuffer *buffer, GstMemory *sei);
+
+/* Make the elements available to gst_element_factory_make() and gst_parse_launch() in this process */
+gboolean gst_sei_ntp_register_static(void);
+
+#endif //VIDEOFILEMETADATA__GST_SEI_NTP_H
@@ -1,14 +1,21 @@
 #include "h264_sei_ntp.h"
 #include "h264bitstream/h264_stream.h"  //https://github.com/D-Y-Innovations/h264bitstream
-#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <glib.h>
 
-#define NALU_BUFFER_MAX_SIZE 50
-#define SEI_PAYLOAD_SIZE 24
+#define SEI_PAYLOAD_SIZE 24 /* H264_SEI_NTP_VERSION_MS: uuid, timestamp */
+#define SEI_PAYLOAD_SIZE_NS 25 /* H264_SEI_NTP_VERSION_NS: uuid, version, timestamp */
 #define H264_SEI_NTP_UUID_SIZE 16
 
+/* NAL header flavours the templates and the reader handle; only the header differs, the SEI messages are the same */
+enum {
+  SEI_NTP_H264,
+  SEI_NTP_H265,
+  SEI_NTP_CODECS
+};
+
 /*
  * start_code_prefix_one_3bytes: 0x000001
  * nal_unit_type: 0x06, Supplemetal enhancement information (SEI)
@@ -21,48 +28,157 @@
  * emulation_prevention_three_byte: 0x03
  */
 
+/*
+ * Wall clock time is CLOCK_MONOTONIC plus an offset to CLOCK_REALTIME taken once, so stamps never go
+ * backwards when the system clock is stepped, and each one costs a single vDSO clock_gettime.
+ */
+static int64_t sei_ntp_clock_offset_ns = 0;
+static gsize sei_ntp_clock_ready = 0;
+
+static int64_t sei_ntp_timespec_ns(const struct timespec *t) {
+  return (int64_t)t->tv_sec * 1000000000 + t->tv_nsec;
+}
+
+static void sei_ntp_clock_init() {
+  if(g_once_init_enter(&sei_ntp_clock_ready)) {
+    struct timespec m0, r, m1;
+    int64_t best = INT64_MAX;
+
+    /* realtime read between two monotonic reads, keep the tightest of a few tries */
+    for(int i = 0; i < 5; i++) {
+      clock_gettime(CLOCK_MONOTONIC, &m0);
+      clock_gettime(CLOCK_REALTIME, &r);
+      clock_gettime(CLOCK_MONOTONIC, &m1);
+      int64_t width = sei_ntp_timespec_ns(&m1) - sei_ntp_timespec_ns(&m0);
+      if(width < best) {
+        best = width;
+        sei_ntp_clock_offset_ns = sei_ntp_timespec_ns(&r) - (sei_ntp_timespec_ns(&m0) + width / 2);
+      }
+    }
+    g_once_init_leave(&sei_ntp_clock_ready, 1);
+  }
+}
+
+uint64_t h264_sei_ntp_now_ns() {
+  struct timespec t;
+
+  sei_ntp_clock_init();
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)(sei_ntp_timespec_ns(&t) + sei_ntp_clock_offset_ns);
+}
+
 uint64_t now_ms() {
-  long ms;
-  time_t s;
-  struct timespec spec;
+  /* rounded to the nearest ms, as before */
+  return (h264_sei_ntp_now_ns() + 500000) / 1000000;
+}
+
+/*
+ * Everything in front of the timestamp never changes, so it is escaped once per payload version.
+ * zeros is the number of zero bytes the escaped prefix ends with, the timestamp is escaped from there on.
+ */
+typedef struct {
+  uint8_t prefix[H264_SEI_NTP_MAX_SIZE];
+  size_t prefix_size;
+  int zeros;
+} sei_ntp_template_t;
+
+static sei_ntp_template_t sei_ntp_template[SEI_NTP_CODECS][2];
+static gsize sei_ntp_template_ready = 0;
+
+/* rbsp to nal: an emulation_prevention_three_byte goes in front of any byte <= 3 after two zero bytes */
+static size_t sei_ntp_escape(uint8_t *out, const uint8_t *in, size_t n, int *zeros) {
+  size_t j = 0;
+  for(size_t i = 0; i < n; i++) {
+    if(*zeros >= 2 && in[i] <= 0x03) {
+      out[j++] = 0x03;
+      *zeros = 0;
+    }
+    out[j++] = in[i];
+    *zeros = (in[i] == 0x00) ? *zeros + 1 : 0;
+  }
+  return j;
+}
+
+static void sei_ntp_template_init() {
+  if(g_once_init_enter(&sei_ntp_template_ready)) {
+    uint8_t sei_uuid[] = H264_SEI_UUID_NTP_TIMESTAMP;
+    uint8_t rbsp[6 + H264_SEI_NTP_UUID_SIZE];
+
+    for(int codec = 0; codec < SEI_NTP_CODECS; codec++) {
+      for(int version = 0; version < 2; version++) {
+        sei_ntp_template_t *t = &sei_ntp_template[codec][version];
+        size_t n = 0;
+
+        if(codec == SEI_NTP_H265) {
+          /* forbidden_zero_bit, nal_unit_type, nuh_layer_id 0, nuh_temporal_id_plus1 1 */
+          rbsp[n++] = H265_NAL_UNIT_TYPE_PREFIX_SEI << 1;
+          rbsp[n++] = 0x01;
+        } else {
+          rbsp[n++] = (NAL_REF_IDC_PRIORITY_DISPOSABLE << 5) | NAL_UNIT_TYPE_SEI;
+        }
+        rbsp[n++] = SEI_TYPE_USER_DATA_UNREGISTERED;
+        rbsp[n++] = (version == H264_SEI_NTP_VERSION_NS) ? SEI_PAYLOAD_SIZE_NS : SEI_PAYLOAD_SIZE;
+        memcpy(rbsp + n, sei_uuid, H264_SEI_NTP_UUID_SIZE);
+        n += H264_SEI_NTP_UUID_SIZE;
+        if(version == H264_SEI_NTP_VERSION_NS) {
+          rbsp[n++] = H264_SEI_NTP_VERSION_NS;
+        }
+
+        t->zeros = 0;
+        t->prefix_size = sei_ntp_escape(t->prefix, rbsp, n, &t->zeros);
+      }
+    }
+    g_once_init_leave(&sei_ntp_template_ready, 1);
+  }
+}
+
+static size_t sei_ntp_write(int codec, int version, uint8_t *buf, size_t size, uint64_t timestamp) {
+  const sei_ntp_template_t *t = &sei_ntp_template[codec][version];
+  uint8_t bytes[8];
+  size_t n;
+  int zeros;
 
-  clock_gettime(CLOCK_REALTIME, &spec);
+  sei_ntp_template_init();
 
-  s = spec.tv_sec;
-  ms = round(spec.tv_nsec / 1.0e6);
+  /* worst case: an escape for every other timestamp byte, and the rbsp_trailing_bits */
+  if(size < t->prefix_size + 2 * sizeof(bytes) + 1) {
+    return 0;
+  }
 
-  if(ms > 999) {
-    s++;
-    ms = 0;
+  /* little endian, as written by x86 hosts so far */
+  for(int i = 0; i < 8; i++) {
+    bytes[i] = (uint8_t)(timestamp >> (8 * i));
   }
 
-  return s * 1000 + ms;
+  memcpy(buf, t->prefix, t->prefix_size);
+  zeros = t->zeros;
+  n = t->prefix_size;
+  n += sei_ntp_escape(buf + n, bytes, sizeof(bytes), &zeros);
+  buf[n++] = 0x80; /* rbsp_stop_one_bit, alignment */
+  return n;
 }
 
-bool h264_sei_ntp_new(uint8_t **h264_sei, size_t *length) {
-  uint8_t sei_uuid[] = H264_SEI_UUID_NTP_TIMESTAMP;
-  uint8_t buffer[NALU_BUFFER_MAX_SIZE] = {0};
-  uint8_t payloadData[SEI_PAYLOAD_SIZE] = {0};
+size_t h264_sei_ntp_write(uint8_t *buf, size_t size, uint64_t timestamp_ms) {
+  return sei_ntp_write(SEI_NTP_H264, H264_SEI_NTP_VERSION_MS, buf, size, timestamp_ms);
+}
 
-  h264_stream_t *h264_nalu_sei = h264_new();
-  h264_nalu_sei->nal->nal_ref_idc = NAL_REF_IDC_PRIORITY_DISPOSABLE;
-  h264_nalu_sei->nal->nal_unit_type = NAL_UNIT_TYPE_SEI;
+size_t h264_sei_ntp_write_ns(uint8_t *buf, size_t size, uint64_t timestamp_ns) {
+  return sei_ntp_write(SEI_NTP_H264, H264_SEI_NTP_VERSION_NS, buf, size, timestamp_ns);
+}
 
-  memcpy(payloadData, sei_uuid, sizeof(sei_uuid));
-  uint64_t  milli_time = now_ms();
-  memcpy(&(payloadData[16]), &milli_time, sizeof(uint64_t));
+size_t h265_sei_ntp_write(uint8_t *buf, size_t size, uint64_t timestamp_ms) {
+  return sei_ntp_write(SEI_NTP_H265, H264_SEI_NTP_VERSION_MS, buf, size, timestamp_ms);
+}
 
-  sei_t *seis[1] = {sei_new()};
-  sei_t *sei = seis[0];
-  sei->payloadType = SEI_TYPE_USER_DATA_UNREGISTERED;
-  sei->payloadSize = SEI_PAYLOAD_SIZE;
-  sei->data = payloadData;
+size_t h265_sei_ntp_write_ns(uint8_t *buf, size_t size, uint64_t timestamp_ns) {
+  return sei_ntp_write(SEI_NTP_H265, H264_SEI_NTP_VERSION_NS, buf, size, timestamp_ns);
+}
 
-  h264_nalu_sei->seis = seis;
-  h264_nalu_sei->num_seis = 1;
+bool h264_sei_ntp_new(uint8_t **h264_sei, size_t *length) {
+  uint8_t buffer[H264_SEI_NTP_MAX_SIZE];
 
-  int len = write_nal_unit(h264_nalu_sei, buffer, NALU_BUFFER_MAX_SIZE);
-  if(len <= 0) {
+  size_t len = h264_sei_ntp_write(buffer, sizeof(buffer), now_ms());
+  if(len == 0) {
     g_print("len <= 0");
     return false;
   }
@@ -81,38 +197,190 @@ bool h264_sei_ntp_new(uint8_t **h264_sei, size_t *length) {
   return true;
 }
 
-bool h264_sei_ntp_parse(uint8_t *h264_sei, size_t length, int64_t *delay) {
+/* the 8 timestamp bytes, little endian */
+static uint64_t sei_ntp_timestamp(const uint8_t *p) {
+  uint64_t timestamp = 0;
+  for(int i = 7; i >= 0; i--) {
+    timestamp = (timestamp << 8) | p[i];
+  }
+  return timestamp;
+}
+
+/* ff_byte coded payloadType or payloadSize, 7.3.2.3.1 */
+static uint32_t sei_ntp_read_ff_coded(bs_t *b) {
+  uint32_t n = 0;
+  uint32_t byte;
+  while((byte = bs_read_u8(b)) == 0xFF && !bs_eof(b)) {
+    n += 255;
+  }
+  return n + byte;
+}
+
+/* timestamp as stored in the payload, ms or ns depending on version */
+static h264_sei_ntp_status_t sei_ntp_find(int codec, const uint8_t *nal, size_t length, uint64_t *timestamp,
+                                          int *version) {
   uint8_t sei_uuid[] = H264_SEI_UUID_NTP_TIMESTAMP;
+  uint8_t payload[SEI_PAYLOAD_SIZE_NS];
+  h264_sei_ntp_status_t status = H264_SEI_NTP_NO_TIMESTAMP;
+  bs_t b;
 
-  h264_stream_t *h264_nalu_sei = h264_new();
-  if(read_nal_unit(h264_nalu_sei, h264_sei, length) > 0) {
-    if(h264_nalu_sei->num_seis == 1) {
-      sei_t *sei = h264_nalu_sei->seis[0];
-      if(sei->payloadType == SEI_TYPE_USER_DATA_UNREGISTERED) {
-        if(sei->payloadSize == SEI_PAYLOAD_SIZE) {
-          if(memcmp(sei->data, sei_uuid, H264_SEI_NTP_UUID_SIZE) == 0) {
-            uint64_t timestamp = 0;
-            memcpy(&timestamp, sei->data + H264_SEI_NTP_UUID_SIZE, sizeof(timestamp));
-            *delay = now_ms() - timestamp;
-            if(*delay >= 0) {
-              return true;
-            } else {
-              printf("delay < 0\n");
-            }
-          } else {
-            printf("memcmp != 0\n");
-          }
-        } else {
-          printf("payloadSize !== SEI_PAYLOAD_SIZE\n");
+  int header_size = (codec == SEI_NTP_H265) ? 2 : 1;
+
+  if(length < (size_t)header_size + 1) {
+    return H264_SEI_NTP_NOT_SEI;
+  }
+  if(codec == SEI_NTP_H265 ? ((nal[0] >> 1) & 0x3F) != H265_NAL_UNIT_TYPE_PREFIX_SEI
+                           : (nal[0] & 0x1F) != NAL_UNIT_TYPE_SEI) {
+    return H264_SEI_NTP_NOT_SEI;
+  }
+
+  /* our own stamps: the NAL starts with an escaped template, only the timestamp needs unescaping */
+  sei_ntp_template_init();
+  for(int v = 0; v < 2; v++) {
+    const sei_ntp_template_t *t = &sei_ntp_template[codec][v];
+    if(length > t->prefix_size && memcmp(nal, t->prefix, t->prefix_size) == 0) {
+      size_t i = t->prefix_size;
+      int zeros = t->zeros;
+      int n = 0;
+      while(n < 8 && i < length) {
+        if(zeros >= 2 && nal[i] == 0x03) {
+          zeros = 0;
+          i++;
+          continue;
+        }
+        payload[n++] = nal[i];
+        zeros = (nal[i] == 0x00) ? zeros + 1 : 0;
+        i++;
+      }
+      if(n < 8) {
+        return H264_SEI_NTP_TRUNCATED;
+      }
+      *timestamp = sei_ntp_timestamp(payload);
+      *version = v;
+      return H264_SEI_NTP_OK;
+    }
+  }
+
+  /* read the rbsp straight from the escaped bytes, one sei_message at a time */
+  bs_init_nal(&b, (uint8_t *)nal + header_size, (int)length - header_size);
+  while(!bs_eof(&b)) {
+    /* rbsp_trailing_bits */
+    if(bs_bytes_left(&b) == 1 && bs_next_bits(&b, 8) == 0x80) {
+      break;
+    }
+
+    uint32_t payload_type = sei_ntp_read_ff_coded(&b);
+    uint32_t payload_size = sei_ntp_read_ff_coded(&b);
+    if(bs_overrun(&b)) {
+      return H264_SEI_NTP_TRUNCATED;
+    }
+
+    if(payload_type == SEI_TYPE_USER_DATA_UNREGISTERED &&
+       (payload_size == SEI_PAYLOAD_SIZE || payload_size == SEI_PAYLOAD_SIZE_NS)) {
+      if(bs_read_bytes(&b, payload, payload_size) != (int)payload_size) {
+        return H264_SEI_NTP_TRUNCATED;
+      }
+      if(memcmp(payload, sei_uuid, H264_SEI_NTP_UUID_SIZE) == 0) {
+        int v = (payload_size == SEI_PAYLOAD_SIZE) ? H264_SEI_NTP_VERSION_MS : payload[H264_SEI_NTP_UUID_SIZE];
+        if(v == H264_SEI_NTP_VERSION_MS || v == H264_SEI_NTP_VERSION_NS) {
+          *timestamp = sei_ntp_timestamp(payload + payload_size - 8);
+          *version = v;
+          return H264_SEI_NTP_OK;
         }
-      } else {
-        printf("payloadType !== SEI_TYPE_USER_DATA_UNREGISTERED\n");
+        /* from a newer writer, another message may still be one we know */
+        status = H264_SEI_NTP_UNKNOWN_VERSION;
       }
     } else {
-      printf("num_seis !== 1\n");
+      bs_skip_bytes(&b, (int)payload_size);
+      if(bs_overrun(&b)) {
+        return H264_SEI_NTP_TRUNCATED;
+      }
     }
+  }
+  return status;
+}
+
+static bool sei_ntp_find_ns(int codec, const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version) {
+  uint64_t timestamp;
+
+  if(sei_ntp_find(codec, nal, length, &timestamp, version) != H264_SEI_NTP_OK) {
+    return false;
+  }
+  *timestamp_ns = (*version == H264_SEI_NTP_VERSION_MS) ? timestamp * 1000000 : timestamp;
+  return true;
+}
+
+bool h264_sei_ntp_find_ns(const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version) {
+  return sei_ntp_find_ns(SEI_NTP_H264, nal, length, timestamp_ns, version);
+}
+
+bool h265_sei_ntp_find_ns(const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version) {
+  return sei_ntp_find_ns(SEI_NTP_H265, nal, length, timestamp_ns, version);
+}
+
+bool h264_sei_ntp_find(const uint8_t *nal, size_t length, uint64_t *timestamp_ms) {
+  uint64_t timestamp;
+  int version;
+
+  if(sei_ntp_find(SEI_NTP_H264, nal, length, &timestamp, &version) != H264_SEI_NTP_OK) {
+    return false;
+  }
+  *timestamp_ms = (version == H264_SEI_NTP_VERSION_MS) ? timestamp : timestamp / 1000000;
+  return true;
+}
+
+bool h264_sei_ntp_parse(uint8_t *h264_sei, size_t length, int64_t *delay) {
+  int64_t delay_ns;
+
+  if(!h264_sei_ntp_parse_ns(h264_sei, length, &delay_ns)) {
+    return false;
+  }
+  *delay = delay_ns / 1000000;
+  return true;
+}
+
+static h264_sei_ntp_status_t sei_ntp_check(int codec, const uint8_t *nal, size_t length, int64_t *delay_ns) {
+  h264_sei_ntp_status_t status;
+  uint64_t timestamp;
+  int version;
+
+  status = sei_ntp_find(codec, nal, length, &timestamp, &version);
+  if(status != H264_SEI_NTP_OK) {
+    return status;
+  }
+  /* a ms stamp was rounded to the nearest ms, compare it with the time rounded the same way */
+  if(version == H264_SEI_NTP_VERSION_MS) {
+    *delay_ns = (int64_t)(now_ms() - timestamp) * 1000000;
   } else {
-    printf("read_nal_unit <= 0\n");
+    *delay_ns = (int64_t)(h264_sei_ntp_now_ns() - timestamp);
+  }
+  return (*delay_ns >= 0) ? H264_SEI_NTP_OK : H264_SEI_NTP_FUTURE;
+}
+
+h264_sei_ntp_status_t h264_sei_ntp_check(const uint8_t *nal, size_t length, int64_t *delay_ns) {
+  return sei_ntp_check(SEI_NTP_H264, nal, length, delay_ns);
+}
+
+h264_sei_ntp_status_t h265_sei_ntp_check(const uint8_t *nal, size_t length, int64_t *delay_ns) {
+  return sei_ntp_check(SEI_NTP_H265, nal, length, delay_ns);
+}
+
+bool h264_sei_ntp_parse_ns(const uint8_t *h264_sei, size_t length, int64_t *delay_ns) {
+  return h264_sei_ntp_check(h264_sei, length, delay_ns) == H264_SEI_NTP_OK;
+}
+
+bool h265_sei_ntp_parse_ns(const uint8_t *h265_sei, size_t length, int64_t *delay_ns) {
+  return h265_sei_ntp_check(h265_sei, length, delay_ns) == H264_SEI_NTP_OK;
+}
+
+const char *h264_sei_ntp_status_name(h264_sei_ntp_status_t status) {
+  switch(status) {
+    case H264_SEI_NTP_OK: return "ok";
+    case H264_SEI_NTP_NOT_SEI: return "not_sei";
+    case H264_SEI_NTP_NO_TIMESTAMP: return "no_timestamp";
+    case H264_SEI_NTP_TRUNCATED: return "truncated";
+    case H264_SEI_NTP_UNKNOWN_VERSION: return "unknown_version";
+    case H264_SEI_NTP_FUTURE: return "future";
+    default: return "unknown";
   }
-  return false;
 }
@@ -13,10 +13,85 @@
 #define START_CODE_PREFIX_BYTES 4
 #define START_CODE_PREFIX { 0x00, 0x00, 0x00, 0x01 };
 
+/* H.265 prefix SEI, its NAL header is 2 bytes: forbidden_zero_bit, nal_unit_type(6), nuh_layer_id(6), nuh_temporal_id_plus1(3) */
+#define H265_NAL_UNIT_TYPE_PREFIX_SEI 39
+
+/* Upper bound on the size of the NAL written by h264_sei_ntp_write() and h265_sei_ntp_write(), start code not included */
+#define H264_SEI_NTP_MAX_SIZE 64
+
+/*
+ * Payload versions, after the 16 byte UUID:
+ * H264_SEI_NTP_VERSION_MS  (24 byte payload) 8 bytes ms since the Unix epoch, little endian
+ * H264_SEI_NTP_VERSION_NS  (25 byte payload) version byte 1, 8 bytes ns since the Unix epoch, little endian
+ * Readers that only know the 24 byte payload skip the newer one.
+ */
+#define H264_SEI_NTP_VERSION_MS 0
+#define H264_SEI_NTP_VERSION_NS 1
+
+/* Outcome of looking for a timestamp, see h264_sei_ntp_check() */
+typedef enum {
+  H264_SEI_NTP_OK = 0,
+  H264_SEI_NTP_NOT_SEI,          /* not an SEI NAL, or too short to hold one */
+  H264_SEI_NTP_NO_TIMESTAMP,     /* well formed SEI without the NTP timestamp message */
+  H264_SEI_NTP_TRUNCATED,        /* a message runs past the end of the NAL */
+  H264_SEI_NTP_UNKNOWN_VERSION,  /* NTP timestamp UUID with a payload version this reader does not know */
+  H264_SEI_NTP_FUTURE,           /* timestamp ahead of the local clock */
+  H264_SEI_NTP_STATUS_COUNT
+} h264_sei_ntp_status_t;
+
+/*
+ * Wall clock time in ns since the Unix epoch: CLOCK_MONOTONIC plus the offset to CLOCK_REALTIME taken
+ * on first use. It never goes backwards; a later step of the system clock is not followed.
+ */
+uint64_t h264_sei_ntp_now_ns();
+
+/* h264_sei_ntp_now_ns() rounded to ms */
 uint64_t now_ms();
 
+/*
+ * Write an NTP timestamp SEI NAL (without start code) into buf, from a template built once.
+ * Only the timestamp bytes are escaped on each call. Reentrant, allocates nothing.
+ * Returns the NAL size, or 0 if size is too small (H264_SEI_NTP_MAX_SIZE is always enough).
+ */
+size_t h264_sei_ntp_write(uint8_t *buf, size_t size, uint64_t timestamp_ms);
+
+/* Same as h264_sei_ntp_write(), with a H264_SEI_NTP_VERSION_NS payload */
+size_t h264_sei_ntp_write_ns(uint8_t *buf, size_t size, uint64_t timestamp_ns);
+
+/* Same as h264_sei_ntp_write() with the current time, into a malloc'ed buffer the caller frees */
 bool h264_sei_ntp_new(uint8_t **h264_sei, size_t *length);
 
+/*
+ * Look for the NTP timestamp message in an SEI NAL (without start code), among any number of SEI messages.
+ * Works on the escaped bytes directly and allocates nothing. Returns false if the NAL has no such message.
+ * version is set to the payload version found, ms stamps are returned in ns.
+ */
+bool h264_sei_ntp_find_ns(const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version);
+
+/* Same as h264_sei_ntp_find_ns(), in ms */
+bool h264_sei_ntp_find(const uint8_t *nal, size_t length, uint64_t *timestamp_ms);
+
+/* Delay in ms from the NTP timestamp in an SEI NAL to now, false if there is none or it is in the future */
 bool h264_sei_ntp_parse(uint8_t *h264_sei, size_t length, int64_t *delay);
 
+/* Same as h264_sei_ntp_parse(), in ns; sub-ms only for H264_SEI_NTP_VERSION_NS stamps */
+bool h264_sei_ntp_parse_ns(const uint8_t *h264_sei, size_t length, int64_t *delay_ns);
+
+/* Same as h264_sei_ntp_parse_ns(), with the reason it failed. Prints nothing. */
+h264_sei_ntp_status_t h264_sei_ntp_check(const uint8_t *nal, size_t length, int64_t *delay_ns);
+
+/*
+ * H.265 counterparts: the same UUID and payload versions in a prefix SEI NAL (type 39, nuh_layer_id 0,
+ * nuh_temporal_id_plus1 1 when written), with the same escaping and allocation free fast paths.
+ * The status codes are the h264_sei_ntp_status_t ones.
+ */
+size_t h265_sei_ntp_write(uint8_t *buf, size_t size, uint64_t timestamp_ms);
+size_t h265_sei_ntp_write_ns(uint8_t *buf, size_t size, uint64_t timestamp_ns);
+bool h265_sei_ntp_find_ns(const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version);
+bool h265_sei_ntp_parse_ns(const uint8_t *h265_sei, size_t length, int64_t *delay_ns);
+h264_sei_ntp_status_t h265_sei_ntp_check(const uint8_t *nal, size_t length, int64_t *delay_ns);
+
+/* Short lowercase name of a status, for logs and metrics labels */
+const char *h264_sei_ntp_status_name(h264_sei_ntp_status_t status);
+
 #endif //VIDEOFILEMETADATA__H264_SEI_NTP_H
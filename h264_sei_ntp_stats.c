@@ -0,0 +1,178 @@
+#include "h264_sei_ntp_stats.h"
+#include <stdlib.h>
+#include <glib.h>
+
+/*
+ * Bucket index of a delay v, HDR histogram style with 2^SUB_BITS sub-buckets per power of two:
+ * v < 2^(SUB_BITS + 1) is its own bucket, above that v is shifted down until it has SUB_BITS + 1 bits
+ * and the shift picks the group of sub-buckets.
+ */
+#define SUB_BITS 5
+#define SUB_COUNT (1 << SUB_BITS)
+#define MAX_SHIFT (40 - SUB_BITS - 1)
+#define BUCKETS ((MAX_SHIFT + 2) * SUB_COUNT)
+
+typedef struct {
+  gint epoch;  /* window number modulo 2^32 the counts are for */
+  gint count;
+  gint max_us;
+  gint buckets[BUCKETS];
+} sei_ntp_stats_window_t;
+
+struct h264_sei_ntp_stats {
+  uint64_t start_ns;
+  uint64_t window_ns;
+  int windows;
+  guint64 status[H264_SEI_NTP_STATUS_COUNT];  /* 64-bit, a 32-bit count wraps in months at high frame rates */
+  sei_ntp_stats_window_t window[];
+};
+
+static int sei_ntp_stats_bucket(uint64_t v) {
+  if(v < 2 * SUB_COUNT) {
+    return (int)v;
+  }
+  int shift = 63 - __builtin_clzll(v) - SUB_BITS;
+  return shift * SUB_COUNT + (int)(v >> shift);
+}
+
+/* largest delay that lands in bucket i */
+static uint64_t sei_ntp_stats_bucket_max(int i) {
+  if(i < 2 * SUB_COUNT) {
+    return (uint64_t)i;
+  }
+  int shift = i / SUB_COUNT - 1;
+  uint64_t sub = (uint64_t)(i - shift * SUB_COUNT);
+  return ((sub + 1) << shift) - 1;
+}
+
+static guint sei_ntp_stats_epoch(const h264_sei_ntp_stats_t *stats) {
+  return (guint)((h264_sei_ntp_now_ns() - stats->start_ns) / stats->window_ns);
+}
+
+h264_sei_ntp_stats_t *h264_sei_ntp_stats_new(uint64_t window_ns, int windows) {
+  if(window_ns == 0 || windows <= 0) {
+    return NULL;
+  }
+
+  /* calloc: every window starts out empty at epoch 0 */
+  h264_sei_ntp_stats_t *stats = calloc(1, sizeof(h264_sei_ntp_stats_t) + windows * sizeof(sei_ntp_stats_window_t));
+  if(stats == NULL) {
+    return NULL;
+  }
+
+  stats->start_ns = h264_sei_ntp_now_ns();
+  stats->window_ns = window_ns;
+  stats->windows = windows;
+  return stats;
+}
+
+void h264_sei_ntp_stats_free(h264_sei_ntp_stats_t *stats) {
+  free(stats);
+}
+
+void h264_sei_ntp_stats_record(h264_sei_ntp_stats_t *stats, int64_t delay_ns) {
+  if(delay_ns < 0) {
+    h264_sei_ntp_stats_fail(stats, H264_SEI_NTP_FUTURE);
+    return;
+  }
+
+  uint64_t v = ((uint64_t)delay_ns > H264_SEI_NTP_STATS_MAX_NS) ? H264_SEI_NTP_STATS_MAX_NS : (uint64_t)delay_ns;
+  guint epoch = sei_ntp_stats_epoch(stats);
+  sei_ntp_stats_window_t *w = &stats->window[epoch % stats->windows];
+  gint old = g_atomic_int_get(&w->epoch);
+
+  /* first delay of a new window: whoever moves the epoch forward empties the window it recycles */
+  if((guint)old != epoch && g_atomic_int_compare_and_exchange(&w->epoch, old, (gint)epoch)) {
+    for(int i = 0; i < BUCKETS; i++) {
+      g_atomic_int_set(&w->buckets[i], 0);
+    }
+    g_atomic_int_set(&w->max_us, 0);
+    g_atomic_int_set(&w->count, 0);
+  }
+
+  g_atomic_int_inc(&w->buckets[sei_ntp_stats_bucket(v)]);
+  g_atomic_int_inc(&w->count);
+
+  gint us = (gint)((v + 999) / 1000);
+  gint max;
+  do {
+    max = g_atomic_int_get(&w->max_us);
+  } while(us > max && !g_atomic_int_compare_and_exchange(&w->max_us, max, us));
+
+  __atomic_fetch_add(&stats->status[H264_SEI_NTP_OK], 1, __ATOMIC_RELAXED);
+}
+
+void h264_sei_ntp_stats_fail(h264_sei_ntp_stats_t *stats, h264_sei_ntp_status_t status) {
+  if(status <= H264_SEI_NTP_OK || status >= H264_SEI_NTP_STATUS_COUNT) {
+    return;
+  }
+  __atomic_fetch_add(&stats->status[status], 1, __ATOMIC_RELAXED);
+}
+
+h264_sei_ntp_status_t h264_sei_ntp_stats_check(h264_sei_ntp_stats_t *stats, const uint8_t *nal, size_t length,
+                                               int64_t *delay_ns) {
+  h264_sei_ntp_status_t status = h264_sei_ntp_check(nal, length, delay_ns);
+
+  if(status == H264_SEI_NTP_OK) {
+    h264_sei_ntp_stats_record(stats, *delay_ns);
+  } else {
+    h264_sei_ntp_stats_fail(stats, status);
+  }
+  return status;
+}
+
+/* smallest bucket bound with at least q of the count at or below it, capped by the max seen */
+static uint64_t sei_ntp_stats_percentile(const uint64_t *buckets, uint64_t count, uint64_t max_ns, double q) {
+  uint64_t target = (uint64_t)(q * count + 0.5);
+  uint64_t seen = 0;
+
+  if(target == 0) {
+    target = 1;
+  }
+  for(int i = 0; i < BUCKETS; i++) {
+    seen += buckets[i];
+    if(seen >= target) {
+      uint64_t v = sei_ntp_stats_bucket_max(i);
+      return (v < max_ns) ? v : max_ns;
+    }
+  }
+  return max_ns;
+}
+
+void h264_sei_ntp_stats_snapshot(h264_sei_ntp_stats_t *stats, int windows, h264_sei_ntp_stats_snapshot_t *snapshot) {
+  uint64_t buckets[BUCKETS] = { 0 };
+  uint64_t count = 0;
+  uint64_t max_us = 0;
+  guint epoch = sei_ntp_stats_epoch(stats);
+
+  if(windows <= 0 || windows > stats->windows) {
+    windows = stats->windows;
+  }
+
+  for(int k = 0; k < stats->windows; k++) {
+    sei_ntp_stats_window_t *w = &stats->window[k];
+
+    /* unsigned, so it still works once the window number wraps */
+    if(epoch - (guint)g_atomic_int_get(&w->epoch) >= (guint)windows) {
+      continue;
+    }
+    for(int i = 0; i < BUCKETS; i++) {
+      buckets[i] += (guint)g_atomic_int_get(&w->buckets[i]);
+    }
+    count += (guint)g_atomic_int_get(&w->count);
+    if((uint64_t)g_atomic_int_get(&w->max_us) > max_us) {
+      max_us = (uint64_t)g_atomic_int_get(&w->max_us);
+    }
+  }
+
+  snapshot->span_ns = (uint64_t)windows * stats->window_ns;
+  snapshot->count = count;
+  snapshot->max_ns = max_us * 1000;
+  snapshot->p50_ns = sei_ntp_stats_percentile(buckets, count, snapshot->max_ns, 0.50);
+  snapshot->p90_ns = sei_ntp_stats_percentile(buckets, count, snapshot->max_ns, 0.90);
+  snapshot->p99_ns = sei_ntp_stats_percentile(buckets, count, snapshot->max_ns, 0.99);
+  snapshot->p999_ns = sei_ntp_stats_percentile(buckets, count, snapshot->max_ns, 0.999);
+  for(int i = 0; i < H264_SEI_NTP_STATUS_COUNT; i++) {
+    snapshot->status[i] = __atomic_load_n(&stats->status[i], __ATOMIC_RELAXED);
+  }
+}
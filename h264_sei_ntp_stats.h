@@ -0,0 +1,56 @@
+#ifndef VIDEOFILEMETADATA__H264_SEI_NTP_STATS_H
+#define VIDEOFILEMETADATA__H264_SEI_NTP_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "h264_sei_ntp.h"
+
+/*
+ * Latency recorder for one stream, fed from the streaming thread and scraped from any other.
+ *
+ * Delays go into log buckets, HDR histogram style: 32 linear sub-buckets per power of two, so a
+ * percentile is within about 3% of the true value. Recording is a couple of atomic increments,
+ * never locks, allocates or prints. Buckets are kept per time window in a ring of windows, a
+ * snapshot merges the most recent ones. Failures are counted by h264_sei_ntp_status_t since creation, in 64 bits.
+ */
+
+/* Delays are clamped to 2^40 ns, about 18 minutes */
+#define H264_SEI_NTP_STATS_MAX_NS ((1ULL << 40) - 1)
+
+typedef struct h264_sei_ntp_stats h264_sei_ntp_stats_t;
+
+typedef struct {
+  uint64_t span_ns;     /* time covered by the merged windows, the current one included */
+  uint64_t count;       /* delays recorded in that time */
+  uint64_t p50_ns;
+  uint64_t p90_ns;
+  uint64_t p99_ns;
+  uint64_t p999_ns;
+  uint64_t max_ns;      /* to the us */
+  uint64_t status[H264_SEI_NTP_STATUS_COUNT];  /* since creation, status[H264_SEI_NTP_OK] is the number of delays */
+} h264_sei_ntp_stats_snapshot_t;
+
+/* windows of window_ns each are kept, e.g. 60 windows of 1 s for a one minute sliding window. NULL on failure. */
+h264_sei_ntp_stats_t *h264_sei_ntp_stats_new(uint64_t window_ns, int windows);
+
+void h264_sei_ntp_stats_free(h264_sei_ntp_stats_t *stats);
+
+/* Record a delay, negative ones count as H264_SEI_NTP_FUTURE */
+void h264_sei_ntp_stats_record(h264_sei_ntp_stats_t *stats, int64_t delay_ns);
+
+/* Count a failure to get a delay */
+void h264_sei_ntp_stats_fail(h264_sei_ntp_stats_t *stats, h264_sei_ntp_status_t status);
+
+/* h264_sei_ntp_check(), then record the delay or count the failure */
+h264_sei_ntp_status_t h264_sei_ntp_stats_check(h264_sei_ntp_stats_t *stats, const uint8_t *nal, size_t length,
+                                               int64_t *delay_ns);
+
+/*
+ * Percentiles over the last windows windows (all of them if windows <= 0 or larger than the ring), and the
+ * failure counts. Safe to call while another thread records; a window that is being recycled at that very
+ * moment may be counted partially.
+ */
+void h264_sei_ntp_stats_snapshot(h264_sei_ntp_stats_t *stats, int windows, h264_sei_ntp_stats_snapshot_t *snapshot);
+
+#endif //VIDEOFILEMETADATA__H264_SEI_NTP_STATS_H
@@ -37,6 +37,8 @@ typedef struct
 	uint8_t* p;
 	uint8_t* end;
 	int bits_left;
+	uint8_t* epb;   // NAL view only (see bs_init_nal()): no emulation prevention byte in [p, epb); NULL for plain buffers
+	int epb_count;  // NAL view only: number of emulation prevention bytes skipped so far
 } bs_t;
 
 #define _OPTIMIZE_BS_ 1
@@ -45,6 +47,9 @@ typedef struct
 #ifndef FAST_U8
 #define FAST_U8
 #endif
+#ifndef FAST_BITS
+#define FAST_BITS
+#endif
 #endif
 
 
@@ -52,6 +57,7 @@ static bs_t* bs_new(uint8_t* buf, size_t size);
 static void bs_free(bs_t* b);
 static bs_t* bs_clone( bs_t* dest, const bs_t* src );
 static bs_t*  bs_init(bs_t* b, uint8_t* buf, size_t size);
+static bs_t*  bs_init_nal(bs_t* b, uint8_t* buf, size_t size);
 static uint32_t bs_byte_aligned(bs_t* b);
 static int bs_eof(bs_t* b);
 static int bs_overrun(bs_t* b);
@@ -84,6 +90,8 @@ static inline bs_t* bs_init(bs_t* b, uint8_t* buf, size_t size)
     b->p = buf;
     b->end = buf + size;
     b->bits_left = 8;
+    b->epb = NULL;
+    b->epb_count = 0;
     return b;
 }
 
@@ -105,6 +113,8 @@ static inline bs_t* bs_clone(bs_t* dest, const bs_t* src)
     dest->p = src->p;
     dest->end = src->end;
     dest->bits_left = src->bits_left;
+    dest->epb = src->epb;
+    dest->epb_count = 0;
     return dest;
 }
 
@@ -117,10 +127,122 @@ static inline int bs_eof(bs_t* b) { if (b->p >= b->end) { return 1; } else { ret
 
 static inline int bs_overrun(bs_t* b) { if (b->p > b->end) { return 1; } else { return 0; } }
 
-static inline int bs_pos(bs_t* b) { if (b->p > b->end) { return (b->end - b->start); } else { return (b->p - b->start); } }
+static inline int bs_pos(bs_t* b) { if (b->p > b->end) { return (b->end - b->start - b->epb_count); } else { return (b->p - b->start - b->epb_count); } }
 
 static inline int bs_bytes_left(bs_t* b) { return (b->end - b->p); }
 
+/**
+ NAL view: the byte at q is an emulation prevention byte (the 0x03 in 0x000003).
+ Looks at the two bytes before q, which must be inside the NAL.
+ */
+static inline int _bs_is_epb(const uint8_t* q) { return q[0] == 0x03 && q[-1] == 0x00 && q[-2] == 0x00; }
+
+/**
+ NAL view: called when p reaches epb.  Skips the emulation prevention byte at p, if there is one,
+ and scans a little further ahead for the next one.
+ */
+static inline void _bs_epb_next(bs_t* b)
+{
+    uint8_t* q;
+    uint8_t* limit;
+
+    if (b->p < b->end && _bs_is_epb(b->p)) { b->p++; b->epb_count++; }
+
+    q = b->p;
+    limit = (b->end - q > 64) ? q + 64 : b->end;
+    while (q < limit && !_bs_is_epb(q)) { q++; }
+    b->epb = (q > b->p) ? q : b->end;
+}
+
+/**
+ Initialize a read-only view of a NAL unit, which reads the RBSP straight out of the NAL bytes
+ and skips emulation prevention bytes as they come up, instead of converting the NAL with nal_to_rbsp() first.
+ bs_pos() counts RBSP bytes.
+ */
+static inline bs_t* bs_init_nal(bs_t* b, uint8_t* buf, size_t size)
+{
+    uint8_t* q;
+    uint8_t* limit;
+
+    bs_init(b, buf, size);
+
+    // the first two bytes cannot be escapes, they would need two zero bytes before them
+    q = (size > 2) ? buf + 2 : b->end;
+    limit = (b->end - q > 64) ? q + 64 : b->end;
+    while (q < limit && !_bs_is_epb(q)) { q++; }
+    b->epb = q;
+    return b;
+}
+
+/**
+ Move to the next byte, skipping it if it is an emulation prevention byte.
+ */
+static inline void _bs_next_byte(bs_t* b)
+{
+    b->p++;
+    b->bits_left = 8;
+    if (b->p == b->epb) { _bs_epb_next(b); }
+}
+
+/**
+ The next n bytes can be read directly, without running into an emulation prevention byte.
+ */
+static inline int _bs_no_epb(bs_t* b, int n) { return (b->epb == NULL || b->epb - b->p >= n); }
+
+/**
+ Advance by n bits without looking at the data, other than to skip escapes in a NAL view.
+ */
+static inline void _bs_advance_bits(bs_t* b, int n)
+{
+    int pos = 8 - b->bits_left + n;
+    int bytes = pos >> 3;
+    b->bits_left = 8 - (pos & 7);
+
+    // in a NAL view, stop at each escape on the way
+    while (b->epb != NULL && bytes > 0 && b->p < b->end)
+    {
+        int k = (b->epb - b->p < bytes) ? (int)(b->epb - b->p) : bytes;
+        b->p += k;
+        bytes -= k;
+        if (b->p == b->epb) { _bs_epb_next(b); }
+    }
+    b->p += bytes;
+}
+
+#ifdef FAST_BITS
+/**
+ Load the 64 bits starting at the current byte, most significant bit first.
+ Bytes past the end of the buffer read as zero, same as bs_read_u1() does.
+ */
+static inline uint64_t _bs_load_u64(bs_t* b)
+{
+    uint64_t w = 0;
+    int i;
+    int n = 8;
+
+    if (b->end - b->p < 8)
+    {
+        n = (b->p < b->end) ? (int)(b->end - b->p) : 0;
+    }
+    for (i = 0; i < n; i++)
+    {
+        w |= (uint64_t)b->p[i] << (56 - 8*i);
+    }
+    return w;
+}
+
+static inline int _bs_clz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & 0x8000000000000000ULL)) { x <<= 1; n++; }
+    return n;
+#endif
+}
+#endif
+
 static inline uint32_t bs_read_u1(bs_t* b)
 {
     uint32_t r = 0;
@@ -132,7 +254,7 @@ static inline uint32_t bs_read_u1(bs_t* b)
         r = ((*(b->p)) >> b->bits_left) & 0x01;
     }
 
-    if (b->bits_left == 0) { b->p ++; b->bits_left = 8; }
+    if (b->bits_left == 0) { _bs_next_byte(b); }
 
     return r;
 }
@@ -140,7 +262,7 @@ static inline uint32_t bs_read_u1(bs_t* b)
 static inline void bs_skip_u1(bs_t* b)
 {    
     b->bits_left--;
-    if (b->bits_left == 0) { b->p ++; b->bits_left = 8; }
+    if (b->bits_left == 0) { _bs_next_byte(b); }
 }
 
 static inline uint32_t bs_peek_u1(bs_t* b)
@@ -159,6 +281,15 @@ static inline uint32_t bs_read_u(bs_t* b, int n)
 {
     uint32_t r = 0;
     int i;
+#ifdef FAST_BITS
+    // at most 7 bits already consumed + 32 bits requested, always fits in one 64-bit load
+    if (n > 0 && n <= 32 && _bs_no_epb(b, 5))
+    {
+        uint64_t w = _bs_load_u64(b) << (8 - b->bits_left);
+        _bs_advance_bits(b, n);
+        return (uint32_t)(w >> (64 - n));
+    }
+#endif
     for (i = 0; i < n; i++)
     {
         r |= ( bs_read_u1(b) << ( n - i - 1 ) );
@@ -169,6 +300,13 @@ static inline uint32_t bs_read_u(bs_t* b, int n)
 static inline void bs_skip_u(bs_t* b, int n)
 {
     int i;
+#ifdef FAST_BITS
+    if (n > 0)
+    {
+        _bs_advance_bits(b, n);
+        return;
+    }
+#endif
     for ( i = 0; i < n; i++ ) 
     {
         bs_skip_u1( b );
@@ -183,7 +321,7 @@ static inline uint32_t bs_read_u8(bs_t* b)
     if (b->bits_left == 8 && ! bs_eof(b)) // can do fast read
     {
         uint32_t r = b->p[0];
-        b->p++;
+        _bs_next_byte(b);
         return r;
     }
 #endif
@@ -195,6 +333,21 @@ static inline uint32_t bs_read_ue(bs_t* b)
     int32_t r = 0;
     int i = 0;
 
+#ifdef FAST_BITS
+    // codes up to 31 bits long, with at least 8 bytes left so that the end of the buffer
+    // cannot cut the prefix short; everything else goes through the bit-by-bit loop below
+    if (b->end - b->p >= 8 && _bs_no_epb(b, 5))
+    {
+        uint64_t w = _bs_load_u64(b) << (8 - b->bits_left);
+        if (w >= (1ULL << 48))
+        {
+            int len = 2 * _bs_clz64(w) + 1;
+            _bs_advance_bits(b, len);
+            return (uint32_t)(w >> (64 - len)) - 1;
+        }
+    }
+#endif
+
     while( (bs_read_u1(b) == 0) && (i < 32) && (!bs_eof(b)) )
     {
         i++;
@@ -204,7 +357,34 @@ static inline uint32_t bs_read_ue(bs_t* b)
     return r;
 }
 
-static inline int32_t bs_read_se(bs_t* b) 
+static inline void bs_skip_ue(bs_t* b)
+{
+    int i = 0;
+
+#ifdef FAST_BITS
+    // unlike bs_read_ue(), only the bytes the code is in need to be there and free of escapes,
+    // so that short NALs and the last bytes of a header don't fall back to the loop below
+    uint64_t w = _bs_load_u64(b) << (8 - b->bits_left);
+    if (w >= (1ULL << 48))
+    {
+        int len = 2 * _bs_clz64(w) + 1;
+        int bytes = (8 - b->bits_left + len + 7) >> 3;
+        if (b->end - b->p >= bytes && _bs_no_epb(b, bytes))
+        {
+            _bs_advance_bits(b, len);
+            return;
+        }
+    }
+#endif
+
+    while( (bs_read_u1(b) == 0) && (i < 32) && (!bs_eof(b)) )
+    {
+        i++;
+    }
+    bs_skip_u(b, i);
+}
+
+static inline int32_t bs_read_se(bs_t* b)
 {
     int32_t r = bs_read_ue(b);
     if (r & 0x01)
@@ -238,6 +418,22 @@ static inline void bs_write_u1(bs_t* b, uint32_t v)
 static inline void bs_write_u(bs_t* b, int n, uint32_t v)
 {
     int i;
+#ifdef FAST_BITS
+    // merge the field into the (at most 5) bytes it touches with one 64-bit read-modify-write,
+    // keeping the other bits of the first and last byte as bs_write_u1() does
+    int pos = 8 - b->bits_left;
+    int nbytes = (pos + n + 7) >> 3;
+    if (n > 0 && n <= 32 && b->p < b->end && b->end - b->p >= nbytes)
+    {
+        uint64_t mask = (0xFFFFFFFFFFFFFFFFULL >> (64 - n)) << (64 - pos - n);
+        uint64_t w = 0;
+        for (i = 0; i < nbytes; i++) { w |= (uint64_t)b->p[i] << (56 - 8*i); }
+        w = (w & ~mask) | (((uint64_t)v << (64 - pos - n)) & mask);
+        for (i = 0; i < nbytes; i++) { b->p[i] = (uint8_t)(w >> (56 - 8*i)); }
+        _bs_advance_bits(b, n);
+        return;
+    }
+#endif
     for (i = 0; i < n; i++)
     {
         bs_write_u1(b, (v >> ( n - i - 1 ))&0x01 );
@@ -312,7 +508,16 @@ static inline void bs_write_ue(bs_t* b, uint32_t v)
             len = len_table[ v ];
         }
 
-        bs_write_u(b, 2*len-1, v);
+        if (len > 16)
+        {
+            // codes longer than 32 bits: leading zeros first, then the value itself
+            bs_write_u(b, len-1, 0);
+            bs_write_u(b, len, v);
+        }
+        else
+        {
+            bs_write_u(b, 2*len-1, v);
+        }
     }
 }
 
@@ -331,6 +536,21 @@ static inline void bs_write_se(bs_t* b, int32_t v)
 static inline int bs_read_bytes(bs_t* b, uint8_t* buf, int len)
 {
     int actual_len = len;
+    if (b->epb != NULL)
+    {
+        // NAL view, copy the runs between escapes
+        actual_len = 0;
+        while (actual_len < len && b->p < b->end)
+        {
+            int k = (b->epb - b->p < len - actual_len) ? (int)(b->epb - b->p) : len - actual_len;
+            memcpy(buf + actual_len, b->p, k);
+            actual_len += k;
+            b->p += k;
+            if (b->p == b->epb) { _bs_epb_next(b); }
+        }
+        if (len > actual_len) { b->p += len - actual_len; }
+        return actual_len;
+    }
     if (b->end - b->p < actual_len) { actual_len = b->end - b->p; }
     if (actual_len < 0) { actual_len = 0; }
     memcpy(buf, b->p, actual_len);
@@ -342,8 +562,15 @@ static inline int bs_read_bytes(bs_t* b, uint8_t* buf, int len)
 static inline int bs_write_bytes(bs_t* b, uint8_t* buf, int len)
 {
     int actual_len = len;
+    int i;
     if (b->end - b->p < actual_len) { actual_len = b->end - b->p; }
     if (actual_len < 0) { actual_len = 0; }
+    if (! bs_byte_aligned(b))
+    {
+        // not aligned, shift each byte into place
+        for (i = 0; i < len; i++) { bs_write_u8(b, buf[i]); }
+        return actual_len;
+    }
     memcpy(b->p, buf, actual_len);
     if (len < 0) { len = 0; }
     b->p += len;
@@ -356,6 +583,7 @@ static inline int bs_skip_bytes(bs_t* b, int len)
     if (b->end - b->p < actual_len) { actual_len = b->end - b->p; }
     if (actual_len < 0) { actual_len = 0; }
     if (len < 0) { len = 0; }
+    if (b->epb != NULL) { _bs_advance_bits(b, 8*len); return actual_len; }
     b->p += len;
     return actual_len;
 }
@@ -374,6 +602,13 @@ static inline uint64_t bs_next_bytes(bs_t* bs, int nbytes)
 
    if ( (nbytes > 8) || (nbytes < 1) ) { return 0; }
    if (bs->p + nbytes > bs->end) { return 0; }
+   if (! _bs_no_epb(bs, nbytes))
+   {
+      bs_t b;
+      bs_clone(&b, bs);
+      for ( i = 0; i < nbytes; i++ ) { val = ( val << 8 ) | bs_read_u8(&b); }
+      return val;
+   }
 
    for ( i = 0; i < nbytes; i++ ) { val = ( val << 8 ) | bs->p[i]; }
    return val;
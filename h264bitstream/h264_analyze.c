@@ -19,7 +19,10 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "h264_stream.h"
+#include "h264_nal_reader.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -29,6 +32,12 @@
 
 #define BUFSIZE 32*1024*1024
 
+#if (defined(__unix__) || defined(__APPLE__))
+#define HAVE_PTHREAD
+
+#include <pthread.h>
+#endif
+
 #if (defined(__GNUC__))
 #define HAVE_GETOPT_LONG
 
@@ -41,6 +50,10 @@ static struct option long_options[] =
     { "output",  required_argument, NULL, 'o'},
     { "help",    no_argument,       NULL, 'h'},
     { "verbose", required_argument, NULL, 'v'},
+    { "depth",   required_argument, NULL, 'd'},
+    { "mmap",    no_argument,       NULL, 'm'},
+    { "jobs",    required_argument, NULL, 'j'},
+    { "format",  required_argument, NULL, 'f'},
 };
 #endif
 
@@ -48,6 +61,10 @@ static char options[] =
 "\t-o output_file, defaults to test.264\n"
 "\t-v verbose_level, print more info\n"
 "\t-p print codec for HTML5 video tag's codecs parameter, per RFC6381\n"
+"\t-d parse_depth, 0 for NAL headers only, 1 for all headers (default), 2 to also copy slice data\n"
+"\t-m map the input file into memory instead of reading it, for large files (regular files only)\n"
+"\t-j jobs, read NALs in this many threads at once (the output is the same)\n"
+"\t-f format, text (default), json (one object per NAL per line), binary (see h264_debug.h) or null (no output)\n"
 "\t-h print this message and exit\n";
 
 void usage( )
@@ -60,18 +77,308 @@ void usage( )
     fprintf( stderr, "h264_analyze [options] <input bitstream>\noptions:\n%s\n", options);
 }
 
+static int opt_verbose = 1;
+static int opt_probe = 0;
+static int opt_format = H264_DEBUG_TEXT;
+
+// next NAL from the reader, or 0 at the end of the stream
+static int next_nal(nal_reader_t* reader, nal_view_t* nal)
+{
+    int rc;
+    while ((rc = nal_reader_next(reader, nal)) != NAL_READER_END)
+    {
+        if (rc == NAL_READER_ERROR) { fprintf( stderr, "!! Error: read failed: %s \n", strerror(errno)); break; }
+
+        if (rc == NAL_READER_DISCARDED)
+        {
+            fprintf( stderr, "!! Did not find any NALs between offset %lld (0x%04llX), size %lld (0x%04llX), discarding \n",
+                   (long long int)nal->offset,
+                   (long long int)nal->offset,
+                   (long long int)nal->offset + nal->size,
+                   (long long int)nal->offset + nal->size);
+            continue;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// read one NAL and send it to the debug sink, 1 when probing and there is nothing more to read
+static int analyze_nal(h264_stream_t* h, nal_view_t* nal)
+{
+    // the other formats need to know where each NAL starts
+    if ( opt_verbose > 0 || opt_format != H264_DEBUG_TEXT )
+    {
+        h264_debug_nal(nal->offset, nal->size);
+    }
+
+    read_debug_nal_unit(h, nal->data, nal->size);
+
+    if ( opt_probe && h->nal->nal_unit_type == NAL_UNIT_TYPE_SPS )
+    {
+        // print codec parameter, per RFC 6381.
+        int constraint_byte = h->sps->constraint_set0_flag << 7;
+        constraint_byte = h->sps->constraint_set1_flag << 6;
+        constraint_byte = h->sps->constraint_set2_flag << 5;
+        constraint_byte = h->sps->constraint_set3_flag << 4;
+        constraint_byte = h->sps->constraint_set4_flag << 3;
+        constraint_byte = h->sps->constraint_set4_flag << 3;
+
+        h264_debug_printf( "codec: avc1.%02X%02X%02X\n",h->sps->profile_idc, constraint_byte, h->sps->level_idc );
+
+        // TODO: add more, move to h264_stream (?)
+        return 1; // we've seen enough, bailing out.
+    }
+
+    if ( opt_verbose > 0 )
+    {
+        // fprintf( h264_dbgfile, "XX ");
+        // debug_bytes(nal->data - 4, nal->size + 4 >= 16 ? 16: nal->size + 4);
+
+        // debug_nal(h, h->nal);
+    }
+
+    return 0;
+}
+
+#ifdef HAVE_PTHREAD
+
+/*
+ Parallel reading: the main thread splits the stream into batches of NALs, and worker threads read and print
+ each batch into memory, with a stream object of its own that starts from a copy of the parameter sets in
+ effect before the batch.  To know those, the main thread reads the parameter set NALs itself (printing them
+ nowhere) and follows which ones the slices use.  Batches are written out in stream order as they are done.
+ */
+
+#define BATCH_NALS   256
+#define BATCH_BYTES  (4*1024*1024)   // of NALs copied out of the reader
+
+typedef struct batch
+{
+    struct batch* next_todo;    // batches waiting for a worker
+    struct batch* next_out;     // batches waiting to be written, in stream order
+    h264_stream_t* h;           // state of the stream before the first NAL, read into by the worker
+    nal_view_t nals[BATCH_NALS];
+    int n;
+    uint8_t* buf;               // copies of the NALs, when the reader's views don't last
+    int buf_size;
+    int buf_used;
+    char* out;                  // what reading the NALs printed
+    size_t out_size;
+    int done;
+} batch_t;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    batch_t* todo;
+    batch_t* todo_tail;
+    batch_t* out;
+    batch_t* out_tail;
+    int queued;                 // batches not written yet, bounds the memory used
+    int max_queued;
+    int finished;               // no more batches will be added
+} batch_queue_t;
+
+static void* analyze_worker(void* arg)
+{
+    batch_queue_t* q = (batch_queue_t*)arg;
+
+    pthread_mutex_lock(&q->lock);
+    while (1)
+    {
+        while (q->todo == NULL && !q->finished) { pthread_cond_wait(&q->cond, &q->lock); }
+        if (q->todo == NULL) { break; }
+        batch_t* b = q->todo;
+        q->todo = b->next_todo;
+        pthread_mutex_unlock(&q->lock);
+
+        FILE* out = open_memstream(&b->out, &b->out_size);
+        if (out == NULL) { fprintf( stderr, "!! Error: could not buffer output: %s \n", strerror(errno)); exit(EXIT_FAILURE); }
+        h264_dbgsink_thread = h264_debug_sink_new(opt_format, out, H264_DEBUG_NO_HEADER);
+        if (h264_dbgsink_thread == NULL) { fprintf( stderr, "!! Error: could not allocate the output buffer \n"); exit(EXIT_FAILURE); }
+        for (int i = 0; i < b->n; i++) { if (analyze_nal(b->h, &b->nals[i])) { break; } }
+        h264_debug_sink_free(h264_dbgsink_thread);
+        h264_dbgsink_thread = NULL;
+        fclose(out);
+        h264_free(b->h);
+        free(b->buf);
+
+        pthread_mutex_lock(&q->lock);
+        b->done = 1;
+        while (q->out != NULL && q->out->done)
+        {
+            batch_t* w = q->out;
+            q->out = w->next_out;
+            fwrite(w->out, 1, w->out_size, h264_dbgfile);
+            free(w->out);
+            free(w);
+            q->queued--;
+        }
+        pthread_cond_broadcast(&q->cond);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return NULL;
+}
+
+static void batch_submit(batch_queue_t* q, batch_t* b)
+{
+    // the views point into buf from here on, which may have moved as it grew
+    if (b->buf != NULL)
+    {
+        int pos = 0;
+        for (int i = 0; i < b->n; i++) { b->nals[i].data = b->buf + pos; pos += b->nals[i].size; }
+    }
+
+    pthread_mutex_lock(&q->lock);
+    while (q->queued >= q->max_queued) { pthread_cond_wait(&q->cond, &q->lock); }
+    if (q->todo == NULL) { q->todo = b; } else { q->todo_tail->next_todo = b; }
+    q->todo_tail = b;
+    if (q->out == NULL) { q->out = b; } else { q->out_tail->next_out = b; }
+    q->out_tail = b;
+    q->queued++;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+}
+
+// follow what reading a NAL does to the stream state, without printing anything
+static void follow_state(h264_stream_t* state, nal_view_t* nal)
+{
+    bs_t b;
+    uint32_t pps_id;
+    if (nal->size < 1) { return; }
+
+    switch (nal->data[0] & 0x1F)
+    {
+        case NAL_UNIT_TYPE_CODED_SLICE_IDR:
+        case NAL_UNIT_TYPE_CODED_SLICE_NON_IDR:
+        case NAL_UNIT_TYPE_CODED_SLICE_AUX:
+            // the slice header makes its PPS, and that PPS's SPS, the current ones
+            if (state->parse_depth < H264_PARSE_HEADERS) { break; }
+            bs_init_nal(&b, nal->data, nal->size);
+            bs_skip_u(&b, 8);
+            bs_read_ue(&b); // first_mb_in_slice
+            bs_read_ue(&b); // slice_type
+            pps_id = bs_read_ue(&b);
+            if (pps_id >= 256) { break; }
+            h264_activate_pps(state, pps_id);
+            if (state->pps->seq_parameter_set_id < 32) { h264_activate_sps(state, state->pps->seq_parameter_set_id); }
+            break;
+
+        case NAL_UNIT_TYPE_SPS:
+        case NAL_UNIT_TYPE_PPS:
+        case NAL_UNIT_TYPE_SUBSET_SPS:
+        case NAL_UNIT_TYPE_PREFIX_NAL:
+        case NAL_UNIT_TYPE_CODED_SLICE_SVC_EXTENSION:
+        case 21: // 3D-AVC slice extension, whose header reuses the SVC fields
+            read_debug_nal_unit(state, nal->data, nal->size);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void analyze_parallel(nal_reader_t* reader, h264_stream_t* h, int jobs, int views_last)
+{
+    batch_queue_t q;
+    memset(&q, 0, sizeof(q));
+    pthread_mutex_init(&q.lock, NULL);
+    pthread_cond_init(&q.cond, NULL);
+    q.max_queued = 2 * jobs;
+
+    // the parameter sets are read here as well, to nowhere; what the sink has so far goes before the batches
+    h264_dbgsink_thread = h264_debug_sink_new(H264_DEBUG_NULL, NULL, 0);
+    h264_dbgsink->flush(h264_dbgsink);
+
+    // as many workers as will start; with none, or when a batch can't be allocated, the rest is read serially
+    pthread_t* threads = (pthread_t*)malloc(jobs * sizeof(pthread_t));
+    int started = 0;
+    while (threads != NULL && started < jobs && pthread_create(&threads[started], NULL, analyze_worker, &q) == 0) { started++; }
+    if (started == 0) { fprintf( stderr, "!! Could not start threads, reading serially \n"); }
+
+    nal_view_t nal;
+    int pending = 0; // nal was taken from the reader but not put in a batch
+    batch_t* b = NULL;
+    while (started > 0 && next_nal(reader, &nal))
+    {
+        if (b == NULL)
+        {
+            b = (batch_t*)calloc(1, sizeof(batch_t));
+            if (b != NULL && (b->h = h264_new()) == NULL) { free(b); b = NULL; }
+            if (b == NULL) { pending = 1; break; }
+            b->h->parse_depth = h->parse_depth;
+            h264_copy_state(b->h, h);
+        }
+
+        if (!views_last)
+        {
+            if (b->buf_used + nal.size > b->buf_size)
+            {
+                int buf_size = 2 * (b->buf_used + nal.size);
+                uint8_t* buf = (uint8_t*)realloc(b->buf, buf_size);
+                if (buf == NULL) { pending = 1; break; }
+                b->buf = buf;
+                b->buf_size = buf_size;
+            }
+            memcpy(b->buf + b->buf_used, nal.data, nal.size);
+            b->buf_used += nal.size;
+        }
+        b->nals[b->n++] = nal;
+
+        follow_state(h, &nal);
+
+        // the worker stops at the first SPS when probing, so nothing after it needs reading
+        if (opt_probe && nal.size > 0 && (nal.data[0] & 0x1F) == NAL_UNIT_TYPE_SPS) { break; }
+
+        if (b->n == BATCH_NALS || b->buf_used >= BATCH_BYTES) { batch_submit(&q, b); b = NULL; }
+    }
+    if (b != NULL) { batch_submit(&q, b); }
+
+    pthread_mutex_lock(&q.lock);
+    q.finished = 1;
+    pthread_cond_broadcast(&q.cond);
+    pthread_mutex_unlock(&q.lock);
+    for (int i = 0; i < started; i++) { pthread_join(threads[i], NULL); }
+
+    free(threads);
+    h264_debug_sink_free(h264_dbgsink_thread);
+    h264_dbgsink_thread = NULL;
+    pthread_cond_destroy(&q.cond);
+    pthread_mutex_destroy(&q.lock);
+
+    // everything batched has been written by now, h is where the stream is
+    if (pending) { fprintf( stderr, "!! Could not allocate a batch, reading the rest serially \n"); }
+    if (pending && analyze_nal(h, &nal)) { return; }
+    if (pending || started == 0)
+    {
+        while (next_nal(reader, &nal)) { if (analyze_nal(h, &nal)) { break; } }
+    }
+}
+
+#else
+
+static void analyze_parallel(nal_reader_t* reader, h264_stream_t* h, int jobs, int views_last)
+{
+    nal_view_t nal;
+    fprintf( stderr, "!! Built without threads, reading serially \n");
+    while (next_nal(reader, &nal)) { if (analyze_nal(h, &nal)) { break; } }
+}
+
+#endif
+
 int main(int argc, char *argv[])
 {
     FILE* infile;
 
-    uint8_t* buf = (uint8_t*)malloc( BUFSIZE );
-
     h264_stream_t* h = h264_new();
+    h->parse_depth = H264_PARSE_HEADERS; // slice data is never printed
 
     if (argc < 2) { usage(); return EXIT_FAILURE; }
 
-    int opt_verbose = 1;
-    int opt_probe = 0;
+    int opt_mmap = 0;
+    int opt_jobs = 1;
 
 #ifdef HAVE_GETOPT_LONG
     int c;
@@ -79,7 +386,7 @@ int main(int argc, char *argv[])
     extern char* optarg;
     extern int   optind;
 
-    while ( ( c = getopt_long( argc, argv, "o:phv:", long_options, &long_options_index) ) != -1 )
+    while ( ( c = getopt_long( argc, argv, "o:phv:d:mj:f:", long_options, &long_options_index) ) != -1 )
     {
         switch ( c )
         {
@@ -93,6 +400,25 @@ int main(int argc, char *argv[])
             case 'v':
                 opt_verbose = atoi( optarg );
                 break;
+            case 'd':
+                if (strcmp(optarg, "0") == 0) { h->parse_depth = H264_PARSE_NAL_HEADER; }
+                else if (strcmp(optarg, "1") == 0) { h->parse_depth = H264_PARSE_HEADERS; }
+                else if (strcmp(optarg, "2") == 0) { h->parse_depth = H264_PARSE_SLICE_DATA; }
+                else { usage( ); return 1; }
+                break;
+            case 'm':
+                opt_mmap = 1;
+                break;
+            case 'j':
+                opt_jobs = atoi( optarg );
+                break;
+            case 'f':
+                if (strcmp(optarg, "text") == 0) { opt_format = H264_DEBUG_TEXT; }
+                else if (strcmp(optarg, "json") == 0) { opt_format = H264_DEBUG_JSON; }
+                else if (strcmp(optarg, "binary") == 0) { opt_format = H264_DEBUG_BINARY; }
+                else if (strcmp(optarg, "null") == 0) { opt_format = H264_DEBUG_NULL; }
+                else { usage( ); return 1; }
+                break;
             case 'h':
             default:
                 usage( );
@@ -111,88 +437,33 @@ int main(int argc, char *argv[])
     if (infile == NULL) { fprintf( stderr, "!! Error: could not open file: %s \n", strerror(errno)); exit(EXIT_FAILURE); }
 
     if (h264_dbgfile == NULL) { h264_dbgfile = stdout; }
+    h264_debug_add_names(h264_stream_debug_names);
+    h264_debug_add_names(h264_sei_debug_names);
+    h264_dbgsink = h264_debug_sink_new(opt_format, h264_dbgfile, 0);
+    if (h264_dbgsink == NULL) { fprintf( stderr, "!! Error: could not allocate the output buffer \n"); exit(EXIT_FAILURE); }
     
 
-    size_t rsz = 0;
-    size_t sz = 0;
-    int64_t off = 0;
-    uint8_t* p = buf;
-
-    int nal_start, nal_end;
-
-    while (1)
+    nal_reader_t* reader = NULL;
+    int mapped = 0; // the NALs stay where they are until the reader is freed
+    if (opt_mmap)
     {
-        rsz = fread(buf + sz, 1, BUFSIZE - sz, infile);
-        if (rsz == 0)
-        {
-            if (ferror(infile)) { fprintf( stderr, "!! Error: read failed: %s \n", strerror(errno)); break; }
-            break;  // if (feof(infile)) 
-        }
-
-        sz += rsz;
-
-        while (find_nal_unit(p, sz, &nal_start, &nal_end) > 0)
-        {
-            if ( opt_verbose > 0 )
-            {
-               fprintf( h264_dbgfile, "!! Found NAL at offset %lld (0x%04llX), size %lld (0x%04llX) \n",
-                      (long long int)(off + (p - buf) + nal_start),
-                      (long long int)(off + (p - buf) + nal_start),
-                      (long long int)(nal_end - nal_start),
-                      (long long int)(nal_end - nal_start) );
-            }
-
-            p += nal_start;
-            read_debug_nal_unit(h, p, nal_end - nal_start);
-
-            if ( opt_probe && h->nal->nal_unit_type == NAL_UNIT_TYPE_SPS )
-            {
-                // print codec parameter, per RFC 6381.
-                int constraint_byte = h->sps->constraint_set0_flag << 7;
-                constraint_byte = h->sps->constraint_set1_flag << 6;
-                constraint_byte = h->sps->constraint_set2_flag << 5;
-                constraint_byte = h->sps->constraint_set3_flag << 4;
-                constraint_byte = h->sps->constraint_set4_flag << 3;
-                constraint_byte = h->sps->constraint_set4_flag << 3;
-
-                fprintf( h264_dbgfile, "codec: avc1.%02X%02X%02X\n",h->sps->profile_idc, constraint_byte, h->sps->level_idc );
-
-                // TODO: add more, move to h264_stream (?)
-                break; // we've seen enough, bailing out.
-            }
-
-            if ( opt_verbose > 0 )
-            {
-                // fprintf( h264_dbgfile, "XX ");
-                // debug_bytes(p-4, nal_end - nal_start + 4 >= 16 ? 16: nal_end - nal_start + 4);
-
-                // debug_nal(h, h->nal);
-            }
-
-            p += (nal_end - nal_start);
-            sz -= nal_end;
-        }
-
-        // if no NALs found in buffer, discard it
-        if (p == buf) 
-        {
-            fprintf( stderr, "!! Did not find any NALs between offset %lld (0x%04llX), size %lld (0x%04llX), discarding \n",
-                   (long long int)off, 
-                   (long long int)off, 
-                   (long long int)off + sz, 
-                   (long long int)off + sz);
-
-            p = buf + sz;
-            sz = 0;
-        }
+        reader = nal_reader_new_mmap(fileno(infile), 0);
+        if (reader == NULL) { fprintf( stderr, "!! Could not map the input file, reading it instead \n"); }
+        else { mapped = 1; }
+    }
+    if (reader == NULL) { reader = nal_reader_new_fd(fileno(infile), BUFSIZE); }
+    if (reader == NULL) { fprintf( stderr, "!! Error: could not allocate the read buffer \n"); exit(EXIT_FAILURE); }
 
-        memmove(buf, p, sz);
-        off += p - buf;
-        p = buf;
+    if (opt_jobs > 1) { analyze_parallel(reader, h, opt_jobs, mapped); }
+    else
+    {
+        nal_view_t nal;
+        while (next_nal(reader, &nal)) { if (analyze_nal(h, &nal)) { break; } }
     }
 
+    nal_reader_free(reader);
     h264_free(h);
-    free(buf);
+    h264_debug_sink_free(h264_dbgsink);
 
     fclose(h264_dbgfile);
     fclose(infile);
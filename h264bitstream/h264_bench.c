@@ -0,0 +1,1544 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ Microbenchmarks for the hot paths of the library.  Each benchmark first checks that
+ the optimized code gives exactly the same results as a reference copy of the original
+ implementation, then times both.  Exits with a failure status if any check fails.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "h264_stream.h"
+#include "h265_stream.h"
+#include "h264_nal_reader.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BS_BENCH_OPS   (1024*1024)
+
+static int opt_iterations = 10;
+
+static double now_sec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+// small deterministic generator so that runs are comparable
+static uint32_t rnd_state = 12345;
+static uint32_t rnd()
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+static void report(const char* name, double t_old, double t_new, double units, const char* unit_name)
+{
+    printf("%-24s old: %10.2f %s  new: %10.2f %s  speedup: %5.2fx\n",
+           name, units / t_old, unit_name, units / t_new, unit_name, t_old / t_new);
+}
+
+// reference bit reader: the original bit-by-bit implementation, built on bs_read_u1()
+
+static uint32_t ref_read_u(bs_t* b, int n)
+{
+    uint32_t r = 0;
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        r |= ( bs_read_u1(b) << ( n - i - 1 ) );
+    }
+    return r;
+}
+
+static uint32_t ref_read_ue(bs_t* b)
+{
+    int32_t r = 0;
+    int i = 0;
+
+    while( (bs_read_u1(b) == 0) && (i < 32) && (!bs_eof(b)) )
+    {
+        i++;
+    }
+    r = ref_read_u(b, i);
+    r += (1 << i) - 1;
+    return r;
+}
+
+// reference bit writer: the original implementation, built on bs_write_u1()
+
+static void ref_write_u(bs_t* b, int n, uint32_t v)
+{
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        bs_write_u1(b, (v >> ( n - i - 1 ))&0x01 );
+    }
+}
+
+static void ref_write_ue(bs_t* b, uint32_t v)
+{
+    int len = 0;
+
+    if (v == 0)
+    {
+        bs_write_u1(b, 1);
+    }
+    else
+    {
+        v++;
+        while ((v >> len) > 1) { len++; }
+        ref_write_u(b, 2*len+1, v);
+    }
+}
+
+typedef struct
+{
+    int n;      // bit width for u(n), 0 for ue
+    uint32_t v;
+} bs_op_t;
+
+static void write_ops(bs_t* b, bs_op_t* ops, int nops, int use_ref)
+{
+    int i;
+    for (i = 0; i < nops; i++)
+    {
+        if (use_ref)
+        {
+            if (ops[i].n > 0) { ref_write_u(b, ops[i].n, ops[i].v); }
+            else { ref_write_ue(b, ops[i].v); }
+        }
+        else
+        {
+            if (ops[i].n > 0) { bs_write_u(b, ops[i].n, ops[i].v); }
+            else { bs_write_ue(b, ops[i].v); }
+        }
+    }
+}
+
+// both writers must produce the same bytes, including over a dirty buffer and past its end
+static int check_bs_write(bs_op_t* ops, int nops, int size)
+{
+    uint8_t* buf_old = (uint8_t*)malloc(size);
+    uint8_t* buf_new = (uint8_t*)malloc(size);
+    int errors = 0;
+    int pass, i;
+    bs_t bo, bn;
+
+    for (pass = 0; pass < 3; pass++)
+    {
+        int len = (pass == 2) ? size / 32 : size;
+        for (i = 0; i < size; i++) { buf_old[i] = buf_new[i] = (pass == 0) ? 0 : rnd(); }
+        bs_init(&bo, buf_old, len);
+        bs_init(&bn, buf_new, len);
+        write_ops(&bo, ops, nops, 1);
+        write_ops(&bn, ops, nops, 0);
+        if (memcmp(buf_old, buf_new, size) != 0 || bo.p - buf_old != bn.p - buf_new || bo.bits_left != bn.bits_left)
+        {
+            fprintf(stderr, "!! bs write mismatch (pass %d)\n", pass);
+            errors++;
+        }
+    }
+
+    // unaligned bs_write_bytes() and Exp-Golomb codes longer than 32 bits, read back
+    uint8_t bytes[5] = { 0x00, 0x00, 0x03, 0xA5, 0xFF };
+    uint32_t big[4] = { 0x0001FFFF, 0x12345678, 0x80000000, 0xFFFFFFFE };
+    memset(buf_new, 0xFF, 64);
+    bs_init(&bn, buf_new, 64);
+    bs_write_u(&bn, 3, 5);
+    bs_write_bytes(&bn, bytes, 5);
+    for (i = 0; i < 4; i++) { bs_write_ue(&bn, big[i]); }
+    bs_init(&bn, buf_new, 64);
+    if (bs_read_u(&bn, 3) != 5) { errors++; }
+    for (i = 0; i < 5; i++) { if (bs_read_u8(&bn) != bytes[i]) { errors++; } }
+    for (i = 0; i < 4; i++) { if (bs_read_ue(&bn) != big[i]) { errors++; } }
+    if (errors > 0) { fprintf(stderr, "!! bs round trip failed\n"); }
+
+    free(buf_old);
+    free(buf_new);
+    return errors;
+}
+
+static int bench_bs()
+{
+    int nops = BS_BENCH_OPS;
+    bs_op_t* ops = (bs_op_t*)malloc(nops * sizeof(bs_op_t));
+    int size = nops * 8;
+    uint8_t* buf = (uint8_t*)calloc(1, size);
+    int i, it;
+    int errors = 0;
+    uint32_t sum_old = 0, sum_new = 0;
+    double bits = 0;
+
+    // mix of fixed-width fields and small Exp-Golomb codes, as found in headers
+    for (i = 0; i < nops; i++)
+    {
+        if (rnd() & 1)
+        {
+            ops[i].n = 1 + rnd() % 32;
+            ops[i].v = rnd() & (ops[i].n == 32 ? 0xFFFFFFFF : ((1u << ops[i].n) - 1));
+        }
+        else
+        {
+            ops[i].n = 0;
+            ops[i].v = rnd() >> (rnd() % 32);
+            if (ops[i].v > 0xFFFE) { ops[i].v &= 0xFF; }
+        }
+    }
+
+    errors += check_bs_write(ops, nops, size);
+
+    bs_t* b = bs_new(buf, size);
+    double t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++)
+    {
+        bs_init(b, buf, size);
+        write_ops(b, ops, nops, 1);
+    }
+    double t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++)
+    {
+        bs_init(b, buf, size);
+        write_ops(b, ops, nops, 0);
+    }
+    double t2 = now_sec();
+    size = bs_pos(b) + 1;
+    bits = (double)bs_pos(b) * 8;
+    report("bs_write_u/bs_write_ue", t1 - t0, t2 - t1, bits * opt_iterations / 1.0e6, "Mbit/s");
+
+    // check: both readers agree with what was written, including reads that run past the end
+    bs_t bo, bn;
+    bs_init(&bo, buf, size);
+    bs_init(&bn, buf, size);
+    for (i = 0; i < nops + 64; i++)
+    {
+        int n = (i < nops) ? ops[i].n : (i % 2 ? 0 : 1 + i % 32);
+        uint32_t vo = (n > 0) ? ref_read_u(&bo, n) : ref_read_ue(&bo);
+        uint32_t vn = (n > 0) ? bs_read_u(&bn, n) : bs_read_ue(&bn);
+        if (vo != vn || bo.p != bn.p || bo.bits_left != bn.bits_left ||
+            (i < nops && vn != ops[i].v))
+        {
+            if (errors++ < 10) { fprintf(stderr, "!! bs mismatch at op %d: old %u new %u\n", i, vo, vn); }
+        }
+    }
+
+    t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++)
+    {
+        bs_init(b, buf, size);
+        for (i = 0; i < nops; i++)
+        {
+            sum_old += (ops[i].n > 0) ? ref_read_u(b, ops[i].n) : ref_read_ue(b);
+        }
+    }
+    t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++)
+    {
+        bs_init(b, buf, size);
+        for (i = 0; i < nops; i++)
+        {
+            sum_new += (ops[i].n > 0) ? bs_read_u(b, ops[i].n) : bs_read_ue(b);
+        }
+    }
+    t2 = now_sec();
+
+    if (sum_old != sum_new) { errors++; }
+    report("bs_read_u/bs_read_ue", t1 - t0, t2 - t1, bits * opt_iterations / 1.0e6, "Mbit/s");
+
+    bs_free(b);
+    free(buf);
+    free(ops);
+    return errors;
+}
+
+// reference start code scanner: the original find_nal_unit()
+
+static int ref_find_nal_unit(uint8_t* buf, int size, int* nal_start, int* nal_end)
+{
+    int i;
+    // find start
+    *nal_start = 0;
+    *nal_end = 0;
+
+    i = 0;
+    while (   //( next_bits( 24 ) != 0x000001 && next_bits( 32 ) != 0x00000001 )
+        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) &&
+        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0 || buf[i+3] != 0x01)
+        )
+    {
+        i++; // skip leading zero
+        if (i+4 >= size) { return 0; } // did not find nal start
+    }
+
+    if  (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) // ( next_bits( 24 ) != 0x000001 )
+    {
+        i++;
+    }
+
+    if  (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) { /* error, should never happen */ return 0; }
+    i+= 3;
+    *nal_start = i;
+
+    while (   //( next_bits( 24 ) != 0x000000 && next_bits( 24 ) != 0x000001 )
+        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0) &&
+        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01)
+        )
+    {
+        i++;
+        if (i+3 >= size) { *nal_end = size; return -1; } // did not find nal end, stream ended first
+    }
+
+    *nal_end = i;
+    return (*nal_end - *nal_start);
+}
+
+// escaped NAL payload of about len bytes, with about as many zero bytes as real CABAC slice data
+static int make_payload(uint8_t* buf, int len)
+{
+    int i = 0;
+    int zeros = 0;
+    while (len-- > 0)
+    {
+        uint8_t v = (rnd() % 64 == 0) ? 0x00 : rnd();
+        if (zeros == 2 && v <= 0x03) { buf[i++] = 0x03; zeros = 0; }
+        buf[i++] = v;
+        zeros = (v == 0x00) ? zeros + 1 : 0;
+    }
+    buf[i++] = 0x80; // rbsp_stop_one_bit
+    return i;
+}
+
+// Annex B stream of NALs of random size, with 3 and 4 byte start codes
+static int make_annexb(uint8_t* buf, int size)
+{
+    int i = 0;
+    while (i + 200000 < size)
+    {
+        if (rnd() & 1) { buf[i++] = 0x00; }
+        buf[i++] = 0x00; buf[i++] = 0x00; buf[i++] = 0x01;
+        i += make_payload(buf + i, 16 + rnd() % 100000);
+    }
+    return i;
+}
+
+static int scan_ref(uint8_t* buf, int size, nal_pos_t* out)
+{
+    int n = 0;
+    int nal_start, nal_end;
+    uint8_t* p = buf;
+    while (ref_find_nal_unit(p, size, &nal_start, &nal_end) > 0)
+    {
+        out[n].start = (p - buf) + nal_start;
+        out[n].end = (p - buf) + nal_end;
+        n++;
+        p += nal_end;
+        size -= nal_end;
+    }
+    return n;
+}
+
+static int scan_new(uint8_t* buf, int size, nal_pos_t* out, int is_last)
+{
+    int n = 0;
+    int k, i;
+    int pos = 0;
+    while ((k = find_nal_units(buf + pos, size - pos, out + n, 256, is_last)) > 0)
+    {
+        for (i = n; i < n + k; i++)
+        {
+            out[i].start += pos;
+            out[i].end += pos;
+        }
+        n += k;
+        pos = out[n-1].end;
+    }
+    return n;
+}
+
+static int bench_nal()
+{
+    int size = 64*1024*1024;
+    uint8_t* buf = (uint8_t*)calloc(1, size + 64);
+    int max_nals = size / 16;
+    nal_pos_t* nals_old = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+    nal_pos_t* nals_new = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+    static const char* kernel_names[] = { "auto", "C", "SSE2", "AVX2" };
+    int errors = 0;
+    int it, kernel;
+    int n_old = 0, n_new = 0;
+
+    size = make_annexb(buf, size);
+
+    double t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { n_old = scan_ref(buf, size, nals_old); }
+    double t_old = now_sec() - t0;
+
+    for (kernel = NAL_SCAN_KERNEL_C; kernel <= NAL_SCAN_KERNEL_AVX2; kernel++)
+    {
+        char name[64];
+        if (nal_scan_set_kernel(kernel) != kernel) { continue; }
+
+        t0 = now_sec();
+        for (it = 0; it < opt_iterations; it++) { n_new = scan_new(buf, size, nals_new, 0); }
+        double t_new = now_sec() - t0;
+
+        if (n_new != n_old || memcmp(nals_old, nals_new, n_old * sizeof(nal_pos_t)) != 0)
+        {
+            fprintf(stderr, "!! find_nal_units (%s) found %d NALs, find_nal_unit found %d\n", kernel_names[kernel], n_new, n_old);
+            errors++;
+        }
+        // the last NAL is only returned when the buffer holds the end of the stream
+        if (scan_new(buf, size, nals_new, 1) != n_old + 1 ||
+            nals_new[n_old].start > nals_old[n_old-1].end + 4 || nals_new[n_old].end != size)
+        {
+            fprintf(stderr, "!! find_nal_units (%s) did not find the last NAL\n", kernel_names[kernel]);
+            errors++;
+        }
+
+        sprintf(name, "find_nal_units (%s)", kernel_names[kernel]);
+        report(name, t_old, t_new, (double)size * opt_iterations / (1024*1024), "MB/s");
+    }
+    nal_scan_set_kernel(NAL_SCAN_KERNEL_AUTO);
+
+    free(nals_old);
+    free(nals_new);
+    free(buf);
+    return errors;
+}
+
+// in-memory stream for the reader benchmark, handed out at most chunk bytes at a time like a pipe
+typedef struct
+{
+    uint8_t* buf;
+    int size;
+    int pos;
+    int chunk;
+} mem_stream_t;
+
+static int mem_read(void* opaque, uint8_t* buf, int size)
+{
+    mem_stream_t* m = (mem_stream_t*)opaque;
+    int n = m->size - m->pos;
+    if (n > size) { n = size; }
+    if (n > m->chunk) { n = m->chunk; }
+    memcpy(buf, m->buf + m->pos, n);
+    m->pos += n;
+    return n;
+}
+
+// reference stream reading: the loop h264_analyze had, reading into a buffer and moving the leftover to the front
+static int read_ref(nal_reader_read_fn read, void* opaque, int bufsize, nal_pos_t* out)
+{
+    uint8_t* buf = (uint8_t*)malloc(bufsize);
+    nal_pos_t nals[256];
+    int sz = 0, off = 0, count = 0, eof = 0;
+    int n, i;
+    uint8_t* p = buf;
+
+    while (1)
+    {
+        int rsz = 0, k;
+        while (sz + rsz < bufsize && (k = read(opaque, buf + sz + rsz, bufsize - sz - rsz)) > 0) { rsz += k; }
+        if (rsz == 0) { eof = 1; }
+        sz += rsz;
+
+        while ((n = find_nal_units(p, sz, nals, 256, eof)) > 0)
+        {
+            uint8_t* base = p;
+            for (i = 0; i < n; i++)
+            {
+                int nal_start = nals[i].start - (p - base);
+                int nal_end = nals[i].end - (p - base);
+                out[count].start = off + (p - buf) + nal_start;
+                out[count].end = out[count].start + nal_end - nal_start;
+                count++;
+                p += nal_end;
+                sz -= nal_end;
+            }
+        }
+        if (eof) { break; }
+        if (p == buf) { p = buf + sz; sz = 0; }
+        memmove(buf, p, sz);
+        off += p - buf;
+        p = buf;
+    }
+    free(buf);
+    return count;
+}
+
+static int read_nals(nal_reader_t* r, nal_pos_t* out)
+{
+    nal_view_t nal;
+    int count = 0;
+    int rc;
+
+    if (r == NULL) { return -1; }
+
+    while ((rc = nal_reader_next(r, &nal)) != NAL_READER_END)
+    {
+        if (rc != NAL_READER_NAL) { continue; }
+        out[count].start = (int)nal.offset;
+        out[count].end = (int)nal.offset + nal.size;
+        count++;
+    }
+    nal_reader_free(r);
+    return count;
+}
+
+static int read_new(mem_stream_t* m, int bufsize, nal_pos_t* out)
+{
+    return read_nals(nal_reader_new(mem_read, m, bufsize), out);
+}
+
+static int bench_reader()
+{
+    int size = 64*1024*1024;
+    int bufsize = 4*1024*1024;
+    uint8_t* buf = (uint8_t*)calloc(1, size + 64);
+    int max_nals = size / 16;
+    nal_pos_t* nals_old = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+    nal_pos_t* nals_new = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+    int errors = 0;
+    int it;
+    int n_old = 0, n_new = 0;
+    mem_stream_t m;
+
+    m.buf = buf;
+    m.size = make_annexb(buf, size);
+    m.chunk = m.size;
+
+    double t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { m.pos = 0; n_old = read_ref(mem_read, &m, bufsize, nals_old); }
+    double t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { m.pos = 0; n_new = read_new(&m, bufsize, nals_new); }
+    double t2 = now_sec();
+
+    if (n_new != n_old || memcmp(nals_old, nals_new, n_old * sizeof(nal_pos_t)) != 0)
+    {
+        fprintf(stderr, "!! nal_reader found %d NALs, the read loop found %d\n", n_new, n_old);
+        errors++;
+    }
+    // short reads, as from a pipe, wrap around the ring at every possible place
+    m.pos = 0;
+    m.chunk = 4099;
+    if (read_new(&m, bufsize, nals_new) != n_old || memcmp(nals_old, nals_new, n_old * sizeof(nal_pos_t)) != 0)
+    {
+        fprintf(stderr, "!! nal_reader found other NALs with short reads\n");
+        errors++;
+    }
+    report("nal_reader", t1 - t0, t2 - t1, (double)m.size * opt_iterations / (1024*1024), "MB/s");
+
+    free(nals_old);
+    free(nals_new);
+    free(buf);
+    return errors;
+}
+
+static int fd_read(void* opaque, uint8_t* buf, int size)
+{
+    return (int)read(*(int*)opaque, buf, size);
+}
+
+static int bench_mmap()
+{
+    int size = 64*1024*1024;
+    uint8_t* buf = (uint8_t*)calloc(1, size + 64);
+    int errors = 0;
+    int it;
+    int n_old = 0, n_new = 0;
+
+    // a real file, so that both sides read it from the page cache
+    FILE* f = tmpfile();
+    size = make_annexb(buf, size);
+    if (f == NULL || fwrite(buf, 1, size, f) != (size_t)size || fflush(f) != 0)
+    {
+        fprintf(stderr, "!! could not write a temporary file\n");
+        if (f != NULL) { fclose(f); }
+        free(buf);
+        return 1;
+    }
+    int fd = fileno(f);
+    int max_nals = size / 16;
+    nal_pos_t* nals_old = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+    nal_pos_t* nals_new = (nal_pos_t*)malloc(max_nals * sizeof(nal_pos_t));
+
+    double t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { lseek(fd, 0, SEEK_SET); n_old = read_ref(fd_read, &fd, NAL_READER_DEFAULT_SIZE, nals_old); }
+    double t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { n_new = read_nals(nal_reader_new_mmap(fd, 0), nals_new); }
+    double t2 = now_sec();
+
+    if (n_new != n_old || memcmp(nals_old, nals_new, n_old * sizeof(nal_pos_t)) != 0)
+    {
+        fprintf(stderr, "!! nal_reader_new_mmap found %d NALs, the read loop found %d\n", n_new, n_old);
+        errors++;
+    }
+    // a window smaller than the file has to move along it like the ring
+    if (read_nals(nal_reader_new_mmap(fd, 1024*1024), nals_new) != n_old || memcmp(nals_old, nals_new, n_old * sizeof(nal_pos_t)) != 0)
+    {
+        fprintf(stderr, "!! nal_reader_new_mmap found other NALs with a small window\n");
+        errors++;
+    }
+    report("nal_reader (mmap)", t1 - t0, t2 - t1, (double)size * opt_iterations / (1024*1024), "MB/s");
+
+    fclose(f);
+    free(nals_old);
+    free(nals_new);
+    free(buf);
+    return errors;
+}
+
+// reference escaping: the original byte-at-a-time rbsp_to_nal() and nal_to_rbsp()
+
+static int ref_rbsp_to_nal(const uint8_t* rbsp_buf, const int* rbsp_size, uint8_t* nal_buf, int* nal_size)
+{
+    int i;
+    int j     = 0;
+    int count = 0;
+
+    for ( i = 0; i < *rbsp_size ; )
+    {
+        if ( j >= *nal_size )
+        {
+            // error, not enough space
+            return -1;
+        }
+
+        if ( ( count == 2 ) && !(rbsp_buf[i] & 0xFC) ) // HACK 0xFC
+        {
+            nal_buf[j] = 0x03;
+            j++;
+            count = 0;
+            continue;
+        }
+        nal_buf[j] = rbsp_buf[i];
+        if ( rbsp_buf[i] == 0x00 )
+        {
+            count++;
+        }
+        else
+        {
+            count = 0;
+        }
+        i++;
+        j++;
+    }
+
+    *nal_size = j;
+    return j;
+}
+
+static int ref_nal_to_rbsp(const uint8_t* nal_buf, int* nal_size, uint8_t* rbsp_buf, int* rbsp_size)
+{
+    int i;
+    int j     = 0;
+    int count = 0;
+
+    for( i = 0; i < *nal_size; i++ )
+    {
+        if( ( count == 2 ) && ( nal_buf[i] < 0x03) )
+        {
+            return -1;
+        }
+
+        if( ( count == 2 ) && ( nal_buf[i] == 0x03) )
+        {
+            if((i < *nal_size - 1) && (nal_buf[i+1] > 0x03))
+            {
+                return -1;
+            }
+
+            if(i == *nal_size - 1)
+            {
+                break;
+            }
+
+            i++;
+            count = 0;
+        }
+
+        if ( j >= *rbsp_size )
+        {
+            return -1;
+        }
+
+        rbsp_buf[j] = nal_buf[i];
+        if(nal_buf[i] == 0x00)
+        {
+            count++;
+        }
+        else
+        {
+            count = 0;
+        }
+        j++;
+    }
+
+    *nal_size = i;
+    *rbsp_size = j;
+    return j;
+}
+
+// compare one conversion both ways, and in place; returns the number of mismatches
+static int check_rbsp(uint8_t* in, int size, int out_size, uint8_t* out_old, uint8_t* out_new)
+{
+    int errors = 0;
+    int rs_old = out_size, rs_new = out_size;
+    int ns_old = size, ns_new = size;
+    int rc_old = ref_nal_to_rbsp(in, &ns_old, out_old, &rs_old);
+    int rc_new = nal_to_rbsp(in, &ns_new, out_new, &rs_new);
+    if (rc_old != rc_new || (rc_old >= 0 && (ns_old != ns_new || rs_old != rs_new || memcmp(out_old, out_new, rs_old) != 0)))
+    {
+        errors++;
+    }
+    if (rc_old >= 0)
+    {
+        int sz = size;
+        memcpy(out_new, in, size);
+        if (nal_to_rbsp_inplace(out_new, &sz) != rc_old || sz != rs_old || memcmp(out_old, out_new, rs_old) != 0) { errors++; }
+    }
+
+    ns_old = out_size; ns_new = out_size;
+    rc_old = ref_rbsp_to_nal(in, &size, out_old, &ns_old);
+    rc_new = rbsp_to_nal(in, &size, out_new, &ns_new);
+    if (rc_old != rc_new || (rc_old >= 0 && (ns_old != ns_new || memcmp(out_old, out_new, ns_old) != 0)))
+    {
+        errors++;
+    }
+    return errors;
+}
+
+static int bench_rbsp()
+{
+    int size = 64*1024*1024;
+    uint8_t* nal = (uint8_t*)malloc(size);
+    uint8_t* rbsp = (uint8_t*)malloc(size);
+    uint8_t* out = (uint8_t*)malloc(size * 3 / 2);
+    uint8_t* out2 = (uint8_t*)malloc(size * 3 / 2);
+    int errors = 0;
+    int it, t, i;
+    int rbsp_size, nal_size, sz;
+
+    // small buffers full of zeros, escapes, errors and too-short outputs
+    for (t = 0; t < 200000; t++)
+    {
+        int len = rnd() % 64;
+        for (i = 0; i < len; i++) { int r = rnd() % 6; out[i] = (r < 3) ? 0x00 : (r == 3) ? 0x03 : rnd(); }
+        memcpy(nal, out, len);
+        if (check_rbsp(nal, len, (t % 4 == 0) ? len / 2 : len * 3 / 2, rbsp, out2) != 0)
+        {
+            if (errors++ < 10) { fprintf(stderr, "!! rbsp mismatch on test %d\n", t); }
+        }
+    }
+
+    // one large escaped slice payload
+    size = make_payload(nal, size / 2);
+    nal_size = size;
+    rbsp_size = size;
+    if (ref_nal_to_rbsp(nal, &nal_size, rbsp, &rbsp_size) < 0) { errors++; }
+    if (check_rbsp(nal, size, size * 3 / 2, out, out2) != 0) { errors++; fprintf(stderr, "!! rbsp mismatch on stream\n"); }
+
+    double t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { nal_size = size; sz = size; ref_nal_to_rbsp(nal, &nal_size, out, &sz); }
+    double t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { nal_size = size; sz = size; nal_to_rbsp(nal, &nal_size, out, &sz); }
+    double t2 = now_sec();
+    report("nal_to_rbsp", t1 - t0, t2 - t1, (double)size * opt_iterations / (1024*1024), "MB/s");
+
+    t0 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { sz = size * 3 / 2; ref_rbsp_to_nal(rbsp, &rbsp_size, out, &sz); }
+    t1 = now_sec();
+    for (it = 0; it < opt_iterations; it++) { sz = size * 3 / 2; rbsp_to_nal(rbsp, &rbsp_size, out, &sz); }
+    t2 = now_sec();
+    report("rbsp_to_nal", t1 - t0, t2 - t1, (double)rbsp_size * opt_iterations / (1024*1024), "MB/s");
+
+    free(nal);
+    free(rbsp);
+    free(out);
+    free(out2);
+    return errors;
+}
+
+// reads through a NAL view must match reads from the unescaped rbsp, whatever the escapes fall on
+static int bench_view()
+{
+    int nops = BS_BENCH_OPS;
+    bs_op_t* ops = (bs_op_t*)malloc(nops * sizeof(bs_op_t));
+    int size = nops * 8;
+    uint8_t* rbsp = (uint8_t*)calloc(1, size);
+    uint8_t* nal = (uint8_t*)malloc(size * 3 / 2);
+    uint8_t* out_r = (uint8_t*)malloc(64);
+    uint8_t* out_n = (uint8_t*)malloc(64);
+    int errors = 0;
+    int i, it, rbsp_size, nal_size;
+    uint32_t sum_old = 0, sum_new = 0;
+    bs_t br, bn;
+
+    // plenty of zero fields, so that escapes land everywhere inside and between fields
+    for (i = 0; i < nops; i++)
+    {
+        ops[i].n = (rnd() & 1) ? 1 + rnd() % 32 : 0;
+        ops[i].v = (rnd() % 3 == 0) ? rnd() % 4 : rnd() >> (rnd() % 32);
+        if (ops[i].n > 0 && ops[i].n < 32) { ops[i].v &= (1u << ops[i].n) - 1; }
+        if (ops[i].n == 0 && ops[i].v > 0xFFFE) { ops[i].v &= 0xFF; }
+    }
+    bs_init(&br, rbsp, size);
+    write_ops(&br, ops, nops, 0);
+    rbsp_size = bs_pos(&br) + 1;
+    nal_size = size * 3 / 2;
+    if (rbsp_to_nal(rbsp, &rbsp_size, nal, &nal_size) < 0) { errors++; }
+
+    bs_init(&br, rbsp, rbsp_size);
+    bs_init_nal(&bn, nal, nal_size);
+    for (i = 0; i < nops + 64; i++)
+    {
+        int n = (i < nops) ? ops[i].n : (i % 2 ? 0 : 1 + i % 32);
+        uint32_t vr, vn;
+        if (i % 1000 == 999)
+        {
+            // byte runs and lookahead across escapes
+            int len = 1 + i % 40;
+            bs_skip_u(&br, br.bits_left % 8);
+            bs_skip_u(&bn, bn.bits_left % 8);
+            vr = bs_next_bytes(&br, 4);
+            vn = bs_next_bytes(&bn, 4);
+            if (vr != vn || bs_read_bytes(&br, out_r, len) != bs_read_bytes(&bn, out_n, len) || memcmp(out_r, out_n, len) != 0) { errors++; }
+            continue;
+        }
+        vr = (n > 0) ? bs_read_u(&br, n) : bs_read_ue(&br);
+        vn = (n > 0) ? bs_read_u(&bn, n) : bs_read_ue(&bn);
+        if (vr != vn || bs_pos(&br) != bs_pos(&bn) || br.bits_left != bn.bits_left)
+        {
+            if (errors++ < 10) { fprintf(stderr, "!! view mismatch at op %d: rbsp %u view %u\n", i, vr, vn); }
+        }
+    }
+
+    // header-only parse of a 256KB IDR slice: unescape it all first, or read the few fields in place
+    int nheader = 16;
+    if (nal_size > 256*1024) { nal_size = 256*1024; }
+    int reps = opt_iterations * 1000;
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++)
+    {
+        int ns = nal_size, rs = nal_size;
+        uint8_t* buf = (uint8_t*)calloc(1, rs);
+        nal_to_rbsp(nal, &ns, buf, &rs);
+        bs_t* b = bs_new(buf, rs);
+        for (i = 0; i < nheader; i++) { sum_old += (ops[i].n > 0) ? bs_read_u(b, ops[i].n) : bs_read_ue(b); }
+        bs_free(b);
+        free(buf);
+    }
+    double t1 = now_sec();
+    for (it = 0; it < reps; it++)
+    {
+        bs_init_nal(&bn, nal, nal_size);
+        for (i = 0; i < nheader; i++) { sum_new += (ops[i].n > 0) ? bs_read_u(&bn, ops[i].n) : bs_read_ue(&bn); }
+    }
+    double t2 = now_sec();
+    if (sum_old != sum_new) { errors++; }
+    report("header parse (copy/view)", t1 - t0, t2 - t1, (double)reps, "hdr/s");
+
+    free(ops);
+    free(rbsp);
+    free(nal);
+    free(out_r);
+    free(out_n);
+    return errors;
+}
+
+// reference stream setup: the original h264_new() and h264_free(), every structure and table slot on its own
+static h264_stream_t* ref_h264_new()
+{
+    h264_stream_t* h = (h264_stream_t*)calloc(1, sizeof(h264_stream_t));
+
+    h->nal = (nal_t*)calloc(1, sizeof(nal_t));
+    h->nal->nal_svc_ext = (nal_svc_ext_t*) calloc(1, sizeof(nal_svc_ext_t));
+    h->nal->prefix_nal_svc = (prefix_nal_svc_t*) calloc(1, sizeof(prefix_nal_svc_t));
+
+    for ( int i = 0; i < 32; i++ ) { h->sps_table[i] = (sps_t*)calloc(1, sizeof(sps_t)); }
+    for ( int i = 0; i < 64; i++ )
+    {
+        h->sps_subset_table[i] = (sps_subset_t*)calloc(1, sizeof(sps_subset_t));
+        h->sps_subset_table[i]->sps = (sps_t*)calloc(1, sizeof(sps_t));
+        h->sps_subset_table[i]->sps_svc_ext = (sps_svc_ext_t*) calloc(1, sizeof(sps_svc_ext_t));
+    }
+    for ( int i = 0; i < 256; i++ ) { h->pps_table[i] = (pps_t*)calloc(1, sizeof(pps_t)); }
+
+    h->sps = (sps_t*)calloc(1, sizeof(sps_t));
+    h->sps_subset = (sps_subset_t*)calloc(1, sizeof(sps_subset_t));
+    h->sps_subset->sps = (sps_t*)calloc(1, sizeof(sps_t));
+    h->sps_subset->sps_svc_ext = (sps_svc_ext_t*)calloc(1, sizeof(sps_svc_ext_t));
+    h->pps = (pps_t*)calloc(1, sizeof(pps_t));
+    h->aud = (aud_t*)calloc(1, sizeof(aud_t));
+    h->sh = (slice_header_t*)calloc(1, sizeof(slice_header_t));
+    h->sh_svc_ext = (slice_header_svc_ext_t*) calloc(1, sizeof(slice_header_svc_ext_t));
+    h->slice_data = (slice_data_rbsp_t*)calloc(1, sizeof(slice_data_rbsp_t));
+    return h;
+}
+
+static void ref_h264_free(h264_stream_t* h)
+{
+    free(h->nal->nal_svc_ext);
+    free(h->nal->prefix_nal_svc);
+    free(h->nal);
+    for ( int i = 0; i < 32; i++ ) { free( h->sps_table[i] ); }
+    for ( int i = 0; i < 64; i++ )
+    {
+        free( h->sps_subset_table[i]->sps );
+        free( h->sps_subset_table[i]->sps_svc_ext );
+        free( h->sps_subset_table[i] );
+    }
+    for ( int i = 0; i < 256; i++ ) { free( h->pps_table[i] ); }
+    free(h->pps);
+    free(h->aud);
+    free(h->sh);
+    free(h->sh_svc_ext);
+    free(h->slice_data);
+    free(h->sps);
+    free(h->sps_subset->sps);
+    free(h->sps_subset->sps_svc_ext);
+    free(h->sps_subset);
+    free(h);
+}
+
+static int bench_stream()
+{
+    int reps = opt_iterations * 1000;
+    int errors = 0;
+    int it, i;
+
+    // a fresh stream reads back empty parameter sets for any id, as it always did
+    h264_stream_t* h = h264_new();
+    for (i = 0; i < 32; i++) { if (h->sps_table[i] != NULL || h264_sps_slot(h, i)->profile_idc != 0) { errors++; } }
+    for (i = 0; i < 64; i++) { if (h264_sps_subset_slot(h, i)->sps_svc_ext->extended_spatial_scalability_idc != 0) { errors++; } }
+    for (i = 0; i < 256; i++) { if (h264_pps_slot(h, i)->num_slice_groups_minus1 != 0 || h264_pps_slot(h, i) != h->pps_table[i]) { errors++; } }
+    h264_free(h);
+    if (errors > 0) { fprintf(stderr, "!! empty parameter set slots are not zero\n"); }
+
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++) { ref_h264_free(ref_h264_new()); }
+    double t1 = now_sec();
+    for (it = 0; it < reps; it++) { h264_free(h264_new()); }
+    double t2 = now_sec();
+    report("h264_new/h264_free", t1 - t0, t2 - t1, (double)reps, "streams/s");
+
+    size_t bytes_old = sizeof(h264_stream_t) + sizeof(nal_t) + sizeof(nal_svc_ext_t) + sizeof(prefix_nal_svc_t) +
+        33 * sizeof(sps_t) + 65 * (sizeof(sps_subset_t) + sizeof(sps_t) + sizeof(sps_svc_ext_t)) + 257 * sizeof(pps_t) +
+        sizeof(aud_t) + sizeof(slice_header_t) + sizeof(slice_header_svc_ext_t) + sizeof(slice_data_rbsp_t);
+    size_t bytes_new = bytes_old - 32 * sizeof(sps_t) - 64 * (sizeof(sps_subset_t) + sizeof(sps_t) + sizeof(sps_svc_ext_t)) - 256 * sizeof(pps_t);
+    printf("%-24s old: %10zu bytes     new: %10zu bytes (before any parameter set is read)\n", "stream size", bytes_old, bytes_new);
+    return errors;
+}
+
+// an SPS and a PPS as an encoder would send them before every IDR
+static int make_param_sets(uint8_t* buf, int* sizes, int sps_id, int width_mbs)
+{
+    h264_stream_t* h = h264_new();
+    h->nal->nal_ref_idc = 3;
+    h->nal->nal_unit_type = NAL_UNIT_TYPE_SPS;
+    h->sps->profile_idc = 100;
+    h->sps->level_idc = 40;
+    h->sps->seq_parameter_set_id = sps_id;
+    h->sps->chroma_format_idc = 1;
+    h->sps->log2_max_frame_num_minus4 = 4;
+    h->sps->pic_order_cnt_type = 2;
+    h->sps->num_ref_frames = 1;
+    h->sps->pic_width_in_mbs_minus1 = width_mbs - 1;
+    h->sps->pic_height_in_map_units_minus1 = 67;
+    h->sps->frame_mbs_only_flag = 1;
+    h->sps->direct_8x8_inference_flag = 1;
+    sizes[0] = write_nal_unit(h, buf, 256);
+
+    h->nal->nal_unit_type = NAL_UNIT_TYPE_PPS;
+    h->pps->pic_parameter_set_id = sps_id;
+    h->pps->seq_parameter_set_id = sps_id;
+    h->pps->entropy_coding_mode_flag = 1;
+    h->pps->num_ref_idx_l0_active_minus1 = 2;
+    sizes[1] = write_nal_unit(h, buf + 256, 256);
+    h264_free(h);
+    return (sizes[0] > 0 && sizes[1] > 0) ? 0 : 1;
+}
+
+// writing a slice loads its PPS into h->pps, and a slice read after that with another PPS must load that one again
+static int check_ps_write(uint8_t* buf, int* sizes)
+{
+    uint8_t* pps_buf = (uint8_t*)calloc(1, 1024);
+    int pps_sizes[2];
+    int slice_size;
+    int i, errors = 0;
+    h264_stream_t* h = h264_new();
+    h->parse_depth = H264_PARSE_HEADERS;
+
+    // two PPSs for the first SPS, CAVLC as a CABAC slice is written with cabac_zero_words to the end of the buffer
+    read_nal_unit(h, buf, sizes[0]);
+    read_nal_unit(h, buf + 256, sizes[1]);
+    h->pps->entropy_coding_mode_flag = 0;
+    for (i = 0; i < 2; i++)
+    {
+        h->pps->pic_parameter_set_id = i;
+        h->pps->num_ref_idx_l0_active_minus1 = i;
+        pps_sizes[i] = write_nal_unit(h, pps_buf + 256 * i, 256);
+    }
+    for (i = 0; i < 2; i++) { read_nal_unit(h, pps_buf + 256 * i, pps_sizes[i]); }
+
+    h->nal->nal_ref_idc = 3;
+    h->nal->nal_unit_type = NAL_UNIT_TYPE_CODED_SLICE_IDR;
+    h->slice_data = NULL;
+    memset(h->sh, 0, sizeof(slice_header_t));
+    h->sh->slice_type = SH_SLICE_TYPE_I_ONLY;
+    h->sh->pic_parameter_set_id = 1;
+    slice_size = write_nal_unit(h, pps_buf + 512, 256);
+    h->sh->pic_parameter_set_id = 0;
+    write_nal_unit(h, pps_buf + 768, 256);
+    if (h->pps->pic_parameter_set_id != 0) { errors++; }
+
+    read_nal_unit(h, pps_buf + 512, slice_size);
+    if (h->sh->pic_parameter_set_id != 1 || h->pps->pic_parameter_set_id != 1 || h->pps->num_ref_idx_l0_active_minus1 != 1) { errors++; }
+    if (errors > 0) { fprintf(stderr, "!! slice read after writing one kept the PPS of the written one\n"); }
+
+    h264_free(h);
+    free(pps_buf);
+    return errors;
+}
+
+static int bench_ps()
+{
+    uint8_t* buf = (uint8_t*)calloc(1, 1024);
+    int sizes[4];
+    int errors = 0;
+    int it;
+    h264_stream_t* h = h264_new();
+    sps_t* sps0 = (sps_t*)malloc(sizeof(sps_t));
+    pps_t* pps0 = (pps_t*)malloc(sizeof(pps_t));
+
+    errors += make_param_sets(buf, sizes, 0, 120);
+    errors += make_param_sets(buf + 512, sizes + 2, 1, 80);
+
+    // first time parsed, then re-sent after another pair: h->sps and h->pps must come back the same
+    read_nal_unit(h, buf, sizes[0]);
+    read_nal_unit(h, buf + 256, sizes[1]);
+    memcpy(sps0, h->sps, sizeof(sps_t));
+    memcpy(pps0, h->pps, sizeof(pps_t));
+    if (h->sps->pic_width_in_mbs_minus1 != 119 || h->pps->num_ref_idx_l0_active_minus1 != 2) { errors++; }
+    read_nal_unit(h, buf + 512, sizes[2]);
+    read_nal_unit(h, buf + 768, sizes[3]);
+    if (h->sps->pic_width_in_mbs_minus1 != 79 || h->pps->pic_parameter_set_id != 1) { errors++; }
+    read_nal_unit(h, buf, sizes[0]);
+    read_nal_unit(h, buf + 256, sizes[1]);
+    if (memcmp(sps0, h->sps, sizeof(sps_t)) != 0 || memcmp(pps0, h->pps, sizeof(pps_t)) != 0) { errors++; }
+    if (errors > 0) { fprintf(stderr, "!! re-sent parameter sets read back differently\n"); }
+    errors += check_ps_write(buf, sizes);
+
+    int reps = opt_iterations * 100000;
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++)
+    {
+        // forget the hashes, so that every parameter set is parsed and copied like before
+        h->sps_table_hash[0] = h->pps_table_hash[0] = 0;
+        read_nal_unit(h, buf, sizes[0]);
+        read_nal_unit(h, buf + 256, sizes[1]);
+    }
+    double t1 = now_sec();
+    for (it = 0; it < reps; it++)
+    {
+        read_nal_unit(h, buf, sizes[0]);
+        read_nal_unit(h, buf + 256, sizes[1]);
+    }
+    double t2 = now_sec();
+    report("re-sent SPS+PPS", t1 - t0, t2 - t1, (double)reps, "pairs/s");
+
+    h264_free(h);
+    free(sps0);
+    free(pps0);
+    free(buf);
+    return errors;
+}
+
+// the parameter sets above with weighted prediction, and a P slice with a weight for each reference
+static int make_weighted_slice(uint8_t* buf, int* sizes)
+{
+    h264_stream_t* h = h264_new();
+    int i, errors = make_param_sets(buf, sizes, 0, 120);
+
+    read_nal_unit(h, buf, sizes[0]);
+    read_nal_unit(h, buf + 256, sizes[1]);
+    h->pps->weighted_pred_flag = 1;
+    h->pps->entropy_coding_mode_flag = 0; // CAVLC, a CABAC slice is written with cabac_zero_words to the end of the buffer
+    sizes[1] = write_nal_unit(h, buf + 256, 256);
+    read_nal_unit(h, buf + 256, sizes[1]);
+
+    h->nal->nal_ref_idc = 0;
+    h->nal->nal_unit_type = NAL_UNIT_TYPE_CODED_SLICE_NON_IDR;
+    h->sh->first_mb_in_slice = 120 * 17;
+    h->sh->slice_type = SH_SLICE_TYPE_P;
+    h->sh->frame_num = 13;
+    h->sh->pwt.luma_log2_weight_denom = 6;
+    h->sh->pwt.chroma_log2_weight_denom = 6;
+    for (i = 0; i < 3; i++)
+    {
+        h->sh->pwt.luma_weight_l0_flag[i] = 1;
+        h->sh->pwt.luma_weight_l0[i] = 64 - 5 * i;
+        h->sh->pwt.luma_offset_l0[i] = -3 * i;
+        h->sh->pwt.chroma_weight_l0_flag[i] = 1;
+        h->sh->pwt.chroma_weight_l0[i][0] = h->sh->pwt.chroma_weight_l0[i][1] = 60 + i;
+        h->sh->pwt.chroma_offset_l0[i][0] = h->sh->pwt.chroma_offset_l0[i][1] = i;
+    }
+    h->sh->slice_qp_delta = -4;
+    h->slice_data = NULL; // no payload, the header is followed by its trailing bits
+    sizes[2] = write_nal_unit(h, buf + 512, 256);
+    h264_free(h);
+    return (errors == 0 && sizes[1] > 0 && sizes[2] > 0) ? 0 : 1;
+}
+
+static int bench_skip()
+{
+    uint8_t* buf = (uint8_t*)calloc(1, 1024);
+    int sizes[3];
+    int errors = 0;
+    int it, i;
+    h264_stream_t* h = h264_new();
+    h264_stream_t* hs = h264_new();
+    h->parse_depth = H264_PARSE_HEADERS;
+
+    errors += make_weighted_slice(buf, sizes);
+
+    // storing everything, skip_nal_unit reads the same as read_nal_unit
+    for (i = 0; i < 3; i++)
+    {
+        if (read_nal_unit(h, buf + 256 * i, sizes[i]) != skip_nal_unit(hs, H264_EXTRACT_ALL, buf + 256 * i, sizes[i])) { errors++; }
+    }
+    if (memcmp(h->sps, hs->sps, sizeof(sps_t)) != 0 || memcmp(h->pps, hs->pps, sizeof(pps_t)) != 0 ||
+        memcmp(h->sh, hs->sh, sizeof(slice_header_t)) != 0) { errors++; }
+
+    // storing only the slice header, the weights are left zero and the rest is the same
+    h264_free(hs);
+    hs = h264_new();
+    for (i = 0; i < 3; i++) { skip_nal_unit(hs, H264_EXTRACT_SLICE_HEADER, buf + 256 * i, sizes[i]); }
+    if (hs->sh->first_mb_in_slice != 120 * 17 || hs->sh->frame_num != 13 || hs->sh->slice_qp_delta != -4 ||
+        hs->sh->pwt.luma_weight_l0_flag[2] != 1) { errors++; }
+    if (hs->sh->pwt.luma_weight_l0[0] != 0 || hs->sh->pwt.chroma_offset_l0[2][1] != 0 || hs->sps->pic_width_in_mbs_minus1 != 0) { errors++; }
+
+    // and a parameter set read that way is not taken for a repeat of the one read whole
+    read_nal_unit(hs, buf, sizes[0]);
+    if (memcmp(h->sps, hs->sps, sizeof(sps_t)) != 0) { errors++; }
+    if (errors > 0) { fprintf(stderr, "!! skip_nal_unit read back differently\n"); }
+
+    int reps = opt_iterations * 100000;
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++) { read_nal_unit(h, buf + 512, sizes[2]); }
+    double t1 = now_sec();
+    for (it = 0; it < reps; it++) { skip_nal_unit(hs, H264_EXTRACT_SLICE_HEADER, buf + 512, sizes[2]); }
+    double t2 = now_sec();
+    report("weighted slice header", t1 - t0, t2 - t1, (double)reps, "NALs/s");
+
+    h264_free(h);
+    h264_free(hs);
+    free(buf);
+    return errors;
+}
+
+#ifdef HAVE_SEI
+// SEI NAL with what broadcast streams carry on every frame: picture timing, closed captions and an NTP timestamp
+static int make_sei(uint8_t* buf, int size, uint8_t payloads[3][64])
+{
+    uint8_t rbsp[256];
+    int types[3] = { SEI_TYPE_PIC_TIMING, SEI_TYPE_USER_DATA_REGISTERED_ITU_T_T35, SEI_TYPE_USER_DATA_UNREGISTERED };
+    int sizes[3] = { 5, 60, 24 };
+    int n = 0;
+    int i, j;
+
+    rbsp[n++] = NAL_UNIT_TYPE_SEI;
+    for (i = 0; i < 3; i++)
+    {
+        rbsp[n++] = types[i];
+        rbsp[n++] = sizes[i];
+        for (j = 0; j < sizes[i]; j++) { rbsp[n++] = payloads[i][j] = (j % 7 == 0) ? 0 : rnd(); }
+    }
+    rbsp[n++] = 0x80;
+    return (rbsp_to_nal(rbsp, &n, buf, &size) < 0) ? -1 : size;
+}
+
+// drop the pooled messages, so that the next read allocates everything again like before
+static void sei_pool_drop(h264_stream_t* h)
+{
+    for (int i = 0; i < h->sei_pool_size; i++) { sei_free(h->seis[i]); }
+    free(h->seis);
+    h->seis = NULL;
+    h->sei_pool_size = 0;
+    h->num_seis = 0;
+}
+#endif
+
+static int bench_sei()
+{
+#ifdef HAVE_SEI
+    uint8_t buf[512];
+    uint8_t payloads[3][64];
+    int errors = 0;
+    int it, i;
+    int size = make_sei(buf, sizeof(buf), payloads);
+    h264_stream_t* h = h264_new();
+
+    // the same messages come out of a fresh pool and out of a reused one
+    for (it = 0; it < 3; it++)
+    {
+        if (it == 0) { sei_pool_drop(h); }
+        if (read_nal_unit(h, buf, size) != size || h->num_seis != 3) { errors++; break; }
+        for (i = 0; i < 3; i++)
+        {
+            if (memcmp(payloads[i], h->seis[i]->data, h->seis[i]->payloadSize) != 0) { errors++; }
+        }
+    }
+    if (errors > 0) { fprintf(stderr, "!! pooled SEI messages read back differently\n"); }
+
+    int reps = opt_iterations * 100000;
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++) { sei_pool_drop(h); read_nal_unit(h, buf, size); }
+    double t1 = now_sec();
+    for (it = 0; it < reps; it++) { read_nal_unit(h, buf, size); }
+    double t2 = now_sec();
+    report("SEI, 3 messages", t1 - t0, t2 - t1, (double)reps, "NALs/s");
+
+    h264_free(h);
+    return errors;
+#else
+    fprintf(stderr, "!! SEI needs a build with HAVE_SEI, run h264_bench_sei\n");
+    return 1;
+#endif
+}
+
+// one of each NAL type h265_stream reads: VPS, SPS, PPS, AUD, SEI, an IDR slice and a P slice segment
+#define HEVC_NALS        7
+#define HEVC_NAL_SIZE    1024
+#define HEVC_SLICE_DATA  (64*1024)
+
+static int make_hevc(uint8_t** bufs, int* sizes, uint8_t* sei_payload)
+{
+    h265_stream_t* h = h265_new();
+    h265_vps_t* vps = h->vps;
+    h265_sps_t* sps = h->sps;
+    h265_pps_t* pps = h->pps;
+    h265_slice_header_t* sh = h->sh;
+    int i;
+
+    h->nal->nuh_temporal_id_plus1 = 1;
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_VPS;
+    vps->vps_base_layer_internal_flag = 1;
+    vps->vps_base_layer_available_flag = 1;
+    vps->vps_temporal_id_nesting_flag = 1;
+    vps->ptl.general_profile_idc = H265_PROFILE_MAIN;
+    vps->ptl.general_profile_compatibility_flag[H265_PROFILE_MAIN] = 1;
+    vps->ptl.general_progressive_source_flag = 1;
+    vps->ptl.general_frame_only_constraint_flag = 1;
+    vps->ptl.general_level_idc = 120;
+    vps->vps_sub_layer_ordering_info_present_flag = 1;
+    vps->vps_max_dec_pic_buffering_minus1[0] = 4;
+    vps->vps_timing_info_present_flag = 1;
+    vps->vps_num_units_in_tick = 1001;
+    vps->vps_time_scale = 60000;
+    sizes[0] = write_h265_nal_unit(h, bufs[0], HEVC_NAL_SIZE);
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_SPS;
+    sps->sps_temporal_id_nesting_flag = 1;
+    memcpy(&sps->ptl, &vps->ptl, sizeof(h265_profile_tier_level_t));
+    sps->chroma_format_idc = 1;
+    sps->pic_width_in_luma_samples = 1920;
+    sps->pic_height_in_luma_samples = 1088;
+    sps->conformance_window_flag = 1;
+    sps->conf_win_bottom_offset = 4;
+    sps->log2_max_pic_order_cnt_lsb_minus4 = 4;
+    sps->sps_sub_layer_ordering_info_present_flag = 1;
+    sps->sps_max_dec_pic_buffering_minus1[0] = 4;
+    sps->log2_diff_max_min_luma_coding_block_size = 3;
+    sps->log2_diff_max_min_luma_transform_block_size = 3;
+    sps->max_transform_hierarchy_depth_inter = 1;
+    sps->max_transform_hierarchy_depth_intra = 1;
+    sps->scaling_list_enabled_flag = 1;
+    sps->sps_scaling_list_data_present_flag = 1;
+    // two coded lists, one of them with differences that only fit modulo 256, the others copied
+    sps->scaling_list.scaling_list_pred_mode_flag[0][0] = 1;
+    for (i = 0; i < 16; i++) { sps->scaling_list.ScalingList[0][0][i] = (i == 8) ? 250 : 16 + i; }
+    sps->scaling_list.scaling_list_pred_mode_flag[2][1] = 1;
+    sps->scaling_list.scaling_list_dc_coef_minus8[0][1] = 8;
+    for (i = 0; i < 64; i++) { sps->scaling_list.ScalingList[2][1][i] = 16 + (i * 37) % 200; }
+    sps->amp_enabled_flag = 1;
+    sps->sample_adaptive_offset_enabled_flag = 1;
+    // POC -1, -3, and -1, -2, -4 predicted from it
+    sps->num_short_term_ref_pic_sets = 2;
+    sps->st_ref_pic_set[0].num_negative_pics = 2;
+    sps->st_ref_pic_set[0].delta_poc_s0_minus1[1] = 1;
+    sps->st_ref_pic_set[0].used_by_curr_pic_s0_flag[0] = 1;
+    sps->st_ref_pic_set[0].used_by_curr_pic_s0_flag[1] = 1;
+    sps->st_ref_pic_set[1].inter_ref_pic_set_prediction_flag = 1;
+    sps->st_ref_pic_set[1].delta_rps_sign = 1;
+    for (i = 0; i < 3; i++) { sps->st_ref_pic_set[1].used_by_curr_pic_flag[i] = 1; }
+    sps->sps_temporal_mvp_enabled_flag = 1;
+    sps->strong_intra_smoothing_enabled_flag = 1;
+    sps->vui_parameters_present_flag = 1;
+    sps->vui.video_signal_type_present_flag = 1;
+    sps->vui.video_format = 5;
+    sps->vui.colour_description_present_flag = 1;
+    sps->vui.colour_primaries = 1;
+    sps->vui.transfer_characteristics = 1;
+    sps->vui.matrix_coeffs = 1;
+    sps->vui.vui_timing_info_present_flag = 1;
+    sps->vui.vui_num_units_in_tick = 1001;
+    sps->vui.vui_time_scale = 60000;
+    sizes[1] = write_h265_nal_unit(h, bufs[1], HEVC_NAL_SIZE);
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_PPS;
+    pps->dependent_slice_segments_enabled_flag = 1;
+    pps->sign_data_hiding_enabled_flag = 1;
+    pps->init_qp_minus26 = -4;
+    pps->cu_qp_delta_enabled_flag = 1;
+    pps->diff_cu_qp_delta_depth = 1;
+    pps->weighted_pred_flag = 1;
+    pps->entropy_coding_sync_enabled_flag = 1;
+    pps->pps_loop_filter_across_slices_enabled_flag = 1;
+    pps->lists_modification_present_flag = 1;
+    pps->slice_segment_header_extension_present_flag = 1;
+    sizes[2] = write_h265_nal_unit(h, bufs[2], HEVC_NAL_SIZE);
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_AUD;
+    h->aud->pic_type = H265_AUD_PIC_TYPE_IP;
+    sizes[3] = write_h265_nal_unit(h, bufs[3], HEVC_NAL_SIZE);
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_PREFIX_SEI;
+    h265_sei_pool_reserve(h, 1);
+    h->num_seis = 1;
+    h->seis[0]->payloadType = SEI_TYPE_USER_DATA_UNREGISTERED;
+    h->seis[0]->payloadSize = 24;
+    h->seis[0]->data = (uint8_t*)malloc(24);
+    for (i = 0; i < 24; i++) { h->seis[0]->data[i] = sei_payload[i] = (i % 5 == 0) ? 0 : rnd(); }
+    sizes[4] = write_h265_nal_unit(h, bufs[4], HEVC_NAL_SIZE);
+
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_IDR_W_RADL;
+    sh->first_slice_segment_in_pic_flag = 1;
+    sh->slice_type = H265_SH_SLICE_TYPE_I;
+    sh->slice_sao_luma_flag = 1;
+    sh->slice_sao_chroma_flag = 1;
+    sh->slice_qp_delta = 2;
+    sh->slice_loop_filter_across_slices_enabled_flag = 1;
+    sizes[5] = write_h265_nal_unit(h, bufs[5], HEVC_NAL_SIZE);
+
+    // the second slice segment of a P picture, with its own reference picture set and a large payload
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_TRAIL_R;
+    memset(sh, 0, sizeof(h265_slice_header_t));
+    sh->slice_segment_address = 255;
+    sh->slice_type = H265_SH_SLICE_TYPE_P;
+    sh->slice_pic_order_cnt_lsb = 5;
+    sh->st_ref_pic_set.inter_ref_pic_set_prediction_flag = 1;
+    sh->st_ref_pic_set.delta_rps_sign = 1;
+    sh->st_ref_pic_set.used_by_curr_pic_flag[0] = 1;
+    sh->st_ref_pic_set.use_delta_flag[1] = 1;
+    sh->st_ref_pic_set.used_by_curr_pic_flag[2] = 1;
+    sh->st_ref_pic_set.used_by_curr_pic_flag[3] = 1;
+    sh->slice_temporal_mvp_enabled_flag = 1;
+    sh->slice_sao_luma_flag = 1;
+    sh->num_ref_idx_active_override_flag = 1;
+    sh->num_ref_idx_l0_active_minus1 = 1;
+    sh->rplm.ref_pic_list_modification_flag_l0 = 1;
+    sh->rplm.list_entry_l0[0] = 2;
+    sh->collocated_from_l0_flag = 1;
+    sh->collocated_ref_idx = 1;
+    sh->pwt.luma_log2_weight_denom = 6;
+    sh->pwt.luma_weight_l0_flag[0] = 1;
+    sh->pwt.delta_luma_weight_l0[0] = -3;
+    sh->pwt.luma_offset_l0[0] = 7;
+    sh->pwt.chroma_weight_l0_flag[1] = 1;
+    sh->pwt.delta_chroma_offset_l0[1][1] = -12;
+    sh->five_minus_max_num_merge_cand = 2;
+    sh->slice_qp_delta = -3;
+    sh->slice_loop_filter_across_slices_enabled_flag = 1;
+    sh->num_entry_point_offsets = 2;
+    sh->offset_len_minus1 = 11;
+    sh->entry_point_offset_minus1[0] = 3000;
+    sh->entry_point_offset_minus1[1] = 4095;
+    sh->slice_segment_header_extension_length = 2;
+    sh->slice_segment_header_extension_data_byte[1] = 0xA5;
+    h->slice_data->rbsp_size = HEVC_SLICE_DATA;
+    h->slice_data->rbsp_buf = (uint8_t*)malloc(HEVC_SLICE_DATA);
+    // runs of zeros, so that writing has escapes to insert
+    for (i = 0; i < HEVC_SLICE_DATA - 1; i++) { h->slice_data->rbsp_buf[i] = (rnd() % 16 == 0) ? 0x00 : rnd(); }
+    h->slice_data->rbsp_buf[HEVC_SLICE_DATA - 1] = 0x80; // rbsp_slice_segment_trailing_bits
+    sizes[6] = write_h265_nal_unit(h, bufs[6], 2 * HEVC_SLICE_DATA);
+
+    h265_free(h);
+    for (i = 0; i < HEVC_NALS; i++) { if (sizes[i] <= 0) { return 1; } }
+    return 0;
+}
+
+static int check_hevc(h265_stream_t* h, uint8_t** bufs, int* sizes, uint8_t* sei_payload)
+{
+    int errors = 0;
+    int i;
+
+    for (i = 0; i < HEVC_NALS; i++)
+    {
+        if (read_h265_nal_unit(h, bufs[i], sizes[i]) != sizes[i]) { errors++; }
+
+        switch (i)
+        {
+            case 0:
+                if (h->vps->vps_time_scale != 60000 || h->vps->ptl.general_level_idc != 120) { errors++; }
+                break;
+            case 1:
+                if (h->sps->pic_height_in_luma_samples != 1088 || h->sps->conf_win_bottom_offset != 4) { errors++; }
+                if (h->sps->scaling_list.ScalingList[0][0][8] != 250 || h->sps->scaling_list.ScalingList[2][1][63] != 16 + (63 * 37) % 200) { errors++; }
+                if (h->sps->st_ref_pic_set[1].NumNegativePics != 3 || h->sps->st_ref_pic_set[1].DeltaPocS0[2] != -4) { errors++; }
+                if (h->sps->vui.matrix_coeffs != 1 || h->sps->vui.vui_time_scale != 60000) { errors++; }
+                break;
+            case 2:
+                if (h->pps->init_qp_minus26 != -4 || !h->pps->slice_segment_header_extension_present_flag) { errors++; }
+                break;
+            case 3:
+                if (h->aud->pic_type != H265_AUD_PIC_TYPE_IP) { errors++; }
+                break;
+            case 4:
+                if (h->num_seis != 1 || h->seis[0]->payloadSize != 24 || memcmp(h->seis[0]->data, sei_payload, 24) != 0) { errors++; }
+                break;
+            case 5:
+                if (h->sh->slice_type != H265_SH_SLICE_TYPE_I || h->sh->slice_qp_delta != 2 || !h->sh->slice_sao_chroma_flag) { errors++; }
+                break;
+            case 6:
+                if (h->sh->slice_segment_address != 255 || h->sh->slice_pic_order_cnt_lsb != 5) { errors++; }
+                if (h->sh->st_ref_pic_set.NumNegativePics != 4 || h265_num_pic_total_curr(h) != 3) { errors++; }
+                if (h->sh->rplm.list_entry_l0[0] != 2 || h->sh->collocated_ref_idx != 1) { errors++; }
+                if (h->sh->pwt.delta_luma_weight_l0[0] != -3 || h->sh->pwt.delta_chroma_offset_l0[1][1] != -12) { errors++; }
+                if (h->sh->entry_point_offset_minus1[1] != 4095 || h->sh->slice_segment_header_extension_data_byte[1] != 0xA5) { errors++; }
+                break;
+        }
+    }
+    return errors;
+}
+
+static int bench_hevc()
+{
+    uint8_t* bufs[HEVC_NALS];
+    uint8_t* out = (uint8_t*)malloc(2 * HEVC_SLICE_DATA);
+    uint8_t sei_payload[24];
+    int sizes[HEVC_NALS];
+    int errors = 0;
+    int it, i;
+
+    for (i = 0; i < HEVC_NALS; i++) { bufs[i] = (uint8_t*)calloc(1, (i < HEVC_NALS - 1) ? HEVC_NAL_SIZE : 2 * HEVC_SLICE_DATA); }
+    errors += make_hevc(bufs, sizes, sei_payload);
+
+    // written NALs read back with the values they were written with, whole or headers only
+    h265_stream_t* h = h265_new();
+    errors += check_hevc(h, bufs, sizes, sei_payload);
+    if (h->slice_data->rbsp_buf != NULL) { errors++; }
+    h->parse_depth = H265_PARSE_SLICE_DATA;
+    errors += check_hevc(h, bufs, sizes, sei_payload);
+    if (h->slice_data->rbsp_size != HEVC_SLICE_DATA) { errors++; }
+
+    // and write again to the same bytes
+    for (i = 0; i < HEVC_NALS; i++)
+    {
+        read_h265_nal_unit(h, bufs[i], sizes[i]);
+        if (write_h265_nal_unit(h, out, 2 * HEVC_SLICE_DATA) != sizes[i] || memcmp(out, bufs[i], sizes[i]) != 0) { errors++; }
+    }
+
+    // re-sent parameter sets are not parsed again, and leave the same VPS, SPS and PPS
+    h265_sps_t* sps0 = (h265_sps_t*)malloc(sizeof(h265_sps_t));
+    memcpy(sps0, h->sps, sizeof(h265_sps_t));
+    for (i = 0; i < 3; i++) { read_h265_nal_unit(h, bufs[i], sizes[i]); }
+    if (memcmp(sps0, h->sps, sizeof(h265_sps_t)) != 0) { errors++; }
+    free(sps0);
+    if (errors > 0) { fprintf(stderr, "!! H.265 NALs read back differently\n"); }
+
+    int reps = opt_iterations * 1000;
+    h->parse_depth = H265_PARSE_SLICE_DATA;
+    double t0 = now_sec();
+    for (it = 0; it < reps; it++) { read_h265_nal_unit(h, bufs[6], sizes[6]); }
+    double t1 = now_sec();
+    h->parse_depth = H265_PARSE_HEADERS;
+    for (it = 0; it < reps; it++) { read_h265_nal_unit(h, bufs[6], sizes[6]); }
+    double t2 = now_sec();
+    report("HEVC slice header only", t1 - t0, t2 - t1, (double)reps, "NALs/s");
+
+    h265_free(h);
+    for (i = 0; i < HEVC_NALS; i++) { free(bufs[i]); }
+    free(out);
+    return errors;
+}
+
+void usage( )
+{
+    fprintf( stderr, "h264_bench, version 0.2.0\n");
+    fprintf( stderr, "Compare optimized library code paths against the original implementation\n");
+    fprintf( stderr, "Usage: \n");
+    fprintf( stderr, "h264_bench [-n iterations] <benchmark>...\nbenchmarks:\n"
+             "\tbs   bit reader and writer\n"
+             "\tnal  start code scanner\n"
+             "\treader streaming NAL reader (nal_reader_next)\n"
+             "\tmmap NAL reader over a mapped file (nal_reader_new_mmap)\n"
+             "\trbsp emulation prevention (nal_to_rbsp, rbsp_to_nal)\n"
+             "\tview bit reader over escaped nal data (bs_init_nal)\n"
+             "\tstream create and destroy a stream object (h264_new, h264_free)\n"
+             "\tps   re-sent parameter sets (read_nal_unit)\n"
+             "\tskip slice headers storing only some fields (skip_nal_unit)\n"
+             "\tsei  SEI messages (read_nal_unit, needs HAVE_SEI: run h264_bench_sei)\n"
+             "\thevc H.265 headers, written, read and written again (read_h265_nal_unit)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    int i = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0)
+    {
+        opt_iterations = atoi(argv[2]);
+        i = 3;
+    }
+    if (i >= argc || opt_iterations < 1) { usage(); return EXIT_FAILURE; }
+
+    for ( ; i < argc; i++)
+    {
+        if (strcmp(argv[i], "bs") == 0) { errors += bench_bs(); }
+        else if (strcmp(argv[i], "nal") == 0) { errors += bench_nal(); }
+        else if (strcmp(argv[i], "reader") == 0) { errors += bench_reader(); }
+        else if (strcmp(argv[i], "mmap") == 0) { errors += bench_mmap(); }
+        else if (strcmp(argv[i], "rbsp") == 0) { errors += bench_rbsp(); }
+        else if (strcmp(argv[i], "view") == 0) { errors += bench_view(); }
+        else if (strcmp(argv[i], "stream") == 0) { errors += bench_stream(); }
+        else if (strcmp(argv[i], "ps") == 0) { errors += bench_ps(); }
+        else if (strcmp(argv[i], "skip") == 0) { errors += bench_skip(); }
+        else if (strcmp(argv[i], "sei") == 0) { errors += bench_sei(); }
+        else if (strcmp(argv[i], "hevc") == 0) { errors += bench_hevc(); }
+        else { usage(); return EXIT_FAILURE; }
+    }
+
+    if (errors > 0)
+    {
+        fprintf( stderr, "!! %d mismatches against the reference implementation\n", errors);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
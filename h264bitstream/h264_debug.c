@@ -0,0 +1,404 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "h264_stream.h"
+#include "h264_debug.h"
+
+#define H264_DEBUG_BUF_SIZE (1024*1024)
+
+h264_debug_sink_t* h264_dbgsink = NULL;
+H264_THREAD_LOCAL h264_debug_sink_t* h264_dbgsink_thread = NULL;
+
+static h264_debug_sink_t* _h264_debug_sink()
+{
+    return (h264_dbgsink_thread != NULL) ? h264_dbgsink_thread : h264_dbgsink;
+}
+
+static FILE* _h264_debug_file()
+{
+    if (h264_dbgfile_thread != NULL) { return h264_dbgfile_thread; }
+    return (h264_dbgfile != NULL) ? h264_dbgfile : stdout;
+}
+
+// buffered output shared by the built in sinks
+
+static void _sink_drain(h264_debug_sink_t* s)
+{
+    if (s->used > 0) { fwrite(s->buf, 1, s->used, s->file); }
+    s->used = 0;
+}
+
+// room for n bytes at s->buf + s->used, n no more than the buffer size
+static char* _sink_reserve(h264_debug_sink_t* s, int n)
+{
+    if (s->used + n > s->size) { _sink_drain(s); }
+    return s->buf + s->used;
+}
+
+static void _sink_write(h264_debug_sink_t* s, const void* p, int len)
+{
+    if (s->used + len > s->size)
+    {
+        _sink_drain(s);
+        if (len > s->size) { fwrite(p, 1, len, s->file); return; }
+    }
+    memcpy(s->buf + s->used, p, len);
+    s->used += len;
+}
+
+static char* _put_dec(char* p, long v)
+{
+    char tmp[24];
+    int n = 0;
+    unsigned long u = (v < 0) ? 0UL - (unsigned long)v : (unsigned long)v;
+    if (v < 0) { *p++ = '-'; }
+    do { tmp[n++] = (char)('0' + u % 10); u /= 10; } while (u != 0);
+    while (n > 0) { *p++ = tmp[--n]; }
+    return p;
+}
+
+static char* _put_str(char* p, const char* str, int len)
+{
+    memcpy(p, str, len);
+    return p + len;
+}
+
+static char* _put_le(char* p, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; i++) { *p++ = (char)(v >> (8 * i)); }
+    return p;
+}
+
+// H264_DEBUG_NULL
+
+static void _null_nal(h264_debug_sink_t* s, int64_t offset, int size) { }
+static void _null_value(h264_debug_sink_t* s, long pos, int bits_left, uint32_t id, const char* name, int value) { }
+static void _null_text(h264_debug_sink_t* s, const char* text, int len) { }
+static void _null_flush(h264_debug_sink_t* s) { }
+
+// H264_DEBUG_TEXT
+
+static void _text_nal(h264_debug_sink_t* s, int64_t offset, int size)
+{
+    char* p = _sink_reserve(s, 128);
+    s->used += sprintf(p, "!! Found NAL at offset %lld (0x%04llX), size %lld (0x%04llX) \n",
+                       (long long int)offset, (long long int)offset, (long long int)size, (long long int)size);
+}
+
+static void _text_value(h264_debug_sink_t* s, long pos, int bits_left, uint32_t id, const char* name, int value)
+{
+    int len = (int)strlen(name);
+    char* start = _sink_reserve(s, len + 64);
+    char* p = _put_dec(start, pos);
+    *p++ = '.';
+    p = _put_dec(p, bits_left);
+    p = _put_str(p, ": ", 2);
+    p = _put_str(p, name, len);
+    p = _put_str(p, ": ", 2);
+    p = _put_dec(p, value);
+    p = _put_str(p, " \n", 2);
+    s->used += (int)(p - start);
+}
+
+static void _text_text(h264_debug_sink_t* s, const char* text, int len)
+{
+    _sink_write(s, text, len);
+}
+
+// H264_DEBUG_JSON
+
+// len bytes of str as the inside of a JSON string; needs up to 6 * len bytes
+static char* _put_json_str(char* p, const char* str, int len)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (int i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)str[i];
+        if (c == '"' || c == '\\') { *p++ = '\\'; *p++ = (char)c; }
+        else if (c == '\n') { *p++ = '\\'; *p++ = 'n'; }
+        else if (c < 0x20) { p = _put_str(p, "\\u00", 4); *p++ = hex[c >> 4]; *p++ = hex[c & 15]; }
+        else { *p++ = (char)c; }
+    }
+    return p;
+}
+
+static void _json_end_nal(h264_debug_sink_t* s)
+{
+    if (s->in_nal) { _sink_write(s, "]}\n", 3); }
+    s->in_nal = 0;
+}
+
+static void _json_nal(h264_debug_sink_t* s, int64_t offset, int size)
+{
+    _json_end_nal(s);
+    char* start = _sink_reserve(s, 96);
+    char* p = _put_str(start, "{\"offset\":", 10);
+    p = _put_dec(p, (long)offset);
+    p = _put_str(p, ",\"size\":", 8);
+    p = _put_dec(p, size);
+    p = _put_str(p, ",\"values\":[", 11);
+    s->used += (int)(p - start);
+    s->in_nal = 1;
+}
+
+static void _json_value(h264_debug_sink_t* s, long pos, int bits_left, uint32_t id, const char* name, int value)
+{
+    int len = (int)strlen(name);
+    if (!s->in_nal) { _sink_write(s, "{\"values\":[", 11); s->in_nal = 1; }
+    char* start = _sink_reserve(s, 6 * len + 32);
+    char* p = start;
+    if (s->in_nal == 2) { *p++ = ','; }
+    p = _put_str(p, "[\"", 2);
+    p = _put_json_str(p, name, len);
+    p = _put_str(p, "\",", 2);
+    p = _put_dec(p, value);
+    *p++ = ']';
+    s->used += (int)(p - start);
+    s->in_nal = 2;
+}
+
+static void _json_text(h264_debug_sink_t* s, const char* text, int len)
+{
+    _json_end_nal(s);
+    _sink_write(s, "{\"text\":\"", 9);
+    for (int i = 0; i < len; i += 1024)
+    {
+        int n = (len - i < 1024) ? len - i : 1024;
+        char* start = _sink_reserve(s, 6 * n);
+        s->used += (int)(_put_json_str(start, text + i, n) - start);
+    }
+    _sink_write(s, "\"}\n", 3);
+}
+
+static void _json_flush(h264_debug_sink_t* s)
+{
+    _json_end_nal(s);
+    _sink_drain(s);
+}
+
+// H264_DEBUG_BINARY
+
+static void _binary_name(h264_debug_sink_t* s, const h264_debug_name_t* n)
+{
+    int len = (int)strlen(n->name);
+    char* start = _sink_reserve(s, len + 7);
+    char* p = start;
+    *p++ = 'D';
+    p = _put_le(p, n->id, 4);
+    p = _put_le(p, len, 2);
+    p = _put_str(p, n->name, len);
+    s->used += (int)(p - start);
+}
+
+// the tables of names the binary header lists, as added by h264_debug_add_names()
+#define H264_DEBUG_MAX_NAME_TABLES 8
+static const h264_debug_name_t* _name_tables[H264_DEBUG_MAX_NAME_TABLES];
+static int _name_tables_n = 0;
+
+/**
+ Add a table of element names, such as h264_stream_debug_names, to those listed at the start of binary output.
+ Only the tables of the syntax a program reads need to be added, before its binary sinks are made; adding a
+ table again does nothing.
+ @return    0, or -1 if there are too many tables
+ */
+int h264_debug_add_names(const h264_debug_name_t* names)
+{
+    for (int t = 0; t < _name_tables_n; t++)
+    {
+        if (_name_tables[t] == names) { return 0; }
+    }
+    if (_name_tables_n == H264_DEBUG_MAX_NAME_TABLES) { return -1; }
+    _name_tables[_name_tables_n++] = names;
+    return 0;
+}
+
+static void _binary_header(h264_debug_sink_t* s)
+{
+    _sink_write(s, "H264DBG1", 8);
+    for (int t = 0; t < _name_tables_n; t++)
+    {
+        for (const h264_debug_name_t* n = _name_tables[t]; n->name != NULL; n++)
+        {
+            // the same name in an earlier table has the same id, list it once
+            int seen = 0;
+            for (int u = 0; u < t && !seen; u++)
+            {
+                for (const h264_debug_name_t* m = _name_tables[u]; m->name != NULL && !seen; m++) { seen = (m->id == n->id); }
+            }
+            if (!seen) { _binary_name(s, n); }
+        }
+    }
+}
+
+static void _binary_nal(h264_debug_sink_t* s, int64_t offset, int size)
+{
+    char* start = _sink_reserve(s, 13);
+    char* p = start;
+    *p++ = 'N';
+    p = _put_le(p, (uint64_t)offset, 8);
+    p = _put_le(p, (uint32_t)size, 4);
+    s->used += (int)(p - start);
+}
+
+static void _binary_value(h264_debug_sink_t* s, long pos, int bits_left, uint32_t id, const char* name, int value)
+{
+    char* start = _sink_reserve(s, 14);
+    char* p = start;
+    *p++ = 'V';
+    p = _put_le(p, id, 4);
+    p = _put_le(p, (uint32_t)pos, 4);
+    *p++ = (char)bits_left;
+    p = _put_le(p, (uint32_t)value, 4);
+    s->used += (int)(p - start);
+}
+
+static void _binary_text(h264_debug_sink_t* s, const char* text, int len)
+{
+    char* start = _sink_reserve(s, 5);
+    char* p = start;
+    *p++ = 'T';
+    p = _put_le(p, (uint32_t)len, 4);
+    s->used += (int)(p - start);
+    _sink_write(s, text, len);
+}
+
+/**
+ Create one of the built in debug output sinks.  Set h264_dbgsink or h264_dbgsink_thread to it to use it.
+ @param[in] format    one of H264_DEBUG_*
+ @param[in] file      where the output goes, NULL for h264_dbgfile
+ @param[in] flags     H264_DEBUG_NO_HEADER or 0
+ @return    the sink, or NULL if it could not be allocated or the format is unknown
+ */
+h264_debug_sink_t* h264_debug_sink_new(int format, FILE* file, int flags)
+{
+    h264_debug_sink_t* s = (h264_debug_sink_t*)calloc(1, sizeof(h264_debug_sink_t));
+    if (s == NULL) { return NULL; }
+
+    switch (format)
+    {
+        case H264_DEBUG_NULL:
+            s->nal = _null_nal; s->value = _null_value; s->text = _null_text; s->flush = _null_flush;
+            return s;
+        case H264_DEBUG_TEXT:
+            s->nal = _text_nal; s->value = _text_value; s->text = _text_text; s->flush = _sink_drain;
+            break;
+        case H264_DEBUG_JSON:
+            s->nal = _json_nal; s->value = _json_value; s->text = _json_text; s->flush = _json_flush;
+            break;
+        case H264_DEBUG_BINARY:
+            s->nal = _binary_nal; s->value = _binary_value; s->text = _binary_text; s->flush = _sink_drain;
+            break;
+        default:
+            free(s);
+            return NULL;
+    }
+
+    s->file = (file != NULL) ? file : _h264_debug_file();
+    s->size = H264_DEBUG_BUF_SIZE;
+    s->buf = (char*)malloc(s->size);
+    if (s->buf == NULL) { free(s); return NULL; }
+
+    if (format == H264_DEBUG_BINARY && !(flags & H264_DEBUG_NO_HEADER)) { _binary_header(s); }
+    return s;
+}
+
+/**
+ Write out what is left in a sink made by h264_debug_sink_new() and free it.  The file is not closed.
+ */
+void h264_debug_sink_free(h264_debug_sink_t* s)
+{
+    if (s == NULL) { return; }
+    s->flush(s);
+    free(s->buf);
+    free(s);
+}
+
+/**
+ Mark the start of a NAL in the debug output, for the NAL about to be read with read_debug_nal_unit().
+ Without a sink this prints the line h264_analyze always printed before each NAL.
+ @param[in] offset    of the NAL in the stream
+ @param[in] size      of the NAL
+ */
+void h264_debug_nal(int64_t offset, int size)
+{
+    h264_debug_sink_t* s = _h264_debug_sink();
+    if (s != NULL) { s->nal(s, offset, size); return; }
+
+    fprintf(_h264_debug_file(), "!! Found NAL at offset %lld (0x%04llX), size %lld (0x%04llX) \n",
+            (long long int)offset, (long long int)offset, (long long int)size, (long long int)size);
+}
+
+/**
+ Output one syntax element read by a read_debug_* function.
+ @param[in] pos         byte in the NAL the element starts in, not counting emulation prevention bytes
+ @param[in] bits_left   bits left in that byte before the element
+ @param[in] id          hash of the name, from the generated h264_*_debug_names tables
+ @param[in] name        the element, as it is named in the syntax source
+ @param[in] value       the value read
+ */
+void h264_debug_value(long pos, int bits_left, uint32_t id, const char* name, int value)
+{
+    h264_debug_sink_t* s = _h264_debug_sink();
+    if (s != NULL) { s->value(s, pos, bits_left, id, name, value); return; }
+
+    fprintf(_h264_debug_file(), "%ld.%d: %s: %d \n", pos, bits_left, name, value);
+}
+
+/**
+ Output free text along with the syntax elements, printf style.
+ */
+void h264_debug_printf(const char* format, ...)
+{
+    va_list ap;
+    h264_debug_sink_t* s = _h264_debug_sink();
+
+    va_start(ap, format);
+    if (s == NULL)
+    {
+        vfprintf(_h264_debug_file(), format, ap);
+        va_end(ap);
+        return;
+    }
+
+    char buf[256];
+    va_list ap2;
+    va_copy(ap2, ap);
+    int len = vsnprintf(buf, sizeof(buf), format, ap);
+    if (len >= (int)sizeof(buf))
+    {
+        char* big = (char*)malloc(len + 1);
+        if (big != NULL)
+        {
+            vsnprintf(big, len + 1, format, ap2);
+            s->text(s, big, len);
+            free(big);
+        }
+    }
+    else if (len > 0)
+    {
+        s->text(s, buf, len);
+    }
+    va_end(ap2);
+    va_end(ap);
+}
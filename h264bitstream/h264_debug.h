@@ -0,0 +1,126 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _H264_DEBUG_H
+#define _H264_DEBUG_H        1
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+#define H264_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define H264_THREAD_LOCAL _Thread_local
+#else
+#define H264_THREAD_LOCAL __thread
+#endif
+
+/**
+   Where the read_debug_* functions send what they read.
+
+   Every syntax element a read_debug_* function reads is passed to h264_debug_value(), which hands it to the
+   current sink: h264_dbgsink_thread if the calling thread has set one, else h264_dbgsink.  Without a sink it
+   is printed to h264_dbgfile as text, one fprintf per element, as it always was.
+
+   A sink is a set of callbacks, so an application can plug in its own; h264_debug_sink_new() makes the
+   built in ones, which collect their output in a buffer and write it to a file in large blocks:
+
+   H264_DEBUG_NULL     nothing, for reading with read_debug_* only for its side effects
+   H264_DEBUG_TEXT     the same text as without a sink
+   H264_DEBUG_JSON     newline-delimited JSON, one object per NAL:
+                         {"offset":4,"size":25,"values":[["forbidden_zero_bit",0],["nal->nal_ref_idc",3],...]}
+                       offset and size are only there if the application passed them to h264_debug_nal()
+   H264_DEBUG_BINARY   records, all numbers little-endian:
+                         "H264DBG1"                                  at the start, unless H264_DEBUG_NO_HEADER
+                         'D' u32 id, u16 length, name               every element name, after the start
+                         'N' i64 offset, i32 size                   h264_debug_nal()
+                         'V' u32 id, u32 byte, u8 bits_left, i32 value   h264_debug_value()
+                         'T' u32 length, text                       h264_debug_printf()
+                       ids are a hash of the name, the same in every build; the 'D' records list the names in the
+                       tables passed to h264_debug_add_names()
+
+   Elements are named as they are in the syntax sources (e.g. "sps->profile_idc"), and positioned by the byte
+   in the NAL they start in (not counting emulation prevention bytes) and the bits left in that byte.
+*/
+
+typedef struct h264_debug_sink h264_debug_sink_t;
+
+struct h264_debug_sink
+{
+    // start of a NAL at offset in the stream, from the application; read_debug_* don't know where NALs are
+    void (*nal)(h264_debug_sink_t* s, int64_t offset, int size);
+    // one syntax element
+    void (*value)(h264_debug_sink_t* s, long pos, int bits_left, uint32_t id, const char* name, int value);
+    // free text, from h264_debug_printf()
+    void (*text)(h264_debug_sink_t* s, const char* text, int len);
+    // write out everything, ending whatever is still open
+    void (*flush)(h264_debug_sink_t* s);
+
+    // used by the built in sinks
+    FILE* file;
+    char* buf;
+    int size;
+    int used;
+    int in_nal;
+};
+
+/**
+   Name of a syntax element and its id, as listed in the tables generated into h264_stream.c, h264_sei.c and
+   h265_stream.c, each ending with a NULL name
+*/
+typedef struct
+{
+    uint32_t id;
+    const char* name;
+} h264_debug_name_t;
+
+extern const h264_debug_name_t h264_stream_debug_names[];
+extern const h264_debug_name_t h264_sei_debug_names[];
+extern const h264_debug_name_t h265_stream_debug_names[];
+
+// sink for read_debug_*, or NULL to print to h264_dbgfile
+extern h264_debug_sink_t* h264_dbgsink;
+// sink for read_debug_* in the calling thread only, used instead of h264_dbgsink when not NULL
+extern H264_THREAD_LOCAL h264_debug_sink_t* h264_dbgsink_thread;
+
+h264_debug_sink_t* h264_debug_sink_new(int format, FILE* file, int flags);
+void h264_debug_sink_free(h264_debug_sink_t* s);
+int h264_debug_add_names(const h264_debug_name_t* names);
+
+void h264_debug_nal(int64_t offset, int size);
+void h264_debug_value(long pos, int bits_left, uint32_t id, const char* name, int value);
+void h264_debug_printf(const char* format, ...);
+
+// h264_debug_sink_new() formats
+#define H264_DEBUG_NULL           0
+#define H264_DEBUG_TEXT           1
+#define H264_DEBUG_JSON           2
+#define H264_DEBUG_BINARY         3
+
+// h264_debug_sink_new() flags
+#define H264_DEBUG_NO_HEADER      1    // the output continues that of another sink: no binary header and names
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,45 +23,74 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "bs.h"
 #include "h264_stream.h"
 #include "h264_sei.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_NAL_SCAN_X86
+#include <immintrin.h>
+#endif
+
+// parameter set slots are carved out of chunks of this size, chained from h->arena
+#define H264_ARENA_CHUNK_SIZE (64*1024)
+
+struct h264_arena_chunk
+{
+    struct h264_arena_chunk* next;
+    size_t used;
+    size_t size;
+};
+
+// everything h264_new() used to allocate one by one, in a single block; h comes first so that free(h) frees it all
+typedef struct
+{
+    h264_stream_t h;
+    nal_t nal;
+    nal_svc_ext_t nal_svc_ext;
+    prefix_nal_svc_t prefix_nal_svc;
+    sps_t sps;
+    sps_subset_t sps_subset;
+    sps_t sps_subset_sps;
+    sps_svc_ext_t sps_subset_sps_svc_ext;
+    pps_t pps;
+    aud_t aud;
+    slice_header_t sh;
+    slice_header_svc_ext_t sh_svc_ext;
+    slice_data_rbsp_t slice_data;
+} h264_stream_block_t;
+
 /**
- Create a new H264 stream object.  Allocates all structures contained within it.
+ Create a new H264 stream object.  All structures contained within it come from one allocation;
+ the parameter set tables start out empty and their slots are created as parameter sets are seen.
  @return    the stream object
  */
 h264_stream_t* h264_new()
 {
-    h264_stream_t* h = (h264_stream_t*)calloc(1, sizeof(h264_stream_t));
-
-    h->nal = (nal_t*)calloc(1, sizeof(nal_t));
-    h->nal->nal_svc_ext = (nal_svc_ext_t*) calloc(1, sizeof(nal_svc_ext_t));
-    h->nal->prefix_nal_svc = (prefix_nal_svc_t*) calloc(1, sizeof(prefix_nal_svc_t));
-
-    // initialize tables
-    for ( int i = 0; i < 32; i++ ) { h->sps_table[i] = (sps_t*)calloc(1, sizeof(sps_t)); }
-    for ( int i = 0; i < 64; i++ )
-    {
-        h->sps_subset_table[i] = (sps_subset_t*)calloc(1, sizeof(sps_subset_t));
-        h->sps_subset_table[i]->sps = (sps_t*)calloc(1, sizeof(sps_t));
-        h->sps_subset_table[i]->sps_svc_ext = (sps_svc_ext_t*) calloc(1, sizeof(sps_svc_ext_t));
-    }
-    for ( int i = 0; i < 256; i++ ) { h->pps_table[i] = (pps_t*)calloc(1, sizeof(pps_t)); }
-
-    h->sps = (sps_t*)calloc(1, sizeof(sps_t));
-    h->sps_subset = (sps_subset_t*)calloc(1, sizeof(sps_subset_t));
-    h->sps_subset->sps = (sps_t*)calloc(1, sizeof(sps_t));
-    h->sps_subset->sps_svc_ext = (sps_svc_ext_t*)calloc(1, sizeof(sps_svc_ext_t));
-    h->pps = (pps_t*)calloc(1, sizeof(pps_t));
-    h->aud = (aud_t*)calloc(1, sizeof(aud_t));
+    h264_stream_block_t* blk = (h264_stream_block_t*)calloc(1, sizeof(h264_stream_block_t));
+    if (blk == NULL) { return NULL; }
+    h264_stream_t* h = &blk->h;
+
+    h->nal = &blk->nal;
+    h->nal->nal_svc_ext = &blk->nal_svc_ext;
+    h->nal->prefix_nal_svc = &blk->prefix_nal_svc;
+
+    h->sps = &blk->sps;
+    h->sps_subset = &blk->sps_subset;
+    h->sps_subset->sps = &blk->sps_subset_sps;
+    h->sps_subset->sps_svc_ext = &blk->sps_subset_sps_svc_ext;
+    h->pps = &blk->pps;
+    h->aud = &blk->aud;
     h->num_seis = 0;
     h->seis = NULL;
     h->sei = NULL;  //This is a TEMP pointer at whats in h->seis...
-    h->sh = (slice_header_t*)calloc(1, sizeof(slice_header_t));
-    h->sh_svc_ext = (slice_header_svc_ext_t*) calloc(1, sizeof(slice_header_svc_ext_t));
-    h->slice_data = (slice_data_rbsp_t*)calloc(1, sizeof(slice_data_rbsp_t));
+    h->sh = &blk->sh;
+    h->sh_svc_ext = &blk->sh_svc_ext;
+    h->slice_data = &blk->slice_data;
+    h->parse_depth = H264_PARSE_SLICE_DATA;
+    h->arena = NULL;
 
     return h;
 }
@@ -73,53 +102,416 @@ h264_stream_t* h264_new()
  */
 void h264_free(h264_stream_t* h)
 {
-    free(h->nal->nal_svc_ext);
-    free(h->nal->prefix_nal_svc);
-    free(h->nal);
-
-    for ( int i = 0; i < 32; i++ ) { free( h->sps_table[i] ); }
-    for ( int i = 0; i < 64; i++ )
-    {
-        if( h->sps_subset_table[i]->sps != NULL )
-            free( h->sps_subset_table[i]->sps );
-        if( h->sps_subset_table[i]->sps_svc_ext != NULL )
-            free( h->sps_subset_table[i]->sps_svc_ext );
-        free( h->sps_subset_table[i] );
-    }
-    for ( int i = 0; i < 256; i++ ) { free( h->pps_table[i] ); }
-
-    free(h->pps);
-    free(h->aud);
     if(h->seis != NULL)
     {
-        for( int i = 0; i < h->num_seis; i++ )
+        for( int i = 0; i < h->num_seis || i < h->sei_pool_size; i++ )
         {
             sei_t* sei = h->seis[i];
             sei_free(sei);
         }
         free(h->seis);
     }
-    free(h->sh);
 
-    if (h->sh_svc_ext != NULL) free(h->sh_svc_ext);
+    if (h->slice_data != NULL && h->slice_data->rbsp_buf != NULL)
+    {
+        free(h->slice_data->rbsp_buf);
+    }
+
+    while (h->arena != NULL)
+    {
+        struct h264_arena_chunk* next = h->arena->next;
+        free(h->arena);
+        h->arena = next;
+    }
+
+    free(h);
+}
+
+// zeroed memory that lives as long as the stream
+static void* _h264_arena_alloc(h264_stream_t* h, size_t size)
+{
+    size_t hdr = (sizeof(struct h264_arena_chunk) + 15) & ~(size_t)15;
+    size = (size + 15) & ~(size_t)15;
 
-    if (h->slice_data != NULL)
+    struct h264_arena_chunk* c = h->arena;
+    if (c == NULL || c->used + size > c->size)
     {
-        if (h->slice_data->rbsp_buf != NULL)
+        size_t chunk_size = (size > H264_ARENA_CHUNK_SIZE - hdr) ? size : H264_ARENA_CHUNK_SIZE - hdr;
+        c = (struct h264_arena_chunk*)calloc(1, hdr + chunk_size);
+        if (c == NULL) { return NULL; }
+        c->size = chunk_size;
+        // an oversized chunk goes behind the current one, which may still have room
+        if (h->arena != NULL && chunk_size == size)
+        {
+            c->next = h->arena->next;
+            h->arena->next = c;
+        }
+        else
         {
-            free(h->slice_data->rbsp_buf);
+            c->next = h->arena;
+            h->arena = c;
         }
+    }
+
+    void* p = (uint8_t*)c + hdr + c->used;
+    c->used += size;
+    return p;
+}
+
+/**
+ Get the SPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in,out] h   the stream object
+ @param[in] id      seq_parameter_set_id, 0..31
+ @return    the slot, or NULL if the id is out of range or the slot could not be allocated
+ */
+sps_t* h264_sps_slot(h264_stream_t* h, int id)
+{
+    if (id < 0 || id >= 32) { return NULL; }
+    if (h->sps_table[id] == NULL) { h->sps_table[id] = (sps_t*)_h264_arena_alloc(h, sizeof(sps_t)); }
+    return h->sps_table[id];
+}
+
+/**
+ Get the subset SPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in,out] h   the stream object
+ @param[in] id      seq_parameter_set_id, 0..63
+ @return    the slot, with its sps and sps_svc_ext, or NULL if the id is out of range or the slot could not be allocated
+ */
+sps_subset_t* h264_sps_subset_slot(h264_stream_t* h, int id)
+{
+    if (id < 0 || id >= 64) { return NULL; }
+    if (h->sps_subset_table[id] == NULL)
+    {
+        sps_subset_t* s = (sps_subset_t*)_h264_arena_alloc(h, sizeof(sps_subset_t));
+        sps_t* sps = (sps_t*)_h264_arena_alloc(h, sizeof(sps_t));
+        sps_svc_ext_t* sps_svc_ext = (sps_svc_ext_t*)_h264_arena_alloc(h, sizeof(sps_svc_ext_t));
+        if (s == NULL || sps == NULL || sps_svc_ext == NULL) { return NULL; }
+        s->sps = sps;
+        s->sps_svc_ext = sps_svc_ext;
+        h->sps_subset_table[id] = s;
+    }
+    return h->sps_subset_table[id];
+}
+
+/**
+ Get the PPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in,out] h   the stream object
+ @param[in] id      pic_parameter_set_id, 0..255
+ @return    the slot, or NULL if the id is out of range or the slot could not be allocated
+ */
+pps_t* h264_pps_slot(h264_stream_t* h, int id)
+{
+    if (id < 0 || id >= 256) { return NULL; }
+    if (h->pps_table[id] == NULL) { h->pps_table[id] = (pps_t*)_h264_arena_alloc(h, sizeof(pps_t)); }
+    return h->pps_table[id];
+}
 
-        free(h->slice_data);
+/**
+ Hash of the bytes of a NAL (64-bit FNV-1a), used to recognize parameter sets that are sent again unchanged.
+ @return    the hash, never 0
+ */
+uint64_t h264_nal_hash(const uint8_t* buf, int size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < size; i++)
+    {
+        hash = (hash ^ buf[i]) * 0x100000001b3ULL;
     }
+    return (hash == 0) ? 1 : hash;
+}
 
-    free(h->sps);
+/**
+ Hash of a parameter set NAL, as read storing the groups of values in extract (H264_EXTRACT_ALL for
+ read_nal_unit), so that a parameter set read by skip_nal_unit() is only taken for a repeat when it has been
+ read storing the same.
+ @return    the hash, never 0
+ */
+uint64_t h264_ps_hash(const uint8_t* buf, int size, int extract)
+{
+    uint64_t hash = h264_nal_hash(buf, size) ^ (uint64_t)(extract ^ H264_EXTRACT_ALL);
+    return (hash == 0) ? 1 : hash;
+}
 
-    free(h->sps_subset->sps);
-    free(h->sps_subset->sps_svc_ext);
-    free(h->sps_subset);
+/**
+ Check whether an SPS NAL has the same bytes as the one last read for its id.  If so, it becomes the current
+ SPS (h->sps) without being parsed again.
+ @param[in] b       the NAL, positioned just after the NAL header
+ @param[in] buf     the whole NAL, as passed to read_nal_unit
+ @param[in] extract what the caller stores, see h264_ps_hash
+ @return    1 if it is a repeat and has been handled, 0 if it needs to be parsed
+ */
+int h264_sps_resent(h264_stream_t* h, bs_t* b, const uint8_t* buf, int size, int extract)
+{
+    bs_t bs_id;
+    bs_clone(&bs_id, b);
+    bs_skip_u(&bs_id, 24); // profile_idc, constraint flags, level_idc
+    uint32_t id = bs_read_ue(&bs_id);
 
-    free(h);
+    if (id >= 32 || h->sps_table[id] == NULL || h->sps_table_hash[id] == 0) { return 0; }
+    if (h->sps_table_hash[id] != h264_ps_hash(buf, size, extract)) { return 0; }
+
+    if (h->sps_hash != h->sps_table_hash[id]) { h264_activate_sps(h, id); }
+    return 1;
+}
+
+/**
+ Check whether a PPS NAL has the same bytes as the one last read for its id.  If so, it becomes the current
+ PPS (h->pps) without being parsed again.
+ @param[in] b       the NAL, positioned just after the NAL header
+ @param[in] buf     the whole NAL, as passed to read_nal_unit
+ @param[in] extract what the caller stores, see h264_ps_hash
+ @return    1 if it is a repeat and has been handled, 0 if it needs to be parsed
+ */
+int h264_pps_resent(h264_stream_t* h, bs_t* b, const uint8_t* buf, int size, int extract)
+{
+    bs_t bs_id;
+    bs_clone(&bs_id, b);
+    uint32_t id = bs_read_ue(&bs_id);
+
+    if (id >= 256 || h->pps_table[id] == NULL || h->pps_table_hash[id] == 0) { return 0; }
+    if (h->pps_table_hash[id] != h264_ps_hash(buf, size, extract)) { return 0; }
+
+    if (h->pps_hash != h->pps_table_hash[id]) { h264_activate_pps(h, id); }
+    return 1;
+}
+
+/**
+ Make the SPS stored for an id the current one, copying it to h->sps unless h->sps already holds it.
+ Ids out of range are ignored.
+ */
+void h264_activate_sps(h264_stream_t* h, int id)
+{
+    if (id < 0 || id >= 32) { return; }
+    if (h->sps_hash == 0 || h->sps_hash != h->sps_table_hash[id])
+    {
+        sps_t* slot = h264_sps_slot(h, id);
+        if (slot == NULL) { return; }
+        memcpy(h->sps, slot, sizeof(sps_t));
+        h->sps_hash = h->sps_table_hash[id];
+    }
+}
+
+/**
+ Make the PPS stored for an id the current one, copying it to h->pps unless h->pps already holds it.
+ Ids out of range are ignored.
+ */
+void h264_activate_pps(h264_stream_t* h, int id)
+{
+    if (id < 0 || id >= 256) { return; }
+    if (h->pps_hash == 0 || h->pps_hash != h->pps_table_hash[id])
+    {
+        pps_t* slot = h264_pps_slot(h, id);
+        if (slot == NULL) { return; }
+        memcpy(h->pps, slot, sizeof(pps_t));
+        h->pps_hash = h->pps_table_hash[id];
+    }
+}
+
+/**
+ Copy everything that reading the next NALs depends on from one stream object to another: the parameter set
+ tables, the current SPS, subset SPS and PPS, and the last NAL header.  Reading the same NALs with either
+ object afterwards gives the same results, so the rest of a stream can be read with another object, for
+ example in another thread.
+ @param[in,out] dst   the stream object to copy to
+ @param[in] src       the stream object to copy from
+ */
+void h264_copy_state(h264_stream_t* dst, h264_stream_t* src)
+{
+    for (int i = 0; i < 32; i++)
+    {
+        if (src->sps_table[i] != NULL)
+        {
+            sps_t* slot = h264_sps_slot(dst, i);
+            if (slot != NULL) { memcpy(slot, src->sps_table[i], sizeof(sps_t)); }
+        }
+        else if (dst->sps_table[i] != NULL) { memset(dst->sps_table[i], 0, sizeof(sps_t)); }
+    }
+    for (int i = 0; i < 64; i++)
+    {
+        if (src->sps_subset_table[i] != NULL)
+        {
+            sps_subset_t* s = h264_sps_subset_slot(dst, i);
+            if (s == NULL) { continue; }
+            memcpy(s->sps, src->sps_subset_table[i]->sps, sizeof(sps_t));
+            memcpy(s->sps_svc_ext, src->sps_subset_table[i]->sps_svc_ext, sizeof(sps_svc_ext_t));
+            s->additional_extension2_flag = src->sps_subset_table[i]->additional_extension2_flag;
+        }
+        else if (dst->sps_subset_table[i] != NULL)
+        {
+            memset(dst->sps_subset_table[i]->sps, 0, sizeof(sps_t));
+            memset(dst->sps_subset_table[i]->sps_svc_ext, 0, sizeof(sps_svc_ext_t));
+            dst->sps_subset_table[i]->additional_extension2_flag = 0;
+        }
+    }
+    for (int i = 0; i < 256; i++)
+    {
+        if (src->pps_table[i] != NULL)
+        {
+            pps_t* slot = h264_pps_slot(dst, i);
+            if (slot != NULL) { memcpy(slot, src->pps_table[i], sizeof(pps_t)); }
+        }
+        else if (dst->pps_table[i] != NULL) { memset(dst->pps_table[i], 0, sizeof(pps_t)); }
+    }
+    memcpy(dst->sps_table_hash, src->sps_table_hash, sizeof(dst->sps_table_hash));
+    memcpy(dst->pps_table_hash, src->pps_table_hash, sizeof(dst->pps_table_hash));
+
+    memcpy(dst->sps, src->sps, sizeof(sps_t));
+    memcpy(dst->pps, src->pps, sizeof(pps_t));
+    dst->sps_hash = src->sps_hash;
+    dst->pps_hash = src->pps_hash;
+    memcpy(dst->sps_subset->sps, src->sps_subset->sps, sizeof(sps_t));
+    memcpy(dst->sps_subset->sps_svc_ext, src->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+    dst->sps_subset->additional_extension2_flag = src->sps_subset->additional_extension2_flag;
+
+    // the NAL header fields, keeping dst's own nested structures
+    dst->nal->forbidden_zero_bit = src->nal->forbidden_zero_bit;
+    dst->nal->nal_ref_idc = src->nal->nal_ref_idc;
+    dst->nal->nal_unit_type = src->nal->nal_unit_type;
+    dst->nal->svc_extension_flag = src->nal->svc_extension_flag;
+    dst->nal->avc_3d_extension_flag = src->nal->avc_3d_extension_flag;
+    memcpy(dst->nal->nal_svc_ext, src->nal->nal_svc_ext, sizeof(nal_svc_ext_t));
+    memcpy(dst->nal->prefix_nal_svc, src->nal->prefix_nal_svc, sizeof(prefix_nal_svc_t));
+}
+
+/**
+ Start code scan kernels.  Each returns the offset of the first pair of zero bytes at or after i
+ (both bytes inside the buffer), or size if there is none.  Every start code and every
+ end of a NAL begins with such a pair, and they are rare inside escaped NAL payloads.
+ */
+typedef int (*nal_scan_kernel_t)(const uint8_t* buf, int i, int size);
+
+static int _nal_scan_c(const uint8_t* buf, int i, int size)
+{
+    // look at every second byte; a zero pair always puts a zero on one of them
+    for ( ; i + 1 < size; i += 2)
+    {
+        if (buf[i+1] != 0) { continue; }
+        if (buf[i] == 0) { return i; }
+        if (i + 2 < size && buf[i+2] == 0) { return i + 1; }
+    }
+    return size;
+}
+
+#ifdef HAVE_NAL_SCAN_X86
+__attribute__((target("sse2")))
+static int _nal_scan_sse2(const uint8_t* buf, int i, int size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 17 <= size; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(buf + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(buf + i + 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, zero), _mm_cmpeq_epi8(b, zero)));
+        if (mask != 0) { return i + __builtin_ctz(mask); }
+    }
+    return _nal_scan_c(buf, i, size);
+}
+
+__attribute__((target("avx2")))
+static int _nal_scan_avx2(const uint8_t* buf, int i, int size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for ( ; i + 33 <= size; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(buf + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(buf + i + 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, zero), _mm256_cmpeq_epi8(b, zero)));
+        if (mask != 0) { return i + __builtin_ctz(mask); }
+    }
+    return _nal_scan_sse2(buf, i, size);
+}
+#endif
+
+static nal_scan_kernel_t _nal_scan = NULL;
+
+/**
+ Select the kernel used by find_nal_units().  By default the fastest one supported by the CPU is used.
+ @param[in]   kernel     one of NAL_SCAN_KERNEL_*
+ @return                 the kernel actually selected, which is a slower one if the CPU lacks support
+ */
+int nal_scan_set_kernel(int kernel)
+{
+#ifdef HAVE_NAL_SCAN_X86
+    __builtin_cpu_init();
+    if ((kernel == NAL_SCAN_KERNEL_AUTO || kernel == NAL_SCAN_KERNEL_AVX2) && __builtin_cpu_supports("avx2"))
+    {
+        _nal_scan = _nal_scan_avx2;
+        return NAL_SCAN_KERNEL_AVX2;
+    }
+    if (kernel != NAL_SCAN_KERNEL_C && __builtin_cpu_supports("sse2"))
+    {
+        _nal_scan = _nal_scan_sse2;
+        return NAL_SCAN_KERNEL_SSE2;
+    }
+#endif
+    _nal_scan = _nal_scan_c;
+    return NAL_SCAN_KERNEL_C;
+}
+
+static int _find_nal_units(uint8_t* buf, int size, nal_pos_t* nals, int max_nals, int is_last, int* pending_start)
+{
+    int n = 0;
+    int i = 0;
+    int start = -1;
+
+    if (_nal_scan == NULL) { nal_scan_set_kernel(NAL_SCAN_KERNEL_AUTO); }
+
+    while (n < max_nals)
+    {
+        i = _nal_scan(buf, i, size);
+        if (i + 2 >= size) { break; }
+        if (buf[i+2] > 0x01) { i += 3; continue; } // 00 00 02 and up, neither start nor end
+
+        // 00 00 00 or 00 00 01 ends the current NAL
+        if (start >= 0)
+        {
+            if (i > start)
+            {
+                nals[n].start = start;
+                nals[n].end = i;
+                n++;
+            }
+            start = -1;
+        }
+
+        if (buf[i+2] == 0x01) { start = i + 3; i += 3; }
+        else { i++; } // leading zero, may be followed by a start code
+    }
+
+    if (start >= 0 && is_last && n < max_nals)
+    {
+        // last NAL runs to the end of the data, minus any trailing_zero_8bits
+        int end = size;
+        while (end > start && buf[end-1] == 0x00) { end--; }
+        if (end > start)
+        {
+            nals[n].start = start;
+            nals[n].end = end;
+            n++;
+        }
+        start = -1;
+    }
+
+    *pending_start = start;
+    return n;
+}
+
+/**
+ Find all NAL units in a byte buffer containing H264 bitstream data in Annex B format.
+ Stops after max_nals units; call again starting from the end of the last one to get more.
+ @param[in]   buf        the buffer
+ @param[in]   size       the size of the buffer
+ @param[out]  nals       positions of the NALs found, relative to buf
+ @param[in]   max_nals   the number of entries in nals
+ @param[in]   is_last    nonzero if the buffer holds the end of the stream, so that the last NAL
+                         ends at the end of the buffer; otherwise a NAL not followed by another
+                         start code is incomplete and is not returned
+ @return                 the number of NALs found
+ */
+int find_nal_units(uint8_t* buf, int size, nal_pos_t* nals, int max_nals, int is_last)
+{
+    int pending_start;
+    return _find_nal_units(buf, size, nals, max_nals, is_last, &pending_start);
 }
 
 /**
@@ -130,45 +522,26 @@ void h264_free(h264_stream_t* h)
  @param[out]  nal_end    the end offset of the nal
  @return                 the length of the nal, or 0 if did not find start of nal, or -1 if did not find end of nal
  */
-// DEPRECATED - this will be replaced by a similar function with a slightly different API
+// DEPRECATED - use find_nal_units(), which finds all NALs in the buffer in one call
 int find_nal_unit(uint8_t* buf, int size, int* nal_start, int* nal_end)
 {
-    int i;
-    // find start
+    nal_pos_t nal;
+    int pending_start;
+
     *nal_start = 0;
     *nal_end = 0;
 
-    i = 0;
-    while (   //( next_bits( 24 ) != 0x000001 && next_bits( 32 ) != 0x00000001 )
-        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) &&
-        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0 || buf[i+3] != 0x01)
-        )
-    {
-        i++; // skip leading zero
-        if (i+4 >= size) { return 0; } // did not find nal start
-    }
-
-    if  (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) // ( next_bits( 24 ) != 0x000001 )
+    if (_find_nal_units(buf, size, &nal, 1, 0, &pending_start) == 1)
     {
-        i++;
+        *nal_start = nal.start;
+        *nal_end = nal.end;
+        return (*nal_end - *nal_start);
     }
+    if (pending_start < 0) { return 0; } // did not find nal start
 
-    if  (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01) { /* error, should never happen */ return 0; }
-    i+= 3;
-    *nal_start = i;
-
-    while (   //( next_bits( 24 ) != 0x000000 && next_bits( 24 ) != 0x000001 )
-        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0) &&
-        (buf[i] != 0 || buf[i+1] != 0 || buf[i+2] != 0x01)
-        )
-    {
-        i++;
-        // FIXME the next line fails when reading a nal that ends exactly at the end of the data
-        if (i+3 >= size) { *nal_end = size; return -1; } // did not find nal end, stream ended first
-    }
-
-    *nal_end = i;
-    return (*nal_end - *nal_start);
+    *nal_start = pending_start;
+    *nal_end = size;
+    return -1; // did not find nal end, stream ended first
 }
 
 
@@ -187,38 +560,38 @@ int find_nal_unit(uint8_t* buf, int size, int* nal_start, int* nal_end)
 // 7.4.1.1 Encapsulation of an SODB within an RBSP
 int rbsp_to_nal(const uint8_t* rbsp_buf, const int* rbsp_size, uint8_t* nal_buf, int* nal_size)
 {
-    int i;
+    int i     = 0;
     int j     = 0;
-    int count = 0;
+    int k;
 
-    // if (*nal_size > 0) { nal_buf[0] = 0x00; } // zero out first byte since we start writing from second byte
+    if (_nal_scan == NULL) { nal_scan_set_kernel(NAL_SCAN_KERNEL_AUTO); }
 
-    for ( i = 0; i < *rbsp_size ; )
+    // escapes are only needed after a pair of zero bytes, so copy everything up to and
+    // including the next pair as one run, then decide about the byte following it
+    while ( i < *rbsp_size )
     {
-        if ( j >= *nal_size )
+        k = _nal_scan(rbsp_buf, i, *rbsp_size);
+        k = (k < *rbsp_size) ? k + 2 : *rbsp_size;
+
+        if ( j + (k - i) > *nal_size )
         {
             // error, not enough space
             return -1;
         }
+        memcpy(nal_buf + j, rbsp_buf + i, k - i);
+        j += k - i;
+        i = k;
 
-        if ( ( count == 2 ) && !(rbsp_buf[i] & 0xFC) ) // HACK 0xFC
+        if ( ( i < *rbsp_size ) && !(rbsp_buf[i] & 0xFC) ) // HACK 0xFC
         {
+            if ( j >= *nal_size )
+            {
+                // error, not enough space
+                return -1;
+            }
             nal_buf[j] = 0x03;
             j++;
-            count = 0;
-            continue;
-        }
-        nal_buf[j] = rbsp_buf[i];
-        if ( rbsp_buf[i] == 0x00 )
-        {
-            count++;
-        }
-        else
-        {
-            count = 0;
         }
-        i++;
-        j++;
     }
 
     *nal_size = j;
@@ -235,57 +608,58 @@ int rbsp_to_nal(const uint8_t* rbsp_buf, const int* rbsp_size, uint8_t* nal_buf,
    @param[in,out] rbsp_buf   allocated memory in which to put the rbsp data
    @param[in,out] rbsp_size  as input, pointer to the maximum size of the rbsp data; as output, filled in with the actual size of rbsp data
    @return  actual size of rbsp data, or -1 on error
+   rbsp_buf may be the same as nal_buf, see nal_to_rbsp_inplace().
  */
 // 7.3.1 NAL unit syntax
 // 7.4.1.1 Encapsulation of an SODB within an RBSP
 int nal_to_rbsp(const uint8_t* nal_buf, int* nal_size, uint8_t* rbsp_buf, int* rbsp_size)
 {
-    int i;
+    int i     = 0;
     int j     = 0;
-    int count = 0;
+    int k;
 
-    for( i = 0; i < *nal_size; i++ )
+    if (_nal_scan == NULL) { nal_scan_set_kernel(NAL_SCAN_KERNEL_AUTO); }
+
+    // runs up to and including the next pair of zero bytes are copied as they are,
+    // only the byte following a pair needs checking
+    while ( i < *nal_size )
     {
+        k = _nal_scan(nal_buf, i, *nal_size);
+        k = (k < *nal_size) ? k + 2 : *nal_size;
+
+        if ( j + (k - i) > *rbsp_size )
+        {
+            // error, not enough space
+            return -1;
+        }
+        memmove(rbsp_buf + j, nal_buf + i, k - i); // may overlap when converting in place
+        j += k - i;
+        i = k;
+
+        if ( i >= *nal_size ) { break; }
+
         // in NAL unit, 0x000000, 0x000001 or 0x000002 shall not occur at any byte-aligned position
-        if( ( count == 2 ) && ( nal_buf[i] < 0x03) )
+        if ( nal_buf[i] < 0x03 )
         {
             return -1;
         }
 
-        if( ( count == 2 ) && ( nal_buf[i] == 0x03) )
+        if ( nal_buf[i] == 0x03 )
         {
             // check the 4th byte after 0x000003, except when cabac_zero_word is used, in which case the last three bytes of this NAL unit must be 0x000003
-            if((i < *nal_size - 1) && (nal_buf[i+1] > 0x03))
+            if ((i < *nal_size - 1) && (nal_buf[i+1] > 0x03))
             {
                 return -1;
             }
 
             // if cabac_zero_word is used, the final byte of this NAL unit(0x03) is discarded, and the last two bytes of RBSP must be 0x0000
-            if(i == *nal_size - 1)
+            if (i == *nal_size - 1)
             {
                 break;
             }
 
             i++;
-            count = 0;
-        }
-
-        if ( j >= *rbsp_size )
-        {
-            // error, not enough space
-            return -1;
         }
-
-        rbsp_buf[j] = nal_buf[i];
-        if(nal_buf[i] == 0x00)
-        {
-            count++;
-        }
-        else
-        {
-            count = 0;
-        }
-        j++;
     }
 
     *nal_size = i;
@@ -293,6 +667,20 @@ int nal_to_rbsp(const uint8_t* nal_buf, int* nal_size, uint8_t* rbsp_buf, int* r
     return j;
 }
 
+/**
+   Convert NAL data (Annex B format) to RBSP data in place, by removing the emulation prevention bytes.
+   @param[in,out] buf   the nal data; on return, holds the rbsp data
+   @param[in,out] size  as input, pointer to the size of the nal data; as output, filled in with the actual size of the rbsp data
+   @return  actual size of rbsp data, or -1 on error
+ */
+int nal_to_rbsp_inplace(uint8_t* buf, int* size)
+{
+    int nal_size = *size;
+    int rbsp_size = *size;
+    int rc = nal_to_rbsp(buf, &nal_size, buf, &rbsp_size);
+    if (rc >= 0) { *size = rbsp_size; }
+    return rc;
+}
 
 /**
  Read only the NAL headers (enough to determine unit type) from a byte buffer.
@@ -302,14 +690,14 @@ int peek_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 {
     nal_t* nal = h->nal;
 
-    bs_t* b = bs_new(buf, size);
+    bs_t bs;
+    bs_t* b = &bs;
+    bs_init(b, buf, size);
 
     nal->forbidden_zero_bit = bs_read_f(b,1);
     nal->nal_ref_idc = bs_read_u(b,2);
     nal->nal_unit_type = bs_read_u(b,5);
 
-    bs_free(b);
-
     // basic verification, per 7.4.1
     if ( nal->forbidden_zero_bit ) { return -1; }
     if ( nal->nal_unit_type <= 0 || nal->nal_unit_type > 20 ) { return -1; }
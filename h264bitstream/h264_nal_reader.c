@@ -0,0 +1,266 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAVE_NAL_READER_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#define HAVE_NAL_READER_MIRROR
+#endif
+
+#include "h264_stream.h"
+#include "h264_nal_reader.h"
+
+#define NAL_READER_SCAN_MAX 256
+
+struct nal_reader
+{
+    nal_reader_read_fn read;
+    void* opaque;
+    int fd;
+
+    uint8_t* buf;
+    int size;
+    int mirrored;       // buf is mapped twice in a row, see _nal_reader_ptr()
+    int64_t map_size;   // buf is the whole input file mapped, and there is nothing to read; see nal_reader_new_mmap()
+
+    // positions in the stream
+    int64_t base;       // of buf[0], when not mirrored
+    int64_t scan;       // end of the last NAL handed out: everything before it may be overwritten
+    int64_t tail;       // one past the last byte read
+    int64_t win;        // where the last find_nal_units() call started, nals are relative to it
+
+    nal_pos_t nals[NAL_READER_SCAN_MAX];
+    int n;
+    int i;
+    int eof;
+};
+
+// where a stream position is in memory.  With the mirror, bytes [pos, pos + size) are always contiguous
+static uint8_t* _nal_reader_ptr(nal_reader_t* r, int64_t pos)
+{
+    if (r->mirrored) { return r->buf + (pos % r->size); }
+    return r->buf + (pos - r->base);
+}
+
+#ifdef HAVE_NAL_READER_MIRROR
+// size bytes of memory mapped at p and again at p + size, or NULL if the system won't
+static uint8_t* _nal_reader_map_mirror(int size)
+{
+    uint8_t* p = NULL;
+    int fd = memfd_create("nal_reader", 0);
+    if (fd < 0) { return NULL; }
+
+    if (ftruncate(fd, size) == 0)
+    {
+        // reserve both halves, then put the same pages in each
+        uint8_t* v = (uint8_t*)mmap(NULL, 2 * (size_t)size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (v != MAP_FAILED)
+        {
+            if (mmap(v, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                mmap(v + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED)
+            {
+                p = v;
+            }
+            else
+            {
+                munmap(v, 2 * (size_t)size);
+            }
+        }
+    }
+    close(fd);
+    return p;
+}
+#endif
+
+static int _nal_reader_read_fd(void* opaque, uint8_t* buf, int size)
+{
+    ssize_t n;
+    do { n = read(*(int*)opaque, buf, size); } while (n < 0 && errno == EINTR);
+    return (int)n;
+}
+
+/**
+ Create a NAL reader.
+ @param[in] read    called to get more of the stream, with opaque
+ @param[in] size    size of the ring, which is the largest NAL that can be read; 0 for NAL_READER_DEFAULT_SIZE
+ @return    the reader, or NULL if the ring could not be allocated
+ */
+nal_reader_t* nal_reader_new(nal_reader_read_fn read, void* opaque, int size)
+{
+    nal_reader_t* r = (nal_reader_t*)calloc(1, sizeof(nal_reader_t));
+    if (r == NULL) { return NULL; }
+
+    if (size <= 0) { size = NAL_READER_DEFAULT_SIZE; }
+    r->read = read;
+    r->opaque = opaque;
+    r->fd = -1;
+
+#ifdef HAVE_NAL_READER_MIRROR
+    // the mirror halves have to start on page boundaries
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) { size = (int)((size + page - 1) / page * page); }
+    r->buf = _nal_reader_map_mirror(size);
+    r->mirrored = (r->buf != NULL);
+#endif
+    if (r->buf == NULL) { r->buf = (uint8_t*)malloc(size); }
+    if (r->buf == NULL) { free(r); return NULL; }
+    r->size = size;
+
+    return r;
+}
+
+/**
+ Create a NAL reader that reads from a file descriptor, which the reader does not close.
+ @see nal_reader_new
+ */
+nal_reader_t* nal_reader_new_fd(int fd, int size)
+{
+    nal_reader_t* r = nal_reader_new(_nal_reader_read_fd, NULL, size);
+    if (r == NULL) { return NULL; }
+    r->fd = fd;
+    r->opaque = &r->fd;
+    return r;
+}
+
+/**
+ Create a NAL reader over a file mapped into memory whole, so that the NALs are handed out straight from the
+ page cache without being read into a buffer.  The file descriptor is not used after this returns.
+ @param[in] fd      a regular file, open for reading
+ @param[in] size    largest NAL that can be read; 0 for no limit
+ @return    the reader, or NULL if the file could not be mapped (it is empty, a pipe, or the system can't)
+ */
+nal_reader_t* nal_reader_new_mmap(int fd, int size)
+{
+#ifdef HAVE_NAL_READER_MMAP
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) { return NULL; }
+    if ((uint64_t)st.st_size > SIZE_MAX) { return NULL; }
+
+    nal_reader_t* r = (nal_reader_t*)calloc(1, sizeof(nal_reader_t));
+    if (r == NULL) { return NULL; }
+
+    // private and writable, so the NALs can be changed in place like with the ring; pages are only copied if they are
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) { free(r); return NULL; }
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    // the size only bounds how far find_nal_units() looks at a time, which has to fit an int
+    if (size <= 0 || size > st.st_size) { size = st.st_size < INT_MAX ? (int)st.st_size : INT_MAX; }
+    r->buf = (uint8_t*)p;
+    r->size = size;
+    r->map_size = st.st_size;
+    r->fd = -1;
+    return r;
+#else
+    return NULL;
+#endif
+}
+
+void nal_reader_free(nal_reader_t* r)
+{
+#ifdef HAVE_NAL_READER_MMAP
+    if (r->map_size > 0) { munmap(r->buf, (size_t)r->map_size); }
+    else
+#endif
+#ifdef HAVE_NAL_READER_MIRROR
+    if (r->mirrored) { munmap(r->buf, 2 * (size_t)r->size); }
+    else
+#endif
+    { free(r->buf); }
+    free(r);
+}
+
+/**
+ Get the next NAL unit in the stream.  The view points into the reader's ring, and stays valid until the
+ next call.
+ @param[out] nal    the NAL, or with NAL_READER_DISCARDED the bytes that were skipped
+ @return    one of NAL_READER_*
+ */
+int nal_reader_next(nal_reader_t* r, nal_view_t* nal)
+{
+    while (1)
+    {
+        if (r->i < r->n)
+        {
+            nal_pos_t* pos = &r->nals[r->i++];
+            nal->data = _nal_reader_ptr(r, r->win) + pos->start;
+            nal->size = pos->end - pos->start;
+            nal->offset = r->win + pos->start;
+            nal->prefix_size = (int)(nal->offset - r->scan);
+            r->scan = r->win + pos->end;
+            return NAL_READER_NAL;
+        }
+
+        // a full batch may have stopped short of the data there is
+        if (r->n < NAL_READER_SCAN_MAX)
+        {
+            if (r->eof) { return NAL_READER_END; }
+
+            int free_size = r->size - (int)(r->tail - r->scan);
+            if (free_size == 0)
+            {
+                // a whole ring without the end of a NAL, skip it all
+                nal->data = _nal_reader_ptr(r, r->scan);
+                nal->size = r->size;
+                nal->offset = r->scan;
+                nal->prefix_size = 0;
+                r->scan = r->tail;
+                return NAL_READER_DISCARDED;
+            }
+
+            int n;
+            if (r->map_size > 0)
+            {
+                // the whole file is already there, only let the window over it move on
+                n = (int)(r->map_size - r->tail < free_size ? r->map_size - r->tail : free_size);
+            }
+            else
+            {
+                if (!r->mirrored && r->tail - r->base == r->size)
+                {
+                    // no room after the data, move what is left of it to the front
+                    memmove(r->buf, _nal_reader_ptr(r, r->scan), r->tail - r->scan);
+                    r->base = r->scan;
+                }
+                int room = r->mirrored ? free_size : r->size - (int)(r->tail - r->base);
+
+                n = r->read(r->opaque, _nal_reader_ptr(r, r->tail), room);
+                if (n < 0) { return NAL_READER_ERROR; }
+            }
+            if (n == 0) { r->eof = 1; } // the last NAL ends at the end of the stream
+            r->tail += n;
+        }
+
+        r->win = r->scan;
+        r->n = find_nal_units(_nal_reader_ptr(r, r->win), (int)(r->tail - r->win), r->nals, NAL_READER_SCAN_MAX, r->eof);
+        r->i = 0;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _H264_NAL_READER_H
+#define _H264_NAL_READER_H        1
+
+#include <stdint.h>
+
+#include "h264_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+   Reads an Annex B stream (H.264 or H.265, the start codes are the same) from a file descriptor or a
+   callback, and hands out the NAL units in it one at a time, in place in its buffer.
+
+   The buffer is a ring of fixed size, mapped twice in a row in memory where the system allows it, so that
+   every NAL in it is contiguous however it wraps around: the stream is read once into the ring and never
+   moved.  Elsewhere the incomplete NAL at the end of the ring is copied back to its start, as the tools did
+   before.  A NAL must fit in the ring; the default size is NAL_READER_DEFAULT_SIZE.
+
+   A regular file can instead be mapped into memory whole with nal_reader_new_mmap(), which has no ring and
+   no limit on the size of a NAL: the NALs are handed out straight from the page cache.
+*/
+
+#define NAL_READER_DEFAULT_SIZE   (32*1024*1024)
+
+/**
+   Read up to size bytes of the stream into buf.
+   @return    the number of bytes read, 0 at the end of the stream, or -1 on error
+*/
+typedef int (*nal_reader_read_fn)(void* opaque, uint8_t* buf, int size);
+
+/**
+   One NAL unit, or some bytes skipped, handed out by nal_reader_next()
+*/
+typedef struct
+{
+    uint8_t* data;      // first byte of the NAL, after the start code
+    int size;           // size of the NAL
+    int64_t offset;     // offset of data from the start of the stream
+    int prefix_size;    // bytes between the end of the previous NAL and data: the start code, and any zero or other bytes
+                        // before it.  They are in memory too, from data - prefix_size
+} nal_view_t;
+
+typedef struct nal_reader nal_reader_t;
+
+nal_reader_t* nal_reader_new(nal_reader_read_fn read, void* opaque, int size);
+nal_reader_t* nal_reader_new_fd(int fd, int size);
+nal_reader_t* nal_reader_new_mmap(int fd, int size);
+void nal_reader_free(nal_reader_t* r);
+int nal_reader_next(nal_reader_t* r, nal_view_t* nal);
+
+// nal_reader_next() return values
+#define NAL_READER_END            0    // end of the stream
+#define NAL_READER_NAL            1    // a NAL unit
+#define NAL_READER_DISCARDED      2    // the ring filled up without a whole NAL in it; the view holds the bytes skipped
+#define NAL_READER_ERROR         -1    // the read callback failed
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,6 +34,8 @@
 #include <stdlib.h> // malloc
 #include <string.h> // memset
 
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
+
 sei_t* sei_new()
 {
     sei_t* s = (sei_t*)calloc(1, sizeof(sei_t));
@@ -44,16 +46,37 @@ sei_t* sei_new()
 
 void sei_free(sei_t* s)
 {
+    // payloads set by the caller rather than read into the message's own storage
     switch( s->payloadType ) {
         case SEI_TYPE_SCALABILITY_INFO:
-            if ( s->sei_svc != NULL ) free(s->sei_svc);
+            if ( s->sei_svc != NULL && s->sei_svc != s->sei_svc_buf ) free(s->sei_svc);
             break;
         default:
-            if ( s->data != NULL ) free(s->data);
+            if ( s->data != NULL && s->data != s->data_buf ) free(s->data);
     }
+    free(s->data_buf);
+    free(s->sei_svc_buf);
     free(s);
 }
 
+/**
+ Make room for n messages in h->seis, reusing the messages left there by the previous SEI.
+ The pool grows geometrically and is only freed with the stream.
+ */
+void sei_pool_reserve(h264_stream_t* h, int n)
+{
+    if ( n <= h->sei_pool_size ) { return; }
+
+    int size = (h->sei_pool_size < 4) ? 4 : h->sei_pool_size * 2;
+    while ( size < n ) { size *= 2; }
+    h->seis = (sei_t**)realloc(h->seis, size * sizeof(sei_t*));
+    for ( int i = h->sei_pool_size; i < size; i++ )
+    {
+        h->seis[i] = sei_new();
+    }
+    h->sei_pool_size = size;
+}
+
 void read_sei_end_bits(h264_stream_t* h, bs_t* b )
 {
     // if the message doesn't end at a byte border
@@ -75,6 +98,8 @@ void read_sei_scalability_info( h264_stream_t* h, bs_t* b );
 void read_sei_payload( h264_stream_t* h, bs_t* b );
 
 
+
+
 // Appendix G.13.1.1 Scalability information SEI message syntax
 void read_sei_scalability_info( h264_stream_t* h, bs_t* b )
 {
@@ -259,18 +284,36 @@ void read_sei_payload( h264_stream_t* h, bs_t* b )
         case SEI_TYPE_SCALABILITY_INFO:
             if( 1 )
             {
-                s->sei_svc = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) );
+                if ( s->sei_svc_buf == NULL ) { s->sei_svc_buf = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) ); }
+                else { memset( s->sei_svc_buf, 0, sizeof(sei_scalability_info_t) ); }
+                s->sei_svc = s->sei_svc_buf;
             }
             read_sei_scalability_info( h, b );
             break;
         default:
             if( 1 )
             {
-                s->data = (uint8_t*)calloc(1, s->payloadSize);
+                if ( s->payloadSize > s->data_capacity )
+                {
+                    int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+                    s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+                    s->data_capacity = capacity;
+                }
+                s->data = s->data_buf;
             }
             
-            for ( i = 0; i < s->payloadSize; i++ )
-                s->data[i] = bs_read_u8(b);
+            if( 1 && !0 && bs_byte_aligned(b) )
+            {
+                int n = bs_read_bytes(b, s->data, s->payloadSize);
+                if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+            }
+            else
+            {
+                for ( i = 0; i < s->payloadSize; i++ )
+                {
+                    s->data[i] = bs_read_u8(b);
+                }
+            }
     }
     
     //if( 1 )
@@ -282,6 +325,8 @@ void write_sei_scalability_info( h264_stream_t* h, bs_t* b );
 void write_sei_payload( h264_stream_t* h, bs_t* b );
 
 
+
+
 // Appendix G.13.1.1 Scalability information SEI message syntax
 void write_sei_scalability_info( h264_stream_t* h, bs_t* b )
 {
@@ -466,18 +511,36 @@ void write_sei_payload( h264_stream_t* h, bs_t* b )
         case SEI_TYPE_SCALABILITY_INFO:
             if( 0 )
             {
-                s->sei_svc = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) );
+                if ( s->sei_svc_buf == NULL ) { s->sei_svc_buf = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) ); }
+                else { memset( s->sei_svc_buf, 0, sizeof(sei_scalability_info_t) ); }
+                s->sei_svc = s->sei_svc_buf;
             }
             write_sei_scalability_info( h, b );
             break;
         default:
             if( 0 )
             {
-                s->data = (uint8_t*)calloc(1, s->payloadSize);
+                if ( s->payloadSize > s->data_capacity )
+                {
+                    int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+                    s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+                    s->data_capacity = capacity;
+                }
+                s->data = s->data_buf;
             }
             
-            for ( i = 0; i < s->payloadSize; i++ )
-                bs_write_u8(b, s->data[i]);
+            if( 0 && !0 && bs_byte_aligned(b) )
+            {
+                int n = bs_read_bytes(b, s->data, s->payloadSize);
+                if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+            }
+            else
+            {
+                for ( i = 0; i < s->payloadSize; i++ )
+                {
+                    bs_write_u8(b, s->data[i]);
+                }
+            }
     }
     
     //if( 0 )
@@ -489,154 +552,156 @@ void read_debug_sei_scalability_info( h264_stream_t* h, bs_t* b );
 void read_debug_sei_payload( h264_stream_t* h, bs_t* b );
 
 
+
+
 // Appendix G.13.1.1 Scalability information SEI message syntax
 void read_debug_sei_scalability_info( h264_stream_t* h, bs_t* b )
 {
     sei_scalability_info_t* sei_svc = h->sei->sei_svc;
     
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->temporal_id_nesting_flag = bs_read_u1(b); printf("sei_svc->temporal_id_nesting_flag: %d \n", sei_svc->temporal_id_nesting_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->priority_layer_info_present_flag = bs_read_u1(b); printf("sei_svc->priority_layer_info_present_flag: %d \n", sei_svc->priority_layer_info_present_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->priority_id_setting_flag = bs_read_u1(b); printf("sei_svc->priority_id_setting_flag: %d \n", sei_svc->priority_id_setting_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->num_layers_minus1 = bs_read_ue(b); printf("sei_svc->num_layers_minus1: %d \n", sei_svc->num_layers_minus1); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->temporal_id_nesting_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA259A504u, "sei_svc->temporal_id_nesting_flag", sei_svc->temporal_id_nesting_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->priority_layer_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x39E7546Cu, "sei_svc->priority_layer_info_present_flag", sei_svc->priority_layer_info_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->priority_id_setting_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7D91C158u, "sei_svc->priority_id_setting_flag", sei_svc->priority_id_setting_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->num_layers_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x4231DA39u, "sei_svc->num_layers_minus1", sei_svc->num_layers_minus1); }
     
     for( int i = 0; i <= sei_svc->num_layers_minus1; i++ ) {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_id = bs_read_ue(b); printf("sei_svc->layers[i].layer_id: %d \n", sei_svc->layers[i].layer_id); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].priority_id = bs_read_u(b, 6); printf("sei_svc->layers[i].priority_id: %d \n", sei_svc->layers[i].priority_id); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].discardable_flag = bs_read_u1(b); printf("sei_svc->layers[i].discardable_flag: %d \n", sei_svc->layers[i].discardable_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].dependency_id = bs_read_u(b, 3); printf("sei_svc->layers[i].dependency_id: %d \n", sei_svc->layers[i].dependency_id); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].quality_id = bs_read_u(b, 4); printf("sei_svc->layers[i].quality_id: %d \n", sei_svc->layers[i].quality_id); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].temporal_id = bs_read_u(b, 3); printf("sei_svc->layers[i].temporal_id: %d \n", sei_svc->layers[i].temporal_id); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].sub_pic_layer_flag = bs_read_u1(b); printf("sei_svc->layers[i].sub_pic_layer_flag: %d \n", sei_svc->layers[i].sub_pic_layer_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].sub_region_layer_flag = bs_read_u1(b); printf("sei_svc->layers[i].sub_region_layer_flag: %d \n", sei_svc->layers[i].sub_region_layer_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].iroi_division_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].iroi_division_info_present_flag: %d \n", sei_svc->layers[i].iroi_division_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].profile_level_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].profile_level_info_present_flag: %d \n", sei_svc->layers[i].profile_level_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].bitrate_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].bitrate_info_present_flag: %d \n", sei_svc->layers[i].bitrate_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].frm_rate_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].frm_rate_info_present_flag: %d \n", sei_svc->layers[i].frm_rate_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].frm_size_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].frm_size_info_present_flag: %d \n", sei_svc->layers[i].frm_size_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_dependency_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].layer_dependency_info_present_flag: %d \n", sei_svc->layers[i].layer_dependency_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].parameter_sets_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].parameter_sets_info_present_flag: %d \n", sei_svc->layers[i].parameter_sets_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].bitstream_restriction_info_present_flag = bs_read_u1(b); printf("sei_svc->layers[i].bitstream_restriction_info_present_flag: %d \n", sei_svc->layers[i].bitstream_restriction_info_present_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].exact_inter_layer_pred_flag = bs_read_u1(b); printf("sei_svc->layers[i].exact_inter_layer_pred_flag: %d \n", sei_svc->layers[i].exact_inter_layer_pred_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7B8DA254u, "sei_svc->layers[i].layer_id", sei_svc->layers[i].layer_id); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].priority_id = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0x6A98FC89u, "sei_svc->layers[i].priority_id", sei_svc->layers[i].priority_id); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].discardable_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x727F185Eu, "sei_svc->layers[i].discardable_flag", sei_svc->layers[i].discardable_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].dependency_id = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xC53853DEu, "sei_svc->layers[i].dependency_id", sei_svc->layers[i].dependency_id); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].quality_id = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x50A24798u, "sei_svc->layers[i].quality_id", sei_svc->layers[i].quality_id); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].temporal_id = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xD5775607u, "sei_svc->layers[i].temporal_id", sei_svc->layers[i].temporal_id); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].sub_pic_layer_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF9DE4F15u, "sei_svc->layers[i].sub_pic_layer_flag", sei_svc->layers[i].sub_pic_layer_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].sub_region_layer_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6076B561u, "sei_svc->layers[i].sub_region_layer_flag", sei_svc->layers[i].sub_region_layer_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].iroi_division_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x8128073Eu, "sei_svc->layers[i].iroi_division_info_present_flag", sei_svc->layers[i].iroi_division_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].profile_level_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF41BB395u, "sei_svc->layers[i].profile_level_info_present_flag", sei_svc->layers[i].profile_level_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].bitrate_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFBF4E6E8u, "sei_svc->layers[i].bitrate_info_present_flag", sei_svc->layers[i].bitrate_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].frm_rate_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC4A1F20Du, "sei_svc->layers[i].frm_rate_info_present_flag", sei_svc->layers[i].frm_rate_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].frm_size_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x995F4902u, "sei_svc->layers[i].frm_size_info_present_flag", sei_svc->layers[i].frm_size_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_dependency_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC309DA34u, "sei_svc->layers[i].layer_dependency_info_present_flag", sei_svc->layers[i].layer_dependency_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].parameter_sets_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6A8366F2u, "sei_svc->layers[i].parameter_sets_info_present_flag", sei_svc->layers[i].parameter_sets_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].bitstream_restriction_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9A9E0857u, "sei_svc->layers[i].bitstream_restriction_info_present_flag", sei_svc->layers[i].bitstream_restriction_info_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].exact_inter_layer_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7483B52Cu, "sei_svc->layers[i].exact_inter_layer_pred_flag", sei_svc->layers[i].exact_inter_layer_pred_flag); }
         if( sei_svc->layers[i].sub_pic_layer_flag ||
             sei_svc->layers[i].iroi_division_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].exact_sample_value_match_flag = bs_read_u1(b); printf("sei_svc->layers[i].exact_sample_value_match_flag: %d \n", sei_svc->layers[i].exact_sample_value_match_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].exact_sample_value_match_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD4E08624u, "sei_svc->layers[i].exact_sample_value_match_flag", sei_svc->layers[i].exact_sample_value_match_flag); }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_conversion_flag = bs_read_u1(b); printf("sei_svc->layers[i].layer_conversion_flag: %d \n", sei_svc->layers[i].layer_conversion_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_output_flag = bs_read_u1(b); printf("sei_svc->layers[i].layer_output_flag: %d \n", sei_svc->layers[i].layer_output_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_conversion_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x702815E4u, "sei_svc->layers[i].layer_conversion_flag", sei_svc->layers[i].layer_conversion_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_output_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA9164147u, "sei_svc->layers[i].layer_output_flag", sei_svc->layers[i].layer_output_flag); }
         if( sei_svc->layers[i].profile_level_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_profile_level_idc = bs_read_u(b, 24); printf("sei_svc->layers[i].layer_profile_level_idc: %d \n", sei_svc->layers[i].layer_profile_level_idc); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_profile_level_idc = bs_read_u(b, 24); h264_debug_value(_pos, _bits_left, 0xAB7DC3E2u, "sei_svc->layers[i].layer_profile_level_idc", sei_svc->layers[i].layer_profile_level_idc); }
         }
         if( sei_svc->layers[i].bitrate_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].avg_bitrate = bs_read_u(b, 16); printf("sei_svc->layers[i].avg_bitrate: %d \n", sei_svc->layers[i].avg_bitrate); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_bitrate_layer = bs_read_u(b, 16); printf("sei_svc->layers[i].max_bitrate_layer: %d \n", sei_svc->layers[i].max_bitrate_layer); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_bitrate_layer_representation = bs_read_u(b, 16); printf("sei_svc->layers[i].max_bitrate_layer_representation: %d \n", sei_svc->layers[i].max_bitrate_layer_representation); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_bitrate_calc_window = bs_read_u(b, 16); printf("sei_svc->layers[i].max_bitrate_calc_window: %d \n", sei_svc->layers[i].max_bitrate_calc_window); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].avg_bitrate = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x8C173B73u, "sei_svc->layers[i].avg_bitrate", sei_svc->layers[i].avg_bitrate); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_bitrate_layer = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x93A2FFC3u, "sei_svc->layers[i].max_bitrate_layer", sei_svc->layers[i].max_bitrate_layer); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_bitrate_layer_representation = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x08D12689u, "sei_svc->layers[i].max_bitrate_layer_representation", sei_svc->layers[i].max_bitrate_layer_representation); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_bitrate_calc_window = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x7340EAA0u, "sei_svc->layers[i].max_bitrate_calc_window", sei_svc->layers[i].max_bitrate_calc_window); }
         }
         if( sei_svc->layers[i].frm_rate_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].constant_frm_rate_idc = bs_read_u(b, 2); printf("sei_svc->layers[i].constant_frm_rate_idc: %d \n", sei_svc->layers[i].constant_frm_rate_idc); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].avg_frm_rate = bs_read_u(b, 16); printf("sei_svc->layers[i].avg_frm_rate: %d \n", sei_svc->layers[i].avg_frm_rate); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].constant_frm_rate_idc = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xC0998423u, "sei_svc->layers[i].constant_frm_rate_idc", sei_svc->layers[i].constant_frm_rate_idc); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].avg_frm_rate = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x4CA864B8u, "sei_svc->layers[i].avg_frm_rate", sei_svc->layers[i].avg_frm_rate); }
         }
         if( sei_svc->layers[i].frm_size_info_present_flag ||
             sei_svc->layers[i].iroi_division_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].frm_width_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].frm_width_in_mbs_minus1: %d \n", sei_svc->layers[i].frm_width_in_mbs_minus1); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].frm_height_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].frm_height_in_mbs_minus1: %d \n", sei_svc->layers[i].frm_height_in_mbs_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].frm_width_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE985B55Cu, "sei_svc->layers[i].frm_width_in_mbs_minus1", sei_svc->layers[i].frm_width_in_mbs_minus1); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].frm_height_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x89C032A1u, "sei_svc->layers[i].frm_height_in_mbs_minus1", sei_svc->layers[i].frm_height_in_mbs_minus1); }
         }
         if( sei_svc->layers[i].sub_region_layer_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].base_region_layer_id = bs_read_ue(b); printf("sei_svc->layers[i].base_region_layer_id: %d \n", sei_svc->layers[i].base_region_layer_id); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].dynamic_rect_flag = bs_read_u1(b); printf("sei_svc->layers[i].dynamic_rect_flag: %d \n", sei_svc->layers[i].dynamic_rect_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].base_region_layer_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBF2B9977u, "sei_svc->layers[i].base_region_layer_id", sei_svc->layers[i].base_region_layer_id); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].dynamic_rect_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x09900302u, "sei_svc->layers[i].dynamic_rect_flag", sei_svc->layers[i].dynamic_rect_flag); }
             if( sei_svc->layers[i].dynamic_rect_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].horizontal_offset = bs_read_u(b, 16); printf("sei_svc->layers[i].horizontal_offset: %d \n", sei_svc->layers[i].horizontal_offset); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].vertical_offset = bs_read_u(b, 16); printf("sei_svc->layers[i].vertical_offset: %d \n", sei_svc->layers[i].vertical_offset); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].region_width = bs_read_u(b, 16); printf("sei_svc->layers[i].region_width: %d \n", sei_svc->layers[i].region_width); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].region_height = bs_read_u(b, 16); printf("sei_svc->layers[i].region_height: %d \n", sei_svc->layers[i].region_height); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].horizontal_offset = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x0BA1A18Fu, "sei_svc->layers[i].horizontal_offset", sei_svc->layers[i].horizontal_offset); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].vertical_offset = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0xF2F087B1u, "sei_svc->layers[i].vertical_offset", sei_svc->layers[i].vertical_offset); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].region_width = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0xF389E910u, "sei_svc->layers[i].region_width", sei_svc->layers[i].region_width); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].region_height = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x88EC4107u, "sei_svc->layers[i].region_height", sei_svc->layers[i].region_height); }
             }
         }
         if( sei_svc->layers[i].sub_pic_layer_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].roi_id = bs_read_ue(b); printf("sei_svc->layers[i].roi_id: %d \n", sei_svc->layers[i].roi_id); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].roi_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x89A1FBCDu, "sei_svc->layers[i].roi_id", sei_svc->layers[i].roi_id); }
         }
         if( sei_svc->layers[i].iroi_division_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].iroi_grid_flag = bs_read_u1(b); printf("sei_svc->layers[i].iroi_grid_flag: %d \n", sei_svc->layers[i].iroi_grid_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].iroi_grid_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDF07E11Cu, "sei_svc->layers[i].iroi_grid_flag", sei_svc->layers[i].iroi_grid_flag); }
             if( sei_svc->layers[i].iroi_grid_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].grid_width_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].grid_width_in_mbs_minus1: %d \n", sei_svc->layers[i].grid_width_in_mbs_minus1); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].grid_height_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].grid_height_in_mbs_minus1: %d \n", sei_svc->layers[i].grid_height_in_mbs_minus1); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].grid_width_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7E15D829u, "sei_svc->layers[i].grid_width_in_mbs_minus1", sei_svc->layers[i].grid_width_in_mbs_minus1); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].grid_height_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xFC6456AAu, "sei_svc->layers[i].grid_height_in_mbs_minus1", sei_svc->layers[i].grid_height_in_mbs_minus1); }
             }
             else
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].num_rois_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].num_rois_minus1: %d \n", sei_svc->layers[i].num_rois_minus1); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].num_rois_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x83941F19u, "sei_svc->layers[i].num_rois_minus1", sei_svc->layers[i].num_rois_minus1); }
                 
                 for( int j = 0; j <= sei_svc->layers[i].num_rois_minus1; j++ )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].roi[j].first_mb_in_roi = bs_read_ue(b); printf("sei_svc->layers[i].roi[j].first_mb_in_roi: %d \n", sei_svc->layers[i].roi[j].first_mb_in_roi); 
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1: %d \n", sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1); 
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1: %d \n", sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].roi[j].first_mb_in_roi = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7A8FE060u, "sei_svc->layers[i].roi[j].first_mb_in_roi", sei_svc->layers[i].roi[j].first_mb_in_roi); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDEAB4D6Bu, "sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1", sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB5A4D370u, "sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1", sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1); }
                 }
             }
         }
         if( sei_svc->layers[i].layer_dependency_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].num_directly_dependent_layers = bs_read_ue(b); printf("sei_svc->layers[i].num_directly_dependent_layers: %d \n", sei_svc->layers[i].num_directly_dependent_layers); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].num_directly_dependent_layers = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD7A9DC63u, "sei_svc->layers[i].num_directly_dependent_layers", sei_svc->layers[i].num_directly_dependent_layers); }
             for( int j = 0; j < sei_svc->layers[i].num_directly_dependent_layers; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j] = bs_read_ue(b); printf("sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j]: %d \n", sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x18661FDAu, "sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j]", sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j]); }
             }
         }
         else
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].layer_dependency_info_src_layer_id_delta = bs_read_ue(b); printf("sei_svc->layers[i].layer_dependency_info_src_layer_id_delta: %d \n", sei_svc->layers[i].layer_dependency_info_src_layer_id_delta); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].layer_dependency_info_src_layer_id_delta = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x2F12EBCFu, "sei_svc->layers[i].layer_dependency_info_src_layer_id_delta", sei_svc->layers[i].layer_dependency_info_src_layer_id_delta); }
         }
         if( sei_svc->layers[i].parameter_sets_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].num_seq_parameter_sets = bs_read_ue(b); printf("sei_svc->layers[i].num_seq_parameter_sets: %d \n", sei_svc->layers[i].num_seq_parameter_sets); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].num_seq_parameter_sets = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x5E1C8B7Fu, "sei_svc->layers[i].num_seq_parameter_sets", sei_svc->layers[i].num_seq_parameter_sets); }
             for( int j = 0; j < sei_svc->layers[i].num_seq_parameter_sets; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].seq_parameter_set_id_delta[j] = bs_read_ue(b); printf("sei_svc->layers[i].seq_parameter_set_id_delta[j]: %d \n", sei_svc->layers[i].seq_parameter_set_id_delta[j]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].seq_parameter_set_id_delta[j] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x60F4C29Eu, "sei_svc->layers[i].seq_parameter_set_id_delta[j]", sei_svc->layers[i].seq_parameter_set_id_delta[j]); }
             }
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].num_subset_seq_parameter_sets = bs_read_ue(b); printf("sei_svc->layers[i].num_subset_seq_parameter_sets: %d \n", sei_svc->layers[i].num_subset_seq_parameter_sets); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].num_subset_seq_parameter_sets = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC4CC16BCu, "sei_svc->layers[i].num_subset_seq_parameter_sets", sei_svc->layers[i].num_subset_seq_parameter_sets); }
             for( int j = 0; j < sei_svc->layers[i].num_subset_seq_parameter_sets; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].subset_seq_parameter_set_id_delta[j] = bs_read_ue(b); printf("sei_svc->layers[i].subset_seq_parameter_set_id_delta[j]: %d \n", sei_svc->layers[i].subset_seq_parameter_set_id_delta[j]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].subset_seq_parameter_set_id_delta[j] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8632C2D5u, "sei_svc->layers[i].subset_seq_parameter_set_id_delta[j]", sei_svc->layers[i].subset_seq_parameter_set_id_delta[j]); }
             }
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].num_pic_parameter_sets_minus1 = bs_read_ue(b); printf("sei_svc->layers[i].num_pic_parameter_sets_minus1: %d \n", sei_svc->layers[i].num_pic_parameter_sets_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].num_pic_parameter_sets_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x38AC4160u, "sei_svc->layers[i].num_pic_parameter_sets_minus1", sei_svc->layers[i].num_pic_parameter_sets_minus1); }
             for( int j = 0; j < sei_svc->layers[i].num_pic_parameter_sets_minus1; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].pic_parameter_set_id_delta[j] = bs_read_ue(b); printf("sei_svc->layers[i].pic_parameter_set_id_delta[j]: %d \n", sei_svc->layers[i].pic_parameter_set_id_delta[j]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].pic_parameter_set_id_delta[j] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBB75C681u, "sei_svc->layers[i].pic_parameter_set_id_delta[j]", sei_svc->layers[i].pic_parameter_set_id_delta[j]); }
             }
         }
         else
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].parameter_sets_info_src_layer_id_delta = bs_read_ue(b); printf("sei_svc->layers[i].parameter_sets_info_src_layer_id_delta: %d \n", sei_svc->layers[i].parameter_sets_info_src_layer_id_delta); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].parameter_sets_info_src_layer_id_delta = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB4084AF1u, "sei_svc->layers[i].parameter_sets_info_src_layer_id_delta", sei_svc->layers[i].parameter_sets_info_src_layer_id_delta); }
         }
         if( sei_svc->layers[i].bitstream_restriction_info_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); printf("sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag: %d \n", sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_bytes_per_pic_denom = bs_read_ue(b); printf("sei_svc->layers[i].max_bytes_per_pic_denom: %d \n", sei_svc->layers[i].max_bytes_per_pic_denom); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_bits_per_mb_denom = bs_read_ue(b); printf("sei_svc->layers[i].max_bits_per_mb_denom: %d \n", sei_svc->layers[i].max_bits_per_mb_denom); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].log2_max_mv_length_horizontal = bs_read_ue(b); printf("sei_svc->layers[i].log2_max_mv_length_horizontal: %d \n", sei_svc->layers[i].log2_max_mv_length_horizontal); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].log2_max_mv_length_vertical = bs_read_ue(b); printf("sei_svc->layers[i].log2_max_mv_length_vertical: %d \n", sei_svc->layers[i].log2_max_mv_length_vertical); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_num_reorder_frames = bs_read_ue(b); printf("sei_svc->layers[i].max_num_reorder_frames: %d \n", sei_svc->layers[i].max_num_reorder_frames); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].max_dec_frame_buffering = bs_read_ue(b); printf("sei_svc->layers[i].max_dec_frame_buffering: %d \n", sei_svc->layers[i].max_dec_frame_buffering); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x11E26AD0u, "sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag", sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_bytes_per_pic_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x197DAF54u, "sei_svc->layers[i].max_bytes_per_pic_denom", sei_svc->layers[i].max_bytes_per_pic_denom); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_bits_per_mb_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x89F650AEu, "sei_svc->layers[i].max_bits_per_mb_denom", sei_svc->layers[i].max_bits_per_mb_denom); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].log2_max_mv_length_horizontal = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x48B9D62Au, "sei_svc->layers[i].log2_max_mv_length_horizontal", sei_svc->layers[i].log2_max_mv_length_horizontal); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].log2_max_mv_length_vertical = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x936D0D5Cu, "sei_svc->layers[i].log2_max_mv_length_vertical", sei_svc->layers[i].log2_max_mv_length_vertical); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_num_reorder_frames = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x900A29BBu, "sei_svc->layers[i].max_num_reorder_frames", sei_svc->layers[i].max_num_reorder_frames); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].max_dec_frame_buffering = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x63689393u, "sei_svc->layers[i].max_dec_frame_buffering", sei_svc->layers[i].max_dec_frame_buffering); }
         }
         if( sei_svc->layers[i].layer_conversion_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].conversion_type_idc = bs_read_ue(b); printf("sei_svc->layers[i].conversion_type_idc: %d \n", sei_svc->layers[i].conversion_type_idc); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].conversion_type_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x16514685u, "sei_svc->layers[i].conversion_type_idc", sei_svc->layers[i].conversion_type_idc); }
             for( int j = 0; j < 2; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].rewriting_info_flag[j] = bs_read_u(b, 1); printf("sei_svc->layers[i].rewriting_info_flag[j]: %d \n", sei_svc->layers[i].rewriting_info_flag[j]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].rewriting_info_flag[j] = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0xB911F522u, "sei_svc->layers[i].rewriting_info_flag[j]", sei_svc->layers[i].rewriting_info_flag[j]); }
                 if( sei_svc->layers[i].rewriting_info_flag[j] )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].rewriting_profile_level_idc[j] = bs_read_u(b, 24); printf("sei_svc->layers[i].rewriting_profile_level_idc[j]: %d \n", sei_svc->layers[i].rewriting_profile_level_idc[j]); 
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].rewriting_avg_bitrate[j] = bs_read_u(b, 16); printf("sei_svc->layers[i].rewriting_avg_bitrate[j]: %d \n", sei_svc->layers[i].rewriting_avg_bitrate[j]); 
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->layers[i].rewriting_max_bitrate[j] = bs_read_u(b, 16); printf("sei_svc->layers[i].rewriting_max_bitrate[j]: %d \n", sei_svc->layers[i].rewriting_max_bitrate[j]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].rewriting_profile_level_idc[j] = bs_read_u(b, 24); h264_debug_value(_pos, _bits_left, 0xD1FB7E50u, "sei_svc->layers[i].rewriting_profile_level_idc[j]", sei_svc->layers[i].rewriting_profile_level_idc[j]); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].rewriting_avg_bitrate[j] = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x77CC8DE9u, "sei_svc->layers[i].rewriting_avg_bitrate[j]", sei_svc->layers[i].rewriting_avg_bitrate[j]); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->layers[i].rewriting_max_bitrate[j] = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x1B665F6Fu, "sei_svc->layers[i].rewriting_max_bitrate[j]", sei_svc->layers[i].rewriting_max_bitrate[j]); }
                 }
             }
         }
@@ -644,17 +709,17 @@ void read_debug_sei_scalability_info( h264_stream_t* h, bs_t* b )
 
     if( sei_svc->priority_layer_info_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr_num_dIds_minus1 = bs_read_ue(b); printf("sei_svc->pr_num_dIds_minus1: %d \n", sei_svc->pr_num_dIds_minus1); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr_num_dIds_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x81B01604u, "sei_svc->pr_num_dIds_minus1", sei_svc->pr_num_dIds_minus1); }
         
         for( int i = 0; i <= sei_svc->pr_num_dIds_minus1; i++ ) {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_dependency_id = bs_read_u(b, 3); printf("sei_svc->pr[i].pr_dependency_id: %d \n", sei_svc->pr[i].pr_dependency_id); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_num_minus1 = bs_read_ue(b); printf("sei_svc->pr[i].pr_num_minus1: %d \n", sei_svc->pr[i].pr_num_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_dependency_id = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x378CDF0Du, "sei_svc->pr[i].pr_dependency_id", sei_svc->pr[i].pr_dependency_id); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_num_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7967DDA4u, "sei_svc->pr[i].pr_num_minus1", sei_svc->pr[i].pr_num_minus1); }
             for( int j = 0; j <= sei_svc->pr[i].pr_num_minus1; j++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_info[j].pr_id = bs_read_ue(b); printf("sei_svc->pr[i].pr_info[j].pr_id: %d \n", sei_svc->pr[i].pr_info[j].pr_id); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_info[j].pr_profile_level_idc = bs_read_u(b, 24); printf("sei_svc->pr[i].pr_info[j].pr_profile_level_idc: %d \n", sei_svc->pr[i].pr_info[j].pr_profile_level_idc); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_info[j].pr_avg_bitrate = bs_read_u(b, 16); printf("sei_svc->pr[i].pr_info[j].pr_avg_bitrate: %d \n", sei_svc->pr[i].pr_info[j].pr_avg_bitrate); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sei_svc->pr[i].pr_info[j].pr_max_bitrate = bs_read_u(b, 16); printf("sei_svc->pr[i].pr_info[j].pr_max_bitrate: %d \n", sei_svc->pr[i].pr_info[j].pr_max_bitrate); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_info[j].pr_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x11BA107Au, "sei_svc->pr[i].pr_info[j].pr_id", sei_svc->pr[i].pr_info[j].pr_id); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_info[j].pr_profile_level_idc = bs_read_u(b, 24); h264_debug_value(_pos, _bits_left, 0xB732C698u, "sei_svc->pr[i].pr_info[j].pr_profile_level_idc", sei_svc->pr[i].pr_info[j].pr_profile_level_idc); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_info[j].pr_avg_bitrate = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x6590BB67u, "sei_svc->pr[i].pr_info[j].pr_avg_bitrate", sei_svc->pr[i].pr_info[j].pr_avg_bitrate); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sei_svc->pr[i].pr_info[j].pr_max_bitrate = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x239D36D1u, "sei_svc->pr[i].pr_info[j].pr_max_bitrate", sei_svc->pr[i].pr_info[j].pr_max_bitrate); }
             }
         }
         
@@ -673,20 +738,347 @@ void read_debug_sei_payload( h264_stream_t* h, bs_t* b )
         case SEI_TYPE_SCALABILITY_INFO:
             if( 1 )
             {
-                s->sei_svc = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) );
+                if ( s->sei_svc_buf == NULL ) { s->sei_svc_buf = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) ); }
+                else { memset( s->sei_svc_buf, 0, sizeof(sei_scalability_info_t) ); }
+                s->sei_svc = s->sei_svc_buf;
             }
             read_debug_sei_scalability_info( h, b );
             break;
         default:
             if( 1 )
             {
-                s->data = (uint8_t*)calloc(1, s->payloadSize);
+                if ( s->payloadSize > s->data_capacity )
+                {
+                    int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+                    s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+                    s->data_capacity = capacity;
+                }
+                s->data = s->data_buf;
             }
             
-            for ( i = 0; i < s->payloadSize; i++ )
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); s->data[i] = bs_read_u8(b); printf("s->data[i]: %d \n", s->data[i]); 
+            if( 1 && !1 && bs_byte_aligned(b) )
+            {
+                int n = bs_read_bytes(b, s->data, s->payloadSize);
+                if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+            }
+            else
+            {
+                for ( i = 0; i < s->payloadSize; i++ )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; s->data[i] = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x248457B0u, "s->data[i]", s->data[i]); }
+                }
+            }
     }
     
     //if( 1 )
     //    read_sei_end_bits(h, b);
 }
+
+
+void skip_sei_scalability_info(h264_stream_t* h, int extract, bs_t* b );
+void skip_sei_payload(h264_stream_t* h, int extract, bs_t* b );
+
+
+
+
+// Appendix G.13.1.1 Scalability information SEI message syntax
+void skip_sei_scalability_info(h264_stream_t* h, int extract, bs_t* b )
+{
+    sei_scalability_info_t* sei_svc = h->sei->sei_svc;
+    
+    if (extract & H264_EXTRACT_SEI) { sei_svc->temporal_id_nesting_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    sei_svc->priority_layer_info_present_flag = bs_read_u1(b);
+    if (extract & H264_EXTRACT_SEI) { sei_svc->priority_id_setting_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    sei_svc->num_layers_minus1 = bs_read_ue(b);
+    
+    for( int i = 0; i <= sei_svc->num_layers_minus1; i++ ) {
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].layer_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].priority_id = bs_read_u(b, 6); } else { bs_skip_u(b, 6); }
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].discardable_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].dependency_id = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].quality_id = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].temporal_id = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+        sei_svc->layers[i].sub_pic_layer_flag = bs_read_u1(b);
+        sei_svc->layers[i].sub_region_layer_flag = bs_read_u1(b);
+        sei_svc->layers[i].iroi_division_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].profile_level_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].bitrate_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].frm_rate_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].frm_size_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].layer_dependency_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].parameter_sets_info_present_flag = bs_read_u1(b);
+        sei_svc->layers[i].bitstream_restriction_info_present_flag = bs_read_u1(b);
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].exact_inter_layer_pred_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if( sei_svc->layers[i].sub_pic_layer_flag ||
+            sei_svc->layers[i].iroi_division_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].exact_sample_value_match_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+        sei_svc->layers[i].layer_conversion_flag = bs_read_u1(b);
+        if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].layer_output_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if( sei_svc->layers[i].profile_level_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].layer_profile_level_idc = bs_read_u(b, 24); } else { bs_skip_u(b, 24); }
+        }
+        if( sei_svc->layers[i].bitrate_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].avg_bitrate = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_bitrate_layer = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_bitrate_layer_representation = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_bitrate_calc_window = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+        }
+        if( sei_svc->layers[i].frm_rate_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].constant_frm_rate_idc = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].avg_frm_rate = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+        }
+        if( sei_svc->layers[i].frm_size_info_present_flag ||
+            sei_svc->layers[i].iroi_division_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].frm_width_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].frm_height_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        if( sei_svc->layers[i].sub_region_layer_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].base_region_layer_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+            sei_svc->layers[i].dynamic_rect_flag = bs_read_u1(b);
+            if( sei_svc->layers[i].dynamic_rect_flag )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].horizontal_offset = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].vertical_offset = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].region_width = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].region_height = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            }
+        }
+        if( sei_svc->layers[i].sub_pic_layer_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].roi_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        if( sei_svc->layers[i].iroi_division_info_present_flag )
+        {
+            sei_svc->layers[i].iroi_grid_flag = bs_read_u1(b);
+            if( sei_svc->layers[i].iroi_grid_flag )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].grid_width_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].grid_height_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+            else
+            {
+                sei_svc->layers[i].num_rois_minus1 = bs_read_ue(b);
+                
+                for( int j = 0; j <= sei_svc->layers[i].num_rois_minus1; j++ )
+                {
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].roi[j].first_mb_in_roi = bs_read_ue(b); } else { bs_skip_ue(b); }
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+            }
+        }
+        if( sei_svc->layers[i].layer_dependency_info_present_flag )
+        {
+            sei_svc->layers[i].num_directly_dependent_layers = bs_read_ue(b);
+            for( int j = 0; j < sei_svc->layers[i].num_directly_dependent_layers; j++ )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        }
+        else
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].layer_dependency_info_src_layer_id_delta = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        if( sei_svc->layers[i].parameter_sets_info_present_flag )
+        {
+            sei_svc->layers[i].num_seq_parameter_sets = bs_read_ue(b);
+            for( int j = 0; j < sei_svc->layers[i].num_seq_parameter_sets; j++ )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].seq_parameter_set_id_delta[j] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+            sei_svc->layers[i].num_subset_seq_parameter_sets = bs_read_ue(b);
+            for( int j = 0; j < sei_svc->layers[i].num_subset_seq_parameter_sets; j++ )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].subset_seq_parameter_set_id_delta[j] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+            sei_svc->layers[i].num_pic_parameter_sets_minus1 = bs_read_ue(b);
+            for( int j = 0; j < sei_svc->layers[i].num_pic_parameter_sets_minus1; j++ )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].pic_parameter_set_id_delta[j] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        }
+        else
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].parameter_sets_info_src_layer_id_delta = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        if( sei_svc->layers[i].bitstream_restriction_info_present_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_bytes_per_pic_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_bits_per_mb_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].log2_max_mv_length_horizontal = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].log2_max_mv_length_vertical = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_num_reorder_frames = bs_read_ue(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].max_dec_frame_buffering = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        if( sei_svc->layers[i].layer_conversion_flag )
+        {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].conversion_type_idc = bs_read_ue(b); } else { bs_skip_ue(b); }
+            for( int j = 0; j < 2; j++ )
+            {
+                sei_svc->layers[i].rewriting_info_flag[j] = bs_read_u(b, 1);
+                if( sei_svc->layers[i].rewriting_info_flag[j] )
+                {
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].rewriting_profile_level_idc[j] = bs_read_u(b, 24); } else { bs_skip_u(b, 24); }
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].rewriting_avg_bitrate[j] = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                    if (extract & H264_EXTRACT_SEI) { sei_svc->layers[i].rewriting_max_bitrate[j] = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                }
+            }
+        }
+    }
+
+    if( sei_svc->priority_layer_info_present_flag )
+    {
+        sei_svc->pr_num_dIds_minus1 = bs_read_ue(b);
+        
+        for( int i = 0; i <= sei_svc->pr_num_dIds_minus1; i++ ) {
+            if (extract & H264_EXTRACT_SEI) { sei_svc->pr[i].pr_dependency_id = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+            sei_svc->pr[i].pr_num_minus1 = bs_read_ue(b);
+            for( int j = 0; j <= sei_svc->pr[i].pr_num_minus1; j++ )
+            {
+                if (extract & H264_EXTRACT_SEI) { sei_svc->pr[i].pr_info[j].pr_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->pr[i].pr_info[j].pr_profile_level_idc = bs_read_u(b, 24); } else { bs_skip_u(b, 24); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->pr[i].pr_info[j].pr_avg_bitrate = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+                if (extract & H264_EXTRACT_SEI) { sei_svc->pr[i].pr_info[j].pr_max_bitrate = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            }
+        }
+        
+    }
+
+}
+
+// D.1 SEI payload syntax
+void skip_sei_payload(h264_stream_t* h, int extract, bs_t* b )
+{
+    sei_t* s = h->sei;
+    
+    int i;
+    switch( s->payloadType )
+    {
+        case SEI_TYPE_SCALABILITY_INFO:
+            if( 1 )
+            {
+                if ( s->sei_svc_buf == NULL ) { s->sei_svc_buf = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) ); }
+                else { memset( s->sei_svc_buf, 0, sizeof(sei_scalability_info_t) ); }
+                s->sei_svc = s->sei_svc_buf;
+            }
+            skip_sei_scalability_info(h, extract, b );
+            break;
+        default:
+            if( 1 )
+            {
+                if ( s->payloadSize > s->data_capacity )
+                {
+                    int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+                    s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+                    s->data_capacity = capacity;
+                }
+                s->data = s->data_buf;
+            }
+            
+            if( 1 && !0 && bs_byte_aligned(b) )
+            {
+                int n = bs_read_bytes(b, s->data, s->payloadSize);
+                if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+            }
+            else
+            {
+                for ( i = 0; i < s->payloadSize; i++ )
+                {
+                    s->data[i] = bs_read_u8(b);
+                }
+            }
+    }
+    
+    //if( 1 )
+    //    read_sei_end_bits(h, b);
+}
+
+const h264_debug_name_t h264_sei_debug_names[] =
+{
+    { 0xA259A504, "sei_svc->temporal_id_nesting_flag" },
+    { 0x39E7546C, "sei_svc->priority_layer_info_present_flag" },
+    { 0x7D91C158, "sei_svc->priority_id_setting_flag" },
+    { 0x4231DA39, "sei_svc->num_layers_minus1" },
+    { 0x7B8DA254, "sei_svc->layers[i].layer_id" },
+    { 0x6A98FC89, "sei_svc->layers[i].priority_id" },
+    { 0x727F185E, "sei_svc->layers[i].discardable_flag" },
+    { 0xC53853DE, "sei_svc->layers[i].dependency_id" },
+    { 0x50A24798, "sei_svc->layers[i].quality_id" },
+    { 0xD5775607, "sei_svc->layers[i].temporal_id" },
+    { 0xF9DE4F15, "sei_svc->layers[i].sub_pic_layer_flag" },
+    { 0x6076B561, "sei_svc->layers[i].sub_region_layer_flag" },
+    { 0x8128073E, "sei_svc->layers[i].iroi_division_info_present_flag" },
+    { 0xF41BB395, "sei_svc->layers[i].profile_level_info_present_flag" },
+    { 0xFBF4E6E8, "sei_svc->layers[i].bitrate_info_present_flag" },
+    { 0xC4A1F20D, "sei_svc->layers[i].frm_rate_info_present_flag" },
+    { 0x995F4902, "sei_svc->layers[i].frm_size_info_present_flag" },
+    { 0xC309DA34, "sei_svc->layers[i].layer_dependency_info_present_flag" },
+    { 0x6A8366F2, "sei_svc->layers[i].parameter_sets_info_present_flag" },
+    { 0x9A9E0857, "sei_svc->layers[i].bitstream_restriction_info_present_flag" },
+    { 0x7483B52C, "sei_svc->layers[i].exact_inter_layer_pred_flag" },
+    { 0xD4E08624, "sei_svc->layers[i].exact_sample_value_match_flag" },
+    { 0x702815E4, "sei_svc->layers[i].layer_conversion_flag" },
+    { 0xA9164147, "sei_svc->layers[i].layer_output_flag" },
+    { 0xAB7DC3E2, "sei_svc->layers[i].layer_profile_level_idc" },
+    { 0x8C173B73, "sei_svc->layers[i].avg_bitrate" },
+    { 0x93A2FFC3, "sei_svc->layers[i].max_bitrate_layer" },
+    { 0x08D12689, "sei_svc->layers[i].max_bitrate_layer_representation" },
+    { 0x7340EAA0, "sei_svc->layers[i].max_bitrate_calc_window" },
+    { 0xC0998423, "sei_svc->layers[i].constant_frm_rate_idc" },
+    { 0x4CA864B8, "sei_svc->layers[i].avg_frm_rate" },
+    { 0xE985B55C, "sei_svc->layers[i].frm_width_in_mbs_minus1" },
+    { 0x89C032A1, "sei_svc->layers[i].frm_height_in_mbs_minus1" },
+    { 0xBF2B9977, "sei_svc->layers[i].base_region_layer_id" },
+    { 0x09900302, "sei_svc->layers[i].dynamic_rect_flag" },
+    { 0x0BA1A18F, "sei_svc->layers[i].horizontal_offset" },
+    { 0xF2F087B1, "sei_svc->layers[i].vertical_offset" },
+    { 0xF389E910, "sei_svc->layers[i].region_width" },
+    { 0x88EC4107, "sei_svc->layers[i].region_height" },
+    { 0x89A1FBCD, "sei_svc->layers[i].roi_id" },
+    { 0xDF07E11C, "sei_svc->layers[i].iroi_grid_flag" },
+    { 0x7E15D829, "sei_svc->layers[i].grid_width_in_mbs_minus1" },
+    { 0xFC6456AA, "sei_svc->layers[i].grid_height_in_mbs_minus1" },
+    { 0x83941F19, "sei_svc->layers[i].num_rois_minus1" },
+    { 0x7A8FE060, "sei_svc->layers[i].roi[j].first_mb_in_roi" },
+    { 0xDEAB4D6B, "sei_svc->layers[i].roi[j].roi_width_in_mbs_minus1" },
+    { 0xB5A4D370, "sei_svc->layers[i].roi[j].roi_height_in_mbs_minus1" },
+    { 0xD7A9DC63, "sei_svc->layers[i].num_directly_dependent_layers" },
+    { 0x18661FDA, "sei_svc->layers[i].directly_dependent_layer_id_delta_minus1[j]" },
+    { 0x2F12EBCF, "sei_svc->layers[i].layer_dependency_info_src_layer_id_delta" },
+    { 0x5E1C8B7F, "sei_svc->layers[i].num_seq_parameter_sets" },
+    { 0x60F4C29E, "sei_svc->layers[i].seq_parameter_set_id_delta[j]" },
+    { 0xC4CC16BC, "sei_svc->layers[i].num_subset_seq_parameter_sets" },
+    { 0x8632C2D5, "sei_svc->layers[i].subset_seq_parameter_set_id_delta[j]" },
+    { 0x38AC4160, "sei_svc->layers[i].num_pic_parameter_sets_minus1" },
+    { 0xBB75C681, "sei_svc->layers[i].pic_parameter_set_id_delta[j]" },
+    { 0xB4084AF1, "sei_svc->layers[i].parameter_sets_info_src_layer_id_delta" },
+    { 0x11E26AD0, "sei_svc->layers[i].motion_vectors_over_pic_boundaries_flag" },
+    { 0x197DAF54, "sei_svc->layers[i].max_bytes_per_pic_denom" },
+    { 0x89F650AE, "sei_svc->layers[i].max_bits_per_mb_denom" },
+    { 0x48B9D62A, "sei_svc->layers[i].log2_max_mv_length_horizontal" },
+    { 0x936D0D5C, "sei_svc->layers[i].log2_max_mv_length_vertical" },
+    { 0x900A29BB, "sei_svc->layers[i].max_num_reorder_frames" },
+    { 0x63689393, "sei_svc->layers[i].max_dec_frame_buffering" },
+    { 0x16514685, "sei_svc->layers[i].conversion_type_idc" },
+    { 0xB911F522, "sei_svc->layers[i].rewriting_info_flag[j]" },
+    { 0xD1FB7E50, "sei_svc->layers[i].rewriting_profile_level_idc[j]" },
+    { 0x77CC8DE9, "sei_svc->layers[i].rewriting_avg_bitrate[j]" },
+    { 0x1B665F6F, "sei_svc->layers[i].rewriting_max_bitrate[j]" },
+    { 0x81B01604, "sei_svc->pr_num_dIds_minus1" },
+    { 0x378CDF0D, "sei_svc->pr[i].pr_dependency_id" },
+    { 0x7967DDA4, "sei_svc->pr[i].pr_num_minus1" },
+    { 0x11BA107A, "sei_svc->pr[i].pr_info[j].pr_id" },
+    { 0xB732C698, "sei_svc->pr[i].pr_info[j].pr_profile_level_idc" },
+    { 0x6590BB67, "sei_svc->pr[i].pr_info[j].pr_avg_bitrate" },
+    { 0x239D36D1, "sei_svc->pr[i].pr_info[j].pr_max_bitrate" },
+    { 0x248457B0, "s->data[i]" },
+    { 0, NULL }
+};
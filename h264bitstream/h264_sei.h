@@ -143,6 +143,11 @@ typedef struct
         sei_scalability_info_t* sei_svc;
         uint8_t* data;
     };
+
+    // payload storage owned by the message, kept when h264_stream_t reuses it for the next SEI
+    uint8_t* data_buf;
+    int data_capacity;
+    sei_scalability_info_t* sei_svc_buf;
 } sei_t;
 
 sei_t* sei_new();
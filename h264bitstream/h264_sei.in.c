@@ -34,6 +34,8 @@
 #include <stdlib.h> // malloc
 #include <string.h> // memset
 
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
+
 sei_t* sei_new()
 {
     sei_t* s = (sei_t*)calloc(1, sizeof(sei_t));
@@ -44,16 +46,37 @@ sei_t* sei_new()
 
 void sei_free(sei_t* s)
 {
+    // payloads set by the caller rather than read into the message's own storage
     switch( s->payloadType ) {
         case SEI_TYPE_SCALABILITY_INFO:
-            if ( s->sei_svc != NULL ) free(s->sei_svc);
+            if ( s->sei_svc != NULL && s->sei_svc != s->sei_svc_buf ) free(s->sei_svc);
             break;
         default:
-            if ( s->data != NULL ) free(s->data);
+            if ( s->data != NULL && s->data != s->data_buf ) free(s->data);
     }
+    free(s->data_buf);
+    free(s->sei_svc_buf);
     free(s);
 }
 
+/**
+ Make room for n messages in h->seis, reusing the messages left there by the previous SEI.
+ The pool grows geometrically and is only freed with the stream.
+ */
+void sei_pool_reserve(h264_stream_t* h, int n)
+{
+    if ( n <= h->sei_pool_size ) { return; }
+
+    int size = (h->sei_pool_size < 4) ? 4 : h->sei_pool_size * 2;
+    while ( size < n ) { size *= 2; }
+    h->seis = (sei_t**)realloc(h->seis, size * sizeof(sei_t*));
+    for ( int i = h->sei_pool_size; i < size; i++ )
+    {
+        h->seis[i] = sei_new();
+    }
+    h->sei_pool_size = size;
+}
+
 void read_sei_end_bits(h264_stream_t* h, bs_t* b )
 {
     // if the message doesn't end at a byte border
@@ -73,6 +96,10 @@ void read_sei_end_bits(h264_stream_t* h, bs_t* b )
 
 #function_declarations
 
+#debug_names h264_sei_debug_names
+
+#extract H264_EXTRACT_SEI sei_scalability_info
+
 // Appendix G.13.1.1 Scalability information SEI message syntax
 void structure(sei_scalability_info)( h264_stream_t* h, bs_t* b )
 {
@@ -257,18 +284,36 @@ void structure(sei_payload)( h264_stream_t* h, bs_t* b )
         case SEI_TYPE_SCALABILITY_INFO:
             if( is_reading )
             {
-                s->sei_svc = (uint8_t*)calloc( 1, sizeof(sei_scalability_info_t) );
+                if ( s->sei_svc_buf == NULL ) { s->sei_svc_buf = (sei_scalability_info_t*)calloc( 1, sizeof(sei_scalability_info_t) ); }
+                else { memset( s->sei_svc_buf, 0, sizeof(sei_scalability_info_t) ); }
+                s->sei_svc = s->sei_svc_buf;
             }
             structure(sei_scalability_info)( h, b );
             break;
         default:
             if( is_reading )
             {
-                s->data = (uint8_t*)calloc(1, s->payloadSize);
+                if ( s->payloadSize > s->data_capacity )
+                {
+                    int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+                    s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+                    s->data_capacity = capacity;
+                }
+                s->data = s->data_buf;
             }
             
-            for ( i = 0; i < s->payloadSize; i++ )
-                value( s->data[i], u8 );
+            if( is_reading && !is_debugging && bs_byte_aligned(b) )
+            {
+                int n = bs_read_bytes(b, s->data, s->payloadSize);
+                if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+            }
+            else
+            {
+                for ( i = 0; i < s->payloadSize; i++ )
+                {
+                    value( s->data[i], u8 );
+                }
+            }
     }
     
     //if( is_reading )
@@ -1253,7 +1253,7 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
     {
         while( !bs_byte_aligned(b) )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); int cabac_alignment_one_bit = bs_read_u(b, 1); printf("cabac_alignment_one_bit: %d \n", cabac_alignment_one_bit); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int cabac_alignment_one_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x64E4D914u, "cabac_alignment_one_bit", cabac_alignment_one_bit); }
         }
     }
     int CurrMbAddr = h->sh->first_mb_in_slice * ( 1 + MbaffFrameFlag );
@@ -1267,7 +1267,7 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
         {
             if( !h->pps->entropy_coding_mode_flag )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); mb_skip_run = bs_read_ue(b); printf("mb_skip_run: %d \n", mb_skip_run); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; mb_skip_run = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x80E3AC0Au, "mb_skip_run", mb_skip_run); }
                 prevMbSkipped = ( mb_skip_run > 0 );
                 for( int i=0; i<mb_skip_run; i++ )
                 {
@@ -1277,7 +1277,7 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
             }
             else
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); mb_skip_flag = bs_read_ae(b); printf("mb_skip_flag: %d \n", mb_skip_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; mb_skip_flag = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0x03203E17u, "mb_skip_flag", mb_skip_flag); }
                 moreDataFlag = !mb_skip_flag;
             }
         }
@@ -1286,8 +1286,8 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
             if( MbaffFrameFlag && ( CurrMbAddr % 2 == 0 ||
                                     ( CurrMbAddr % 2 == 1 && prevMbSkipped ) ) )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mb_field_decoding_flag = bs_read_ae(b); }
-                else { mb->mb_field_decoding_flag = bs_read_u(b, 1); } printf("mb->mb_field_decoding_flag: %d \n", mb->mb_field_decoding_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mb_field_decoding_flag = bs_read_ae(b); }
+                else { mb->mb_field_decoding_flag = bs_read_u(b, 1); } h264_debug_value(_pos, _bits_left, 0x9FAC16E6u, "mb->mb_field_decoding_flag", mb->mb_field_decoding_flag); }
             }
             read_debug_macroblock_layer( h, b );
         }
@@ -1308,7 +1308,7 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
             else
             {
                 int end_of_slice_flag;
-                printf("%d.%d: ", b->p - b->start, b->bits_left); end_of_slice_flag = bs_read_ae(b); printf("end_of_slice_flag: %d \n", end_of_slice_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; end_of_slice_flag = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0xBAD6214Au, "end_of_slice_flag", end_of_slice_flag); }
                 moreDataFlag = !end_of_slice_flag;
             }
         }
@@ -1321,21 +1321,21 @@ void read_debug_slice_data( h264_stream_t* h, bs_t* b )
 void read_debug_macroblock_layer( h264_stream_t* h, bs_t* b )
 {
     macroblock_t* mb;
-    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mb_type = bs_read_ae(b); }
-    else { mb->mb_type = bs_read_ue(b); } printf("mb->mb_type: %d \n", mb->mb_type); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mb_type = bs_read_ae(b); }
+    else { mb->mb_type = bs_read_ue(b); } h264_debug_value(_pos, _bits_left, 0xF9713D5Bu, "mb->mb_type", mb->mb_type); }
     if( mb->mb_type == I_PCM )
     {
         while( !bs_byte_aligned(b) )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); // ERROR: value( pcm_alignment_zero_bit, f(1) ); printf("pcm_alignment_zero_bit: %d \n", pcm_alignment_zero_bit); 
+            // ERROR: value( pcm_alignment_zero_bit, f(1) );
         }
         for( int i = 0; i < 256; i++ )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); mb->pcm_sample_luma[ i ] = bs_read_u8(b); printf("mb->pcm_sample_luma[ i ]: %d \n", mb->pcm_sample_luma[ i ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; mb->pcm_sample_luma[ i ] = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x0E6BD0CFu, "mb->pcm_sample_luma[ i ]", mb->pcm_sample_luma[ i ]); }
         }
         for( int i = 0; i < 2 * MbWidthC * MbHeightC; i++ )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); mb->pcm_sample_chroma[ i ] = bs_read_u8(b); printf("mb->pcm_sample_chroma[ i ]: %d \n", mb->pcm_sample_chroma[ i ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; mb->pcm_sample_chroma[ i ] = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xDE7ACCEAu, "mb->pcm_sample_chroma[ i ]", mb->pcm_sample_chroma[ i ]); }
         }
     }
     else
@@ -1365,29 +1365,29 @@ void read_debug_macroblock_layer( h264_stream_t* h, bs_t* b )
         {
             if( h->pps->transform_8x8_mode_flag && mb->mb_type == I_NxN )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->transform_size_8x8_flag = bs_read_ae(b); }
-                else { mb->transform_size_8x8_flag = bs_read_u(b, 1); } printf("mb->transform_size_8x8_flag: %d \n", mb->transform_size_8x8_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->transform_size_8x8_flag = bs_read_ae(b); }
+                else { mb->transform_size_8x8_flag = bs_read_u(b, 1); } h264_debug_value(_pos, _bits_left, 0x00F78839u, "mb->transform_size_8x8_flag", mb->transform_size_8x8_flag); }
             }
             read_debug_mb_pred( h, b, mb->mb_type );
         }
         if( MbPartPredMode( mb->mb_type, 0 ) != Intra_16x16 )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->coded_block_pattern = bs_read_ae(b); }
-            else { mb->coded_block_pattern = bs_read_me(b); } printf("mb->coded_block_pattern: %d \n", mb->coded_block_pattern); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->coded_block_pattern = bs_read_ae(b); }
+            else { mb->coded_block_pattern = bs_read_me(b); } h264_debug_value(_pos, _bits_left, 0x654632BFu, "mb->coded_block_pattern", mb->coded_block_pattern); }
             if( CodedBlockPatternLuma > 0 &&
                 h->pps->transform_8x8_mode_flag && mb->mb_type != I_NxN &&
                 noSubMbPartSizeLessThan8x8Flag &&
                 ( mb->mb_type != B_Direct_16x16 || h->sps->direct_8x8_inference_flag ) )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->transform_size_8x8_flag = bs_read_ae(b); }
-                else { mb->transform_size_8x8_flag = bs_read_u(b, 1); } printf("mb->transform_size_8x8_flag: %d \n", mb->transform_size_8x8_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->transform_size_8x8_flag = bs_read_ae(b); }
+                else { mb->transform_size_8x8_flag = bs_read_u(b, 1); } h264_debug_value(_pos, _bits_left, 0x00F78839u, "mb->transform_size_8x8_flag", mb->transform_size_8x8_flag); }
             }
         }
         if( CodedBlockPatternLuma > 0 || CodedBlockPatternChroma > 0 ||
             MbPartPredMode( mb->mb_type, 0 ) == Intra_16x16 )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mb_qp_delta = bs_read_ae(b); }
-            else { mb->mb_qp_delta = bs_read_se(b); } printf("mb->mb_qp_delta: %d \n", mb->mb_qp_delta); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mb_qp_delta = bs_read_ae(b); }
+            else { mb->mb_qp_delta = bs_read_se(b); } h264_debug_value(_pos, _bits_left, 0x9FC6A6BFu, "mb->mb_qp_delta", mb->mb_qp_delta); }
             read_debug_residual( h, b );
         }
     }
@@ -1406,12 +1406,12 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
         {
             for( int luma4x4BlkIdx=0; luma4x4BlkIdx<16; luma4x4BlkIdx++ )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ] = bs_read_ae(b); }
-                else { mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ] = bs_read_u(b, 1); } printf("mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ]: %d \n", mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ] = bs_read_ae(b); }
+                else { mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ] = bs_read_u(b, 1); } h264_debug_value(_pos, _bits_left, 0x98BF35F7u, "mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ]", mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ]); }
                 if( !mb->prev_intra4x4_pred_mode_flag[ luma4x4BlkIdx ] )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ] = bs_read_ae(b); }
-                    else { mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ] = bs_read_u(b, 3); } printf("mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ]: %d \n", mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ] = bs_read_ae(b); }
+                    else { mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ] = bs_read_u(b, 3); } h264_debug_value(_pos, _bits_left, 0xFF05F5CFu, "mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ]", mb->rem_intra4x4_pred_mode[ luma4x4BlkIdx ]); }
                 }
             }
         }
@@ -1419,19 +1419,19 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
         {
             for( int luma8x8BlkIdx=0; luma8x8BlkIdx<4; luma8x8BlkIdx++ )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ] = bs_read_ae(b); }
-                else { mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ] = bs_read_u(b, 1); } printf("mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ]: %d \n", mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ] = bs_read_ae(b); }
+                else { mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ] = bs_read_u(b, 1); } h264_debug_value(_pos, _bits_left, 0x99D8E7D7u, "mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ]", mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ]); }
                 if( !mb->prev_intra8x8_pred_mode_flag[ luma8x8BlkIdx ] )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ] = bs_read_ae(b); }
-                    else { mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ] = bs_read_u(b, 3); } printf("mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ]: %d \n", mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ] = bs_read_ae(b); }
+                    else { mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ] = bs_read_u(b, 3); } h264_debug_value(_pos, _bits_left, 0xBC9B7EDFu, "mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ]", mb->rem_intra8x8_pred_mode[ luma8x8BlkIdx ]); }
                 }
             }
         }
         if( h->sps->chroma_format_idc != 0 )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->intra_chroma_pred_mode = bs_read_ae(b); }
-            else { mb->intra_chroma_pred_mode = bs_read_ue(b); } printf("mb->intra_chroma_pred_mode: %d \n", mb->intra_chroma_pred_mode); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->intra_chroma_pred_mode = bs_read_ae(b); }
+            else { mb->intra_chroma_pred_mode = bs_read_ue(b); } h264_debug_value(_pos, _bits_left, 0x6B4AC422u, "mb->intra_chroma_pred_mode", mb->intra_chroma_pred_mode); }
         }
     }
     else if( MbPartPredMode( mb->mb_type, 0 ) != Direct )
@@ -1442,8 +1442,8 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
                   mb->mb_field_decoding_flag ) &&
                 MbPartPredMode( mb->mb_type, mbPartIdx ) != Pred_L1 )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->ref_idx_l0[ mbPartIdx ] = bs_read_ae(b); }
-                else { mb->ref_idx_l0[ mbPartIdx ] = bs_read_te(b); } printf("mb->ref_idx_l0[ mbPartIdx ]: %d \n", mb->ref_idx_l0[ mbPartIdx ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->ref_idx_l0[ mbPartIdx ] = bs_read_ae(b); }
+                else { mb->ref_idx_l0[ mbPartIdx ] = bs_read_te(b); } h264_debug_value(_pos, _bits_left, 0x8593F3A2u, "mb->ref_idx_l0[ mbPartIdx ]", mb->ref_idx_l0[ mbPartIdx ]); }
             }
         }
         for( int mbPartIdx = 0; mbPartIdx < NumMbPart( mb->mb_type ); mbPartIdx++)
@@ -1452,8 +1452,8 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
                   mb->mb_field_decoding_flag ) &&
                 MbPartPredMode( mb->mb_type, mbPartIdx ) != Pred_L0 )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->ref_idx_l1[ mbPartIdx ] = bs_read_ae(b); }
-                else { mb->ref_idx_l1[ mbPartIdx ] = bs_read_te(b); } printf("mb->ref_idx_l1[ mbPartIdx ]: %d \n", mb->ref_idx_l1[ mbPartIdx ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->ref_idx_l1[ mbPartIdx ] = bs_read_ae(b); }
+                else { mb->ref_idx_l1[ mbPartIdx ] = bs_read_te(b); } h264_debug_value(_pos, _bits_left, 0x46EBE15Bu, "mb->ref_idx_l1[ mbPartIdx ]", mb->ref_idx_l1[ mbPartIdx ]); }
             }
         }
         for( int mbPartIdx = 0; mbPartIdx < NumMbPart( mb->mb_type ); mbPartIdx++)
@@ -1462,8 +1462,8 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             {
                 for( int compIdx = 0; compIdx < 2; compIdx++ )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_ae(b); }
-                    else { mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_se(b); } printf("mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ]: %d \n", mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_ae(b); }
+                    else { mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_se(b); } h264_debug_value(_pos, _bits_left, 0xCEE47100u, "mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ]", mb->mvd_l0[ mbPartIdx ][ 0 ][ compIdx ]); }
                 }
             }
         }
@@ -1473,8 +1473,8 @@ void read_debug_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             {
                 for( int compIdx = 0; compIdx < 2; compIdx++ )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_ae(b); }
-                    else { mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_se(b); } printf("mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ]: %d \n", mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_ae(b); }
+                    else { mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ] = bs_read_se(b); } h264_debug_value(_pos, _bits_left, 0x93A4959Du, "mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ]", mb->mvd_l1[ mbPartIdx ][ 0 ][ compIdx ]); }
                 }
             }
         }
@@ -1488,8 +1488,8 @@ void read_debug_sub_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
 
     for( int mbPartIdx = 0; mbPartIdx < 4; mbPartIdx++ )
     {
-        printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->sub_mb_type[ mbPartIdx ] = bs_read_ae(b); }
-        else { mb->sub_mb_type[ mbPartIdx ] = bs_read_ue(b); } printf("mb->sub_mb_type[ mbPartIdx ]: %d \n", mb->sub_mb_type[ mbPartIdx ]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->sub_mb_type[ mbPartIdx ] = bs_read_ae(b); }
+        else { mb->sub_mb_type[ mbPartIdx ] = bs_read_ue(b); } h264_debug_value(_pos, _bits_left, 0xFEB18199u, "mb->sub_mb_type[ mbPartIdx ]", mb->sub_mb_type[ mbPartIdx ]); }
     }
     for( int mbPartIdx = 0; mbPartIdx < 4; mbPartIdx++ )
     {
@@ -1498,8 +1498,8 @@ void read_debug_sub_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             mb->sub_mb_type[ mbPartIdx ] != B_Direct_8x8 &&
             SubMbPredMode( mb->sub_mb_type[ mbPartIdx ] ) != Pred_L1 )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->ref_idx_l0[ mbPartIdx ] = bs_read_ae(b); }
-            else { mb->ref_idx_l0[ mbPartIdx ] = bs_read_te(b); } printf("mb->ref_idx_l0[ mbPartIdx ]: %d \n", mb->ref_idx_l0[ mbPartIdx ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->ref_idx_l0[ mbPartIdx ] = bs_read_ae(b); }
+            else { mb->ref_idx_l0[ mbPartIdx ] = bs_read_te(b); } h264_debug_value(_pos, _bits_left, 0x8593F3A2u, "mb->ref_idx_l0[ mbPartIdx ]", mb->ref_idx_l0[ mbPartIdx ]); }
         }
     }
     for( int mbPartIdx = 0; mbPartIdx < 4; mbPartIdx++ )
@@ -1508,8 +1508,8 @@ void read_debug_sub_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             mb->sub_mb_type[ mbPartIdx ] != B_Direct_8x8 &&
             SubMbPredMode( mb->sub_mb_type[ mbPartIdx ] ) != Pred_L0 )
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->ref_idx_l1[ mbPartIdx ] = bs_read_ae(b); }
-            else { mb->ref_idx_l1[ mbPartIdx ] = bs_read_te(b); } printf("mb->ref_idx_l1[ mbPartIdx ]: %d \n", mb->ref_idx_l1[ mbPartIdx ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->ref_idx_l1[ mbPartIdx ] = bs_read_ae(b); }
+            else { mb->ref_idx_l1[ mbPartIdx ] = bs_read_te(b); } h264_debug_value(_pos, _bits_left, 0x46EBE15Bu, "mb->ref_idx_l1[ mbPartIdx ]", mb->ref_idx_l1[ mbPartIdx ]); }
         }
     }
     for( int mbPartIdx = 0; mbPartIdx < 4; mbPartIdx++ )
@@ -1523,8 +1523,8 @@ void read_debug_sub_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             {
                 for( int compIdx = 0; compIdx < 2; compIdx++ )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_ae(b); }
-                    else { mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_se(b); } printf("mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ]: %d \n", mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_ae(b); }
+                    else { mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_se(b); } h264_debug_value(_pos, _bits_left, 0xA087063Fu, "mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ]", mb->mvd_l0[ mbPartIdx ][ subMbPartIdx ][ compIdx ]); }
                 }
             }
         }
@@ -1540,8 +1540,8 @@ void read_debug_sub_mb_pred( h264_stream_t* h, bs_t* b, int mb_type )
             {
                 for( int compIdx = 0; compIdx < 2; compIdx++ )
                 {
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); if (cabac) { mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_ae(b); }
-                    else { mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_se(b); } printf("mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ]: %d \n", mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; if (cabac) { mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_ae(b); }
+                    else { mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ] = bs_read_se(b); } h264_debug_value(_pos, _bits_left, 0xFA1AE6C0u, "mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ]", mb->mvd_l1[ mbPartIdx ][ subMbPartIdx ][ compIdx ]); }
                 }
             }
         }
@@ -1674,7 +1674,7 @@ void read_debug_residual_block_cavlc( bs_t* b, int* coeffLevel, int maxNumCoeff
         coeffLevel[ i ] = 0;
     }
     int coeff_token;
-    printf("%d.%d: ", b->p - b->start, b->bits_left); coeff_token = bs_read_ce(b); printf("coeff_token: %d \n", coeff_token); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coeff_token = bs_read_ce(b); h264_debug_value(_pos, _bits_left, 0x6F44368Cu, "coeff_token", coeff_token); }
     int suffixLength;
     if( TotalCoeff( coeff_token ) > 0 )
     {
@@ -1691,19 +1691,19 @@ void read_debug_residual_block_cavlc( bs_t* b, int* coeffLevel, int maxNumCoeff
             if( i < TrailingOnes( coeff_token ) )
             {
                 int trailing_ones_sign_flag;
-                printf("%d.%d: ", b->p - b->start, b->bits_left); trailing_ones_sign_flag = bs_read_u(b, 1); printf("trailing_ones_sign_flag: %d \n", trailing_ones_sign_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; trailing_ones_sign_flag = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0xF81A1914u, "trailing_ones_sign_flag", trailing_ones_sign_flag); }
                 level[ i ] = 1 - 2 * trailing_ones_sign_flag;
             }
             else
             {
                 int level_prefix;
-                printf("%d.%d: ", b->p - b->start, b->bits_left); level_prefix = bs_read_ce(b); printf("level_prefix: %d \n", level_prefix); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; level_prefix = bs_read_ce(b); h264_debug_value(_pos, _bits_left, 0xF6CA441Au, "level_prefix", level_prefix); }
                 int levelCode;
                 levelCode = ( Min( 15, level_prefix ) << suffixLength );
                 if( suffixLength > 0 || level_prefix >= 14 )
                 {
                     int level_suffix;
-                    printf("%d.%d: ", b->p - b->start, b->bits_left); // ERROR: value( level_suffix, u ); printf("level_suffix: %d \n", level_suffix);  // FIXME
+                    // ERROR: value( level_suffix, u ); // FIXME
                     levelCode += level_suffix;
                 }
                 if( level_prefix >= 15 && suffixLength == 0 )
@@ -1742,7 +1742,7 @@ void read_debug_residual_block_cavlc( bs_t* b, int* coeffLevel, int maxNumCoeff
         if( TotalCoeff( coeff_token ) < maxNumCoeff )
         {
             int total_zeros;
-            printf("%d.%d: ", b->p - b->start, b->bits_left); total_zeros = bs_read_ce(b); printf("total_zeros: %d \n", total_zeros); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; total_zeros = bs_read_ce(b); h264_debug_value(_pos, _bits_left, 0x898A1DB5u, "total_zeros", total_zeros); }
             zerosLeft = total_zeros;
         } else
         {
@@ -1753,7 +1753,7 @@ void read_debug_residual_block_cavlc( bs_t* b, int* coeffLevel, int maxNumCoeff
             if( zerosLeft > 0 )
             {
                 int run_before;
-                printf("%d.%d: ", b->p - b->start, b->bits_left); run_before = bs_read_ce(b); printf("run_before: %d \n", run_before); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; run_before = bs_read_ce(b); h264_debug_value(_pos, _bits_left, 0x02DDD598u, "run_before", run_before); }
                 run[ i ] = run_before;
             } else
             {
@@ -1783,7 +1783,7 @@ void read_debug_residual_block_cabac( bs_t* b, int* coeffLevel, int maxNumCoeff
     }
     else
     {
-        printf("%d.%d: ", b->p - b->start, b->bits_left); coded_block_flag = bs_read_ae(b); printf("coded_block_flag: %d \n", coded_block_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coded_block_flag = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0x1784B901u, "coded_block_flag", coded_block_flag); }
     }
     if( coded_block_flag )
     {
@@ -1791,10 +1791,10 @@ void read_debug_residual_block_cabac( bs_t* b, int* coeffLevel, int maxNumCoeff
         int i=0;
         do
         {
-            printf("%d.%d: ", b->p - b->start, b->bits_left); significant_coeff_flag[ i ] = bs_read_ae(b); printf("significant_coeff_flag[ i ]: %d \n", significant_coeff_flag[ i ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; significant_coeff_flag[ i ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0x0B9103F2u, "significant_coeff_flag[ i ]", significant_coeff_flag[ i ]); }
             if( significant_coeff_flag[ i ] )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); last_significant_coeff_flag[ i ] = bs_read_ae(b); printf("last_significant_coeff_flag[ i ]: %d \n", last_significant_coeff_flag[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; last_significant_coeff_flag[ i ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0x59A6E41Fu, "last_significant_coeff_flag[ i ]", last_significant_coeff_flag[ i ]); }
                 if( last_significant_coeff_flag[ i ] )
                 {
                     numCoeff = i + 1;
@@ -1807,8 +1807,8 @@ void read_debug_residual_block_cabac( bs_t* b, int* coeffLevel, int maxNumCoeff
             i++;
         } while( i < numCoeff - 1 );
 
-        printf("%d.%d: ", b->p - b->start, b->bits_left); coeff_abs_level_minus1[ numCoeff - 1 ] = bs_read_ae(b); printf("coeff_abs_level_minus1[ numCoeff - 1 ]: %d \n", coeff_abs_level_minus1[ numCoeff - 1 ]); 
-        printf("%d.%d: ", b->p - b->start, b->bits_left); coeff_sign_flag[ numCoeff - 1 ] = bs_read_ae(b); printf("coeff_sign_flag[ numCoeff - 1 ]: %d \n", coeff_sign_flag[ numCoeff - 1 ]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coeff_abs_level_minus1[ numCoeff - 1 ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0x600A9DD3u, "coeff_abs_level_minus1[ numCoeff - 1 ]", coeff_abs_level_minus1[ numCoeff - 1 ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coeff_sign_flag[ numCoeff - 1 ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0xFF012250u, "coeff_sign_flag[ numCoeff - 1 ]", coeff_sign_flag[ numCoeff - 1 ]); }
         coeffLevel[ numCoeff - 1 ] =
             ( coeff_abs_level_minus1[ numCoeff - 1 ] + 1 ) *
             ( 1 - 2 * coeff_sign_flag[ numCoeff - 1 ] );
@@ -1816,8 +1816,8 @@ void read_debug_residual_block_cabac( bs_t* b, int* coeffLevel, int maxNumCoeff
         {
             if( significant_coeff_flag[ i ] )
             {
-                printf("%d.%d: ", b->p - b->start, b->bits_left); coeff_abs_level_minus1[ i ] = bs_read_ae(b); printf("coeff_abs_level_minus1[ i ]: %d \n", coeff_abs_level_minus1[ i ]); 
-                printf("%d.%d: ", b->p - b->start, b->bits_left); coeff_sign_flag[ i ] = bs_read_ae(b); printf("coeff_sign_flag[ i ]: %d \n", coeff_sign_flag[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coeff_abs_level_minus1[ i ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0xF3ECC04Fu, "coeff_abs_level_minus1[ i ]", coeff_abs_level_minus1[ i ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; coeff_sign_flag[ i ] = bs_read_ae(b); h264_debug_value(_pos, _bits_left, 0xF028BA5Au, "coeff_sign_flag[ i ]", coeff_sign_flag[ i ]); }
                 coeffLevel[ i ] = ( coeff_abs_level_minus1[ i ] + 1 ) *
                     ( 1 - 2 * coeff_sign_flag[ i ] );
             }
@@ -31,8 +31,9 @@
 #include "h264_sei.h"
 
 FILE* h264_dbgfile = NULL;
+H264_THREAD_LOCAL FILE* h264_dbgfile_thread = NULL;
 
-#define printf(...) fprintf((h264_dbgfile == NULL ? stdout : h264_dbgfile), __VA_ARGS__)
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
 
 /** 
  Calculate the log base 2 of the argument, rounded up. 
@@ -73,10 +74,12 @@ int more_rbsp_data(bs_t* bs)
     bs_t bs_tmp;
     bs_clone(&bs_tmp, bs);
     bs_skip_u1(&bs_tmp);
+
+    // A later bit was 1, it wasn't the rsbp_stop_bit; check the rest of this byte, then whole bytes
+    if (!bs_byte_aligned(&bs_tmp) && bs_read_u(&bs_tmp, bs_tmp.bits_left) != 0) { return 1; }
     while(!bs_eof(&bs_tmp))
     {
-        // A later bit was 1, it wasn't the rsbp_stop_bit
-        if (bs_read_u1(&bs_tmp) == 1) { return 1; }
+        if (bs_read_u8(&bs_tmp) != 0) { return 1; }
     }
 
     // All following bits were 0, it was the rsbp_stop_bit
@@ -156,6 +159,7 @@ void read_dec_ref_base_pic_marking(nal_t* nal, bs_t* b);
 
 
 
+
 //7.3.1 NAL unit syntax
 int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 {
@@ -163,21 +167,23 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 
     int nal_size = size;
     int rbsp_size = size;
-    uint8_t* rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
 
     if( 1 )
     {
-        int rc = nal_to_rbsp(buf, &nal_size, rbsp_buf, &rbsp_size);
-
-        if (rc < 0) { free(rbsp_buf); return -1; } // handle conversion error
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
     }
 
     if( 0 )
     {
         rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
     }
 
-    bs_t* b = bs_new(rbsp_buf, rbsp_size);
     /* forbidden_zero_bit */ bs_skip_u(b, 1);
     nal->nal_ref_idc = bs_read_u(b, 2);
     nal->nal_unit_type = bs_read_u(b, 5);
@@ -199,6 +205,11 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         }
     }
 
+    if( 1 && h->parse_depth < H264_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
     switch ( nal->nal_unit_type )
     {
         case NAL_UNIT_TYPE_CODED_SLICE_IDR:
@@ -215,19 +226,37 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 #endif
 
         case NAL_UNIT_TYPE_SPS: 
+            if( 1 && !0 && h264_sps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             read_seq_parameter_set_rbsp(h->sps, b);
             read_rbsp_trailing_bits(b);
             
             if( 1 )
             {
-                memcpy(h->sps_table[h->sps->seq_parameter_set_id], h->sps, sizeof(sps_t));
+                int id = h->sps->seq_parameter_set_id;
+                sps_t* slot = h264_sps_slot(h, id);
+                if( slot == NULL ) { h->sps_hash = 0; return -1; }
+                memcpy(slot, h->sps, sizeof(sps_t));
+                h->sps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->sps_table_hash[id] = h->sps_hash;
             }
 
             break;
 
         case NAL_UNIT_TYPE_PPS:   
+            if( 1 && !0 && h264_pps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             read_pic_parameter_set_rbsp(h, b);
             read_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                // pic_parameter_set_rbsp has stored it, unless the id is out of range
+                int id = h->pps->pic_parameter_set_id;
+                if( h264_pps_slot(h, id) == NULL ) { h->pps_hash = 0; return -1; }
+                h->pps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
             break;
 
         case NAL_UNIT_TYPE_AUD:     
@@ -252,10 +281,12 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
             
             if( 1 )
             {
-                memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps, h->sps_subset->sps, sizeof(sps_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
-                //h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
+                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
+                sps_subset_t* sps_subset = h264_sps_subset_slot(h, h->sps_subset->sps->seq_parameter_set_id);
+                if( sps_subset == NULL ) { return -1; }
+                memcpy(sps_subset->sps, h->sps_subset->sps, sizeof(sps_t));
+                memcpy(sps_subset->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+                sps_subset->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
             }
 
             break;
@@ -279,12 +310,11 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_B: 
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_C:
         default:
-            bs_free(b);
             free(rbsp_buf);
             return -1;
     }
 
-    if (bs_overrun(b)) { bs_free(b); free(rbsp_buf); return -1; }
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
 
     if( 0 )
     {
@@ -292,10 +322,9 @@ int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         rbsp_size = bs_pos(b);
 
         int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
-        if (rc < 0) { bs_free(b); free(rbsp_buf); return -1; }
+        if (rc < 0) { free(rbsp_buf); return -1; }
     }
 
-    bs_free(b);
     free(rbsp_buf);
 
     return nal_size;
@@ -768,7 +797,7 @@ void read_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
     if( 1 ) { have_more_data = more_rbsp_data(b); }
     if( 0 )
     {
-        have_more_data = pps->transform_8x8_mode_flag | pps->pic_scaling_matrix_present_flag | pps->second_chroma_qp_index_offset != 0;
+        have_more_data = pps->transform_8x8_mode_flag || pps->pic_scaling_matrix_present_flag || pps->second_chroma_qp_index_offset != 0;
     }
 
     if( have_more_data )
@@ -800,7 +829,8 @@ void read_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
 
     if( 1 )
     {
-        memcpy(h->pps_table[pps->pic_parameter_set_id], h->pps, sizeof(pps_t));
+        pps_t* slot = h264_pps_slot(h, pps->pic_parameter_set_id);
+        if( slot != NULL ) { memcpy(slot, h->pps, sizeof(pps_t)); }
     }
 }
 
@@ -810,16 +840,11 @@ void read_sei_rbsp(h264_stream_t* h, bs_t* b)
 {
     if( 1 )
     {
-        for( int i = 0; i < h->num_seis; i++ )
-        {
-            sei_free(h->seis[i]);
-        }
-    
+        // the messages of the previous SEI are reused, with their payload storage
         h->num_seis = 0;
         do {
             h->num_seis++;
-            h->seis = (sei_t**)realloc(h->seis, h->num_seis * sizeof(sei_t*));
-            h->seis[h->num_seis - 1] = sei_new();
+            sei_pool_reserve(h, h->num_seis);
             h->sei = h->seis[h->num_seis - 1];
             read_sei_message(h, b);
         } while( more_rbsp_data(b) );
@@ -891,13 +916,31 @@ void read_slice_layer_rbsp(h264_stream_t* h,  bs_t* b)
     if ( slice_data != NULL )
     {
         if ( slice_data->rbsp_buf != NULL ) free( slice_data->rbsp_buf ); 
-        uint8_t *sptr = b->p + (!!b->bits_left); // CABAC-specific: skip alignment bits, if there are any
-        slice_data->rbsp_size = b->end - sptr;
-        
-        slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
-        memcpy( slice_data->rbsp_buf, sptr, slice_data->rbsp_size );
-        // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
-        return;
+        bs_t bs_tmp;
+        bs_clone(&bs_tmp, b);
+        bs_skip_u(&bs_tmp, bs_tmp.bits_left); // CABAC-specific: skip alignment bits, if there are any
+        slice_data->rbsp_size = bs_tmp.end - bs_tmp.p;
+
+        if ( slice_data->rbsp_size > 0 && 1 && ( 0 || h->parse_depth < H264_PARSE_SLICE_DATA ) )
+        {
+            // only the headers were asked for, leave the payload unread
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+            return;
+        }
+        else if ( slice_data->rbsp_size > 0 )
+        {
+            slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, slice_data->rbsp_size );
+            // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
+            return;
+        }
+        else
+        {
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+        }
     }
 
     // FIXME should read or skip data
@@ -976,8 +1019,28 @@ void read_slice_header(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_t* sps = h->sps;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(h->sps, h->sps_table[pps->seq_parameter_set_id], sizeof(sps_t));
+    if( 1 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h264_activate_pps(h, sh->pic_parameter_set_id);
+        h264_activate_sps(h, pps->seq_parameter_set_id);
+    }
+    else
+    {
+        // always copies, h->pps and h->sps may have been changed by hand; the hashes follow, for the next read
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+        sps_t* sps_slot = h264_sps_slot(h, pps->seq_parameter_set_id);
+        if( sps_slot != NULL )
+        {
+            memcpy(h->sps, sps_slot, sizeof(sps_t));
+            h->sps_hash = h->sps_table_hash[pps->seq_parameter_set_id];
+        }
+    }
 
     if (sps->residual_colour_transform_flag)
     {
@@ -1135,7 +1198,7 @@ void read_pred_weight_table(h264_stream_t* h, bs_t* b)
     int i, j;
 
     sh->pwt.luma_log2_weight_denom = bs_read_ue(b);
-    if( sps->chroma_format_idc != 0 )
+    if( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
     {
         sh->pwt.chroma_log2_weight_denom = bs_read_ue(b);
     }
@@ -1147,7 +1210,7 @@ void read_pred_weight_table(h264_stream_t* h, bs_t* b)
             sh->pwt.luma_weight_l0[ i ] = bs_read_se(b);
             sh->pwt.luma_offset_l0[ i ] = bs_read_se(b);
         }
-        if ( sps->chroma_format_idc != 0 )
+        if ( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
         {
             sh->pwt.chroma_weight_l0_flag[i] = bs_read_u1(b);
             if( sh->pwt.chroma_weight_l0_flag[i] )
@@ -1250,10 +1313,23 @@ void read_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_subset_t* sps_subset = h->sps_subset;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
-    //memcpy(h->sps_subset->sps, h->sps_subset_table[pps->seq_parameter_set_id]->sps, sizeof(sps_t));
-    //memcpy(h->sps_subset->sps_svc_ext, h->sps_subset_table[pps->seq_parameter_set_id]->sps_svc_ext, sizeof(sps_svc_ext_t));
+    if( 1 ) { h264_activate_pps(h, sh->pic_parameter_set_id); }
+    else
+    {
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+    }
+    //memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
+    sps_subset_t* sps_subset_slot = h264_sps_subset_slot(h, pps->seq_parameter_set_id);
+    if( sps_subset_slot != NULL )
+    {
+        memcpy(sps_subset->sps, sps_subset_slot->sps, sizeof(sps_t));
+        memcpy(sps_subset->sps_svc_ext, sps_subset_slot->sps_svc_ext, sizeof(sps_svc_ext_t));
+    }
     
     if (sps_subset->sps->residual_colour_transform_flag)
     {
@@ -1487,6 +1563,7 @@ void write_dec_ref_base_pic_marking(nal_t* nal, bs_t* b);
 
 
 
+
 //7.3.1 NAL unit syntax
 int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 {
@@ -1494,21 +1571,23 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 
     int nal_size = size;
     int rbsp_size = size;
-    uint8_t* rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
 
     if( 0 )
     {
-        int rc = nal_to_rbsp(buf, &nal_size, rbsp_buf, &rbsp_size);
-
-        if (rc < 0) { free(rbsp_buf); return -1; } // handle conversion error
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
     }
 
     if( 1 )
     {
         rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
     }
 
-    bs_t* b = bs_new(rbsp_buf, rbsp_size);
     /* forbidden_zero_bit */ bs_write_u(b, 1, 0);
     bs_write_u(b, 2, nal->nal_ref_idc);
     bs_write_u(b, 5, nal->nal_unit_type);
@@ -1530,6 +1609,11 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         }
     }
 
+    if( 0 && h->parse_depth < H264_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
     switch ( nal->nal_unit_type )
     {
         case NAL_UNIT_TYPE_CODED_SLICE_IDR:
@@ -1546,19 +1630,37 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 #endif
 
         case NAL_UNIT_TYPE_SPS: 
+            if( 0 && !0 && h264_sps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             write_seq_parameter_set_rbsp(h->sps, b);
             write_rbsp_trailing_bits(b);
             
             if( 0 )
             {
-                memcpy(h->sps_table[h->sps->seq_parameter_set_id], h->sps, sizeof(sps_t));
+                int id = h->sps->seq_parameter_set_id;
+                sps_t* slot = h264_sps_slot(h, id);
+                if( slot == NULL ) { h->sps_hash = 0; return -1; }
+                memcpy(slot, h->sps, sizeof(sps_t));
+                h->sps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->sps_table_hash[id] = h->sps_hash;
             }
 
             break;
 
         case NAL_UNIT_TYPE_PPS:   
+            if( 0 && !0 && h264_pps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             write_pic_parameter_set_rbsp(h, b);
             write_rbsp_trailing_bits(b);
+
+            if( 0 )
+            {
+                // pic_parameter_set_rbsp has stored it, unless the id is out of range
+                int id = h->pps->pic_parameter_set_id;
+                if( h264_pps_slot(h, id) == NULL ) { h->pps_hash = 0; return -1; }
+                h->pps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
             break;
 
         case NAL_UNIT_TYPE_AUD:     
@@ -1583,10 +1685,12 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
             
             if( 0 )
             {
-                memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps, h->sps_subset->sps, sizeof(sps_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
-                //h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
+                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
+                sps_subset_t* sps_subset = h264_sps_subset_slot(h, h->sps_subset->sps->seq_parameter_set_id);
+                if( sps_subset == NULL ) { return -1; }
+                memcpy(sps_subset->sps, h->sps_subset->sps, sizeof(sps_t));
+                memcpy(sps_subset->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+                sps_subset->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
             }
 
             break;
@@ -1610,10 +1714,11 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_B: 
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_C:
         default:
+            free(rbsp_buf);
             return -1;
     }
 
-    if (bs_overrun(b)) { bs_free(b); free(rbsp_buf); return -1; }
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
 
     if( 1 )
     {
@@ -1621,10 +1726,9 @@ int write_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         rbsp_size = bs_pos(b);
 
         int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
-        if (rc < 0) { bs_free(b); free(rbsp_buf); return -1; }
+        if (rc < 0) { free(rbsp_buf); return -1; }
     }
 
-    bs_free(b);
     free(rbsp_buf);
 
     return nal_size;
@@ -1724,7 +1828,7 @@ void write_seq_parameter_set_rbsp(sps_t* sps, bs_t* b)
         bs_write_u1(b, sps->seq_scaling_matrix_present_flag);
         if( sps->seq_scaling_matrix_present_flag )
         {
-            for( i = 0; i < 8; i++ )
+            for( i = 0; i < ((sps->chroma_format_idc != 3) ? 8 : 12); i++ )
             {
                 bs_write_u1(b, sps->seq_scaling_list_present_flag[ i ]);
                 if( sps->seq_scaling_list_present_flag[ i ] )
@@ -2097,7 +2201,7 @@ void write_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
     if( 0 ) { have_more_data = more_rbsp_data(b); }
     if( 1 )
     {
-        have_more_data = pps->transform_8x8_mode_flag | pps->pic_scaling_matrix_present_flag | pps->second_chroma_qp_index_offset != 0;
+        have_more_data = pps->transform_8x8_mode_flag || pps->pic_scaling_matrix_present_flag || pps->second_chroma_qp_index_offset != 0;
     }
 
     if( have_more_data )
@@ -2129,7 +2233,8 @@ void write_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
 
     if( 0 )
     {
-        memcpy(h->pps_table[pps->pic_parameter_set_id], h->pps, sizeof(pps_t));
+        pps_t* slot = h264_pps_slot(h, pps->pic_parameter_set_id);
+        if( slot != NULL ) { memcpy(slot, h->pps, sizeof(pps_t)); }
     }
 }
 
@@ -2139,16 +2244,11 @@ void write_sei_rbsp(h264_stream_t* h, bs_t* b)
 {
     if( 0 )
     {
-        for( int i = 0; i < h->num_seis; i++ )
-        {
-            sei_free(h->seis[i]);
-        }
-    
+        // the messages of the previous SEI are reused, with their payload storage
         h->num_seis = 0;
         do {
             h->num_seis++;
-            h->seis = (sei_t**)realloc(h->seis, h->num_seis * sizeof(sei_t*));
-            h->seis[h->num_seis - 1] = sei_new();
+            sei_pool_reserve(h, h->num_seis);
             h->sei = h->seis[h->num_seis - 1];
             write_sei_message(h, b);
         } while( more_rbsp_data(b) );
@@ -2220,13 +2320,31 @@ void write_slice_layer_rbsp(h264_stream_t* h,  bs_t* b)
     if ( slice_data != NULL )
     {
         if ( slice_data->rbsp_buf != NULL ) free( slice_data->rbsp_buf ); 
-        uint8_t *sptr = b->p + (!!b->bits_left); // CABAC-specific: skip alignment bits, if there are any
-        slice_data->rbsp_size = b->end - sptr;
-        
-        slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
-        memcpy( slice_data->rbsp_buf, sptr, slice_data->rbsp_size );
-        // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
-        return;
+        bs_t bs_tmp;
+        bs_clone(&bs_tmp, b);
+        bs_skip_u(&bs_tmp, bs_tmp.bits_left); // CABAC-specific: skip alignment bits, if there are any
+        slice_data->rbsp_size = bs_tmp.end - bs_tmp.p;
+
+        if ( slice_data->rbsp_size > 0 && 0 && ( 0 || h->parse_depth < H264_PARSE_SLICE_DATA ) )
+        {
+            // only the headers were asked for, leave the payload unread
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+            return;
+        }
+        else if ( slice_data->rbsp_size > 0 )
+        {
+            slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, slice_data->rbsp_size );
+            // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
+            return;
+        }
+        else
+        {
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+        }
     }
 
     // FIXME should read or skip data
@@ -2305,8 +2423,28 @@ void write_slice_header(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_t* sps = h->sps;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(h->sps, h->sps_table[pps->seq_parameter_set_id], sizeof(sps_t));
+    if( 0 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h264_activate_pps(h, sh->pic_parameter_set_id);
+        h264_activate_sps(h, pps->seq_parameter_set_id);
+    }
+    else
+    {
+        // always copies, h->pps and h->sps may have been changed by hand; the hashes follow, for the next read
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+        sps_t* sps_slot = h264_sps_slot(h, pps->seq_parameter_set_id);
+        if( sps_slot != NULL )
+        {
+            memcpy(h->sps, sps_slot, sizeof(sps_t));
+            h->sps_hash = h->sps_table_hash[pps->seq_parameter_set_id];
+        }
+    }
 
     if (sps->residual_colour_transform_flag)
     {
@@ -2464,7 +2602,7 @@ void write_pred_weight_table(h264_stream_t* h, bs_t* b)
     int i, j;
 
     bs_write_ue(b, sh->pwt.luma_log2_weight_denom);
-    if( sps->chroma_format_idc != 0 )
+    if( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
     {
         bs_write_ue(b, sh->pwt.chroma_log2_weight_denom);
     }
@@ -2476,7 +2614,7 @@ void write_pred_weight_table(h264_stream_t* h, bs_t* b)
             bs_write_se(b, sh->pwt.luma_weight_l0[ i ]);
             bs_write_se(b, sh->pwt.luma_offset_l0[ i ]);
         }
-        if ( sps->chroma_format_idc != 0 )
+        if ( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
         {
             bs_write_u1(b, sh->pwt.chroma_weight_l0_flag[i]);
             if( sh->pwt.chroma_weight_l0_flag[i] )
@@ -2579,10 +2717,23 @@ void write_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_subset_t* sps_subset = h->sps_subset;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
-    //memcpy(h->sps_subset->sps, h->sps_subset_table[pps->seq_parameter_set_id]->sps, sizeof(sps_t));
-    //memcpy(h->sps_subset->sps_svc_ext, h->sps_subset_table[pps->seq_parameter_set_id]->sps_svc_ext, sizeof(sps_svc_ext_t));
+    if( 0 ) { h264_activate_pps(h, sh->pic_parameter_set_id); }
+    else
+    {
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+    }
+    //memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
+    sps_subset_t* sps_subset_slot = h264_sps_subset_slot(h, pps->seq_parameter_set_id);
+    if( sps_subset_slot != NULL )
+    {
+        memcpy(sps_subset->sps, sps_subset_slot->sps, sizeof(sps_t));
+        memcpy(sps_subset->sps_svc_ext, sps_subset_slot->sps_svc_ext, sizeof(sps_svc_ext_t));
+    }
     
     if (sps_subset->sps->residual_colour_transform_flag)
     {
@@ -2816,6 +2967,7 @@ void read_debug_dec_ref_base_pic_marking(nal_t* nal, bs_t* b);
 
 
 
+
 //7.3.1 NAL unit syntax
 int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 {
@@ -2823,34 +2975,36 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 
     int nal_size = size;
     int rbsp_size = size;
-    uint8_t* rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
 
     if( 1 )
     {
-        int rc = nal_to_rbsp(buf, &nal_size, rbsp_buf, &rbsp_size);
-
-        if (rc < 0) { free(rbsp_buf); return -1; } // handle conversion error
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
     }
 
     if( 0 )
     {
         rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
     }
 
-    bs_t* b = bs_new(rbsp_buf, rbsp_size);
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int forbidden_zero_bit = bs_read_u(b, 1); printf("forbidden_zero_bit: %d \n", forbidden_zero_bit); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->nal_ref_idc = bs_read_u(b, 2); printf("nal->nal_ref_idc: %d \n", nal->nal_ref_idc); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->nal_unit_type = bs_read_u(b, 5); printf("nal->nal_unit_type: %d \n", nal->nal_unit_type); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int forbidden_zero_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x3A3AE9DDu, "forbidden_zero_bit", forbidden_zero_bit); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->nal_ref_idc = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x18BAEDFDu, "nal->nal_ref_idc", nal->nal_ref_idc); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->nal_unit_type = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x8FC50732u, "nal->nal_unit_type", nal->nal_unit_type); }
     
     if( nal->nal_unit_type == 14 || nal->nal_unit_type == 21 || nal->nal_unit_type == 20 )
     {
         if( nal->nal_unit_type != 21 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->svc_extension_flag = bs_read_u1(b); printf("nal->svc_extension_flag: %d \n", nal->svc_extension_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->svc_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x43DAA5C8u, "nal->svc_extension_flag", nal->svc_extension_flag); }
         }
         else
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->avc_3d_extension_flag = bs_read_u1(b); printf("nal->avc_3d_extension_flag: %d \n", nal->avc_3d_extension_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->avc_3d_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6291D4AEu, "nal->avc_3d_extension_flag", nal->avc_3d_extension_flag); }
         }
         
         if( nal->svc_extension_flag )
@@ -2859,6 +3013,11 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         }
     }
 
+    if( 1 && h->parse_depth < H264_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
     switch ( nal->nal_unit_type )
     {
         case NAL_UNIT_TYPE_CODED_SLICE_IDR:
@@ -2875,19 +3034,37 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 #endif
 
         case NAL_UNIT_TYPE_SPS: 
+            if( 1 && !1 && h264_sps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             read_debug_seq_parameter_set_rbsp(h->sps, b);
             read_debug_rbsp_trailing_bits(b);
             
             if( 1 )
             {
-                memcpy(h->sps_table[h->sps->seq_parameter_set_id], h->sps, sizeof(sps_t));
+                int id = h->sps->seq_parameter_set_id;
+                sps_t* slot = h264_sps_slot(h, id);
+                if( slot == NULL ) { h->sps_hash = 0; return -1; }
+                memcpy(slot, h->sps, sizeof(sps_t));
+                h->sps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->sps_table_hash[id] = h->sps_hash;
             }
 
             break;
 
         case NAL_UNIT_TYPE_PPS:   
+            if( 1 && !1 && h264_pps_resent(h, b, buf, nal_size, H264_EXTRACT_ALL) ) { break; }
+
             read_debug_pic_parameter_set_rbsp(h, b);
             read_debug_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                // pic_parameter_set_rbsp has stored it, unless the id is out of range
+                int id = h->pps->pic_parameter_set_id;
+                if( h264_pps_slot(h, id) == NULL ) { h->pps_hash = 0; return -1; }
+                h->pps_hash = h264_ps_hash(buf, nal_size, H264_EXTRACT_ALL);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
             break;
 
         case NAL_UNIT_TYPE_AUD:     
@@ -2913,9 +3090,11 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
             if( 1 )
             {
                 //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
-                memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps, h->sps_subset->sps, sizeof(sps_t));
-                memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
-                h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
+                sps_subset_t* sps_subset = h264_sps_subset_slot(h, h->sps_subset->sps->seq_parameter_set_id);
+                if( sps_subset == NULL ) { return -1; }
+                memcpy(sps_subset->sps, h->sps_subset->sps, sizeof(sps_t));
+                memcpy(sps_subset->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+                sps_subset->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
             }
 
             break;
@@ -2939,10 +3118,11 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_B: 
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_C:
         default:
+            free(rbsp_buf);
             return -1;
     }
 
-    if (bs_overrun(b)) { bs_free(b); free(rbsp_buf); return -1; }
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
 
     if( 0 )
     {
@@ -2950,10 +3130,9 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
         rbsp_size = bs_pos(b);
 
         int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
-        if (rc < 0) { bs_free(b); free(rbsp_buf); return -1; }
+        if (rc < 0) { free(rbsp_buf); return -1; }
     }
 
-    bs_free(b);
     free(rbsp_buf);
 
     return nal_size;
@@ -2962,16 +3141,16 @@ int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size)
 //G.7.3.1.1 NAL unit header SVC extension syntax
 void read_debug_nal_unit_header_svc_extension(nal_svc_ext_t* nal_svc_ext, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->idr_flag = bs_read_u1(b); printf("nal_svc_ext->idr_flag: %d \n", nal_svc_ext->idr_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->priority_id = bs_read_u(b, 6); printf("nal_svc_ext->priority_id: %d \n", nal_svc_ext->priority_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->no_inter_layer_pred_flag = bs_read_u1(b); printf("nal_svc_ext->no_inter_layer_pred_flag: %d \n", nal_svc_ext->no_inter_layer_pred_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->dependency_id = bs_read_u(b, 3); printf("nal_svc_ext->dependency_id: %d \n", nal_svc_ext->dependency_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->quality_id = bs_read_u(b, 4); printf("nal_svc_ext->quality_id: %d \n", nal_svc_ext->quality_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->temporal_id = bs_read_u(b, 3); printf("nal_svc_ext->temporal_id: %d \n", nal_svc_ext->temporal_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->use_ref_base_pic_flag = bs_read_u1(b); printf("nal_svc_ext->use_ref_base_pic_flag: %d \n", nal_svc_ext->use_ref_base_pic_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->discardable_flag = bs_read_u1(b); printf("nal_svc_ext->discardable_flag: %d \n", nal_svc_ext->discardable_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->output_flag = bs_read_u1(b); printf("nal_svc_ext->output_flag: %d \n", nal_svc_ext->output_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal_svc_ext->reserved_three_2bits = bs_read_u(b, 2); printf("nal_svc_ext->reserved_three_2bits: %d \n", nal_svc_ext->reserved_three_2bits); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->idr_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC2877CD6u, "nal_svc_ext->idr_flag", nal_svc_ext->idr_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->priority_id = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0x0C3164D2u, "nal_svc_ext->priority_id", nal_svc_ext->priority_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->no_inter_layer_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF7D290CBu, "nal_svc_ext->no_inter_layer_pred_flag", nal_svc_ext->no_inter_layer_pred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->dependency_id = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xA4D85F59u, "nal_svc_ext->dependency_id", nal_svc_ext->dependency_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->quality_id = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x45517E89u, "nal_svc_ext->quality_id", nal_svc_ext->quality_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->temporal_id = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xBB115B4Cu, "nal_svc_ext->temporal_id", nal_svc_ext->temporal_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->use_ref_base_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1C2F0C29u, "nal_svc_ext->use_ref_base_pic_flag", nal_svc_ext->use_ref_base_pic_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->discardable_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x89616617u, "nal_svc_ext->discardable_flag", nal_svc_ext->discardable_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->output_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x78554172u, "nal_svc_ext->output_flag", nal_svc_ext->output_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal_svc_ext->reserved_three_2bits = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x9E0F942Cu, "nal_svc_ext->reserved_three_2bits", nal_svc_ext->reserved_three_2bits); }
 }
 
 //G.7.3.2.12.1 Prefix NAL unit SVC syntax
@@ -2979,18 +3158,18 @@ void read_debug_prefix_nal_unit_svc(nal_t* nal, bs_t* b)
 {
     if( nal->nal_ref_idc != 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->store_ref_base_pic_flag = bs_read_u1(b); printf("nal->prefix_nal_svc->store_ref_base_pic_flag: %d \n", nal->prefix_nal_svc->store_ref_base_pic_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->store_ref_base_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7AA492CAu, "nal->prefix_nal_svc->store_ref_base_pic_flag", nal->prefix_nal_svc->store_ref_base_pic_flag); }
         if( ( nal->nal_svc_ext->use_ref_base_pic_flag || nal->prefix_nal_svc->store_ref_base_pic_flag ) &&
              !nal->nal_svc_ext->idr_flag )
         {
             read_debug_dec_ref_base_pic_marking( nal, b );
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag = bs_read_u1(b); printf("nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag: %d \n", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE4F0AC41u, "nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag); }
         if( nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag )
         {
             while( more_rbsp_data( b ) )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b); printf("nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag: %d \n", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA4D9334Au, "nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag); }
             }
         }
     }
@@ -2998,7 +3177,7 @@ void read_debug_prefix_nal_unit_svc(nal_t* nal, bs_t* b)
     {
         while( more_rbsp_data( b ) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b); printf("nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag: %d \n", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA4D9334Au, "nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag", nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag); }
         }
     }
 }
@@ -3023,16 +3202,16 @@ void read_debug_seq_parameter_set_rbsp(sps_t* sps, bs_t* b)
         sps->chroma_format_idc = 1; 
     }
  
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->profile_idc = bs_read_u8(b); printf("sps->profile_idc: %d \n", sps->profile_idc); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set0_flag = bs_read_u1(b); printf("sps->constraint_set0_flag: %d \n", sps->constraint_set0_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set1_flag = bs_read_u1(b); printf("sps->constraint_set1_flag: %d \n", sps->constraint_set1_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set2_flag = bs_read_u1(b); printf("sps->constraint_set2_flag: %d \n", sps->constraint_set2_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set3_flag = bs_read_u1(b); printf("sps->constraint_set3_flag: %d \n", sps->constraint_set3_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set4_flag = bs_read_u1(b); printf("sps->constraint_set4_flag: %d \n", sps->constraint_set4_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->constraint_set5_flag = bs_read_u1(b); printf("sps->constraint_set5_flag: %d \n", sps->constraint_set5_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int reserved_zero_2bits = bs_read_u(b, 2); printf("reserved_zero_2bits: %d \n", reserved_zero_2bits); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->level_idc = bs_read_u8(b); printf("sps->level_idc: %d \n", sps->level_idc); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->seq_parameter_set_id = bs_read_ue(b); printf("sps->seq_parameter_set_id: %d \n", sps->seq_parameter_set_id); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->profile_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xF79F9368u, "sps->profile_idc", sps->profile_idc); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set0_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x53BA02DFu, "sps->constraint_set0_flag", sps->constraint_set0_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set1_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7061DBEEu, "sps->constraint_set1_flag", sps->constraint_set1_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set2_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x43B73565u, "sps->constraint_set2_flag", sps->constraint_set2_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set3_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x0282B21Cu, "sps->constraint_set3_flag", sps->constraint_set3_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set4_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF0AF37A3u, "sps->constraint_set4_flag", sps->constraint_set4_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->constraint_set5_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x554FB4C2u, "sps->constraint_set5_flag", sps->constraint_set5_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int reserved_zero_2bits = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xB740DD25u, "reserved_zero_2bits", reserved_zero_2bits); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->level_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xB826F6D7u, "sps->level_idc", sps->level_idc); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->seq_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB10AF9B0u, "sps->seq_parameter_set_id", sps->seq_parameter_set_id); }
 
     if( sps->profile_idc == 100 || sps->profile_idc == 110 ||
         sps->profile_idc == 122 || sps->profile_idc == 244 ||
@@ -3042,20 +3221,20 @@ void read_debug_seq_parameter_set_rbsp(sps_t* sps, bs_t* b)
         sps->profile_idc == 139 || sps->profile_idc == 134
        )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->chroma_format_idc = bs_read_ue(b); printf("sps->chroma_format_idc: %d \n", sps->chroma_format_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->chroma_format_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x6F6238B5u, "sps->chroma_format_idc", sps->chroma_format_idc); }
         if( sps->chroma_format_idc == 3 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->residual_colour_transform_flag = bs_read_u1(b); printf("sps->residual_colour_transform_flag: %d \n", sps->residual_colour_transform_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->residual_colour_transform_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x29019BA2u, "sps->residual_colour_transform_flag", sps->residual_colour_transform_flag); }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->bit_depth_luma_minus8 = bs_read_ue(b); printf("sps->bit_depth_luma_minus8: %d \n", sps->bit_depth_luma_minus8); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->bit_depth_chroma_minus8 = bs_read_ue(b); printf("sps->bit_depth_chroma_minus8: %d \n", sps->bit_depth_chroma_minus8); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->qpprime_y_zero_transform_bypass_flag = bs_read_u1(b); printf("sps->qpprime_y_zero_transform_bypass_flag: %d \n", sps->qpprime_y_zero_transform_bypass_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->seq_scaling_matrix_present_flag = bs_read_u1(b); printf("sps->seq_scaling_matrix_present_flag: %d \n", sps->seq_scaling_matrix_present_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->bit_depth_luma_minus8 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x664F05FCu, "sps->bit_depth_luma_minus8", sps->bit_depth_luma_minus8); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->bit_depth_chroma_minus8 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBBEFF3D9u, "sps->bit_depth_chroma_minus8", sps->bit_depth_chroma_minus8); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->qpprime_y_zero_transform_bypass_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE632F6B0u, "sps->qpprime_y_zero_transform_bypass_flag", sps->qpprime_y_zero_transform_bypass_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->seq_scaling_matrix_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x17019E5Au, "sps->seq_scaling_matrix_present_flag", sps->seq_scaling_matrix_present_flag); }
         if( sps->seq_scaling_matrix_present_flag )
         {
-            for( i = 0; i < 8; i++ )
+            for( i = 0; i < ((sps->chroma_format_idc != 3) ? 8 : 12); i++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->seq_scaling_list_present_flag[ i ] = bs_read_u1(b); printf("sps->seq_scaling_list_present_flag[ i ]: %d \n", sps->seq_scaling_list_present_flag[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->seq_scaling_list_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x50F3146Eu, "sps->seq_scaling_list_present_flag[ i ]", sps->seq_scaling_list_present_flag[ i ]); }
                 if( sps->seq_scaling_list_present_flag[ i ] )
                 {
                     if( i < 6 )
@@ -3072,42 +3251,42 @@ void read_debug_seq_parameter_set_rbsp(sps_t* sps, bs_t* b)
             }
         }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->log2_max_frame_num_minus4 = bs_read_ue(b); printf("sps->log2_max_frame_num_minus4: %d \n", sps->log2_max_frame_num_minus4); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->pic_order_cnt_type = bs_read_ue(b); printf("sps->pic_order_cnt_type: %d \n", sps->pic_order_cnt_type); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_max_frame_num_minus4 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x33BB06ADu, "sps->log2_max_frame_num_minus4", sps->log2_max_frame_num_minus4); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pic_order_cnt_type = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x46D53E6Cu, "sps->pic_order_cnt_type", sps->pic_order_cnt_type); }
     if( sps->pic_order_cnt_type == 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->log2_max_pic_order_cnt_lsb_minus4 = bs_read_ue(b); printf("sps->log2_max_pic_order_cnt_lsb_minus4: %d \n", sps->log2_max_pic_order_cnt_lsb_minus4); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_max_pic_order_cnt_lsb_minus4 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x2A686A28u, "sps->log2_max_pic_order_cnt_lsb_minus4", sps->log2_max_pic_order_cnt_lsb_minus4); }
     }
     else if( sps->pic_order_cnt_type == 1 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->delta_pic_order_always_zero_flag = bs_read_u1(b); printf("sps->delta_pic_order_always_zero_flag: %d \n", sps->delta_pic_order_always_zero_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->offset_for_non_ref_pic = bs_read_se(b); printf("sps->offset_for_non_ref_pic: %d \n", sps->offset_for_non_ref_pic); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->offset_for_top_to_bottom_field = bs_read_se(b); printf("sps->offset_for_top_to_bottom_field: %d \n", sps->offset_for_top_to_bottom_field); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->num_ref_frames_in_pic_order_cnt_cycle = bs_read_ue(b); printf("sps->num_ref_frames_in_pic_order_cnt_cycle: %d \n", sps->num_ref_frames_in_pic_order_cnt_cycle); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->delta_pic_order_always_zero_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC455AA90u, "sps->delta_pic_order_always_zero_flag", sps->delta_pic_order_always_zero_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->offset_for_non_ref_pic = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xF6C15E7Eu, "sps->offset_for_non_ref_pic", sps->offset_for_non_ref_pic); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->offset_for_top_to_bottom_field = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x13E9EE16u, "sps->offset_for_top_to_bottom_field", sps->offset_for_top_to_bottom_field); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->num_ref_frames_in_pic_order_cnt_cycle = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x376A1244u, "sps->num_ref_frames_in_pic_order_cnt_cycle", sps->num_ref_frames_in_pic_order_cnt_cycle); }
         for( i = 0; i < sps->num_ref_frames_in_pic_order_cnt_cycle; i++ )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->offset_for_ref_frame[ i ] = bs_read_se(b); printf("sps->offset_for_ref_frame[ i ]: %d \n", sps->offset_for_ref_frame[ i ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->offset_for_ref_frame[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x5A61C46Cu, "sps->offset_for_ref_frame[ i ]", sps->offset_for_ref_frame[ i ]); }
         }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->num_ref_frames = bs_read_ue(b); printf("sps->num_ref_frames: %d \n", sps->num_ref_frames); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->gaps_in_frame_num_value_allowed_flag = bs_read_u1(b); printf("sps->gaps_in_frame_num_value_allowed_flag: %d \n", sps->gaps_in_frame_num_value_allowed_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->pic_width_in_mbs_minus1 = bs_read_ue(b); printf("sps->pic_width_in_mbs_minus1: %d \n", sps->pic_width_in_mbs_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->pic_height_in_map_units_minus1 = bs_read_ue(b); printf("sps->pic_height_in_map_units_minus1: %d \n", sps->pic_height_in_map_units_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_mbs_only_flag = bs_read_u1(b); printf("sps->frame_mbs_only_flag: %d \n", sps->frame_mbs_only_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->num_ref_frames = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x480EDFBDu, "sps->num_ref_frames", sps->num_ref_frames); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->gaps_in_frame_num_value_allowed_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDC64F080u, "sps->gaps_in_frame_num_value_allowed_flag", sps->gaps_in_frame_num_value_allowed_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pic_width_in_mbs_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x77EAC076u, "sps->pic_width_in_mbs_minus1", sps->pic_width_in_mbs_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pic_height_in_map_units_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xCBEAF48Du, "sps->pic_height_in_map_units_minus1", sps->pic_height_in_map_units_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_mbs_only_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x07D2F140u, "sps->frame_mbs_only_flag", sps->frame_mbs_only_flag); }
     if( !sps->frame_mbs_only_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->mb_adaptive_frame_field_flag = bs_read_u1(b); printf("sps->mb_adaptive_frame_field_flag: %d \n", sps->mb_adaptive_frame_field_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->mb_adaptive_frame_field_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x8804360Au, "sps->mb_adaptive_frame_field_flag", sps->mb_adaptive_frame_field_flag); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->direct_8x8_inference_flag = bs_read_u1(b); printf("sps->direct_8x8_inference_flag: %d \n", sps->direct_8x8_inference_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_cropping_flag = bs_read_u1(b); printf("sps->frame_cropping_flag: %d \n", sps->frame_cropping_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->direct_8x8_inference_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x82791561u, "sps->direct_8x8_inference_flag", sps->direct_8x8_inference_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_cropping_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1EA98E77u, "sps->frame_cropping_flag", sps->frame_cropping_flag); }
     if( sps->frame_cropping_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_crop_left_offset = bs_read_ue(b); printf("sps->frame_crop_left_offset: %d \n", sps->frame_crop_left_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_crop_right_offset = bs_read_ue(b); printf("sps->frame_crop_right_offset: %d \n", sps->frame_crop_right_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_crop_top_offset = bs_read_ue(b); printf("sps->frame_crop_top_offset: %d \n", sps->frame_crop_top_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->frame_crop_bottom_offset = bs_read_ue(b); printf("sps->frame_crop_bottom_offset: %d \n", sps->frame_crop_bottom_offset); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_crop_left_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xCD9983DAu, "sps->frame_crop_left_offset", sps->frame_crop_left_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_crop_right_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD7134661u, "sps->frame_crop_right_offset", sps->frame_crop_right_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_crop_top_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x853B36FEu, "sps->frame_crop_top_offset", sps->frame_crop_top_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->frame_crop_bottom_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x27EA917Cu, "sps->frame_crop_bottom_offset", sps->frame_crop_bottom_offset); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui_parameters_present_flag = bs_read_u1(b); printf("sps->vui_parameters_present_flag: %d \n", sps->vui_parameters_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA58884FCu, "sps->vui_parameters_present_flag", sps->vui_parameters_present_flag); }
     if( sps->vui_parameters_present_flag )
     {
         read_debug_vui_parameters(sps, b);
@@ -3132,7 +3311,7 @@ void read_debug_scaling_list(bs_t* b, int* scalingList, int sizeOfScalingList, i
                 delta_scale = (nextScale - lastScale) % 256 ;
             }
 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); delta_scale = bs_read_se(b); printf("delta_scale: %d \n", delta_scale); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; delta_scale = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x1B14B590u, "delta_scale", delta_scale); }
 
             if( 1 )
             {
@@ -3160,7 +3339,7 @@ void read_debug_subset_seq_parameter_set_rbsp(sps_subset_t* sps_subset, bs_t* b)
             read_debug_seq_parameter_set_svc_extension(sps_subset, b); /* specified in Annex G */
             
             sps_svc_ext_t* sps_svc_ext = sps_subset->sps_svc_ext;
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->svc_vui_parameters_present_flag = bs_read_u1(b); printf("sps_svc_ext->svc_vui_parameters_present_flag: %d \n", sps_svc_ext->svc_vui_parameters_present_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->svc_vui_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDE1AA042u, "sps_svc_ext->svc_vui_parameters_present_flag", sps_svc_ext->svc_vui_parameters_present_flag); }
             
             if( sps_svc_ext->svc_vui_parameters_present_flag )
             {
@@ -3170,12 +3349,12 @@ void read_debug_subset_seq_parameter_set_rbsp(sps_subset_t* sps_subset, bs_t* b)
         default:
             break;
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_subset->additional_extension2_flag = bs_read_u1(b); printf("sps_subset->additional_extension2_flag: %d \n", sps_subset->additional_extension2_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_subset->additional_extension2_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9687A85Fu, "sps_subset->additional_extension2_flag", sps_subset->additional_extension2_flag); }
     if( sps_subset->additional_extension2_flag )
     {
         while( more_rbsp_data( b ) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_subset->additional_extension2_flag = bs_read_u1(b); printf("sps_subset->additional_extension2_flag: %d \n", sps_subset->additional_extension2_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_subset->additional_extension2_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9687A85Fu, "sps_subset->additional_extension2_flag", sps_subset->additional_extension2_flag); }
         }
     }
     
@@ -3185,59 +3364,59 @@ void read_debug_subset_seq_parameter_set_rbsp(sps_subset_t* sps_subset, bs_t* b)
 void read_debug_seq_parameter_set_svc_extension(sps_subset_t* sps_subset, bs_t* b)
 {
     sps_svc_ext_t* sps_svc_ext = sps_subset->sps_svc_ext;
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->inter_layer_deblocking_filter_control_present_flag = bs_read_u1(b); printf("sps_svc_ext->inter_layer_deblocking_filter_control_present_flag: %d \n", sps_svc_ext->inter_layer_deblocking_filter_control_present_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->extended_spatial_scalability_idc = bs_read_u(b, 2); printf("sps_svc_ext->extended_spatial_scalability_idc: %d \n", sps_svc_ext->extended_spatial_scalability_idc); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->inter_layer_deblocking_filter_control_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x631C4A34u, "sps_svc_ext->inter_layer_deblocking_filter_control_present_flag", sps_svc_ext->inter_layer_deblocking_filter_control_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->extended_spatial_scalability_idc = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x0AF878CAu, "sps_svc_ext->extended_spatial_scalability_idc", sps_svc_ext->extended_spatial_scalability_idc); }
     if( sps_subset->sps->chroma_format_idc == 1 || sps_subset->sps->chroma_format_idc == 2 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->chroma_phase_x_plus1_flag = bs_read_u1(b); printf("sps_svc_ext->chroma_phase_x_plus1_flag: %d \n", sps_svc_ext->chroma_phase_x_plus1_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->chroma_phase_x_plus1_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x01750137u, "sps_svc_ext->chroma_phase_x_plus1_flag", sps_svc_ext->chroma_phase_x_plus1_flag); }
     }
     if( sps_subset->sps->chroma_format_idc == 1 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->chroma_phase_y_plus1 = bs_read_u(b, 2); printf("sps_svc_ext->chroma_phase_y_plus1: %d \n", sps_svc_ext->chroma_phase_y_plus1); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->chroma_phase_y_plus1 = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xC978D7F3u, "sps_svc_ext->chroma_phase_y_plus1", sps_svc_ext->chroma_phase_y_plus1); }
     }
     if( sps_svc_ext->extended_spatial_scalability_idc )
     {
         if( sps_subset->sps->chroma_format_idc > 0 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); printf("sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag: %d \n", sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); printf("sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1: %d \n", sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x5603AC43u, "sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag", sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x53C258B7u, "sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1", sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1); }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_scaled_ref_layer_left_offset = bs_read_se(b); printf("sps_svc_ext->seq_scaled_ref_layer_left_offset: %d \n", sps_svc_ext->seq_scaled_ref_layer_left_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_scaled_ref_layer_top_offset = bs_read_se(b); printf("sps_svc_ext->seq_scaled_ref_layer_top_offset: %d \n", sps_svc_ext->seq_scaled_ref_layer_top_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_scaled_ref_layer_right_offset = bs_read_se(b); printf("sps_svc_ext->seq_scaled_ref_layer_right_offset: %d \n", sps_svc_ext->seq_scaled_ref_layer_right_offset); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_scaled_ref_layer_bottom_offset = bs_read_se(b); printf("sps_svc_ext->seq_scaled_ref_layer_bottom_offset: %d \n", sps_svc_ext->seq_scaled_ref_layer_bottom_offset); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_scaled_ref_layer_left_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x713C1BB9u, "sps_svc_ext->seq_scaled_ref_layer_left_offset", sps_svc_ext->seq_scaled_ref_layer_left_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_scaled_ref_layer_top_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x314911FBu, "sps_svc_ext->seq_scaled_ref_layer_top_offset", sps_svc_ext->seq_scaled_ref_layer_top_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_scaled_ref_layer_right_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x66B53920u, "sps_svc_ext->seq_scaled_ref_layer_right_offset", sps_svc_ext->seq_scaled_ref_layer_right_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_scaled_ref_layer_bottom_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x95FA3193u, "sps_svc_ext->seq_scaled_ref_layer_bottom_offset", sps_svc_ext->seq_scaled_ref_layer_bottom_offset); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->seq_tcoeff_level_prediction_flag = bs_read_u1(b); printf("sps_svc_ext->seq_tcoeff_level_prediction_flag: %d \n", sps_svc_ext->seq_tcoeff_level_prediction_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->seq_tcoeff_level_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC3C4323Au, "sps_svc_ext->seq_tcoeff_level_prediction_flag", sps_svc_ext->seq_tcoeff_level_prediction_flag); }
     if( sps_svc_ext->seq_tcoeff_level_prediction_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->adaptive_tcoeff_level_prediction_flag = bs_read_u1(b); printf("sps_svc_ext->adaptive_tcoeff_level_prediction_flag: %d \n", sps_svc_ext->adaptive_tcoeff_level_prediction_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->adaptive_tcoeff_level_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x96B8A3CBu, "sps_svc_ext->adaptive_tcoeff_level_prediction_flag", sps_svc_ext->adaptive_tcoeff_level_prediction_flag); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->slice_header_restriction_flag = bs_read_u1(b); printf("sps_svc_ext->slice_header_restriction_flag: %d \n", sps_svc_ext->slice_header_restriction_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->slice_header_restriction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x72A47A25u, "sps_svc_ext->slice_header_restriction_flag", sps_svc_ext->slice_header_restriction_flag); }
 }
 
 //Appendix G.14.1 SVC VUI parameters extension syntax
 void read_debug_svc_vui_parameters_extension(sps_svc_ext_t* sps_svc_ext, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_num_entries_minus1 = bs_read_ue(b); printf("sps_svc_ext->vui.vui_ext_num_entries_minus1: %d \n", sps_svc_ext->vui.vui_ext_num_entries_minus1); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_num_entries_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBEB88EA9u, "sps_svc_ext->vui.vui_ext_num_entries_minus1", sps_svc_ext->vui.vui_ext_num_entries_minus1); }
     for( int i = 0; i <= sps_svc_ext->vui.vui_ext_num_entries_minus1; i++ )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_dependency_id[i] = bs_read_u(b, 3); printf("sps_svc_ext->vui.vui_ext_dependency_id[i]: %d \n", sps_svc_ext->vui.vui_ext_dependency_id[i]); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_quality_id[i] = bs_read_u(b, 4); printf("sps_svc_ext->vui.vui_ext_quality_id[i]: %d \n", sps_svc_ext->vui.vui_ext_quality_id[i]); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_temporal_id[i] = bs_read_u(b, 3); printf("sps_svc_ext->vui.vui_ext_temporal_id[i]: %d \n", sps_svc_ext->vui.vui_ext_temporal_id[i]); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_timing_info_present_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_timing_info_present_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_timing_info_present_flag[i]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_dependency_id[i] = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xD07879C4u, "sps_svc_ext->vui.vui_ext_dependency_id[i]", sps_svc_ext->vui.vui_ext_dependency_id[i]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_quality_id[i] = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x058A577Cu, "sps_svc_ext->vui.vui_ext_quality_id[i]", sps_svc_ext->vui.vui_ext_quality_id[i]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_temporal_id[i] = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x91FF32DFu, "sps_svc_ext->vui.vui_ext_temporal_id[i]", sps_svc_ext->vui.vui_ext_temporal_id[i]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_timing_info_present_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x104E5C9Fu, "sps_svc_ext->vui.vui_ext_timing_info_present_flag[i]", sps_svc_ext->vui.vui_ext_timing_info_present_flag[i]); }
         if( sps_svc_ext->vui.vui_ext_timing_info_present_flag[i] )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_num_units_in_tick[i] = bs_read_u(b, 32); printf("sps_svc_ext->vui.vui_ext_num_units_in_tick[i]: %d \n", sps_svc_ext->vui.vui_ext_num_units_in_tick[i]); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_time_scale[i] = bs_read_u(b, 32); printf("sps_svc_ext->vui.vui_ext_time_scale[i]: %d \n", sps_svc_ext->vui.vui_ext_time_scale[i]); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_num_units_in_tick[i] = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0x1D5E02FFu, "sps_svc_ext->vui.vui_ext_num_units_in_tick[i]", sps_svc_ext->vui.vui_ext_num_units_in_tick[i]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_time_scale[i] = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0xC0991525u, "sps_svc_ext->vui.vui_ext_time_scale[i]", sps_svc_ext->vui.vui_ext_time_scale[i]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFD21B887u, "sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i]", sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i]); }
         }
 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x63F10AD7u, "sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i]", sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i]); }
         if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] )
         {
             read_debug_hrd_parameters(&sps_svc_ext->hrd_vcl[i], b);
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3659A41Du, "sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i]", sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i]); }
         if( sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] )
         {
             read_debug_hrd_parameters(&sps_svc_ext->hrd_nal[i], b);
@@ -3246,81 +3425,81 @@ void read_debug_svc_vui_parameters_extension(sps_svc_ext_t* sps_svc_ext, bs_t* b
         if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] ||
             sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6E8DFD9Bu, "sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i]", sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i]); }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i] = bs_read_u1(b); printf("sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i]: %d \n", sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6BDF54D8u, "sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i]", sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i]); }
     }
 }
 
 //Appendix E.1.1 VUI parameters syntax
 void read_debug_vui_parameters(sps_t* sps, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.aspect_ratio_info_present_flag = bs_read_u1(b); printf("sps->vui.aspect_ratio_info_present_flag: %d \n", sps->vui.aspect_ratio_info_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.aspect_ratio_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3884A7D6u, "sps->vui.aspect_ratio_info_present_flag", sps->vui.aspect_ratio_info_present_flag); }
     if( sps->vui.aspect_ratio_info_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.aspect_ratio_idc = bs_read_u8(b); printf("sps->vui.aspect_ratio_idc: %d \n", sps->vui.aspect_ratio_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.aspect_ratio_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xEFA464BFu, "sps->vui.aspect_ratio_idc", sps->vui.aspect_ratio_idc); }
         if( sps->vui.aspect_ratio_idc == SAR_Extended )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.sar_width = bs_read_u(b, 16); printf("sps->vui.sar_width: %d \n", sps->vui.sar_width); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.sar_height = bs_read_u(b, 16); printf("sps->vui.sar_height: %d \n", sps->vui.sar_height); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.sar_width = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x6B39F0AFu, "sps->vui.sar_width", sps->vui.sar_width); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.sar_height = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x04DC3452u, "sps->vui.sar_height", sps->vui.sar_height); }
         }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.overscan_info_present_flag = bs_read_u1(b); printf("sps->vui.overscan_info_present_flag: %d \n", sps->vui.overscan_info_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.overscan_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x91B11011u, "sps->vui.overscan_info_present_flag", sps->vui.overscan_info_present_flag); }
     if( sps->vui.overscan_info_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.overscan_appropriate_flag = bs_read_u1(b); printf("sps->vui.overscan_appropriate_flag: %d \n", sps->vui.overscan_appropriate_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.overscan_appropriate_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6310A094u, "sps->vui.overscan_appropriate_flag", sps->vui.overscan_appropriate_flag); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.video_signal_type_present_flag = bs_read_u1(b); printf("sps->vui.video_signal_type_present_flag: %d \n", sps->vui.video_signal_type_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_signal_type_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x50A5A40Au, "sps->vui.video_signal_type_present_flag", sps->vui.video_signal_type_present_flag); }
     if( sps->vui.video_signal_type_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.video_format = bs_read_u(b, 3); printf("sps->vui.video_format: %d \n", sps->vui.video_format); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.video_full_range_flag = bs_read_u1(b); printf("sps->vui.video_full_range_flag: %d \n", sps->vui.video_full_range_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.colour_description_present_flag = bs_read_u1(b); printf("sps->vui.colour_description_present_flag: %d \n", sps->vui.colour_description_present_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_format = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x987DF82Du, "sps->vui.video_format", sps->vui.video_format); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_full_range_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE3CB6388u, "sps->vui.video_full_range_flag", sps->vui.video_full_range_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.colour_description_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD7F2F03Au, "sps->vui.colour_description_present_flag", sps->vui.colour_description_present_flag); }
         if( sps->vui.colour_description_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.colour_primaries = bs_read_u8(b); printf("sps->vui.colour_primaries: %d \n", sps->vui.colour_primaries); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.transfer_characteristics = bs_read_u8(b); printf("sps->vui.transfer_characteristics: %d \n", sps->vui.transfer_characteristics); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.matrix_coefficients = bs_read_u8(b); printf("sps->vui.matrix_coefficients: %d \n", sps->vui.matrix_coefficients); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.colour_primaries = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xCE4B0EC7u, "sps->vui.colour_primaries", sps->vui.colour_primaries); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.transfer_characteristics = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x565718C0u, "sps->vui.transfer_characteristics", sps->vui.transfer_characteristics); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.matrix_coefficients = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xCCCACA22u, "sps->vui.matrix_coefficients", sps->vui.matrix_coefficients); }
         }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.chroma_loc_info_present_flag = bs_read_u1(b); printf("sps->vui.chroma_loc_info_present_flag: %d \n", sps->vui.chroma_loc_info_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_loc_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6AEC4651u, "sps->vui.chroma_loc_info_present_flag", sps->vui.chroma_loc_info_present_flag); }
     if( sps->vui.chroma_loc_info_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.chroma_sample_loc_type_top_field = bs_read_ue(b); printf("sps->vui.chroma_sample_loc_type_top_field: %d \n", sps->vui.chroma_sample_loc_type_top_field); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.chroma_sample_loc_type_bottom_field = bs_read_ue(b); printf("sps->vui.chroma_sample_loc_type_bottom_field: %d \n", sps->vui.chroma_sample_loc_type_bottom_field); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_sample_loc_type_top_field = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB0EECC1Cu, "sps->vui.chroma_sample_loc_type_top_field", sps->vui.chroma_sample_loc_type_top_field); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_sample_loc_type_bottom_field = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x78386E84u, "sps->vui.chroma_sample_loc_type_bottom_field", sps->vui.chroma_sample_loc_type_bottom_field); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.timing_info_present_flag = bs_read_u1(b); printf("sps->vui.timing_info_present_flag: %d \n", sps->vui.timing_info_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.timing_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x128B2F14u, "sps->vui.timing_info_present_flag", sps->vui.timing_info_present_flag); }
     if( sps->vui.timing_info_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.num_units_in_tick = bs_read_u(b, 32); printf("sps->vui.num_units_in_tick: %d \n", sps->vui.num_units_in_tick); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.time_scale = bs_read_u(b, 32); printf("sps->vui.time_scale: %d \n", sps->vui.time_scale); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.fixed_frame_rate_flag = bs_read_u1(b); printf("sps->vui.fixed_frame_rate_flag: %d \n", sps->vui.fixed_frame_rate_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.num_units_in_tick = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0x86EEDE6Cu, "sps->vui.num_units_in_tick", sps->vui.num_units_in_tick); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.time_scale = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0x218F4A62u, "sps->vui.time_scale", sps->vui.time_scale); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.fixed_frame_rate_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE48BBEDCu, "sps->vui.fixed_frame_rate_flag", sps->vui.fixed_frame_rate_flag); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.nal_hrd_parameters_present_flag = bs_read_u1(b); printf("sps->vui.nal_hrd_parameters_present_flag: %d \n", sps->vui.nal_hrd_parameters_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.nal_hrd_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9C3DB6ACu, "sps->vui.nal_hrd_parameters_present_flag", sps->vui.nal_hrd_parameters_present_flag); }
     if( sps->vui.nal_hrd_parameters_present_flag )
     {
         read_debug_hrd_parameters(&sps->hrd_nal, b);
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.vcl_hrd_parameters_present_flag = bs_read_u1(b); printf("sps->vui.vcl_hrd_parameters_present_flag: %d \n", sps->vui.vcl_hrd_parameters_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vcl_hrd_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC221E242u, "sps->vui.vcl_hrd_parameters_present_flag", sps->vui.vcl_hrd_parameters_present_flag); }
     if( sps->vui.vcl_hrd_parameters_present_flag )
     {
         read_debug_hrd_parameters(&sps->hrd_vcl, b);
     }
     if( sps->vui.nal_hrd_parameters_present_flag || sps->vui.vcl_hrd_parameters_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.low_delay_hrd_flag = bs_read_u1(b); printf("sps->vui.low_delay_hrd_flag: %d \n", sps->vui.low_delay_hrd_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.low_delay_hrd_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4F316D20u, "sps->vui.low_delay_hrd_flag", sps->vui.low_delay_hrd_flag); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.pic_struct_present_flag = bs_read_u1(b); printf("sps->vui.pic_struct_present_flag: %d \n", sps->vui.pic_struct_present_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.bitstream_restriction_flag = bs_read_u1(b); printf("sps->vui.bitstream_restriction_flag: %d \n", sps->vui.bitstream_restriction_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.pic_struct_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBEF94BADu, "sps->vui.pic_struct_present_flag", sps->vui.pic_struct_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.bitstream_restriction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7C18EA6Bu, "sps->vui.bitstream_restriction_flag", sps->vui.bitstream_restriction_flag); }
     if( sps->vui.bitstream_restriction_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); printf("sps->vui.motion_vectors_over_pic_boundaries_flag: %d \n", sps->vui.motion_vectors_over_pic_boundaries_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.max_bytes_per_pic_denom = bs_read_ue(b); printf("sps->vui.max_bytes_per_pic_denom: %d \n", sps->vui.max_bytes_per_pic_denom); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.max_bits_per_mb_denom = bs_read_ue(b); printf("sps->vui.max_bits_per_mb_denom: %d \n", sps->vui.max_bits_per_mb_denom); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.log2_max_mv_length_horizontal = bs_read_ue(b); printf("sps->vui.log2_max_mv_length_horizontal: %d \n", sps->vui.log2_max_mv_length_horizontal); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.log2_max_mv_length_vertical = bs_read_ue(b); printf("sps->vui.log2_max_mv_length_vertical: %d \n", sps->vui.log2_max_mv_length_vertical); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.num_reorder_frames = bs_read_ue(b); printf("sps->vui.num_reorder_frames: %d \n", sps->vui.num_reorder_frames); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sps->vui.max_dec_frame_buffering = bs_read_ue(b); printf("sps->vui.max_dec_frame_buffering: %d \n", sps->vui.max_dec_frame_buffering); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFAB7A89Fu, "sps->vui.motion_vectors_over_pic_boundaries_flag", sps->vui.motion_vectors_over_pic_boundaries_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.max_bytes_per_pic_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x6A6A4BC3u, "sps->vui.max_bytes_per_pic_denom", sps->vui.max_bytes_per_pic_denom); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.max_bits_per_mb_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD4454321u, "sps->vui.max_bits_per_mb_denom", sps->vui.max_bits_per_mb_denom); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.log2_max_mv_length_horizontal = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDF7539A1u, "sps->vui.log2_max_mv_length_horizontal", sps->vui.log2_max_mv_length_horizontal); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.log2_max_mv_length_vertical = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xEF2EB4A3u, "sps->vui.log2_max_mv_length_vertical", sps->vui.log2_max_mv_length_vertical); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.num_reorder_frames = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7B55E0E5u, "sps->vui.num_reorder_frames", sps->vui.num_reorder_frames); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.max_dec_frame_buffering = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x461D0874u, "sps->vui.max_dec_frame_buffering", sps->vui.max_dec_frame_buffering); }
     }
 }
 
@@ -3328,19 +3507,19 @@ void read_debug_vui_parameters(sps_t* sps, bs_t* b)
 //Appendix E.1.2 HRD parameters syntax
 void read_debug_hrd_parameters(hrd_t* hrd, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->cpb_cnt_minus1 = bs_read_ue(b); printf("hrd->cpb_cnt_minus1: %d \n", hrd->cpb_cnt_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->bit_rate_scale = bs_read_u(b, 4); printf("hrd->bit_rate_scale: %d \n", hrd->bit_rate_scale); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->cpb_size_scale = bs_read_u(b, 4); printf("hrd->cpb_size_scale: %d \n", hrd->cpb_size_scale); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_cnt_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x11DA04A9u, "hrd->cpb_cnt_minus1", hrd->cpb_cnt_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->bit_rate_scale = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x789F7519u, "hrd->bit_rate_scale", hrd->bit_rate_scale); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_size_scale = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xBCE2EED2u, "hrd->cpb_size_scale", hrd->cpb_size_scale); }
     for( int SchedSelIdx = 0; SchedSelIdx <= hrd->cpb_cnt_minus1; SchedSelIdx++ )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->bit_rate_value_minus1[ SchedSelIdx ] = bs_read_ue(b); printf("hrd->bit_rate_value_minus1[ SchedSelIdx ]: %d \n", hrd->bit_rate_value_minus1[ SchedSelIdx ]); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->cpb_size_value_minus1[ SchedSelIdx ] = bs_read_ue(b); printf("hrd->cpb_size_value_minus1[ SchedSelIdx ]: %d \n", hrd->cpb_size_value_minus1[ SchedSelIdx ]); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->cbr_flag[ SchedSelIdx ] = bs_read_u1(b); printf("hrd->cbr_flag[ SchedSelIdx ]: %d \n", hrd->cbr_flag[ SchedSelIdx ]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->bit_rate_value_minus1[ SchedSelIdx ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x508939FAu, "hrd->bit_rate_value_minus1[ SchedSelIdx ]", hrd->bit_rate_value_minus1[ SchedSelIdx ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_size_value_minus1[ SchedSelIdx ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC09DD4A1u, "hrd->cpb_size_value_minus1[ SchedSelIdx ]", hrd->cpb_size_value_minus1[ SchedSelIdx ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cbr_flag[ SchedSelIdx ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xAD77AA3Cu, "hrd->cbr_flag[ SchedSelIdx ]", hrd->cbr_flag[ SchedSelIdx ]); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->initial_cpb_removal_delay_length_minus1 = bs_read_u(b, 5); printf("hrd->initial_cpb_removal_delay_length_minus1: %d \n", hrd->initial_cpb_removal_delay_length_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->cpb_removal_delay_length_minus1 = bs_read_u(b, 5); printf("hrd->cpb_removal_delay_length_minus1: %d \n", hrd->cpb_removal_delay_length_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->dpb_output_delay_length_minus1 = bs_read_u(b, 5); printf("hrd->dpb_output_delay_length_minus1: %d \n", hrd->dpb_output_delay_length_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); hrd->time_offset_length = bs_read_u(b, 5); printf("hrd->time_offset_length: %d \n", hrd->time_offset_length); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->initial_cpb_removal_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xFE8EAC8Cu, "hrd->initial_cpb_removal_delay_length_minus1", hrd->initial_cpb_removal_delay_length_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_removal_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x9D257C9Bu, "hrd->cpb_removal_delay_length_minus1", hrd->cpb_removal_delay_length_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->dpb_output_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xBC80045Du, "hrd->dpb_output_delay_length_minus1", hrd->dpb_output_delay_length_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->time_offset_length = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xF6072640u, "hrd->time_offset_length", hrd->time_offset_length); }
 }
 
 
@@ -3348,15 +3527,15 @@ void read_debug_hrd_parameters(hrd_t* hrd, bs_t* b)
 UNIMPLEMENTED
 //7.3.2.1.2 Sequence parameter set extension RBSP syntax
 int read_debug_seq_parameter_set_extension_rbsp(bs_t* b, sps_ext_t* sps_ext) {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); seq_parameter_set_id = bs_read_ue(b); printf("seq_parameter_set_id: %d \n", seq_parameter_set_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); aux_format_idc = bs_read_ue(b); printf("aux_format_idc: %d \n", aux_format_idc); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; seq_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7922D34Du, "seq_parameter_set_id", seq_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; aux_format_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA48FA9ECu, "aux_format_idc", aux_format_idc); }
     if( aux_format_idc != 0 ) {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); bit_depth_aux_minus8 = bs_read_ue(b); printf("bit_depth_aux_minus8: %d \n", bit_depth_aux_minus8); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); alpha_incr_flag = bs_read_u1(b); printf("alpha_incr_flag: %d \n", alpha_incr_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; bit_depth_aux_minus8 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x3A3D1D78u, "bit_depth_aux_minus8", bit_depth_aux_minus8); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; alpha_incr_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB77D4F75u, "alpha_incr_flag", alpha_incr_flag); }
         alpha_opaque_value = bs_read_debug_u(v);
         alpha_transparent_value = bs_read_debug_u(v);
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); additional_extension_flag = bs_read_u1(b); printf("additional_extension_flag: %d \n", additional_extension_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; additional_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE104D1B5u, "additional_extension_flag", additional_extension_flag); }
     read_debug_rbsp_trailing_bits();
 }
 */
@@ -3370,74 +3549,74 @@ void read_debug_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
         memset(pps, 0, sizeof(pps_t));
     }
 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_parameter_set_id = bs_read_ue(b); printf("pps->pic_parameter_set_id: %d \n", pps->pic_parameter_set_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->seq_parameter_set_id = bs_read_ue(b); printf("pps->seq_parameter_set_id: %d \n", pps->seq_parameter_set_id); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->entropy_coding_mode_flag = bs_read_u1(b); printf("pps->entropy_coding_mode_flag: %d \n", pps->entropy_coding_mode_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_order_present_flag = bs_read_u1(b); printf("pps->pic_order_present_flag: %d \n", pps->pic_order_present_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->num_slice_groups_minus1 = bs_read_ue(b); printf("pps->num_slice_groups_minus1: %d \n", pps->num_slice_groups_minus1); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x68B23910u, "pps->pic_parameter_set_id", pps->pic_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->seq_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x4D11F1B1u, "pps->seq_parameter_set_id", pps->seq_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->entropy_coding_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBC12E810u, "pps->entropy_coding_mode_flag", pps->entropy_coding_mode_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_order_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x533B879Bu, "pps->pic_order_present_flag", pps->pic_order_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_slice_groups_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC7089C13u, "pps->num_slice_groups_minus1", pps->num_slice_groups_minus1); }
 
     if( pps->num_slice_groups_minus1 > 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->slice_group_map_type = bs_read_ue(b); printf("pps->slice_group_map_type: %d \n", pps->slice_group_map_type); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->slice_group_map_type = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7DF19349u, "pps->slice_group_map_type", pps->slice_group_map_type); }
         if( pps->slice_group_map_type == 0 )
         {
             for( int i_group = 0; i_group <= pps->num_slice_groups_minus1; i_group++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->run_length_minus1[ i_group ] = bs_read_ue(b); printf("pps->run_length_minus1[ i_group ]: %d \n", pps->run_length_minus1[ i_group ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->run_length_minus1[ i_group ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9A3C0BF4u, "pps->run_length_minus1[ i_group ]", pps->run_length_minus1[ i_group ]); }
             }
         }
         else if( pps->slice_group_map_type == 2 )
         {
             for( int i_group = 0; i_group < pps->num_slice_groups_minus1; i_group++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->top_left[ i_group ] = bs_read_ue(b); printf("pps->top_left[ i_group ]: %d \n", pps->top_left[ i_group ]); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->bottom_right[ i_group ] = bs_read_ue(b); printf("pps->bottom_right[ i_group ]: %d \n", pps->bottom_right[ i_group ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->top_left[ i_group ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x61D70951u, "pps->top_left[ i_group ]", pps->top_left[ i_group ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->bottom_right[ i_group ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xAF2DC34Cu, "pps->bottom_right[ i_group ]", pps->bottom_right[ i_group ]); }
             }
         }
         else if( pps->slice_group_map_type == 3 ||
                  pps->slice_group_map_type == 4 ||
                  pps->slice_group_map_type == 5 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->slice_group_change_direction_flag = bs_read_u1(b); printf("pps->slice_group_change_direction_flag: %d \n", pps->slice_group_change_direction_flag); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->slice_group_change_rate_minus1 = bs_read_ue(b); printf("pps->slice_group_change_rate_minus1: %d \n", pps->slice_group_change_rate_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->slice_group_change_direction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC0959D13u, "pps->slice_group_change_direction_flag", pps->slice_group_change_direction_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->slice_group_change_rate_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD584F7FDu, "pps->slice_group_change_rate_minus1", pps->slice_group_change_rate_minus1); }
         }
         else if( pps->slice_group_map_type == 6 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_size_in_map_units_minus1 = bs_read_ue(b); printf("pps->pic_size_in_map_units_minus1: %d \n", pps->pic_size_in_map_units_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_size_in_map_units_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8D01C1DEu, "pps->pic_size_in_map_units_minus1", pps->pic_size_in_map_units_minus1); }
             for( int i = 0; i <= pps->pic_size_in_map_units_minus1; i++ )
             {
                 int v = intlog2( pps->num_slice_groups_minus1 + 1 );
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->slice_group_id[ i ] = bs_read_u(b, v); printf("pps->slice_group_id[ i ]: %d \n", pps->slice_group_id[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->slice_group_id[ i ] = bs_read_u(b, v); h264_debug_value(_pos, _bits_left, 0xB56315B0u, "pps->slice_group_id[ i ]", pps->slice_group_id[ i ]); }
             }
         }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->num_ref_idx_l0_active_minus1 = bs_read_ue(b); printf("pps->num_ref_idx_l0_active_minus1: %d \n", pps->num_ref_idx_l0_active_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->num_ref_idx_l1_active_minus1 = bs_read_ue(b); printf("pps->num_ref_idx_l1_active_minus1: %d \n", pps->num_ref_idx_l1_active_minus1); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->weighted_pred_flag = bs_read_u1(b); printf("pps->weighted_pred_flag: %d \n", pps->weighted_pred_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->weighted_bipred_idc = bs_read_u(b, 2); printf("pps->weighted_bipred_idc: %d \n", pps->weighted_bipred_idc); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_init_qp_minus26 = bs_read_se(b); printf("pps->pic_init_qp_minus26: %d \n", pps->pic_init_qp_minus26); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_init_qs_minus26 = bs_read_se(b); printf("pps->pic_init_qs_minus26: %d \n", pps->pic_init_qs_minus26); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->chroma_qp_index_offset = bs_read_se(b); printf("pps->chroma_qp_index_offset: %d \n", pps->chroma_qp_index_offset); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->deblocking_filter_control_present_flag = bs_read_u1(b); printf("pps->deblocking_filter_control_present_flag: %d \n", pps->deblocking_filter_control_present_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->constrained_intra_pred_flag = bs_read_u1(b); printf("pps->constrained_intra_pred_flag: %d \n", pps->constrained_intra_pred_flag); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->redundant_pic_cnt_present_flag = bs_read_u1(b); printf("pps->redundant_pic_cnt_present_flag: %d \n", pps->redundant_pic_cnt_present_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_ref_idx_l0_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xCF445549u, "pps->num_ref_idx_l0_active_minus1", pps->num_ref_idx_l0_active_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_ref_idx_l1_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC6650FE6u, "pps->num_ref_idx_l1_active_minus1", pps->num_ref_idx_l1_active_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->weighted_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC95D0631u, "pps->weighted_pred_flag", pps->weighted_pred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->weighted_bipred_idc = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x925A6E4Au, "pps->weighted_bipred_idc", pps->weighted_bipred_idc); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_init_qp_minus26 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xFC26EF25u, "pps->pic_init_qp_minus26", pps->pic_init_qp_minus26); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_init_qs_minus26 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xC0B518BCu, "pps->pic_init_qs_minus26", pps->pic_init_qs_minus26); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->chroma_qp_index_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xA98E2E8Cu, "pps->chroma_qp_index_offset", pps->chroma_qp_index_offset); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->deblocking_filter_control_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC8868471u, "pps->deblocking_filter_control_present_flag", pps->deblocking_filter_control_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->constrained_intra_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4FE55835u, "pps->constrained_intra_pred_flag", pps->constrained_intra_pred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->redundant_pic_cnt_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x08B21270u, "pps->redundant_pic_cnt_present_flag", pps->redundant_pic_cnt_present_flag); }
 
     int have_more_data = 0;
     if( 1 ) { have_more_data = more_rbsp_data(b); }
     if( 0 )
     {
-        have_more_data = pps->transform_8x8_mode_flag | pps->pic_scaling_matrix_present_flag | pps->second_chroma_qp_index_offset != 0;
+        have_more_data = pps->transform_8x8_mode_flag || pps->pic_scaling_matrix_present_flag || pps->second_chroma_qp_index_offset != 0;
     }
 
     if( have_more_data )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->transform_8x8_mode_flag = bs_read_u1(b); printf("pps->transform_8x8_mode_flag: %d \n", pps->transform_8x8_mode_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_scaling_matrix_present_flag = bs_read_u1(b); printf("pps->pic_scaling_matrix_present_flag: %d \n", pps->pic_scaling_matrix_present_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->transform_8x8_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBC0C3C91u, "pps->transform_8x8_mode_flag", pps->transform_8x8_mode_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_scaling_matrix_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4D1BC97Au, "pps->pic_scaling_matrix_present_flag", pps->pic_scaling_matrix_present_flag); }
         if( pps->pic_scaling_matrix_present_flag )
         {
             for( int i = 0; i < 6 + 2* pps->transform_8x8_mode_flag; i++ )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->pic_scaling_list_present_flag[ i ] = bs_read_u1(b); printf("pps->pic_scaling_list_present_flag[ i ]: %d \n", pps->pic_scaling_list_present_flag[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pic_scaling_list_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4169BA0Eu, "pps->pic_scaling_list_present_flag[ i ]", pps->pic_scaling_list_present_flag[ i ]); }
                 if( pps->pic_scaling_list_present_flag[ i ] )
                 {
                     if( i < 6 )
@@ -3453,12 +3632,13 @@ void read_debug_pic_parameter_set_rbsp(h264_stream_t* h, bs_t* b)
                 }
             }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); pps->second_chroma_qp_index_offset = bs_read_se(b); printf("pps->second_chroma_qp_index_offset: %d \n", pps->second_chroma_qp_index_offset); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->second_chroma_qp_index_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xDE87226Fu, "pps->second_chroma_qp_index_offset", pps->second_chroma_qp_index_offset); }
     }
 
     if( 1 )
     {
-        memcpy(h->pps_table[pps->pic_parameter_set_id], h->pps, sizeof(pps_t));
+        pps_t* slot = h264_pps_slot(h, pps->pic_parameter_set_id);
+        if( slot != NULL ) { memcpy(slot, h->pps, sizeof(pps_t)); }
     }
 }
 
@@ -3468,16 +3648,11 @@ void read_debug_sei_rbsp(h264_stream_t* h, bs_t* b)
 {
     if( 1 )
     {
-        for( int i = 0; i < h->num_seis; i++ )
-        {
-            sei_free(h->seis[i]);
-        }
-    
+        // the messages of the previous SEI are reused, with their payload storage
         h->num_seis = 0;
         do {
             h->num_seis++;
-            h->seis = (sei_t**)realloc(h->seis, h->num_seis * sizeof(sei_t*));
-            h->seis[h->num_seis - 1] = sei_new();
+            sei_pool_reserve(h, h->num_seis);
             h->sei = h->seis[h->num_seis - 1];
             read_debug_sei_message(h, b);
         } while( more_rbsp_data(b) );
@@ -3514,7 +3689,7 @@ void read_debug_sei_message(h264_stream_t* h, bs_t* b)
 //7.3.2.4 Access unit delimiter RBSP syntax
 void read_debug_access_unit_delimiter_rbsp(h264_stream_t* h, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); h->aud->primary_pic_type = bs_read_u(b, 3); printf("h->aud->primary_pic_type: %d \n", h->aud->primary_pic_type); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; h->aud->primary_pic_type = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xB9EA56C3u, "h->aud->primary_pic_type", h->aud->primary_pic_type); }
 }
 
 //7.3.2.5 End of sequence RBSP syntax
@@ -3532,7 +3707,7 @@ void read_debug_filler_data_rbsp(h264_stream_t* h, bs_t* b)
 {
     while( bs_next_bits(b, 8) == 0xFF )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int ff_byte = bs_read_u(b, 8); printf("ff_byte: %d \n", ff_byte); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int ff_byte = bs_read_u(b, 8); h264_debug_value(_pos, _bits_left, 0x1B8EDC7Cu, "ff_byte", ff_byte); }
     }
 }
 
@@ -3549,13 +3724,23 @@ void read_debug_slice_layer_rbsp(h264_stream_t* h,  bs_t* b)
     if ( slice_data != NULL )
     {
         if ( slice_data->rbsp_buf != NULL ) free( slice_data->rbsp_buf ); 
-        uint8_t *sptr = b->p + (!!b->bits_left); // CABAC-specific: skip alignment bits, if there are any
-        slice_data->rbsp_size = b->end - sptr;
+        bs_t bs_tmp;
+        bs_clone(&bs_tmp, b);
+        bs_skip_u(&bs_tmp, bs_tmp.bits_left); // CABAC-specific: skip alignment bits, if there are any
+        slice_data->rbsp_size = bs_tmp.end - bs_tmp.p;
 
-        if ( slice_data->rbsp_size > 0 )
+        if ( slice_data->rbsp_size > 0 && 1 && ( 0 || h->parse_depth < H264_PARSE_SLICE_DATA ) )
+        {
+            // only the headers were asked for, leave the payload unread
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+            return;
+        }
+        else if ( slice_data->rbsp_size > 0 )
         {
             slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
-            memcpy( slice_data->rbsp_buf, sptr, slice_data->rbsp_size );
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, slice_data->rbsp_size );
             // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
             return;
         }
@@ -3583,18 +3768,18 @@ slice_data_partition_a_layer_rbsp( ) {
 
 //7.3.2.9.2 Slice data partition B RBSP syntax
 slice_data_partition_b_layer_rbsp( ) {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); slice_id = bs_read_ue(b); printf("slice_id: %d \n", slice_id);     // only category 3
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; slice_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x46E0C087u, "slice_id", slice_id); }    // only category 3
     if( redundant_pic_cnt_present_flag )
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); redundant_pic_cnt = bs_read_ue(b); printf("redundant_pic_cnt: %d \n", redundant_pic_cnt); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; redundant_pic_cnt = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x0467E7E5u, "redundant_pic_cnt", redundant_pic_cnt); }
     read_debug_slice_data( );               // only category 3
     read_debug_rbsp_slice_trailing_bits( ); // only category 3
 }
 
 //7.3.2.9.3 Slice data partition C RBSP syntax
 slice_data_partition_c_layer_rbsp( ) {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); slice_id = bs_read_ue(b); printf("slice_id: %d \n", slice_id);     // only category 4
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; slice_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x46E0C087u, "slice_id", slice_id); }    // only category 4
     if( redundant_pic_cnt_present_flag )
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); redundant_pic_cnt = bs_read_ue(b); printf("redundant_pic_cnt: %d \n", redundant_pic_cnt); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; redundant_pic_cnt = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x0467E7E5u, "redundant_pic_cnt", redundant_pic_cnt); }
     read_debug_slice_data( );               // only category 4
     rbsp_slice_trailing_bits( ); // only category 4
 }
@@ -3608,7 +3793,7 @@ void read_debug_rbsp_slice_trailing_bits(h264_stream_t* h, bs_t* b)
     {
         while( more_rbsp_trailing_data(h, b) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int cabac_zero_word = bs_read_u(b, 16); printf("cabac_zero_word: %d \n", cabac_zero_word); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int cabac_zero_word = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x95137F65u, "cabac_zero_word", cabac_zero_word); }
         }
     }
 }
@@ -3616,11 +3801,11 @@ void read_debug_rbsp_slice_trailing_bits(h264_stream_t* h, bs_t* b)
 //7.3.2.11 RBSP trailing bits syntax
 void read_debug_rbsp_trailing_bits(bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int rbsp_stop_one_bit = bs_read_u(b, 1); printf("rbsp_stop_one_bit: %d \n", rbsp_stop_one_bit); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int rbsp_stop_one_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x02FE9ED0u, "rbsp_stop_one_bit", rbsp_stop_one_bit); }
 
     while( !bs_byte_aligned(b) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); int rbsp_alignment_zero_bit = bs_read_u(b, 1); printf("rbsp_alignment_zero_bit: %d \n", rbsp_alignment_zero_bit); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int rbsp_alignment_zero_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x525C97EBu, "rbsp_alignment_zero_bit", rbsp_alignment_zero_bit); }
     }
 }
 
@@ -3635,67 +3820,87 @@ void read_debug_slice_header(h264_stream_t* h, bs_t* b)
 
     nal_t* nal = h->nal;
 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->first_mb_in_slice = bs_read_ue(b); printf("sh->first_mb_in_slice: %d \n", sh->first_mb_in_slice); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_type = bs_read_ue(b); printf("sh->slice_type: %d \n", sh->slice_type); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pic_parameter_set_id = bs_read_ue(b); printf("sh->pic_parameter_set_id: %d \n", sh->pic_parameter_set_id); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->first_mb_in_slice = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x57733530u, "sh->first_mb_in_slice", sh->first_mb_in_slice); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_type = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x62D7949Au, "sh->slice_type", sh->slice_type); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pic_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x109E2164u, "sh->pic_parameter_set_id", sh->pic_parameter_set_id); }
 
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_t* sps = h->sps;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(h->sps, h->sps_table[pps->seq_parameter_set_id], sizeof(sps_t));
+    if( 1 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h264_activate_pps(h, sh->pic_parameter_set_id);
+        h264_activate_sps(h, pps->seq_parameter_set_id);
+    }
+    else
+    {
+        // always copies, h->pps and h->sps may have been changed by hand; the hashes follow, for the next read
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+        sps_t* sps_slot = h264_sps_slot(h, pps->seq_parameter_set_id);
+        if( sps_slot != NULL )
+        {
+            memcpy(h->sps, sps_slot, sizeof(sps_t));
+            h->sps_hash = h->sps_table_hash[pps->seq_parameter_set_id];
+        }
+    }
 
     if (sps->residual_colour_transform_flag)
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->colour_plane_id = bs_read_u(b, 2); printf("sh->colour_plane_id: %d \n", sh->colour_plane_id); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->colour_plane_id = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x83597CB0u, "sh->colour_plane_id", sh->colour_plane_id); }
     }
-
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->frame_num = bs_read_u(b, sps->log2_max_frame_num_minus4 + 4 ); printf("sh->frame_num: %d \n", sh->frame_num);  // was u(v)
+    
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->frame_num = bs_read_u(b, sps->log2_max_frame_num_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0x73571069u, "sh->frame_num", sh->frame_num); } // was u(v)
     if( !sps->frame_mbs_only_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->field_pic_flag = bs_read_u1(b); printf("sh->field_pic_flag: %d \n", sh->field_pic_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->field_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x54BDCFEFu, "sh->field_pic_flag", sh->field_pic_flag); }
         if( sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->bottom_field_flag = bs_read_u1(b); printf("sh->bottom_field_flag: %d \n", sh->bottom_field_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->bottom_field_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9F603184u, "sh->bottom_field_flag", sh->bottom_field_flag); }
         }
     }
     if( nal->nal_unit_type == 5 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->idr_pic_id = bs_read_ue(b); printf("sh->idr_pic_id: %d \n", sh->idr_pic_id); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->idr_pic_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x10428B47u, "sh->idr_pic_id", sh->idr_pic_id); }
     }
     if( sps->pic_order_cnt_type == 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pic_order_cnt_lsb = bs_read_u(b, sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); printf("sh->pic_order_cnt_lsb: %d \n", sh->pic_order_cnt_lsb);  // was u(v)
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pic_order_cnt_lsb = bs_read_u(b, sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0x4C8264E2u, "sh->pic_order_cnt_lsb", sh->pic_order_cnt_lsb); } // was u(v)
         if( pps->pic_order_present_flag && !sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt_bottom = bs_read_se(b); printf("sh->delta_pic_order_cnt_bottom: %d \n", sh->delta_pic_order_cnt_bottom); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt_bottom = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x5A2017D1u, "sh->delta_pic_order_cnt_bottom", sh->delta_pic_order_cnt_bottom); }
         }
     }
     if( sps->pic_order_cnt_type == 1 && !sps->delta_pic_order_always_zero_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); printf("sh->delta_pic_order_cnt[ 0 ]: %d \n", sh->delta_pic_order_cnt[ 0 ]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD2E3D88Du, "sh->delta_pic_order_cnt[ 0 ]", sh->delta_pic_order_cnt[ 0 ]); }
         if( pps->pic_order_present_flag && !sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); printf("sh->delta_pic_order_cnt[ 1 ]: %d \n", sh->delta_pic_order_cnt[ 1 ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x7F2BD542u, "sh->delta_pic_order_cnt[ 1 ]", sh->delta_pic_order_cnt[ 1 ]); }
         }
     }
     if( pps->redundant_pic_cnt_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->redundant_pic_cnt = bs_read_ue(b); printf("sh->redundant_pic_cnt: %d \n", sh->redundant_pic_cnt); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->redundant_pic_cnt = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA4ECE2F5u, "sh->redundant_pic_cnt", sh->redundant_pic_cnt); }
     }
     if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->direct_spatial_mv_pred_flag = bs_read_u1(b); printf("sh->direct_spatial_mv_pred_flag: %d \n", sh->direct_spatial_mv_pred_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->direct_spatial_mv_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9AA9FC56u, "sh->direct_spatial_mv_pred_flag", sh->direct_spatial_mv_pred_flag); }
     }
     if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_P ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_active_override_flag = bs_read_u1(b); printf("sh->num_ref_idx_active_override_flag: %d \n", sh->num_ref_idx_active_override_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_active_override_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF0140AA8u, "sh->num_ref_idx_active_override_flag", sh->num_ref_idx_active_override_flag); }
         if( sh->num_ref_idx_active_override_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); printf("sh->num_ref_idx_l0_active_minus1: %d \n", sh->num_ref_idx_l0_active_minus1);  // FIXME does this modify the pps?
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x4B3128BDu, "sh->num_ref_idx_l0_active_minus1", sh->num_ref_idx_l0_active_minus1); } // FIXME does this modify the pps?
             if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); printf("sh->num_ref_idx_l1_active_minus1: %d \n", sh->num_ref_idx_l1_active_minus1); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9EAD4B6Au, "sh->num_ref_idx_l1_active_minus1", sh->num_ref_idx_l1_active_minus1); }
             }
         }
     }
@@ -3711,31 +3916,31 @@ void read_debug_slice_header(h264_stream_t* h, bs_t* b)
     }
     if( pps->entropy_coding_mode_flag && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_I ) && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->cabac_init_idc = bs_read_ue(b); printf("sh->cabac_init_idc: %d \n", sh->cabac_init_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->cabac_init_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE1633E39u, "sh->cabac_init_idc", sh->cabac_init_idc); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_qp_delta = bs_read_se(b); printf("sh->slice_qp_delta: %d \n", sh->slice_qp_delta); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_qp_delta = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x7394F832u, "sh->slice_qp_delta", sh->slice_qp_delta); }
     if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
     {
         if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->sp_for_switch_flag = bs_read_u1(b); printf("sh->sp_for_switch_flag: %d \n", sh->sp_for_switch_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->sp_for_switch_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1442BAAEu, "sh->sp_for_switch_flag", sh->sp_for_switch_flag); }
         }
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_qs_delta = bs_read_se(b); printf("sh->slice_qs_delta: %d \n", sh->slice_qs_delta); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_qs_delta = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xED321FBBu, "sh->slice_qs_delta", sh->slice_qs_delta); }
     }
     if( pps->deblocking_filter_control_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->disable_deblocking_filter_idc = bs_read_ue(b); printf("sh->disable_deblocking_filter_idc: %d \n", sh->disable_deblocking_filter_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->disable_deblocking_filter_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1B100012u, "sh->disable_deblocking_filter_idc", sh->disable_deblocking_filter_idc); }
         if( sh->disable_deblocking_filter_idc != 1 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_alpha_c0_offset_div2 = bs_read_se(b); printf("sh->slice_alpha_c0_offset_div2: %d \n", sh->slice_alpha_c0_offset_div2); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_beta_offset_div2 = bs_read_se(b); printf("sh->slice_beta_offset_div2: %d \n", sh->slice_beta_offset_div2); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_alpha_c0_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x01BC7C6Cu, "sh->slice_alpha_c0_offset_div2", sh->slice_alpha_c0_offset_div2); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_beta_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x53F5E9E8u, "sh->slice_beta_offset_div2", sh->slice_beta_offset_div2); }
         }
     }
     if( pps->num_slice_groups_minus1 > 0 &&
         pps->slice_group_map_type >= 3 && pps->slice_group_map_type <= 5)
     {
         int v = intlog2( pps->pic_size_in_map_units_minus1 +  pps->slice_group_change_rate_minus1 + 1 );
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_group_change_cycle = bs_read_u(b, v); printf("sh->slice_group_change_cycle: %d \n", sh->slice_group_change_cycle);  // FIXME add 2?
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_group_change_cycle = bs_read_u(b, v); h264_debug_value(_pos, _bits_left, 0x1BE65547u, "sh->slice_group_change_cycle", sh->slice_group_change_cycle); } // FIXME add 2?
     }
 }
 
@@ -3747,44 +3952,44 @@ void read_debug_ref_pic_list_reordering(h264_stream_t* h, bs_t* b)
 
     if( ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_I ) && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.ref_pic_list_reordering_flag_l0 = bs_read_u1(b); printf("sh->rplr.ref_pic_list_reordering_flag_l0: %d \n", sh->rplr.ref_pic_list_reordering_flag_l0); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.ref_pic_list_reordering_flag_l0 = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x47EDD236u, "sh->rplr.ref_pic_list_reordering_flag_l0", sh->rplr.ref_pic_list_reordering_flag_l0); }
         if( sh->rplr.ref_pic_list_reordering_flag_l0 )
         {
             int n = -1;
             do
             {
                 n++;
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ]: %d \n", sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xED33F6B0u, "sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ]", sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ]); }
                 if( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 0 ||
                     sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 1 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ]: %d \n", sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x5C366411u, "sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ]", sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ]); }
                 }
                 else if( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 2 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l0.long_term_pic_num[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l0.long_term_pic_num[ n ]: %d \n", sh->rplr.reorder_l0.long_term_pic_num[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l0.long_term_pic_num[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9650E456u, "sh->rplr.reorder_l0.long_term_pic_num[ n ]", sh->rplr.reorder_l0.long_term_pic_num[ n ]); }
                 }
             } while( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] != 3 && ! bs_eof(b) );
         }
     }
     if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.ref_pic_list_reordering_flag_l1 = bs_read_u1(b); printf("sh->rplr.ref_pic_list_reordering_flag_l1: %d \n", sh->rplr.ref_pic_list_reordering_flag_l1); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.ref_pic_list_reordering_flag_l1 = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x48EDD3C9u, "sh->rplr.ref_pic_list_reordering_flag_l1", sh->rplr.ref_pic_list_reordering_flag_l1); }
         if( sh->rplr.ref_pic_list_reordering_flag_l1 )
         {
             int n = -1;
             do
             {
                 n++;
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ]: %d \n", sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE066F36Bu, "sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ]", sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ]); }
                 if( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 0 ||
                     sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 1 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ]: %d \n", sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x350B0C90u, "sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ]", sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ]); }
                 }
                 else if( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 2 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->rplr.reorder_l1.long_term_pic_num[ n ] = bs_read_ue(b); printf("sh->rplr.reorder_l1.long_term_pic_num[ n ]: %d \n", sh->rplr.reorder_l1.long_term_pic_num[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplr.reorder_l1.long_term_pic_num[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9C8412AFu, "sh->rplr.reorder_l1.long_term_pic_num[ n ]", sh->rplr.reorder_l1.long_term_pic_num[ n ]); }
                 }
             } while( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] != 3 && ! bs_eof(b) );
         }
@@ -3800,28 +4005,28 @@ void read_debug_pred_weight_table(h264_stream_t* h, bs_t* b)
 
     int i, j;
 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_log2_weight_denom = bs_read_ue(b); printf("sh->pwt.luma_log2_weight_denom: %d \n", sh->pwt.luma_log2_weight_denom); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_log2_weight_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x48220CB5u, "sh->pwt.luma_log2_weight_denom", sh->pwt.luma_log2_weight_denom); }
     if( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_log2_weight_denom = bs_read_ue(b); printf("sh->pwt.chroma_log2_weight_denom: %d \n", sh->pwt.chroma_log2_weight_denom); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_log2_weight_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xAB2AB65Au, "sh->pwt.chroma_log2_weight_denom", sh->pwt.chroma_log2_weight_denom); }
     }
     for( i = 0; i <= pps->num_ref_idx_l0_active_minus1; i++ )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_weight_l0_flag[i] = bs_read_u1(b); printf("sh->pwt.luma_weight_l0_flag[i]: %d \n", sh->pwt.luma_weight_l0_flag[i]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l0_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBB9ABBB3u, "sh->pwt.luma_weight_l0_flag[i]", sh->pwt.luma_weight_l0_flag[i]); }
         if( sh->pwt.luma_weight_l0_flag[i] )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_weight_l0[ i ] = bs_read_se(b); printf("sh->pwt.luma_weight_l0[ i ]: %d \n", sh->pwt.luma_weight_l0[ i ]); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_offset_l0[ i ] = bs_read_se(b); printf("sh->pwt.luma_offset_l0[ i ]: %d \n", sh->pwt.luma_offset_l0[ i ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l0[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6FC119C2u, "sh->pwt.luma_weight_l0[ i ]", sh->pwt.luma_weight_l0[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_offset_l0[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x09589BA5u, "sh->pwt.luma_offset_l0[ i ]", sh->pwt.luma_offset_l0[ i ]); }
         }
         if ( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_weight_l0_flag[i] = bs_read_u1(b); printf("sh->pwt.chroma_weight_l0_flag[i]: %d \n", sh->pwt.chroma_weight_l0_flag[i]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l0_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x2DB42BDCu, "sh->pwt.chroma_weight_l0_flag[i]", sh->pwt.chroma_weight_l0_flag[i]); }
             if( sh->pwt.chroma_weight_l0_flag[i] )
             {
                 for( j =0; j < 2; j++ )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_weight_l0[ i ][ j ] = bs_read_se(b); printf("sh->pwt.chroma_weight_l0[ i ][ j ]: %d \n", sh->pwt.chroma_weight_l0[ i ][ j ]); 
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_offset_l0[ i ][ j ] = bs_read_se(b); printf("sh->pwt.chroma_offset_l0[ i ][ j ]: %d \n", sh->pwt.chroma_offset_l0[ i ][ j ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l0[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6BAE6BFDu, "sh->pwt.chroma_weight_l0[ i ][ j ]", sh->pwt.chroma_weight_l0[ i ][ j ]); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_offset_l0[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x11510600u, "sh->pwt.chroma_offset_l0[ i ][ j ]", sh->pwt.chroma_offset_l0[ i ][ j ]); }
                 }
             }
         }
@@ -3830,21 +4035,21 @@ void read_debug_pred_weight_table(h264_stream_t* h, bs_t* b)
     {
         for( i = 0; i <= pps->num_ref_idx_l1_active_minus1; i++ )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_weight_l1_flag[i] = bs_read_u1(b); printf("sh->pwt.luma_weight_l1_flag[i]: %d \n", sh->pwt.luma_weight_l1_flag[i]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l1_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9BBC4194u, "sh->pwt.luma_weight_l1_flag[i]", sh->pwt.luma_weight_l1_flag[i]); }
             if( sh->pwt.luma_weight_l1_flag[i] )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_weight_l1[ i ] = bs_read_se(b); printf("sh->pwt.luma_weight_l1[ i ]: %d \n", sh->pwt.luma_weight_l1[ i ]); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.luma_offset_l1[ i ] = bs_read_se(b); printf("sh->pwt.luma_offset_l1[ i ]: %d \n", sh->pwt.luma_offset_l1[ i ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l1[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x152B737Bu, "sh->pwt.luma_weight_l1[ i ]", sh->pwt.luma_weight_l1[ i ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_offset_l1[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6203F6ACu, "sh->pwt.luma_offset_l1[ i ]", sh->pwt.luma_offset_l1[ i ]); }
             }
             if( sps->chroma_format_idc != 0 )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_weight_l1_flag[i] = bs_read_u1(b); printf("sh->pwt.chroma_weight_l1_flag[i]: %d \n", sh->pwt.chroma_weight_l1_flag[i]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l1_flag[i] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x57D15FFBu, "sh->pwt.chroma_weight_l1_flag[i]", sh->pwt.chroma_weight_l1_flag[i]); }
                 if( sh->pwt.chroma_weight_l1_flag[i] )
                 {
                     for( j = 0; j < 2; j++ )
                     {
-                        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_weight_l1[ i ][ j ] = bs_read_se(b); printf("sh->pwt.chroma_weight_l1[ i ][ j ]: %d \n", sh->pwt.chroma_weight_l1[ i ][ j ]); 
-                        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pwt.chroma_offset_l1[ i ][ j ] = bs_read_se(b); printf("sh->pwt.chroma_offset_l1[ i ][ j ]: %d \n", sh->pwt.chroma_offset_l1[ i ][ j ]); 
+                        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l1[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD3FDA912u, "sh->pwt.chroma_weight_l1[ i ][ j ]", sh->pwt.chroma_weight_l1[ i ][ j ]); }
+                        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_offset_l1[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x9A9659EBu, "sh->pwt.chroma_offset_l1[ i ][ j ]", sh->pwt.chroma_offset_l1[ i ][ j ]); }
                     }
                 }
             }
@@ -3860,36 +4065,36 @@ void read_debug_dec_ref_pic_marking(h264_stream_t* h, bs_t* b)
 
     if( h->nal->nal_unit_type == 5 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.no_output_of_prior_pics_flag = bs_read_u1(b); printf("sh->drpm.no_output_of_prior_pics_flag: %d \n", sh->drpm.no_output_of_prior_pics_flag); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.long_term_reference_flag = bs_read_u1(b); printf("sh->drpm.long_term_reference_flag: %d \n", sh->drpm.long_term_reference_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.no_output_of_prior_pics_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7069B935u, "sh->drpm.no_output_of_prior_pics_flag", sh->drpm.no_output_of_prior_pics_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.long_term_reference_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF86F0E08u, "sh->drpm.long_term_reference_flag", sh->drpm.long_term_reference_flag); }
     }
     else
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.adaptive_ref_pic_marking_mode_flag = bs_read_u1(b); printf("sh->drpm.adaptive_ref_pic_marking_mode_flag: %d \n", sh->drpm.adaptive_ref_pic_marking_mode_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.adaptive_ref_pic_marking_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFBA0F6A4u, "sh->drpm.adaptive_ref_pic_marking_mode_flag", sh->drpm.adaptive_ref_pic_marking_mode_flag); }
         if( sh->drpm.adaptive_ref_pic_marking_mode_flag )
         {
             int n = -1;
             do
             {
                 n++;
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.memory_management_control_operation[ n ] = bs_read_ue(b); printf("sh->drpm.memory_management_control_operation[ n ]: %d \n", sh->drpm.memory_management_control_operation[ n ]); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.memory_management_control_operation[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x57967323u, "sh->drpm.memory_management_control_operation[ n ]", sh->drpm.memory_management_control_operation[ n ]); }
                 if( sh->drpm.memory_management_control_operation[ n ] == 1 ||
                     sh->drpm.memory_management_control_operation[ n ] == 3 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.difference_of_pic_nums_minus1[ n ] = bs_read_ue(b); printf("sh->drpm.difference_of_pic_nums_minus1[ n ]: %d \n", sh->drpm.difference_of_pic_nums_minus1[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.difference_of_pic_nums_minus1[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDC8B5E8Eu, "sh->drpm.difference_of_pic_nums_minus1[ n ]", sh->drpm.difference_of_pic_nums_minus1[ n ]); }
                 }
                 if(sh->drpm.memory_management_control_operation[ n ] == 2 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.long_term_pic_num[ n ] = bs_read_ue(b); printf("sh->drpm.long_term_pic_num[ n ]: %d \n", sh->drpm.long_term_pic_num[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.long_term_pic_num[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x08400521u, "sh->drpm.long_term_pic_num[ n ]", sh->drpm.long_term_pic_num[ n ]); }
                 }
                 if( sh->drpm.memory_management_control_operation[ n ] == 3 ||
                     sh->drpm.memory_management_control_operation[ n ] == 6 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.long_term_frame_idx[ n ] = bs_read_ue(b); printf("sh->drpm.long_term_frame_idx[ n ]: %d \n", sh->drpm.long_term_frame_idx[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.long_term_frame_idx[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x87270BC3u, "sh->drpm.long_term_frame_idx[ n ]", sh->drpm.long_term_frame_idx[ n ]); }
                 }
                 if( sh->drpm.memory_management_control_operation[ n ] == 4 )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->drpm.max_long_term_frame_idx_plus1[ n ] = bs_read_ue(b); printf("sh->drpm.max_long_term_frame_idx_plus1[ n ]: %d \n", sh->drpm.max_long_term_frame_idx_plus1[ n ]); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->drpm.max_long_term_frame_idx_plus1[ n ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x49A7E84Cu, "sh->drpm.max_long_term_frame_idx_plus1[ n ]", sh->drpm.max_long_term_frame_idx_plus1[ n ]); }
                 }
             } while( sh->drpm.memory_management_control_operation[ n ] != 0 && ! bs_eof(b) );
         }
@@ -3909,72 +4114,85 @@ void read_debug_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
     
     nal_t* nal = h->nal;
     
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->first_mb_in_slice = bs_read_ue(b); printf("sh->first_mb_in_slice: %d \n", sh->first_mb_in_slice); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_type = bs_read_ue(b); printf("sh->slice_type: %d \n", sh->slice_type); 
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pic_parameter_set_id = bs_read_ue(b); printf("sh->pic_parameter_set_id: %d \n", sh->pic_parameter_set_id); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->first_mb_in_slice = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x57733530u, "sh->first_mb_in_slice", sh->first_mb_in_slice); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_type = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x62D7949Au, "sh->slice_type", sh->slice_type); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pic_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x109E2164u, "sh->pic_parameter_set_id", sh->pic_parameter_set_id); }
     
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_subset_t* sps_subset = h->sps_subset;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
+    if( 1 ) { h264_activate_pps(h, sh->pic_parameter_set_id); }
+    else
+    {
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+    }
     //memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
-    memcpy(sps_subset->sps, h->sps_subset_table[pps->seq_parameter_set_id]->sps, sizeof(sps_t));
-    memcpy(sps_subset->sps_svc_ext, h->sps_subset_table[pps->seq_parameter_set_id]->sps_svc_ext, sizeof(sps_svc_ext_t));
+    sps_subset_t* sps_subset_slot = h264_sps_subset_slot(h, pps->seq_parameter_set_id);
+    if( sps_subset_slot != NULL )
+    {
+        memcpy(sps_subset->sps, sps_subset_slot->sps, sizeof(sps_t));
+        memcpy(sps_subset->sps_svc_ext, sps_subset_slot->sps_svc_ext, sizeof(sps_svc_ext_t));
+    }
     
     if (sps_subset->sps->residual_colour_transform_flag)
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->colour_plane_id = bs_read_u(b, 2); printf("sh->colour_plane_id: %d \n", sh->colour_plane_id); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->colour_plane_id = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x83597CB0u, "sh->colour_plane_id", sh->colour_plane_id); }
     }
     
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->frame_num = bs_read_u(b, sps_subset->sps->log2_max_frame_num_minus4 + 4 ); printf("sh->frame_num: %d \n", sh->frame_num);  // was u(v)
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->frame_num = bs_read_u(b, sps_subset->sps->log2_max_frame_num_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0x73571069u, "sh->frame_num", sh->frame_num); } // was u(v)
     if( !sps_subset->sps->frame_mbs_only_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->field_pic_flag = bs_read_u1(b); printf("sh->field_pic_flag: %d \n", sh->field_pic_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->field_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x54BDCFEFu, "sh->field_pic_flag", sh->field_pic_flag); }
         if( sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->bottom_field_flag = bs_read_u1(b); printf("sh->bottom_field_flag: %d \n", sh->bottom_field_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->bottom_field_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9F603184u, "sh->bottom_field_flag", sh->bottom_field_flag); }
         }
     }
     if( nal->nal_unit_type == 5 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->idr_pic_id = bs_read_ue(b); printf("sh->idr_pic_id: %d \n", sh->idr_pic_id); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->idr_pic_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x10428B47u, "sh->idr_pic_id", sh->idr_pic_id); }
     }
     if( sps_subset->sps->pic_order_cnt_type == 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->pic_order_cnt_lsb = bs_read_u(b, sps_subset->sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); printf("sh->pic_order_cnt_lsb: %d \n", sh->pic_order_cnt_lsb);  // was u(v)
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pic_order_cnt_lsb = bs_read_u(b, sps_subset->sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0x4C8264E2u, "sh->pic_order_cnt_lsb", sh->pic_order_cnt_lsb); } // was u(v)
         if( pps->pic_order_present_flag && !sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt_bottom = bs_read_se(b); printf("sh->delta_pic_order_cnt_bottom: %d \n", sh->delta_pic_order_cnt_bottom); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt_bottom = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x5A2017D1u, "sh->delta_pic_order_cnt_bottom", sh->delta_pic_order_cnt_bottom); }
         }
     }
     if( sps_subset->sps->pic_order_cnt_type == 1 && !sps_subset->sps->delta_pic_order_always_zero_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); printf("sh->delta_pic_order_cnt[ 0 ]: %d \n", sh->delta_pic_order_cnt[ 0 ]); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD2E3D88Du, "sh->delta_pic_order_cnt[ 0 ]", sh->delta_pic_order_cnt[ 0 ]); }
         if( pps->pic_order_present_flag && !sh->field_pic_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); printf("sh->delta_pic_order_cnt[ 1 ]: %d \n", sh->delta_pic_order_cnt[ 1 ]); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x7F2BD542u, "sh->delta_pic_order_cnt[ 1 ]", sh->delta_pic_order_cnt[ 1 ]); }
         }
     }
     if( pps->redundant_pic_cnt_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->redundant_pic_cnt = bs_read_ue(b); printf("sh->redundant_pic_cnt: %d \n", sh->redundant_pic_cnt); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->redundant_pic_cnt = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA4ECE2F5u, "sh->redundant_pic_cnt", sh->redundant_pic_cnt); }
     }
     if( nal->nal_svc_ext->quality_id == 0)
     {
         if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->direct_spatial_mv_pred_flag = bs_read_u1(b); printf("sh->direct_spatial_mv_pred_flag: %d \n", sh->direct_spatial_mv_pred_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->direct_spatial_mv_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9AA9FC56u, "sh->direct_spatial_mv_pred_flag", sh->direct_spatial_mv_pred_flag); }
         }
         if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EP ) ||
             is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_active_override_flag = bs_read_u1(b); printf("sh->num_ref_idx_active_override_flag: %d \n", sh->num_ref_idx_active_override_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_active_override_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF0140AA8u, "sh->num_ref_idx_active_override_flag", sh->num_ref_idx_active_override_flag); }
             if( sh->num_ref_idx_active_override_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); printf("sh->num_ref_idx_l0_active_minus1: %d \n", sh->num_ref_idx_l0_active_minus1);  // FIXME does this modify the pps?
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x4B3128BDu, "sh->num_ref_idx_l0_active_minus1", sh->num_ref_idx_l0_active_minus1); } // FIXME does this modify the pps?
                 if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); printf("sh->num_ref_idx_l1_active_minus1: %d \n", sh->num_ref_idx_l1_active_minus1); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9EAD4B6Au, "sh->num_ref_idx_l1_active_minus1", sh->num_ref_idx_l1_active_minus1); }
                 }
             }
         }
@@ -3985,7 +4203,7 @@ void read_debug_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
             //svc specific
             if( !nal->nal_svc_ext->no_inter_layer_pred_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->base_pred_weight_table_flag = bs_read_u1(b); printf("sh_svc_ext->base_pred_weight_table_flag: %d \n", sh_svc_ext->base_pred_weight_table_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->base_pred_weight_table_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9F0C489Cu, "sh_svc_ext->base_pred_weight_table_flag", sh_svc_ext->base_pred_weight_table_flag); }
             }
             if( nal->nal_svc_ext->no_inter_layer_pred_flag || !sh_svc_ext->base_pred_weight_table_flag )
             {
@@ -3999,7 +4217,7 @@ void read_debug_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
             //svc specific
             if( !sps_subset->sps_svc_ext->slice_header_restriction_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->store_ref_base_pic_flag = bs_read_u1(b); printf("sh_svc_ext->store_ref_base_pic_flag: %d \n", sh_svc_ext->store_ref_base_pic_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->store_ref_base_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xEA45E601u, "sh_svc_ext->store_ref_base_pic_flag", sh_svc_ext->store_ref_base_pic_flag); }
                 if( ( nal->nal_svc_ext->use_ref_base_pic_flag || sh_svc_ext->store_ref_base_pic_flag ) &&
                    ( nal->nal_unit_type != 5 ) )
                 {
@@ -4011,114 +4229,1771 @@ void read_debug_slice_header_in_scalable_extension(h264_stream_t* h, bs_t* b)
     
     if( pps->entropy_coding_mode_flag && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_EI ) )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->cabac_init_idc = bs_read_ue(b); printf("sh->cabac_init_idc: %d \n", sh->cabac_init_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->cabac_init_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE1633E39u, "sh->cabac_init_idc", sh->cabac_init_idc); }
     }
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_qp_delta = bs_read_se(b); printf("sh->slice_qp_delta: %d \n", sh->slice_qp_delta); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_qp_delta = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x7394F832u, "sh->slice_qp_delta", sh->slice_qp_delta); }
     if( pps->deblocking_filter_control_present_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->disable_deblocking_filter_idc = bs_read_ue(b); printf("sh->disable_deblocking_filter_idc: %d \n", sh->disable_deblocking_filter_idc); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->disable_deblocking_filter_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1B100012u, "sh->disable_deblocking_filter_idc", sh->disable_deblocking_filter_idc); }
         if( sh->disable_deblocking_filter_idc != 1 )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_alpha_c0_offset_div2 = bs_read_se(b); printf("sh->slice_alpha_c0_offset_div2: %d \n", sh->slice_alpha_c0_offset_div2); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_beta_offset_div2 = bs_read_se(b); printf("sh->slice_beta_offset_div2: %d \n", sh->slice_beta_offset_div2); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_alpha_c0_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x01BC7C6Cu, "sh->slice_alpha_c0_offset_div2", sh->slice_alpha_c0_offset_div2); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_beta_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x53F5E9E8u, "sh->slice_beta_offset_div2", sh->slice_beta_offset_div2); }
         }
     }
     if( pps->num_slice_groups_minus1 > 0 &&
        pps->slice_group_map_type >= 3 && pps->slice_group_map_type <= 5)
     {
         int v = intlog2( pps->pic_size_in_map_units_minus1 +  pps->slice_group_change_rate_minus1 + 1 );
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh->slice_group_change_cycle = bs_read_u(b, v); printf("sh->slice_group_change_cycle: %d \n", sh->slice_group_change_cycle);  // FIXME add 2?
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_group_change_cycle = bs_read_u(b, v); h264_debug_value(_pos, _bits_left, 0x1BE65547u, "sh->slice_group_change_cycle", sh->slice_group_change_cycle); } // FIXME add 2?
     }
     
     //svc specific
     if( !nal->nal_svc_ext->no_inter_layer_pred_flag && nal->nal_svc_ext->quality_id == 0 )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->ref_layer_dq_id = bs_read_ue(b); printf("sh_svc_ext->ref_layer_dq_id: %d \n", sh_svc_ext->ref_layer_dq_id); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->ref_layer_dq_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xF85AF9E9u, "sh_svc_ext->ref_layer_dq_id", sh_svc_ext->ref_layer_dq_id); }
         if( sps_subset->sps_svc_ext->inter_layer_deblocking_filter_control_present_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->disable_inter_layer_deblocking_filter_idc = bs_read_ue(b); printf("sh_svc_ext->disable_inter_layer_deblocking_filter_idc: %d \n", sh_svc_ext->disable_inter_layer_deblocking_filter_idc); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->disable_inter_layer_deblocking_filter_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x55C22032u, "sh_svc_ext->disable_inter_layer_deblocking_filter_idc", sh_svc_ext->disable_inter_layer_deblocking_filter_idc); }
             if( sh_svc_ext->disable_inter_layer_deblocking_filter_idc != 1 )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2 = bs_read_se(b); printf("sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2: %d \n", sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->inter_layer_slice_beta_offset_div2 = bs_read_se(b); printf("sh_svc_ext->inter_layer_slice_beta_offset_div2: %d \n", sh_svc_ext->inter_layer_slice_beta_offset_div2); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x5F92B8DCu, "sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2", sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->inter_layer_slice_beta_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xC658F4D8u, "sh_svc_ext->inter_layer_slice_beta_offset_div2", sh_svc_ext->inter_layer_slice_beta_offset_div2); }
             }
         }
         
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->constrained_intra_resampling_flag = bs_read_u1(b); printf("sh_svc_ext->constrained_intra_resampling_flag: %d \n", sh_svc_ext->constrained_intra_resampling_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->constrained_intra_resampling_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB99327ABu, "sh_svc_ext->constrained_intra_resampling_flag", sh_svc_ext->constrained_intra_resampling_flag); }
         if( sps_subset->sps_svc_ext->extended_spatial_scalability_idc == 2 )
         {
             if( sps_subset->sps->chroma_format_idc > 0 )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); printf("sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag: %d \n", sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag); 
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); printf("sh_svc_ext->ref_layer_chroma_phase_y_plus1: %d \n", sh_svc_ext->ref_layer_chroma_phase_y_plus1); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6B8FCFA4u, "sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag", sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xA0FA5596u, "sh_svc_ext->ref_layer_chroma_phase_y_plus1", sh_svc_ext->ref_layer_chroma_phase_y_plus1); }
             }
             
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scaled_ref_layer_left_offset = bs_read_se(b); printf("sh_svc_ext->scaled_ref_layer_left_offset: %d \n", sh_svc_ext->scaled_ref_layer_left_offset); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scaled_ref_layer_top_offset = bs_read_se(b); printf("sh_svc_ext->scaled_ref_layer_top_offset: %d \n", sh_svc_ext->scaled_ref_layer_top_offset); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scaled_ref_layer_right_offset = bs_read_se(b); printf("sh_svc_ext->scaled_ref_layer_right_offset: %d \n", sh_svc_ext->scaled_ref_layer_right_offset); 
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scaled_ref_layer_bottom_offset = bs_read_se(b); printf("sh_svc_ext->scaled_ref_layer_bottom_offset: %d \n", sh_svc_ext->scaled_ref_layer_bottom_offset); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scaled_ref_layer_left_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x4E7D0354u, "sh_svc_ext->scaled_ref_layer_left_offset", sh_svc_ext->scaled_ref_layer_left_offset); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scaled_ref_layer_top_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6DBE23B4u, "sh_svc_ext->scaled_ref_layer_top_offset", sh_svc_ext->scaled_ref_layer_top_offset); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scaled_ref_layer_right_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x2212DB2Bu, "sh_svc_ext->scaled_ref_layer_right_offset", sh_svc_ext->scaled_ref_layer_right_offset); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scaled_ref_layer_bottom_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xAE3B80C6u, "sh_svc_ext->scaled_ref_layer_bottom_offset", sh_svc_ext->scaled_ref_layer_bottom_offset); }
         }
     }
     
     if( !nal->nal_svc_ext->no_inter_layer_pred_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->slice_skip_flag = bs_read_u1(b); printf("sh_svc_ext->slice_skip_flag: %d \n", sh_svc_ext->slice_skip_flag); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->slice_skip_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1FEB35CBu, "sh_svc_ext->slice_skip_flag", sh_svc_ext->slice_skip_flag); }
         if( sh_svc_ext->slice_skip_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->num_mbs_in_slice_minus1 = bs_read_ue(b); printf("sh_svc_ext->num_mbs_in_slice_minus1: %d \n", sh_svc_ext->num_mbs_in_slice_minus1); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->num_mbs_in_slice_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDBF3C85Cu, "sh_svc_ext->num_mbs_in_slice_minus1", sh_svc_ext->num_mbs_in_slice_minus1); }
         }
         else
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->adaptive_base_mode_flag = bs_read_u1(b); printf("sh_svc_ext->adaptive_base_mode_flag: %d \n", sh_svc_ext->adaptive_base_mode_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->adaptive_base_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x56B25B43u, "sh_svc_ext->adaptive_base_mode_flag", sh_svc_ext->adaptive_base_mode_flag); }
             if( !sh_svc_ext->adaptive_base_mode_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->default_base_mode_flag = bs_read_u1(b); printf("sh_svc_ext->default_base_mode_flag: %d \n", sh_svc_ext->default_base_mode_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->default_base_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF5A59E9Au, "sh_svc_ext->default_base_mode_flag", sh_svc_ext->default_base_mode_flag); }
             }
             if( !sh_svc_ext->default_base_mode_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->adaptive_motion_prediction_flag = bs_read_u1(b); printf("sh_svc_ext->adaptive_motion_prediction_flag: %d \n", sh_svc_ext->adaptive_motion_prediction_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->adaptive_motion_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD19E0E8Au, "sh_svc_ext->adaptive_motion_prediction_flag", sh_svc_ext->adaptive_motion_prediction_flag); }
                 if( !sh_svc_ext->adaptive_motion_prediction_flag )
                 {
-                    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->default_motion_prediction_flag = bs_read_u1(b); printf("sh_svc_ext->default_motion_prediction_flag: %d \n", sh_svc_ext->default_motion_prediction_flag); 
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->default_motion_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x52DE28DFu, "sh_svc_ext->default_motion_prediction_flag", sh_svc_ext->default_motion_prediction_flag); }
                 }
             }
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->adaptive_residual_prediction_flag = bs_read_u1(b); printf("sh_svc_ext->adaptive_residual_prediction_flag: %d \n", sh_svc_ext->adaptive_residual_prediction_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->adaptive_residual_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBB298F87u, "sh_svc_ext->adaptive_residual_prediction_flag", sh_svc_ext->adaptive_residual_prediction_flag); }
             if( !sh_svc_ext->adaptive_residual_prediction_flag )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->default_residual_prediction_flag = bs_read_u1(b); printf("sh_svc_ext->default_residual_prediction_flag: %d \n", sh_svc_ext->default_residual_prediction_flag); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->default_residual_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x46866F7Eu, "sh_svc_ext->default_residual_prediction_flag", sh_svc_ext->default_residual_prediction_flag); }
             }
         }
         if( sps_subset->sps_svc_ext->adaptive_tcoeff_level_prediction_flag )
         {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->tcoeff_level_prediction_flag = bs_read_u1(b); printf("sh_svc_ext->tcoeff_level_prediction_flag: %d \n", sh_svc_ext->tcoeff_level_prediction_flag); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->tcoeff_level_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE7785C33u, "sh_svc_ext->tcoeff_level_prediction_flag", sh_svc_ext->tcoeff_level_prediction_flag); }
         }
     }
     
     if( !sps_subset->sps_svc_ext->slice_header_restriction_flag && !sh_svc_ext->slice_skip_flag )
     {
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scan_idx_start = bs_read_u(b, 4); printf("sh_svc_ext->scan_idx_start: %d \n", sh_svc_ext->scan_idx_start); 
-        printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); sh_svc_ext->scan_idx_end = bs_read_u(b, 4); printf("sh_svc_ext->scan_idx_end: %d \n", sh_svc_ext->scan_idx_end); 
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scan_idx_start = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x0F2B2D86u, "sh_svc_ext->scan_idx_start", sh_svc_ext->scan_idx_start); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh_svc_ext->scan_idx_end = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x994A21E3u, "sh_svc_ext->scan_idx_end", sh_svc_ext->scan_idx_end); }
     }
 }
 
 //G.7.3.3.5 Decoded reference base picture marking syntax
 void read_debug_dec_ref_base_pic_marking(nal_t* nal, bs_t* b)
 {
-    printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag = bs_read_u1(b); printf("nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag: %d \n", nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag); 
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x15981CD1u, "nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag", nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag); }
     if( nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag )
     {
         do {
-            printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->memory_management_base_control_operation = bs_read_ue(b); printf("nal->prefix_nal_svc->memory_management_base_control_operation: %d \n", nal->prefix_nal_svc->memory_management_base_control_operation); 
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->memory_management_base_control_operation = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x65A17330u, "nal->prefix_nal_svc->memory_management_base_control_operation", nal->prefix_nal_svc->memory_management_base_control_operation); }
             
             if( nal->prefix_nal_svc->memory_management_base_control_operation == 1 )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->difference_of_base_pic_nums_minus1 = bs_read_ue(b); printf("nal->prefix_nal_svc->difference_of_base_pic_nums_minus1: %d \n", nal->prefix_nal_svc->difference_of_base_pic_nums_minus1); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->difference_of_base_pic_nums_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8DB0053Bu, "nal->prefix_nal_svc->difference_of_base_pic_nums_minus1", nal->prefix_nal_svc->difference_of_base_pic_nums_minus1); }
             }
             if( nal->prefix_nal_svc->memory_management_base_control_operation == 2 )
             {
-                printf("%ld.%d: ", (long int)(b->p - b->start), b->bits_left); nal->prefix_nal_svc->long_term_base_pic_num = bs_read_ue(b); printf("nal->prefix_nal_svc->long_term_base_pic_num: %d \n", nal->prefix_nal_svc->long_term_base_pic_num); 
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->prefix_nal_svc->long_term_base_pic_num = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1127AF6Au, "nal->prefix_nal_svc->long_term_base_pic_num", nal->prefix_nal_svc->long_term_base_pic_num); }
             }
         } while( nal->prefix_nal_svc->memory_management_base_control_operation != 0 );
     }
 }
 
+
+
+void skip_nal_unit_header_svc_extension(nal_svc_ext_t* nal_svc_ext, int extract, bs_t* b);
+void skip_prefix_nal_unit_svc(nal_t* nal, int extract, bs_t* b);
+void skip_prefix_nal_unit_rbsp(nal_t* nal, int extract, bs_t* b);
+void skip_seq_parameter_set_rbsp(sps_t* sps, int extract, bs_t* b);
+void skip_scaling_list(bs_t* b, int extract, int* scalingList, int sizeOfScalingList, int* useDefaultScalingMatrixFlag );
+void skip_subset_seq_parameter_set_rbsp(sps_subset_t* sps_subset, int extract, bs_t* b);
+void skip_seq_parameter_set_svc_extension(sps_subset_t* sps_subset, int extract, bs_t* b);
+void skip_svc_vui_parameters_extension(sps_svc_ext_t* sps_svc_ext, int extract, bs_t* b);
+void skip_vui_parameters(sps_t* sps, int extract, bs_t* b);
+void skip_hrd_parameters(hrd_t* hrd, int extract, bs_t* b);
+void skip_pic_parameter_set_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_sei_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_sei_message(h264_stream_t* h, int extract, bs_t* b);
+void skip_access_unit_delimiter_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_end_of_seq_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_end_of_stream_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_filler_data_rbsp(h264_stream_t* h, int extract, bs_t* b);
+void skip_slice_layer_rbsp(h264_stream_t* h, int extract,  bs_t* b);
+void skip_rbsp_slice_trailing_bits(h264_stream_t* h, int extract, bs_t* b);
+void skip_rbsp_trailing_bits(bs_t* b, int extract);
+void skip_slice_header(h264_stream_t* h, int extract, bs_t* b);
+void skip_ref_pic_list_reordering(h264_stream_t* h, int extract, bs_t* b);
+void skip_pred_weight_table(h264_stream_t* h, int extract, bs_t* b);
+void skip_dec_ref_pic_marking(h264_stream_t* h, int extract, bs_t* b);
+void skip_slice_header_in_scalable_extension(h264_stream_t* h, int extract, bs_t* b);
+void skip_dec_ref_base_pic_marking(nal_t* nal, int extract, bs_t* b);
+
+
+
+
+//7.3.1 NAL unit syntax
+int skip_nal_unit(h264_stream_t* h, int extract, uint8_t* buf, int size)
+{
+    nal_t* nal = h->nal;
+
+    int nal_size = size;
+    int rbsp_size = size;
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
+
+    if( 1 )
+    {
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
+    }
+
+    if( 0 )
+    {
+        rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
+    }
+
+    /* forbidden_zero_bit */ bs_skip_u(b, 1);
+    nal->nal_ref_idc = bs_read_u(b, 2);
+    nal->nal_unit_type = bs_read_u(b, 5);
+    
+    if( nal->nal_unit_type == 14 || nal->nal_unit_type == 21 || nal->nal_unit_type == 20 )
+    {
+        if( nal->nal_unit_type != 21 )
+        {
+            nal->svc_extension_flag = bs_read_u1(b);
+        }
+        else
+        {
+            nal->avc_3d_extension_flag = bs_read_u1(b);
+        }
+        
+        if( nal->svc_extension_flag )
+        {
+            skip_nal_unit_header_svc_extension(nal->nal_svc_ext, extract, b);
+        }
+    }
+
+    if( 1 && h->parse_depth < H264_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
+    switch ( nal->nal_unit_type )
+    {
+        case NAL_UNIT_TYPE_CODED_SLICE_IDR:
+        case NAL_UNIT_TYPE_CODED_SLICE_NON_IDR:  
+        case NAL_UNIT_TYPE_CODED_SLICE_AUX:
+            skip_slice_layer_rbsp(h, extract, b);
+            break;
+
+#ifdef HAVE_SEI
+        case NAL_UNIT_TYPE_SEI:
+            skip_sei_rbsp(h, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            break;
+#endif
+
+        case NAL_UNIT_TYPE_SPS: 
+            if( 1 && !0 && h264_sps_resent(h, b, buf, nal_size, extract) ) { break; }
+
+            skip_seq_parameter_set_rbsp(h->sps, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            
+            if( 1 )
+            {
+                int id = h->sps->seq_parameter_set_id;
+                sps_t* slot = h264_sps_slot(h, id);
+                if( slot == NULL ) { h->sps_hash = 0; return -1; }
+                memcpy(slot, h->sps, sizeof(sps_t));
+                h->sps_hash = h264_ps_hash(buf, nal_size, extract);
+                h->sps_table_hash[id] = h->sps_hash;
+            }
+
+            break;
+
+        case NAL_UNIT_TYPE_PPS:   
+            if( 1 && !0 && h264_pps_resent(h, b, buf, nal_size, extract) ) { break; }
+
+            skip_pic_parameter_set_rbsp(h, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+
+            if( 1 )
+            {
+                // pic_parameter_set_rbsp has stored it, unless the id is out of range
+                int id = h->pps->pic_parameter_set_id;
+                if( h264_pps_slot(h, id) == NULL ) { h->pps_hash = 0; return -1; }
+                h->pps_hash = h264_ps_hash(buf, nal_size, extract);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
+            break;
+
+        case NAL_UNIT_TYPE_AUD:     
+            skip_access_unit_delimiter_rbsp(h, extract, b); 
+            skip_rbsp_trailing_bits(b, extract);
+            break;
+
+        case NAL_UNIT_TYPE_END_OF_SEQUENCE: 
+            skip_end_of_seq_rbsp(h, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            break;
+
+        case NAL_UNIT_TYPE_END_OF_STREAM: 
+            skip_end_of_stream_rbsp(h, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            break;
+
+        //SVC support
+        case NAL_UNIT_TYPE_SUBSET_SPS:
+            skip_subset_seq_parameter_set_rbsp(h->sps_subset, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            
+            if( 1 )
+            {
+                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
+                sps_subset_t* sps_subset = h264_sps_subset_slot(h, h->sps_subset->sps->seq_parameter_set_id);
+                if( sps_subset == NULL ) { return -1; }
+                memcpy(sps_subset->sps, h->sps_subset->sps, sizeof(sps_t));
+                memcpy(sps_subset->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+                sps_subset->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
+            }
+
+            break;
+            
+        //prefix NAL
+        case NAL_UNIT_TYPE_PREFIX_NAL:
+            skip_prefix_nal_unit_rbsp(h->nal, extract, b);
+            skip_rbsp_trailing_bits(b, extract);
+            break;
+            
+        //SVC support
+        case NAL_UNIT_TYPE_CODED_SLICE_SVC_EXTENSION:            
+            skip_slice_layer_rbsp(h, extract, b);
+            
+            break;
+            
+        case NAL_UNIT_TYPE_FILLER:
+        case NAL_UNIT_TYPE_SPS_EXT:
+        case NAL_UNIT_TYPE_UNSPECIFIED:
+        case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_A:  
+        case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_B: 
+        case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_C:
+        default:
+            free(rbsp_buf);
+            return -1;
+    }
+
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
+
+    if( 0 )
+    {
+        // now get the actual size used
+        rbsp_size = bs_pos(b);
+
+        int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
+        if (rc < 0) { free(rbsp_buf); return -1; }
+    }
+
+    free(rbsp_buf);
+
+    return nal_size;
+}
+
+//G.7.3.1.1 NAL unit header SVC extension syntax
+void skip_nal_unit_header_svc_extension(nal_svc_ext_t* nal_svc_ext, int extract, bs_t* b)
+{
+    nal_svc_ext->idr_flag = bs_read_u1(b);
+    nal_svc_ext->priority_id = bs_read_u(b, 6);
+    nal_svc_ext->no_inter_layer_pred_flag = bs_read_u1(b);
+    nal_svc_ext->dependency_id = bs_read_u(b, 3);
+    nal_svc_ext->quality_id = bs_read_u(b, 4);
+    nal_svc_ext->temporal_id = bs_read_u(b, 3);
+    nal_svc_ext->use_ref_base_pic_flag = bs_read_u1(b);
+    nal_svc_ext->discardable_flag = bs_read_u1(b);
+    nal_svc_ext->output_flag = bs_read_u1(b);
+    nal_svc_ext->reserved_three_2bits = bs_read_u(b, 2);
+}
+
+//G.7.3.2.12.1 Prefix NAL unit SVC syntax
+void skip_prefix_nal_unit_svc(nal_t* nal, int extract, bs_t* b)
+{
+    if( nal->nal_ref_idc != 0 )
+    {
+        nal->prefix_nal_svc->store_ref_base_pic_flag = bs_read_u1(b);
+        if( ( nal->nal_svc_ext->use_ref_base_pic_flag || nal->prefix_nal_svc->store_ref_base_pic_flag ) &&
+             !nal->nal_svc_ext->idr_flag )
+        {
+            skip_dec_ref_base_pic_marking(nal, extract, b );
+        }
+        nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag = bs_read_u1(b);
+        if( nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag )
+        {
+            while( more_rbsp_data( b ) )
+            {
+                nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b);
+            }
+        }
+    }
+    else if( more_rbsp_data( b ) )
+    {
+        while( more_rbsp_data( b ) )
+        {
+            nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag = bs_read_u1(b);
+        }
+    }
+}
+
+//7.3.2.12 Prefix NAL unit RBSP syntax
+void skip_prefix_nal_unit_rbsp(nal_t* nal, int extract, bs_t* b)
+{
+    if( nal->svc_extension_flag )
+    {
+        skip_prefix_nal_unit_svc(nal, extract, b);
+    }
+}
+
+//7.3.2.1 Sequence parameter set RBSP syntax
+void skip_seq_parameter_set_rbsp(sps_t* sps, int extract, bs_t* b)
+{
+    int i;
+
+    if( 1 )
+    {
+        memset(sps, 0, sizeof(sps_t));
+        sps->chroma_format_idc = 1; 
+    }
+ 
+    sps->profile_idc = bs_read_u8(b);
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set0_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set1_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set2_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set3_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set4_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->constraint_set5_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    /* reserved_zero_2bits */ bs_skip_u(b, 2);
+    if (extract & H264_EXTRACT_SPS) { sps->level_idc = bs_read_u8(b); } else { bs_skip_u(b, 8); }
+    sps->seq_parameter_set_id = bs_read_ue(b);
+
+    if( sps->profile_idc == 100 || sps->profile_idc == 110 ||
+        sps->profile_idc == 122 || sps->profile_idc == 244 ||
+        sps->profile_idc == 44 || sps->profile_idc == 83 ||
+        sps->profile_idc == 86 || sps->profile_idc == 118 ||
+        sps->profile_idc == 128 || sps->profile_idc == 138 ||
+        sps->profile_idc == 139 || sps->profile_idc == 134
+       )
+    {
+        sps->chroma_format_idc = bs_read_ue(b);
+        if( sps->chroma_format_idc == 3 )
+        {
+            sps->residual_colour_transform_flag = bs_read_u1(b);
+        }
+        if (extract & H264_EXTRACT_SPS) { sps->bit_depth_luma_minus8 = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->bit_depth_chroma_minus8 = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->qpprime_y_zero_transform_bypass_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        sps->seq_scaling_matrix_present_flag = bs_read_u1(b);
+        if( sps->seq_scaling_matrix_present_flag )
+        {
+            for( i = 0; i < ((sps->chroma_format_idc != 3) ? 8 : 12); i++ )
+            {
+                sps->seq_scaling_list_present_flag[ i ] = bs_read_u1(b);
+                if( sps->seq_scaling_list_present_flag[ i ] )
+                {
+                    if( i < 6 )
+                    {
+                        skip_scaling_list(b, extract, sps->ScalingList4x4[ i ], 16,
+                                                 &( sps->UseDefaultScalingMatrix4x4Flag[ i ] ) );
+                    }
+                    else
+                    {
+                        skip_scaling_list(b, extract, sps->ScalingList8x8[ i - 6 ], 64,
+                                                 &( sps->UseDefaultScalingMatrix8x8Flag[ i - 6 ] ) );
+                    }
+                }
+            }
+        }
+    }
+    sps->log2_max_frame_num_minus4 = bs_read_ue(b);
+    sps->pic_order_cnt_type = bs_read_ue(b);
+    if( sps->pic_order_cnt_type == 0 )
+    {
+        sps->log2_max_pic_order_cnt_lsb_minus4 = bs_read_ue(b);
+    }
+    else if( sps->pic_order_cnt_type == 1 )
+    {
+        sps->delta_pic_order_always_zero_flag = bs_read_u1(b);
+        if (extract & H264_EXTRACT_SPS) { sps->offset_for_non_ref_pic = bs_read_se(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->offset_for_top_to_bottom_field = bs_read_se(b); } else { bs_skip_ue(b); }
+        sps->num_ref_frames_in_pic_order_cnt_cycle = bs_read_ue(b);
+        for( i = 0; i < sps->num_ref_frames_in_pic_order_cnt_cycle; i++ )
+        {
+            if (extract & H264_EXTRACT_SPS) { sps->offset_for_ref_frame[ i ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if (extract & H264_EXTRACT_SPS) { sps->num_ref_frames = bs_read_ue(b); } else { bs_skip_ue(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->gaps_in_frame_num_value_allowed_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->pic_width_in_mbs_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+    if (extract & H264_EXTRACT_SPS) { sps->pic_height_in_map_units_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+    sps->frame_mbs_only_flag = bs_read_u1(b);
+    if( !sps->frame_mbs_only_flag )
+    {
+        if (extract & H264_EXTRACT_SPS) { sps->mb_adaptive_frame_field_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    if (extract & H264_EXTRACT_SPS) { sps->direct_8x8_inference_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    sps->frame_cropping_flag = bs_read_u1(b);
+    if( sps->frame_cropping_flag )
+    {
+        if (extract & H264_EXTRACT_SPS) { sps->frame_crop_left_offset = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->frame_crop_right_offset = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->frame_crop_top_offset = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps->frame_crop_bottom_offset = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    sps->vui_parameters_present_flag = bs_read_u1(b);
+    if( sps->vui_parameters_present_flag )
+    {
+        skip_vui_parameters(sps, extract, b);
+    }
+}
+
+//7.3.2.1.1 Scaling list syntax
+void skip_scaling_list(bs_t* b, int extract, int* scalingList, int sizeOfScalingList, int* useDefaultScalingMatrixFlag )
+{
+    // NOTE need to be able to set useDefaultScalingMatrixFlag when reading, hence passing as pointer
+    int lastScale = 8;
+    int nextScale = 8;
+    int delta_scale;
+    for( int j = 0; j < sizeOfScalingList; j++ )
+    {
+        if( nextScale != 0 )
+        {
+            if( 0 )
+            {
+                nextScale = scalingList[ j ];
+                if (useDefaultScalingMatrixFlag[0]) { nextScale = 0; }
+                delta_scale = (nextScale - lastScale) % 256 ;
+            }
+
+            delta_scale = bs_read_se(b);
+
+            if( 1 )
+            {
+                nextScale = ( lastScale + delta_scale + 256 ) % 256;
+                useDefaultScalingMatrixFlag[0] = ( j == 0 && nextScale == 0 );
+            }
+        }
+        if( 1 )
+        {
+            scalingList[ j ] = ( nextScale == 0 ) ? lastScale : nextScale;
+        }
+        lastScale = scalingList[ j ];
+    }
+}
+
+//7.3.2.1.3 Subset sequence parameter set RBSP syntax
+void skip_subset_seq_parameter_set_rbsp(sps_subset_t* sps_subset, int extract, bs_t* b)
+{
+    skip_seq_parameter_set_rbsp(sps_subset->sps, extract, b);
+    
+    switch( sps_subset->sps->profile_idc )
+    {
+        case 83:
+        case 86:
+            skip_seq_parameter_set_svc_extension(sps_subset, extract, b); /* specified in Annex G */
+            
+            sps_svc_ext_t* sps_svc_ext = sps_subset->sps_svc_ext;
+            sps_svc_ext->svc_vui_parameters_present_flag = bs_read_u1(b);
+            
+            if( sps_svc_ext->svc_vui_parameters_present_flag )
+            {
+                skip_svc_vui_parameters_extension(sps_svc_ext, extract,b); /* specified in Annex G */
+            }
+            break;
+        default:
+            break;
+    }
+    sps_subset->additional_extension2_flag = bs_read_u1(b);
+    if( sps_subset->additional_extension2_flag )
+    {
+        while( more_rbsp_data( b ) )
+        {
+            sps_subset->additional_extension2_flag = bs_read_u1(b);
+        }
+    }
+    
+}
+
+//Appendix G.7.3.2.1.4 Sequence parameter set SVC extension syntax
+void skip_seq_parameter_set_svc_extension(sps_subset_t* sps_subset, int extract, bs_t* b)
+{
+    sps_svc_ext_t* sps_svc_ext = sps_subset->sps_svc_ext;
+    sps_svc_ext->inter_layer_deblocking_filter_control_present_flag = bs_read_u1(b);
+    sps_svc_ext->extended_spatial_scalability_idc = bs_read_u(b, 2);
+    if( sps_subset->sps->chroma_format_idc == 1 || sps_subset->sps->chroma_format_idc == 2 )
+    {
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->chroma_phase_x_plus1_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    if( sps_subset->sps->chroma_format_idc == 1 )
+    {
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->chroma_phase_y_plus1 = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+    }
+    if( sps_svc_ext->extended_spatial_scalability_idc )
+    {
+        if( sps_subset->sps->chroma_format_idc > 0 )
+        {
+            if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+            if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+        }
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_scaled_ref_layer_left_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_scaled_ref_layer_top_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_scaled_ref_layer_right_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_SPS) { sps_svc_ext->seq_scaled_ref_layer_bottom_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+    }
+    sps_svc_ext->seq_tcoeff_level_prediction_flag = bs_read_u1(b);
+    if( sps_svc_ext->seq_tcoeff_level_prediction_flag )
+    {
+        sps_svc_ext->adaptive_tcoeff_level_prediction_flag = bs_read_u1(b);
+    }
+    sps_svc_ext->slice_header_restriction_flag = bs_read_u1(b);
+}
+
+//Appendix G.14.1 SVC VUI parameters extension syntax
+void skip_svc_vui_parameters_extension(sps_svc_ext_t* sps_svc_ext, int extract, bs_t* b)
+{
+    sps_svc_ext->vui.vui_ext_num_entries_minus1 = bs_read_ue(b);
+    for( int i = 0; i <= sps_svc_ext->vui.vui_ext_num_entries_minus1; i++ )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_dependency_id[i] = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+        if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_quality_id[i] = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+        if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_temporal_id[i] = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+        sps_svc_ext->vui.vui_ext_timing_info_present_flag[i] = bs_read_u1(b);
+        if( sps_svc_ext->vui.vui_ext_timing_info_present_flag[i] )
+        {
+            if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_num_units_in_tick[i] = bs_read_u(b, 32); } else { bs_skip_u(b, 32); }
+            if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_time_scale[i] = bs_read_u(b, 32); } else { bs_skip_u(b, 32); }
+            if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i] = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+
+        sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] = bs_read_u1(b);
+        if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] )
+        {
+            skip_hrd_parameters(&sps_svc_ext->hrd_vcl[i], extract, b);
+        }
+        sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] = bs_read_u1(b);
+        if( sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] )
+        {
+            skip_hrd_parameters(&sps_svc_ext->hrd_nal[i], extract, b);
+        }
+        
+        if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] ||
+            sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] )
+        {
+            if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i] = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+        if (extract & H264_EXTRACT_VUI) { sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i] = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+}
+
+//Appendix E.1.1 VUI parameters syntax
+void skip_vui_parameters(sps_t* sps, int extract, bs_t* b)
+{
+    sps->vui.aspect_ratio_info_present_flag = bs_read_u1(b);
+    if( sps->vui.aspect_ratio_info_present_flag )
+    {
+        sps->vui.aspect_ratio_idc = bs_read_u8(b);
+        if( sps->vui.aspect_ratio_idc == SAR_Extended )
+        {
+            if (extract & H264_EXTRACT_VUI) { sps->vui.sar_width = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+            if (extract & H264_EXTRACT_VUI) { sps->vui.sar_height = bs_read_u(b, 16); } else { bs_skip_u(b, 16); }
+        }
+    }
+    sps->vui.overscan_info_present_flag = bs_read_u1(b);
+    if( sps->vui.overscan_info_present_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.overscan_appropriate_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    sps->vui.video_signal_type_present_flag = bs_read_u1(b);
+    if( sps->vui.video_signal_type_present_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.video_format = bs_read_u(b, 3); } else { bs_skip_u(b, 3); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.video_full_range_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        sps->vui.colour_description_present_flag = bs_read_u1(b);
+        if( sps->vui.colour_description_present_flag )
+        {
+            if (extract & H264_EXTRACT_VUI) { sps->vui.colour_primaries = bs_read_u8(b); } else { bs_skip_u(b, 8); }
+            if (extract & H264_EXTRACT_VUI) { sps->vui.transfer_characteristics = bs_read_u8(b); } else { bs_skip_u(b, 8); }
+            if (extract & H264_EXTRACT_VUI) { sps->vui.matrix_coefficients = bs_read_u8(b); } else { bs_skip_u(b, 8); }
+        }
+    }
+    sps->vui.chroma_loc_info_present_flag = bs_read_u1(b);
+    if( sps->vui.chroma_loc_info_present_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.chroma_sample_loc_type_top_field = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.chroma_sample_loc_type_bottom_field = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    sps->vui.timing_info_present_flag = bs_read_u1(b);
+    if( sps->vui.timing_info_present_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.num_units_in_tick = bs_read_u(b, 32); } else { bs_skip_u(b, 32); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.time_scale = bs_read_u(b, 32); } else { bs_skip_u(b, 32); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.fixed_frame_rate_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    sps->vui.nal_hrd_parameters_present_flag = bs_read_u1(b);
+    if( sps->vui.nal_hrd_parameters_present_flag )
+    {
+        skip_hrd_parameters(&sps->hrd_nal, extract, b);
+    }
+    sps->vui.vcl_hrd_parameters_present_flag = bs_read_u1(b);
+    if( sps->vui.vcl_hrd_parameters_present_flag )
+    {
+        skip_hrd_parameters(&sps->hrd_vcl, extract, b);
+    }
+    if( sps->vui.nal_hrd_parameters_present_flag || sps->vui.vcl_hrd_parameters_present_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.low_delay_hrd_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    if (extract & H264_EXTRACT_VUI) { sps->vui.pic_struct_present_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    sps->vui.bitstream_restriction_flag = bs_read_u1(b);
+    if( sps->vui.bitstream_restriction_flag )
+    {
+        if (extract & H264_EXTRACT_VUI) { sps->vui.motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.max_bytes_per_pic_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.max_bits_per_mb_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.log2_max_mv_length_horizontal = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.log2_max_mv_length_vertical = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.num_reorder_frames = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { sps->vui.max_dec_frame_buffering = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+}
+
+
+//Appendix E.1.2 HRD parameters syntax
+void skip_hrd_parameters(hrd_t* hrd, int extract, bs_t* b)
+{
+    hrd->cpb_cnt_minus1 = bs_read_ue(b);
+    if (extract & H264_EXTRACT_VUI) { hrd->bit_rate_scale = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+    if (extract & H264_EXTRACT_VUI) { hrd->cpb_size_scale = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+    for( int SchedSelIdx = 0; SchedSelIdx <= hrd->cpb_cnt_minus1; SchedSelIdx++ )
+    {
+        if (extract & H264_EXTRACT_VUI) { hrd->bit_rate_value_minus1[ SchedSelIdx ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { hrd->cpb_size_value_minus1[ SchedSelIdx ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if (extract & H264_EXTRACT_VUI) { hrd->cbr_flag[ SchedSelIdx ] = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    if (extract & H264_EXTRACT_VUI) { hrd->initial_cpb_removal_delay_length_minus1 = bs_read_u(b, 5); } else { bs_skip_u(b, 5); }
+    if (extract & H264_EXTRACT_VUI) { hrd->cpb_removal_delay_length_minus1 = bs_read_u(b, 5); } else { bs_skip_u(b, 5); }
+    if (extract & H264_EXTRACT_VUI) { hrd->dpb_output_delay_length_minus1 = bs_read_u(b, 5); } else { bs_skip_u(b, 5); }
+    if (extract & H264_EXTRACT_VUI) { hrd->time_offset_length = bs_read_u(b, 5); } else { bs_skip_u(b, 5); }
+}
+
+
+/*
+UNIMPLEMENTED
+//7.3.2.1.2 Sequence parameter set extension RBSP syntax
+int skip_seq_parameter_set_extension_rbsp(bs_t* b, int extract, sps_ext_t* sps_ext) {
+    seq_parameter_set_id = bs_read_ue(b);
+    aux_format_idc = bs_read_ue(b);
+    if( aux_format_idc != 0 ) {
+        bit_depth_aux_minus8 = bs_read_ue(b);
+        alpha_incr_flag = bs_read_u1(b);
+        alpha_opaque_value = bs_skip_u(v, extract);
+        alpha_transparent_value = bs_skip_u(v, extract);
+    }
+    additional_extension_flag = bs_read_u1(b);
+    skip_rbsp_trailing_bits(, extract);
+}
+*/
+
+//7.3.2.2 Picture parameter set RBSP syntax
+void skip_pic_parameter_set_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+    pps_t* pps = h->pps;
+    if( 1 )
+    {
+        memset(pps, 0, sizeof(pps_t));
+    }
+
+    pps->pic_parameter_set_id = bs_read_ue(b);
+    pps->seq_parameter_set_id = bs_read_ue(b);
+    pps->entropy_coding_mode_flag = bs_read_u1(b);
+    pps->pic_order_present_flag = bs_read_u1(b);
+    pps->num_slice_groups_minus1 = bs_read_ue(b);
+
+    if( pps->num_slice_groups_minus1 > 0 )
+    {
+        pps->slice_group_map_type = bs_read_ue(b);
+        if( pps->slice_group_map_type == 0 )
+        {
+            for( int i_group = 0; i_group <= pps->num_slice_groups_minus1; i_group++ )
+            {
+                if (extract & H264_EXTRACT_PPS) { pps->run_length_minus1[ i_group ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        }
+        else if( pps->slice_group_map_type == 2 )
+        {
+            for( int i_group = 0; i_group < pps->num_slice_groups_minus1; i_group++ )
+            {
+                if (extract & H264_EXTRACT_PPS) { pps->top_left[ i_group ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                if (extract & H264_EXTRACT_PPS) { pps->bottom_right[ i_group ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        }
+        else if( pps->slice_group_map_type == 3 ||
+                 pps->slice_group_map_type == 4 ||
+                 pps->slice_group_map_type == 5 )
+        {
+            if (extract & H264_EXTRACT_PPS) { pps->slice_group_change_direction_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+            pps->slice_group_change_rate_minus1 = bs_read_ue(b);
+        }
+        else if( pps->slice_group_map_type == 6 )
+        {
+            pps->pic_size_in_map_units_minus1 = bs_read_ue(b);
+            for( int i = 0; i <= pps->pic_size_in_map_units_minus1; i++ )
+            {
+                int v = intlog2( pps->num_slice_groups_minus1 + 1 );
+                if (extract & H264_EXTRACT_PPS) { pps->slice_group_id[ i ] = bs_read_u(b, v); } else { bs_skip_u(b, v); }
+            }
+        }
+    }
+    pps->num_ref_idx_l0_active_minus1 = bs_read_ue(b);
+    pps->num_ref_idx_l1_active_minus1 = bs_read_ue(b);
+    pps->weighted_pred_flag = bs_read_u1(b);
+    pps->weighted_bipred_idc = bs_read_u(b, 2);
+    if (extract & H264_EXTRACT_PPS) { pps->pic_init_qp_minus26 = bs_read_se(b); } else { bs_skip_ue(b); }
+    if (extract & H264_EXTRACT_PPS) { pps->pic_init_qs_minus26 = bs_read_se(b); } else { bs_skip_ue(b); }
+    if (extract & H264_EXTRACT_PPS) { pps->chroma_qp_index_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+    pps->deblocking_filter_control_present_flag = bs_read_u1(b);
+    if (extract & H264_EXTRACT_PPS) { pps->constrained_intra_pred_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    pps->redundant_pic_cnt_present_flag = bs_read_u1(b);
+
+    int have_more_data = 0;
+    if( 1 ) { have_more_data = more_rbsp_data(b); }
+    if( 0 )
+    {
+        have_more_data = pps->transform_8x8_mode_flag || pps->pic_scaling_matrix_present_flag || pps->second_chroma_qp_index_offset != 0;
+    }
+
+    if( have_more_data )
+    {
+        pps->transform_8x8_mode_flag = bs_read_u1(b);
+        pps->pic_scaling_matrix_present_flag = bs_read_u1(b);
+        if( pps->pic_scaling_matrix_present_flag )
+        {
+            for( int i = 0; i < 6 + 2* pps->transform_8x8_mode_flag; i++ )
+            {
+                pps->pic_scaling_list_present_flag[ i ] = bs_read_u1(b);
+                if( pps->pic_scaling_list_present_flag[ i ] )
+                {
+                    if( i < 6 )
+                    {
+                        skip_scaling_list(b, extract, pps->ScalingList4x4[ i ], 16,
+                                                 &( pps->UseDefaultScalingMatrix4x4Flag[ i ] ) );
+                    }
+                    else
+                    {
+                        skip_scaling_list(b, extract, pps->ScalingList8x8[ i - 6 ], 64,
+                                                 &( pps->UseDefaultScalingMatrix8x8Flag[ i - 6 ] ) );
+                    }
+                }
+            }
+        }
+        pps->second_chroma_qp_index_offset = bs_read_se(b);
+    }
+
+    if( 1 )
+    {
+        pps_t* slot = h264_pps_slot(h, pps->pic_parameter_set_id);
+        if( slot != NULL ) { memcpy(slot, h->pps, sizeof(pps_t)); }
+    }
+}
+
+#ifdef HAVE_SEI
+//7.3.2.3 Supplemental enhancement information RBSP syntax
+void skip_sei_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+    if( 1 )
+    {
+        // the messages of the previous SEI are reused, with their payload storage
+        h->num_seis = 0;
+        do {
+            h->num_seis++;
+            sei_pool_reserve(h, h->num_seis);
+            h->sei = h->seis[h->num_seis - 1];
+            skip_sei_message(h, extract, b);
+        } while( more_rbsp_data(b) );
+    }
+
+    if( 0 )
+    {
+        for (int i = 0; i < h->num_seis; i++)
+        {
+            h->sei = h->seis[i];
+            skip_sei_message(h, extract, b);
+        }
+        h->sei = NULL;
+    }
+}
+
+//7.3.2.3.1 Supplemental enhancement information message syntax
+void skip_sei_message(h264_stream_t* h, int extract, bs_t* b)
+{
+    if( 0 )
+    {
+        _write_ff_coded_number(b, h->sei->payloadType);
+        _write_ff_coded_number(b, h->sei->payloadSize);
+    }
+    if( 1 )
+    {
+        h->sei->payloadType = _read_ff_coded_number(b);
+        h->sei->payloadSize = _read_ff_coded_number(b);
+    }
+    skip_sei_payload(h, extract, b );
+}
+#endif
+
+//7.3.2.4 Access unit delimiter RBSP syntax
+void skip_access_unit_delimiter_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+    h->aud->primary_pic_type = bs_read_u(b, 3);
+}
+
+//7.3.2.5 End of sequence RBSP syntax
+void skip_end_of_seq_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+}
+
+//7.3.2.6 End of stream RBSP syntax
+void skip_end_of_stream_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+}
+
+//7.3.2.7 Filler data RBSP syntax
+void skip_filler_data_rbsp(h264_stream_t* h, int extract, bs_t* b)
+{
+    while( bs_next_bits(b, 8) == 0xFF )
+    {
+        /* ff_byte */ bs_skip_u(b, 8);
+    }
+}
+
+//7.3.2.8 Slice layer without partitioning RBSP syntax
+void skip_slice_layer_rbsp(h264_stream_t* h, int extract,  bs_t* b)
+{
+    if (h->nal->nal_unit_type != NAL_UNIT_TYPE_CODED_SLICE_SVC_EXTENSION)
+        skip_slice_header(h, extract, b);
+    else
+        skip_slice_header_in_scalable_extension(h, extract, b);
+    
+    slice_data_rbsp_t* slice_data = h->slice_data;
+
+    if ( slice_data != NULL )
+    {
+        if ( slice_data->rbsp_buf != NULL ) free( slice_data->rbsp_buf ); 
+        bs_t bs_tmp;
+        bs_clone(&bs_tmp, b);
+        bs_skip_u(&bs_tmp, bs_tmp.bits_left); // CABAC-specific: skip alignment bits, if there are any
+        slice_data->rbsp_size = bs_tmp.end - bs_tmp.p;
+
+        if ( slice_data->rbsp_size > 0 && 1 && ( 1 || h->parse_depth < H264_PARSE_SLICE_DATA ) )
+        {
+            // only the headers were asked for, leave the payload unread
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+            return;
+        }
+        else if ( slice_data->rbsp_size > 0 )
+        {
+            slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, slice_data->rbsp_size );
+            // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
+            return;
+        }
+        else
+        {
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+        }
+    }
+
+    // FIXME should read or skip data
+    //slice_data( ); /* all categories of slice_data( ) syntax */
+    skip_rbsp_slice_trailing_bits(h, extract, b);
+}
+
+/*
+// UNIMPLEMENTED
+//7.3.2.9.1 Slice data partition A RBSP syntax
+slice_data_partition_a_layer_rbsp( ) {
+    skip_slice_header(, extract);             // only category 2
+    slice_id = bs_skip_ue(b, extract)
+    skip_slice_data(, extract);               // only category 2
+    skip_rbsp_slice_trailing_bits(, extract); // only category 2
+}
+
+//7.3.2.9.2 Slice data partition B RBSP syntax
+slice_data_partition_b_layer_rbsp( ) {
+    slice_id = bs_read_ue(b);    // only category 3
+    if( redundant_pic_cnt_present_flag )
+        redundant_pic_cnt = bs_read_ue(b);
+    skip_slice_data(, extract);               // only category 3
+    skip_rbsp_slice_trailing_bits(, extract); // only category 3
+}
+
+//7.3.2.9.3 Slice data partition C RBSP syntax
+slice_data_partition_c_layer_rbsp( ) {
+    slice_id = bs_read_ue(b);    // only category 4
+    if( redundant_pic_cnt_present_flag )
+        redundant_pic_cnt = bs_read_ue(b);
+    skip_slice_data(, extract);               // only category 4
+    rbsp_slice_trailing_bits( ); // only category 4
+}
+*/
+
+//7.3.2.10 RBSP slice trailing bits syntax
+void skip_rbsp_slice_trailing_bits(h264_stream_t* h, int extract, bs_t* b)
+{
+    skip_rbsp_trailing_bits(b, extract);
+    if( h->pps->entropy_coding_mode_flag )
+    {
+        while( more_rbsp_trailing_data(h, b) )
+        {
+            /* cabac_zero_word */ bs_skip_u(b, 16);
+        }
+    }
+}
+
+//7.3.2.11 RBSP trailing bits syntax
+void skip_rbsp_trailing_bits(bs_t* b, int extract)
+{
+    /* rbsp_stop_one_bit */ bs_skip_u(b, 1);
+
+    while( !bs_byte_aligned(b) )
+    {
+        /* rbsp_alignment_zero_bit */ bs_skip_u(b, 1);
+    }
+}
+
+//7.3.3 Slice header syntax
+void skip_slice_header(h264_stream_t* h, int extract, bs_t* b)
+{
+    slice_header_t* sh = h->sh;
+    if( 1 )
+    {
+        memset(sh, 0, sizeof(slice_header_t));
+    }
+
+    nal_t* nal = h->nal;
+
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->first_mb_in_slice = bs_read_ue(b); } else { bs_skip_ue(b); }
+    sh->slice_type = bs_read_ue(b);
+    sh->pic_parameter_set_id = bs_read_ue(b);
+
+    // TODO check existence, otherwise fail
+    pps_t* pps = h->pps;
+    sps_t* sps = h->sps;
+    if( 1 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h264_activate_pps(h, sh->pic_parameter_set_id);
+        h264_activate_sps(h, pps->seq_parameter_set_id);
+    }
+    else
+    {
+        // always copies, h->pps and h->sps may have been changed by hand; the hashes follow, for the next read
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+        sps_t* sps_slot = h264_sps_slot(h, pps->seq_parameter_set_id);
+        if( sps_slot != NULL )
+        {
+            memcpy(h->sps, sps_slot, sizeof(sps_t));
+            h->sps_hash = h->sps_table_hash[pps->seq_parameter_set_id];
+        }
+    }
+
+    if (sps->residual_colour_transform_flag)
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->colour_plane_id = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+    }
+    
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->frame_num = bs_read_u(b, sps->log2_max_frame_num_minus4 + 4 ); } else { bs_skip_u(b, sps->log2_max_frame_num_minus4 + 4 ); } // was u(v)
+    if( !sps->frame_mbs_only_flag )
+    {
+        sh->field_pic_flag = bs_read_u1(b);
+        if( sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->bottom_field_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+    }
+    if( nal->nal_unit_type == 5 )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->idr_pic_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if( sps->pic_order_cnt_type == 0 )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->pic_order_cnt_lsb = bs_read_u(b, sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); } else { bs_skip_u(b, sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); } // was u(v)
+        if( pps->pic_order_present_flag && !sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt_bottom = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( sps->pic_order_cnt_type == 1 && !sps->delta_pic_order_always_zero_flag )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        if( pps->pic_order_present_flag && !sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( pps->redundant_pic_cnt_present_flag )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->redundant_pic_cnt = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->direct_spatial_mv_pred_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_P ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
+    {
+        sh->num_ref_idx_active_override_flag = bs_read_u1(b);
+        if( sh->num_ref_idx_active_override_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); } // FIXME does this modify the pps?
+            if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
+            {
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        }
+    }
+    skip_ref_pic_list_reordering(h, extract, b);
+    if( ( pps->weighted_pred_flag && ( is_slice_type( sh->slice_type, SH_SLICE_TYPE_P ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) ) ) ||
+        ( pps->weighted_bipred_idc == 1 && is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) ) )
+    {
+        skip_pred_weight_table(h, extract, b);
+    }
+    if( nal->nal_ref_idc != 0 )
+    {
+        skip_dec_ref_pic_marking(h, extract, b);
+    }
+    if( pps->entropy_coding_mode_flag && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_I ) && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->cabac_init_idc = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_qp_delta = bs_read_se(b); } else { bs_skip_ue(b); }
+    if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) || is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
+    {
+        if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_SP ) )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->sp_for_switch_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_qs_delta = bs_read_se(b); } else { bs_skip_ue(b); }
+    }
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        sh->disable_deblocking_filter_idc = bs_read_ue(b);
+        if( sh->disable_deblocking_filter_idc != 1 )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_alpha_c0_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_beta_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( pps->num_slice_groups_minus1 > 0 &&
+        pps->slice_group_map_type >= 3 && pps->slice_group_map_type <= 5)
+    {
+        int v = intlog2( pps->pic_size_in_map_units_minus1 +  pps->slice_group_change_rate_minus1 + 1 );
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_group_change_cycle = bs_read_u(b, v); } else { bs_skip_u(b, v); } // FIXME add 2?
+    }
+}
+
+//7.3.3.1 Reference picture list reordering syntax
+void skip_ref_pic_list_reordering(h264_stream_t* h, int extract, bs_t* b)
+{
+    slice_header_t* sh = h->sh;
+    // FIXME should be an array
+
+    if( ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_I ) && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_SI ) )
+    {
+        sh->rplr.ref_pic_list_reordering_flag_l0 = bs_read_u1(b);
+        if( sh->rplr.ref_pic_list_reordering_flag_l0 )
+        {
+            int n = -1;
+            do
+            {
+                n++;
+                sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b);
+                if( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 0 ||
+                    sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 1 )
+                {
+                    if (extract & H264_EXTRACT_RPLR) { sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+                else if( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] == 2 )
+                {
+                    if (extract & H264_EXTRACT_RPLR) { sh->rplr.reorder_l0.long_term_pic_num[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+            } while( sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ] != 3 && ! bs_eof(b) );
+        }
+    }
+    if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
+    {
+        sh->rplr.ref_pic_list_reordering_flag_l1 = bs_read_u1(b);
+        if( sh->rplr.ref_pic_list_reordering_flag_l1 )
+        {
+            int n = -1;
+            do
+            {
+                n++;
+                sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] = bs_read_ue(b);
+                if( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 0 ||
+                    sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 1 )
+                {
+                    if (extract & H264_EXTRACT_RPLR) { sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+                else if( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] == 2 )
+                {
+                    if (extract & H264_EXTRACT_RPLR) { sh->rplr.reorder_l1.long_term_pic_num[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+            } while( sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ] != 3 && ! bs_eof(b) );
+        }
+    }
+}
+
+//7.3.3.2 Prediction weight table syntax
+void skip_pred_weight_table(h264_stream_t* h, int extract, bs_t* b)
+{
+    slice_header_t* sh = h->sh;
+    sps_t* sps = h->sps;
+    pps_t* pps = h->pps;
+
+    int i, j;
+
+    if (extract & H264_EXTRACT_PWT) { sh->pwt.luma_log2_weight_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+    if( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
+    {
+        if (extract & H264_EXTRACT_PWT) { sh->pwt.chroma_log2_weight_denom = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    for( i = 0; i <= pps->num_ref_idx_l0_active_minus1; i++ )
+    {
+        sh->pwt.luma_weight_l0_flag[i] = bs_read_u1(b);
+        if( sh->pwt.luma_weight_l0_flag[i] )
+        {
+            if (extract & H264_EXTRACT_PWT) { sh->pwt.luma_weight_l0[ i ] = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_PWT) { sh->pwt.luma_offset_l0[ i ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+        if ( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
+        {
+            sh->pwt.chroma_weight_l0_flag[i] = bs_read_u1(b);
+            if( sh->pwt.chroma_weight_l0_flag[i] )
+            {
+                for( j =0; j < 2; j++ )
+                {
+                    if (extract & H264_EXTRACT_PWT) { sh->pwt.chroma_weight_l0[ i ][ j ] = bs_read_se(b); } else { bs_skip_ue(b); }
+                    if (extract & H264_EXTRACT_PWT) { sh->pwt.chroma_offset_l0[ i ][ j ] = bs_read_se(b); } else { bs_skip_ue(b); }
+                }
+            }
+        }
+    }
+    if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_B ) )
+    {
+        for( i = 0; i <= pps->num_ref_idx_l1_active_minus1; i++ )
+        {
+            sh->pwt.luma_weight_l1_flag[i] = bs_read_u1(b);
+            if( sh->pwt.luma_weight_l1_flag[i] )
+            {
+                if (extract & H264_EXTRACT_PWT) { sh->pwt.luma_weight_l1[ i ] = bs_read_se(b); } else { bs_skip_ue(b); }
+                if (extract & H264_EXTRACT_PWT) { sh->pwt.luma_offset_l1[ i ] = bs_read_se(b); } else { bs_skip_ue(b); }
+            }
+            if( sps->chroma_format_idc != 0 )
+            {
+                sh->pwt.chroma_weight_l1_flag[i] = bs_read_u1(b);
+                if( sh->pwt.chroma_weight_l1_flag[i] )
+                {
+                    for( j = 0; j < 2; j++ )
+                    {
+                        if (extract & H264_EXTRACT_PWT) { sh->pwt.chroma_weight_l1[ i ][ j ] = bs_read_se(b); } else { bs_skip_ue(b); }
+                        if (extract & H264_EXTRACT_PWT) { sh->pwt.chroma_offset_l1[ i ][ j ] = bs_read_se(b); } else { bs_skip_ue(b); }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//7.3.3.3 Decoded reference picture marking syntax
+void skip_dec_ref_pic_marking(h264_stream_t* h, int extract, bs_t* b)
+{
+    slice_header_t* sh = h->sh;
+    // FIXME should be an array
+
+    if( h->nal->nal_unit_type == 5 )
+    {
+        if (extract & H264_EXTRACT_DRPM) { sh->drpm.no_output_of_prior_pics_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if (extract & H264_EXTRACT_DRPM) { sh->drpm.long_term_reference_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+    }
+    else
+    {
+        sh->drpm.adaptive_ref_pic_marking_mode_flag = bs_read_u1(b);
+        if( sh->drpm.adaptive_ref_pic_marking_mode_flag )
+        {
+            int n = -1;
+            do
+            {
+                n++;
+                sh->drpm.memory_management_control_operation[ n ] = bs_read_ue(b);
+                if( sh->drpm.memory_management_control_operation[ n ] == 1 ||
+                    sh->drpm.memory_management_control_operation[ n ] == 3 )
+                {
+                    if (extract & H264_EXTRACT_DRPM) { sh->drpm.difference_of_pic_nums_minus1[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+                if(sh->drpm.memory_management_control_operation[ n ] == 2 )
+                {
+                    if (extract & H264_EXTRACT_DRPM) { sh->drpm.long_term_pic_num[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+                if( sh->drpm.memory_management_control_operation[ n ] == 3 ||
+                    sh->drpm.memory_management_control_operation[ n ] == 6 )
+                {
+                    if (extract & H264_EXTRACT_DRPM) { sh->drpm.long_term_frame_idx[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+                if( sh->drpm.memory_management_control_operation[ n ] == 4 )
+                {
+                    if (extract & H264_EXTRACT_DRPM) { sh->drpm.max_long_term_frame_idx_plus1[ n ] = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+            } while( sh->drpm.memory_management_control_operation[ n ] != 0 && ! bs_eof(b) );
+        }
+    }
+}
+
+//G.7.3.3.4 Slice header in scalable extension syntax
+void skip_slice_header_in_scalable_extension(h264_stream_t* h, int extract, bs_t* b)
+{
+    slice_header_t* sh = h->sh;
+    slice_header_svc_ext_t* sh_svc_ext = h->sh_svc_ext;
+    if( 1 )
+    {
+        memset(sh, 0, sizeof(slice_header_t));
+        memset(sh_svc_ext, 0, sizeof(slice_header_svc_ext_t));
+    }
+    
+    nal_t* nal = h->nal;
+    
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->first_mb_in_slice = bs_read_ue(b); } else { bs_skip_ue(b); }
+    sh->slice_type = bs_read_ue(b);
+    sh->pic_parameter_set_id = bs_read_ue(b);
+    
+    // TODO check existence, otherwise fail
+    pps_t* pps = h->pps;
+    sps_subset_t* sps_subset = h->sps_subset;
+    if( 1 ) { h264_activate_pps(h, sh->pic_parameter_set_id); }
+    else
+    {
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+    }
+    //memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
+    sps_subset_t* sps_subset_slot = h264_sps_subset_slot(h, pps->seq_parameter_set_id);
+    if( sps_subset_slot != NULL )
+    {
+        memcpy(sps_subset->sps, sps_subset_slot->sps, sizeof(sps_t));
+        memcpy(sps_subset->sps_svc_ext, sps_subset_slot->sps_svc_ext, sizeof(sps_svc_ext_t));
+    }
+    
+    if (sps_subset->sps->residual_colour_transform_flag)
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->colour_plane_id = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+    }
+    
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->frame_num = bs_read_u(b, sps_subset->sps->log2_max_frame_num_minus4 + 4 ); } else { bs_skip_u(b, sps_subset->sps->log2_max_frame_num_minus4 + 4 ); } // was u(v)
+    if( !sps_subset->sps->frame_mbs_only_flag )
+    {
+        sh->field_pic_flag = bs_read_u1(b);
+        if( sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->bottom_field_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+    }
+    if( nal->nal_unit_type == 5 )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->idr_pic_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if( sps_subset->sps->pic_order_cnt_type == 0 )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->pic_order_cnt_lsb = bs_read_u(b, sps_subset->sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); } else { bs_skip_u(b, sps_subset->sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); } // was u(v)
+        if( pps->pic_order_present_flag && !sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt_bottom = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( sps_subset->sps->pic_order_cnt_type == 1 && !sps_subset->sps->delta_pic_order_always_zero_flag )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt[ 0 ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        if( pps->pic_order_present_flag && !sh->field_pic_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->delta_pic_order_cnt[ 1 ] = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( pps->redundant_pic_cnt_present_flag )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->redundant_pic_cnt = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if( nal->nal_svc_ext->quality_id == 0)
+    {
+        if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->direct_spatial_mv_pred_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+        if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EP ) ||
+            is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
+        {
+            sh->num_ref_idx_active_override_flag = bs_read_u1(b);
+            if( sh->num_ref_idx_active_override_flag )
+            {
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); } // FIXME does this modify the pps?
+                if( is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) )
+                {
+                    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+                }
+            }
+        }
+        skip_ref_pic_list_reordering(h, extract, b);
+        if( ( pps->weighted_pred_flag       && is_slice_type( sh->slice_type, SH_SLICE_TYPE_EP ) ) ||
+            ( pps->weighted_bipred_idc == 1 && is_slice_type( sh->slice_type, SH_SLICE_TYPE_EB ) ) )
+        {
+            //svc specific
+            if( !nal->nal_svc_ext->no_inter_layer_pred_flag )
+            {
+                sh_svc_ext->base_pred_weight_table_flag = bs_read_u1(b);
+            }
+            if( nal->nal_svc_ext->no_inter_layer_pred_flag || !sh_svc_ext->base_pred_weight_table_flag )
+            {
+                skip_pred_weight_table(h, extract, b);
+            }
+        }
+        if( nal->nal_ref_idc != 0 )
+        {
+            skip_dec_ref_pic_marking(h, extract, b);
+            
+            //svc specific
+            if( !sps_subset->sps_svc_ext->slice_header_restriction_flag )
+            {
+                sh_svc_ext->store_ref_base_pic_flag = bs_read_u1(b);
+                if( ( nal->nal_svc_ext->use_ref_base_pic_flag || sh_svc_ext->store_ref_base_pic_flag ) &&
+                   ( nal->nal_unit_type != 5 ) )
+                {
+                    skip_dec_ref_base_pic_marking(nal, extract, b);
+                }
+            }
+        }
+    }
+    
+    if( pps->entropy_coding_mode_flag && ! is_slice_type( sh->slice_type, SH_SLICE_TYPE_EI ) )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->cabac_init_idc = bs_read_ue(b); } else { bs_skip_ue(b); }
+    }
+    if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_qp_delta = bs_read_se(b); } else { bs_skip_ue(b); }
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        sh->disable_deblocking_filter_idc = bs_read_ue(b);
+        if( sh->disable_deblocking_filter_idc != 1 )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_alpha_c0_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_beta_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    if( pps->num_slice_groups_minus1 > 0 &&
+       pps->slice_group_map_type >= 3 && pps->slice_group_map_type <= 5)
+    {
+        int v = intlog2( pps->pic_size_in_map_units_minus1 +  pps->slice_group_change_rate_minus1 + 1 );
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh->slice_group_change_cycle = bs_read_u(b, v); } else { bs_skip_u(b, v); } // FIXME add 2?
+    }
+    
+    //svc specific
+    if( !nal->nal_svc_ext->no_inter_layer_pred_flag && nal->nal_svc_ext->quality_id == 0 )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->ref_layer_dq_id = bs_read_ue(b); } else { bs_skip_ue(b); }
+        if( sps_subset->sps_svc_ext->inter_layer_deblocking_filter_control_present_flag )
+        {
+            sh_svc_ext->disable_inter_layer_deblocking_filter_idc = bs_read_ue(b);
+            if( sh_svc_ext->disable_inter_layer_deblocking_filter_idc != 1 )
+            {
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->inter_layer_slice_beta_offset_div2 = bs_read_se(b); } else { bs_skip_ue(b); }
+            }
+        }
+        
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->constrained_intra_resampling_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        if( sps_subset->sps_svc_ext->extended_spatial_scalability_idc == 2 )
+        {
+            if( sps_subset->sps->chroma_format_idc > 0 )
+            {
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->ref_layer_chroma_phase_y_plus1 = bs_read_u(b, 2); } else { bs_skip_u(b, 2); }
+            }
+            
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scaled_ref_layer_left_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scaled_ref_layer_top_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scaled_ref_layer_right_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scaled_ref_layer_bottom_offset = bs_read_se(b); } else { bs_skip_ue(b); }
+        }
+    }
+    
+    if( !nal->nal_svc_ext->no_inter_layer_pred_flag )
+    {
+        sh_svc_ext->slice_skip_flag = bs_read_u1(b);
+        if( sh_svc_ext->slice_skip_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->num_mbs_in_slice_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+        }
+        else
+        {
+            sh_svc_ext->adaptive_base_mode_flag = bs_read_u1(b);
+            if( !sh_svc_ext->adaptive_base_mode_flag )
+            {
+                sh_svc_ext->default_base_mode_flag = bs_read_u1(b);
+            }
+            if( !sh_svc_ext->default_base_mode_flag )
+            {
+                sh_svc_ext->adaptive_motion_prediction_flag = bs_read_u1(b);
+                if( !sh_svc_ext->adaptive_motion_prediction_flag )
+                {
+                    if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->default_motion_prediction_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+                }
+            }
+            sh_svc_ext->adaptive_residual_prediction_flag = bs_read_u1(b);
+            if( !sh_svc_ext->adaptive_residual_prediction_flag )
+            {
+                if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->default_residual_prediction_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+            }
+        }
+        if( sps_subset->sps_svc_ext->adaptive_tcoeff_level_prediction_flag )
+        {
+            if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->tcoeff_level_prediction_flag = bs_read_u1(b); } else { bs_skip_u1(b); }
+        }
+    }
+    
+    if( !sps_subset->sps_svc_ext->slice_header_restriction_flag && !sh_svc_ext->slice_skip_flag )
+    {
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scan_idx_start = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+        if (extract & H264_EXTRACT_SLICE_HEADER) { sh_svc_ext->scan_idx_end = bs_read_u(b, 4); } else { bs_skip_u(b, 4); }
+    }
+}
+
+//G.7.3.3.5 Decoded reference base picture marking syntax
+void skip_dec_ref_base_pic_marking(nal_t* nal, int extract, bs_t* b)
+{
+    nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag = bs_read_u1(b);
+    if( nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag )
+    {
+        do {
+            nal->prefix_nal_svc->memory_management_base_control_operation = bs_read_ue(b);
+            
+            if( nal->prefix_nal_svc->memory_management_base_control_operation == 1 )
+            {
+                if (extract & H264_EXTRACT_DRPM) { nal->prefix_nal_svc->difference_of_base_pic_nums_minus1 = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+            if( nal->prefix_nal_svc->memory_management_base_control_operation == 2 )
+            {
+                if (extract & H264_EXTRACT_DRPM) { nal->prefix_nal_svc->long_term_base_pic_num = bs_read_ue(b); } else { bs_skip_ue(b); }
+            }
+        } while( nal->prefix_nal_svc->memory_management_base_control_operation != 0 );
+    }
+}
+
+
+const h264_debug_name_t h264_stream_debug_names[] =
+{
+    { 0x3A3AE9DD, "forbidden_zero_bit" },
+    { 0x18BAEDFD, "nal->nal_ref_idc" },
+    { 0x8FC50732, "nal->nal_unit_type" },
+    { 0x43DAA5C8, "nal->svc_extension_flag" },
+    { 0x6291D4AE, "nal->avc_3d_extension_flag" },
+    { 0xC2877CD6, "nal_svc_ext->idr_flag" },
+    { 0x0C3164D2, "nal_svc_ext->priority_id" },
+    { 0xF7D290CB, "nal_svc_ext->no_inter_layer_pred_flag" },
+    { 0xA4D85F59, "nal_svc_ext->dependency_id" },
+    { 0x45517E89, "nal_svc_ext->quality_id" },
+    { 0xBB115B4C, "nal_svc_ext->temporal_id" },
+    { 0x1C2F0C29, "nal_svc_ext->use_ref_base_pic_flag" },
+    { 0x89616617, "nal_svc_ext->discardable_flag" },
+    { 0x78554172, "nal_svc_ext->output_flag" },
+    { 0x9E0F942C, "nal_svc_ext->reserved_three_2bits" },
+    { 0x7AA492CA, "nal->prefix_nal_svc->store_ref_base_pic_flag" },
+    { 0xE4F0AC41, "nal->prefix_nal_svc->additional_prefix_nal_unit_extension_flag" },
+    { 0xA4D9334A, "nal->prefix_nal_svc->additional_prefix_nal_unit_extension_data_flag" },
+    { 0xF79F9368, "sps->profile_idc" },
+    { 0x53BA02DF, "sps->constraint_set0_flag" },
+    { 0x7061DBEE, "sps->constraint_set1_flag" },
+    { 0x43B73565, "sps->constraint_set2_flag" },
+    { 0x0282B21C, "sps->constraint_set3_flag" },
+    { 0xF0AF37A3, "sps->constraint_set4_flag" },
+    { 0x554FB4C2, "sps->constraint_set5_flag" },
+    { 0xB740DD25, "reserved_zero_2bits" },
+    { 0xB826F6D7, "sps->level_idc" },
+    { 0xB10AF9B0, "sps->seq_parameter_set_id" },
+    { 0x6F6238B5, "sps->chroma_format_idc" },
+    { 0x29019BA2, "sps->residual_colour_transform_flag" },
+    { 0x664F05FC, "sps->bit_depth_luma_minus8" },
+    { 0xBBEFF3D9, "sps->bit_depth_chroma_minus8" },
+    { 0xE632F6B0, "sps->qpprime_y_zero_transform_bypass_flag" },
+    { 0x17019E5A, "sps->seq_scaling_matrix_present_flag" },
+    { 0x50F3146E, "sps->seq_scaling_list_present_flag[ i ]" },
+    { 0x33BB06AD, "sps->log2_max_frame_num_minus4" },
+    { 0x46D53E6C, "sps->pic_order_cnt_type" },
+    { 0x2A686A28, "sps->log2_max_pic_order_cnt_lsb_minus4" },
+    { 0xC455AA90, "sps->delta_pic_order_always_zero_flag" },
+    { 0xF6C15E7E, "sps->offset_for_non_ref_pic" },
+    { 0x13E9EE16, "sps->offset_for_top_to_bottom_field" },
+    { 0x376A1244, "sps->num_ref_frames_in_pic_order_cnt_cycle" },
+    { 0x5A61C46C, "sps->offset_for_ref_frame[ i ]" },
+    { 0x480EDFBD, "sps->num_ref_frames" },
+    { 0xDC64F080, "sps->gaps_in_frame_num_value_allowed_flag" },
+    { 0x77EAC076, "sps->pic_width_in_mbs_minus1" },
+    { 0xCBEAF48D, "sps->pic_height_in_map_units_minus1" },
+    { 0x07D2F140, "sps->frame_mbs_only_flag" },
+    { 0x8804360A, "sps->mb_adaptive_frame_field_flag" },
+    { 0x82791561, "sps->direct_8x8_inference_flag" },
+    { 0x1EA98E77, "sps->frame_cropping_flag" },
+    { 0xCD9983DA, "sps->frame_crop_left_offset" },
+    { 0xD7134661, "sps->frame_crop_right_offset" },
+    { 0x853B36FE, "sps->frame_crop_top_offset" },
+    { 0x27EA917C, "sps->frame_crop_bottom_offset" },
+    { 0xA58884FC, "sps->vui_parameters_present_flag" },
+    { 0x1B14B590, "delta_scale" },
+    { 0xDE1AA042, "sps_svc_ext->svc_vui_parameters_present_flag" },
+    { 0x9687A85F, "sps_subset->additional_extension2_flag" },
+    { 0x631C4A34, "sps_svc_ext->inter_layer_deblocking_filter_control_present_flag" },
+    { 0x0AF878CA, "sps_svc_ext->extended_spatial_scalability_idc" },
+    { 0x01750137, "sps_svc_ext->chroma_phase_x_plus1_flag" },
+    { 0xC978D7F3, "sps_svc_ext->chroma_phase_y_plus1" },
+    { 0x5603AC43, "sps_svc_ext->seq_ref_layer_chroma_phase_x_plus1_flag" },
+    { 0x53C258B7, "sps_svc_ext->seq_ref_layer_chroma_phase_y_plus1" },
+    { 0x713C1BB9, "sps_svc_ext->seq_scaled_ref_layer_left_offset" },
+    { 0x314911FB, "sps_svc_ext->seq_scaled_ref_layer_top_offset" },
+    { 0x66B53920, "sps_svc_ext->seq_scaled_ref_layer_right_offset" },
+    { 0x95FA3193, "sps_svc_ext->seq_scaled_ref_layer_bottom_offset" },
+    { 0xC3C4323A, "sps_svc_ext->seq_tcoeff_level_prediction_flag" },
+    { 0x96B8A3CB, "sps_svc_ext->adaptive_tcoeff_level_prediction_flag" },
+    { 0x72A47A25, "sps_svc_ext->slice_header_restriction_flag" },
+    { 0xBEB88EA9, "sps_svc_ext->vui.vui_ext_num_entries_minus1" },
+    { 0xD07879C4, "sps_svc_ext->vui.vui_ext_dependency_id[i]" },
+    { 0x058A577C, "sps_svc_ext->vui.vui_ext_quality_id[i]" },
+    { 0x91FF32DF, "sps_svc_ext->vui.vui_ext_temporal_id[i]" },
+    { 0x104E5C9F, "sps_svc_ext->vui.vui_ext_timing_info_present_flag[i]" },
+    { 0x1D5E02FF, "sps_svc_ext->vui.vui_ext_num_units_in_tick[i]" },
+    { 0xC0991525, "sps_svc_ext->vui.vui_ext_time_scale[i]" },
+    { 0xFD21B887, "sps_svc_ext->vui.vui_ext_fixed_frame_rate_flag[i]" },
+    { 0x63F10AD7, "sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i]" },
+    { 0x3659A41D, "sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i]" },
+    { 0x6E8DFD9B, "sps_svc_ext->vui.vui_ext_low_delay_hrd_flag[i]" },
+    { 0x6BDF54D8, "sps_svc_ext->vui.vui_ext_pic_struct_present_flag[i]" },
+    { 0x3884A7D6, "sps->vui.aspect_ratio_info_present_flag" },
+    { 0xEFA464BF, "sps->vui.aspect_ratio_idc" },
+    { 0x6B39F0AF, "sps->vui.sar_width" },
+    { 0x04DC3452, "sps->vui.sar_height" },
+    { 0x91B11011, "sps->vui.overscan_info_present_flag" },
+    { 0x6310A094, "sps->vui.overscan_appropriate_flag" },
+    { 0x50A5A40A, "sps->vui.video_signal_type_present_flag" },
+    { 0x987DF82D, "sps->vui.video_format" },
+    { 0xE3CB6388, "sps->vui.video_full_range_flag" },
+    { 0xD7F2F03A, "sps->vui.colour_description_present_flag" },
+    { 0xCE4B0EC7, "sps->vui.colour_primaries" },
+    { 0x565718C0, "sps->vui.transfer_characteristics" },
+    { 0xCCCACA22, "sps->vui.matrix_coefficients" },
+    { 0x6AEC4651, "sps->vui.chroma_loc_info_present_flag" },
+    { 0xB0EECC1C, "sps->vui.chroma_sample_loc_type_top_field" },
+    { 0x78386E84, "sps->vui.chroma_sample_loc_type_bottom_field" },
+    { 0x128B2F14, "sps->vui.timing_info_present_flag" },
+    { 0x86EEDE6C, "sps->vui.num_units_in_tick" },
+    { 0x218F4A62, "sps->vui.time_scale" },
+    { 0xE48BBEDC, "sps->vui.fixed_frame_rate_flag" },
+    { 0x9C3DB6AC, "sps->vui.nal_hrd_parameters_present_flag" },
+    { 0xC221E242, "sps->vui.vcl_hrd_parameters_present_flag" },
+    { 0x4F316D20, "sps->vui.low_delay_hrd_flag" },
+    { 0xBEF94BAD, "sps->vui.pic_struct_present_flag" },
+    { 0x7C18EA6B, "sps->vui.bitstream_restriction_flag" },
+    { 0xFAB7A89F, "sps->vui.motion_vectors_over_pic_boundaries_flag" },
+    { 0x6A6A4BC3, "sps->vui.max_bytes_per_pic_denom" },
+    { 0xD4454321, "sps->vui.max_bits_per_mb_denom" },
+    { 0xDF7539A1, "sps->vui.log2_max_mv_length_horizontal" },
+    { 0xEF2EB4A3, "sps->vui.log2_max_mv_length_vertical" },
+    { 0x7B55E0E5, "sps->vui.num_reorder_frames" },
+    { 0x461D0874, "sps->vui.max_dec_frame_buffering" },
+    { 0x11DA04A9, "hrd->cpb_cnt_minus1" },
+    { 0x789F7519, "hrd->bit_rate_scale" },
+    { 0xBCE2EED2, "hrd->cpb_size_scale" },
+    { 0x508939FA, "hrd->bit_rate_value_minus1[ SchedSelIdx ]" },
+    { 0xC09DD4A1, "hrd->cpb_size_value_minus1[ SchedSelIdx ]" },
+    { 0xAD77AA3C, "hrd->cbr_flag[ SchedSelIdx ]" },
+    { 0xFE8EAC8C, "hrd->initial_cpb_removal_delay_length_minus1" },
+    { 0x9D257C9B, "hrd->cpb_removal_delay_length_minus1" },
+    { 0xBC80045D, "hrd->dpb_output_delay_length_minus1" },
+    { 0xF6072640, "hrd->time_offset_length" },
+    { 0x7922D34D, "seq_parameter_set_id" },
+    { 0xA48FA9EC, "aux_format_idc" },
+    { 0x3A3D1D78, "bit_depth_aux_minus8" },
+    { 0xB77D4F75, "alpha_incr_flag" },
+    { 0xE104D1B5, "additional_extension_flag" },
+    { 0x68B23910, "pps->pic_parameter_set_id" },
+    { 0x4D11F1B1, "pps->seq_parameter_set_id" },
+    { 0xBC12E810, "pps->entropy_coding_mode_flag" },
+    { 0x533B879B, "pps->pic_order_present_flag" },
+    { 0xC7089C13, "pps->num_slice_groups_minus1" },
+    { 0x7DF19349, "pps->slice_group_map_type" },
+    { 0x9A3C0BF4, "pps->run_length_minus1[ i_group ]" },
+    { 0x61D70951, "pps->top_left[ i_group ]" },
+    { 0xAF2DC34C, "pps->bottom_right[ i_group ]" },
+    { 0xC0959D13, "pps->slice_group_change_direction_flag" },
+    { 0xD584F7FD, "pps->slice_group_change_rate_minus1" },
+    { 0x8D01C1DE, "pps->pic_size_in_map_units_minus1" },
+    { 0xB56315B0, "pps->slice_group_id[ i ]" },
+    { 0xCF445549, "pps->num_ref_idx_l0_active_minus1" },
+    { 0xC6650FE6, "pps->num_ref_idx_l1_active_minus1" },
+    { 0xC95D0631, "pps->weighted_pred_flag" },
+    { 0x925A6E4A, "pps->weighted_bipred_idc" },
+    { 0xFC26EF25, "pps->pic_init_qp_minus26" },
+    { 0xC0B518BC, "pps->pic_init_qs_minus26" },
+    { 0xA98E2E8C, "pps->chroma_qp_index_offset" },
+    { 0xC8868471, "pps->deblocking_filter_control_present_flag" },
+    { 0x4FE55835, "pps->constrained_intra_pred_flag" },
+    { 0x08B21270, "pps->redundant_pic_cnt_present_flag" },
+    { 0xBC0C3C91, "pps->transform_8x8_mode_flag" },
+    { 0x4D1BC97A, "pps->pic_scaling_matrix_present_flag" },
+    { 0x4169BA0E, "pps->pic_scaling_list_present_flag[ i ]" },
+    { 0xDE87226F, "pps->second_chroma_qp_index_offset" },
+    { 0xB9EA56C3, "h->aud->primary_pic_type" },
+    { 0x1B8EDC7C, "ff_byte" },
+    { 0x46E0C087, "slice_id" },
+    { 0x0467E7E5, "redundant_pic_cnt" },
+    { 0x95137F65, "cabac_zero_word" },
+    { 0x02FE9ED0, "rbsp_stop_one_bit" },
+    { 0x525C97EB, "rbsp_alignment_zero_bit" },
+    { 0x57733530, "sh->first_mb_in_slice" },
+    { 0x62D7949A, "sh->slice_type" },
+    { 0x109E2164, "sh->pic_parameter_set_id" },
+    { 0x83597CB0, "sh->colour_plane_id" },
+    { 0x73571069, "sh->frame_num" },
+    { 0x54BDCFEF, "sh->field_pic_flag" },
+    { 0x9F603184, "sh->bottom_field_flag" },
+    { 0x10428B47, "sh->idr_pic_id" },
+    { 0x4C8264E2, "sh->pic_order_cnt_lsb" },
+    { 0x5A2017D1, "sh->delta_pic_order_cnt_bottom" },
+    { 0xD2E3D88D, "sh->delta_pic_order_cnt[ 0 ]" },
+    { 0x7F2BD542, "sh->delta_pic_order_cnt[ 1 ]" },
+    { 0xA4ECE2F5, "sh->redundant_pic_cnt" },
+    { 0x9AA9FC56, "sh->direct_spatial_mv_pred_flag" },
+    { 0xF0140AA8, "sh->num_ref_idx_active_override_flag" },
+    { 0x4B3128BD, "sh->num_ref_idx_l0_active_minus1" },
+    { 0x9EAD4B6A, "sh->num_ref_idx_l1_active_minus1" },
+    { 0xE1633E39, "sh->cabac_init_idc" },
+    { 0x7394F832, "sh->slice_qp_delta" },
+    { 0x1442BAAE, "sh->sp_for_switch_flag" },
+    { 0xED321FBB, "sh->slice_qs_delta" },
+    { 0x1B100012, "sh->disable_deblocking_filter_idc" },
+    { 0x01BC7C6C, "sh->slice_alpha_c0_offset_div2" },
+    { 0x53F5E9E8, "sh->slice_beta_offset_div2" },
+    { 0x1BE65547, "sh->slice_group_change_cycle" },
+    { 0x47EDD236, "sh->rplr.ref_pic_list_reordering_flag_l0" },
+    { 0xED33F6B0, "sh->rplr.reorder_l0.reordering_of_pic_nums_idc[ n ]" },
+    { 0x5C366411, "sh->rplr.reorder_l0.abs_diff_pic_num_minus1[ n ]" },
+    { 0x9650E456, "sh->rplr.reorder_l0.long_term_pic_num[ n ]" },
+    { 0x48EDD3C9, "sh->rplr.ref_pic_list_reordering_flag_l1" },
+    { 0xE066F36B, "sh->rplr.reorder_l1.reordering_of_pic_nums_idc[ n ]" },
+    { 0x350B0C90, "sh->rplr.reorder_l1.abs_diff_pic_num_minus1[ n ]" },
+    { 0x9C8412AF, "sh->rplr.reorder_l1.long_term_pic_num[ n ]" },
+    { 0x48220CB5, "sh->pwt.luma_log2_weight_denom" },
+    { 0xAB2AB65A, "sh->pwt.chroma_log2_weight_denom" },
+    { 0xBB9ABBB3, "sh->pwt.luma_weight_l0_flag[i]" },
+    { 0x6FC119C2, "sh->pwt.luma_weight_l0[ i ]" },
+    { 0x09589BA5, "sh->pwt.luma_offset_l0[ i ]" },
+    { 0x2DB42BDC, "sh->pwt.chroma_weight_l0_flag[i]" },
+    { 0x6BAE6BFD, "sh->pwt.chroma_weight_l0[ i ][ j ]" },
+    { 0x11510600, "sh->pwt.chroma_offset_l0[ i ][ j ]" },
+    { 0x9BBC4194, "sh->pwt.luma_weight_l1_flag[i]" },
+    { 0x152B737B, "sh->pwt.luma_weight_l1[ i ]" },
+    { 0x6203F6AC, "sh->pwt.luma_offset_l1[ i ]" },
+    { 0x57D15FFB, "sh->pwt.chroma_weight_l1_flag[i]" },
+    { 0xD3FDA912, "sh->pwt.chroma_weight_l1[ i ][ j ]" },
+    { 0x9A9659EB, "sh->pwt.chroma_offset_l1[ i ][ j ]" },
+    { 0x7069B935, "sh->drpm.no_output_of_prior_pics_flag" },
+    { 0xF86F0E08, "sh->drpm.long_term_reference_flag" },
+    { 0xFBA0F6A4, "sh->drpm.adaptive_ref_pic_marking_mode_flag" },
+    { 0x57967323, "sh->drpm.memory_management_control_operation[ n ]" },
+    { 0xDC8B5E8E, "sh->drpm.difference_of_pic_nums_minus1[ n ]" },
+    { 0x08400521, "sh->drpm.long_term_pic_num[ n ]" },
+    { 0x87270BC3, "sh->drpm.long_term_frame_idx[ n ]" },
+    { 0x49A7E84C, "sh->drpm.max_long_term_frame_idx_plus1[ n ]" },
+    { 0x9F0C489C, "sh_svc_ext->base_pred_weight_table_flag" },
+    { 0xEA45E601, "sh_svc_ext->store_ref_base_pic_flag" },
+    { 0xF85AF9E9, "sh_svc_ext->ref_layer_dq_id" },
+    { 0x55C22032, "sh_svc_ext->disable_inter_layer_deblocking_filter_idc" },
+    { 0x5F92B8DC, "sh_svc_ext->inter_layer_slice_alpha_c0_offset_div2" },
+    { 0xC658F4D8, "sh_svc_ext->inter_layer_slice_beta_offset_div2" },
+    { 0xB99327AB, "sh_svc_ext->constrained_intra_resampling_flag" },
+    { 0x6B8FCFA4, "sh_svc_ext->ref_layer_chroma_phase_x_plus1_flag" },
+    { 0xA0FA5596, "sh_svc_ext->ref_layer_chroma_phase_y_plus1" },
+    { 0x4E7D0354, "sh_svc_ext->scaled_ref_layer_left_offset" },
+    { 0x6DBE23B4, "sh_svc_ext->scaled_ref_layer_top_offset" },
+    { 0x2212DB2B, "sh_svc_ext->scaled_ref_layer_right_offset" },
+    { 0xAE3B80C6, "sh_svc_ext->scaled_ref_layer_bottom_offset" },
+    { 0x1FEB35CB, "sh_svc_ext->slice_skip_flag" },
+    { 0xDBF3C85C, "sh_svc_ext->num_mbs_in_slice_minus1" },
+    { 0x56B25B43, "sh_svc_ext->adaptive_base_mode_flag" },
+    { 0xF5A59E9A, "sh_svc_ext->default_base_mode_flag" },
+    { 0xD19E0E8A, "sh_svc_ext->adaptive_motion_prediction_flag" },
+    { 0x52DE28DF, "sh_svc_ext->default_motion_prediction_flag" },
+    { 0xBB298F87, "sh_svc_ext->adaptive_residual_prediction_flag" },
+    { 0x46866F7E, "sh_svc_ext->default_residual_prediction_flag" },
+    { 0xE7785C33, "sh_svc_ext->tcoeff_level_prediction_flag" },
+    { 0x0F2B2D86, "sh_svc_ext->scan_idx_start" },
+    { 0x994A21E3, "sh_svc_ext->scan_idx_end" },
+    { 0x15981CD1, "nal->prefix_nal_svc->adaptive_ref_base_pic_marking_mode_flag" },
+    { 0x65A17330, "nal->prefix_nal_svc->memory_management_base_control_operation" },
+    { 0x8DB0053B, "nal->prefix_nal_svc->difference_of_base_pic_nums_minus1" },
+    { 0x1127AF6A, "nal->prefix_nal_svc->long_term_base_pic_num" },
+    { 0, NULL }
+};
@@ -28,6 +28,7 @@
 #include <assert.h>
 
 #include "bs.h"
+#include "h264_debug.h"
 #include "h264_sei.h"
 
 #ifdef __cplusplus
@@ -498,6 +499,27 @@ typedef struct
     uint8_t* rbsp_buf;
 } slice_data_rbsp_t;
 
+// how much of each NAL read_nal_unit() parses, see h264_stream_t.parse_depth
+#define H264_PARSE_NAL_HEADER   0  // nal_unit header only
+#define H264_PARSE_HEADERS      1  // also parameter sets, SEI and slice headers, but not slice data
+#define H264_PARSE_SLICE_DATA   2  // also copy the slice payload into slice_data (default)
+
+/**
+   What skip_nal_unit() stores, by the structure a value is read in.  Values that reading the rest of the
+   stream depends on (parameter set ids, flags that say what comes next, and so on) are always stored; the
+   others are stepped over without being decoded unless their group is asked for, and are left zero.
+   skip_nal_unit(h, H264_EXTRACT_ALL, ...) stores the same as read_nal_unit(), except for slice data.
+ */
+#define H264_EXTRACT_SPS            0x0001  // seq_parameter_set_rbsp and the subset SPS extensions
+#define H264_EXTRACT_VUI            0x0002  // vui_parameters and hrd_parameters
+#define H264_EXTRACT_PPS            0x0004  // pic_parameter_set_rbsp
+#define H264_EXTRACT_SLICE_HEADER   0x0008  // slice_header, other than the following
+#define H264_EXTRACT_RPLR           0x0010  // ref_pic_list_reordering
+#define H264_EXTRACT_PWT            0x0020  // pred_weight_table
+#define H264_EXTRACT_DRPM           0x0040  // dec_ref_pic_marking
+#define H264_EXTRACT_SEI            0x0080  // sei_scalability_info
+#define H264_EXTRACT_ALL            0xFFFF
+
 /**
    H264 stream
    Contains data structures for all NAL types that can be handled by this library.  
@@ -519,20 +541,64 @@ typedef struct
     
     slice_data_rbsp_t* slice_data;
     
+    // slots are NULL until a parameter set with that id is seen, use h264_*_slot() to create them
     sps_t* sps_table[32];
     sps_subset_t* sps_subset_table[64];  //refer to base SPS
     pps_t* pps_table[256];
     sei_t** seis;
+    int sei_pool_size; // messages allocated in seis when reading, num_seis of them in use
+
+    int parse_depth; // one of H264_PARSE_*, only affects reading
+
+    struct h264_arena_chunk* arena; // memory for the table slots, freed with the stream
+
+    // hashes of the NAL bytes each table slot was read from, and of the parameter sets h->sps and h->pps hold, 0 if unknown.
+    // A re-sent SPS or PPS with the same bytes is not parsed again, and h->sps and h->pps are only reloaded from the tables
+    // when a slice switches to another parameter set.  Set the hash to 0 when changing a slot or h->sps/h->pps by hand.
+    uint64_t sps_table_hash[32];
+    uint64_t pps_table_hash[256];
+    uint64_t sps_hash;
+    uint64_t pps_hash;
 
 } h264_stream_t;
 
 h264_stream_t* h264_new();
 void h264_free(h264_stream_t* h);
 
+sps_t* h264_sps_slot(h264_stream_t* h, int id);
+sps_subset_t* h264_sps_subset_slot(h264_stream_t* h, int id);
+pps_t* h264_pps_slot(h264_stream_t* h, int id);
+void sei_pool_reserve(h264_stream_t* h, int n);
+
+uint64_t h264_nal_hash(const uint8_t* buf, int size);
+uint64_t h264_ps_hash(const uint8_t* buf, int size, int extract);
+int h264_sps_resent(h264_stream_t* h, bs_t* b, const uint8_t* buf, int size, int extract);
+int h264_pps_resent(h264_stream_t* h, bs_t* b, const uint8_t* buf, int size, int extract);
+void h264_activate_sps(h264_stream_t* h, int id);
+void h264_activate_pps(h264_stream_t* h, int id);
+void h264_copy_state(h264_stream_t* dst, h264_stream_t* src);
+
+/**
+   Position of one NAL unit in a buffer, as found by find_nal_units().
+*/
+typedef struct
+{
+    int start;  // offset of the first byte after the start code
+    int end;    // offset one past the last byte of the NAL
+} nal_pos_t;
+
 int find_nal_unit(uint8_t* buf, int size, int* nal_start, int* nal_end);
+int find_nal_units(uint8_t* buf, int size, nal_pos_t* nals, int max_nals, int is_last);
+int nal_scan_set_kernel(int kernel);
+
+#define NAL_SCAN_KERNEL_AUTO        0
+#define NAL_SCAN_KERNEL_C           1
+#define NAL_SCAN_KERNEL_SSE2        2
+#define NAL_SCAN_KERNEL_AVX2        3
 
 int rbsp_to_nal(const uint8_t* rbsp_buf, const int* rbsp_size, uint8_t* nal_buf, int* nal_size);
 int nal_to_rbsp(const uint8_t* nal_buf, int* nal_size, uint8_t* rbsp_buf, int* rbsp_size);
+int nal_to_rbsp_inplace(uint8_t* buf, int* size);
 
 int read_nal_unit(h264_stream_t* h, uint8_t* buf, int size);
 int peek_nal_unit(h264_stream_t* h, uint8_t* buf, int size);
@@ -587,6 +653,8 @@ void write_dec_ref_pic_marking(h264_stream_t* h, bs_t* b);
 
 int read_debug_nal_unit(h264_stream_t* h, uint8_t* buf, int size);
 
+int skip_nal_unit(h264_stream_t* h, int extract, uint8_t* buf, int size);
+
 void debug_sps(sps_t* sps);
 void debug_pps(pps_t* pps);
 void debug_slice_header(slice_header_t* sh);
@@ -597,6 +665,7 @@ void debug_bytes(uint8_t* buf, int len);
 void read_sei_payload( h264_stream_t* h, bs_t* b);
 void read_debug_sei_payload( h264_stream_t* h, bs_t* b);
 void write_sei_payload( h264_stream_t* h, bs_t* b);
+void skip_sei_payload(h264_stream_t* h, int extract, bs_t* b);
 
 //NAL ref idc codes
 #define NAL_REF_IDC_PRIORITY_HIGHEST    3
@@ -699,6 +768,9 @@ void write_sei_payload( h264_stream_t* h, bs_t* b);
 
 // file handle for debug output
 extern FILE* h264_dbgfile;
+// file handle for debug output from the calling thread only, used instead of h264_dbgfile when not NULL.
+// Lets several threads read_debug_* at once, each into its own file
+extern H264_THREAD_LOCAL FILE* h264_dbgfile_thread;
 
 #ifdef __cplusplus
 }
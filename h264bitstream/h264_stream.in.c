@@ -31,8 +31,9 @@
 #include "h264_sei.h"
 
 FILE* h264_dbgfile = NULL;
+H264_THREAD_LOCAL FILE* h264_dbgfile_thread = NULL;
 
-#define printf(...) fprintf((h264_dbgfile == NULL ? stdout : h264_dbgfile), __VA_ARGS__)
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
 
 /** 
  Calculate the log base 2 of the argument, rounded up. 
@@ -73,10 +74,12 @@ int more_rbsp_data(bs_t* bs)
     bs_t bs_tmp;
     bs_clone(&bs_tmp, bs);
     bs_skip_u1(&bs_tmp);
+
+    // A later bit was 1, it wasn't the rsbp_stop_bit; check the rest of this byte, then whole bytes
+    if (!bs_byte_aligned(&bs_tmp) && bs_read_u(&bs_tmp, bs_tmp.bits_left) != 0) { return 1; }
     while(!bs_eof(&bs_tmp))
     {
-        // A later bit was 1, it wasn't the rsbp_stop_bit
-        if (bs_read_u1(&bs_tmp) == 1) { return 1; }
+        if (bs_read_u8(&bs_tmp) != 0) { return 1; }
     }
 
     // All following bits were 0, it was the rsbp_stop_bit
@@ -129,6 +132,15 @@ void debug_bytes(uint8_t* buf, int len)
 
 #function_declarations
 
+#debug_names h264_stream_debug_names
+
+#extract H264_EXTRACT_SPS seq_parameter_set_rbsp subset_seq_parameter_set_rbsp seq_parameter_set_svc_extension
+#extract H264_EXTRACT_VUI vui_parameters hrd_parameters svc_vui_parameters_extension
+#extract H264_EXTRACT_PPS pic_parameter_set_rbsp
+#extract H264_EXTRACT_SLICE_HEADER slice_header slice_header_in_scalable_extension
+#extract H264_EXTRACT_RPLR ref_pic_list_reordering
+#extract H264_EXTRACT_PWT pred_weight_table
+#extract H264_EXTRACT_DRPM dec_ref_pic_marking dec_ref_base_pic_marking
 
 //7.3.1 NAL unit syntax
 int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
@@ -137,21 +149,23 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
 
     int nal_size = size;
     int rbsp_size = size;
-    uint8_t* rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
 
     if( is_reading )
     {
-        int rc = nal_to_rbsp(buf, &nal_size, rbsp_buf, &rbsp_size);
-
-        if (rc < 0) { free(rbsp_buf); return -1; } // handle conversion error
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
     }
 
     if( is_writing )
     {
         rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
     }
 
-    bs_t* b = bs_new(rbsp_buf, rbsp_size);
     value( forbidden_zero_bit, f(1, 0) );
     value( nal->nal_ref_idc, u(2) );
     value( nal->nal_unit_type, u(5) );
@@ -173,6 +187,11 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
         }
     }
 
+    if( is_reading && h->parse_depth < H264_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
     switch ( nal->nal_unit_type )
     {
         case NAL_UNIT_TYPE_CODED_SLICE_IDR:
@@ -189,19 +208,37 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
 #endif
 
         case NAL_UNIT_TYPE_SPS: 
+            if( is_reading && !is_debugging && h264_sps_resent(h, b, buf, nal_size, extracted) ) { break; }
+
             structure(seq_parameter_set_rbsp)(h->sps, b);
             structure(rbsp_trailing_bits)(b);
             
             if( is_reading )
             {
-                memcpy(h->sps_table[h->sps->seq_parameter_set_id], h->sps, sizeof(sps_t));
+                int id = h->sps->seq_parameter_set_id;
+                sps_t* slot = h264_sps_slot(h, id);
+                if( slot == NULL ) { h->sps_hash = 0; return -1; }
+                memcpy(slot, h->sps, sizeof(sps_t));
+                h->sps_hash = h264_ps_hash(buf, nal_size, extracted);
+                h->sps_table_hash[id] = h->sps_hash;
             }
 
             break;
 
         case NAL_UNIT_TYPE_PPS:   
+            if( is_reading && !is_debugging && h264_pps_resent(h, b, buf, nal_size, extracted) ) { break; }
+
             structure(pic_parameter_set_rbsp)(h, b);
             structure(rbsp_trailing_bits)(b);
+
+            if( is_reading )
+            {
+                // pic_parameter_set_rbsp has stored it, unless the id is out of range
+                int id = h->pps->pic_parameter_set_id;
+                if( h264_pps_slot(h, id) == NULL ) { h->pps_hash = 0; return -1; }
+                h->pps_hash = h264_ps_hash(buf, nal_size, extracted);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
             break;
 
         case NAL_UNIT_TYPE_AUD:     
@@ -226,10 +263,12 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
             
             if( is_reading )
             {
-                memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps, h->sps_subset->sps, sizeof(sps_t));
-                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
-                //h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id]->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
+                //memcpy(h->sps_subset_table[h->sps_subset->sps->seq_parameter_set_id], h->sps_subset, sizeof(sps_subset_t));
+                sps_subset_t* sps_subset = h264_sps_subset_slot(h, h->sps_subset->sps->seq_parameter_set_id);
+                if( sps_subset == NULL ) { return -1; }
+                memcpy(sps_subset->sps, h->sps_subset->sps, sizeof(sps_t));
+                memcpy(sps_subset->sps_svc_ext, h->sps_subset->sps_svc_ext, sizeof(sps_svc_ext_t));
+                sps_subset->additional_extension2_flag = h->sps_subset->additional_extension2_flag;
             }
 
             break;
@@ -253,10 +292,11 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_B: 
         case NAL_UNIT_TYPE_CODED_SLICE_DATA_PARTITION_C:
         default:
+            free(rbsp_buf);
             return -1;
     }
 
-    if (bs_overrun(b)) { bs_free(b); free(rbsp_buf); return -1; }
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
 
     if( is_writing )
     {
@@ -264,10 +304,9 @@ int structure(nal_unit)(h264_stream_t* h, uint8_t* buf, int size)
         rbsp_size = bs_pos(b);
 
         int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
-        if (rc < 0) { bs_free(b); free(rbsp_buf); return -1; }
+        if (rc < 0) { free(rbsp_buf); return -1; }
     }
 
-    bs_free(b);
     free(rbsp_buf);
 
     return nal_size;
@@ -367,7 +406,7 @@ void structure(seq_parameter_set_rbsp)(sps_t* sps, bs_t* b)
         value( sps->seq_scaling_matrix_present_flag, u1 );
         if( sps->seq_scaling_matrix_present_flag )
         {
-            for( i = 0; i < 8; i++ )
+            for( i = 0; i < ((sps->chroma_format_idc != 3) ? 8 : 12); i++ )
             {
                 value( sps->seq_scaling_list_present_flag[ i ], u1 );
                 if( sps->seq_scaling_list_present_flag[ i ] )
@@ -549,12 +588,12 @@ void structure(svc_vui_parameters_extension)(sps_svc_ext_t* sps_svc_ext, bs_t* b
         value( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i], u1 );
         if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] )
         {
-            structure(hrd_parameters)(&sps_svc_ext->hrd_vcl, b);
+            structure(hrd_parameters)(&sps_svc_ext->hrd_vcl[i], b);
         }
         value( sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i], u1 );
         if( sps_svc_ext->vui.vui_ext_vcl_hrd_parameters_present_flag[i] )
         {
-            structure(hrd_parameters)(&sps_svc_ext->hrd_nal, b);
+            structure(hrd_parameters)(&sps_svc_ext->hrd_nal[i], b);
         }
         
         if( sps_svc_ext->vui.vui_ext_nal_hrd_parameters_present_flag[i] ||
@@ -740,7 +779,7 @@ void structure(pic_parameter_set_rbsp)(h264_stream_t* h, bs_t* b)
     if( is_reading ) { have_more_data = more_rbsp_data(b); }
     if( is_writing )
     {
-        have_more_data = pps->transform_8x8_mode_flag | pps->pic_scaling_matrix_present_flag | pps->second_chroma_qp_index_offset != 0;
+        have_more_data = pps->transform_8x8_mode_flag || pps->pic_scaling_matrix_present_flag || pps->second_chroma_qp_index_offset != 0;
     }
 
     if( have_more_data )
@@ -772,7 +811,8 @@ void structure(pic_parameter_set_rbsp)(h264_stream_t* h, bs_t* b)
 
     if( is_reading )
     {
-        memcpy(h->pps_table[pps->pic_parameter_set_id], h->pps, sizeof(pps_t));
+        pps_t* slot = h264_pps_slot(h, pps->pic_parameter_set_id);
+        if( slot != NULL ) { memcpy(slot, h->pps, sizeof(pps_t)); }
     }
 }
 
@@ -782,16 +822,11 @@ void structure(sei_rbsp)(h264_stream_t* h, bs_t* b)
 {
     if( is_reading )
     {
-        for( int i = 0; i < h->num_seis; i++ )
-        {
-            sei_free(h->seis[i]);
-        }
-    
+        // the messages of the previous SEI are reused, with their payload storage
         h->num_seis = 0;
         do {
             h->num_seis++;
-            h->seis = (sei_t**)realloc(h->seis, h->num_seis * sizeof(sei_t*));
-            h->seis[h->num_seis - 1] = sei_new();
+            sei_pool_reserve(h, h->num_seis);
             h->sei = h->seis[h->num_seis - 1];
             structure(sei_message)(h, b);
         } while( more_rbsp_data(b) );
@@ -863,13 +898,31 @@ void structure(slice_layer_rbsp)(h264_stream_t* h,  bs_t* b)
     if ( slice_data != NULL )
     {
         if ( slice_data->rbsp_buf != NULL ) free( slice_data->rbsp_buf ); 
-        uint8_t *sptr = b->p + (!!b->bits_left); // CABAC-specific: skip alignment bits, if there are any
-        slice_data->rbsp_size = b->end - sptr;
-        
-        slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
-        memcpy( slice_data->rbsp_buf, sptr, slice_data->rbsp_size );
-        // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
-        return;
+        bs_t bs_tmp;
+        bs_clone(&bs_tmp, b);
+        bs_skip_u(&bs_tmp, bs_tmp.bits_left); // CABAC-specific: skip alignment bits, if there are any
+        slice_data->rbsp_size = bs_tmp.end - bs_tmp.p;
+
+        if ( slice_data->rbsp_size > 0 && is_reading && ( is_skipping || h->parse_depth < H264_PARSE_SLICE_DATA ) )
+        {
+            // only the headers were asked for, leave the payload unread
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+            return;
+        }
+        else if ( slice_data->rbsp_size > 0 )
+        {
+            slice_data->rbsp_buf = (uint8_t*)malloc(slice_data->rbsp_size);
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, slice_data->rbsp_size );
+            // ugly hack: since next NALU starts at byte border, we are going to be padded by trailing_bits;
+            return;
+        }
+        else
+        {
+            slice_data->rbsp_buf = NULL;
+            slice_data->rbsp_size = 0;
+        }
     }
 
     // FIXME should read or skip data
@@ -948,8 +1001,28 @@ void structure(slice_header)(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_t* sps = h->sps;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(h->sps, h->sps_table[pps->seq_parameter_set_id], sizeof(sps_t));
+    if( is_reading )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h264_activate_pps(h, sh->pic_parameter_set_id);
+        h264_activate_sps(h, pps->seq_parameter_set_id);
+    }
+    else
+    {
+        // always copies, h->pps and h->sps may have been changed by hand; the hashes follow, for the next read
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+        sps_t* sps_slot = h264_sps_slot(h, pps->seq_parameter_set_id);
+        if( sps_slot != NULL )
+        {
+            memcpy(h->sps, sps_slot, sizeof(sps_t));
+            h->sps_hash = h->sps_table_hash[pps->seq_parameter_set_id];
+        }
+    }
 
     if (sps->residual_colour_transform_flag)
     {
@@ -1107,7 +1180,7 @@ void structure(pred_weight_table)(h264_stream_t* h, bs_t* b)
     int i, j;
 
     value( sh->pwt.luma_log2_weight_denom, ue );
-    if( sps->chroma_format_idc != 0 )
+    if( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
     {
         value( sh->pwt.chroma_log2_weight_denom, ue );
     }
@@ -1119,7 +1192,7 @@ void structure(pred_weight_table)(h264_stream_t* h, bs_t* b)
             value( sh->pwt.luma_weight_l0[ i ], se );
             value( sh->pwt.luma_offset_l0[ i ], se );
         }
-        if ( sps->chroma_format_idc != 0 )
+        if ( sps->chroma_format_idc != 0 ) //FIXME ChromaArrayType may differ from chroma_format_idc
         {
             value( sh->pwt.chroma_weight_l0_flag[i], u1 );
             if( sh->pwt.chroma_weight_l0_flag[i] )
@@ -1222,10 +1295,23 @@ void structure(slice_header_in_scalable_extension)(h264_stream_t* h, bs_t* b)
     // TODO check existence, otherwise fail
     pps_t* pps = h->pps;
     sps_subset_t* sps_subset = h->sps_subset;
-    memcpy(h->pps, h->pps_table[sh->pic_parameter_set_id], sizeof(pps_t));
-    memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
-    //memcpy(h->sps_subset->sps, h->sps_subset_table[pps->seq_parameter_set_id]->sps, sizeof(sps_t));
-    //memcpy(h->sps_subset->sps_svc_ext, h->sps_subset_table[pps->seq_parameter_set_id]->sps_svc_ext, sizeof(sps_svc_ext_t));
+    if( is_reading ) { h264_activate_pps(h, sh->pic_parameter_set_id); }
+    else
+    {
+        pps_t* pps_slot = h264_pps_slot(h, sh->pic_parameter_set_id);
+        if( pps_slot != NULL )
+        {
+            memcpy(h->pps, pps_slot, sizeof(pps_t));
+            h->pps_hash = h->pps_table_hash[sh->pic_parameter_set_id];
+        }
+    }
+    //memcpy(sps_subset, h->sps_subset_table[pps->seq_parameter_set_id], sizeof(sps_subset_t));
+    sps_subset_t* sps_subset_slot = h264_sps_subset_slot(h, pps->seq_parameter_set_id);
+    if( sps_subset_slot != NULL )
+    {
+        memcpy(sps_subset->sps, sps_subset_slot->sps, sizeof(sps_t));
+        memcpy(sps_subset->sps_svc_ext, sps_subset_slot->sps_svc_ext, sizeof(sps_svc_ext_t));
+    }
     
     if (sps_subset->sps->residual_colour_transform_flag)
     {
@@ -1309,7 +1395,7 @@ void structure(slice_header_in_scalable_extension)(h264_stream_t* h, bs_t* b)
                 if( ( nal->nal_svc_ext->use_ref_base_pic_flag || sh_svc_ext->store_ref_base_pic_flag ) &&
                    ( nal->nal_unit_type != 5 ) )
                 {
-                    structure(dec_ref_base_pic_marking)(h, b);
+                    structure(dec_ref_base_pic_marking)(nal, b);
                 }
             }
         }
@@ -0,0 +1,4425 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ * Copyright (C) 2005-2007 Auroras Entertainment, LLC
+ * Copyright (C) 2008-2011 Avail-TVN
+ * Copyright (C) 2012 Alex Izvorski
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "bs.h"
+#include "h264_stream.h"
+#include "h264_sei.h"
+#include "h265_stream.h"
+
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
+
+// shared with h264_stream.c
+int intlog2(int x);
+int more_rbsp_data(bs_t* bs);
+int _read_ff_coded_number(bs_t* b);
+void _write_ff_coded_number(bs_t* b, int n);
+
+// everything h265_new() allocates, in a single block; h comes first so that free(h) frees it
+typedef struct
+{
+    h265_stream_t h;
+    h265_nal_t nal;
+    h265_vps_t vps;
+    h265_sps_t sps;
+    h265_pps_t pps;
+    h265_aud_t aud;
+    h265_slice_header_t sh;
+    slice_data_rbsp_t slice_data;
+} h265_stream_block_t;
+
+/**
+ Create a new H265 stream object.  It reads headers only (H265_PARSE_HEADERS) until parse_depth is changed.
+ @return    the stream object
+ */
+h265_stream_t* h265_new()
+{
+    h265_stream_block_t* blk = (h265_stream_block_t*)calloc(1, sizeof(h265_stream_block_t));
+    if (blk == NULL) { return NULL; }
+    h265_stream_t* h = &blk->h;
+
+    h->nal = &blk->nal;
+    h->vps = &blk->vps;
+    h->sps = &blk->sps;
+    h->pps = &blk->pps;
+    h->aud = &blk->aud;
+    h->sh = &blk->sh;
+    h->slice_data = &blk->slice_data;
+    h->parse_depth = H265_PARSE_HEADERS;
+
+    return h;
+}
+
+/**
+ Free an existing H265 stream object.  Frees all contained structures.
+ @param[in,out] h   the stream object
+ */
+void h265_free(h265_stream_t* h)
+{
+    for (int i = 0; i < h->sei_pool_size; i++) { sei_free(h->seis[i]); }
+    free(h->seis);
+
+    free(h->slice_data->rbsp_buf);
+
+    for (int i = 0; i < 16; i++) { free(h->vps_table[i]); }
+    for (int i = 0; i < 16; i++) { free(h->sps_table[i]); }
+    for (int i = 0; i < 64; i++) { free(h->pps_table[i]); }
+
+    free(h);
+}
+
+/**
+ Get the VPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      vps_video_parameter_set_id, 0..15
+ */
+h265_vps_t* h265_vps_slot(h265_stream_t* h, int id)
+{
+    if (h->vps_table[id] == NULL) { h->vps_table[id] = (h265_vps_t*)calloc(1, sizeof(h265_vps_t)); }
+    return h->vps_table[id];
+}
+
+/**
+ Get the SPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      sps_seq_parameter_set_id, 0..15
+ */
+h265_sps_t* h265_sps_slot(h265_stream_t* h, int id)
+{
+    if (h->sps_table[id] == NULL) { h->sps_table[id] = (h265_sps_t*)calloc(1, sizeof(h265_sps_t)); }
+    return h->sps_table[id];
+}
+
+/**
+ Get the PPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      pps_pic_parameter_set_id, 0..63
+ */
+h265_pps_t* h265_pps_slot(h265_stream_t* h, int id)
+{
+    if (h->pps_table[id] == NULL) { h->pps_table[id] = (h265_pps_t*)calloc(1, sizeof(h265_pps_t)); }
+    return h->pps_table[id];
+}
+
+/**
+ Make room for n messages in h->seis, reusing the messages left there by the previous SEI, as sei_pool_reserve() does.
+ */
+void h265_sei_pool_reserve(h265_stream_t* h, int n)
+{
+    if ( n <= h->sei_pool_size ) { return; }
+
+    int size = (h->sei_pool_size < 4) ? 4 : h->sei_pool_size * 2;
+    while ( size < n ) { size *= 2; }
+    h->seis = (sei_t**)realloc(h->seis, size * sizeof(sei_t*));
+    for ( int i = h->sei_pool_size; i < size; i++ )
+    {
+        h->seis[i] = sei_new();
+    }
+    h->sei_pool_size = size;
+}
+
+/**
+ Make the SPS stored for an id the current one, copying it to h->sps unless h->sps already holds it.
+ Ids out of range are ignored.
+ */
+void h265_activate_sps(h265_stream_t* h, int id)
+{
+    if (id < 0 || id >= 16) { return; }
+    if (h->sps_hash == 0 || h->sps_hash != h->sps_table_hash[id])
+    {
+        memcpy(h->sps, h265_sps_slot(h, id), sizeof(h265_sps_t));
+        h->sps_hash = h->sps_table_hash[id];
+    }
+}
+
+/**
+ Make the PPS stored for an id the current one, copying it to h->pps unless h->pps already holds it.
+ Ids out of range are ignored.
+ */
+void h265_activate_pps(h265_stream_t* h, int id)
+{
+    if (id < 0 || id >= 64) { return; }
+    if (h->pps_hash == 0 || h->pps_hash != h->pps_table_hash[id])
+    {
+        memcpy(h->pps, h265_pps_slot(h, id), sizeof(h265_pps_t));
+        h->pps_hash = h->pps_table_hash[id];
+    }
+}
+
+/**
+ Check whether a VPS, SPS or PPS NAL has the same bytes as one already in the tables.  If so, that one becomes
+ the current parameter set without the NAL being parsed again.  The tables are searched by hash, since the SPS id
+ comes after the variable length profile_tier_level().
+ @param[in] buf     the whole NAL, as passed to read_h265_nal_unit, of type h->nal->nal_unit_type
+ @return    1 if it is a repeat and has been handled, 0 if it needs to be parsed
+ */
+int h265_ps_resent(h265_stream_t* h, const uint8_t* buf, int size)
+{
+    uint64_t hash = h264_nal_hash(buf, size);
+    int id;
+
+    switch (h->nal->nal_unit_type)
+    {
+        case H265_NAL_UNIT_TYPE_VPS:
+            for (id = 0; id < 16; id++)
+            {
+                if (h->vps_table_hash[id] == hash) { memcpy(h->vps, h->vps_table[id], sizeof(h265_vps_t)); return 1; }
+            }
+            break;
+        case H265_NAL_UNIT_TYPE_SPS:
+            for (id = 0; id < 16; id++)
+            {
+                if (h->sps_table_hash[id] == hash) { h265_activate_sps(h, id); return 1; }
+            }
+            break;
+        case H265_NAL_UNIT_TYPE_PPS:
+            for (id = 0; id < 64; id++)
+            {
+                if (h->pps_table_hash[id] == hash) { h265_activate_pps(h, id); return 1; }
+            }
+            break;
+    }
+    return 0;
+}
+
+/**
+ NumPicTotalCurr (7-55) of the current slice segment header: the reference pictures the picture may use.
+ */
+int h265_num_pic_total_curr(h265_stream_t* h)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    h265_st_ref_pic_set_t* rps = &sh->st_ref_pic_set;
+    int n = 0;
+    int i;
+
+    if (sh->short_term_ref_pic_set_sps_flag && sh->short_term_ref_pic_set_idx < H265_MAX_SHORT_TERM_RPS)
+    {
+        rps = &sps->st_ref_pic_set[ sh->short_term_ref_pic_set_idx ];
+    }
+    for (i = 0; i < rps->NumNegativePics; i++) { n += rps->UsedByCurrPicS0[i]; }
+    for (i = 0; i < rps->NumPositivePics; i++) { n += rps->UsedByCurrPicS1[i]; }
+    for (i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++)
+    {
+        if (i < sh->num_long_term_sps) { n += sps->used_by_curr_pic_lt_sps_flag[ sh->lt_idx_sps[i] % H265_MAX_LONG_TERM_PICS ]; }
+        else { n += sh->used_by_curr_pic_lt_flag[i]; }
+    }
+    return n;
+}
+
+/**
+ Read only the NAL header from a byte buffer.
+ @return unit type if read successfully, or -1 if this doesn't look like a nal
+*/
+int peek_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    bs_t bs;
+    bs_t* b = &bs;
+    bs_init(b, buf, size);
+
+    nal->forbidden_zero_bit = bs_read_f(b,1);
+    nal->nal_unit_type = bs_read_u(b,6);
+    nal->nuh_layer_id = bs_read_u(b,6);
+    nal->nuh_temporal_id_plus1 = bs_read_u(b,3);
+
+    // basic verification, per 7.4.2.2
+    if ( size < 2 || nal->forbidden_zero_bit || nal->nuh_temporal_id_plus1 == 0 ) { return -1; }
+    if ( H265_IS_IRAP(nal->nal_unit_type) && nal->nuh_temporal_id_plus1 != 1 ) { return -1; }
+
+    return nal->nal_unit_type;
+}
+
+// the variables 7.4.8 derives from a short-term reference picture set, (7-61) to (7-64)
+static void h265_st_ref_pic_set_derive(h265_st_ref_pic_set_t* rps, const h265_st_ref_pic_set_t* ref)
+{
+    int i, j, dPoc;
+
+    if (rps->inter_ref_pic_set_prediction_flag)
+    {
+        int deltaRps = (1 - 2 * rps->delta_rps_sign) * (rps->abs_delta_rps_minus1 + 1);
+        int use_delta_flag[H265_MAX_DPB_SIZE + 1];
+
+        // use_delta_flag is 1 when it is not there, which is whenever used_by_curr_pic_flag is 1
+        for (j = 0; j <= ref->NumDeltaPocs; j++) { use_delta_flag[j] = rps->used_by_curr_pic_flag[j] || rps->use_delta_flag[j]; }
+
+        i = 0;
+        for (j = ref->NumPositivePics - 1; j >= 0 && i < H265_MAX_DPB_SIZE; j--)
+        {
+            dPoc = ref->DeltaPocS1[j] + deltaRps;
+            if (dPoc < 0 && use_delta_flag[ref->NumNegativePics + j])
+            {
+                rps->DeltaPocS0[i] = dPoc;
+                rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[ref->NumNegativePics + j];
+            }
+        }
+        if (deltaRps < 0 && use_delta_flag[ref->NumDeltaPocs] && i < H265_MAX_DPB_SIZE)
+        {
+            rps->DeltaPocS0[i] = deltaRps;
+            rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[ref->NumDeltaPocs];
+        }
+        for (j = 0; j < ref->NumNegativePics && i < H265_MAX_DPB_SIZE; j++)
+        {
+            dPoc = ref->DeltaPocS0[j] + deltaRps;
+            if (dPoc < 0 && use_delta_flag[j])
+            {
+                rps->DeltaPocS0[i] = dPoc;
+                rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[j];
+            }
+        }
+        rps->NumNegativePics = i;
+
+        i = 0;
+        for (j = ref->NumNegativePics - 1; j >= 0 && i < H265_MAX_DPB_SIZE; j--)
+        {
+            dPoc = ref->DeltaPocS0[j] + deltaRps;
+            if (dPoc > 0 && use_delta_flag[j])
+            {
+                rps->DeltaPocS1[i] = dPoc;
+                rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[j];
+            }
+        }
+        if (deltaRps > 0 && use_delta_flag[ref->NumDeltaPocs] && i < H265_MAX_DPB_SIZE)
+        {
+            rps->DeltaPocS1[i] = deltaRps;
+            rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[ref->NumDeltaPocs];
+        }
+        for (j = 0; j < ref->NumPositivePics && i < H265_MAX_DPB_SIZE; j++)
+        {
+            dPoc = ref->DeltaPocS1[j] + deltaRps;
+            if (dPoc > 0 && use_delta_flag[ref->NumNegativePics + j])
+            {
+                rps->DeltaPocS1[i] = dPoc;
+                rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[ref->NumNegativePics + j];
+            }
+        }
+        rps->NumPositivePics = i;
+    }
+    else
+    {
+        rps->NumNegativePics = (rps->num_negative_pics < H265_MAX_DPB_SIZE) ? rps->num_negative_pics : H265_MAX_DPB_SIZE;
+        rps->NumPositivePics = (rps->num_positive_pics < H265_MAX_DPB_SIZE) ? rps->num_positive_pics : H265_MAX_DPB_SIZE;
+        for (i = 0; i < rps->NumNegativePics; i++)
+        {
+            rps->DeltaPocS0[i] = ((i == 0) ? 0 : rps->DeltaPocS0[i - 1]) - (rps->delta_poc_s0_minus1[i] + 1);
+            rps->UsedByCurrPicS0[i] = rps->used_by_curr_pic_s0_flag[i];
+        }
+        for (i = 0; i < rps->NumPositivePics; i++)
+        {
+            rps->DeltaPocS1[i] = ((i == 0) ? 0 : rps->DeltaPocS1[i - 1]) + (rps->delta_poc_s1_minus1[i] + 1);
+            rps->UsedByCurrPicS1[i] = rps->used_by_curr_pic_s1_flag[i];
+        }
+    }
+
+    // no more than the DPB holds, so that a set predicted from this one stays within its arrays
+    if (rps->NumNegativePics + rps->NumPositivePics > H265_MAX_DPB_SIZE)
+    {
+        rps->NumPositivePics = H265_MAX_DPB_SIZE - rps->NumNegativePics;
+    }
+    rps->NumDeltaPocs = rps->NumNegativePics + rps->NumPositivePics;
+}
+
+// PicSizeInCtbsY (7-10 to 7-19), slice_segment_address has Ceil( Log2( PicSizeInCtbsY ) ) bits
+static int h265_pic_size_in_ctbs(h265_sps_t* sps)
+{
+    int CtbLog2SizeY = sps->log2_min_luma_coding_block_size_minus3 + 3 + sps->log2_diff_max_min_luma_coding_block_size;
+    if (CtbLog2SizeY < 4 || CtbLog2SizeY > 6) { CtbLog2SizeY = 6; }
+    int CtbSizeY = 1 << CtbLog2SizeY;
+    int PicWidthInCtbsY = (sps->pic_width_in_luma_samples + CtbSizeY - 1) / CtbSizeY;
+    int PicHeightInCtbsY = (sps->pic_height_in_luma_samples + CtbSizeY - 1) / CtbSizeY;
+    return PicWidthInCtbsY * PicHeightInCtbsY;
+}
+
+
+
+void read_h265_nal_unit_header(h265_nal_t* nal, bs_t* b);
+void read_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b);
+void read_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void read_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void read_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b);
+void read_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b);
+void read_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b);
+void read_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b);
+void read_h265_vui_parameters(h265_sps_t* sps, bs_t* b);
+void read_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b);
+void read_h265_sei_rbsp(h265_stream_t* h, bs_t* b);
+void read_h265_sei_message(h265_stream_t* h, bs_t* b);
+void read_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b);
+void read_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b);
+void read_h265_slice_segment_header(h265_stream_t* h, bs_t* b);
+void read_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b);
+void read_h265_pred_weight_table(h265_stream_t* h, bs_t* b);
+void read_h265_rbsp_trailing_bits(bs_t* b);
+void read_h265_byte_alignment(bs_t* b);
+
+
+
+
+//7.3.1.1 General NAL unit syntax
+int read_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    int nal_size = size;
+    int rbsp_size = size;
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
+
+    if( 1 )
+    {
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
+    }
+
+    if( 0 )
+    {
+        rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
+    }
+
+    read_h265_nal_unit_header(nal, b);
+
+    if( 1 && h->parse_depth < H265_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
+    switch ( nal->nal_unit_type )
+    {
+        case H265_NAL_UNIT_TYPE_TRAIL_N:
+        case H265_NAL_UNIT_TYPE_TRAIL_R:
+        case H265_NAL_UNIT_TYPE_TSA_N:
+        case H265_NAL_UNIT_TYPE_TSA_R:
+        case H265_NAL_UNIT_TYPE_STSA_N:
+        case H265_NAL_UNIT_TYPE_STSA_R:
+        case H265_NAL_UNIT_TYPE_RADL_N:
+        case H265_NAL_UNIT_TYPE_RADL_R:
+        case H265_NAL_UNIT_TYPE_RASL_N:
+        case H265_NAL_UNIT_TYPE_RASL_R:
+        case H265_NAL_UNIT_TYPE_BLA_W_LP:
+        case H265_NAL_UNIT_TYPE_BLA_W_RADL:
+        case H265_NAL_UNIT_TYPE_BLA_N_LP:
+        case H265_NAL_UNIT_TYPE_IDR_W_RADL:
+        case H265_NAL_UNIT_TYPE_IDR_N_LP:
+        case H265_NAL_UNIT_TYPE_CRA_NUT:
+            read_h265_slice_segment_layer_rbsp(h, b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_VPS:
+            if( 1 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_h265_video_parameter_set_rbsp(h->vps, b);
+            if( h->vps->incomplete ) { free(rbsp_buf); return -1; }
+            read_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->vps->vps_video_parameter_set_id;
+                memcpy(h265_vps_slot(h, id), h->vps, sizeof(h265_vps_t));
+                h->vps_table_hash[id] = h264_nal_hash(buf, nal_size);
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_SPS:
+            if( 1 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_h265_seq_parameter_set_rbsp(h->sps, b);
+            if( h->sps->incomplete ) { free(rbsp_buf); h->sps_hash = 0; return -1; }
+            read_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->sps->sps_seq_parameter_set_id;
+                if( id >= 16 ) { return -1; }
+                memcpy(h265_sps_slot(h, id), h->sps, sizeof(h265_sps_t));
+                h->sps_hash = h264_nal_hash(buf, nal_size);
+                h->sps_table_hash[id] = h->sps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_PPS:
+            if( 1 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_h265_pic_parameter_set_rbsp(h->pps, b);
+            read_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->pps->pps_pic_parameter_set_id;
+                if( id >= 64 ) { return -1; }
+                memcpy(h265_pps_slot(h, id), h->pps, sizeof(h265_pps_t));
+                h->pps_hash = h264_nal_hash(buf, nal_size);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_AUD:
+            read_h265_access_unit_delimiter_rbsp(h, b);
+            read_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_PREFIX_SEI:
+        case H265_NAL_UNIT_TYPE_SUFFIX_SEI:
+            read_h265_sei_rbsp(h, b);
+            read_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_EOS:
+        case H265_NAL_UNIT_TYPE_EOB:
+            // 7.3.2.6, 7.3.2.7 the rbsp is empty
+            break;
+
+        case H265_NAL_UNIT_TYPE_FD:
+        default:
+            free(rbsp_buf);
+            return -1;
+    }
+
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
+
+    if( 0 )
+    {
+        // now get the actual size used
+        rbsp_size = bs_pos(b);
+
+        int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
+        if (rc < 0) { free(rbsp_buf); return -1; }
+    }
+
+    free(rbsp_buf);
+
+    return nal_size;
+}
+
+//7.3.1.2 NAL unit header syntax
+void read_h265_nal_unit_header(h265_nal_t* nal, bs_t* b)
+{
+    /* forbidden_zero_bit */ bs_skip_u(b, 1);
+    nal->nal_unit_type = bs_read_u(b, 6);
+    nal->nuh_layer_id = bs_read_u(b, 6);
+    nal->nuh_temporal_id_plus1 = bs_read_u(b, 3);
+}
+
+//7.3.2.1 Video parameter set RBSP syntax
+void read_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b)
+{
+    int i, j;
+
+    if( 1 )
+    {
+        memset(vps, 0, sizeof(h265_vps_t));
+    }
+
+    vps->vps_video_parameter_set_id = bs_read_u(b, 4);
+    vps->vps_base_layer_internal_flag = bs_read_u1(b);
+    vps->vps_base_layer_available_flag = bs_read_u1(b);
+    vps->vps_max_layers_minus1 = bs_read_u(b, 6);
+    vps->vps_max_sub_layers_minus1 = bs_read_u(b, 3);
+    vps->vps_temporal_id_nesting_flag = bs_read_u1(b);
+    /* vps_reserved_0xffff_16bits */ bs_skip_u(b, 16);
+    read_h265_profile_tier_level(&vps->ptl, 1, vps->vps_max_sub_layers_minus1, b);
+    vps->vps_sub_layer_ordering_info_present_flag = bs_read_u1(b);
+    for( i = ( vps->vps_sub_layer_ordering_info_present_flag ? 0 : vps->vps_max_sub_layers_minus1 );
+         i <= vps->vps_max_sub_layers_minus1; i++ )
+    {
+        vps->vps_max_dec_pic_buffering_minus1[ i ] = bs_read_ue(b);
+        vps->vps_max_num_reorder_pics[ i ] = bs_read_ue(b);
+        vps->vps_max_latency_increase_plus1[ i ] = bs_read_ue(b);
+    }
+    vps->vps_max_layer_id = bs_read_u(b, 6);
+    vps->vps_num_layer_sets_minus1 = bs_read_ue(b);
+    if( vps->vps_num_layer_sets_minus1 >= H265_MAX_LAYER_SETS )
+    {
+        // not read past here
+        vps->incomplete = 1;
+        return;
+    }
+    for( i = 1; i <= vps->vps_num_layer_sets_minus1; i++ )
+    {
+        for( j = 0; j <= vps->vps_max_layer_id; j++ )
+        {
+            vps->layer_id_included_flag[ i ][ j ] = bs_read_u1(b);
+        }
+    }
+    vps->vps_timing_info_present_flag = bs_read_u1(b);
+    if( vps->vps_timing_info_present_flag )
+    {
+        vps->vps_num_units_in_tick = bs_read_u(b, 32);
+        vps->vps_time_scale = bs_read_u(b, 32);
+        vps->vps_poc_proportional_to_timing_flag = bs_read_u1(b);
+        if( vps->vps_poc_proportional_to_timing_flag )
+        {
+            vps->vps_num_ticks_poc_diff_one_minus1 = bs_read_ue(b);
+        }
+        vps->vps_num_hrd_parameters = bs_read_ue(b);
+        if( vps->vps_num_hrd_parameters > H265_MAX_VPS_HRD )
+        {
+            // not read past here
+            vps->incomplete = 1;
+            return;
+        }
+        for( i = 0; i < vps->vps_num_hrd_parameters; i++ )
+        {
+            vps->hrd_layer_set_idx[ i ] = bs_read_ue(b);
+            if( i > 0 )
+            {
+                vps->cprms_present_flag[ i ] = bs_read_u1(b);
+            }
+            else if( 1 )
+            {
+                vps->cprms_present_flag[ i ] = 1;
+            }
+            read_h265_hrd_parameters(&vps->hrd[ i ], vps->cprms_present_flag[ i ], vps->vps_max_sub_layers_minus1, b);
+        }
+    }
+    vps->vps_extension_flag = bs_read_u1(b);
+    // vps_extension_data_flag (multilayer and 3D) is not read
+}
+
+//7.3.3 Profile, tier and level syntax
+void read_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i, j;
+
+    if( profilePresentFlag )
+    {
+        ptl->general_profile_space = bs_read_u(b, 2);
+        ptl->general_tier_flag = bs_read_u1(b);
+        ptl->general_profile_idc = bs_read_u(b, 5);
+        for( j = 0; j < 32; j++ )
+        {
+            ptl->general_profile_compatibility_flag[ j ] = bs_read_u1(b);
+        }
+        ptl->general_progressive_source_flag = bs_read_u1(b);
+        ptl->general_interlaced_source_flag = bs_read_u1(b);
+        ptl->general_non_packed_constraint_flag = bs_read_u1(b);
+        ptl->general_frame_only_constraint_flag = bs_read_u1(b);
+        ptl->general_reserved_zero_44bits[ 0 ] = bs_read_u(b, 32);
+        ptl->general_reserved_zero_44bits[ 1 ] = bs_read_u(b, 12);
+    }
+    ptl->general_level_idc = bs_read_u8(b);
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        ptl->sub_layer_profile_present_flag[ i ] = bs_read_u1(b);
+        ptl->sub_layer_level_present_flag[ i ] = bs_read_u1(b);
+    }
+    if( maxNumSubLayersMinus1 > 0 )
+    {
+        for( i = maxNumSubLayersMinus1; i < 8; i++ )
+        {
+            /* reserved_zero_2bits */ bs_skip_u(b, 2);
+        }
+    }
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        if( ptl->sub_layer_profile_present_flag[ i ] )
+        {
+            ptl->sub_layer[ i ].sub_layer_profile_space = bs_read_u(b, 2);
+            ptl->sub_layer[ i ].sub_layer_tier_flag = bs_read_u1(b);
+            ptl->sub_layer[ i ].sub_layer_profile_idc = bs_read_u(b, 5);
+            for( j = 0; j < 32; j++ )
+            {
+                ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ] = bs_read_u1(b);
+            }
+            ptl->sub_layer[ i ].sub_layer_progressive_source_flag = bs_read_u1(b);
+            ptl->sub_layer[ i ].sub_layer_interlaced_source_flag = bs_read_u1(b);
+            ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag = bs_read_u1(b);
+            ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag = bs_read_u1(b);
+            ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ] = bs_read_u(b, 32);
+            ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ] = bs_read_u(b, 12);
+        }
+        if( ptl->sub_layer_level_present_flag[ i ] )
+        {
+            ptl->sub_layer[ i ].sub_layer_level_idc = bs_read_u8(b);
+        }
+    }
+}
+
+//E.2.2 HRD parameters syntax
+void read_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i;
+
+    if( commonInfPresentFlag )
+    {
+        hrd->nal_hrd_parameters_present_flag = bs_read_u1(b);
+        hrd->vcl_hrd_parameters_present_flag = bs_read_u1(b);
+        if( hrd->nal_hrd_parameters_present_flag || hrd->vcl_hrd_parameters_present_flag )
+        {
+            hrd->sub_pic_hrd_params_present_flag = bs_read_u1(b);
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                hrd->tick_divisor_minus2 = bs_read_u8(b);
+                hrd->du_cpb_removal_delay_increment_length_minus1 = bs_read_u(b, 5);
+                hrd->sub_pic_cpb_params_in_pic_timing_sei_flag = bs_read_u1(b);
+                hrd->dpb_output_delay_du_length_minus1 = bs_read_u(b, 5);
+            }
+            hrd->bit_rate_scale = bs_read_u(b, 4);
+            hrd->cpb_size_scale = bs_read_u(b, 4);
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                hrd->cpb_size_du_scale = bs_read_u(b, 4);
+            }
+            hrd->initial_cpb_removal_delay_length_minus1 = bs_read_u(b, 5);
+            hrd->au_cpb_removal_delay_length_minus1 = bs_read_u(b, 5);
+            hrd->dpb_output_delay_length_minus1 = bs_read_u(b, 5);
+        }
+    }
+    for( i = 0; i <= maxNumSubLayersMinus1; i++ )
+    {
+        hrd->fixed_pic_rate_general_flag[ i ] = bs_read_u1(b);
+        if( 1 )
+        {
+            hrd->fixed_pic_rate_within_cvs_flag[ i ] = hrd->fixed_pic_rate_general_flag[ i ];
+            hrd->low_delay_hrd_flag[ i ] = 0;
+            hrd->cpb_cnt_minus1[ i ] = 0;
+        }
+        if( !hrd->fixed_pic_rate_general_flag[ i ] )
+        {
+            hrd->fixed_pic_rate_within_cvs_flag[ i ] = bs_read_u1(b);
+        }
+        if( hrd->fixed_pic_rate_within_cvs_flag[ i ] )
+        {
+            hrd->elemental_duration_in_tc_minus1[ i ] = bs_read_ue(b);
+        }
+        else
+        {
+            hrd->low_delay_hrd_flag[ i ] = bs_read_u1(b);
+        }
+        if( !hrd->low_delay_hrd_flag[ i ] )
+        {
+            hrd->cpb_cnt_minus1[ i ] = bs_read_ue(b);
+        }
+        if( hrd->nal_hrd_parameters_present_flag )
+        {
+            read_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_nal[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+        if( hrd->vcl_hrd_parameters_present_flag )
+        {
+            read_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_vcl[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+    }
+}
+
+//E.2.3 Sub-layer HRD parameters syntax
+void read_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b)
+{
+    int i;
+
+    for( i = 0; i <= cpb_cnt_minus1 && i < H265_MAX_CPB_CNT; i++ )
+    {
+        sub->bit_rate_value_minus1[ i ] = bs_read_ue(b);
+        sub->cpb_size_value_minus1[ i ] = bs_read_ue(b);
+        if( sub_pic_hrd_params_present_flag )
+        {
+            sub->cpb_size_du_value_minus1[ i ] = bs_read_ue(b);
+            sub->bit_rate_du_value_minus1[ i ] = bs_read_ue(b);
+        }
+        sub->cbr_flag[ i ] = bs_read_u1(b);
+    }
+}
+
+//7.3.2.2.1 General sequence parameter set RBSP syntax
+void read_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b)
+{
+    int i;
+
+    if( 1 )
+    {
+        memset(sps, 0, sizeof(h265_sps_t));
+    }
+
+    sps->sps_video_parameter_set_id = bs_read_u(b, 4);
+    sps->sps_max_sub_layers_minus1 = bs_read_u(b, 3);
+    sps->sps_temporal_id_nesting_flag = bs_read_u1(b);
+    read_h265_profile_tier_level(&sps->ptl, 1, sps->sps_max_sub_layers_minus1, b);
+    sps->sps_seq_parameter_set_id = bs_read_ue(b);
+    sps->chroma_format_idc = bs_read_ue(b);
+    if( sps->chroma_format_idc == 3 )
+    {
+        sps->separate_colour_plane_flag = bs_read_u1(b);
+    }
+    sps->pic_width_in_luma_samples = bs_read_ue(b);
+    sps->pic_height_in_luma_samples = bs_read_ue(b);
+    sps->conformance_window_flag = bs_read_u1(b);
+    if( sps->conformance_window_flag )
+    {
+        sps->conf_win_left_offset = bs_read_ue(b);
+        sps->conf_win_right_offset = bs_read_ue(b);
+        sps->conf_win_top_offset = bs_read_ue(b);
+        sps->conf_win_bottom_offset = bs_read_ue(b);
+    }
+    sps->bit_depth_luma_minus8 = bs_read_ue(b);
+    sps->bit_depth_chroma_minus8 = bs_read_ue(b);
+    sps->log2_max_pic_order_cnt_lsb_minus4 = bs_read_ue(b);
+    sps->sps_sub_layer_ordering_info_present_flag = bs_read_u1(b);
+    for( i = ( sps->sps_sub_layer_ordering_info_present_flag ? 0 : sps->sps_max_sub_layers_minus1 );
+         i <= sps->sps_max_sub_layers_minus1; i++ )
+    {
+        sps->sps_max_dec_pic_buffering_minus1[ i ] = bs_read_ue(b);
+        sps->sps_max_num_reorder_pics[ i ] = bs_read_ue(b);
+        sps->sps_max_latency_increase_plus1[ i ] = bs_read_ue(b);
+    }
+    sps->log2_min_luma_coding_block_size_minus3 = bs_read_ue(b);
+    sps->log2_diff_max_min_luma_coding_block_size = bs_read_ue(b);
+    sps->log2_min_luma_transform_block_size_minus2 = bs_read_ue(b);
+    sps->log2_diff_max_min_luma_transform_block_size = bs_read_ue(b);
+    sps->max_transform_hierarchy_depth_inter = bs_read_ue(b);
+    sps->max_transform_hierarchy_depth_intra = bs_read_ue(b);
+    sps->scaling_list_enabled_flag = bs_read_u1(b);
+    if( sps->scaling_list_enabled_flag )
+    {
+        sps->sps_scaling_list_data_present_flag = bs_read_u1(b);
+        if( sps->sps_scaling_list_data_present_flag )
+        {
+            read_h265_scaling_list_data(&sps->scaling_list, b);
+        }
+    }
+    sps->amp_enabled_flag = bs_read_u1(b);
+    sps->sample_adaptive_offset_enabled_flag = bs_read_u1(b);
+    sps->pcm_enabled_flag = bs_read_u1(b);
+    if( sps->pcm_enabled_flag )
+    {
+        sps->pcm_sample_bit_depth_luma_minus1 = bs_read_u(b, 4);
+        sps->pcm_sample_bit_depth_chroma_minus1 = bs_read_u(b, 4);
+        sps->log2_min_pcm_luma_coding_block_size_minus3 = bs_read_ue(b);
+        sps->log2_diff_max_min_pcm_luma_coding_block_size = bs_read_ue(b);
+        sps->pcm_loop_filter_disabled_flag = bs_read_u1(b);
+    }
+    sps->num_short_term_ref_pic_sets = bs_read_ue(b);
+    if( sps->num_short_term_ref_pic_sets > H265_MAX_SHORT_TERM_RPS )
+    {
+        // not read past here
+        sps->incomplete = 1;
+        return;
+    }
+    for( i = 0; i < sps->num_short_term_ref_pic_sets; i++ )
+    {
+        read_h265_st_ref_pic_set(&sps->st_ref_pic_set[ i ], sps->st_ref_pic_set, i, sps->num_short_term_ref_pic_sets, b);
+    }
+    sps->long_term_ref_pics_present_flag = bs_read_u1(b);
+    if( sps->long_term_ref_pics_present_flag )
+    {
+        sps->num_long_term_ref_pics_sps = bs_read_ue(b);
+        for( i = 0; i < sps->num_long_term_ref_pics_sps && i < H265_MAX_LONG_TERM_PICS; i++ )
+        {
+            sps->lt_ref_pic_poc_lsb_sps[ i ] = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 );
+            sps->used_by_curr_pic_lt_sps_flag[ i ] = bs_read_u1(b);
+        }
+    }
+    sps->sps_temporal_mvp_enabled_flag = bs_read_u1(b);
+    sps->strong_intra_smoothing_enabled_flag = bs_read_u1(b);
+    sps->vui_parameters_present_flag = bs_read_u1(b);
+    if( sps->vui_parameters_present_flag )
+    {
+        read_h265_vui_parameters(sps, b);
+    }
+    sps->sps_extension_present_flag = bs_read_u1(b);
+    if( sps->sps_extension_present_flag )
+    {
+        sps->sps_range_extension_flag = bs_read_u1(b);
+        sps->sps_multilayer_extension_flag = bs_read_u1(b);
+        sps->sps_3d_extension_flag = bs_read_u1(b);
+        sps->sps_scc_extension_flag = bs_read_u1(b);
+        sps->sps_extension_4bits = bs_read_u(b, 4);
+    }
+    if( sps->sps_range_extension_flag )
+    {
+        sps->transform_skip_rotation_enabled_flag = bs_read_u1(b);
+        sps->transform_skip_context_enabled_flag = bs_read_u1(b);
+        sps->implicit_rdpcm_enabled_flag = bs_read_u1(b);
+        sps->explicit_rdpcm_enabled_flag = bs_read_u1(b);
+        sps->extended_precision_processing_flag = bs_read_u1(b);
+        sps->intra_smoothing_disabled_flag = bs_read_u1(b);
+        sps->high_precision_offsets_enabled_flag = bs_read_u1(b);
+        sps->persistent_rice_adaptation_enabled_flag = bs_read_u1(b);
+        sps->cabac_bypass_alignment_enabled_flag = bs_read_u1(b);
+    }
+    // the multilayer, 3D and SCC extensions and sps_extension_data_flag are not read
+}
+
+//7.3.4 Scaling list data syntax
+void read_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b)
+{
+    int sizeId, matrixId, i;
+    int scaling_list_delta_coef;
+
+    for( sizeId = 0; sizeId < 4; sizeId++ )
+    {
+        for( matrixId = 0; matrixId < 6; matrixId += ( sizeId == 3 ) ? 3 : 1 )
+        {
+            sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] = bs_read_u1(b);
+            if( !sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] )
+            {
+                sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ] = bs_read_ue(b);
+            }
+            else
+            {
+                int nextCoef = 8;
+                int coefNum = ( sizeId == 0 ) ? 16 : 64;
+                if( sizeId > 1 )
+                {
+                    sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] = bs_read_se(b);
+                    nextCoef = sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] + 8;
+                }
+                for( i = 0; i < coefNum; i++ )
+                {
+                    if( 0 )
+                    {
+                        // any difference that comes out the same modulo 256 will do, take the one in -128..127
+                        scaling_list_delta_coef = ( ( sl->ScalingList[ sizeId ][ matrixId ][ i ] - nextCoef + 128 ) & 255 ) - 128;
+                    }
+                    scaling_list_delta_coef = bs_read_se(b);
+                    nextCoef = ( nextCoef + scaling_list_delta_coef + 256 ) % 256;
+                    if( 1 )
+                    {
+                        sl->ScalingList[ sizeId ][ matrixId ][ i ] = nextCoef;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//7.3.7 Short-term reference picture set syntax
+void read_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b)
+{
+    int i, j;
+
+    if( 1 )
+    {
+        memset(rps, 0, sizeof(h265_st_ref_pic_set_t));
+    }
+
+    if( stRpsIdx != 0 )
+    {
+        rps->inter_ref_pic_set_prediction_flag = bs_read_u1(b);
+    }
+    if( rps->inter_ref_pic_set_prediction_flag )
+    {
+        if( stRpsIdx == num_short_term_ref_pic_sets )
+        {
+            rps->delta_idx_minus1 = bs_read_ue(b);
+        }
+        rps->delta_rps_sign = bs_read_u1(b);
+        rps->abs_delta_rps_minus1 = bs_read_ue(b);
+
+        int RefRpsIdx = stRpsIdx - ( rps->delta_idx_minus1 + 1 );
+        if( RefRpsIdx < 0 || RefRpsIdx >= H265_MAX_SHORT_TERM_RPS ) { RefRpsIdx = 0; }
+        h265_st_ref_pic_set_t* ref = &sets[ RefRpsIdx ];
+
+        for( j = 0; j <= ref->NumDeltaPocs; j++ )
+        {
+            rps->used_by_curr_pic_flag[ j ] = bs_read_u1(b);
+            if( !rps->used_by_curr_pic_flag[ j ] )
+            {
+                rps->use_delta_flag[ j ] = bs_read_u1(b);
+            }
+        }
+        h265_st_ref_pic_set_derive(rps, ref);
+    }
+    else
+    {
+        rps->num_negative_pics = bs_read_ue(b);
+        rps->num_positive_pics = bs_read_ue(b);
+        for( i = 0; i < rps->num_negative_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            rps->delta_poc_s0_minus1[ i ] = bs_read_ue(b);
+            rps->used_by_curr_pic_s0_flag[ i ] = bs_read_u1(b);
+        }
+        for( i = 0; i < rps->num_positive_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            rps->delta_poc_s1_minus1[ i ] = bs_read_ue(b);
+            rps->used_by_curr_pic_s1_flag[ i ] = bs_read_u1(b);
+        }
+        h265_st_ref_pic_set_derive(rps, NULL);
+    }
+}
+
+//E.2.1 VUI parameters syntax
+void read_h265_vui_parameters(h265_sps_t* sps, bs_t* b)
+{
+    sps->vui.aspect_ratio_info_present_flag = bs_read_u1(b);
+    if( sps->vui.aspect_ratio_info_present_flag )
+    {
+        sps->vui.aspect_ratio_idc = bs_read_u8(b);
+        if( sps->vui.aspect_ratio_idc == SAR_Extended )
+        {
+            sps->vui.sar_width = bs_read_u(b, 16);
+            sps->vui.sar_height = bs_read_u(b, 16);
+        }
+    }
+    sps->vui.overscan_info_present_flag = bs_read_u1(b);
+    if( sps->vui.overscan_info_present_flag )
+    {
+        sps->vui.overscan_appropriate_flag = bs_read_u1(b);
+    }
+    sps->vui.video_signal_type_present_flag = bs_read_u1(b);
+    if( sps->vui.video_signal_type_present_flag )
+    {
+        sps->vui.video_format = bs_read_u(b, 3);
+        sps->vui.video_full_range_flag = bs_read_u1(b);
+        sps->vui.colour_description_present_flag = bs_read_u1(b);
+        if( sps->vui.colour_description_present_flag )
+        {
+            sps->vui.colour_primaries = bs_read_u8(b);
+            sps->vui.transfer_characteristics = bs_read_u8(b);
+            sps->vui.matrix_coeffs = bs_read_u8(b);
+        }
+    }
+    sps->vui.chroma_loc_info_present_flag = bs_read_u1(b);
+    if( sps->vui.chroma_loc_info_present_flag )
+    {
+        sps->vui.chroma_sample_loc_type_top_field = bs_read_ue(b);
+        sps->vui.chroma_sample_loc_type_bottom_field = bs_read_ue(b);
+    }
+    sps->vui.neutral_chroma_indication_flag = bs_read_u1(b);
+    sps->vui.field_seq_flag = bs_read_u1(b);
+    sps->vui.frame_field_info_present_flag = bs_read_u1(b);
+    sps->vui.default_display_window_flag = bs_read_u1(b);
+    if( sps->vui.default_display_window_flag )
+    {
+        sps->vui.def_disp_win_left_offset = bs_read_ue(b);
+        sps->vui.def_disp_win_right_offset = bs_read_ue(b);
+        sps->vui.def_disp_win_top_offset = bs_read_ue(b);
+        sps->vui.def_disp_win_bottom_offset = bs_read_ue(b);
+    }
+    sps->vui.vui_timing_info_present_flag = bs_read_u1(b);
+    if( sps->vui.vui_timing_info_present_flag )
+    {
+        sps->vui.vui_num_units_in_tick = bs_read_u(b, 32);
+        sps->vui.vui_time_scale = bs_read_u(b, 32);
+        sps->vui.vui_poc_proportional_to_timing_flag = bs_read_u1(b);
+        if( sps->vui.vui_poc_proportional_to_timing_flag )
+        {
+            sps->vui.vui_num_ticks_poc_diff_one_minus1 = bs_read_ue(b);
+        }
+        sps->vui.vui_hrd_parameters_present_flag = bs_read_u1(b);
+        if( sps->vui.vui_hrd_parameters_present_flag )
+        {
+            read_h265_hrd_parameters(&sps->hrd, 1, sps->sps_max_sub_layers_minus1, b);
+        }
+    }
+    sps->vui.bitstream_restriction_flag = bs_read_u1(b);
+    if( sps->vui.bitstream_restriction_flag )
+    {
+        sps->vui.tiles_fixed_structure_flag = bs_read_u1(b);
+        sps->vui.motion_vectors_over_pic_boundaries_flag = bs_read_u1(b);
+        sps->vui.restricted_ref_pic_lists_flag = bs_read_u1(b);
+        sps->vui.min_spatial_segmentation_idc = bs_read_ue(b);
+        sps->vui.max_bytes_per_pic_denom = bs_read_ue(b);
+        sps->vui.max_bits_per_min_cu_denom = bs_read_ue(b);
+        sps->vui.log2_max_mv_length_horizontal = bs_read_ue(b);
+        sps->vui.log2_max_mv_length_vertical = bs_read_ue(b);
+    }
+}
+
+//7.3.2.3.1 General picture parameter set RBSP syntax
+void read_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b)
+{
+    int i;
+
+    if( 1 )
+    {
+        memset(pps, 0, sizeof(h265_pps_t));
+        pps->uniform_spacing_flag = 1;
+        pps->loop_filter_across_tiles_enabled_flag = 1;
+    }
+
+    pps->pps_pic_parameter_set_id = bs_read_ue(b);
+    pps->pps_seq_parameter_set_id = bs_read_ue(b);
+    pps->dependent_slice_segments_enabled_flag = bs_read_u1(b);
+    pps->output_flag_present_flag = bs_read_u1(b);
+    pps->num_extra_slice_header_bits = bs_read_u(b, 3);
+    pps->sign_data_hiding_enabled_flag = bs_read_u1(b);
+    pps->cabac_init_present_flag = bs_read_u1(b);
+    pps->num_ref_idx_l0_default_active_minus1 = bs_read_ue(b);
+    pps->num_ref_idx_l1_default_active_minus1 = bs_read_ue(b);
+    pps->init_qp_minus26 = bs_read_se(b);
+    pps->constrained_intra_pred_flag = bs_read_u1(b);
+    pps->transform_skip_enabled_flag = bs_read_u1(b);
+    pps->cu_qp_delta_enabled_flag = bs_read_u1(b);
+    if( pps->cu_qp_delta_enabled_flag )
+    {
+        pps->diff_cu_qp_delta_depth = bs_read_ue(b);
+    }
+    pps->pps_cb_qp_offset = bs_read_se(b);
+    pps->pps_cr_qp_offset = bs_read_se(b);
+    pps->pps_slice_chroma_qp_offsets_present_flag = bs_read_u1(b);
+    pps->weighted_pred_flag = bs_read_u1(b);
+    pps->weighted_bipred_flag = bs_read_u1(b);
+    pps->transquant_bypass_enabled_flag = bs_read_u1(b);
+    pps->tiles_enabled_flag = bs_read_u1(b);
+    pps->entropy_coding_sync_enabled_flag = bs_read_u1(b);
+    if( pps->tiles_enabled_flag )
+    {
+        pps->num_tile_columns_minus1 = bs_read_ue(b);
+        pps->num_tile_rows_minus1 = bs_read_ue(b);
+        pps->uniform_spacing_flag = bs_read_u1(b);
+        if( !pps->uniform_spacing_flag )
+        {
+            for( i = 0; i < pps->num_tile_columns_minus1 && i < H265_MAX_TILE_COLUMNS; i++ )
+            {
+                pps->column_width_minus1[ i ] = bs_read_ue(b);
+            }
+            for( i = 0; i < pps->num_tile_rows_minus1 && i < H265_MAX_TILE_ROWS; i++ )
+            {
+                pps->row_height_minus1[ i ] = bs_read_ue(b);
+            }
+        }
+        pps->loop_filter_across_tiles_enabled_flag = bs_read_u1(b);
+    }
+    pps->pps_loop_filter_across_slices_enabled_flag = bs_read_u1(b);
+    pps->deblocking_filter_control_present_flag = bs_read_u1(b);
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        pps->deblocking_filter_override_enabled_flag = bs_read_u1(b);
+        pps->pps_deblocking_filter_disabled_flag = bs_read_u1(b);
+        if( !pps->pps_deblocking_filter_disabled_flag )
+        {
+            pps->pps_beta_offset_div2 = bs_read_se(b);
+            pps->pps_tc_offset_div2 = bs_read_se(b);
+        }
+    }
+    pps->pps_scaling_list_data_present_flag = bs_read_u1(b);
+    if( pps->pps_scaling_list_data_present_flag )
+    {
+        read_h265_scaling_list_data(&pps->scaling_list, b);
+    }
+    pps->lists_modification_present_flag = bs_read_u1(b);
+    pps->log2_parallel_merge_level_minus2 = bs_read_ue(b);
+    pps->slice_segment_header_extension_present_flag = bs_read_u1(b);
+    pps->pps_extension_present_flag = bs_read_u1(b);
+    if( pps->pps_extension_present_flag )
+    {
+        pps->pps_range_extension_flag = bs_read_u1(b);
+        pps->pps_multilayer_extension_flag = bs_read_u1(b);
+        pps->pps_3d_extension_flag = bs_read_u1(b);
+        pps->pps_scc_extension_flag = bs_read_u1(b);
+        pps->pps_extension_4bits = bs_read_u(b, 4);
+    }
+    if( pps->pps_range_extension_flag )
+    {
+        if( pps->transform_skip_enabled_flag )
+        {
+            pps->log2_max_transform_skip_block_size_minus2 = bs_read_ue(b);
+        }
+        pps->cross_component_prediction_enabled_flag = bs_read_u1(b);
+        pps->chroma_qp_offset_list_enabled_flag = bs_read_u1(b);
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            pps->diff_cu_chroma_qp_offset_depth = bs_read_ue(b);
+            pps->chroma_qp_offset_list_len_minus1 = bs_read_ue(b);
+            for( i = 0; i <= pps->chroma_qp_offset_list_len_minus1 && i < 6; i++ )
+            {
+                pps->cb_qp_offset_list[ i ] = bs_read_se(b);
+                pps->cr_qp_offset_list[ i ] = bs_read_se(b);
+            }
+        }
+        pps->log2_sao_offset_scale_luma = bs_read_ue(b);
+        pps->log2_sao_offset_scale_chroma = bs_read_ue(b);
+    }
+    // the multilayer, 3D and SCC extensions and pps_extension_data_flag are not read
+}
+
+//7.3.2.4 Supplemental enhancement information RBSP syntax
+void read_h265_sei_rbsp(h265_stream_t* h, bs_t* b)
+{
+    if( 1 )
+    {
+        // the messages of the previous SEI are reused, with their payload storage
+        h->num_seis = 0;
+        do {
+            h->num_seis++;
+            h265_sei_pool_reserve(h, h->num_seis);
+            h->sei = h->seis[h->num_seis - 1];
+            read_h265_sei_message(h, b);
+        } while( more_rbsp_data(b) );
+    }
+
+    if( 0 )
+    {
+        for (int i = 0; i < h->num_seis; i++)
+        {
+            h->sei = h->seis[i];
+            read_h265_sei_message(h, b);
+        }
+        h->sei = NULL;
+    }
+}
+
+//7.3.5 Supplemental enhancement information message syntax
+void read_h265_sei_message(h265_stream_t* h, bs_t* b)
+{
+    sei_t* s = h->sei;
+    int i;
+
+    if( 0 )
+    {
+        _write_ff_coded_number(b, s->payloadType);
+        _write_ff_coded_number(b, s->payloadSize);
+    }
+    if( 1 )
+    {
+        s->payloadType = _read_ff_coded_number(b);
+        s->payloadSize = _read_ff_coded_number(b);
+
+        // payloads are kept as bytes, see sei_payload() for H.264
+        if ( s->payloadSize > s->data_capacity )
+        {
+            int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+            s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+            s->data_capacity = capacity;
+        }
+        s->data = s->data_buf;
+    }
+
+    if( 1 && !0 )
+    {
+        int n = bs_read_bytes(b, s->data, s->payloadSize);
+        if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+    }
+    else
+    {
+        for ( i = 0; i < s->payloadSize; i++ )
+        {
+            s->data[i] = bs_read_u8(b);
+        }
+    }
+}
+
+//7.3.2.5 Access unit delimiter RBSP syntax
+void read_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b)
+{
+    h->aud->pic_type = bs_read_u(b, 3);
+}
+
+//7.3.2.9 Slice segment layer RBSP syntax
+void read_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b)
+{
+    read_h265_slice_segment_header(h, b);
+
+    slice_data_rbsp_t* slice_data = h->slice_data;
+
+    if( 1 )
+    {
+        free( slice_data->rbsp_buf );
+        slice_data->rbsp_buf = NULL;
+        slice_data->rbsp_size = 0;
+
+        // the header ends byte aligned, slice_segment_data() and the trailing bits are copied as they are
+        if( h->parse_depth >= H265_PARSE_SLICE_DATA && b->p < b->end )
+        {
+            bs_t bs_tmp;
+            bs_clone(&bs_tmp, b);
+            slice_data->rbsp_buf = (uint8_t*)malloc( bs_tmp.end - bs_tmp.p );
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, bs_tmp.end - bs_tmp.p );
+        }
+    }
+
+    if( 0 && slice_data->rbsp_buf != NULL )
+    {
+        bs_write_bytes( b, slice_data->rbsp_buf, slice_data->rbsp_size );
+    }
+}
+
+//7.3.6.1 General slice segment header syntax
+void read_h265_slice_segment_header(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_nal_t* nal = h->nal;
+    int i;
+
+    if( 1 )
+    {
+        sh->no_output_of_prior_pics_flag = 0;
+        sh->dependent_slice_segment_flag = 0;
+        sh->slice_segment_address = 0;
+    }
+
+    sh->first_slice_segment_in_pic_flag = bs_read_u1(b);
+    if( H265_IS_IRAP( nal->nal_unit_type ) )
+    {
+        sh->no_output_of_prior_pics_flag = bs_read_u1(b);
+    }
+    sh->slice_pic_parameter_set_id = bs_read_ue(b);
+
+    // when writing, the slice segment goes out with the parameter sets in h->pps and h->sps as they are
+    if( 1 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h265_activate_pps(h, sh->slice_pic_parameter_set_id);
+        h265_activate_sps(h, h->pps->pps_seq_parameter_set_id);
+    }
+    h265_pps_t* pps = h->pps;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+
+    if( !sh->first_slice_segment_in_pic_flag )
+    {
+        if( pps->dependent_slice_segments_enabled_flag )
+        {
+            sh->dependent_slice_segment_flag = bs_read_u1(b);
+        }
+        sh->slice_segment_address = bs_read_u(b,  intlog2( h265_pic_size_in_ctbs( sps ) ) );
+    }
+
+    if( 1 && !sh->dependent_slice_segment_flag )
+    {
+        memset(&sh->slice_reserved_flag, 0, sizeof(h265_slice_header_t) - offsetof(h265_slice_header_t, slice_reserved_flag));
+        sh->pic_output_flag = 1;
+        sh->num_ref_idx_l0_active_minus1 = pps->num_ref_idx_l0_default_active_minus1;
+        sh->num_ref_idx_l1_active_minus1 = pps->num_ref_idx_l1_default_active_minus1;
+        sh->collocated_from_l0_flag = 1;
+        sh->slice_deblocking_filter_disabled_flag = pps->pps_deblocking_filter_disabled_flag;
+        sh->slice_beta_offset_div2 = pps->pps_beta_offset_div2;
+        sh->slice_tc_offset_div2 = pps->pps_tc_offset_div2;
+        sh->slice_loop_filter_across_slices_enabled_flag = pps->pps_loop_filter_across_slices_enabled_flag;
+    }
+
+    if( !sh->dependent_slice_segment_flag )
+    {
+        for( i = 0; i < pps->num_extra_slice_header_bits; i++ )
+        {
+            sh->slice_reserved_flag[ i ] = bs_read_u1(b);
+        }
+        sh->slice_type = bs_read_ue(b);
+        if( pps->output_flag_present_flag )
+        {
+            sh->pic_output_flag = bs_read_u1(b);
+        }
+        if( sps->separate_colour_plane_flag )
+        {
+            sh->colour_plane_id = bs_read_u(b, 2);
+        }
+        if( !H265_IS_IDR( nal->nal_unit_type ) )
+        {
+            sh->slice_pic_order_cnt_lsb = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 );
+            sh->short_term_ref_pic_set_sps_flag = bs_read_u1(b);
+            if( !sh->short_term_ref_pic_set_sps_flag )
+            {
+                read_h265_st_ref_pic_set(&sh->st_ref_pic_set, sps->st_ref_pic_set, sps->num_short_term_ref_pic_sets, sps->num_short_term_ref_pic_sets, b);
+            }
+            else if( sps->num_short_term_ref_pic_sets > 1 )
+            {
+                sh->short_term_ref_pic_set_idx = bs_read_u(b,  intlog2( sps->num_short_term_ref_pic_sets ) );
+            }
+            if( sps->long_term_ref_pics_present_flag )
+            {
+                if( sps->num_long_term_ref_pics_sps > 0 )
+                {
+                    sh->num_long_term_sps = bs_read_ue(b);
+                }
+                sh->num_long_term_pics = bs_read_ue(b);
+                for( i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++ )
+                {
+                    if( i < sh->num_long_term_sps )
+                    {
+                        if( sps->num_long_term_ref_pics_sps > 1 )
+                        {
+                            sh->lt_idx_sps[ i ] = bs_read_u(b,  intlog2( sps->num_long_term_ref_pics_sps ) );
+                        }
+                    }
+                    else
+                    {
+                        sh->poc_lsb_lt[ i ] = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 );
+                        sh->used_by_curr_pic_lt_flag[ i ] = bs_read_u1(b);
+                    }
+                    sh->delta_poc_msb_present_flag[ i ] = bs_read_u1(b);
+                    if( sh->delta_poc_msb_present_flag[ i ] )
+                    {
+                        sh->delta_poc_msb_cycle_lt[ i ] = bs_read_ue(b);
+                    }
+                }
+            }
+            if( sps->sps_temporal_mvp_enabled_flag )
+            {
+                sh->slice_temporal_mvp_enabled_flag = bs_read_u1(b);
+            }
+        }
+        if( sps->sample_adaptive_offset_enabled_flag )
+        {
+            sh->slice_sao_luma_flag = bs_read_u1(b);
+            if( ChromaArrayType != 0 )
+            {
+                sh->slice_sao_chroma_flag = bs_read_u1(b);
+            }
+        }
+        if( sh->slice_type == H265_SH_SLICE_TYPE_P || sh->slice_type == H265_SH_SLICE_TYPE_B )
+        {
+            sh->num_ref_idx_active_override_flag = bs_read_u1(b);
+            if( sh->num_ref_idx_active_override_flag )
+            {
+                sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b);
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b);
+                }
+            }
+            if( pps->lists_modification_present_flag && h265_num_pic_total_curr(h) > 1 )
+            {
+                read_h265_ref_pic_lists_modification(h, b);
+            }
+            if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+            {
+                sh->mvd_l1_zero_flag = bs_read_u1(b);
+            }
+            if( pps->cabac_init_present_flag )
+            {
+                sh->cabac_init_flag = bs_read_u1(b);
+            }
+            if( sh->slice_temporal_mvp_enabled_flag )
+            {
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    sh->collocated_from_l0_flag = bs_read_u1(b);
+                }
+                if( ( sh->collocated_from_l0_flag && sh->num_ref_idx_l0_active_minus1 > 0 ) ||
+                    ( !sh->collocated_from_l0_flag && sh->num_ref_idx_l1_active_minus1 > 0 ) )
+                {
+                    sh->collocated_ref_idx = bs_read_ue(b);
+                }
+            }
+            if( ( pps->weighted_pred_flag && sh->slice_type == H265_SH_SLICE_TYPE_P ) ||
+                ( pps->weighted_bipred_flag && sh->slice_type == H265_SH_SLICE_TYPE_B ) )
+            {
+                read_h265_pred_weight_table(h, b);
+            }
+            sh->five_minus_max_num_merge_cand = bs_read_ue(b);
+        }
+        sh->slice_qp_delta = bs_read_se(b);
+        if( pps->pps_slice_chroma_qp_offsets_present_flag )
+        {
+            sh->slice_cb_qp_offset = bs_read_se(b);
+            sh->slice_cr_qp_offset = bs_read_se(b);
+        }
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            sh->cu_chroma_qp_offset_enabled_flag = bs_read_u1(b);
+        }
+        if( pps->deblocking_filter_override_enabled_flag )
+        {
+            sh->deblocking_filter_override_flag = bs_read_u1(b);
+        }
+        if( sh->deblocking_filter_override_flag )
+        {
+            sh->slice_deblocking_filter_disabled_flag = bs_read_u1(b);
+            if( !sh->slice_deblocking_filter_disabled_flag )
+            {
+                sh->slice_beta_offset_div2 = bs_read_se(b);
+                sh->slice_tc_offset_div2 = bs_read_se(b);
+            }
+        }
+        if( pps->pps_loop_filter_across_slices_enabled_flag &&
+            ( sh->slice_sao_luma_flag || sh->slice_sao_chroma_flag || !sh->slice_deblocking_filter_disabled_flag ) )
+        {
+            sh->slice_loop_filter_across_slices_enabled_flag = bs_read_u1(b);
+        }
+    }
+
+    if( 1 )
+    {
+        sh->num_entry_point_offsets = 0;
+        sh->slice_segment_header_extension_length = 0;
+    }
+    if( pps->tiles_enabled_flag || pps->entropy_coding_sync_enabled_flag )
+    {
+        sh->num_entry_point_offsets = bs_read_ue(b);
+        if( sh->num_entry_point_offsets > 0 )
+        {
+            sh->offset_len_minus1 = bs_read_ue(b);
+            for( i = 0; i < sh->num_entry_point_offsets && i < H265_MAX_ENTRY_POINTS; i++ )
+            {
+                sh->entry_point_offset_minus1[ i ] = bs_read_u(b,  sh->offset_len_minus1 + 1 );
+            }
+            // the offsets past H265_MAX_ENTRY_POINTS are not kept: stepped over when reading, written as 0
+            for( ; i < sh->num_entry_point_offsets && !bs_eof(b); i++ )
+            {
+                if( 1 ) { bs_skip_u(b, sh->offset_len_minus1 + 1); }
+                if( 0 ) { bs_write_u(b, sh->offset_len_minus1 + 1, 0); }
+            }
+        }
+    }
+    if( pps->slice_segment_header_extension_present_flag )
+    {
+        sh->slice_segment_header_extension_length = bs_read_ue(b);
+        for( i = 0; i < sh->slice_segment_header_extension_length && i < 256; i++ )
+        {
+            sh->slice_segment_header_extension_data_byte[ i ] = bs_read_u8(b);
+        }
+        for( ; i < sh->slice_segment_header_extension_length && !bs_eof(b); i++ )
+        {
+            if( 1 ) { bs_skip_u(b, 8); }
+            if( 0 ) { bs_write_u(b, 8, 0); }
+        }
+    }
+    read_h265_byte_alignment(b);
+}
+
+//7.3.6.2 Reference picture list modification syntax
+void read_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    int n = intlog2( h265_num_pic_total_curr(h) );
+    int i;
+
+    sh->rplm.ref_pic_list_modification_flag_l0 = bs_read_u1(b);
+    if( sh->rplm.ref_pic_list_modification_flag_l0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            sh->rplm.list_entry_l0[ i ] = bs_read_u(b,  n );
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        sh->rplm.ref_pic_list_modification_flag_l1 = bs_read_u1(b);
+        if( sh->rplm.ref_pic_list_modification_flag_l1 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                sh->rplm.list_entry_l1[ i ] = bs_read_u(b,  n );
+            }
+        }
+    }
+}
+
+//7.3.6.3 Weighted prediction parameters syntax
+// luma_weight_lX_flag and chroma_weight_lX_flag are read for every reference picture: a reference can only have the
+// POC of the current picture with the screen content extension, which is not read
+void read_h265_pred_weight_table(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+    int i, j;
+
+    sh->pwt.luma_log2_weight_denom = bs_read_ue(b);
+    if( ChromaArrayType != 0 )
+    {
+        sh->pwt.delta_chroma_log2_weight_denom = bs_read_se(b);
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        sh->pwt.luma_weight_l0_flag[ i ] = bs_read_u1(b);
+    }
+    if( ChromaArrayType != 0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            sh->pwt.chroma_weight_l0_flag[ i ] = bs_read_u1(b);
+        }
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        if( sh->pwt.luma_weight_l0_flag[ i ] )
+        {
+            sh->pwt.delta_luma_weight_l0[ i ] = bs_read_se(b);
+            sh->pwt.luma_offset_l0[ i ] = bs_read_se(b);
+        }
+        if( sh->pwt.chroma_weight_l0_flag[ i ] )
+        {
+            for( j = 0; j < 2; j++ )
+            {
+                sh->pwt.delta_chroma_weight_l0[ i ][ j ] = bs_read_se(b);
+                sh->pwt.delta_chroma_offset_l0[ i ][ j ] = bs_read_se(b);
+            }
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            sh->pwt.luma_weight_l1_flag[ i ] = bs_read_u1(b);
+        }
+        if( ChromaArrayType != 0 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                sh->pwt.chroma_weight_l1_flag[ i ] = bs_read_u1(b);
+            }
+        }
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            if( sh->pwt.luma_weight_l1_flag[ i ] )
+            {
+                sh->pwt.delta_luma_weight_l1[ i ] = bs_read_se(b);
+                sh->pwt.luma_offset_l1[ i ] = bs_read_se(b);
+            }
+            if( sh->pwt.chroma_weight_l1_flag[ i ] )
+            {
+                for( j = 0; j < 2; j++ )
+                {
+                    sh->pwt.delta_chroma_weight_l1[ i ][ j ] = bs_read_se(b);
+                    sh->pwt.delta_chroma_offset_l1[ i ][ j ] = bs_read_se(b);
+                }
+            }
+        }
+    }
+}
+
+//7.3.2.11 RBSP trailing bits syntax
+void read_h265_rbsp_trailing_bits(bs_t* b)
+{
+    /* rbsp_stop_one_bit */ bs_skip_u(b, 1);
+
+    while( !bs_byte_aligned(b) )
+    {
+        /* rbsp_alignment_zero_bit */ bs_skip_u(b, 1);
+    }
+}
+
+//7.3.2.12 Byte alignment syntax
+void read_h265_byte_alignment(bs_t* b)
+{
+    /* alignment_bit_equal_to_one */ bs_skip_u(b, 1);
+
+    while( !bs_byte_aligned(b) )
+    {
+        /* alignment_bit_equal_to_zero */ bs_skip_u(b, 1);
+    }
+}
+
+
+void write_h265_nal_unit_header(h265_nal_t* nal, bs_t* b);
+void write_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b);
+void write_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void write_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void write_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b);
+void write_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b);
+void write_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b);
+void write_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b);
+void write_h265_vui_parameters(h265_sps_t* sps, bs_t* b);
+void write_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b);
+void write_h265_sei_rbsp(h265_stream_t* h, bs_t* b);
+void write_h265_sei_message(h265_stream_t* h, bs_t* b);
+void write_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b);
+void write_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b);
+void write_h265_slice_segment_header(h265_stream_t* h, bs_t* b);
+void write_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b);
+void write_h265_pred_weight_table(h265_stream_t* h, bs_t* b);
+void write_h265_rbsp_trailing_bits(bs_t* b);
+void write_h265_byte_alignment(bs_t* b);
+
+
+
+
+//7.3.1.1 General NAL unit syntax
+int write_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    int nal_size = size;
+    int rbsp_size = size;
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
+
+    if( 0 )
+    {
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
+    }
+
+    if( 1 )
+    {
+        rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
+    }
+
+    write_h265_nal_unit_header(nal, b);
+
+    if( 0 && h->parse_depth < H265_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
+    switch ( nal->nal_unit_type )
+    {
+        case H265_NAL_UNIT_TYPE_TRAIL_N:
+        case H265_NAL_UNIT_TYPE_TRAIL_R:
+        case H265_NAL_UNIT_TYPE_TSA_N:
+        case H265_NAL_UNIT_TYPE_TSA_R:
+        case H265_NAL_UNIT_TYPE_STSA_N:
+        case H265_NAL_UNIT_TYPE_STSA_R:
+        case H265_NAL_UNIT_TYPE_RADL_N:
+        case H265_NAL_UNIT_TYPE_RADL_R:
+        case H265_NAL_UNIT_TYPE_RASL_N:
+        case H265_NAL_UNIT_TYPE_RASL_R:
+        case H265_NAL_UNIT_TYPE_BLA_W_LP:
+        case H265_NAL_UNIT_TYPE_BLA_W_RADL:
+        case H265_NAL_UNIT_TYPE_BLA_N_LP:
+        case H265_NAL_UNIT_TYPE_IDR_W_RADL:
+        case H265_NAL_UNIT_TYPE_IDR_N_LP:
+        case H265_NAL_UNIT_TYPE_CRA_NUT:
+            write_h265_slice_segment_layer_rbsp(h, b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_VPS:
+            if( 0 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            write_h265_video_parameter_set_rbsp(h->vps, b);
+            if( h->vps->incomplete ) { free(rbsp_buf); return -1; }
+            write_h265_rbsp_trailing_bits(b);
+
+            if( 0 )
+            {
+                int id = h->vps->vps_video_parameter_set_id;
+                memcpy(h265_vps_slot(h, id), h->vps, sizeof(h265_vps_t));
+                h->vps_table_hash[id] = h264_nal_hash(buf, nal_size);
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_SPS:
+            if( 0 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            write_h265_seq_parameter_set_rbsp(h->sps, b);
+            if( h->sps->incomplete ) { free(rbsp_buf); h->sps_hash = 0; return -1; }
+            write_h265_rbsp_trailing_bits(b);
+
+            if( 0 )
+            {
+                int id = h->sps->sps_seq_parameter_set_id;
+                if( id >= 16 ) { return -1; }
+                memcpy(h265_sps_slot(h, id), h->sps, sizeof(h265_sps_t));
+                h->sps_hash = h264_nal_hash(buf, nal_size);
+                h->sps_table_hash[id] = h->sps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_PPS:
+            if( 0 && !0 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            write_h265_pic_parameter_set_rbsp(h->pps, b);
+            write_h265_rbsp_trailing_bits(b);
+
+            if( 0 )
+            {
+                int id = h->pps->pps_pic_parameter_set_id;
+                if( id >= 64 ) { return -1; }
+                memcpy(h265_pps_slot(h, id), h->pps, sizeof(h265_pps_t));
+                h->pps_hash = h264_nal_hash(buf, nal_size);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_AUD:
+            write_h265_access_unit_delimiter_rbsp(h, b);
+            write_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_PREFIX_SEI:
+        case H265_NAL_UNIT_TYPE_SUFFIX_SEI:
+            write_h265_sei_rbsp(h, b);
+            write_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_EOS:
+        case H265_NAL_UNIT_TYPE_EOB:
+            // 7.3.2.6, 7.3.2.7 the rbsp is empty
+            break;
+
+        case H265_NAL_UNIT_TYPE_FD:
+        default:
+            free(rbsp_buf);
+            return -1;
+    }
+
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
+
+    if( 1 )
+    {
+        // now get the actual size used
+        rbsp_size = bs_pos(b);
+
+        int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
+        if (rc < 0) { free(rbsp_buf); return -1; }
+    }
+
+    free(rbsp_buf);
+
+    return nal_size;
+}
+
+//7.3.1.2 NAL unit header syntax
+void write_h265_nal_unit_header(h265_nal_t* nal, bs_t* b)
+{
+    /* forbidden_zero_bit */ bs_write_u(b, 1, 0);
+    bs_write_u(b, 6, nal->nal_unit_type);
+    bs_write_u(b, 6, nal->nuh_layer_id);
+    bs_write_u(b, 3, nal->nuh_temporal_id_plus1);
+}
+
+//7.3.2.1 Video parameter set RBSP syntax
+void write_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b)
+{
+    int i, j;
+
+    if( 0 )
+    {
+        memset(vps, 0, sizeof(h265_vps_t));
+    }
+
+    bs_write_u(b, 4, vps->vps_video_parameter_set_id);
+    bs_write_u1(b, vps->vps_base_layer_internal_flag);
+    bs_write_u1(b, vps->vps_base_layer_available_flag);
+    bs_write_u(b, 6, vps->vps_max_layers_minus1);
+    bs_write_u(b, 3, vps->vps_max_sub_layers_minus1);
+    bs_write_u1(b, vps->vps_temporal_id_nesting_flag);
+    /* vps_reserved_0xffff_16bits */ bs_write_u(b, 16, 0xFFFF);
+    write_h265_profile_tier_level(&vps->ptl, 1, vps->vps_max_sub_layers_minus1, b);
+    bs_write_u1(b, vps->vps_sub_layer_ordering_info_present_flag);
+    for( i = ( vps->vps_sub_layer_ordering_info_present_flag ? 0 : vps->vps_max_sub_layers_minus1 );
+         i <= vps->vps_max_sub_layers_minus1; i++ )
+    {
+        bs_write_ue(b, vps->vps_max_dec_pic_buffering_minus1[ i ]);
+        bs_write_ue(b, vps->vps_max_num_reorder_pics[ i ]);
+        bs_write_ue(b, vps->vps_max_latency_increase_plus1[ i ]);
+    }
+    bs_write_u(b, 6, vps->vps_max_layer_id);
+    bs_write_ue(b, vps->vps_num_layer_sets_minus1);
+    if( vps->vps_num_layer_sets_minus1 >= H265_MAX_LAYER_SETS )
+    {
+        // not read past here
+        vps->incomplete = 1;
+        return;
+    }
+    for( i = 1; i <= vps->vps_num_layer_sets_minus1; i++ )
+    {
+        for( j = 0; j <= vps->vps_max_layer_id; j++ )
+        {
+            bs_write_u1(b, vps->layer_id_included_flag[ i ][ j ]);
+        }
+    }
+    bs_write_u1(b, vps->vps_timing_info_present_flag);
+    if( vps->vps_timing_info_present_flag )
+    {
+        bs_write_u(b, 32, vps->vps_num_units_in_tick);
+        bs_write_u(b, 32, vps->vps_time_scale);
+        bs_write_u1(b, vps->vps_poc_proportional_to_timing_flag);
+        if( vps->vps_poc_proportional_to_timing_flag )
+        {
+            bs_write_ue(b, vps->vps_num_ticks_poc_diff_one_minus1);
+        }
+        bs_write_ue(b, vps->vps_num_hrd_parameters);
+        if( vps->vps_num_hrd_parameters > H265_MAX_VPS_HRD )
+        {
+            // not read past here
+            vps->incomplete = 1;
+            return;
+        }
+        for( i = 0; i < vps->vps_num_hrd_parameters; i++ )
+        {
+            bs_write_ue(b, vps->hrd_layer_set_idx[ i ]);
+            if( i > 0 )
+            {
+                bs_write_u1(b, vps->cprms_present_flag[ i ]);
+            }
+            else if( 0 )
+            {
+                vps->cprms_present_flag[ i ] = 1;
+            }
+            write_h265_hrd_parameters(&vps->hrd[ i ], vps->cprms_present_flag[ i ], vps->vps_max_sub_layers_minus1, b);
+        }
+    }
+    bs_write_u1(b, vps->vps_extension_flag);
+    // vps_extension_data_flag (multilayer and 3D) is not read
+}
+
+//7.3.3 Profile, tier and level syntax
+void write_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i, j;
+
+    if( profilePresentFlag )
+    {
+        bs_write_u(b, 2, ptl->general_profile_space);
+        bs_write_u1(b, ptl->general_tier_flag);
+        bs_write_u(b, 5, ptl->general_profile_idc);
+        for( j = 0; j < 32; j++ )
+        {
+            bs_write_u1(b, ptl->general_profile_compatibility_flag[ j ]);
+        }
+        bs_write_u1(b, ptl->general_progressive_source_flag);
+        bs_write_u1(b, ptl->general_interlaced_source_flag);
+        bs_write_u1(b, ptl->general_non_packed_constraint_flag);
+        bs_write_u1(b, ptl->general_frame_only_constraint_flag);
+        bs_write_u(b, 32, ptl->general_reserved_zero_44bits[ 0 ]);
+        bs_write_u(b, 12, ptl->general_reserved_zero_44bits[ 1 ]);
+    }
+    bs_write_u8(b, ptl->general_level_idc);
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        bs_write_u1(b, ptl->sub_layer_profile_present_flag[ i ]);
+        bs_write_u1(b, ptl->sub_layer_level_present_flag[ i ]);
+    }
+    if( maxNumSubLayersMinus1 > 0 )
+    {
+        for( i = maxNumSubLayersMinus1; i < 8; i++ )
+        {
+            /* reserved_zero_2bits */ bs_write_u(b, 2, 0);
+        }
+    }
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        if( ptl->sub_layer_profile_present_flag[ i ] )
+        {
+            bs_write_u(b, 2, ptl->sub_layer[ i ].sub_layer_profile_space);
+            bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_tier_flag);
+            bs_write_u(b, 5, ptl->sub_layer[ i ].sub_layer_profile_idc);
+            for( j = 0; j < 32; j++ )
+            {
+                bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ]);
+            }
+            bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_progressive_source_flag);
+            bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_interlaced_source_flag);
+            bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag);
+            bs_write_u1(b, ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag);
+            bs_write_u(b, 32, ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ]);
+            bs_write_u(b, 12, ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ]);
+        }
+        if( ptl->sub_layer_level_present_flag[ i ] )
+        {
+            bs_write_u8(b, ptl->sub_layer[ i ].sub_layer_level_idc);
+        }
+    }
+}
+
+//E.2.2 HRD parameters syntax
+void write_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i;
+
+    if( commonInfPresentFlag )
+    {
+        bs_write_u1(b, hrd->nal_hrd_parameters_present_flag);
+        bs_write_u1(b, hrd->vcl_hrd_parameters_present_flag);
+        if( hrd->nal_hrd_parameters_present_flag || hrd->vcl_hrd_parameters_present_flag )
+        {
+            bs_write_u1(b, hrd->sub_pic_hrd_params_present_flag);
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                bs_write_u8(b, hrd->tick_divisor_minus2);
+                bs_write_u(b, 5, hrd->du_cpb_removal_delay_increment_length_minus1);
+                bs_write_u1(b, hrd->sub_pic_cpb_params_in_pic_timing_sei_flag);
+                bs_write_u(b, 5, hrd->dpb_output_delay_du_length_minus1);
+            }
+            bs_write_u(b, 4, hrd->bit_rate_scale);
+            bs_write_u(b, 4, hrd->cpb_size_scale);
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                bs_write_u(b, 4, hrd->cpb_size_du_scale);
+            }
+            bs_write_u(b, 5, hrd->initial_cpb_removal_delay_length_minus1);
+            bs_write_u(b, 5, hrd->au_cpb_removal_delay_length_minus1);
+            bs_write_u(b, 5, hrd->dpb_output_delay_length_minus1);
+        }
+    }
+    for( i = 0; i <= maxNumSubLayersMinus1; i++ )
+    {
+        bs_write_u1(b, hrd->fixed_pic_rate_general_flag[ i ]);
+        if( 0 )
+        {
+            hrd->fixed_pic_rate_within_cvs_flag[ i ] = hrd->fixed_pic_rate_general_flag[ i ];
+            hrd->low_delay_hrd_flag[ i ] = 0;
+            hrd->cpb_cnt_minus1[ i ] = 0;
+        }
+        if( !hrd->fixed_pic_rate_general_flag[ i ] )
+        {
+            bs_write_u1(b, hrd->fixed_pic_rate_within_cvs_flag[ i ]);
+        }
+        if( hrd->fixed_pic_rate_within_cvs_flag[ i ] )
+        {
+            bs_write_ue(b, hrd->elemental_duration_in_tc_minus1[ i ]);
+        }
+        else
+        {
+            bs_write_u1(b, hrd->low_delay_hrd_flag[ i ]);
+        }
+        if( !hrd->low_delay_hrd_flag[ i ] )
+        {
+            bs_write_ue(b, hrd->cpb_cnt_minus1[ i ]);
+        }
+        if( hrd->nal_hrd_parameters_present_flag )
+        {
+            write_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_nal[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+        if( hrd->vcl_hrd_parameters_present_flag )
+        {
+            write_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_vcl[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+    }
+}
+
+//E.2.3 Sub-layer HRD parameters syntax
+void write_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b)
+{
+    int i;
+
+    for( i = 0; i <= cpb_cnt_minus1 && i < H265_MAX_CPB_CNT; i++ )
+    {
+        bs_write_ue(b, sub->bit_rate_value_minus1[ i ]);
+        bs_write_ue(b, sub->cpb_size_value_minus1[ i ]);
+        if( sub_pic_hrd_params_present_flag )
+        {
+            bs_write_ue(b, sub->cpb_size_du_value_minus1[ i ]);
+            bs_write_ue(b, sub->bit_rate_du_value_minus1[ i ]);
+        }
+        bs_write_u1(b, sub->cbr_flag[ i ]);
+    }
+}
+
+//7.3.2.2.1 General sequence parameter set RBSP syntax
+void write_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b)
+{
+    int i;
+
+    if( 0 )
+    {
+        memset(sps, 0, sizeof(h265_sps_t));
+    }
+
+    bs_write_u(b, 4, sps->sps_video_parameter_set_id);
+    bs_write_u(b, 3, sps->sps_max_sub_layers_minus1);
+    bs_write_u1(b, sps->sps_temporal_id_nesting_flag);
+    write_h265_profile_tier_level(&sps->ptl, 1, sps->sps_max_sub_layers_minus1, b);
+    bs_write_ue(b, sps->sps_seq_parameter_set_id);
+    bs_write_ue(b, sps->chroma_format_idc);
+    if( sps->chroma_format_idc == 3 )
+    {
+        bs_write_u1(b, sps->separate_colour_plane_flag);
+    }
+    bs_write_ue(b, sps->pic_width_in_luma_samples);
+    bs_write_ue(b, sps->pic_height_in_luma_samples);
+    bs_write_u1(b, sps->conformance_window_flag);
+    if( sps->conformance_window_flag )
+    {
+        bs_write_ue(b, sps->conf_win_left_offset);
+        bs_write_ue(b, sps->conf_win_right_offset);
+        bs_write_ue(b, sps->conf_win_top_offset);
+        bs_write_ue(b, sps->conf_win_bottom_offset);
+    }
+    bs_write_ue(b, sps->bit_depth_luma_minus8);
+    bs_write_ue(b, sps->bit_depth_chroma_minus8);
+    bs_write_ue(b, sps->log2_max_pic_order_cnt_lsb_minus4);
+    bs_write_u1(b, sps->sps_sub_layer_ordering_info_present_flag);
+    for( i = ( sps->sps_sub_layer_ordering_info_present_flag ? 0 : sps->sps_max_sub_layers_minus1 );
+         i <= sps->sps_max_sub_layers_minus1; i++ )
+    {
+        bs_write_ue(b, sps->sps_max_dec_pic_buffering_minus1[ i ]);
+        bs_write_ue(b, sps->sps_max_num_reorder_pics[ i ]);
+        bs_write_ue(b, sps->sps_max_latency_increase_plus1[ i ]);
+    }
+    bs_write_ue(b, sps->log2_min_luma_coding_block_size_minus3);
+    bs_write_ue(b, sps->log2_diff_max_min_luma_coding_block_size);
+    bs_write_ue(b, sps->log2_min_luma_transform_block_size_minus2);
+    bs_write_ue(b, sps->log2_diff_max_min_luma_transform_block_size);
+    bs_write_ue(b, sps->max_transform_hierarchy_depth_inter);
+    bs_write_ue(b, sps->max_transform_hierarchy_depth_intra);
+    bs_write_u1(b, sps->scaling_list_enabled_flag);
+    if( sps->scaling_list_enabled_flag )
+    {
+        bs_write_u1(b, sps->sps_scaling_list_data_present_flag);
+        if( sps->sps_scaling_list_data_present_flag )
+        {
+            write_h265_scaling_list_data(&sps->scaling_list, b);
+        }
+    }
+    bs_write_u1(b, sps->amp_enabled_flag);
+    bs_write_u1(b, sps->sample_adaptive_offset_enabled_flag);
+    bs_write_u1(b, sps->pcm_enabled_flag);
+    if( sps->pcm_enabled_flag )
+    {
+        bs_write_u(b, 4, sps->pcm_sample_bit_depth_luma_minus1);
+        bs_write_u(b, 4, sps->pcm_sample_bit_depth_chroma_minus1);
+        bs_write_ue(b, sps->log2_min_pcm_luma_coding_block_size_minus3);
+        bs_write_ue(b, sps->log2_diff_max_min_pcm_luma_coding_block_size);
+        bs_write_u1(b, sps->pcm_loop_filter_disabled_flag);
+    }
+    bs_write_ue(b, sps->num_short_term_ref_pic_sets);
+    if( sps->num_short_term_ref_pic_sets > H265_MAX_SHORT_TERM_RPS )
+    {
+        // not read past here
+        sps->incomplete = 1;
+        return;
+    }
+    for( i = 0; i < sps->num_short_term_ref_pic_sets; i++ )
+    {
+        write_h265_st_ref_pic_set(&sps->st_ref_pic_set[ i ], sps->st_ref_pic_set, i, sps->num_short_term_ref_pic_sets, b);
+    }
+    bs_write_u1(b, sps->long_term_ref_pics_present_flag);
+    if( sps->long_term_ref_pics_present_flag )
+    {
+        bs_write_ue(b, sps->num_long_term_ref_pics_sps);
+        for( i = 0; i < sps->num_long_term_ref_pics_sps && i < H265_MAX_LONG_TERM_PICS; i++ )
+        {
+            bs_write_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 , sps->lt_ref_pic_poc_lsb_sps[ i ]);
+            bs_write_u1(b, sps->used_by_curr_pic_lt_sps_flag[ i ]);
+        }
+    }
+    bs_write_u1(b, sps->sps_temporal_mvp_enabled_flag);
+    bs_write_u1(b, sps->strong_intra_smoothing_enabled_flag);
+    bs_write_u1(b, sps->vui_parameters_present_flag);
+    if( sps->vui_parameters_present_flag )
+    {
+        write_h265_vui_parameters(sps, b);
+    }
+    bs_write_u1(b, sps->sps_extension_present_flag);
+    if( sps->sps_extension_present_flag )
+    {
+        bs_write_u1(b, sps->sps_range_extension_flag);
+        bs_write_u1(b, sps->sps_multilayer_extension_flag);
+        bs_write_u1(b, sps->sps_3d_extension_flag);
+        bs_write_u1(b, sps->sps_scc_extension_flag);
+        bs_write_u(b, 4, sps->sps_extension_4bits);
+    }
+    if( sps->sps_range_extension_flag )
+    {
+        bs_write_u1(b, sps->transform_skip_rotation_enabled_flag);
+        bs_write_u1(b, sps->transform_skip_context_enabled_flag);
+        bs_write_u1(b, sps->implicit_rdpcm_enabled_flag);
+        bs_write_u1(b, sps->explicit_rdpcm_enabled_flag);
+        bs_write_u1(b, sps->extended_precision_processing_flag);
+        bs_write_u1(b, sps->intra_smoothing_disabled_flag);
+        bs_write_u1(b, sps->high_precision_offsets_enabled_flag);
+        bs_write_u1(b, sps->persistent_rice_adaptation_enabled_flag);
+        bs_write_u1(b, sps->cabac_bypass_alignment_enabled_flag);
+    }
+    // the multilayer, 3D and SCC extensions and sps_extension_data_flag are not read
+}
+
+//7.3.4 Scaling list data syntax
+void write_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b)
+{
+    int sizeId, matrixId, i;
+    int scaling_list_delta_coef;
+
+    for( sizeId = 0; sizeId < 4; sizeId++ )
+    {
+        for( matrixId = 0; matrixId < 6; matrixId += ( sizeId == 3 ) ? 3 : 1 )
+        {
+            bs_write_u1(b, sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ]);
+            if( !sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] )
+            {
+                bs_write_ue(b, sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ]);
+            }
+            else
+            {
+                int nextCoef = 8;
+                int coefNum = ( sizeId == 0 ) ? 16 : 64;
+                if( sizeId > 1 )
+                {
+                    bs_write_se(b, sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ]);
+                    nextCoef = sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] + 8;
+                }
+                for( i = 0; i < coefNum; i++ )
+                {
+                    if( 1 )
+                    {
+                        // any difference that comes out the same modulo 256 will do, take the one in -128..127
+                        scaling_list_delta_coef = ( ( sl->ScalingList[ sizeId ][ matrixId ][ i ] - nextCoef + 128 ) & 255 ) - 128;
+                    }
+                    bs_write_se(b, scaling_list_delta_coef);
+                    nextCoef = ( nextCoef + scaling_list_delta_coef + 256 ) % 256;
+                    if( 0 )
+                    {
+                        sl->ScalingList[ sizeId ][ matrixId ][ i ] = nextCoef;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//7.3.7 Short-term reference picture set syntax
+void write_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b)
+{
+    int i, j;
+
+    if( 0 )
+    {
+        memset(rps, 0, sizeof(h265_st_ref_pic_set_t));
+    }
+
+    if( stRpsIdx != 0 )
+    {
+        bs_write_u1(b, rps->inter_ref_pic_set_prediction_flag);
+    }
+    if( rps->inter_ref_pic_set_prediction_flag )
+    {
+        if( stRpsIdx == num_short_term_ref_pic_sets )
+        {
+            bs_write_ue(b, rps->delta_idx_minus1);
+        }
+        bs_write_u1(b, rps->delta_rps_sign);
+        bs_write_ue(b, rps->abs_delta_rps_minus1);
+
+        int RefRpsIdx = stRpsIdx - ( rps->delta_idx_minus1 + 1 );
+        if( RefRpsIdx < 0 || RefRpsIdx >= H265_MAX_SHORT_TERM_RPS ) { RefRpsIdx = 0; }
+        h265_st_ref_pic_set_t* ref = &sets[ RefRpsIdx ];
+
+        for( j = 0; j <= ref->NumDeltaPocs; j++ )
+        {
+            bs_write_u1(b, rps->used_by_curr_pic_flag[ j ]);
+            if( !rps->used_by_curr_pic_flag[ j ] )
+            {
+                bs_write_u1(b, rps->use_delta_flag[ j ]);
+            }
+        }
+        h265_st_ref_pic_set_derive(rps, ref);
+    }
+    else
+    {
+        bs_write_ue(b, rps->num_negative_pics);
+        bs_write_ue(b, rps->num_positive_pics);
+        for( i = 0; i < rps->num_negative_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            bs_write_ue(b, rps->delta_poc_s0_minus1[ i ]);
+            bs_write_u1(b, rps->used_by_curr_pic_s0_flag[ i ]);
+        }
+        for( i = 0; i < rps->num_positive_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            bs_write_ue(b, rps->delta_poc_s1_minus1[ i ]);
+            bs_write_u1(b, rps->used_by_curr_pic_s1_flag[ i ]);
+        }
+        h265_st_ref_pic_set_derive(rps, NULL);
+    }
+}
+
+//E.2.1 VUI parameters syntax
+void write_h265_vui_parameters(h265_sps_t* sps, bs_t* b)
+{
+    bs_write_u1(b, sps->vui.aspect_ratio_info_present_flag);
+    if( sps->vui.aspect_ratio_info_present_flag )
+    {
+        bs_write_u8(b, sps->vui.aspect_ratio_idc);
+        if( sps->vui.aspect_ratio_idc == SAR_Extended )
+        {
+            bs_write_u(b, 16, sps->vui.sar_width);
+            bs_write_u(b, 16, sps->vui.sar_height);
+        }
+    }
+    bs_write_u1(b, sps->vui.overscan_info_present_flag);
+    if( sps->vui.overscan_info_present_flag )
+    {
+        bs_write_u1(b, sps->vui.overscan_appropriate_flag);
+    }
+    bs_write_u1(b, sps->vui.video_signal_type_present_flag);
+    if( sps->vui.video_signal_type_present_flag )
+    {
+        bs_write_u(b, 3, sps->vui.video_format);
+        bs_write_u1(b, sps->vui.video_full_range_flag);
+        bs_write_u1(b, sps->vui.colour_description_present_flag);
+        if( sps->vui.colour_description_present_flag )
+        {
+            bs_write_u8(b, sps->vui.colour_primaries);
+            bs_write_u8(b, sps->vui.transfer_characteristics);
+            bs_write_u8(b, sps->vui.matrix_coeffs);
+        }
+    }
+    bs_write_u1(b, sps->vui.chroma_loc_info_present_flag);
+    if( sps->vui.chroma_loc_info_present_flag )
+    {
+        bs_write_ue(b, sps->vui.chroma_sample_loc_type_top_field);
+        bs_write_ue(b, sps->vui.chroma_sample_loc_type_bottom_field);
+    }
+    bs_write_u1(b, sps->vui.neutral_chroma_indication_flag);
+    bs_write_u1(b, sps->vui.field_seq_flag);
+    bs_write_u1(b, sps->vui.frame_field_info_present_flag);
+    bs_write_u1(b, sps->vui.default_display_window_flag);
+    if( sps->vui.default_display_window_flag )
+    {
+        bs_write_ue(b, sps->vui.def_disp_win_left_offset);
+        bs_write_ue(b, sps->vui.def_disp_win_right_offset);
+        bs_write_ue(b, sps->vui.def_disp_win_top_offset);
+        bs_write_ue(b, sps->vui.def_disp_win_bottom_offset);
+    }
+    bs_write_u1(b, sps->vui.vui_timing_info_present_flag);
+    if( sps->vui.vui_timing_info_present_flag )
+    {
+        bs_write_u(b, 32, sps->vui.vui_num_units_in_tick);
+        bs_write_u(b, 32, sps->vui.vui_time_scale);
+        bs_write_u1(b, sps->vui.vui_poc_proportional_to_timing_flag);
+        if( sps->vui.vui_poc_proportional_to_timing_flag )
+        {
+            bs_write_ue(b, sps->vui.vui_num_ticks_poc_diff_one_minus1);
+        }
+        bs_write_u1(b, sps->vui.vui_hrd_parameters_present_flag);
+        if( sps->vui.vui_hrd_parameters_present_flag )
+        {
+            write_h265_hrd_parameters(&sps->hrd, 1, sps->sps_max_sub_layers_minus1, b);
+        }
+    }
+    bs_write_u1(b, sps->vui.bitstream_restriction_flag);
+    if( sps->vui.bitstream_restriction_flag )
+    {
+        bs_write_u1(b, sps->vui.tiles_fixed_structure_flag);
+        bs_write_u1(b, sps->vui.motion_vectors_over_pic_boundaries_flag);
+        bs_write_u1(b, sps->vui.restricted_ref_pic_lists_flag);
+        bs_write_ue(b, sps->vui.min_spatial_segmentation_idc);
+        bs_write_ue(b, sps->vui.max_bytes_per_pic_denom);
+        bs_write_ue(b, sps->vui.max_bits_per_min_cu_denom);
+        bs_write_ue(b, sps->vui.log2_max_mv_length_horizontal);
+        bs_write_ue(b, sps->vui.log2_max_mv_length_vertical);
+    }
+}
+
+//7.3.2.3.1 General picture parameter set RBSP syntax
+void write_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b)
+{
+    int i;
+
+    if( 0 )
+    {
+        memset(pps, 0, sizeof(h265_pps_t));
+        pps->uniform_spacing_flag = 1;
+        pps->loop_filter_across_tiles_enabled_flag = 1;
+    }
+
+    bs_write_ue(b, pps->pps_pic_parameter_set_id);
+    bs_write_ue(b, pps->pps_seq_parameter_set_id);
+    bs_write_u1(b, pps->dependent_slice_segments_enabled_flag);
+    bs_write_u1(b, pps->output_flag_present_flag);
+    bs_write_u(b, 3, pps->num_extra_slice_header_bits);
+    bs_write_u1(b, pps->sign_data_hiding_enabled_flag);
+    bs_write_u1(b, pps->cabac_init_present_flag);
+    bs_write_ue(b, pps->num_ref_idx_l0_default_active_minus1);
+    bs_write_ue(b, pps->num_ref_idx_l1_default_active_minus1);
+    bs_write_se(b, pps->init_qp_minus26);
+    bs_write_u1(b, pps->constrained_intra_pred_flag);
+    bs_write_u1(b, pps->transform_skip_enabled_flag);
+    bs_write_u1(b, pps->cu_qp_delta_enabled_flag);
+    if( pps->cu_qp_delta_enabled_flag )
+    {
+        bs_write_ue(b, pps->diff_cu_qp_delta_depth);
+    }
+    bs_write_se(b, pps->pps_cb_qp_offset);
+    bs_write_se(b, pps->pps_cr_qp_offset);
+    bs_write_u1(b, pps->pps_slice_chroma_qp_offsets_present_flag);
+    bs_write_u1(b, pps->weighted_pred_flag);
+    bs_write_u1(b, pps->weighted_bipred_flag);
+    bs_write_u1(b, pps->transquant_bypass_enabled_flag);
+    bs_write_u1(b, pps->tiles_enabled_flag);
+    bs_write_u1(b, pps->entropy_coding_sync_enabled_flag);
+    if( pps->tiles_enabled_flag )
+    {
+        bs_write_ue(b, pps->num_tile_columns_minus1);
+        bs_write_ue(b, pps->num_tile_rows_minus1);
+        bs_write_u1(b, pps->uniform_spacing_flag);
+        if( !pps->uniform_spacing_flag )
+        {
+            for( i = 0; i < pps->num_tile_columns_minus1 && i < H265_MAX_TILE_COLUMNS; i++ )
+            {
+                bs_write_ue(b, pps->column_width_minus1[ i ]);
+            }
+            for( i = 0; i < pps->num_tile_rows_minus1 && i < H265_MAX_TILE_ROWS; i++ )
+            {
+                bs_write_ue(b, pps->row_height_minus1[ i ]);
+            }
+        }
+        bs_write_u1(b, pps->loop_filter_across_tiles_enabled_flag);
+    }
+    bs_write_u1(b, pps->pps_loop_filter_across_slices_enabled_flag);
+    bs_write_u1(b, pps->deblocking_filter_control_present_flag);
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        bs_write_u1(b, pps->deblocking_filter_override_enabled_flag);
+        bs_write_u1(b, pps->pps_deblocking_filter_disabled_flag);
+        if( !pps->pps_deblocking_filter_disabled_flag )
+        {
+            bs_write_se(b, pps->pps_beta_offset_div2);
+            bs_write_se(b, pps->pps_tc_offset_div2);
+        }
+    }
+    bs_write_u1(b, pps->pps_scaling_list_data_present_flag);
+    if( pps->pps_scaling_list_data_present_flag )
+    {
+        write_h265_scaling_list_data(&pps->scaling_list, b);
+    }
+    bs_write_u1(b, pps->lists_modification_present_flag);
+    bs_write_ue(b, pps->log2_parallel_merge_level_minus2);
+    bs_write_u1(b, pps->slice_segment_header_extension_present_flag);
+    bs_write_u1(b, pps->pps_extension_present_flag);
+    if( pps->pps_extension_present_flag )
+    {
+        bs_write_u1(b, pps->pps_range_extension_flag);
+        bs_write_u1(b, pps->pps_multilayer_extension_flag);
+        bs_write_u1(b, pps->pps_3d_extension_flag);
+        bs_write_u1(b, pps->pps_scc_extension_flag);
+        bs_write_u(b, 4, pps->pps_extension_4bits);
+    }
+    if( pps->pps_range_extension_flag )
+    {
+        if( pps->transform_skip_enabled_flag )
+        {
+            bs_write_ue(b, pps->log2_max_transform_skip_block_size_minus2);
+        }
+        bs_write_u1(b, pps->cross_component_prediction_enabled_flag);
+        bs_write_u1(b, pps->chroma_qp_offset_list_enabled_flag);
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            bs_write_ue(b, pps->diff_cu_chroma_qp_offset_depth);
+            bs_write_ue(b, pps->chroma_qp_offset_list_len_minus1);
+            for( i = 0; i <= pps->chroma_qp_offset_list_len_minus1 && i < 6; i++ )
+            {
+                bs_write_se(b, pps->cb_qp_offset_list[ i ]);
+                bs_write_se(b, pps->cr_qp_offset_list[ i ]);
+            }
+        }
+        bs_write_ue(b, pps->log2_sao_offset_scale_luma);
+        bs_write_ue(b, pps->log2_sao_offset_scale_chroma);
+    }
+    // the multilayer, 3D and SCC extensions and pps_extension_data_flag are not read
+}
+
+//7.3.2.4 Supplemental enhancement information RBSP syntax
+void write_h265_sei_rbsp(h265_stream_t* h, bs_t* b)
+{
+    if( 0 )
+    {
+        // the messages of the previous SEI are reused, with their payload storage
+        h->num_seis = 0;
+        do {
+            h->num_seis++;
+            h265_sei_pool_reserve(h, h->num_seis);
+            h->sei = h->seis[h->num_seis - 1];
+            write_h265_sei_message(h, b);
+        } while( more_rbsp_data(b) );
+    }
+
+    if( 1 )
+    {
+        for (int i = 0; i < h->num_seis; i++)
+        {
+            h->sei = h->seis[i];
+            write_h265_sei_message(h, b);
+        }
+        h->sei = NULL;
+    }
+}
+
+//7.3.5 Supplemental enhancement information message syntax
+void write_h265_sei_message(h265_stream_t* h, bs_t* b)
+{
+    sei_t* s = h->sei;
+    int i;
+
+    if( 1 )
+    {
+        _write_ff_coded_number(b, s->payloadType);
+        _write_ff_coded_number(b, s->payloadSize);
+    }
+    if( 0 )
+    {
+        s->payloadType = _read_ff_coded_number(b);
+        s->payloadSize = _read_ff_coded_number(b);
+
+        // payloads are kept as bytes, see sei_payload() for H.264
+        if ( s->payloadSize > s->data_capacity )
+        {
+            int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+            s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+            s->data_capacity = capacity;
+        }
+        s->data = s->data_buf;
+    }
+
+    if( 0 && !0 )
+    {
+        int n = bs_read_bytes(b, s->data, s->payloadSize);
+        if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+    }
+    else
+    {
+        for ( i = 0; i < s->payloadSize; i++ )
+        {
+            bs_write_u8(b, s->data[i]);
+        }
+    }
+}
+
+//7.3.2.5 Access unit delimiter RBSP syntax
+void write_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b)
+{
+    bs_write_u(b, 3, h->aud->pic_type);
+}
+
+//7.3.2.9 Slice segment layer RBSP syntax
+void write_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b)
+{
+    write_h265_slice_segment_header(h, b);
+
+    slice_data_rbsp_t* slice_data = h->slice_data;
+
+    if( 0 )
+    {
+        free( slice_data->rbsp_buf );
+        slice_data->rbsp_buf = NULL;
+        slice_data->rbsp_size = 0;
+
+        // the header ends byte aligned, slice_segment_data() and the trailing bits are copied as they are
+        if( h->parse_depth >= H265_PARSE_SLICE_DATA && b->p < b->end )
+        {
+            bs_t bs_tmp;
+            bs_clone(&bs_tmp, b);
+            slice_data->rbsp_buf = (uint8_t*)malloc( bs_tmp.end - bs_tmp.p );
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, bs_tmp.end - bs_tmp.p );
+        }
+    }
+
+    if( 1 && slice_data->rbsp_buf != NULL )
+    {
+        bs_write_bytes( b, slice_data->rbsp_buf, slice_data->rbsp_size );
+    }
+}
+
+//7.3.6.1 General slice segment header syntax
+void write_h265_slice_segment_header(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_nal_t* nal = h->nal;
+    int i;
+
+    if( 0 )
+    {
+        sh->no_output_of_prior_pics_flag = 0;
+        sh->dependent_slice_segment_flag = 0;
+        sh->slice_segment_address = 0;
+    }
+
+    bs_write_u1(b, sh->first_slice_segment_in_pic_flag);
+    if( H265_IS_IRAP( nal->nal_unit_type ) )
+    {
+        bs_write_u1(b, sh->no_output_of_prior_pics_flag);
+    }
+    bs_write_ue(b, sh->slice_pic_parameter_set_id);
+
+    // when writing, the slice segment goes out with the parameter sets in h->pps and h->sps as they are
+    if( 0 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h265_activate_pps(h, sh->slice_pic_parameter_set_id);
+        h265_activate_sps(h, h->pps->pps_seq_parameter_set_id);
+    }
+    h265_pps_t* pps = h->pps;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+
+    if( !sh->first_slice_segment_in_pic_flag )
+    {
+        if( pps->dependent_slice_segments_enabled_flag )
+        {
+            bs_write_u1(b, sh->dependent_slice_segment_flag);
+        }
+        bs_write_u(b,  intlog2( h265_pic_size_in_ctbs( sps ) ) , sh->slice_segment_address);
+    }
+
+    if( 0 && !sh->dependent_slice_segment_flag )
+    {
+        memset(&sh->slice_reserved_flag, 0, sizeof(h265_slice_header_t) - offsetof(h265_slice_header_t, slice_reserved_flag));
+        sh->pic_output_flag = 1;
+        sh->num_ref_idx_l0_active_minus1 = pps->num_ref_idx_l0_default_active_minus1;
+        sh->num_ref_idx_l1_active_minus1 = pps->num_ref_idx_l1_default_active_minus1;
+        sh->collocated_from_l0_flag = 1;
+        sh->slice_deblocking_filter_disabled_flag = pps->pps_deblocking_filter_disabled_flag;
+        sh->slice_beta_offset_div2 = pps->pps_beta_offset_div2;
+        sh->slice_tc_offset_div2 = pps->pps_tc_offset_div2;
+        sh->slice_loop_filter_across_slices_enabled_flag = pps->pps_loop_filter_across_slices_enabled_flag;
+    }
+
+    if( !sh->dependent_slice_segment_flag )
+    {
+        for( i = 0; i < pps->num_extra_slice_header_bits; i++ )
+        {
+            bs_write_u1(b, sh->slice_reserved_flag[ i ]);
+        }
+        bs_write_ue(b, sh->slice_type);
+        if( pps->output_flag_present_flag )
+        {
+            bs_write_u1(b, sh->pic_output_flag);
+        }
+        if( sps->separate_colour_plane_flag )
+        {
+            bs_write_u(b, 2, sh->colour_plane_id);
+        }
+        if( !H265_IS_IDR( nal->nal_unit_type ) )
+        {
+            bs_write_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 , sh->slice_pic_order_cnt_lsb);
+            bs_write_u1(b, sh->short_term_ref_pic_set_sps_flag);
+            if( !sh->short_term_ref_pic_set_sps_flag )
+            {
+                write_h265_st_ref_pic_set(&sh->st_ref_pic_set, sps->st_ref_pic_set, sps->num_short_term_ref_pic_sets, sps->num_short_term_ref_pic_sets, b);
+            }
+            else if( sps->num_short_term_ref_pic_sets > 1 )
+            {
+                bs_write_u(b,  intlog2( sps->num_short_term_ref_pic_sets ) , sh->short_term_ref_pic_set_idx);
+            }
+            if( sps->long_term_ref_pics_present_flag )
+            {
+                if( sps->num_long_term_ref_pics_sps > 0 )
+                {
+                    bs_write_ue(b, sh->num_long_term_sps);
+                }
+                bs_write_ue(b, sh->num_long_term_pics);
+                for( i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++ )
+                {
+                    if( i < sh->num_long_term_sps )
+                    {
+                        if( sps->num_long_term_ref_pics_sps > 1 )
+                        {
+                            bs_write_u(b,  intlog2( sps->num_long_term_ref_pics_sps ) , sh->lt_idx_sps[ i ]);
+                        }
+                    }
+                    else
+                    {
+                        bs_write_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 , sh->poc_lsb_lt[ i ]);
+                        bs_write_u1(b, sh->used_by_curr_pic_lt_flag[ i ]);
+                    }
+                    bs_write_u1(b, sh->delta_poc_msb_present_flag[ i ]);
+                    if( sh->delta_poc_msb_present_flag[ i ] )
+                    {
+                        bs_write_ue(b, sh->delta_poc_msb_cycle_lt[ i ]);
+                    }
+                }
+            }
+            if( sps->sps_temporal_mvp_enabled_flag )
+            {
+                bs_write_u1(b, sh->slice_temporal_mvp_enabled_flag);
+            }
+        }
+        if( sps->sample_adaptive_offset_enabled_flag )
+        {
+            bs_write_u1(b, sh->slice_sao_luma_flag);
+            if( ChromaArrayType != 0 )
+            {
+                bs_write_u1(b, sh->slice_sao_chroma_flag);
+            }
+        }
+        if( sh->slice_type == H265_SH_SLICE_TYPE_P || sh->slice_type == H265_SH_SLICE_TYPE_B )
+        {
+            bs_write_u1(b, sh->num_ref_idx_active_override_flag);
+            if( sh->num_ref_idx_active_override_flag )
+            {
+                bs_write_ue(b, sh->num_ref_idx_l0_active_minus1);
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    bs_write_ue(b, sh->num_ref_idx_l1_active_minus1);
+                }
+            }
+            if( pps->lists_modification_present_flag && h265_num_pic_total_curr(h) > 1 )
+            {
+                write_h265_ref_pic_lists_modification(h, b);
+            }
+            if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+            {
+                bs_write_u1(b, sh->mvd_l1_zero_flag);
+            }
+            if( pps->cabac_init_present_flag )
+            {
+                bs_write_u1(b, sh->cabac_init_flag);
+            }
+            if( sh->slice_temporal_mvp_enabled_flag )
+            {
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    bs_write_u1(b, sh->collocated_from_l0_flag);
+                }
+                if( ( sh->collocated_from_l0_flag && sh->num_ref_idx_l0_active_minus1 > 0 ) ||
+                    ( !sh->collocated_from_l0_flag && sh->num_ref_idx_l1_active_minus1 > 0 ) )
+                {
+                    bs_write_ue(b, sh->collocated_ref_idx);
+                }
+            }
+            if( ( pps->weighted_pred_flag && sh->slice_type == H265_SH_SLICE_TYPE_P ) ||
+                ( pps->weighted_bipred_flag && sh->slice_type == H265_SH_SLICE_TYPE_B ) )
+            {
+                write_h265_pred_weight_table(h, b);
+            }
+            bs_write_ue(b, sh->five_minus_max_num_merge_cand);
+        }
+        bs_write_se(b, sh->slice_qp_delta);
+        if( pps->pps_slice_chroma_qp_offsets_present_flag )
+        {
+            bs_write_se(b, sh->slice_cb_qp_offset);
+            bs_write_se(b, sh->slice_cr_qp_offset);
+        }
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            bs_write_u1(b, sh->cu_chroma_qp_offset_enabled_flag);
+        }
+        if( pps->deblocking_filter_override_enabled_flag )
+        {
+            bs_write_u1(b, sh->deblocking_filter_override_flag);
+        }
+        if( sh->deblocking_filter_override_flag )
+        {
+            bs_write_u1(b, sh->slice_deblocking_filter_disabled_flag);
+            if( !sh->slice_deblocking_filter_disabled_flag )
+            {
+                bs_write_se(b, sh->slice_beta_offset_div2);
+                bs_write_se(b, sh->slice_tc_offset_div2);
+            }
+        }
+        if( pps->pps_loop_filter_across_slices_enabled_flag &&
+            ( sh->slice_sao_luma_flag || sh->slice_sao_chroma_flag || !sh->slice_deblocking_filter_disabled_flag ) )
+        {
+            bs_write_u1(b, sh->slice_loop_filter_across_slices_enabled_flag);
+        }
+    }
+
+    if( 0 )
+    {
+        sh->num_entry_point_offsets = 0;
+        sh->slice_segment_header_extension_length = 0;
+    }
+    if( pps->tiles_enabled_flag || pps->entropy_coding_sync_enabled_flag )
+    {
+        bs_write_ue(b, sh->num_entry_point_offsets);
+        if( sh->num_entry_point_offsets > 0 )
+        {
+            bs_write_ue(b, sh->offset_len_minus1);
+            for( i = 0; i < sh->num_entry_point_offsets && i < H265_MAX_ENTRY_POINTS; i++ )
+            {
+                bs_write_u(b,  sh->offset_len_minus1 + 1 , sh->entry_point_offset_minus1[ i ]);
+            }
+            // the offsets past H265_MAX_ENTRY_POINTS are not kept: stepped over when reading, written as 0
+            for( ; i < sh->num_entry_point_offsets && !bs_eof(b); i++ )
+            {
+                if( 0 ) { bs_skip_u(b, sh->offset_len_minus1 + 1); }
+                if( 1 ) { bs_write_u(b, sh->offset_len_minus1 + 1, 0); }
+            }
+        }
+    }
+    if( pps->slice_segment_header_extension_present_flag )
+    {
+        bs_write_ue(b, sh->slice_segment_header_extension_length);
+        for( i = 0; i < sh->slice_segment_header_extension_length && i < 256; i++ )
+        {
+            bs_write_u8(b, sh->slice_segment_header_extension_data_byte[ i ]);
+        }
+        for( ; i < sh->slice_segment_header_extension_length && !bs_eof(b); i++ )
+        {
+            if( 0 ) { bs_skip_u(b, 8); }
+            if( 1 ) { bs_write_u(b, 8, 0); }
+        }
+    }
+    write_h265_byte_alignment(b);
+}
+
+//7.3.6.2 Reference picture list modification syntax
+void write_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    int n = intlog2( h265_num_pic_total_curr(h) );
+    int i;
+
+    bs_write_u1(b, sh->rplm.ref_pic_list_modification_flag_l0);
+    if( sh->rplm.ref_pic_list_modification_flag_l0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            bs_write_u(b,  n , sh->rplm.list_entry_l0[ i ]);
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        bs_write_u1(b, sh->rplm.ref_pic_list_modification_flag_l1);
+        if( sh->rplm.ref_pic_list_modification_flag_l1 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                bs_write_u(b,  n , sh->rplm.list_entry_l1[ i ]);
+            }
+        }
+    }
+}
+
+//7.3.6.3 Weighted prediction parameters syntax
+// luma_weight_lX_flag and chroma_weight_lX_flag are read for every reference picture: a reference can only have the
+// POC of the current picture with the screen content extension, which is not read
+void write_h265_pred_weight_table(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+    int i, j;
+
+    bs_write_ue(b, sh->pwt.luma_log2_weight_denom);
+    if( ChromaArrayType != 0 )
+    {
+        bs_write_se(b, sh->pwt.delta_chroma_log2_weight_denom);
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        bs_write_u1(b, sh->pwt.luma_weight_l0_flag[ i ]);
+    }
+    if( ChromaArrayType != 0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            bs_write_u1(b, sh->pwt.chroma_weight_l0_flag[ i ]);
+        }
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        if( sh->pwt.luma_weight_l0_flag[ i ] )
+        {
+            bs_write_se(b, sh->pwt.delta_luma_weight_l0[ i ]);
+            bs_write_se(b, sh->pwt.luma_offset_l0[ i ]);
+        }
+        if( sh->pwt.chroma_weight_l0_flag[ i ] )
+        {
+            for( j = 0; j < 2; j++ )
+            {
+                bs_write_se(b, sh->pwt.delta_chroma_weight_l0[ i ][ j ]);
+                bs_write_se(b, sh->pwt.delta_chroma_offset_l0[ i ][ j ]);
+            }
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            bs_write_u1(b, sh->pwt.luma_weight_l1_flag[ i ]);
+        }
+        if( ChromaArrayType != 0 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                bs_write_u1(b, sh->pwt.chroma_weight_l1_flag[ i ]);
+            }
+        }
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            if( sh->pwt.luma_weight_l1_flag[ i ] )
+            {
+                bs_write_se(b, sh->pwt.delta_luma_weight_l1[ i ]);
+                bs_write_se(b, sh->pwt.luma_offset_l1[ i ]);
+            }
+            if( sh->pwt.chroma_weight_l1_flag[ i ] )
+            {
+                for( j = 0; j < 2; j++ )
+                {
+                    bs_write_se(b, sh->pwt.delta_chroma_weight_l1[ i ][ j ]);
+                    bs_write_se(b, sh->pwt.delta_chroma_offset_l1[ i ][ j ]);
+                }
+            }
+        }
+    }
+}
+
+//7.3.2.11 RBSP trailing bits syntax
+void write_h265_rbsp_trailing_bits(bs_t* b)
+{
+    /* rbsp_stop_one_bit */ bs_write_u(b, 1, 1);
+
+    while( !bs_byte_aligned(b) )
+    {
+        /* rbsp_alignment_zero_bit */ bs_write_u(b, 1, 0);
+    }
+}
+
+//7.3.2.12 Byte alignment syntax
+void write_h265_byte_alignment(bs_t* b)
+{
+    /* alignment_bit_equal_to_one */ bs_write_u(b, 1, 1);
+
+    while( !bs_byte_aligned(b) )
+    {
+        /* alignment_bit_equal_to_zero */ bs_write_u(b, 1, 0);
+    }
+}
+
+
+void read_debug_h265_nal_unit_header(h265_nal_t* nal, bs_t* b);
+void read_debug_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b);
+void read_debug_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void read_debug_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b);
+void read_debug_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b);
+void read_debug_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b);
+void read_debug_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b);
+void read_debug_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b);
+void read_debug_h265_vui_parameters(h265_sps_t* sps, bs_t* b);
+void read_debug_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b);
+void read_debug_h265_sei_rbsp(h265_stream_t* h, bs_t* b);
+void read_debug_h265_sei_message(h265_stream_t* h, bs_t* b);
+void read_debug_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b);
+void read_debug_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b);
+void read_debug_h265_slice_segment_header(h265_stream_t* h, bs_t* b);
+void read_debug_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b);
+void read_debug_h265_pred_weight_table(h265_stream_t* h, bs_t* b);
+void read_debug_h265_rbsp_trailing_bits(bs_t* b);
+void read_debug_h265_byte_alignment(bs_t* b);
+
+
+
+
+//7.3.1.1 General NAL unit syntax
+int read_debug_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    int nal_size = size;
+    int rbsp_size = size;
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
+
+    if( 1 )
+    {
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
+    }
+
+    if( 0 )
+    {
+        rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
+    }
+
+    read_debug_h265_nal_unit_header(nal, b);
+
+    if( 1 && h->parse_depth < H265_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
+    switch ( nal->nal_unit_type )
+    {
+        case H265_NAL_UNIT_TYPE_TRAIL_N:
+        case H265_NAL_UNIT_TYPE_TRAIL_R:
+        case H265_NAL_UNIT_TYPE_TSA_N:
+        case H265_NAL_UNIT_TYPE_TSA_R:
+        case H265_NAL_UNIT_TYPE_STSA_N:
+        case H265_NAL_UNIT_TYPE_STSA_R:
+        case H265_NAL_UNIT_TYPE_RADL_N:
+        case H265_NAL_UNIT_TYPE_RADL_R:
+        case H265_NAL_UNIT_TYPE_RASL_N:
+        case H265_NAL_UNIT_TYPE_RASL_R:
+        case H265_NAL_UNIT_TYPE_BLA_W_LP:
+        case H265_NAL_UNIT_TYPE_BLA_W_RADL:
+        case H265_NAL_UNIT_TYPE_BLA_N_LP:
+        case H265_NAL_UNIT_TYPE_IDR_W_RADL:
+        case H265_NAL_UNIT_TYPE_IDR_N_LP:
+        case H265_NAL_UNIT_TYPE_CRA_NUT:
+            read_debug_h265_slice_segment_layer_rbsp(h, b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_VPS:
+            if( 1 && !1 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_debug_h265_video_parameter_set_rbsp(h->vps, b);
+            if( h->vps->incomplete ) { free(rbsp_buf); return -1; }
+            read_debug_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->vps->vps_video_parameter_set_id;
+                memcpy(h265_vps_slot(h, id), h->vps, sizeof(h265_vps_t));
+                h->vps_table_hash[id] = h264_nal_hash(buf, nal_size);
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_SPS:
+            if( 1 && !1 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_debug_h265_seq_parameter_set_rbsp(h->sps, b);
+            if( h->sps->incomplete ) { free(rbsp_buf); h->sps_hash = 0; return -1; }
+            read_debug_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->sps->sps_seq_parameter_set_id;
+                if( id >= 16 ) { return -1; }
+                memcpy(h265_sps_slot(h, id), h->sps, sizeof(h265_sps_t));
+                h->sps_hash = h264_nal_hash(buf, nal_size);
+                h->sps_table_hash[id] = h->sps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_PPS:
+            if( 1 && !1 && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            read_debug_h265_pic_parameter_set_rbsp(h->pps, b);
+            read_debug_h265_rbsp_trailing_bits(b);
+
+            if( 1 )
+            {
+                int id = h->pps->pps_pic_parameter_set_id;
+                if( id >= 64 ) { return -1; }
+                memcpy(h265_pps_slot(h, id), h->pps, sizeof(h265_pps_t));
+                h->pps_hash = h264_nal_hash(buf, nal_size);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_AUD:
+            read_debug_h265_access_unit_delimiter_rbsp(h, b);
+            read_debug_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_PREFIX_SEI:
+        case H265_NAL_UNIT_TYPE_SUFFIX_SEI:
+            read_debug_h265_sei_rbsp(h, b);
+            read_debug_h265_rbsp_trailing_bits(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_EOS:
+        case H265_NAL_UNIT_TYPE_EOB:
+            // 7.3.2.6, 7.3.2.7 the rbsp is empty
+            break;
+
+        case H265_NAL_UNIT_TYPE_FD:
+        default:
+            free(rbsp_buf);
+            return -1;
+    }
+
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
+
+    if( 0 )
+    {
+        // now get the actual size used
+        rbsp_size = bs_pos(b);
+
+        int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
+        if (rc < 0) { free(rbsp_buf); return -1; }
+    }
+
+    free(rbsp_buf);
+
+    return nal_size;
+}
+
+//7.3.1.2 NAL unit header syntax
+void read_debug_h265_nal_unit_header(h265_nal_t* nal, bs_t* b)
+{
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int forbidden_zero_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x3A3AE9DDu, "forbidden_zero_bit", forbidden_zero_bit); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->nal_unit_type = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0x8FC50732u, "nal->nal_unit_type", nal->nal_unit_type); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->nuh_layer_id = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0x242E66BCu, "nal->nuh_layer_id", nal->nuh_layer_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; nal->nuh_temporal_id_plus1 = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x26DD7DD3u, "nal->nuh_temporal_id_plus1", nal->nuh_temporal_id_plus1); }
+}
+
+//7.3.2.1 Video parameter set RBSP syntax
+void read_debug_h265_video_parameter_set_rbsp(h265_vps_t* vps, bs_t* b)
+{
+    int i, j;
+
+    if( 1 )
+    {
+        memset(vps, 0, sizeof(h265_vps_t));
+    }
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_video_parameter_set_id = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x6408F9AFu, "vps->vps_video_parameter_set_id", vps->vps_video_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_base_layer_internal_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9A3CFD9Fu, "vps->vps_base_layer_internal_flag", vps->vps_base_layer_internal_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_base_layer_available_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE1807667u, "vps->vps_base_layer_available_flag", vps->vps_base_layer_available_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_layers_minus1 = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0x4FCEA6CCu, "vps->vps_max_layers_minus1", vps->vps_max_layers_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_sub_layers_minus1 = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0xE400DDFDu, "vps->vps_max_sub_layers_minus1", vps->vps_max_sub_layers_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_temporal_id_nesting_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x82AD2639u, "vps->vps_temporal_id_nesting_flag", vps->vps_temporal_id_nesting_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int vps_reserved_0xffff_16bits = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0xBA1F5460u, "vps_reserved_0xffff_16bits", vps_reserved_0xffff_16bits); }
+    read_debug_h265_profile_tier_level(&vps->ptl, 1, vps->vps_max_sub_layers_minus1, b);
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_sub_layer_ordering_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF6A1437Eu, "vps->vps_sub_layer_ordering_info_present_flag", vps->vps_sub_layer_ordering_info_present_flag); }
+    for( i = ( vps->vps_sub_layer_ordering_info_present_flag ? 0 : vps->vps_max_sub_layers_minus1 );
+         i <= vps->vps_max_sub_layers_minus1; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_dec_pic_buffering_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x037C30D1u, "vps->vps_max_dec_pic_buffering_minus1[ i ]", vps->vps_max_dec_pic_buffering_minus1[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_num_reorder_pics[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x0C628AC5u, "vps->vps_max_num_reorder_pics[ i ]", vps->vps_max_num_reorder_pics[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_latency_increase_plus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8EFB4EFCu, "vps->vps_max_latency_increase_plus1[ i ]", vps->vps_max_latency_increase_plus1[ i ]); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_max_layer_id = bs_read_u(b, 6); h264_debug_value(_pos, _bits_left, 0xB8F9A1CBu, "vps->vps_max_layer_id", vps->vps_max_layer_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_num_layer_sets_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDBC8B781u, "vps->vps_num_layer_sets_minus1", vps->vps_num_layer_sets_minus1); }
+    if( vps->vps_num_layer_sets_minus1 >= H265_MAX_LAYER_SETS )
+    {
+        // not read past here
+        vps->incomplete = 1;
+        return;
+    }
+    for( i = 1; i <= vps->vps_num_layer_sets_minus1; i++ )
+    {
+        for( j = 0; j <= vps->vps_max_layer_id; j++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->layer_id_included_flag[ i ][ j ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xCCBBAA63u, "vps->layer_id_included_flag[ i ][ j ]", vps->layer_id_included_flag[ i ][ j ]); }
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_timing_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x552A5215u, "vps->vps_timing_info_present_flag", vps->vps_timing_info_present_flag); }
+    if( vps->vps_timing_info_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_num_units_in_tick = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0x73554853u, "vps->vps_num_units_in_tick", vps->vps_num_units_in_tick); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_time_scale = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0xFAD6803Bu, "vps->vps_time_scale", vps->vps_time_scale); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_poc_proportional_to_timing_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xAE14EC5Bu, "vps->vps_poc_proportional_to_timing_flag", vps->vps_poc_proportional_to_timing_flag); }
+        if( vps->vps_poc_proportional_to_timing_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_num_ticks_poc_diff_one_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBCD737A4u, "vps->vps_num_ticks_poc_diff_one_minus1", vps->vps_num_ticks_poc_diff_one_minus1); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_num_hrd_parameters = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x827EAC95u, "vps->vps_num_hrd_parameters", vps->vps_num_hrd_parameters); }
+        if( vps->vps_num_hrd_parameters > H265_MAX_VPS_HRD )
+        {
+            // not read past here
+            vps->incomplete = 1;
+            return;
+        }
+        for( i = 0; i < vps->vps_num_hrd_parameters; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->hrd_layer_set_idx[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9B27317Fu, "vps->hrd_layer_set_idx[ i ]", vps->hrd_layer_set_idx[ i ]); }
+            if( i > 0 )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->cprms_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC7EFED32u, "vps->cprms_present_flag[ i ]", vps->cprms_present_flag[ i ]); }
+            }
+            else if( 1 )
+            {
+                vps->cprms_present_flag[ i ] = 1;
+            }
+            read_debug_h265_hrd_parameters(&vps->hrd[ i ], vps->cprms_present_flag[ i ], vps->vps_max_sub_layers_minus1, b);
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; vps->vps_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDEA5BB27u, "vps->vps_extension_flag", vps->vps_extension_flag); }
+    // vps_extension_data_flag (multilayer and 3D) is not read
+}
+
+//7.3.3 Profile, tier and level syntax
+void read_debug_h265_profile_tier_level(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i, j;
+
+    if( profilePresentFlag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_profile_space = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xDCF3B56Fu, "ptl->general_profile_space", ptl->general_profile_space); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_tier_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3F2B10FCu, "ptl->general_tier_flag", ptl->general_tier_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_profile_idc = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x13236CD7u, "ptl->general_profile_idc", ptl->general_profile_idc); }
+        for( j = 0; j < 32; j++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_profile_compatibility_flag[ j ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x47E93900u, "ptl->general_profile_compatibility_flag[ j ]", ptl->general_profile_compatibility_flag[ j ]); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_progressive_source_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x92D2963Bu, "ptl->general_progressive_source_flag", ptl->general_progressive_source_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_interlaced_source_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD7AC31A1u, "ptl->general_interlaced_source_flag", ptl->general_interlaced_source_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_non_packed_constraint_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x2DF931D0u, "ptl->general_non_packed_constraint_flag", ptl->general_non_packed_constraint_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_frame_only_constraint_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3BE62930u, "ptl->general_frame_only_constraint_flag", ptl->general_frame_only_constraint_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_reserved_zero_44bits[ 0 ] = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0x41725361u, "ptl->general_reserved_zero_44bits[ 0 ]", ptl->general_reserved_zero_44bits[ 0 ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_reserved_zero_44bits[ 1 ] = bs_read_u(b, 12); h264_debug_value(_pos, _bits_left, 0x6E58EA56u, "ptl->general_reserved_zero_44bits[ 1 ]", ptl->general_reserved_zero_44bits[ 1 ]); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->general_level_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xDB3FD268u, "ptl->general_level_idc", ptl->general_level_idc); }
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer_profile_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA09A178Au, "ptl->sub_layer_profile_present_flag[ i ]", ptl->sub_layer_profile_present_flag[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer_level_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1B5E7CB1u, "ptl->sub_layer_level_present_flag[ i ]", ptl->sub_layer_level_present_flag[ i ]); }
+    }
+    if( maxNumSubLayersMinus1 > 0 )
+    {
+        for( i = maxNumSubLayersMinus1; i < 8; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int reserved_zero_2bits = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0xB740DD25u, "reserved_zero_2bits", reserved_zero_2bits); }
+        }
+    }
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        if( ptl->sub_layer_profile_present_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_profile_space = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x2B0C7688u, "ptl->sub_layer[ i ].sub_layer_profile_space", ptl->sub_layer[ i ].sub_layer_profile_space); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_tier_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC6E51FABu, "ptl->sub_layer[ i ].sub_layer_tier_flag", ptl->sub_layer[ i ].sub_layer_tier_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_profile_idc = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x8B16EAC0u, "ptl->sub_layer[ i ].sub_layer_profile_idc", ptl->sub_layer[ i ].sub_layer_profile_idc); }
+            for( j = 0; j < 32; j++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x539EDB23u, "ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ]", ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ]); }
+            }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_progressive_source_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7E98AB18u, "ptl->sub_layer[ i ].sub_layer_progressive_source_flag", ptl->sub_layer[ i ].sub_layer_progressive_source_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_interlaced_source_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x5BD66110u, "ptl->sub_layer[ i ].sub_layer_interlaced_source_flag", ptl->sub_layer[ i ].sub_layer_interlaced_source_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x603DC9F5u, "ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag", ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x96E7A7C9u, "ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag", ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ] = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0xEAB22622u, "ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ]", ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ] = bs_read_u(b, 12); h264_debug_value(_pos, _bits_left, 0xBD2DBE6Du, "ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ]", ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ]); }
+        }
+        if( ptl->sub_layer_level_present_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ptl->sub_layer[ i ].sub_layer_level_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xBD0BDABFu, "ptl->sub_layer[ i ].sub_layer_level_idc", ptl->sub_layer[ i ].sub_layer_level_idc); }
+        }
+    }
+}
+
+//E.2.2 HRD parameters syntax
+void read_debug_h265_hrd_parameters(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i;
+
+    if( commonInfPresentFlag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->nal_hrd_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x0F5CBD84u, "hrd->nal_hrd_parameters_present_flag", hrd->nal_hrd_parameters_present_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->vcl_hrd_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xAD859CEAu, "hrd->vcl_hrd_parameters_present_flag", hrd->vcl_hrd_parameters_present_flag); }
+        if( hrd->nal_hrd_parameters_present_flag || hrd->vcl_hrd_parameters_present_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->sub_pic_hrd_params_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD9BBC128u, "hrd->sub_pic_hrd_params_present_flag", hrd->sub_pic_hrd_params_present_flag); }
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->tick_divisor_minus2 = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xAB97C06Du, "hrd->tick_divisor_minus2", hrd->tick_divisor_minus2); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->du_cpb_removal_delay_increment_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xED4361C9u, "hrd->du_cpb_removal_delay_increment_length_minus1", hrd->du_cpb_removal_delay_increment_length_minus1); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->sub_pic_cpb_params_in_pic_timing_sei_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4014BE85u, "hrd->sub_pic_cpb_params_in_pic_timing_sei_flag", hrd->sub_pic_cpb_params_in_pic_timing_sei_flag); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->dpb_output_delay_du_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x30F2508Fu, "hrd->dpb_output_delay_du_length_minus1", hrd->dpb_output_delay_du_length_minus1); }
+            }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->bit_rate_scale = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x789F7519u, "hrd->bit_rate_scale", hrd->bit_rate_scale); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_size_scale = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xBCE2EED2u, "hrd->cpb_size_scale", hrd->cpb_size_scale); }
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_size_du_scale = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xC2EF5C56u, "hrd->cpb_size_du_scale", hrd->cpb_size_du_scale); }
+            }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->initial_cpb_removal_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xFE8EAC8Cu, "hrd->initial_cpb_removal_delay_length_minus1", hrd->initial_cpb_removal_delay_length_minus1); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->au_cpb_removal_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0x71CBF112u, "hrd->au_cpb_removal_delay_length_minus1", hrd->au_cpb_removal_delay_length_minus1); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->dpb_output_delay_length_minus1 = bs_read_u(b, 5); h264_debug_value(_pos, _bits_left, 0xBC80045Du, "hrd->dpb_output_delay_length_minus1", hrd->dpb_output_delay_length_minus1); }
+        }
+    }
+    for( i = 0; i <= maxNumSubLayersMinus1; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->fixed_pic_rate_general_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x92DD7109u, "hrd->fixed_pic_rate_general_flag[ i ]", hrd->fixed_pic_rate_general_flag[ i ]); }
+        if( 1 )
+        {
+            hrd->fixed_pic_rate_within_cvs_flag[ i ] = hrd->fixed_pic_rate_general_flag[ i ];
+            hrd->low_delay_hrd_flag[ i ] = 0;
+            hrd->cpb_cnt_minus1[ i ] = 0;
+        }
+        if( !hrd->fixed_pic_rate_general_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->fixed_pic_rate_within_cvs_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE08888C5u, "hrd->fixed_pic_rate_within_cvs_flag[ i ]", hrd->fixed_pic_rate_within_cvs_flag[ i ]); }
+        }
+        if( hrd->fixed_pic_rate_within_cvs_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->elemental_duration_in_tc_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBA03CEBDu, "hrd->elemental_duration_in_tc_minus1[ i ]", hrd->elemental_duration_in_tc_minus1[ i ]); }
+        }
+        else
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->low_delay_hrd_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA8079D2Du, "hrd->low_delay_hrd_flag[ i ]", hrd->low_delay_hrd_flag[ i ]); }
+        }
+        if( !hrd->low_delay_hrd_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; hrd->cpb_cnt_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xABAF249Au, "hrd->cpb_cnt_minus1[ i ]", hrd->cpb_cnt_minus1[ i ]); }
+        }
+        if( hrd->nal_hrd_parameters_present_flag )
+        {
+            read_debug_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_nal[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+        if( hrd->vcl_hrd_parameters_present_flag )
+        {
+            read_debug_h265_sub_layer_hrd_parameters(&hrd->sub_layer_hrd_vcl[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+    }
+}
+
+//E.2.3 Sub-layer HRD parameters syntax
+void read_debug_h265_sub_layer_hrd_parameters(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b)
+{
+    int i;
+
+    for( i = 0; i <= cpb_cnt_minus1 && i < H265_MAX_CPB_CNT; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sub->bit_rate_value_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xF0D42C0Du, "sub->bit_rate_value_minus1[ i ]", sub->bit_rate_value_minus1[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sub->cpb_size_value_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE9A78CAAu, "sub->cpb_size_value_minus1[ i ]", sub->cpb_size_value_minus1[ i ]); }
+        if( sub_pic_hrd_params_present_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sub->cpb_size_du_value_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x530C95D6u, "sub->cpb_size_du_value_minus1[ i ]", sub->cpb_size_du_value_minus1[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sub->bit_rate_du_value_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBF2EB65Fu, "sub->bit_rate_du_value_minus1[ i ]", sub->bit_rate_du_value_minus1[ i ]); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sub->cbr_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x49E02CABu, "sub->cbr_flag[ i ]", sub->cbr_flag[ i ]); }
+    }
+}
+
+//7.3.2.2.1 General sequence parameter set RBSP syntax
+void read_debug_h265_seq_parameter_set_rbsp(h265_sps_t* sps, bs_t* b)
+{
+    int i;
+
+    if( 1 )
+    {
+        memset(sps, 0, sizeof(h265_sps_t));
+    }
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_video_parameter_set_id = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xC7BCBB15u, "sps->sps_video_parameter_set_id", sps->sps_video_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_max_sub_layers_minus1 = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x2AB12A3Bu, "sps->sps_max_sub_layers_minus1", sps->sps_max_sub_layers_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_temporal_id_nesting_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x76B0635Bu, "sps->sps_temporal_id_nesting_flag", sps->sps_temporal_id_nesting_flag); }
+    read_debug_h265_profile_tier_level(&sps->ptl, 1, sps->sps_max_sub_layers_minus1, b);
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_seq_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x5D317425u, "sps->sps_seq_parameter_set_id", sps->sps_seq_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->chroma_format_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x6F6238B5u, "sps->chroma_format_idc", sps->chroma_format_idc); }
+    if( sps->chroma_format_idc == 3 )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->separate_colour_plane_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x8980B2F2u, "sps->separate_colour_plane_flag", sps->separate_colour_plane_flag); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pic_width_in_luma_samples = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD1409991u, "sps->pic_width_in_luma_samples", sps->pic_width_in_luma_samples); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pic_height_in_luma_samples = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC53ACD24u, "sps->pic_height_in_luma_samples", sps->pic_height_in_luma_samples); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->conformance_window_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDF2921C1u, "sps->conformance_window_flag", sps->conformance_window_flag); }
+    if( sps->conformance_window_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->conf_win_left_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x04ABB7E9u, "sps->conf_win_left_offset", sps->conf_win_left_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->conf_win_right_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xF6288090u, "sps->conf_win_right_offset", sps->conf_win_right_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->conf_win_top_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8C12306Bu, "sps->conf_win_top_offset", sps->conf_win_top_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->conf_win_bottom_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x400A8DA3u, "sps->conf_win_bottom_offset", sps->conf_win_bottom_offset); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->bit_depth_luma_minus8 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x664F05FCu, "sps->bit_depth_luma_minus8", sps->bit_depth_luma_minus8); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->bit_depth_chroma_minus8 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xBBEFF3D9u, "sps->bit_depth_chroma_minus8", sps->bit_depth_chroma_minus8); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_max_pic_order_cnt_lsb_minus4 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x2A686A28u, "sps->log2_max_pic_order_cnt_lsb_minus4", sps->log2_max_pic_order_cnt_lsb_minus4); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_sub_layer_ordering_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x0269E828u, "sps->sps_sub_layer_ordering_info_present_flag", sps->sps_sub_layer_ordering_info_present_flag); }
+    for( i = ( sps->sps_sub_layer_ordering_info_present_flag ? 0 : sps->sps_max_sub_layers_minus1 );
+         i <= sps->sps_max_sub_layers_minus1; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_max_dec_pic_buffering_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x42C46877u, "sps->sps_max_dec_pic_buffering_minus1[ i ]", sps->sps_max_dec_pic_buffering_minus1[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_max_num_reorder_pics[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x0CCA8253u, "sps->sps_max_num_reorder_pics[ i ]", sps->sps_max_num_reorder_pics[ i ]); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_max_latency_increase_plus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1BEFE462u, "sps->sps_max_latency_increase_plus1[ i ]", sps->sps_max_latency_increase_plus1[ i ]); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_min_luma_coding_block_size_minus3 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xAE85B52Eu, "sps->log2_min_luma_coding_block_size_minus3", sps->log2_min_luma_coding_block_size_minus3); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_diff_max_min_luma_coding_block_size = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB7735B43u, "sps->log2_diff_max_min_luma_coding_block_size", sps->log2_diff_max_min_luma_coding_block_size); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_min_luma_transform_block_size_minus2 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x8F6239DBu, "sps->log2_min_luma_transform_block_size_minus2", sps->log2_min_luma_transform_block_size_minus2); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_diff_max_min_luma_transform_block_size = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE66B98E7u, "sps->log2_diff_max_min_luma_transform_block_size", sps->log2_diff_max_min_luma_transform_block_size); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->max_transform_hierarchy_depth_inter = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB89B66E6u, "sps->max_transform_hierarchy_depth_inter", sps->max_transform_hierarchy_depth_inter); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->max_transform_hierarchy_depth_intra = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xAF85926Cu, "sps->max_transform_hierarchy_depth_intra", sps->max_transform_hierarchy_depth_intra); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->scaling_list_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBECFCD73u, "sps->scaling_list_enabled_flag", sps->scaling_list_enabled_flag); }
+    if( sps->scaling_list_enabled_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_scaling_list_data_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x101F616Bu, "sps->sps_scaling_list_data_present_flag", sps->sps_scaling_list_data_present_flag); }
+        if( sps->sps_scaling_list_data_present_flag )
+        {
+            read_debug_h265_scaling_list_data(&sps->scaling_list, b);
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->amp_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB71299BFu, "sps->amp_enabled_flag", sps->amp_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sample_adaptive_offset_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA8BBCD36u, "sps->sample_adaptive_offset_enabled_flag", sps->sample_adaptive_offset_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pcm_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xCAAFBA51u, "sps->pcm_enabled_flag", sps->pcm_enabled_flag); }
+    if( sps->pcm_enabled_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pcm_sample_bit_depth_luma_minus1 = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x67BA183Bu, "sps->pcm_sample_bit_depth_luma_minus1", sps->pcm_sample_bit_depth_luma_minus1); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pcm_sample_bit_depth_chroma_minus1 = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xACC1558Au, "sps->pcm_sample_bit_depth_chroma_minus1", sps->pcm_sample_bit_depth_chroma_minus1); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_min_pcm_luma_coding_block_size_minus3 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1ECD4A0Du, "sps->log2_min_pcm_luma_coding_block_size_minus3", sps->log2_min_pcm_luma_coding_block_size_minus3); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->log2_diff_max_min_pcm_luma_coding_block_size = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE3DA771Eu, "sps->log2_diff_max_min_pcm_luma_coding_block_size", sps->log2_diff_max_min_pcm_luma_coding_block_size); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->pcm_loop_filter_disabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE990DE5Au, "sps->pcm_loop_filter_disabled_flag", sps->pcm_loop_filter_disabled_flag); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->num_short_term_ref_pic_sets = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7632E4E3u, "sps->num_short_term_ref_pic_sets", sps->num_short_term_ref_pic_sets); }
+    if( sps->num_short_term_ref_pic_sets > H265_MAX_SHORT_TERM_RPS )
+    {
+        // not read past here
+        sps->incomplete = 1;
+        return;
+    }
+    for( i = 0; i < sps->num_short_term_ref_pic_sets; i++ )
+    {
+        read_debug_h265_st_ref_pic_set(&sps->st_ref_pic_set[ i ], sps->st_ref_pic_set, i, sps->num_short_term_ref_pic_sets, b);
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->long_term_ref_pics_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x547C2FFCu, "sps->long_term_ref_pics_present_flag", sps->long_term_ref_pics_present_flag); }
+    if( sps->long_term_ref_pics_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->num_long_term_ref_pics_sps = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9172D593u, "sps->num_long_term_ref_pics_sps", sps->num_long_term_ref_pics_sps); }
+        for( i = 0; i < sps->num_long_term_ref_pics_sps && i < H265_MAX_LONG_TERM_PICS; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->lt_ref_pic_poc_lsb_sps[ i ] = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0xDC1992DEu, "sps->lt_ref_pic_poc_lsb_sps[ i ]", sps->lt_ref_pic_poc_lsb_sps[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->used_by_curr_pic_lt_sps_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x08FE6823u, "sps->used_by_curr_pic_lt_sps_flag[ i ]", sps->used_by_curr_pic_lt_sps_flag[ i ]); }
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_temporal_mvp_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDE4A3E4Eu, "sps->sps_temporal_mvp_enabled_flag", sps->sps_temporal_mvp_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->strong_intra_smoothing_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x453DF102u, "sps->strong_intra_smoothing_enabled_flag", sps->strong_intra_smoothing_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA58884FCu, "sps->vui_parameters_present_flag", sps->vui_parameters_present_flag); }
+    if( sps->vui_parameters_present_flag )
+    {
+        read_debug_h265_vui_parameters(sps, b);
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_extension_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x761E7BFDu, "sps->sps_extension_present_flag", sps->sps_extension_present_flag); }
+    if( sps->sps_extension_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_range_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x51787607u, "sps->sps_range_extension_flag", sps->sps_range_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_multilayer_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xEF49FFC0u, "sps->sps_multilayer_extension_flag", sps->sps_multilayer_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_3d_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x715E2C87u, "sps->sps_3d_extension_flag", sps->sps_3d_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_scc_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC721FF91u, "sps->sps_scc_extension_flag", sps->sps_scc_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->sps_extension_4bits = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0xDF1EFE05u, "sps->sps_extension_4bits", sps->sps_extension_4bits); }
+    }
+    if( sps->sps_range_extension_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->transform_skip_rotation_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9DA3BB7Eu, "sps->transform_skip_rotation_enabled_flag", sps->transform_skip_rotation_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->transform_skip_context_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x71F61ECBu, "sps->transform_skip_context_enabled_flag", sps->transform_skip_context_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->implicit_rdpcm_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xEA3EF793u, "sps->implicit_rdpcm_enabled_flag", sps->implicit_rdpcm_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->explicit_rdpcm_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x36BFE51Eu, "sps->explicit_rdpcm_enabled_flag", sps->explicit_rdpcm_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->extended_precision_processing_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDDC05B27u, "sps->extended_precision_processing_flag", sps->extended_precision_processing_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->intra_smoothing_disabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4B3B3539u, "sps->intra_smoothing_disabled_flag", sps->intra_smoothing_disabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->high_precision_offsets_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xCC0F6A41u, "sps->high_precision_offsets_enabled_flag", sps->high_precision_offsets_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->persistent_rice_adaptation_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x534473E2u, "sps->persistent_rice_adaptation_enabled_flag", sps->persistent_rice_adaptation_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->cabac_bypass_alignment_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x14C59B12u, "sps->cabac_bypass_alignment_enabled_flag", sps->cabac_bypass_alignment_enabled_flag); }
+    }
+    // the multilayer, 3D and SCC extensions and sps_extension_data_flag are not read
+}
+
+//7.3.4 Scaling list data syntax
+void read_debug_h265_scaling_list_data(h265_scaling_list_t* sl, bs_t* b)
+{
+    int sizeId, matrixId, i;
+    int scaling_list_delta_coef;
+
+    for( sizeId = 0; sizeId < 4; sizeId++ )
+    {
+        for( matrixId = 0; matrixId < 6; matrixId += ( sizeId == 3 ) ? 3 : 1 )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA1A219FAu, "sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ]", sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ]); }
+            if( !sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x5FBFB28Au, "sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ]", sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ]); }
+            }
+            else
+            {
+                int nextCoef = 8;
+                int coefNum = ( sizeId == 0 ) ? 16 : 64;
+                if( sizeId > 1 )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD69DE4DDu, "sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ]", sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ]); }
+                    nextCoef = sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] + 8;
+                }
+                for( i = 0; i < coefNum; i++ )
+                {
+                    if( 0 )
+                    {
+                        // any difference that comes out the same modulo 256 will do, take the one in -128..127
+                        scaling_list_delta_coef = ( ( sl->ScalingList[ sizeId ][ matrixId ][ i ] - nextCoef + 128 ) & 255 ) - 128;
+                    }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; scaling_list_delta_coef = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xEF1C2BE2u, "scaling_list_delta_coef", scaling_list_delta_coef); }
+                    nextCoef = ( nextCoef + scaling_list_delta_coef + 256 ) % 256;
+                    if( 1 )
+                    {
+                        sl->ScalingList[ sizeId ][ matrixId ][ i ] = nextCoef;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//7.3.7 Short-term reference picture set syntax
+void read_debug_h265_st_ref_pic_set(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b)
+{
+    int i, j;
+
+    if( 1 )
+    {
+        memset(rps, 0, sizeof(h265_st_ref_pic_set_t));
+    }
+
+    if( stRpsIdx != 0 )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->inter_ref_pic_set_prediction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3A0275BAu, "rps->inter_ref_pic_set_prediction_flag", rps->inter_ref_pic_set_prediction_flag); }
+    }
+    if( rps->inter_ref_pic_set_prediction_flag )
+    {
+        if( stRpsIdx == num_short_term_ref_pic_sets )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->delta_idx_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xC81F82F3u, "rps->delta_idx_minus1", rps->delta_idx_minus1); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->delta_rps_sign = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x0816B24Du, "rps->delta_rps_sign", rps->delta_rps_sign); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->abs_delta_rps_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x20AC3E12u, "rps->abs_delta_rps_minus1", rps->abs_delta_rps_minus1); }
+
+        int RefRpsIdx = stRpsIdx - ( rps->delta_idx_minus1 + 1 );
+        if( RefRpsIdx < 0 || RefRpsIdx >= H265_MAX_SHORT_TERM_RPS ) { RefRpsIdx = 0; }
+        h265_st_ref_pic_set_t* ref = &sets[ RefRpsIdx ];
+
+        for( j = 0; j <= ref->NumDeltaPocs; j++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->used_by_curr_pic_flag[ j ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF3D8DEB9u, "rps->used_by_curr_pic_flag[ j ]", rps->used_by_curr_pic_flag[ j ]); }
+            if( !rps->used_by_curr_pic_flag[ j ] )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->use_delta_flag[ j ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE4A003BEu, "rps->use_delta_flag[ j ]", rps->use_delta_flag[ j ]); }
+            }
+        }
+        h265_st_ref_pic_set_derive(rps, ref);
+    }
+    else
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->num_negative_pics = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x2F54456Bu, "rps->num_negative_pics", rps->num_negative_pics); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->num_positive_pics = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD598323Fu, "rps->num_positive_pics", rps->num_positive_pics); }
+        for( i = 0; i < rps->num_negative_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->delta_poc_s0_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB6601BFBu, "rps->delta_poc_s0_minus1[ i ]", rps->delta_poc_s0_minus1[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->used_by_curr_pic_s0_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFDED2E4Eu, "rps->used_by_curr_pic_s0_flag[ i ]", rps->used_by_curr_pic_s0_flag[ i ]); }
+        }
+        for( i = 0; i < rps->num_positive_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->delta_poc_s1_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x5ABA5C2Cu, "rps->delta_poc_s1_minus1[ i ]", rps->delta_poc_s1_minus1[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; rps->used_by_curr_pic_s1_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7D26C529u, "rps->used_by_curr_pic_s1_flag[ i ]", rps->used_by_curr_pic_s1_flag[ i ]); }
+        }
+        h265_st_ref_pic_set_derive(rps, NULL);
+    }
+}
+
+//E.2.1 VUI parameters syntax
+void read_debug_h265_vui_parameters(h265_sps_t* sps, bs_t* b)
+{
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.aspect_ratio_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x3884A7D6u, "sps->vui.aspect_ratio_info_present_flag", sps->vui.aspect_ratio_info_present_flag); }
+    if( sps->vui.aspect_ratio_info_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.aspect_ratio_idc = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xEFA464BFu, "sps->vui.aspect_ratio_idc", sps->vui.aspect_ratio_idc); }
+        if( sps->vui.aspect_ratio_idc == SAR_Extended )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.sar_width = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x6B39F0AFu, "sps->vui.sar_width", sps->vui.sar_width); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.sar_height = bs_read_u(b, 16); h264_debug_value(_pos, _bits_left, 0x04DC3452u, "sps->vui.sar_height", sps->vui.sar_height); }
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.overscan_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x91B11011u, "sps->vui.overscan_info_present_flag", sps->vui.overscan_info_present_flag); }
+    if( sps->vui.overscan_info_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.overscan_appropriate_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6310A094u, "sps->vui.overscan_appropriate_flag", sps->vui.overscan_appropriate_flag); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_signal_type_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x50A5A40Au, "sps->vui.video_signal_type_present_flag", sps->vui.video_signal_type_present_flag); }
+    if( sps->vui.video_signal_type_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_format = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x987DF82Du, "sps->vui.video_format", sps->vui.video_format); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.video_full_range_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE3CB6388u, "sps->vui.video_full_range_flag", sps->vui.video_full_range_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.colour_description_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD7F2F03Au, "sps->vui.colour_description_present_flag", sps->vui.colour_description_present_flag); }
+        if( sps->vui.colour_description_present_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.colour_primaries = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xCE4B0EC7u, "sps->vui.colour_primaries", sps->vui.colour_primaries); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.transfer_characteristics = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x565718C0u, "sps->vui.transfer_characteristics", sps->vui.transfer_characteristics); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.matrix_coeffs = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x1FEA196Eu, "sps->vui.matrix_coeffs", sps->vui.matrix_coeffs); }
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_loc_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6AEC4651u, "sps->vui.chroma_loc_info_present_flag", sps->vui.chroma_loc_info_present_flag); }
+    if( sps->vui.chroma_loc_info_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_sample_loc_type_top_field = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xB0EECC1Cu, "sps->vui.chroma_sample_loc_type_top_field", sps->vui.chroma_sample_loc_type_top_field); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.chroma_sample_loc_type_bottom_field = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x78386E84u, "sps->vui.chroma_sample_loc_type_bottom_field", sps->vui.chroma_sample_loc_type_bottom_field); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.neutral_chroma_indication_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x8FBADAC2u, "sps->vui.neutral_chroma_indication_flag", sps->vui.neutral_chroma_indication_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.field_seq_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD64FFA1Du, "sps->vui.field_seq_flag", sps->vui.field_seq_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.frame_field_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xBB1E5968u, "sps->vui.frame_field_info_present_flag", sps->vui.frame_field_info_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.default_display_window_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB37D635Au, "sps->vui.default_display_window_flag", sps->vui.default_display_window_flag); }
+    if( sps->vui.default_display_window_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.def_disp_win_left_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x336228C9u, "sps->vui.def_disp_win_left_offset", sps->vui.def_disp_win_left_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.def_disp_win_right_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xFA8DEE70u, "sps->vui.def_disp_win_right_offset", sps->vui.def_disp_win_right_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.def_disp_win_top_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9DC137CBu, "sps->vui.def_disp_win_top_offset", sps->vui.def_disp_win_top_offset); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.def_disp_win_bottom_offset = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9A1E9B83u, "sps->vui.def_disp_win_bottom_offset", sps->vui.def_disp_win_bottom_offset); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_timing_info_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFB7F58FDu, "sps->vui.vui_timing_info_present_flag", sps->vui.vui_timing_info_present_flag); }
+    if( sps->vui.vui_timing_info_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_num_units_in_tick = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0xE894EB9Bu, "sps->vui.vui_num_units_in_tick", sps->vui.vui_num_units_in_tick); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_time_scale = bs_read_u(b, 32); h264_debug_value(_pos, _bits_left, 0xDA6A1903u, "sps->vui.vui_time_scale", sps->vui.vui_time_scale); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_poc_proportional_to_timing_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA613DE63u, "sps->vui.vui_poc_proportional_to_timing_flag", sps->vui.vui_poc_proportional_to_timing_flag); }
+        if( sps->vui.vui_poc_proportional_to_timing_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_num_ticks_poc_diff_one_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9D353E7Cu, "sps->vui.vui_num_ticks_poc_diff_one_minus1", sps->vui.vui_num_ticks_poc_diff_one_minus1); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.vui_hrd_parameters_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA7804BCBu, "sps->vui.vui_hrd_parameters_present_flag", sps->vui.vui_hrd_parameters_present_flag); }
+        if( sps->vui.vui_hrd_parameters_present_flag )
+        {
+            read_debug_h265_hrd_parameters(&sps->hrd, 1, sps->sps_max_sub_layers_minus1, b);
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.bitstream_restriction_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7C18EA6Bu, "sps->vui.bitstream_restriction_flag", sps->vui.bitstream_restriction_flag); }
+    if( sps->vui.bitstream_restriction_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.tiles_fixed_structure_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF27B6157u, "sps->vui.tiles_fixed_structure_flag", sps->vui.tiles_fixed_structure_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.motion_vectors_over_pic_boundaries_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFAB7A89Fu, "sps->vui.motion_vectors_over_pic_boundaries_flag", sps->vui.motion_vectors_over_pic_boundaries_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.restricted_ref_pic_lists_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x27E90467u, "sps->vui.restricted_ref_pic_lists_flag", sps->vui.restricted_ref_pic_lists_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.min_spatial_segmentation_idc = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x03A09A5Du, "sps->vui.min_spatial_segmentation_idc", sps->vui.min_spatial_segmentation_idc); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.max_bytes_per_pic_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x6A6A4BC3u, "sps->vui.max_bytes_per_pic_denom", sps->vui.max_bytes_per_pic_denom); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.max_bits_per_min_cu_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xF043DE07u, "sps->vui.max_bits_per_min_cu_denom", sps->vui.max_bits_per_min_cu_denom); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.log2_max_mv_length_horizontal = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xDF7539A1u, "sps->vui.log2_max_mv_length_horizontal", sps->vui.log2_max_mv_length_horizontal); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sps->vui.log2_max_mv_length_vertical = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xEF2EB4A3u, "sps->vui.log2_max_mv_length_vertical", sps->vui.log2_max_mv_length_vertical); }
+    }
+}
+
+//7.3.2.3.1 General picture parameter set RBSP syntax
+void read_debug_h265_pic_parameter_set_rbsp(h265_pps_t* pps, bs_t* b)
+{
+    int i;
+
+    if( 1 )
+    {
+        memset(pps, 0, sizeof(h265_pps_t));
+        pps->uniform_spacing_flag = 1;
+        pps->loop_filter_across_tiles_enabled_flag = 1;
+    }
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_pic_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA9EE93D6u, "pps->pps_pic_parameter_set_id", pps->pps_pic_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_seq_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xFFB3DBD7u, "pps->pps_seq_parameter_set_id", pps->pps_seq_parameter_set_id); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->dependent_slice_segments_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xCC081DB9u, "pps->dependent_slice_segments_enabled_flag", pps->dependent_slice_segments_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->output_flag_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x725A1FEEu, "pps->output_flag_present_flag", pps->output_flag_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_extra_slice_header_bits = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x43D3FC82u, "pps->num_extra_slice_header_bits", pps->num_extra_slice_header_bits); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->sign_data_hiding_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7E1F1CFAu, "pps->sign_data_hiding_enabled_flag", pps->sign_data_hiding_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->cabac_init_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6052D317u, "pps->cabac_init_present_flag", pps->cabac_init_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_ref_idx_l0_default_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x86FA5EC7u, "pps->num_ref_idx_l0_default_active_minus1", pps->num_ref_idx_l0_default_active_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_ref_idx_l1_default_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1A2313D4u, "pps->num_ref_idx_l1_default_active_minus1", pps->num_ref_idx_l1_default_active_minus1); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->init_qp_minus26 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6220C086u, "pps->init_qp_minus26", pps->init_qp_minus26); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->constrained_intra_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4FE55835u, "pps->constrained_intra_pred_flag", pps->constrained_intra_pred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->transform_skip_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x58012D74u, "pps->transform_skip_enabled_flag", pps->transform_skip_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->cu_qp_delta_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xA2A6998Bu, "pps->cu_qp_delta_enabled_flag", pps->cu_qp_delta_enabled_flag); }
+    if( pps->cu_qp_delta_enabled_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->diff_cu_qp_delta_depth = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x2ED81AE6u, "pps->diff_cu_qp_delta_depth", pps->diff_cu_qp_delta_depth); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_cb_qp_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD4FD47E4u, "pps->pps_cb_qp_offset", pps->pps_cb_qp_offset); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_cr_qp_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6DF987B4u, "pps->pps_cr_qp_offset", pps->pps_cr_qp_offset); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_slice_chroma_qp_offsets_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9D238AA8u, "pps->pps_slice_chroma_qp_offsets_present_flag", pps->pps_slice_chroma_qp_offsets_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->weighted_pred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC95D0631u, "pps->weighted_pred_flag", pps->weighted_pred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->weighted_bipred_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x131AEE62u, "pps->weighted_bipred_flag", pps->weighted_bipred_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->transquant_bypass_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC75805FAu, "pps->transquant_bypass_enabled_flag", pps->transquant_bypass_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->tiles_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4D21F2ABu, "pps->tiles_enabled_flag", pps->tiles_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->entropy_coding_sync_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE4C8750Eu, "pps->entropy_coding_sync_enabled_flag", pps->entropy_coding_sync_enabled_flag); }
+    if( pps->tiles_enabled_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_tile_columns_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA43CD99Au, "pps->num_tile_columns_minus1", pps->num_tile_columns_minus1); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->num_tile_rows_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x848525AEu, "pps->num_tile_rows_minus1", pps->num_tile_rows_minus1); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->uniform_spacing_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB2AC4A04u, "pps->uniform_spacing_flag", pps->uniform_spacing_flag); }
+        if( !pps->uniform_spacing_flag )
+        {
+            for( i = 0; i < pps->num_tile_columns_minus1 && i < H265_MAX_TILE_COLUMNS; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->column_width_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x59DEF287u, "pps->column_width_minus1[ i ]", pps->column_width_minus1[ i ]); }
+            }
+            for( i = 0; i < pps->num_tile_rows_minus1 && i < H265_MAX_TILE_ROWS; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->row_height_minus1[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x3F427748u, "pps->row_height_minus1[ i ]", pps->row_height_minus1[ i ]); }
+            }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->loop_filter_across_tiles_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x25574B05u, "pps->loop_filter_across_tiles_enabled_flag", pps->loop_filter_across_tiles_enabled_flag); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_loop_filter_across_slices_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x5C2356EFu, "pps->pps_loop_filter_across_slices_enabled_flag", pps->pps_loop_filter_across_slices_enabled_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->deblocking_filter_control_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xC8868471u, "pps->deblocking_filter_control_present_flag", pps->deblocking_filter_control_present_flag); }
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->deblocking_filter_override_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB3DE89E6u, "pps->deblocking_filter_override_enabled_flag", pps->deblocking_filter_override_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_deblocking_filter_disabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6D07FBCAu, "pps->pps_deblocking_filter_disabled_flag", pps->pps_deblocking_filter_disabled_flag); }
+        if( !pps->pps_deblocking_filter_disabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_beta_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x26B0C611u, "pps->pps_beta_offset_div2", pps->pps_beta_offset_div2); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_tc_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xC54C8E02u, "pps->pps_tc_offset_div2", pps->pps_tc_offset_div2); }
+        }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_scaling_list_data_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4753C849u, "pps->pps_scaling_list_data_present_flag", pps->pps_scaling_list_data_present_flag); }
+    if( pps->pps_scaling_list_data_present_flag )
+    {
+        read_debug_h265_scaling_list_data(&pps->scaling_list, b);
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->lists_modification_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB4DD363Au, "pps->lists_modification_present_flag", pps->lists_modification_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->log2_parallel_merge_level_minus2 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xD8B53CC6u, "pps->log2_parallel_merge_level_minus2", pps->log2_parallel_merge_level_minus2); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->slice_segment_header_extension_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x8271C576u, "pps->slice_segment_header_extension_present_flag", pps->slice_segment_header_extension_present_flag); }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_extension_present_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x0A765E8Fu, "pps->pps_extension_present_flag", pps->pps_extension_present_flag); }
+    if( pps->pps_extension_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_range_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE35FB851u, "pps->pps_range_extension_flag", pps->pps_range_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_multilayer_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x609E08C6u, "pps->pps_multilayer_extension_flag", pps->pps_multilayer_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_3d_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x179AE565u, "pps->pps_3d_extension_flag", pps->pps_3d_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_scc_extension_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x23CA12DBu, "pps->pps_scc_extension_flag", pps->pps_scc_extension_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->pps_extension_4bits = bs_read_u(b, 4); h264_debug_value(_pos, _bits_left, 0x38A1962Bu, "pps->pps_extension_4bits", pps->pps_extension_4bits); }
+    }
+    if( pps->pps_range_extension_flag )
+    {
+        if( pps->transform_skip_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->log2_max_transform_skip_block_size_minus2 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xCED5EF86u, "pps->log2_max_transform_skip_block_size_minus2", pps->log2_max_transform_skip_block_size_minus2); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->cross_component_prediction_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x9D9A4E9Eu, "pps->cross_component_prediction_enabled_flag", pps->cross_component_prediction_enabled_flag); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->chroma_qp_offset_list_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4C657917u, "pps->chroma_qp_offset_list_enabled_flag", pps->chroma_qp_offset_list_enabled_flag); }
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->diff_cu_chroma_qp_offset_depth = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x39A1C84Eu, "pps->diff_cu_chroma_qp_offset_depth", pps->diff_cu_chroma_qp_offset_depth); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->chroma_qp_offset_list_len_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x63026374u, "pps->chroma_qp_offset_list_len_minus1", pps->chroma_qp_offset_list_len_minus1); }
+            for( i = 0; i <= pps->chroma_qp_offset_list_len_minus1 && i < 6; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->cb_qp_offset_list[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x44B23790u, "pps->cb_qp_offset_list[ i ]", pps->cb_qp_offset_list[ i ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->cr_qp_offset_list[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x322A25C0u, "pps->cr_qp_offset_list[ i ]", pps->cr_qp_offset_list[ i ]); }
+            }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->log2_sao_offset_scale_luma = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x7F526DFAu, "pps->log2_sao_offset_scale_luma", pps->log2_sao_offset_scale_luma); }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; pps->log2_sao_offset_scale_chroma = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x74ABE8A1u, "pps->log2_sao_offset_scale_chroma", pps->log2_sao_offset_scale_chroma); }
+    }
+    // the multilayer, 3D and SCC extensions and pps_extension_data_flag are not read
+}
+
+//7.3.2.4 Supplemental enhancement information RBSP syntax
+void read_debug_h265_sei_rbsp(h265_stream_t* h, bs_t* b)
+{
+    if( 1 )
+    {
+        // the messages of the previous SEI are reused, with their payload storage
+        h->num_seis = 0;
+        do {
+            h->num_seis++;
+            h265_sei_pool_reserve(h, h->num_seis);
+            h->sei = h->seis[h->num_seis - 1];
+            read_debug_h265_sei_message(h, b);
+        } while( more_rbsp_data(b) );
+    }
+
+    if( 0 )
+    {
+        for (int i = 0; i < h->num_seis; i++)
+        {
+            h->sei = h->seis[i];
+            read_debug_h265_sei_message(h, b);
+        }
+        h->sei = NULL;
+    }
+}
+
+//7.3.5 Supplemental enhancement information message syntax
+void read_debug_h265_sei_message(h265_stream_t* h, bs_t* b)
+{
+    sei_t* s = h->sei;
+    int i;
+
+    if( 0 )
+    {
+        _write_ff_coded_number(b, s->payloadType);
+        _write_ff_coded_number(b, s->payloadSize);
+    }
+    if( 1 )
+    {
+        s->payloadType = _read_ff_coded_number(b);
+        s->payloadSize = _read_ff_coded_number(b);
+
+        // payloads are kept as bytes, see sei_payload() for H.264
+        if ( s->payloadSize > s->data_capacity )
+        {
+            int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+            s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+            s->data_capacity = capacity;
+        }
+        s->data = s->data_buf;
+    }
+
+    if( 1 && !1 )
+    {
+        int n = bs_read_bytes(b, s->data, s->payloadSize);
+        if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+    }
+    else
+    {
+        for ( i = 0; i < s->payloadSize; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; s->data[i] = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0x248457B0u, "s->data[i]", s->data[i]); }
+        }
+    }
+}
+
+//7.3.2.5 Access unit delimiter RBSP syntax
+void read_debug_h265_access_unit_delimiter_rbsp(h265_stream_t* h, bs_t* b)
+{
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; h->aud->pic_type = bs_read_u(b, 3); h264_debug_value(_pos, _bits_left, 0x4859C698u, "h->aud->pic_type", h->aud->pic_type); }
+}
+
+//7.3.2.9 Slice segment layer RBSP syntax
+void read_debug_h265_slice_segment_layer_rbsp(h265_stream_t* h, bs_t* b)
+{
+    read_debug_h265_slice_segment_header(h, b);
+
+    slice_data_rbsp_t* slice_data = h->slice_data;
+
+    if( 1 )
+    {
+        free( slice_data->rbsp_buf );
+        slice_data->rbsp_buf = NULL;
+        slice_data->rbsp_size = 0;
+
+        // the header ends byte aligned, slice_segment_data() and the trailing bits are copied as they are
+        if( h->parse_depth >= H265_PARSE_SLICE_DATA && b->p < b->end )
+        {
+            bs_t bs_tmp;
+            bs_clone(&bs_tmp, b);
+            slice_data->rbsp_buf = (uint8_t*)malloc( bs_tmp.end - bs_tmp.p );
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, bs_tmp.end - bs_tmp.p );
+        }
+    }
+
+    if( 0 && slice_data->rbsp_buf != NULL )
+    {
+        bs_write_bytes( b, slice_data->rbsp_buf, slice_data->rbsp_size );
+    }
+}
+
+//7.3.6.1 General slice segment header syntax
+void read_debug_h265_slice_segment_header(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_nal_t* nal = h->nal;
+    int i;
+
+    if( 1 )
+    {
+        sh->no_output_of_prior_pics_flag = 0;
+        sh->dependent_slice_segment_flag = 0;
+        sh->slice_segment_address = 0;
+    }
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->first_slice_segment_in_pic_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x36A1A556u, "sh->first_slice_segment_in_pic_flag", sh->first_slice_segment_in_pic_flag); }
+    if( H265_IS_IRAP( nal->nal_unit_type ) )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->no_output_of_prior_pics_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x4C77F5AEu, "sh->no_output_of_prior_pics_flag", sh->no_output_of_prior_pics_flag); }
+    }
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_pic_parameter_set_id = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x40F37DEFu, "sh->slice_pic_parameter_set_id", sh->slice_pic_parameter_set_id); }
+
+    // when writing, the slice segment goes out with the parameter sets in h->pps and h->sps as they are
+    if( 1 )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h265_activate_pps(h, sh->slice_pic_parameter_set_id);
+        h265_activate_sps(h, h->pps->pps_seq_parameter_set_id);
+    }
+    h265_pps_t* pps = h->pps;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+
+    if( !sh->first_slice_segment_in_pic_flag )
+    {
+        if( pps->dependent_slice_segments_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->dependent_slice_segment_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x206AF09Eu, "sh->dependent_slice_segment_flag", sh->dependent_slice_segment_flag); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_segment_address = bs_read_u(b,  intlog2( h265_pic_size_in_ctbs( sps ) ) ); h264_debug_value(_pos, _bits_left, 0xCBB8C5FCu, "sh->slice_segment_address", sh->slice_segment_address); }
+    }
+
+    if( 1 && !sh->dependent_slice_segment_flag )
+    {
+        memset(&sh->slice_reserved_flag, 0, sizeof(h265_slice_header_t) - offsetof(h265_slice_header_t, slice_reserved_flag));
+        sh->pic_output_flag = 1;
+        sh->num_ref_idx_l0_active_minus1 = pps->num_ref_idx_l0_default_active_minus1;
+        sh->num_ref_idx_l1_active_minus1 = pps->num_ref_idx_l1_default_active_minus1;
+        sh->collocated_from_l0_flag = 1;
+        sh->slice_deblocking_filter_disabled_flag = pps->pps_deblocking_filter_disabled_flag;
+        sh->slice_beta_offset_div2 = pps->pps_beta_offset_div2;
+        sh->slice_tc_offset_div2 = pps->pps_tc_offset_div2;
+        sh->slice_loop_filter_across_slices_enabled_flag = pps->pps_loop_filter_across_slices_enabled_flag;
+    }
+
+    if( !sh->dependent_slice_segment_flag )
+    {
+        for( i = 0; i < pps->num_extra_slice_header_bits; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_reserved_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xE2D3CD56u, "sh->slice_reserved_flag[ i ]", sh->slice_reserved_flag[ i ]); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_type = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x62D7949Au, "sh->slice_type", sh->slice_type); }
+        if( pps->output_flag_present_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pic_output_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x46BCFDFCu, "sh->pic_output_flag", sh->pic_output_flag); }
+        }
+        if( sps->separate_colour_plane_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->colour_plane_id = bs_read_u(b, 2); h264_debug_value(_pos, _bits_left, 0x83597CB0u, "sh->colour_plane_id", sh->colour_plane_id); }
+        }
+        if( !H265_IS_IDR( nal->nal_unit_type ) )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_pic_order_cnt_lsb = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0xBF43190Bu, "sh->slice_pic_order_cnt_lsb", sh->slice_pic_order_cnt_lsb); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->short_term_ref_pic_set_sps_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x948C1410u, "sh->short_term_ref_pic_set_sps_flag", sh->short_term_ref_pic_set_sps_flag); }
+            if( !sh->short_term_ref_pic_set_sps_flag )
+            {
+                read_debug_h265_st_ref_pic_set(&sh->st_ref_pic_set, sps->st_ref_pic_set, sps->num_short_term_ref_pic_sets, sps->num_short_term_ref_pic_sets, b);
+            }
+            else if( sps->num_short_term_ref_pic_sets > 1 )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->short_term_ref_pic_set_idx = bs_read_u(b,  intlog2( sps->num_short_term_ref_pic_sets ) ); h264_debug_value(_pos, _bits_left, 0x206D8656u, "sh->short_term_ref_pic_set_idx", sh->short_term_ref_pic_set_idx); }
+            }
+            if( sps->long_term_ref_pics_present_flag )
+            {
+                if( sps->num_long_term_ref_pics_sps > 0 )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_long_term_sps = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x6901295Au, "sh->num_long_term_sps", sh->num_long_term_sps); }
+                }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_long_term_pics = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xF33ED97Fu, "sh->num_long_term_pics", sh->num_long_term_pics); }
+                for( i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++ )
+                {
+                    if( i < sh->num_long_term_sps )
+                    {
+                        if( sps->num_long_term_ref_pics_sps > 1 )
+                        {
+                            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->lt_idx_sps[ i ] = bs_read_u(b,  intlog2( sps->num_long_term_ref_pics_sps ) ); h264_debug_value(_pos, _bits_left, 0x8FED05FBu, "sh->lt_idx_sps[ i ]", sh->lt_idx_sps[ i ]); }
+                        }
+                    }
+                    else
+                    {
+                        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->poc_lsb_lt[ i ] = bs_read_u(b,  sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ); h264_debug_value(_pos, _bits_left, 0x26FFDB21u, "sh->poc_lsb_lt[ i ]", sh->poc_lsb_lt[ i ]); }
+                        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->used_by_curr_pic_lt_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6717DAEFu, "sh->used_by_curr_pic_lt_flag[ i ]", sh->used_by_curr_pic_lt_flag[ i ]); }
+                    }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_poc_msb_present_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD7BD3445u, "sh->delta_poc_msb_present_flag[ i ]", sh->delta_poc_msb_present_flag[ i ]); }
+                    if( sh->delta_poc_msb_present_flag[ i ] )
+                    {
+                        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->delta_poc_msb_cycle_lt[ i ] = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xE841312Au, "sh->delta_poc_msb_cycle_lt[ i ]", sh->delta_poc_msb_cycle_lt[ i ]); }
+                    }
+                }
+            }
+            if( sps->sps_temporal_mvp_enabled_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_temporal_mvp_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xDEE75687u, "sh->slice_temporal_mvp_enabled_flag", sh->slice_temporal_mvp_enabled_flag); }
+            }
+        }
+        if( sps->sample_adaptive_offset_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_sao_luma_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x956AB858u, "sh->slice_sao_luma_flag", sh->slice_sao_luma_flag); }
+            if( ChromaArrayType != 0 )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_sao_chroma_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x239FA919u, "sh->slice_sao_chroma_flag", sh->slice_sao_chroma_flag); }
+            }
+        }
+        if( sh->slice_type == H265_SH_SLICE_TYPE_P || sh->slice_type == H265_SH_SLICE_TYPE_B )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_active_override_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF0140AA8u, "sh->num_ref_idx_active_override_flag", sh->num_ref_idx_active_override_flag); }
+            if( sh->num_ref_idx_active_override_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l0_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x4B3128BDu, "sh->num_ref_idx_l0_active_minus1", sh->num_ref_idx_l0_active_minus1); }
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_ref_idx_l1_active_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x9EAD4B6Au, "sh->num_ref_idx_l1_active_minus1", sh->num_ref_idx_l1_active_minus1); }
+                }
+            }
+            if( pps->lists_modification_present_flag && h265_num_pic_total_curr(h) > 1 )
+            {
+                read_debug_h265_ref_pic_lists_modification(h, b);
+            }
+            if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->mvd_l1_zero_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x5E06351Eu, "sh->mvd_l1_zero_flag", sh->mvd_l1_zero_flag); }
+            }
+            if( pps->cabac_init_present_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->cabac_init_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF6397ED7u, "sh->cabac_init_flag", sh->cabac_init_flag); }
+            }
+            if( sh->slice_temporal_mvp_enabled_flag )
+            {
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->collocated_from_l0_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x7BD94B1Eu, "sh->collocated_from_l0_flag", sh->collocated_from_l0_flag); }
+                }
+                if( ( sh->collocated_from_l0_flag && sh->num_ref_idx_l0_active_minus1 > 0 ) ||
+                    ( !sh->collocated_from_l0_flag && sh->num_ref_idx_l1_active_minus1 > 0 ) )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->collocated_ref_idx = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x1BB8E697u, "sh->collocated_ref_idx", sh->collocated_ref_idx); }
+                }
+            }
+            if( ( pps->weighted_pred_flag && sh->slice_type == H265_SH_SLICE_TYPE_P ) ||
+                ( pps->weighted_bipred_flag && sh->slice_type == H265_SH_SLICE_TYPE_B ) )
+            {
+                read_debug_h265_pred_weight_table(h, b);
+            }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->five_minus_max_num_merge_cand = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xEAE75E1Au, "sh->five_minus_max_num_merge_cand", sh->five_minus_max_num_merge_cand); }
+        }
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_qp_delta = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x7394F832u, "sh->slice_qp_delta", sh->slice_qp_delta); }
+        if( pps->pps_slice_chroma_qp_offsets_present_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_cb_qp_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x54537AE9u, "sh->slice_cb_qp_offset", sh->slice_cb_qp_offset); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_cr_qp_offset = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xDCEEBF79u, "sh->slice_cr_qp_offset", sh->slice_cr_qp_offset); }
+        }
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->cu_chroma_qp_offset_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xAD0AC17Fu, "sh->cu_chroma_qp_offset_enabled_flag", sh->cu_chroma_qp_offset_enabled_flag); }
+        }
+        if( pps->deblocking_filter_override_enabled_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->deblocking_filter_override_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xD89292C4u, "sh->deblocking_filter_override_flag", sh->deblocking_filter_override_flag); }
+        }
+        if( sh->deblocking_filter_override_flag )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_deblocking_filter_disabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xFF932BE5u, "sh->slice_deblocking_filter_disabled_flag", sh->slice_deblocking_filter_disabled_flag); }
+            if( !sh->slice_deblocking_filter_disabled_flag )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_beta_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x53F5E9E8u, "sh->slice_beta_offset_div2", sh->slice_beta_offset_div2); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_tc_offset_div2 = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xD0C55FB3u, "sh->slice_tc_offset_div2", sh->slice_tc_offset_div2); }
+            }
+        }
+        if( pps->pps_loop_filter_across_slices_enabled_flag &&
+            ( sh->slice_sao_luma_flag || sh->slice_sao_chroma_flag || !sh->slice_deblocking_filter_disabled_flag ) )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_loop_filter_across_slices_enabled_flag = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x1C0714DAu, "sh->slice_loop_filter_across_slices_enabled_flag", sh->slice_loop_filter_across_slices_enabled_flag); }
+        }
+    }
+
+    if( 1 )
+    {
+        sh->num_entry_point_offsets = 0;
+        sh->slice_segment_header_extension_length = 0;
+    }
+    if( pps->tiles_enabled_flag || pps->entropy_coding_sync_enabled_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->num_entry_point_offsets = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0xA3B0994Au, "sh->num_entry_point_offsets", sh->num_entry_point_offsets); }
+        if( sh->num_entry_point_offsets > 0 )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->offset_len_minus1 = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x3340ED58u, "sh->offset_len_minus1", sh->offset_len_minus1); }
+            for( i = 0; i < sh->num_entry_point_offsets && i < H265_MAX_ENTRY_POINTS; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->entry_point_offset_minus1[ i ] = bs_read_u(b,  sh->offset_len_minus1 + 1 ); h264_debug_value(_pos, _bits_left, 0x353D7E6Bu, "sh->entry_point_offset_minus1[ i ]", sh->entry_point_offset_minus1[ i ]); }
+            }
+            // the offsets past H265_MAX_ENTRY_POINTS are not kept: stepped over when reading, written as 0
+            for( ; i < sh->num_entry_point_offsets && !bs_eof(b); i++ )
+            {
+                if( 1 ) { bs_skip_u(b, sh->offset_len_minus1 + 1); }
+                if( 0 ) { bs_write_u(b, sh->offset_len_minus1 + 1, 0); }
+            }
+        }
+    }
+    if( pps->slice_segment_header_extension_present_flag )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_segment_header_extension_length = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x86925ED8u, "sh->slice_segment_header_extension_length", sh->slice_segment_header_extension_length); }
+        for( i = 0; i < sh->slice_segment_header_extension_length && i < 256; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->slice_segment_header_extension_data_byte[ i ] = bs_read_u8(b); h264_debug_value(_pos, _bits_left, 0xAB3706ACu, "sh->slice_segment_header_extension_data_byte[ i ]", sh->slice_segment_header_extension_data_byte[ i ]); }
+        }
+        for( ; i < sh->slice_segment_header_extension_length && !bs_eof(b); i++ )
+        {
+            if( 1 ) { bs_skip_u(b, 8); }
+            if( 0 ) { bs_write_u(b, 8, 0); }
+        }
+    }
+    read_debug_h265_byte_alignment(b);
+}
+
+//7.3.6.2 Reference picture list modification syntax
+void read_debug_h265_ref_pic_lists_modification(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    int n = intlog2( h265_num_pic_total_curr(h) );
+    int i;
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplm.ref_pic_list_modification_flag_l0 = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF87DC816u, "sh->rplm.ref_pic_list_modification_flag_l0", sh->rplm.ref_pic_list_modification_flag_l0); }
+    if( sh->rplm.ref_pic_list_modification_flag_l0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplm.list_entry_l0[ i ] = bs_read_u(b,  n ); h264_debug_value(_pos, _bits_left, 0x87F05F33u, "sh->rplm.list_entry_l0[ i ]", sh->rplm.list_entry_l0[ i ]); }
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplm.ref_pic_list_modification_flag_l1 = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xF97DC9A9u, "sh->rplm.ref_pic_list_modification_flag_l1", sh->rplm.ref_pic_list_modification_flag_l1); }
+        if( sh->rplm.ref_pic_list_modification_flag_l1 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->rplm.list_entry_l1[ i ] = bs_read_u(b,  n ); h264_debug_value(_pos, _bits_left, 0xF6D4A57Au, "sh->rplm.list_entry_l1[ i ]", sh->rplm.list_entry_l1[ i ]); }
+            }
+        }
+    }
+}
+
+//7.3.6.3 Weighted prediction parameters syntax
+// luma_weight_lX_flag and chroma_weight_lX_flag are read for every reference picture: a reference can only have the
+// POC of the current picture with the screen content extension, which is not read
+void read_debug_h265_pred_weight_table(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+    int i, j;
+
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_log2_weight_denom = bs_read_ue(b); h264_debug_value(_pos, _bits_left, 0x48220CB5u, "sh->pwt.luma_log2_weight_denom", sh->pwt.luma_log2_weight_denom); }
+    if( ChromaArrayType != 0 )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_chroma_log2_weight_denom = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6C9DA9CDu, "sh->pwt.delta_chroma_log2_weight_denom", sh->pwt.delta_chroma_log2_weight_denom); }
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l0_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x62EAE239u, "sh->pwt.luma_weight_l0_flag[ i ]", sh->pwt.luma_weight_l0_flag[ i ]); }
+    }
+    if( ChromaArrayType != 0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l0_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x6563AE86u, "sh->pwt.chroma_weight_l0_flag[ i ]", sh->pwt.chroma_weight_l0_flag[ i ]); }
+        }
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        if( sh->pwt.luma_weight_l0_flag[ i ] )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_luma_weight_l0[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xDF38CDC7u, "sh->pwt.delta_luma_weight_l0[ i ]", sh->pwt.delta_luma_weight_l0[ i ]); }
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_offset_l0[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x09589BA5u, "sh->pwt.luma_offset_l0[ i ]", sh->pwt.luma_offset_l0[ i ]); }
+        }
+        if( sh->pwt.chroma_weight_l0_flag[ i ] )
+        {
+            for( j = 0; j < 2; j++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_chroma_weight_l0[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6ACA6E42u, "sh->pwt.delta_chroma_weight_l0[ i ][ j ]", sh->pwt.delta_chroma_weight_l0[ i ][ j ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_chroma_offset_l0[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x0A131253u, "sh->pwt.delta_chroma_offset_l0[ i ][ j ]", sh->pwt.delta_chroma_offset_l0[ i ][ j ]); }
+            }
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_weight_l1_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0x994F799Eu, "sh->pwt.luma_weight_l1_flag[ i ]", sh->pwt.luma_weight_l1_flag[ i ]); }
+        }
+        if( ChromaArrayType != 0 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.chroma_weight_l1_flag[ i ] = bs_read_u1(b); h264_debug_value(_pos, _bits_left, 0xB2121241u, "sh->pwt.chroma_weight_l1_flag[ i ]", sh->pwt.chroma_weight_l1_flag[ i ]); }
+            }
+        }
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            if( sh->pwt.luma_weight_l1_flag[ i ] )
+            {
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_luma_weight_l1[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x8049152Eu, "sh->pwt.delta_luma_weight_l1[ i ]", sh->pwt.delta_luma_weight_l1[ i ]); }
+                { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.luma_offset_l1[ i ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0x6203F6ACu, "sh->pwt.luma_offset_l1[ i ]", sh->pwt.luma_offset_l1[ i ]); }
+            }
+            if( sh->pwt.chroma_weight_l1_flag[ i ] )
+            {
+                for( j = 0; j < 2; j++ )
+                {
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_chroma_weight_l1[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xE9EC122Du, "sh->pwt.delta_chroma_weight_l1[ i ][ j ]", sh->pwt.delta_chroma_weight_l1[ i ][ j ]); }
+                    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; sh->pwt.delta_chroma_offset_l1[ i ][ j ] = bs_read_se(b); h264_debug_value(_pos, _bits_left, 0xA5F7DD48u, "sh->pwt.delta_chroma_offset_l1[ i ][ j ]", sh->pwt.delta_chroma_offset_l1[ i ][ j ]); }
+                }
+            }
+        }
+    }
+}
+
+//7.3.2.11 RBSP trailing bits syntax
+void read_debug_h265_rbsp_trailing_bits(bs_t* b)
+{
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int rbsp_stop_one_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x02FE9ED0u, "rbsp_stop_one_bit", rbsp_stop_one_bit); }
+
+    while( !bs_byte_aligned(b) )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int rbsp_alignment_zero_bit = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0x525C97EBu, "rbsp_alignment_zero_bit", rbsp_alignment_zero_bit); }
+    }
+}
+
+//7.3.2.12 Byte alignment syntax
+void read_debug_h265_byte_alignment(bs_t* b)
+{
+    { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int alignment_bit_equal_to_one = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0xBBDD1CDCu, "alignment_bit_equal_to_one", alignment_bit_equal_to_one); }
+
+    while( !bs_byte_aligned(b) )
+    {
+        { long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; int alignment_bit_equal_to_zero = bs_read_u(b, 1); h264_debug_value(_pos, _bits_left, 0xEFFC246Au, "alignment_bit_equal_to_zero", alignment_bit_equal_to_zero); }
+    }
+}
+
+const h264_debug_name_t h265_stream_debug_names[] =
+{
+    { 0x3A3AE9DD, "forbidden_zero_bit" },
+    { 0x8FC50732, "nal->nal_unit_type" },
+    { 0x242E66BC, "nal->nuh_layer_id" },
+    { 0x26DD7DD3, "nal->nuh_temporal_id_plus1" },
+    { 0x6408F9AF, "vps->vps_video_parameter_set_id" },
+    { 0x9A3CFD9F, "vps->vps_base_layer_internal_flag" },
+    { 0xE1807667, "vps->vps_base_layer_available_flag" },
+    { 0x4FCEA6CC, "vps->vps_max_layers_minus1" },
+    { 0xE400DDFD, "vps->vps_max_sub_layers_minus1" },
+    { 0x82AD2639, "vps->vps_temporal_id_nesting_flag" },
+    { 0xBA1F5460, "vps_reserved_0xffff_16bits" },
+    { 0xF6A1437E, "vps->vps_sub_layer_ordering_info_present_flag" },
+    { 0x037C30D1, "vps->vps_max_dec_pic_buffering_minus1[ i ]" },
+    { 0x0C628AC5, "vps->vps_max_num_reorder_pics[ i ]" },
+    { 0x8EFB4EFC, "vps->vps_max_latency_increase_plus1[ i ]" },
+    { 0xB8F9A1CB, "vps->vps_max_layer_id" },
+    { 0xDBC8B781, "vps->vps_num_layer_sets_minus1" },
+    { 0xCCBBAA63, "vps->layer_id_included_flag[ i ][ j ]" },
+    { 0x552A5215, "vps->vps_timing_info_present_flag" },
+    { 0x73554853, "vps->vps_num_units_in_tick" },
+    { 0xFAD6803B, "vps->vps_time_scale" },
+    { 0xAE14EC5B, "vps->vps_poc_proportional_to_timing_flag" },
+    { 0xBCD737A4, "vps->vps_num_ticks_poc_diff_one_minus1" },
+    { 0x827EAC95, "vps->vps_num_hrd_parameters" },
+    { 0x9B27317F, "vps->hrd_layer_set_idx[ i ]" },
+    { 0xC7EFED32, "vps->cprms_present_flag[ i ]" },
+    { 0xDEA5BB27, "vps->vps_extension_flag" },
+    { 0xDCF3B56F, "ptl->general_profile_space" },
+    { 0x3F2B10FC, "ptl->general_tier_flag" },
+    { 0x13236CD7, "ptl->general_profile_idc" },
+    { 0x47E93900, "ptl->general_profile_compatibility_flag[ j ]" },
+    { 0x92D2963B, "ptl->general_progressive_source_flag" },
+    { 0xD7AC31A1, "ptl->general_interlaced_source_flag" },
+    { 0x2DF931D0, "ptl->general_non_packed_constraint_flag" },
+    { 0x3BE62930, "ptl->general_frame_only_constraint_flag" },
+    { 0x41725361, "ptl->general_reserved_zero_44bits[ 0 ]" },
+    { 0x6E58EA56, "ptl->general_reserved_zero_44bits[ 1 ]" },
+    { 0xDB3FD268, "ptl->general_level_idc" },
+    { 0xA09A178A, "ptl->sub_layer_profile_present_flag[ i ]" },
+    { 0x1B5E7CB1, "ptl->sub_layer_level_present_flag[ i ]" },
+    { 0xB740DD25, "reserved_zero_2bits" },
+    { 0x2B0C7688, "ptl->sub_layer[ i ].sub_layer_profile_space" },
+    { 0xC6E51FAB, "ptl->sub_layer[ i ].sub_layer_tier_flag" },
+    { 0x8B16EAC0, "ptl->sub_layer[ i ].sub_layer_profile_idc" },
+    { 0x539EDB23, "ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ]" },
+    { 0x7E98AB18, "ptl->sub_layer[ i ].sub_layer_progressive_source_flag" },
+    { 0x5BD66110, "ptl->sub_layer[ i ].sub_layer_interlaced_source_flag" },
+    { 0x603DC9F5, "ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag" },
+    { 0x96E7A7C9, "ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag" },
+    { 0xEAB22622, "ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ]" },
+    { 0xBD2DBE6D, "ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ]" },
+    { 0xBD0BDABF, "ptl->sub_layer[ i ].sub_layer_level_idc" },
+    { 0x0F5CBD84, "hrd->nal_hrd_parameters_present_flag" },
+    { 0xAD859CEA, "hrd->vcl_hrd_parameters_present_flag" },
+    { 0xD9BBC128, "hrd->sub_pic_hrd_params_present_flag" },
+    { 0xAB97C06D, "hrd->tick_divisor_minus2" },
+    { 0xED4361C9, "hrd->du_cpb_removal_delay_increment_length_minus1" },
+    { 0x4014BE85, "hrd->sub_pic_cpb_params_in_pic_timing_sei_flag" },
+    { 0x30F2508F, "hrd->dpb_output_delay_du_length_minus1" },
+    { 0x789F7519, "hrd->bit_rate_scale" },
+    { 0xBCE2EED2, "hrd->cpb_size_scale" },
+    { 0xC2EF5C56, "hrd->cpb_size_du_scale" },
+    { 0xFE8EAC8C, "hrd->initial_cpb_removal_delay_length_minus1" },
+    { 0x71CBF112, "hrd->au_cpb_removal_delay_length_minus1" },
+    { 0xBC80045D, "hrd->dpb_output_delay_length_minus1" },
+    { 0x92DD7109, "hrd->fixed_pic_rate_general_flag[ i ]" },
+    { 0xE08888C5, "hrd->fixed_pic_rate_within_cvs_flag[ i ]" },
+    { 0xBA03CEBD, "hrd->elemental_duration_in_tc_minus1[ i ]" },
+    { 0xA8079D2D, "hrd->low_delay_hrd_flag[ i ]" },
+    { 0xABAF249A, "hrd->cpb_cnt_minus1[ i ]" },
+    { 0xF0D42C0D, "sub->bit_rate_value_minus1[ i ]" },
+    { 0xE9A78CAA, "sub->cpb_size_value_minus1[ i ]" },
+    { 0x530C95D6, "sub->cpb_size_du_value_minus1[ i ]" },
+    { 0xBF2EB65F, "sub->bit_rate_du_value_minus1[ i ]" },
+    { 0x49E02CAB, "sub->cbr_flag[ i ]" },
+    { 0xC7BCBB15, "sps->sps_video_parameter_set_id" },
+    { 0x2AB12A3B, "sps->sps_max_sub_layers_minus1" },
+    { 0x76B0635B, "sps->sps_temporal_id_nesting_flag" },
+    { 0x5D317425, "sps->sps_seq_parameter_set_id" },
+    { 0x6F6238B5, "sps->chroma_format_idc" },
+    { 0x8980B2F2, "sps->separate_colour_plane_flag" },
+    { 0xD1409991, "sps->pic_width_in_luma_samples" },
+    { 0xC53ACD24, "sps->pic_height_in_luma_samples" },
+    { 0xDF2921C1, "sps->conformance_window_flag" },
+    { 0x04ABB7E9, "sps->conf_win_left_offset" },
+    { 0xF6288090, "sps->conf_win_right_offset" },
+    { 0x8C12306B, "sps->conf_win_top_offset" },
+    { 0x400A8DA3, "sps->conf_win_bottom_offset" },
+    { 0x664F05FC, "sps->bit_depth_luma_minus8" },
+    { 0xBBEFF3D9, "sps->bit_depth_chroma_minus8" },
+    { 0x2A686A28, "sps->log2_max_pic_order_cnt_lsb_minus4" },
+    { 0x0269E828, "sps->sps_sub_layer_ordering_info_present_flag" },
+    { 0x42C46877, "sps->sps_max_dec_pic_buffering_minus1[ i ]" },
+    { 0x0CCA8253, "sps->sps_max_num_reorder_pics[ i ]" },
+    { 0x1BEFE462, "sps->sps_max_latency_increase_plus1[ i ]" },
+    { 0xAE85B52E, "sps->log2_min_luma_coding_block_size_minus3" },
+    { 0xB7735B43, "sps->log2_diff_max_min_luma_coding_block_size" },
+    { 0x8F6239DB, "sps->log2_min_luma_transform_block_size_minus2" },
+    { 0xE66B98E7, "sps->log2_diff_max_min_luma_transform_block_size" },
+    { 0xB89B66E6, "sps->max_transform_hierarchy_depth_inter" },
+    { 0xAF85926C, "sps->max_transform_hierarchy_depth_intra" },
+    { 0xBECFCD73, "sps->scaling_list_enabled_flag" },
+    { 0x101F616B, "sps->sps_scaling_list_data_present_flag" },
+    { 0xB71299BF, "sps->amp_enabled_flag" },
+    { 0xA8BBCD36, "sps->sample_adaptive_offset_enabled_flag" },
+    { 0xCAAFBA51, "sps->pcm_enabled_flag" },
+    { 0x67BA183B, "sps->pcm_sample_bit_depth_luma_minus1" },
+    { 0xACC1558A, "sps->pcm_sample_bit_depth_chroma_minus1" },
+    { 0x1ECD4A0D, "sps->log2_min_pcm_luma_coding_block_size_minus3" },
+    { 0xE3DA771E, "sps->log2_diff_max_min_pcm_luma_coding_block_size" },
+    { 0xE990DE5A, "sps->pcm_loop_filter_disabled_flag" },
+    { 0x7632E4E3, "sps->num_short_term_ref_pic_sets" },
+    { 0x547C2FFC, "sps->long_term_ref_pics_present_flag" },
+    { 0x9172D593, "sps->num_long_term_ref_pics_sps" },
+    { 0xDC1992DE, "sps->lt_ref_pic_poc_lsb_sps[ i ]" },
+    { 0x08FE6823, "sps->used_by_curr_pic_lt_sps_flag[ i ]" },
+    { 0xDE4A3E4E, "sps->sps_temporal_mvp_enabled_flag" },
+    { 0x453DF102, "sps->strong_intra_smoothing_enabled_flag" },
+    { 0xA58884FC, "sps->vui_parameters_present_flag" },
+    { 0x761E7BFD, "sps->sps_extension_present_flag" },
+    { 0x51787607, "sps->sps_range_extension_flag" },
+    { 0xEF49FFC0, "sps->sps_multilayer_extension_flag" },
+    { 0x715E2C87, "sps->sps_3d_extension_flag" },
+    { 0xC721FF91, "sps->sps_scc_extension_flag" },
+    { 0xDF1EFE05, "sps->sps_extension_4bits" },
+    { 0x9DA3BB7E, "sps->transform_skip_rotation_enabled_flag" },
+    { 0x71F61ECB, "sps->transform_skip_context_enabled_flag" },
+    { 0xEA3EF793, "sps->implicit_rdpcm_enabled_flag" },
+    { 0x36BFE51E, "sps->explicit_rdpcm_enabled_flag" },
+    { 0xDDC05B27, "sps->extended_precision_processing_flag" },
+    { 0x4B3B3539, "sps->intra_smoothing_disabled_flag" },
+    { 0xCC0F6A41, "sps->high_precision_offsets_enabled_flag" },
+    { 0x534473E2, "sps->persistent_rice_adaptation_enabled_flag" },
+    { 0x14C59B12, "sps->cabac_bypass_alignment_enabled_flag" },
+    { 0xA1A219FA, "sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ]" },
+    { 0x5FBFB28A, "sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ]" },
+    { 0xD69DE4DD, "sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ]" },
+    { 0xEF1C2BE2, "scaling_list_delta_coef" },
+    { 0x3A0275BA, "rps->inter_ref_pic_set_prediction_flag" },
+    { 0xC81F82F3, "rps->delta_idx_minus1" },
+    { 0x0816B24D, "rps->delta_rps_sign" },
+    { 0x20AC3E12, "rps->abs_delta_rps_minus1" },
+    { 0xF3D8DEB9, "rps->used_by_curr_pic_flag[ j ]" },
+    { 0xE4A003BE, "rps->use_delta_flag[ j ]" },
+    { 0x2F54456B, "rps->num_negative_pics" },
+    { 0xD598323F, "rps->num_positive_pics" },
+    { 0xB6601BFB, "rps->delta_poc_s0_minus1[ i ]" },
+    { 0xFDED2E4E, "rps->used_by_curr_pic_s0_flag[ i ]" },
+    { 0x5ABA5C2C, "rps->delta_poc_s1_minus1[ i ]" },
+    { 0x7D26C529, "rps->used_by_curr_pic_s1_flag[ i ]" },
+    { 0x3884A7D6, "sps->vui.aspect_ratio_info_present_flag" },
+    { 0xEFA464BF, "sps->vui.aspect_ratio_idc" },
+    { 0x6B39F0AF, "sps->vui.sar_width" },
+    { 0x04DC3452, "sps->vui.sar_height" },
+    { 0x91B11011, "sps->vui.overscan_info_present_flag" },
+    { 0x6310A094, "sps->vui.overscan_appropriate_flag" },
+    { 0x50A5A40A, "sps->vui.video_signal_type_present_flag" },
+    { 0x987DF82D, "sps->vui.video_format" },
+    { 0xE3CB6388, "sps->vui.video_full_range_flag" },
+    { 0xD7F2F03A, "sps->vui.colour_description_present_flag" },
+    { 0xCE4B0EC7, "sps->vui.colour_primaries" },
+    { 0x565718C0, "sps->vui.transfer_characteristics" },
+    { 0x1FEA196E, "sps->vui.matrix_coeffs" },
+    { 0x6AEC4651, "sps->vui.chroma_loc_info_present_flag" },
+    { 0xB0EECC1C, "sps->vui.chroma_sample_loc_type_top_field" },
+    { 0x78386E84, "sps->vui.chroma_sample_loc_type_bottom_field" },
+    { 0x8FBADAC2, "sps->vui.neutral_chroma_indication_flag" },
+    { 0xD64FFA1D, "sps->vui.field_seq_flag" },
+    { 0xBB1E5968, "sps->vui.frame_field_info_present_flag" },
+    { 0xB37D635A, "sps->vui.default_display_window_flag" },
+    { 0x336228C9, "sps->vui.def_disp_win_left_offset" },
+    { 0xFA8DEE70, "sps->vui.def_disp_win_right_offset" },
+    { 0x9DC137CB, "sps->vui.def_disp_win_top_offset" },
+    { 0x9A1E9B83, "sps->vui.def_disp_win_bottom_offset" },
+    { 0xFB7F58FD, "sps->vui.vui_timing_info_present_flag" },
+    { 0xE894EB9B, "sps->vui.vui_num_units_in_tick" },
+    { 0xDA6A1903, "sps->vui.vui_time_scale" },
+    { 0xA613DE63, "sps->vui.vui_poc_proportional_to_timing_flag" },
+    { 0x9D353E7C, "sps->vui.vui_num_ticks_poc_diff_one_minus1" },
+    { 0xA7804BCB, "sps->vui.vui_hrd_parameters_present_flag" },
+    { 0x7C18EA6B, "sps->vui.bitstream_restriction_flag" },
+    { 0xF27B6157, "sps->vui.tiles_fixed_structure_flag" },
+    { 0xFAB7A89F, "sps->vui.motion_vectors_over_pic_boundaries_flag" },
+    { 0x27E90467, "sps->vui.restricted_ref_pic_lists_flag" },
+    { 0x03A09A5D, "sps->vui.min_spatial_segmentation_idc" },
+    { 0x6A6A4BC3, "sps->vui.max_bytes_per_pic_denom" },
+    { 0xF043DE07, "sps->vui.max_bits_per_min_cu_denom" },
+    { 0xDF7539A1, "sps->vui.log2_max_mv_length_horizontal" },
+    { 0xEF2EB4A3, "sps->vui.log2_max_mv_length_vertical" },
+    { 0xA9EE93D6, "pps->pps_pic_parameter_set_id" },
+    { 0xFFB3DBD7, "pps->pps_seq_parameter_set_id" },
+    { 0xCC081DB9, "pps->dependent_slice_segments_enabled_flag" },
+    { 0x725A1FEE, "pps->output_flag_present_flag" },
+    { 0x43D3FC82, "pps->num_extra_slice_header_bits" },
+    { 0x7E1F1CFA, "pps->sign_data_hiding_enabled_flag" },
+    { 0x6052D317, "pps->cabac_init_present_flag" },
+    { 0x86FA5EC7, "pps->num_ref_idx_l0_default_active_minus1" },
+    { 0x1A2313D4, "pps->num_ref_idx_l1_default_active_minus1" },
+    { 0x6220C086, "pps->init_qp_minus26" },
+    { 0x4FE55835, "pps->constrained_intra_pred_flag" },
+    { 0x58012D74, "pps->transform_skip_enabled_flag" },
+    { 0xA2A6998B, "pps->cu_qp_delta_enabled_flag" },
+    { 0x2ED81AE6, "pps->diff_cu_qp_delta_depth" },
+    { 0xD4FD47E4, "pps->pps_cb_qp_offset" },
+    { 0x6DF987B4, "pps->pps_cr_qp_offset" },
+    { 0x9D238AA8, "pps->pps_slice_chroma_qp_offsets_present_flag" },
+    { 0xC95D0631, "pps->weighted_pred_flag" },
+    { 0x131AEE62, "pps->weighted_bipred_flag" },
+    { 0xC75805FA, "pps->transquant_bypass_enabled_flag" },
+    { 0x4D21F2AB, "pps->tiles_enabled_flag" },
+    { 0xE4C8750E, "pps->entropy_coding_sync_enabled_flag" },
+    { 0xA43CD99A, "pps->num_tile_columns_minus1" },
+    { 0x848525AE, "pps->num_tile_rows_minus1" },
+    { 0xB2AC4A04, "pps->uniform_spacing_flag" },
+    { 0x59DEF287, "pps->column_width_minus1[ i ]" },
+    { 0x3F427748, "pps->row_height_minus1[ i ]" },
+    { 0x25574B05, "pps->loop_filter_across_tiles_enabled_flag" },
+    { 0x5C2356EF, "pps->pps_loop_filter_across_slices_enabled_flag" },
+    { 0xC8868471, "pps->deblocking_filter_control_present_flag" },
+    { 0xB3DE89E6, "pps->deblocking_filter_override_enabled_flag" },
+    { 0x6D07FBCA, "pps->pps_deblocking_filter_disabled_flag" },
+    { 0x26B0C611, "pps->pps_beta_offset_div2" },
+    { 0xC54C8E02, "pps->pps_tc_offset_div2" },
+    { 0x4753C849, "pps->pps_scaling_list_data_present_flag" },
+    { 0xB4DD363A, "pps->lists_modification_present_flag" },
+    { 0xD8B53CC6, "pps->log2_parallel_merge_level_minus2" },
+    { 0x8271C576, "pps->slice_segment_header_extension_present_flag" },
+    { 0x0A765E8F, "pps->pps_extension_present_flag" },
+    { 0xE35FB851, "pps->pps_range_extension_flag" },
+    { 0x609E08C6, "pps->pps_multilayer_extension_flag" },
+    { 0x179AE565, "pps->pps_3d_extension_flag" },
+    { 0x23CA12DB, "pps->pps_scc_extension_flag" },
+    { 0x38A1962B, "pps->pps_extension_4bits" },
+    { 0xCED5EF86, "pps->log2_max_transform_skip_block_size_minus2" },
+    { 0x9D9A4E9E, "pps->cross_component_prediction_enabled_flag" },
+    { 0x4C657917, "pps->chroma_qp_offset_list_enabled_flag" },
+    { 0x39A1C84E, "pps->diff_cu_chroma_qp_offset_depth" },
+    { 0x63026374, "pps->chroma_qp_offset_list_len_minus1" },
+    { 0x44B23790, "pps->cb_qp_offset_list[ i ]" },
+    { 0x322A25C0, "pps->cr_qp_offset_list[ i ]" },
+    { 0x7F526DFA, "pps->log2_sao_offset_scale_luma" },
+    { 0x74ABE8A1, "pps->log2_sao_offset_scale_chroma" },
+    { 0x248457B0, "s->data[i]" },
+    { 0x4859C698, "h->aud->pic_type" },
+    { 0x36A1A556, "sh->first_slice_segment_in_pic_flag" },
+    { 0x4C77F5AE, "sh->no_output_of_prior_pics_flag" },
+    { 0x40F37DEF, "sh->slice_pic_parameter_set_id" },
+    { 0x206AF09E, "sh->dependent_slice_segment_flag" },
+    { 0xCBB8C5FC, "sh->slice_segment_address" },
+    { 0xE2D3CD56, "sh->slice_reserved_flag[ i ]" },
+    { 0x62D7949A, "sh->slice_type" },
+    { 0x46BCFDFC, "sh->pic_output_flag" },
+    { 0x83597CB0, "sh->colour_plane_id" },
+    { 0xBF43190B, "sh->slice_pic_order_cnt_lsb" },
+    { 0x948C1410, "sh->short_term_ref_pic_set_sps_flag" },
+    { 0x206D8656, "sh->short_term_ref_pic_set_idx" },
+    { 0x6901295A, "sh->num_long_term_sps" },
+    { 0xF33ED97F, "sh->num_long_term_pics" },
+    { 0x8FED05FB, "sh->lt_idx_sps[ i ]" },
+    { 0x26FFDB21, "sh->poc_lsb_lt[ i ]" },
+    { 0x6717DAEF, "sh->used_by_curr_pic_lt_flag[ i ]" },
+    { 0xD7BD3445, "sh->delta_poc_msb_present_flag[ i ]" },
+    { 0xE841312A, "sh->delta_poc_msb_cycle_lt[ i ]" },
+    { 0xDEE75687, "sh->slice_temporal_mvp_enabled_flag" },
+    { 0x956AB858, "sh->slice_sao_luma_flag" },
+    { 0x239FA919, "sh->slice_sao_chroma_flag" },
+    { 0xF0140AA8, "sh->num_ref_idx_active_override_flag" },
+    { 0x4B3128BD, "sh->num_ref_idx_l0_active_minus1" },
+    { 0x9EAD4B6A, "sh->num_ref_idx_l1_active_minus1" },
+    { 0x5E06351E, "sh->mvd_l1_zero_flag" },
+    { 0xF6397ED7, "sh->cabac_init_flag" },
+    { 0x7BD94B1E, "sh->collocated_from_l0_flag" },
+    { 0x1BB8E697, "sh->collocated_ref_idx" },
+    { 0xEAE75E1A, "sh->five_minus_max_num_merge_cand" },
+    { 0x7394F832, "sh->slice_qp_delta" },
+    { 0x54537AE9, "sh->slice_cb_qp_offset" },
+    { 0xDCEEBF79, "sh->slice_cr_qp_offset" },
+    { 0xAD0AC17F, "sh->cu_chroma_qp_offset_enabled_flag" },
+    { 0xD89292C4, "sh->deblocking_filter_override_flag" },
+    { 0xFF932BE5, "sh->slice_deblocking_filter_disabled_flag" },
+    { 0x53F5E9E8, "sh->slice_beta_offset_div2" },
+    { 0xD0C55FB3, "sh->slice_tc_offset_div2" },
+    { 0x1C0714DA, "sh->slice_loop_filter_across_slices_enabled_flag" },
+    { 0xA3B0994A, "sh->num_entry_point_offsets" },
+    { 0x3340ED58, "sh->offset_len_minus1" },
+    { 0x353D7E6B, "sh->entry_point_offset_minus1[ i ]" },
+    { 0x86925ED8, "sh->slice_segment_header_extension_length" },
+    { 0xAB3706AC, "sh->slice_segment_header_extension_data_byte[ i ]" },
+    { 0xF87DC816, "sh->rplm.ref_pic_list_modification_flag_l0" },
+    { 0x87F05F33, "sh->rplm.list_entry_l0[ i ]" },
+    { 0xF97DC9A9, "sh->rplm.ref_pic_list_modification_flag_l1" },
+    { 0xF6D4A57A, "sh->rplm.list_entry_l1[ i ]" },
+    { 0x48220CB5, "sh->pwt.luma_log2_weight_denom" },
+    { 0x6C9DA9CD, "sh->pwt.delta_chroma_log2_weight_denom" },
+    { 0x62EAE239, "sh->pwt.luma_weight_l0_flag[ i ]" },
+    { 0x6563AE86, "sh->pwt.chroma_weight_l0_flag[ i ]" },
+    { 0xDF38CDC7, "sh->pwt.delta_luma_weight_l0[ i ]" },
+    { 0x09589BA5, "sh->pwt.luma_offset_l0[ i ]" },
+    { 0x6ACA6E42, "sh->pwt.delta_chroma_weight_l0[ i ][ j ]" },
+    { 0x0A131253, "sh->pwt.delta_chroma_offset_l0[ i ][ j ]" },
+    { 0x994F799E, "sh->pwt.luma_weight_l1_flag[ i ]" },
+    { 0xB2121241, "sh->pwt.chroma_weight_l1_flag[ i ]" },
+    { 0x8049152E, "sh->pwt.delta_luma_weight_l1[ i ]" },
+    { 0x6203F6AC, "sh->pwt.luma_offset_l1[ i ]" },
+    { 0xE9EC122D, "sh->pwt.delta_chroma_weight_l1[ i ][ j ]" },
+    { 0xA5F7DD48, "sh->pwt.delta_chroma_offset_l1[ i ][ j ]" },
+    { 0x02FE9ED0, "rbsp_stop_one_bit" },
+    { 0x525C97EB, "rbsp_alignment_zero_bit" },
+    { 0xBBDD1CDC, "alignment_bit_equal_to_one" },
+    { 0xEFFC246A, "alignment_bit_equal_to_zero" },
+    { 0, NULL }
+};
@@ -0,0 +1,620 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ * Copyright (C) 2005-2007 Auroras Entertainment, LLC
+ * Copyright (C) 2008-2011 Avail-TVN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _H265_STREAM_H
+#define _H265_STREAM_H        1
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bs.h"
+#include "h264_stream.h"
+#include "h264_sei.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ H.265 (HEVC) headers: video, sequence and picture parameter sets, slice segment headers, SEI and
+ access unit delimiters, read and written the same way as the H.264 ones in h264_stream.h.  Range extension
+ flags are read; multilayer, 3D and screen content extensions are not, and their data is left unread.
+ Array sizes are the limits of the standard unless noted; syntax that would go past them is not read.
+*/
+
+#define H265_MAX_SUB_LAYERS        8
+#define H265_MAX_DPB_SIZE         16
+#define H265_MAX_SHORT_TERM_RPS   64   // num_short_term_ref_pic_sets
+#define H265_MAX_LONG_TERM_PICS   32   // num_long_term_ref_pics_sps, num_long_term_sps + num_long_term_pics
+#define H265_MAX_REFS             16   // num_ref_idx_l0_active_minus1 + 1
+#define H265_MAX_CPB_CNT          32
+#define H265_MAX_LAYER_SETS       16   // vps_num_layer_sets_minus1 + 1, the standard allows 1024
+#define H265_MAX_VPS_HRD           4   // vps_num_hrd_parameters, the standard allows 1024
+#define H265_MAX_TILE_COLUMNS     20
+#define H265_MAX_TILE_ROWS        22
+#define H265_MAX_ENTRY_POINTS    512   // num_entry_point_offsets, the standard allows one per CTB row of each tile
+
+/**
+   Profile, tier and level
+   @see 7.3.3 Profile, tier and level syntax
+*/
+typedef struct
+{
+    int general_profile_space;
+    int general_tier_flag;
+    int general_profile_idc;
+    int general_profile_compatibility_flag[32];
+    int general_progressive_source_flag;
+    int general_interlaced_source_flag;
+    int general_non_packed_constraint_flag;
+    int general_frame_only_constraint_flag;
+    int general_reserved_zero_44bits[2]; // 32 + 12 bits, also the range extension constraint flags and general_inbld_flag
+    int general_level_idc;
+    int sub_layer_profile_present_flag[H265_MAX_SUB_LAYERS];
+    int sub_layer_level_present_flag[H265_MAX_SUB_LAYERS];
+    struct
+    {
+        int sub_layer_profile_space;
+        int sub_layer_tier_flag;
+        int sub_layer_profile_idc;
+        int sub_layer_profile_compatibility_flag[32];
+        int sub_layer_progressive_source_flag;
+        int sub_layer_interlaced_source_flag;
+        int sub_layer_non_packed_constraint_flag;
+        int sub_layer_frame_only_constraint_flag;
+        int sub_layer_reserved_zero_44bits[2];
+        int sub_layer_level_idc;
+    } sub_layer[H265_MAX_SUB_LAYERS];
+} h265_profile_tier_level_t;
+
+/**
+   Sub-layer HRD parameters
+   @see E.2.3 Sub-layer HRD parameters syntax
+*/
+typedef struct
+{
+    int bit_rate_value_minus1[H265_MAX_CPB_CNT];
+    int cpb_size_value_minus1[H265_MAX_CPB_CNT];
+    int cpb_size_du_value_minus1[H265_MAX_CPB_CNT];
+    int bit_rate_du_value_minus1[H265_MAX_CPB_CNT];
+    int cbr_flag[H265_MAX_CPB_CNT];
+} h265_sub_layer_hrd_t;
+
+/**
+   HRD parameters
+   @see E.2.2 HRD parameters syntax
+*/
+typedef struct
+{
+    int nal_hrd_parameters_present_flag;
+    int vcl_hrd_parameters_present_flag;
+    int sub_pic_hrd_params_present_flag;
+    int tick_divisor_minus2;
+    int du_cpb_removal_delay_increment_length_minus1;
+    int sub_pic_cpb_params_in_pic_timing_sei_flag;
+    int dpb_output_delay_du_length_minus1;
+    int bit_rate_scale;
+    int cpb_size_scale;
+    int cpb_size_du_scale;
+    int initial_cpb_removal_delay_length_minus1;
+    int au_cpb_removal_delay_length_minus1;
+    int dpb_output_delay_length_minus1;
+    int fixed_pic_rate_general_flag[H265_MAX_SUB_LAYERS];
+    int fixed_pic_rate_within_cvs_flag[H265_MAX_SUB_LAYERS];
+    int elemental_duration_in_tc_minus1[H265_MAX_SUB_LAYERS];
+    int low_delay_hrd_flag[H265_MAX_SUB_LAYERS];
+    int cpb_cnt_minus1[H265_MAX_SUB_LAYERS];
+    h265_sub_layer_hrd_t sub_layer_hrd_nal[H265_MAX_SUB_LAYERS];
+    h265_sub_layer_hrd_t sub_layer_hrd_vcl[H265_MAX_SUB_LAYERS];
+} h265_hrd_t;
+
+/**
+   Short-term reference picture set, with the variables 7.4.8 derives from it
+   @see 7.3.7 Short-term reference picture set syntax
+*/
+typedef struct
+{
+    int inter_ref_pic_set_prediction_flag;
+    int delta_idx_minus1;
+    int delta_rps_sign;
+    int abs_delta_rps_minus1;
+    int used_by_curr_pic_flag[H265_MAX_DPB_SIZE + 1];
+    int use_delta_flag[H265_MAX_DPB_SIZE + 1];
+    int num_negative_pics;
+    int num_positive_pics;
+    int delta_poc_s0_minus1[H265_MAX_DPB_SIZE];
+    int used_by_curr_pic_s0_flag[H265_MAX_DPB_SIZE];
+    int delta_poc_s1_minus1[H265_MAX_DPB_SIZE];
+    int used_by_curr_pic_s1_flag[H265_MAX_DPB_SIZE];
+
+    // derived, (7-61) to (7-64)
+    int NumNegativePics;
+    int NumPositivePics;
+    int NumDeltaPocs;
+    int DeltaPocS0[H265_MAX_DPB_SIZE];
+    int UsedByCurrPicS0[H265_MAX_DPB_SIZE];
+    int DeltaPocS1[H265_MAX_DPB_SIZE];
+    int UsedByCurrPicS1[H265_MAX_DPB_SIZE];
+} h265_st_ref_pic_set_t;
+
+/**
+   Scaling list data
+   @see 7.3.4 Scaling list data syntax
+*/
+typedef struct
+{
+    int scaling_list_pred_mode_flag[4][6];
+    int scaling_list_pred_matrix_id_delta[4][6];
+    int scaling_list_dc_coef_minus8[2][6];
+    int ScalingList[4][6][64];
+} h265_scaling_list_t;
+
+/**
+   Video Parameter Set
+   @see 7.3.2.1 Video parameter set RBSP syntax
+   @see read_h265_video_parameter_set_rbsp
+   @see write_h265_video_parameter_set_rbsp
+*/
+typedef struct
+{
+    int vps_video_parameter_set_id;
+    int vps_base_layer_internal_flag;
+    int vps_base_layer_available_flag;
+    int vps_max_layers_minus1;
+    int vps_max_sub_layers_minus1;
+    int vps_temporal_id_nesting_flag;
+    h265_profile_tier_level_t ptl;
+    int vps_sub_layer_ordering_info_present_flag;
+    int vps_max_dec_pic_buffering_minus1[H265_MAX_SUB_LAYERS];
+    int vps_max_num_reorder_pics[H265_MAX_SUB_LAYERS];
+    int vps_max_latency_increase_plus1[H265_MAX_SUB_LAYERS];
+    int vps_max_layer_id;
+    int vps_num_layer_sets_minus1;
+    int layer_id_included_flag[H265_MAX_LAYER_SETS][64];
+    int vps_timing_info_present_flag;
+    int vps_num_units_in_tick;
+    int vps_time_scale;
+    int vps_poc_proportional_to_timing_flag;
+    int vps_num_ticks_poc_diff_one_minus1;
+    int vps_num_hrd_parameters;
+    int hrd_layer_set_idx[H265_MAX_VPS_HRD];
+    int cprms_present_flag[H265_MAX_VPS_HRD];
+    h265_hrd_t hrd[H265_MAX_VPS_HRD];
+    int vps_extension_flag;
+
+    int incomplete; // set when the counts exceed the tables and the rest was not read
+} h265_vps_t;
+
+/**
+   Sequence Parameter Set
+   @see 7.3.2.2 Sequence parameter set RBSP syntax
+   @see read_h265_seq_parameter_set_rbsp
+   @see write_h265_seq_parameter_set_rbsp
+*/
+typedef struct
+{
+    int sps_video_parameter_set_id;
+    int sps_max_sub_layers_minus1;
+    int sps_temporal_id_nesting_flag;
+    h265_profile_tier_level_t ptl;
+    int sps_seq_parameter_set_id;
+    int chroma_format_idc;
+    int separate_colour_plane_flag;
+    int pic_width_in_luma_samples;
+    int pic_height_in_luma_samples;
+    int conformance_window_flag;
+    int conf_win_left_offset;
+    int conf_win_right_offset;
+    int conf_win_top_offset;
+    int conf_win_bottom_offset;
+    int bit_depth_luma_minus8;
+    int bit_depth_chroma_minus8;
+    int log2_max_pic_order_cnt_lsb_minus4;
+    int sps_sub_layer_ordering_info_present_flag;
+    int sps_max_dec_pic_buffering_minus1[H265_MAX_SUB_LAYERS];
+    int sps_max_num_reorder_pics[H265_MAX_SUB_LAYERS];
+    int sps_max_latency_increase_plus1[H265_MAX_SUB_LAYERS];
+    int log2_min_luma_coding_block_size_minus3;
+    int log2_diff_max_min_luma_coding_block_size;
+    int log2_min_luma_transform_block_size_minus2;
+    int log2_diff_max_min_luma_transform_block_size;
+    int max_transform_hierarchy_depth_inter;
+    int max_transform_hierarchy_depth_intra;
+    int scaling_list_enabled_flag;
+    int sps_scaling_list_data_present_flag;
+    h265_scaling_list_t scaling_list;
+    int amp_enabled_flag;
+    int sample_adaptive_offset_enabled_flag;
+    int pcm_enabled_flag;
+    int pcm_sample_bit_depth_luma_minus1;
+    int pcm_sample_bit_depth_chroma_minus1;
+    int log2_min_pcm_luma_coding_block_size_minus3;
+    int log2_diff_max_min_pcm_luma_coding_block_size;
+    int pcm_loop_filter_disabled_flag;
+    int num_short_term_ref_pic_sets;
+    h265_st_ref_pic_set_t st_ref_pic_set[H265_MAX_SHORT_TERM_RPS];
+    int long_term_ref_pics_present_flag;
+    int num_long_term_ref_pics_sps;
+    int lt_ref_pic_poc_lsb_sps[H265_MAX_LONG_TERM_PICS];
+    int used_by_curr_pic_lt_sps_flag[H265_MAX_LONG_TERM_PICS];
+    int sps_temporal_mvp_enabled_flag;
+    int strong_intra_smoothing_enabled_flag;
+    int vui_parameters_present_flag;
+
+    struct
+    {
+        int aspect_ratio_info_present_flag;
+        int aspect_ratio_idc;
+        int sar_width;
+        int sar_height;
+        int overscan_info_present_flag;
+        int overscan_appropriate_flag;
+        int video_signal_type_present_flag;
+        int video_format;
+        int video_full_range_flag;
+        int colour_description_present_flag;
+        int colour_primaries;
+        int transfer_characteristics;
+        int matrix_coeffs;
+        int chroma_loc_info_present_flag;
+        int chroma_sample_loc_type_top_field;
+        int chroma_sample_loc_type_bottom_field;
+        int neutral_chroma_indication_flag;
+        int field_seq_flag;
+        int frame_field_info_present_flag;
+        int default_display_window_flag;
+        int def_disp_win_left_offset;
+        int def_disp_win_right_offset;
+        int def_disp_win_top_offset;
+        int def_disp_win_bottom_offset;
+        int vui_timing_info_present_flag;
+        int vui_num_units_in_tick;
+        int vui_time_scale;
+        int vui_poc_proportional_to_timing_flag;
+        int vui_num_ticks_poc_diff_one_minus1;
+        int vui_hrd_parameters_present_flag;
+        int bitstream_restriction_flag;
+        int tiles_fixed_structure_flag;
+        int motion_vectors_over_pic_boundaries_flag;
+        int restricted_ref_pic_lists_flag;
+        int min_spatial_segmentation_idc;
+        int max_bytes_per_pic_denom;
+        int max_bits_per_min_cu_denom;
+        int log2_max_mv_length_horizontal;
+        int log2_max_mv_length_vertical;
+    } vui;
+    h265_hrd_t hrd;
+
+    int sps_extension_present_flag;
+    int sps_range_extension_flag;
+    int sps_multilayer_extension_flag;
+    int sps_3d_extension_flag;
+    int sps_scc_extension_flag;
+    int sps_extension_4bits;
+
+    // 7.3.2.2.2 Sequence parameter set range extension syntax
+    int transform_skip_rotation_enabled_flag;
+    int transform_skip_context_enabled_flag;
+    int implicit_rdpcm_enabled_flag;
+    int explicit_rdpcm_enabled_flag;
+    int extended_precision_processing_flag;
+    int intra_smoothing_disabled_flag;
+    int high_precision_offsets_enabled_flag;
+    int persistent_rice_adaptation_enabled_flag;
+    int cabac_bypass_alignment_enabled_flag;
+
+    int incomplete; // set when the counts exceed the tables and the rest was not read
+} h265_sps_t;
+
+/**
+   Picture Parameter Set
+   @see 7.3.2.3 Picture parameter set RBSP syntax
+   @see read_h265_pic_parameter_set_rbsp
+   @see write_h265_pic_parameter_set_rbsp
+*/
+typedef struct
+{
+    int pps_pic_parameter_set_id;
+    int pps_seq_parameter_set_id;
+    int dependent_slice_segments_enabled_flag;
+    int output_flag_present_flag;
+    int num_extra_slice_header_bits;
+    int sign_data_hiding_enabled_flag;
+    int cabac_init_present_flag;
+    int num_ref_idx_l0_default_active_minus1;
+    int num_ref_idx_l1_default_active_minus1;
+    int init_qp_minus26;
+    int constrained_intra_pred_flag;
+    int transform_skip_enabled_flag;
+    int cu_qp_delta_enabled_flag;
+    int diff_cu_qp_delta_depth;
+    int pps_cb_qp_offset;
+    int pps_cr_qp_offset;
+    int pps_slice_chroma_qp_offsets_present_flag;
+    int weighted_pred_flag;
+    int weighted_bipred_flag;
+    int transquant_bypass_enabled_flag;
+    int tiles_enabled_flag;
+    int entropy_coding_sync_enabled_flag;
+    int num_tile_columns_minus1;
+    int num_tile_rows_minus1;
+    int uniform_spacing_flag;
+    int column_width_minus1[H265_MAX_TILE_COLUMNS];
+    int row_height_minus1[H265_MAX_TILE_ROWS];
+    int loop_filter_across_tiles_enabled_flag;
+    int pps_loop_filter_across_slices_enabled_flag;
+    int deblocking_filter_control_present_flag;
+    int deblocking_filter_override_enabled_flag;
+    int pps_deblocking_filter_disabled_flag;
+    int pps_beta_offset_div2;
+    int pps_tc_offset_div2;
+    int pps_scaling_list_data_present_flag;
+    h265_scaling_list_t scaling_list;
+    int lists_modification_present_flag;
+    int log2_parallel_merge_level_minus2;
+    int slice_segment_header_extension_present_flag;
+    int pps_extension_present_flag;
+    int pps_range_extension_flag;
+    int pps_multilayer_extension_flag;
+    int pps_3d_extension_flag;
+    int pps_scc_extension_flag;
+    int pps_extension_4bits;
+
+    // 7.3.2.3.2 Picture parameter set range extension syntax
+    int log2_max_transform_skip_block_size_minus2;
+    int cross_component_prediction_enabled_flag;
+    int chroma_qp_offset_list_enabled_flag;
+    int diff_cu_chroma_qp_offset_depth;
+    int chroma_qp_offset_list_len_minus1;
+    int cb_qp_offset_list[6];
+    int cr_qp_offset_list[6];
+    int log2_sao_offset_scale_luma;
+    int log2_sao_offset_scale_chroma;
+} h265_pps_t;
+
+/**
+   Slice segment header
+   @see 7.3.6.1 General slice segment header syntax
+   @see read_h265_slice_segment_header
+   @see write_h265_slice_segment_header
+*/
+typedef struct
+{
+    // read for every slice segment
+    int first_slice_segment_in_pic_flag;
+    int no_output_of_prior_pics_flag;
+    int slice_pic_parameter_set_id;
+    int dependent_slice_segment_flag;
+    int slice_segment_address;
+
+    // a dependent slice segment keeps these from the slice segment before it; everything from here on is
+    // cleared when an independent one is read
+    int slice_reserved_flag[8];
+    int slice_type;
+    int pic_output_flag;
+    int colour_plane_id;
+    int slice_pic_order_cnt_lsb;
+    int short_term_ref_pic_set_sps_flag;
+    h265_st_ref_pic_set_t st_ref_pic_set;
+    int short_term_ref_pic_set_idx;
+    int num_long_term_sps;
+    int num_long_term_pics;
+    int lt_idx_sps[H265_MAX_LONG_TERM_PICS];
+    int poc_lsb_lt[H265_MAX_LONG_TERM_PICS];
+    int used_by_curr_pic_lt_flag[H265_MAX_LONG_TERM_PICS];
+    int delta_poc_msb_present_flag[H265_MAX_LONG_TERM_PICS];
+    int delta_poc_msb_cycle_lt[H265_MAX_LONG_TERM_PICS];
+    int slice_temporal_mvp_enabled_flag;
+    int slice_sao_luma_flag;
+    int slice_sao_chroma_flag;
+    int num_ref_idx_active_override_flag;
+    int num_ref_idx_l0_active_minus1;
+    int num_ref_idx_l1_active_minus1;
+
+    struct
+    {
+        int ref_pic_list_modification_flag_l0;
+        int list_entry_l0[H265_MAX_REFS];
+        int ref_pic_list_modification_flag_l1;
+        int list_entry_l1[H265_MAX_REFS];
+    } rplm; // ref pic lists modification
+
+    int mvd_l1_zero_flag;
+    int cabac_init_flag;
+    int collocated_from_l0_flag;
+    int collocated_ref_idx;
+
+    struct
+    {
+        int luma_log2_weight_denom;
+        int delta_chroma_log2_weight_denom;
+        int luma_weight_l0_flag[H265_MAX_REFS];
+        int chroma_weight_l0_flag[H265_MAX_REFS];
+        int delta_luma_weight_l0[H265_MAX_REFS];
+        int luma_offset_l0[H265_MAX_REFS];
+        int delta_chroma_weight_l0[H265_MAX_REFS][2];
+        int delta_chroma_offset_l0[H265_MAX_REFS][2];
+        int luma_weight_l1_flag[H265_MAX_REFS];
+        int chroma_weight_l1_flag[H265_MAX_REFS];
+        int delta_luma_weight_l1[H265_MAX_REFS];
+        int luma_offset_l1[H265_MAX_REFS];
+        int delta_chroma_weight_l1[H265_MAX_REFS][2];
+        int delta_chroma_offset_l1[H265_MAX_REFS][2];
+    } pwt; // pred weight table
+
+    int five_minus_max_num_merge_cand;
+    int slice_qp_delta;
+    int slice_cb_qp_offset;
+    int slice_cr_qp_offset;
+    int cu_chroma_qp_offset_enabled_flag;
+    int deblocking_filter_override_flag;
+    int slice_deblocking_filter_disabled_flag;
+    int slice_beta_offset_div2;
+    int slice_tc_offset_div2;
+    int slice_loop_filter_across_slices_enabled_flag;
+
+    // read for every slice segment again
+    int num_entry_point_offsets;
+    int offset_len_minus1;
+    int entry_point_offset_minus1[H265_MAX_ENTRY_POINTS];
+    int slice_segment_header_extension_length;
+    int slice_segment_header_extension_data_byte[256];
+} h265_slice_header_t;
+
+/**
+   Access unit delimiter
+   @see 7.3.2.5 Access unit delimiter RBSP syntax
+*/
+typedef struct
+{
+    int pic_type;
+} h265_aud_t;
+
+/**
+   Network Abstraction Layer (NAL) unit header
+   @see 7.3.1.2 NAL unit header syntax
+   @see read_h265_nal_unit
+   @see write_h265_nal_unit
+*/
+typedef struct
+{
+    int forbidden_zero_bit;
+    int nal_unit_type;
+    int nuh_layer_id;
+    int nuh_temporal_id_plus1;
+} h265_nal_t;
+
+// how much of each NAL read_h265_nal_unit() parses, see h265_stream_t.parse_depth
+#define H265_PARSE_NAL_HEADER   0  // nal_unit_header only
+#define H265_PARSE_HEADERS      1  // also parameter sets, SEI and slice segment headers, but not slice data (default)
+#define H265_PARSE_SLICE_DATA   2  // also copy the slice segment payload into slice_data
+
+/**
+   H265 stream
+   Same layout and use as h264_stream_t: the structures the last NAL was read into or the next one is written
+   from, and the parameter set tables that slice segment headers are read with.
+ */
+typedef struct
+{
+    h265_nal_t* nal;
+    h265_vps_t* vps;
+    h265_sps_t* sps;
+    h265_pps_t* pps;
+    h265_aud_t* aud;
+    sei_t* sei; // the message being read or written, one of seis
+    int num_seis;
+    h265_slice_header_t* sh;
+
+    slice_data_rbsp_t* slice_data;
+
+    // slots are NULL until a parameter set with that id is seen, use h265_*_slot() to create them
+    h265_vps_t* vps_table[16];
+    h265_sps_t* sps_table[16];
+    h265_pps_t* pps_table[64];
+    sei_t** seis;
+    int sei_pool_size; // messages allocated in seis when reading, num_seis of them in use
+
+    int parse_depth; // one of H265_PARSE_*, only affects reading
+
+    // hashes of the NAL bytes each table slot was read from, and of the parameter sets h->sps and h->pps hold,
+    // 0 if unknown; see h264_stream_t.  A re-sent parameter set with the same bytes is not parsed again.
+    uint64_t vps_table_hash[16];
+    uint64_t sps_table_hash[16];
+    uint64_t pps_table_hash[64];
+    uint64_t sps_hash;
+    uint64_t pps_hash;
+} h265_stream_t;
+
+h265_stream_t* h265_new();
+void h265_free(h265_stream_t* h);
+
+h265_vps_t* h265_vps_slot(h265_stream_t* h, int id);
+h265_sps_t* h265_sps_slot(h265_stream_t* h, int id);
+h265_pps_t* h265_pps_slot(h265_stream_t* h, int id);
+void h265_sei_pool_reserve(h265_stream_t* h, int n);
+
+int h265_ps_resent(h265_stream_t* h, const uint8_t* buf, int size);
+void h265_activate_sps(h265_stream_t* h, int id);
+void h265_activate_pps(h265_stream_t* h, int id);
+int h265_num_pic_total_curr(h265_stream_t* h);
+
+int peek_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size);
+int read_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size);
+int write_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size);
+int read_debug_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size);
+
+//Table 7-1 NAL unit type codes and NAL unit type classes
+#define H265_NAL_UNIT_TYPE_TRAIL_N          0    // Coded slice segment of a non-TSA, non-STSA trailing picture
+#define H265_NAL_UNIT_TYPE_TRAIL_R          1
+#define H265_NAL_UNIT_TYPE_TSA_N            2    // Coded slice segment of a TSA picture
+#define H265_NAL_UNIT_TYPE_TSA_R            3
+#define H265_NAL_UNIT_TYPE_STSA_N           4    // Coded slice segment of an STSA picture
+#define H265_NAL_UNIT_TYPE_STSA_R           5
+#define H265_NAL_UNIT_TYPE_RADL_N           6    // Coded slice segment of a RADL picture
+#define H265_NAL_UNIT_TYPE_RADL_R           7
+#define H265_NAL_UNIT_TYPE_RASL_N           8    // Coded slice segment of a RASL picture
+#define H265_NAL_UNIT_TYPE_RASL_R           9
+                                        // 10..15    // Reserved non-IRAP VCL
+#define H265_NAL_UNIT_TYPE_BLA_W_LP        16    // Coded slice segment of a BLA picture
+#define H265_NAL_UNIT_TYPE_BLA_W_RADL      17
+#define H265_NAL_UNIT_TYPE_BLA_N_LP        18
+#define H265_NAL_UNIT_TYPE_IDR_W_RADL      19    // Coded slice segment of an IDR picture
+#define H265_NAL_UNIT_TYPE_IDR_N_LP        20
+#define H265_NAL_UNIT_TYPE_CRA_NUT         21    // Coded slice segment of a CRA picture
+#define H265_NAL_UNIT_TYPE_RSV_IRAP_VCL22  22    // Reserved IRAP
+#define H265_NAL_UNIT_TYPE_RSV_IRAP_VCL23  23
+                                        // 24..31    // Reserved non-IRAP VCL
+#define H265_NAL_UNIT_TYPE_VPS             32    // Video parameter set
+#define H265_NAL_UNIT_TYPE_SPS             33    // Sequence parameter set
+#define H265_NAL_UNIT_TYPE_PPS             34    // Picture parameter set
+#define H265_NAL_UNIT_TYPE_AUD             35    // Access unit delimiter
+#define H265_NAL_UNIT_TYPE_EOS             36    // End of sequence
+#define H265_NAL_UNIT_TYPE_EOB             37    // End of bitstream
+#define H265_NAL_UNIT_TYPE_FD              38    // Filler data
+#define H265_NAL_UNIT_TYPE_PREFIX_SEI      39    // Supplemental enhancement information
+#define H265_NAL_UNIT_TYPE_SUFFIX_SEI      40
+                                        // 41..47    // Reserved
+                                        // 48..63    // Unspecified
+
+// VCL NALs (slice segments) are types 0..31, IRAP pictures (random access points, keyframes) 16..23
+#define H265_IS_VCL(nal_unit_type)   ((nal_unit_type) <= 31)
+#define H265_IS_IRAP(nal_unit_type)  ((nal_unit_type) >= H265_NAL_UNIT_TYPE_BLA_W_LP && (nal_unit_type) <= H265_NAL_UNIT_TYPE_RSV_IRAP_VCL23)
+#define H265_IS_IDR(nal_unit_type)   ((nal_unit_type) == H265_NAL_UNIT_TYPE_IDR_W_RADL || (nal_unit_type) == H265_NAL_UNIT_TYPE_IDR_N_LP)
+
+//7.4.7.1 Table 7-7 Name association to slice_type
+#define H265_SH_SLICE_TYPE_B        0
+#define H265_SH_SLICE_TYPE_P        1
+#define H265_SH_SLICE_TYPE_I        2
+
+//7.4.3.5 Table 7-2 Interpretation of pic_type
+#define H265_AUD_PIC_TYPE_I         0                // I
+#define H265_AUD_PIC_TYPE_IP        1                // P, I
+#define H265_AUD_PIC_TYPE_IPB       2                // B, P, I
+
+#define H265_PROFILE_MAIN           1
+#define H265_PROFILE_MAIN_10        2
+#define H265_PROFILE_MAIN_STILL     3
+#define H265_PROFILE_RANGE_EXT      4
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1588 @@
+/*
+ * h264bitstream - a library for reading and writing H.264 video
+ * Copyright (C) 2005-2007 Auroras Entertainment, LLC
+ * Copyright (C) 2008-2011 Avail-TVN
+ * Copyright (C) 2012 Alex Izvorski
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "bs.h"
+#include "h264_stream.h"
+#include "h264_sei.h"
+#include "h265_stream.h"
+
+#define printf(...) fprintf((h264_dbgfile_thread != NULL ? h264_dbgfile_thread : h264_dbgfile != NULL ? h264_dbgfile : stdout), __VA_ARGS__)
+
+// shared with h264_stream.c
+int intlog2(int x);
+int more_rbsp_data(bs_t* bs);
+int _read_ff_coded_number(bs_t* b);
+void _write_ff_coded_number(bs_t* b, int n);
+
+// everything h265_new() allocates, in a single block; h comes first so that free(h) frees it
+typedef struct
+{
+    h265_stream_t h;
+    h265_nal_t nal;
+    h265_vps_t vps;
+    h265_sps_t sps;
+    h265_pps_t pps;
+    h265_aud_t aud;
+    h265_slice_header_t sh;
+    slice_data_rbsp_t slice_data;
+} h265_stream_block_t;
+
+/**
+ Create a new H265 stream object.  It reads headers only (H265_PARSE_HEADERS) until parse_depth is changed.
+ @return    the stream object
+ */
+h265_stream_t* h265_new()
+{
+    h265_stream_block_t* blk = (h265_stream_block_t*)calloc(1, sizeof(h265_stream_block_t));
+    if (blk == NULL) { return NULL; }
+    h265_stream_t* h = &blk->h;
+
+    h->nal = &blk->nal;
+    h->vps = &blk->vps;
+    h->sps = &blk->sps;
+    h->pps = &blk->pps;
+    h->aud = &blk->aud;
+    h->sh = &blk->sh;
+    h->slice_data = &blk->slice_data;
+    h->parse_depth = H265_PARSE_HEADERS;
+
+    return h;
+}
+
+/**
+ Free an existing H265 stream object.  Frees all contained structures.
+ @param[in,out] h   the stream object
+ */
+void h265_free(h265_stream_t* h)
+{
+    for (int i = 0; i < h->sei_pool_size; i++) { sei_free(h->seis[i]); }
+    free(h->seis);
+
+    free(h->slice_data->rbsp_buf);
+
+    for (int i = 0; i < 16; i++) { free(h->vps_table[i]); }
+    for (int i = 0; i < 16; i++) { free(h->sps_table[i]); }
+    for (int i = 0; i < 64; i++) { free(h->pps_table[i]); }
+
+    free(h);
+}
+
+/**
+ Get the VPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      vps_video_parameter_set_id, 0..15
+ */
+h265_vps_t* h265_vps_slot(h265_stream_t* h, int id)
+{
+    if (h->vps_table[id] == NULL) { h->vps_table[id] = (h265_vps_t*)calloc(1, sizeof(h265_vps_t)); }
+    return h->vps_table[id];
+}
+
+/**
+ Get the SPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      sps_seq_parameter_set_id, 0..15
+ */
+h265_sps_t* h265_sps_slot(h265_stream_t* h, int id)
+{
+    if (h->sps_table[id] == NULL) { h->sps_table[id] = (h265_sps_t*)calloc(1, sizeof(h265_sps_t)); }
+    return h->sps_table[id];
+}
+
+/**
+ Get the PPS table slot for an id, creating an empty one if that id has not been seen yet.
+ @param[in] id      pps_pic_parameter_set_id, 0..63
+ */
+h265_pps_t* h265_pps_slot(h265_stream_t* h, int id)
+{
+    if (h->pps_table[id] == NULL) { h->pps_table[id] = (h265_pps_t*)calloc(1, sizeof(h265_pps_t)); }
+    return h->pps_table[id];
+}
+
+/**
+ Make room for n messages in h->seis, reusing the messages left there by the previous SEI, as sei_pool_reserve() does.
+ */
+void h265_sei_pool_reserve(h265_stream_t* h, int n)
+{
+    if ( n <= h->sei_pool_size ) { return; }
+
+    int size = (h->sei_pool_size < 4) ? 4 : h->sei_pool_size * 2;
+    while ( size < n ) { size *= 2; }
+    h->seis = (sei_t**)realloc(h->seis, size * sizeof(sei_t*));
+    for ( int i = h->sei_pool_size; i < size; i++ )
+    {
+        h->seis[i] = sei_new();
+    }
+    h->sei_pool_size = size;
+}
+
+/**
+ Make the SPS stored for an id the current one, copying it to h->sps unless h->sps already holds it.
+ Ids out of range are ignored.
+ */
+void h265_activate_sps(h265_stream_t* h, int id)
+{
+    if (id < 0 || id >= 16) { return; }
+    if (h->sps_hash == 0 || h->sps_hash != h->sps_table_hash[id])
+    {
+        memcpy(h->sps, h265_sps_slot(h, id), sizeof(h265_sps_t));
+        h->sps_hash = h->sps_table_hash[id];
+    }
+}
+
+/**
+ Make the PPS stored for an id the current one, copying it to h->pps unless h->pps already holds it.
+ Ids out of range are ignored.
+ */
+void h265_activate_pps(h265_stream_t* h, int id)
+{
+    if (id < 0 || id >= 64) { return; }
+    if (h->pps_hash == 0 || h->pps_hash != h->pps_table_hash[id])
+    {
+        memcpy(h->pps, h265_pps_slot(h, id), sizeof(h265_pps_t));
+        h->pps_hash = h->pps_table_hash[id];
+    }
+}
+
+/**
+ Check whether a VPS, SPS or PPS NAL has the same bytes as one already in the tables.  If so, that one becomes
+ the current parameter set without the NAL being parsed again.  The tables are searched by hash, since the SPS id
+ comes after the variable length profile_tier_level().
+ @param[in] buf     the whole NAL, as passed to read_h265_nal_unit, of type h->nal->nal_unit_type
+ @return    1 if it is a repeat and has been handled, 0 if it needs to be parsed
+ */
+int h265_ps_resent(h265_stream_t* h, const uint8_t* buf, int size)
+{
+    uint64_t hash = h264_nal_hash(buf, size);
+    int id;
+
+    switch (h->nal->nal_unit_type)
+    {
+        case H265_NAL_UNIT_TYPE_VPS:
+            for (id = 0; id < 16; id++)
+            {
+                if (h->vps_table_hash[id] == hash) { memcpy(h->vps, h->vps_table[id], sizeof(h265_vps_t)); return 1; }
+            }
+            break;
+        case H265_NAL_UNIT_TYPE_SPS:
+            for (id = 0; id < 16; id++)
+            {
+                if (h->sps_table_hash[id] == hash) { h265_activate_sps(h, id); return 1; }
+            }
+            break;
+        case H265_NAL_UNIT_TYPE_PPS:
+            for (id = 0; id < 64; id++)
+            {
+                if (h->pps_table_hash[id] == hash) { h265_activate_pps(h, id); return 1; }
+            }
+            break;
+    }
+    return 0;
+}
+
+/**
+ NumPicTotalCurr (7-55) of the current slice segment header: the reference pictures the picture may use.
+ */
+int h265_num_pic_total_curr(h265_stream_t* h)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    h265_st_ref_pic_set_t* rps = &sh->st_ref_pic_set;
+    int n = 0;
+    int i;
+
+    if (sh->short_term_ref_pic_set_sps_flag && sh->short_term_ref_pic_set_idx < H265_MAX_SHORT_TERM_RPS)
+    {
+        rps = &sps->st_ref_pic_set[ sh->short_term_ref_pic_set_idx ];
+    }
+    for (i = 0; i < rps->NumNegativePics; i++) { n += rps->UsedByCurrPicS0[i]; }
+    for (i = 0; i < rps->NumPositivePics; i++) { n += rps->UsedByCurrPicS1[i]; }
+    for (i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++)
+    {
+        if (i < sh->num_long_term_sps) { n += sps->used_by_curr_pic_lt_sps_flag[ sh->lt_idx_sps[i] % H265_MAX_LONG_TERM_PICS ]; }
+        else { n += sh->used_by_curr_pic_lt_flag[i]; }
+    }
+    return n;
+}
+
+/**
+ Read only the NAL header from a byte buffer.
+ @return unit type if read successfully, or -1 if this doesn't look like a nal
+*/
+int peek_h265_nal_unit(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    bs_t bs;
+    bs_t* b = &bs;
+    bs_init(b, buf, size);
+
+    nal->forbidden_zero_bit = bs_read_f(b,1);
+    nal->nal_unit_type = bs_read_u(b,6);
+    nal->nuh_layer_id = bs_read_u(b,6);
+    nal->nuh_temporal_id_plus1 = bs_read_u(b,3);
+
+    // basic verification, per 7.4.2.2
+    if ( size < 2 || nal->forbidden_zero_bit || nal->nuh_temporal_id_plus1 == 0 ) { return -1; }
+    if ( H265_IS_IRAP(nal->nal_unit_type) && nal->nuh_temporal_id_plus1 != 1 ) { return -1; }
+
+    return nal->nal_unit_type;
+}
+
+// the variables 7.4.8 derives from a short-term reference picture set, (7-61) to (7-64)
+static void h265_st_ref_pic_set_derive(h265_st_ref_pic_set_t* rps, const h265_st_ref_pic_set_t* ref)
+{
+    int i, j, dPoc;
+
+    if (rps->inter_ref_pic_set_prediction_flag)
+    {
+        int deltaRps = (1 - 2 * rps->delta_rps_sign) * (rps->abs_delta_rps_minus1 + 1);
+        int use_delta_flag[H265_MAX_DPB_SIZE + 1];
+
+        // use_delta_flag is 1 when it is not there, which is whenever used_by_curr_pic_flag is 1
+        for (j = 0; j <= ref->NumDeltaPocs; j++) { use_delta_flag[j] = rps->used_by_curr_pic_flag[j] || rps->use_delta_flag[j]; }
+
+        i = 0;
+        for (j = ref->NumPositivePics - 1; j >= 0 && i < H265_MAX_DPB_SIZE; j--)
+        {
+            dPoc = ref->DeltaPocS1[j] + deltaRps;
+            if (dPoc < 0 && use_delta_flag[ref->NumNegativePics + j])
+            {
+                rps->DeltaPocS0[i] = dPoc;
+                rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[ref->NumNegativePics + j];
+            }
+        }
+        if (deltaRps < 0 && use_delta_flag[ref->NumDeltaPocs] && i < H265_MAX_DPB_SIZE)
+        {
+            rps->DeltaPocS0[i] = deltaRps;
+            rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[ref->NumDeltaPocs];
+        }
+        for (j = 0; j < ref->NumNegativePics && i < H265_MAX_DPB_SIZE; j++)
+        {
+            dPoc = ref->DeltaPocS0[j] + deltaRps;
+            if (dPoc < 0 && use_delta_flag[j])
+            {
+                rps->DeltaPocS0[i] = dPoc;
+                rps->UsedByCurrPicS0[i++] = rps->used_by_curr_pic_flag[j];
+            }
+        }
+        rps->NumNegativePics = i;
+
+        i = 0;
+        for (j = ref->NumNegativePics - 1; j >= 0 && i < H265_MAX_DPB_SIZE; j--)
+        {
+            dPoc = ref->DeltaPocS0[j] + deltaRps;
+            if (dPoc > 0 && use_delta_flag[j])
+            {
+                rps->DeltaPocS1[i] = dPoc;
+                rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[j];
+            }
+        }
+        if (deltaRps > 0 && use_delta_flag[ref->NumDeltaPocs] && i < H265_MAX_DPB_SIZE)
+        {
+            rps->DeltaPocS1[i] = deltaRps;
+            rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[ref->NumDeltaPocs];
+        }
+        for (j = 0; j < ref->NumPositivePics && i < H265_MAX_DPB_SIZE; j++)
+        {
+            dPoc = ref->DeltaPocS1[j] + deltaRps;
+            if (dPoc > 0 && use_delta_flag[ref->NumNegativePics + j])
+            {
+                rps->DeltaPocS1[i] = dPoc;
+                rps->UsedByCurrPicS1[i++] = rps->used_by_curr_pic_flag[ref->NumNegativePics + j];
+            }
+        }
+        rps->NumPositivePics = i;
+    }
+    else
+    {
+        rps->NumNegativePics = (rps->num_negative_pics < H265_MAX_DPB_SIZE) ? rps->num_negative_pics : H265_MAX_DPB_SIZE;
+        rps->NumPositivePics = (rps->num_positive_pics < H265_MAX_DPB_SIZE) ? rps->num_positive_pics : H265_MAX_DPB_SIZE;
+        for (i = 0; i < rps->NumNegativePics; i++)
+        {
+            rps->DeltaPocS0[i] = ((i == 0) ? 0 : rps->DeltaPocS0[i - 1]) - (rps->delta_poc_s0_minus1[i] + 1);
+            rps->UsedByCurrPicS0[i] = rps->used_by_curr_pic_s0_flag[i];
+        }
+        for (i = 0; i < rps->NumPositivePics; i++)
+        {
+            rps->DeltaPocS1[i] = ((i == 0) ? 0 : rps->DeltaPocS1[i - 1]) + (rps->delta_poc_s1_minus1[i] + 1);
+            rps->UsedByCurrPicS1[i] = rps->used_by_curr_pic_s1_flag[i];
+        }
+    }
+
+    // no more than the DPB holds, so that a set predicted from this one stays within its arrays
+    if (rps->NumNegativePics + rps->NumPositivePics > H265_MAX_DPB_SIZE)
+    {
+        rps->NumPositivePics = H265_MAX_DPB_SIZE - rps->NumNegativePics;
+    }
+    rps->NumDeltaPocs = rps->NumNegativePics + rps->NumPositivePics;
+}
+
+// PicSizeInCtbsY (7-10 to 7-19), slice_segment_address has Ceil( Log2( PicSizeInCtbsY ) ) bits
+static int h265_pic_size_in_ctbs(h265_sps_t* sps)
+{
+    int CtbLog2SizeY = sps->log2_min_luma_coding_block_size_minus3 + 3 + sps->log2_diff_max_min_luma_coding_block_size;
+    if (CtbLog2SizeY < 4 || CtbLog2SizeY > 6) { CtbLog2SizeY = 6; }
+    int CtbSizeY = 1 << CtbLog2SizeY;
+    int PicWidthInCtbsY = (sps->pic_width_in_luma_samples + CtbSizeY - 1) / CtbSizeY;
+    int PicHeightInCtbsY = (sps->pic_height_in_luma_samples + CtbSizeY - 1) / CtbSizeY;
+    return PicWidthInCtbsY * PicHeightInCtbsY;
+}
+
+#end_preamble
+
+#function_declarations
+
+#debug_names h265_stream_debug_names
+
+
+//7.3.1.1 General NAL unit syntax
+int structure(h265_nal_unit)(h265_stream_t* h, uint8_t* buf, int size)
+{
+    h265_nal_t* nal = h->nal;
+
+    int nal_size = size;
+    int rbsp_size = size;
+    uint8_t* rbsp_buf = NULL;
+    bs_t bs;
+    bs_t* b = &bs;
+
+    if( is_reading )
+    {
+        // read the rbsp straight from the nal, escapes are skipped as they come up
+        bs_init_nal(b, buf, nal_size);
+    }
+
+    if( is_writing )
+    {
+        rbsp_size = size*3/4; // NOTE this may have to be slightly smaller (3/4 smaller, worst case) in order to be guaranteed to fit
+        rbsp_buf = (uint8_t*)calloc(1, rbsp_size);
+        bs_init(b, rbsp_buf, rbsp_size);
+    }
+
+    structure(h265_nal_unit_header)(nal, b);
+
+    if( is_reading && h->parse_depth < H265_PARSE_HEADERS )
+    {
+        return nal_size;
+    }
+
+    switch ( nal->nal_unit_type )
+    {
+        case H265_NAL_UNIT_TYPE_TRAIL_N:
+        case H265_NAL_UNIT_TYPE_TRAIL_R:
+        case H265_NAL_UNIT_TYPE_TSA_N:
+        case H265_NAL_UNIT_TYPE_TSA_R:
+        case H265_NAL_UNIT_TYPE_STSA_N:
+        case H265_NAL_UNIT_TYPE_STSA_R:
+        case H265_NAL_UNIT_TYPE_RADL_N:
+        case H265_NAL_UNIT_TYPE_RADL_R:
+        case H265_NAL_UNIT_TYPE_RASL_N:
+        case H265_NAL_UNIT_TYPE_RASL_R:
+        case H265_NAL_UNIT_TYPE_BLA_W_LP:
+        case H265_NAL_UNIT_TYPE_BLA_W_RADL:
+        case H265_NAL_UNIT_TYPE_BLA_N_LP:
+        case H265_NAL_UNIT_TYPE_IDR_W_RADL:
+        case H265_NAL_UNIT_TYPE_IDR_N_LP:
+        case H265_NAL_UNIT_TYPE_CRA_NUT:
+            structure(h265_slice_segment_layer_rbsp)(h, b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_VPS:
+            if( is_reading && !is_debugging && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            structure(h265_video_parameter_set_rbsp)(h->vps, b);
+            if( h->vps->incomplete ) { free(rbsp_buf); return -1; }
+            structure(h265_rbsp_trailing_bits)(b);
+
+            if( is_reading )
+            {
+                int id = h->vps->vps_video_parameter_set_id;
+                memcpy(h265_vps_slot(h, id), h->vps, sizeof(h265_vps_t));
+                h->vps_table_hash[id] = h264_nal_hash(buf, nal_size);
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_SPS:
+            if( is_reading && !is_debugging && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            structure(h265_seq_parameter_set_rbsp)(h->sps, b);
+            if( h->sps->incomplete ) { free(rbsp_buf); h->sps_hash = 0; return -1; }
+            structure(h265_rbsp_trailing_bits)(b);
+
+            if( is_reading )
+            {
+                int id = h->sps->sps_seq_parameter_set_id;
+                if( id >= 16 ) { return -1; }
+                memcpy(h265_sps_slot(h, id), h->sps, sizeof(h265_sps_t));
+                h->sps_hash = h264_nal_hash(buf, nal_size);
+                h->sps_table_hash[id] = h->sps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_PPS:
+            if( is_reading && !is_debugging && h265_ps_resent(h, buf, nal_size) ) { break; }
+
+            structure(h265_pic_parameter_set_rbsp)(h->pps, b);
+            structure(h265_rbsp_trailing_bits)(b);
+
+            if( is_reading )
+            {
+                int id = h->pps->pps_pic_parameter_set_id;
+                if( id >= 64 ) { return -1; }
+                memcpy(h265_pps_slot(h, id), h->pps, sizeof(h265_pps_t));
+                h->pps_hash = h264_nal_hash(buf, nal_size);
+                h->pps_table_hash[id] = h->pps_hash;
+            }
+            break;
+
+        case H265_NAL_UNIT_TYPE_AUD:
+            structure(h265_access_unit_delimiter_rbsp)(h, b);
+            structure(h265_rbsp_trailing_bits)(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_PREFIX_SEI:
+        case H265_NAL_UNIT_TYPE_SUFFIX_SEI:
+            structure(h265_sei_rbsp)(h, b);
+            structure(h265_rbsp_trailing_bits)(b);
+            break;
+
+        case H265_NAL_UNIT_TYPE_EOS:
+        case H265_NAL_UNIT_TYPE_EOB:
+            // 7.3.2.6, 7.3.2.7 the rbsp is empty
+            break;
+
+        case H265_NAL_UNIT_TYPE_FD:
+        default:
+            free(rbsp_buf);
+            return -1;
+    }
+
+    if (bs_overrun(b)) { free(rbsp_buf); return -1; }
+
+    if( is_writing )
+    {
+        // now get the actual size used
+        rbsp_size = bs_pos(b);
+
+        int rc = rbsp_to_nal(rbsp_buf, &rbsp_size, buf, &nal_size);
+        if (rc < 0) { free(rbsp_buf); return -1; }
+    }
+
+    free(rbsp_buf);
+
+    return nal_size;
+}
+
+//7.3.1.2 NAL unit header syntax
+void structure(h265_nal_unit_header)(h265_nal_t* nal, bs_t* b)
+{
+    value( forbidden_zero_bit, f(1, 0) );
+    value( nal->nal_unit_type, u(6) );
+    value( nal->nuh_layer_id, u(6) );
+    value( nal->nuh_temporal_id_plus1, u(3) );
+}
+
+//7.3.2.1 Video parameter set RBSP syntax
+void structure(h265_video_parameter_set_rbsp)(h265_vps_t* vps, bs_t* b)
+{
+    int i, j;
+
+    if( is_reading )
+    {
+        memset(vps, 0, sizeof(h265_vps_t));
+    }
+
+    value( vps->vps_video_parameter_set_id, u(4) );
+    value( vps->vps_base_layer_internal_flag, u1 );
+    value( vps->vps_base_layer_available_flag, u1 );
+    value( vps->vps_max_layers_minus1, u(6) );
+    value( vps->vps_max_sub_layers_minus1, u(3) );
+    value( vps->vps_temporal_id_nesting_flag, u1 );
+    value( vps_reserved_0xffff_16bits, f(16, 0xFFFF) );
+    structure(h265_profile_tier_level)(&vps->ptl, 1, vps->vps_max_sub_layers_minus1, b);
+    value( vps->vps_sub_layer_ordering_info_present_flag, u1 );
+    for( i = ( vps->vps_sub_layer_ordering_info_present_flag ? 0 : vps->vps_max_sub_layers_minus1 );
+         i <= vps->vps_max_sub_layers_minus1; i++ )
+    {
+        value( vps->vps_max_dec_pic_buffering_minus1[ i ], ue );
+        value( vps->vps_max_num_reorder_pics[ i ], ue );
+        value( vps->vps_max_latency_increase_plus1[ i ], ue );
+    }
+    value( vps->vps_max_layer_id, u(6) );
+    value( vps->vps_num_layer_sets_minus1, ue );
+    if( vps->vps_num_layer_sets_minus1 >= H265_MAX_LAYER_SETS )
+    {
+        // not read past here
+        vps->incomplete = 1;
+        return;
+    }
+    for( i = 1; i <= vps->vps_num_layer_sets_minus1; i++ )
+    {
+        for( j = 0; j <= vps->vps_max_layer_id; j++ )
+        {
+            value( vps->layer_id_included_flag[ i ][ j ], u1 );
+        }
+    }
+    value( vps->vps_timing_info_present_flag, u1 );
+    if( vps->vps_timing_info_present_flag )
+    {
+        value( vps->vps_num_units_in_tick, u(32) );
+        value( vps->vps_time_scale, u(32) );
+        value( vps->vps_poc_proportional_to_timing_flag, u1 );
+        if( vps->vps_poc_proportional_to_timing_flag )
+        {
+            value( vps->vps_num_ticks_poc_diff_one_minus1, ue );
+        }
+        value( vps->vps_num_hrd_parameters, ue );
+        if( vps->vps_num_hrd_parameters > H265_MAX_VPS_HRD )
+        {
+            // not read past here
+            vps->incomplete = 1;
+            return;
+        }
+        for( i = 0; i < vps->vps_num_hrd_parameters; i++ )
+        {
+            value( vps->hrd_layer_set_idx[ i ], ue );
+            if( i > 0 )
+            {
+                value( vps->cprms_present_flag[ i ], u1 );
+            }
+            else if( is_reading )
+            {
+                vps->cprms_present_flag[ i ] = 1;
+            }
+            structure(h265_hrd_parameters)(&vps->hrd[ i ], vps->cprms_present_flag[ i ], vps->vps_max_sub_layers_minus1, b);
+        }
+    }
+    value( vps->vps_extension_flag, u1 );
+    // vps_extension_data_flag (multilayer and 3D) is not read
+}
+
+//7.3.3 Profile, tier and level syntax
+void structure(h265_profile_tier_level)(h265_profile_tier_level_t* ptl, int profilePresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i, j;
+
+    if( profilePresentFlag )
+    {
+        value( ptl->general_profile_space, u(2) );
+        value( ptl->general_tier_flag, u1 );
+        value( ptl->general_profile_idc, u(5) );
+        for( j = 0; j < 32; j++ )
+        {
+            value( ptl->general_profile_compatibility_flag[ j ], u1 );
+        }
+        value( ptl->general_progressive_source_flag, u1 );
+        value( ptl->general_interlaced_source_flag, u1 );
+        value( ptl->general_non_packed_constraint_flag, u1 );
+        value( ptl->general_frame_only_constraint_flag, u1 );
+        value( ptl->general_reserved_zero_44bits[ 0 ], u(32) );
+        value( ptl->general_reserved_zero_44bits[ 1 ], u(12) );
+    }
+    value( ptl->general_level_idc, u8 );
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        value( ptl->sub_layer_profile_present_flag[ i ], u1 );
+        value( ptl->sub_layer_level_present_flag[ i ], u1 );
+    }
+    if( maxNumSubLayersMinus1 > 0 )
+    {
+        for( i = maxNumSubLayersMinus1; i < 8; i++ )
+        {
+            value( reserved_zero_2bits, f(2, 0) );
+        }
+    }
+    for( i = 0; i < maxNumSubLayersMinus1; i++ )
+    {
+        if( ptl->sub_layer_profile_present_flag[ i ] )
+        {
+            value( ptl->sub_layer[ i ].sub_layer_profile_space, u(2) );
+            value( ptl->sub_layer[ i ].sub_layer_tier_flag, u1 );
+            value( ptl->sub_layer[ i ].sub_layer_profile_idc, u(5) );
+            for( j = 0; j < 32; j++ )
+            {
+                value( ptl->sub_layer[ i ].sub_layer_profile_compatibility_flag[ j ], u1 );
+            }
+            value( ptl->sub_layer[ i ].sub_layer_progressive_source_flag, u1 );
+            value( ptl->sub_layer[ i ].sub_layer_interlaced_source_flag, u1 );
+            value( ptl->sub_layer[ i ].sub_layer_non_packed_constraint_flag, u1 );
+            value( ptl->sub_layer[ i ].sub_layer_frame_only_constraint_flag, u1 );
+            value( ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 0 ], u(32) );
+            value( ptl->sub_layer[ i ].sub_layer_reserved_zero_44bits[ 1 ], u(12) );
+        }
+        if( ptl->sub_layer_level_present_flag[ i ] )
+        {
+            value( ptl->sub_layer[ i ].sub_layer_level_idc, u8 );
+        }
+    }
+}
+
+//E.2.2 HRD parameters syntax
+void structure(h265_hrd_parameters)(h265_hrd_t* hrd, int commonInfPresentFlag, int maxNumSubLayersMinus1, bs_t* b)
+{
+    int i;
+
+    if( commonInfPresentFlag )
+    {
+        value( hrd->nal_hrd_parameters_present_flag, u1 );
+        value( hrd->vcl_hrd_parameters_present_flag, u1 );
+        if( hrd->nal_hrd_parameters_present_flag || hrd->vcl_hrd_parameters_present_flag )
+        {
+            value( hrd->sub_pic_hrd_params_present_flag, u1 );
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                value( hrd->tick_divisor_minus2, u8 );
+                value( hrd->du_cpb_removal_delay_increment_length_minus1, u(5) );
+                value( hrd->sub_pic_cpb_params_in_pic_timing_sei_flag, u1 );
+                value( hrd->dpb_output_delay_du_length_minus1, u(5) );
+            }
+            value( hrd->bit_rate_scale, u(4) );
+            value( hrd->cpb_size_scale, u(4) );
+            if( hrd->sub_pic_hrd_params_present_flag )
+            {
+                value( hrd->cpb_size_du_scale, u(4) );
+            }
+            value( hrd->initial_cpb_removal_delay_length_minus1, u(5) );
+            value( hrd->au_cpb_removal_delay_length_minus1, u(5) );
+            value( hrd->dpb_output_delay_length_minus1, u(5) );
+        }
+    }
+    for( i = 0; i <= maxNumSubLayersMinus1; i++ )
+    {
+        value( hrd->fixed_pic_rate_general_flag[ i ], u1 );
+        if( is_reading )
+        {
+            hrd->fixed_pic_rate_within_cvs_flag[ i ] = hrd->fixed_pic_rate_general_flag[ i ];
+            hrd->low_delay_hrd_flag[ i ] = 0;
+            hrd->cpb_cnt_minus1[ i ] = 0;
+        }
+        if( !hrd->fixed_pic_rate_general_flag[ i ] )
+        {
+            value( hrd->fixed_pic_rate_within_cvs_flag[ i ], u1 );
+        }
+        if( hrd->fixed_pic_rate_within_cvs_flag[ i ] )
+        {
+            value( hrd->elemental_duration_in_tc_minus1[ i ], ue );
+        }
+        else
+        {
+            value( hrd->low_delay_hrd_flag[ i ], u1 );
+        }
+        if( !hrd->low_delay_hrd_flag[ i ] )
+        {
+            value( hrd->cpb_cnt_minus1[ i ], ue );
+        }
+        if( hrd->nal_hrd_parameters_present_flag )
+        {
+            structure(h265_sub_layer_hrd_parameters)(&hrd->sub_layer_hrd_nal[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+        if( hrd->vcl_hrd_parameters_present_flag )
+        {
+            structure(h265_sub_layer_hrd_parameters)(&hrd->sub_layer_hrd_vcl[ i ], hrd->cpb_cnt_minus1[ i ], hrd->sub_pic_hrd_params_present_flag, b);
+        }
+    }
+}
+
+//E.2.3 Sub-layer HRD parameters syntax
+void structure(h265_sub_layer_hrd_parameters)(h265_sub_layer_hrd_t* sub, int cpb_cnt_minus1, int sub_pic_hrd_params_present_flag, bs_t* b)
+{
+    int i;
+
+    for( i = 0; i <= cpb_cnt_minus1 && i < H265_MAX_CPB_CNT; i++ )
+    {
+        value( sub->bit_rate_value_minus1[ i ], ue );
+        value( sub->cpb_size_value_minus1[ i ], ue );
+        if( sub_pic_hrd_params_present_flag )
+        {
+            value( sub->cpb_size_du_value_minus1[ i ], ue );
+            value( sub->bit_rate_du_value_minus1[ i ], ue );
+        }
+        value( sub->cbr_flag[ i ], u1 );
+    }
+}
+
+//7.3.2.2.1 General sequence parameter set RBSP syntax
+void structure(h265_seq_parameter_set_rbsp)(h265_sps_t* sps, bs_t* b)
+{
+    int i;
+
+    if( is_reading )
+    {
+        memset(sps, 0, sizeof(h265_sps_t));
+    }
+
+    value( sps->sps_video_parameter_set_id, u(4) );
+    value( sps->sps_max_sub_layers_minus1, u(3) );
+    value( sps->sps_temporal_id_nesting_flag, u1 );
+    structure(h265_profile_tier_level)(&sps->ptl, 1, sps->sps_max_sub_layers_minus1, b);
+    value( sps->sps_seq_parameter_set_id, ue );
+    value( sps->chroma_format_idc, ue );
+    if( sps->chroma_format_idc == 3 )
+    {
+        value( sps->separate_colour_plane_flag, u1 );
+    }
+    value( sps->pic_width_in_luma_samples, ue );
+    value( sps->pic_height_in_luma_samples, ue );
+    value( sps->conformance_window_flag, u1 );
+    if( sps->conformance_window_flag )
+    {
+        value( sps->conf_win_left_offset, ue );
+        value( sps->conf_win_right_offset, ue );
+        value( sps->conf_win_top_offset, ue );
+        value( sps->conf_win_bottom_offset, ue );
+    }
+    value( sps->bit_depth_luma_minus8, ue );
+    value( sps->bit_depth_chroma_minus8, ue );
+    value( sps->log2_max_pic_order_cnt_lsb_minus4, ue );
+    value( sps->sps_sub_layer_ordering_info_present_flag, u1 );
+    for( i = ( sps->sps_sub_layer_ordering_info_present_flag ? 0 : sps->sps_max_sub_layers_minus1 );
+         i <= sps->sps_max_sub_layers_minus1; i++ )
+    {
+        value( sps->sps_max_dec_pic_buffering_minus1[ i ], ue );
+        value( sps->sps_max_num_reorder_pics[ i ], ue );
+        value( sps->sps_max_latency_increase_plus1[ i ], ue );
+    }
+    value( sps->log2_min_luma_coding_block_size_minus3, ue );
+    value( sps->log2_diff_max_min_luma_coding_block_size, ue );
+    value( sps->log2_min_luma_transform_block_size_minus2, ue );
+    value( sps->log2_diff_max_min_luma_transform_block_size, ue );
+    value( sps->max_transform_hierarchy_depth_inter, ue );
+    value( sps->max_transform_hierarchy_depth_intra, ue );
+    value( sps->scaling_list_enabled_flag, u1 );
+    if( sps->scaling_list_enabled_flag )
+    {
+        value( sps->sps_scaling_list_data_present_flag, u1 );
+        if( sps->sps_scaling_list_data_present_flag )
+        {
+            structure(h265_scaling_list_data)(&sps->scaling_list, b);
+        }
+    }
+    value( sps->amp_enabled_flag, u1 );
+    value( sps->sample_adaptive_offset_enabled_flag, u1 );
+    value( sps->pcm_enabled_flag, u1 );
+    if( sps->pcm_enabled_flag )
+    {
+        value( sps->pcm_sample_bit_depth_luma_minus1, u(4) );
+        value( sps->pcm_sample_bit_depth_chroma_minus1, u(4) );
+        value( sps->log2_min_pcm_luma_coding_block_size_minus3, ue );
+        value( sps->log2_diff_max_min_pcm_luma_coding_block_size, ue );
+        value( sps->pcm_loop_filter_disabled_flag, u1 );
+    }
+    value( sps->num_short_term_ref_pic_sets, ue );
+    if( sps->num_short_term_ref_pic_sets > H265_MAX_SHORT_TERM_RPS )
+    {
+        // not read past here
+        sps->incomplete = 1;
+        return;
+    }
+    for( i = 0; i < sps->num_short_term_ref_pic_sets; i++ )
+    {
+        structure(h265_st_ref_pic_set)(&sps->st_ref_pic_set[ i ], sps->st_ref_pic_set, i, sps->num_short_term_ref_pic_sets, b);
+    }
+    value( sps->long_term_ref_pics_present_flag, u1 );
+    if( sps->long_term_ref_pics_present_flag )
+    {
+        value( sps->num_long_term_ref_pics_sps, ue );
+        for( i = 0; i < sps->num_long_term_ref_pics_sps && i < H265_MAX_LONG_TERM_PICS; i++ )
+        {
+            value( sps->lt_ref_pic_poc_lsb_sps[ i ], u( sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ) );
+            value( sps->used_by_curr_pic_lt_sps_flag[ i ], u1 );
+        }
+    }
+    value( sps->sps_temporal_mvp_enabled_flag, u1 );
+    value( sps->strong_intra_smoothing_enabled_flag, u1 );
+    value( sps->vui_parameters_present_flag, u1 );
+    if( sps->vui_parameters_present_flag )
+    {
+        structure(h265_vui_parameters)(sps, b);
+    }
+    value( sps->sps_extension_present_flag, u1 );
+    if( sps->sps_extension_present_flag )
+    {
+        value( sps->sps_range_extension_flag, u1 );
+        value( sps->sps_multilayer_extension_flag, u1 );
+        value( sps->sps_3d_extension_flag, u1 );
+        value( sps->sps_scc_extension_flag, u1 );
+        value( sps->sps_extension_4bits, u(4) );
+    }
+    if( sps->sps_range_extension_flag )
+    {
+        value( sps->transform_skip_rotation_enabled_flag, u1 );
+        value( sps->transform_skip_context_enabled_flag, u1 );
+        value( sps->implicit_rdpcm_enabled_flag, u1 );
+        value( sps->explicit_rdpcm_enabled_flag, u1 );
+        value( sps->extended_precision_processing_flag, u1 );
+        value( sps->intra_smoothing_disabled_flag, u1 );
+        value( sps->high_precision_offsets_enabled_flag, u1 );
+        value( sps->persistent_rice_adaptation_enabled_flag, u1 );
+        value( sps->cabac_bypass_alignment_enabled_flag, u1 );
+    }
+    // the multilayer, 3D and SCC extensions and sps_extension_data_flag are not read
+}
+
+//7.3.4 Scaling list data syntax
+void structure(h265_scaling_list_data)(h265_scaling_list_t* sl, bs_t* b)
+{
+    int sizeId, matrixId, i;
+    int scaling_list_delta_coef;
+
+    for( sizeId = 0; sizeId < 4; sizeId++ )
+    {
+        for( matrixId = 0; matrixId < 6; matrixId += ( sizeId == 3 ) ? 3 : 1 )
+        {
+            value( sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ], u1 );
+            if( !sl->scaling_list_pred_mode_flag[ sizeId ][ matrixId ] )
+            {
+                value( sl->scaling_list_pred_matrix_id_delta[ sizeId ][ matrixId ], ue );
+            }
+            else
+            {
+                int nextCoef = 8;
+                int coefNum = ( sizeId == 0 ) ? 16 : 64;
+                if( sizeId > 1 )
+                {
+                    value( sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ], se );
+                    nextCoef = sl->scaling_list_dc_coef_minus8[ sizeId - 2 ][ matrixId ] + 8;
+                }
+                for( i = 0; i < coefNum; i++ )
+                {
+                    if( is_writing )
+                    {
+                        // any difference that comes out the same modulo 256 will do, take the one in -128..127
+                        scaling_list_delta_coef = ( ( sl->ScalingList[ sizeId ][ matrixId ][ i ] - nextCoef + 128 ) & 255 ) - 128;
+                    }
+                    value( scaling_list_delta_coef, se );
+                    nextCoef = ( nextCoef + scaling_list_delta_coef + 256 ) % 256;
+                    if( is_reading )
+                    {
+                        sl->ScalingList[ sizeId ][ matrixId ][ i ] = nextCoef;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//7.3.7 Short-term reference picture set syntax
+void structure(h265_st_ref_pic_set)(h265_st_ref_pic_set_t* rps, h265_st_ref_pic_set_t* sets, int stRpsIdx, int num_short_term_ref_pic_sets, bs_t* b)
+{
+    int i, j;
+
+    if( is_reading )
+    {
+        memset(rps, 0, sizeof(h265_st_ref_pic_set_t));
+    }
+
+    if( stRpsIdx != 0 )
+    {
+        value( rps->inter_ref_pic_set_prediction_flag, u1 );
+    }
+    if( rps->inter_ref_pic_set_prediction_flag )
+    {
+        if( stRpsIdx == num_short_term_ref_pic_sets )
+        {
+            value( rps->delta_idx_minus1, ue );
+        }
+        value( rps->delta_rps_sign, u1 );
+        value( rps->abs_delta_rps_minus1, ue );
+
+        int RefRpsIdx = stRpsIdx - ( rps->delta_idx_minus1 + 1 );
+        if( RefRpsIdx < 0 || RefRpsIdx >= H265_MAX_SHORT_TERM_RPS ) { RefRpsIdx = 0; }
+        h265_st_ref_pic_set_t* ref = &sets[ RefRpsIdx ];
+
+        for( j = 0; j <= ref->NumDeltaPocs; j++ )
+        {
+            value( rps->used_by_curr_pic_flag[ j ], u1 );
+            if( !rps->used_by_curr_pic_flag[ j ] )
+            {
+                value( rps->use_delta_flag[ j ], u1 );
+            }
+        }
+        h265_st_ref_pic_set_derive(rps, ref);
+    }
+    else
+    {
+        value( rps->num_negative_pics, ue );
+        value( rps->num_positive_pics, ue );
+        for( i = 0; i < rps->num_negative_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            value( rps->delta_poc_s0_minus1[ i ], ue );
+            value( rps->used_by_curr_pic_s0_flag[ i ], u1 );
+        }
+        for( i = 0; i < rps->num_positive_pics && i < H265_MAX_DPB_SIZE; i++ )
+        {
+            value( rps->delta_poc_s1_minus1[ i ], ue );
+            value( rps->used_by_curr_pic_s1_flag[ i ], u1 );
+        }
+        h265_st_ref_pic_set_derive(rps, NULL);
+    }
+}
+
+//E.2.1 VUI parameters syntax
+void structure(h265_vui_parameters)(h265_sps_t* sps, bs_t* b)
+{
+    value( sps->vui.aspect_ratio_info_present_flag, u1 );
+    if( sps->vui.aspect_ratio_info_present_flag )
+    {
+        value( sps->vui.aspect_ratio_idc, u8 );
+        if( sps->vui.aspect_ratio_idc == SAR_Extended )
+        {
+            value( sps->vui.sar_width, u(16) );
+            value( sps->vui.sar_height, u(16) );
+        }
+    }
+    value( sps->vui.overscan_info_present_flag, u1 );
+    if( sps->vui.overscan_info_present_flag )
+    {
+        value( sps->vui.overscan_appropriate_flag, u1 );
+    }
+    value( sps->vui.video_signal_type_present_flag, u1 );
+    if( sps->vui.video_signal_type_present_flag )
+    {
+        value( sps->vui.video_format, u(3) );
+        value( sps->vui.video_full_range_flag, u1 );
+        value( sps->vui.colour_description_present_flag, u1 );
+        if( sps->vui.colour_description_present_flag )
+        {
+            value( sps->vui.colour_primaries, u8 );
+            value( sps->vui.transfer_characteristics, u8 );
+            value( sps->vui.matrix_coeffs, u8 );
+        }
+    }
+    value( sps->vui.chroma_loc_info_present_flag, u1 );
+    if( sps->vui.chroma_loc_info_present_flag )
+    {
+        value( sps->vui.chroma_sample_loc_type_top_field, ue );
+        value( sps->vui.chroma_sample_loc_type_bottom_field, ue );
+    }
+    value( sps->vui.neutral_chroma_indication_flag, u1 );
+    value( sps->vui.field_seq_flag, u1 );
+    value( sps->vui.frame_field_info_present_flag, u1 );
+    value( sps->vui.default_display_window_flag, u1 );
+    if( sps->vui.default_display_window_flag )
+    {
+        value( sps->vui.def_disp_win_left_offset, ue );
+        value( sps->vui.def_disp_win_right_offset, ue );
+        value( sps->vui.def_disp_win_top_offset, ue );
+        value( sps->vui.def_disp_win_bottom_offset, ue );
+    }
+    value( sps->vui.vui_timing_info_present_flag, u1 );
+    if( sps->vui.vui_timing_info_present_flag )
+    {
+        value( sps->vui.vui_num_units_in_tick, u(32) );
+        value( sps->vui.vui_time_scale, u(32) );
+        value( sps->vui.vui_poc_proportional_to_timing_flag, u1 );
+        if( sps->vui.vui_poc_proportional_to_timing_flag )
+        {
+            value( sps->vui.vui_num_ticks_poc_diff_one_minus1, ue );
+        }
+        value( sps->vui.vui_hrd_parameters_present_flag, u1 );
+        if( sps->vui.vui_hrd_parameters_present_flag )
+        {
+            structure(h265_hrd_parameters)(&sps->hrd, 1, sps->sps_max_sub_layers_minus1, b);
+        }
+    }
+    value( sps->vui.bitstream_restriction_flag, u1 );
+    if( sps->vui.bitstream_restriction_flag )
+    {
+        value( sps->vui.tiles_fixed_structure_flag, u1 );
+        value( sps->vui.motion_vectors_over_pic_boundaries_flag, u1 );
+        value( sps->vui.restricted_ref_pic_lists_flag, u1 );
+        value( sps->vui.min_spatial_segmentation_idc, ue );
+        value( sps->vui.max_bytes_per_pic_denom, ue );
+        value( sps->vui.max_bits_per_min_cu_denom, ue );
+        value( sps->vui.log2_max_mv_length_horizontal, ue );
+        value( sps->vui.log2_max_mv_length_vertical, ue );
+    }
+}
+
+//7.3.2.3.1 General picture parameter set RBSP syntax
+void structure(h265_pic_parameter_set_rbsp)(h265_pps_t* pps, bs_t* b)
+{
+    int i;
+
+    if( is_reading )
+    {
+        memset(pps, 0, sizeof(h265_pps_t));
+        pps->uniform_spacing_flag = 1;
+        pps->loop_filter_across_tiles_enabled_flag = 1;
+    }
+
+    value( pps->pps_pic_parameter_set_id, ue );
+    value( pps->pps_seq_parameter_set_id, ue );
+    value( pps->dependent_slice_segments_enabled_flag, u1 );
+    value( pps->output_flag_present_flag, u1 );
+    value( pps->num_extra_slice_header_bits, u(3) );
+    value( pps->sign_data_hiding_enabled_flag, u1 );
+    value( pps->cabac_init_present_flag, u1 );
+    value( pps->num_ref_idx_l0_default_active_minus1, ue );
+    value( pps->num_ref_idx_l1_default_active_minus1, ue );
+    value( pps->init_qp_minus26, se );
+    value( pps->constrained_intra_pred_flag, u1 );
+    value( pps->transform_skip_enabled_flag, u1 );
+    value( pps->cu_qp_delta_enabled_flag, u1 );
+    if( pps->cu_qp_delta_enabled_flag )
+    {
+        value( pps->diff_cu_qp_delta_depth, ue );
+    }
+    value( pps->pps_cb_qp_offset, se );
+    value( pps->pps_cr_qp_offset, se );
+    value( pps->pps_slice_chroma_qp_offsets_present_flag, u1 );
+    value( pps->weighted_pred_flag, u1 );
+    value( pps->weighted_bipred_flag, u1 );
+    value( pps->transquant_bypass_enabled_flag, u1 );
+    value( pps->tiles_enabled_flag, u1 );
+    value( pps->entropy_coding_sync_enabled_flag, u1 );
+    if( pps->tiles_enabled_flag )
+    {
+        value( pps->num_tile_columns_minus1, ue );
+        value( pps->num_tile_rows_minus1, ue );
+        value( pps->uniform_spacing_flag, u1 );
+        if( !pps->uniform_spacing_flag )
+        {
+            for( i = 0; i < pps->num_tile_columns_minus1 && i < H265_MAX_TILE_COLUMNS; i++ )
+            {
+                value( pps->column_width_minus1[ i ], ue );
+            }
+            for( i = 0; i < pps->num_tile_rows_minus1 && i < H265_MAX_TILE_ROWS; i++ )
+            {
+                value( pps->row_height_minus1[ i ], ue );
+            }
+        }
+        value( pps->loop_filter_across_tiles_enabled_flag, u1 );
+    }
+    value( pps->pps_loop_filter_across_slices_enabled_flag, u1 );
+    value( pps->deblocking_filter_control_present_flag, u1 );
+    if( pps->deblocking_filter_control_present_flag )
+    {
+        value( pps->deblocking_filter_override_enabled_flag, u1 );
+        value( pps->pps_deblocking_filter_disabled_flag, u1 );
+        if( !pps->pps_deblocking_filter_disabled_flag )
+        {
+            value( pps->pps_beta_offset_div2, se );
+            value( pps->pps_tc_offset_div2, se );
+        }
+    }
+    value( pps->pps_scaling_list_data_present_flag, u1 );
+    if( pps->pps_scaling_list_data_present_flag )
+    {
+        structure(h265_scaling_list_data)(&pps->scaling_list, b);
+    }
+    value( pps->lists_modification_present_flag, u1 );
+    value( pps->log2_parallel_merge_level_minus2, ue );
+    value( pps->slice_segment_header_extension_present_flag, u1 );
+    value( pps->pps_extension_present_flag, u1 );
+    if( pps->pps_extension_present_flag )
+    {
+        value( pps->pps_range_extension_flag, u1 );
+        value( pps->pps_multilayer_extension_flag, u1 );
+        value( pps->pps_3d_extension_flag, u1 );
+        value( pps->pps_scc_extension_flag, u1 );
+        value( pps->pps_extension_4bits, u(4) );
+    }
+    if( pps->pps_range_extension_flag )
+    {
+        if( pps->transform_skip_enabled_flag )
+        {
+            value( pps->log2_max_transform_skip_block_size_minus2, ue );
+        }
+        value( pps->cross_component_prediction_enabled_flag, u1 );
+        value( pps->chroma_qp_offset_list_enabled_flag, u1 );
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            value( pps->diff_cu_chroma_qp_offset_depth, ue );
+            value( pps->chroma_qp_offset_list_len_minus1, ue );
+            for( i = 0; i <= pps->chroma_qp_offset_list_len_minus1 && i < 6; i++ )
+            {
+                value( pps->cb_qp_offset_list[ i ], se );
+                value( pps->cr_qp_offset_list[ i ], se );
+            }
+        }
+        value( pps->log2_sao_offset_scale_luma, ue );
+        value( pps->log2_sao_offset_scale_chroma, ue );
+    }
+    // the multilayer, 3D and SCC extensions and pps_extension_data_flag are not read
+}
+
+//7.3.2.4 Supplemental enhancement information RBSP syntax
+void structure(h265_sei_rbsp)(h265_stream_t* h, bs_t* b)
+{
+    if( is_reading )
+    {
+        // the messages of the previous SEI are reused, with their payload storage
+        h->num_seis = 0;
+        do {
+            h->num_seis++;
+            h265_sei_pool_reserve(h, h->num_seis);
+            h->sei = h->seis[h->num_seis - 1];
+            structure(h265_sei_message)(h, b);
+        } while( more_rbsp_data(b) );
+    }
+
+    if( is_writing )
+    {
+        for (int i = 0; i < h->num_seis; i++)
+        {
+            h->sei = h->seis[i];
+            structure(h265_sei_message)(h, b);
+        }
+        h->sei = NULL;
+    }
+}
+
+//7.3.5 Supplemental enhancement information message syntax
+void structure(h265_sei_message)(h265_stream_t* h, bs_t* b)
+{
+    sei_t* s = h->sei;
+    int i;
+
+    if( is_writing )
+    {
+        _write_ff_coded_number(b, s->payloadType);
+        _write_ff_coded_number(b, s->payloadSize);
+    }
+    if( is_reading )
+    {
+        s->payloadType = _read_ff_coded_number(b);
+        s->payloadSize = _read_ff_coded_number(b);
+
+        // payloads are kept as bytes, see sei_payload() for H.264
+        if ( s->payloadSize > s->data_capacity )
+        {
+            int capacity = (s->data_capacity * 2 > s->payloadSize) ? s->data_capacity * 2 : s->payloadSize;
+            s->data_buf = (uint8_t*)realloc(s->data_buf, capacity);
+            s->data_capacity = capacity;
+        }
+        s->data = s->data_buf;
+    }
+
+    if( is_reading && !is_debugging )
+    {
+        int n = bs_read_bytes(b, s->data, s->payloadSize);
+        if ( n < s->payloadSize ) { memset(s->data + n, 0, s->payloadSize - n); }
+    }
+    else
+    {
+        for ( i = 0; i < s->payloadSize; i++ )
+        {
+            value( s->data[i], u8 );
+        }
+    }
+}
+
+//7.3.2.5 Access unit delimiter RBSP syntax
+void structure(h265_access_unit_delimiter_rbsp)(h265_stream_t* h, bs_t* b)
+{
+    value( h->aud->pic_type, u(3) );
+}
+
+//7.3.2.9 Slice segment layer RBSP syntax
+void structure(h265_slice_segment_layer_rbsp)(h265_stream_t* h, bs_t* b)
+{
+    structure(h265_slice_segment_header)(h, b);
+
+    slice_data_rbsp_t* slice_data = h->slice_data;
+
+    if( is_reading )
+    {
+        free( slice_data->rbsp_buf );
+        slice_data->rbsp_buf = NULL;
+        slice_data->rbsp_size = 0;
+
+        // the header ends byte aligned, slice_segment_data() and the trailing bits are copied as they are
+        if( h->parse_depth >= H265_PARSE_SLICE_DATA && b->p < b->end )
+        {
+            bs_t bs_tmp;
+            bs_clone(&bs_tmp, b);
+            slice_data->rbsp_buf = (uint8_t*)malloc( bs_tmp.end - bs_tmp.p );
+            // b may be a view of the escaped nal, the copy comes out shorter by the number of escapes
+            slice_data->rbsp_size = bs_read_bytes( &bs_tmp, slice_data->rbsp_buf, bs_tmp.end - bs_tmp.p );
+        }
+    }
+
+    if( is_writing && slice_data->rbsp_buf != NULL )
+    {
+        bs_write_bytes( b, slice_data->rbsp_buf, slice_data->rbsp_size );
+    }
+}
+
+//7.3.6.1 General slice segment header syntax
+void structure(h265_slice_segment_header)(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_nal_t* nal = h->nal;
+    int i;
+
+    if( is_reading )
+    {
+        sh->no_output_of_prior_pics_flag = 0;
+        sh->dependent_slice_segment_flag = 0;
+        sh->slice_segment_address = 0;
+    }
+
+    value( sh->first_slice_segment_in_pic_flag, u1 );
+    if( H265_IS_IRAP( nal->nal_unit_type ) )
+    {
+        value( sh->no_output_of_prior_pics_flag, u1 );
+    }
+    value( sh->slice_pic_parameter_set_id, ue );
+
+    // when writing, the slice segment goes out with the parameter sets in h->pps and h->sps as they are
+    if( is_reading )
+    {
+        // only copies when the slice uses other parameter sets than the last one
+        h265_activate_pps(h, sh->slice_pic_parameter_set_id);
+        h265_activate_sps(h, h->pps->pps_seq_parameter_set_id);
+    }
+    h265_pps_t* pps = h->pps;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+
+    if( !sh->first_slice_segment_in_pic_flag )
+    {
+        if( pps->dependent_slice_segments_enabled_flag )
+        {
+            value( sh->dependent_slice_segment_flag, u1 );
+        }
+        value( sh->slice_segment_address, u( intlog2( h265_pic_size_in_ctbs( sps ) ) ) );
+    }
+
+    if( is_reading && !sh->dependent_slice_segment_flag )
+    {
+        memset(&sh->slice_reserved_flag, 0, sizeof(h265_slice_header_t) - offsetof(h265_slice_header_t, slice_reserved_flag));
+        sh->pic_output_flag = 1;
+        sh->num_ref_idx_l0_active_minus1 = pps->num_ref_idx_l0_default_active_minus1;
+        sh->num_ref_idx_l1_active_minus1 = pps->num_ref_idx_l1_default_active_minus1;
+        sh->collocated_from_l0_flag = 1;
+        sh->slice_deblocking_filter_disabled_flag = pps->pps_deblocking_filter_disabled_flag;
+        sh->slice_beta_offset_div2 = pps->pps_beta_offset_div2;
+        sh->slice_tc_offset_div2 = pps->pps_tc_offset_div2;
+        sh->slice_loop_filter_across_slices_enabled_flag = pps->pps_loop_filter_across_slices_enabled_flag;
+    }
+
+    if( !sh->dependent_slice_segment_flag )
+    {
+        for( i = 0; i < pps->num_extra_slice_header_bits; i++ )
+        {
+            value( sh->slice_reserved_flag[ i ], u1 );
+        }
+        value( sh->slice_type, ue );
+        if( pps->output_flag_present_flag )
+        {
+            value( sh->pic_output_flag, u1 );
+        }
+        if( sps->separate_colour_plane_flag )
+        {
+            value( sh->colour_plane_id, u(2) );
+        }
+        if( !H265_IS_IDR( nal->nal_unit_type ) )
+        {
+            value( sh->slice_pic_order_cnt_lsb, u( sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ) );
+            value( sh->short_term_ref_pic_set_sps_flag, u1 );
+            if( !sh->short_term_ref_pic_set_sps_flag )
+            {
+                structure(h265_st_ref_pic_set)(&sh->st_ref_pic_set, sps->st_ref_pic_set, sps->num_short_term_ref_pic_sets, sps->num_short_term_ref_pic_sets, b);
+            }
+            else if( sps->num_short_term_ref_pic_sets > 1 )
+            {
+                value( sh->short_term_ref_pic_set_idx, u( intlog2( sps->num_short_term_ref_pic_sets ) ) );
+            }
+            if( sps->long_term_ref_pics_present_flag )
+            {
+                if( sps->num_long_term_ref_pics_sps > 0 )
+                {
+                    value( sh->num_long_term_sps, ue );
+                }
+                value( sh->num_long_term_pics, ue );
+                for( i = 0; i < sh->num_long_term_sps + sh->num_long_term_pics && i < H265_MAX_LONG_TERM_PICS; i++ )
+                {
+                    if( i < sh->num_long_term_sps )
+                    {
+                        if( sps->num_long_term_ref_pics_sps > 1 )
+                        {
+                            value( sh->lt_idx_sps[ i ], u( intlog2( sps->num_long_term_ref_pics_sps ) ) );
+                        }
+                    }
+                    else
+                    {
+                        value( sh->poc_lsb_lt[ i ], u( sps->log2_max_pic_order_cnt_lsb_minus4 + 4 ) );
+                        value( sh->used_by_curr_pic_lt_flag[ i ], u1 );
+                    }
+                    value( sh->delta_poc_msb_present_flag[ i ], u1 );
+                    if( sh->delta_poc_msb_present_flag[ i ] )
+                    {
+                        value( sh->delta_poc_msb_cycle_lt[ i ], ue );
+                    }
+                }
+            }
+            if( sps->sps_temporal_mvp_enabled_flag )
+            {
+                value( sh->slice_temporal_mvp_enabled_flag, u1 );
+            }
+        }
+        if( sps->sample_adaptive_offset_enabled_flag )
+        {
+            value( sh->slice_sao_luma_flag, u1 );
+            if( ChromaArrayType != 0 )
+            {
+                value( sh->slice_sao_chroma_flag, u1 );
+            }
+        }
+        if( sh->slice_type == H265_SH_SLICE_TYPE_P || sh->slice_type == H265_SH_SLICE_TYPE_B )
+        {
+            value( sh->num_ref_idx_active_override_flag, u1 );
+            if( sh->num_ref_idx_active_override_flag )
+            {
+                value( sh->num_ref_idx_l0_active_minus1, ue );
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    value( sh->num_ref_idx_l1_active_minus1, ue );
+                }
+            }
+            if( pps->lists_modification_present_flag && h265_num_pic_total_curr(h) > 1 )
+            {
+                structure(h265_ref_pic_lists_modification)(h, b);
+            }
+            if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+            {
+                value( sh->mvd_l1_zero_flag, u1 );
+            }
+            if( pps->cabac_init_present_flag )
+            {
+                value( sh->cabac_init_flag, u1 );
+            }
+            if( sh->slice_temporal_mvp_enabled_flag )
+            {
+                if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+                {
+                    value( sh->collocated_from_l0_flag, u1 );
+                }
+                if( ( sh->collocated_from_l0_flag && sh->num_ref_idx_l0_active_minus1 > 0 ) ||
+                    ( !sh->collocated_from_l0_flag && sh->num_ref_idx_l1_active_minus1 > 0 ) )
+                {
+                    value( sh->collocated_ref_idx, ue );
+                }
+            }
+            if( ( pps->weighted_pred_flag && sh->slice_type == H265_SH_SLICE_TYPE_P ) ||
+                ( pps->weighted_bipred_flag && sh->slice_type == H265_SH_SLICE_TYPE_B ) )
+            {
+                structure(h265_pred_weight_table)(h, b);
+            }
+            value( sh->five_minus_max_num_merge_cand, ue );
+        }
+        value( sh->slice_qp_delta, se );
+        if( pps->pps_slice_chroma_qp_offsets_present_flag )
+        {
+            value( sh->slice_cb_qp_offset, se );
+            value( sh->slice_cr_qp_offset, se );
+        }
+        if( pps->chroma_qp_offset_list_enabled_flag )
+        {
+            value( sh->cu_chroma_qp_offset_enabled_flag, u1 );
+        }
+        if( pps->deblocking_filter_override_enabled_flag )
+        {
+            value( sh->deblocking_filter_override_flag, u1 );
+        }
+        if( sh->deblocking_filter_override_flag )
+        {
+            value( sh->slice_deblocking_filter_disabled_flag, u1 );
+            if( !sh->slice_deblocking_filter_disabled_flag )
+            {
+                value( sh->slice_beta_offset_div2, se );
+                value( sh->slice_tc_offset_div2, se );
+            }
+        }
+        if( pps->pps_loop_filter_across_slices_enabled_flag &&
+            ( sh->slice_sao_luma_flag || sh->slice_sao_chroma_flag || !sh->slice_deblocking_filter_disabled_flag ) )
+        {
+            value( sh->slice_loop_filter_across_slices_enabled_flag, u1 );
+        }
+    }
+
+    if( is_reading )
+    {
+        sh->num_entry_point_offsets = 0;
+        sh->slice_segment_header_extension_length = 0;
+    }
+    if( pps->tiles_enabled_flag || pps->entropy_coding_sync_enabled_flag )
+    {
+        value( sh->num_entry_point_offsets, ue );
+        if( sh->num_entry_point_offsets > 0 )
+        {
+            value( sh->offset_len_minus1, ue );
+            for( i = 0; i < sh->num_entry_point_offsets && i < H265_MAX_ENTRY_POINTS; i++ )
+            {
+                value( sh->entry_point_offset_minus1[ i ], u( sh->offset_len_minus1 + 1 ) );
+            }
+            // the offsets past H265_MAX_ENTRY_POINTS are not kept: stepped over when reading, written as 0
+            for( ; i < sh->num_entry_point_offsets && !bs_eof(b); i++ )
+            {
+                if( is_reading ) { bs_skip_u(b, sh->offset_len_minus1 + 1); }
+                if( is_writing ) { bs_write_u(b, sh->offset_len_minus1 + 1, 0); }
+            }
+        }
+    }
+    if( pps->slice_segment_header_extension_present_flag )
+    {
+        value( sh->slice_segment_header_extension_length, ue );
+        for( i = 0; i < sh->slice_segment_header_extension_length && i < 256; i++ )
+        {
+            value( sh->slice_segment_header_extension_data_byte[ i ], u8 );
+        }
+        for( ; i < sh->slice_segment_header_extension_length && !bs_eof(b); i++ )
+        {
+            if( is_reading ) { bs_skip_u(b, 8); }
+            if( is_writing ) { bs_write_u(b, 8, 0); }
+        }
+    }
+    structure(h265_byte_alignment)(b);
+}
+
+//7.3.6.2 Reference picture list modification syntax
+void structure(h265_ref_pic_lists_modification)(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    int n = intlog2( h265_num_pic_total_curr(h) );
+    int i;
+
+    value( sh->rplm.ref_pic_list_modification_flag_l0, u1 );
+    if( sh->rplm.ref_pic_list_modification_flag_l0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            value( sh->rplm.list_entry_l0[ i ], u( n ) );
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        value( sh->rplm.ref_pic_list_modification_flag_l1, u1 );
+        if( sh->rplm.ref_pic_list_modification_flag_l1 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                value( sh->rplm.list_entry_l1[ i ], u( n ) );
+            }
+        }
+    }
+}
+
+//7.3.6.3 Weighted prediction parameters syntax
+// luma_weight_lX_flag and chroma_weight_lX_flag are read for every reference picture: a reference can only have the
+// POC of the current picture with the screen content extension, which is not read
+void structure(h265_pred_weight_table)(h265_stream_t* h, bs_t* b)
+{
+    h265_slice_header_t* sh = h->sh;
+    h265_sps_t* sps = h->sps;
+    int ChromaArrayType = sps->separate_colour_plane_flag ? 0 : sps->chroma_format_idc;
+    int i, j;
+
+    value( sh->pwt.luma_log2_weight_denom, ue );
+    if( ChromaArrayType != 0 )
+    {
+        value( sh->pwt.delta_chroma_log2_weight_denom, se );
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        value( sh->pwt.luma_weight_l0_flag[ i ], u1 );
+    }
+    if( ChromaArrayType != 0 )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            value( sh->pwt.chroma_weight_l0_flag[ i ], u1 );
+        }
+    }
+    for( i = 0; i <= sh->num_ref_idx_l0_active_minus1 && i < H265_MAX_REFS; i++ )
+    {
+        if( sh->pwt.luma_weight_l0_flag[ i ] )
+        {
+            value( sh->pwt.delta_luma_weight_l0[ i ], se );
+            value( sh->pwt.luma_offset_l0[ i ], se );
+        }
+        if( sh->pwt.chroma_weight_l0_flag[ i ] )
+        {
+            for( j = 0; j < 2; j++ )
+            {
+                value( sh->pwt.delta_chroma_weight_l0[ i ][ j ], se );
+                value( sh->pwt.delta_chroma_offset_l0[ i ][ j ], se );
+            }
+        }
+    }
+    if( sh->slice_type == H265_SH_SLICE_TYPE_B )
+    {
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            value( sh->pwt.luma_weight_l1_flag[ i ], u1 );
+        }
+        if( ChromaArrayType != 0 )
+        {
+            for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+            {
+                value( sh->pwt.chroma_weight_l1_flag[ i ], u1 );
+            }
+        }
+        for( i = 0; i <= sh->num_ref_idx_l1_active_minus1 && i < H265_MAX_REFS; i++ )
+        {
+            if( sh->pwt.luma_weight_l1_flag[ i ] )
+            {
+                value( sh->pwt.delta_luma_weight_l1[ i ], se );
+                value( sh->pwt.luma_offset_l1[ i ], se );
+            }
+            if( sh->pwt.chroma_weight_l1_flag[ i ] )
+            {
+                for( j = 0; j < 2; j++ )
+                {
+                    value( sh->pwt.delta_chroma_weight_l1[ i ][ j ], se );
+                    value( sh->pwt.delta_chroma_offset_l1[ i ][ j ], se );
+                }
+            }
+        }
+    }
+}
+
+//7.3.2.11 RBSP trailing bits syntax
+void structure(h265_rbsp_trailing_bits)(bs_t* b)
+{
+    value( rbsp_stop_one_bit, f(1, 1) );
+
+    while( !bs_byte_aligned(b) )
+    {
+        value( rbsp_alignment_zero_bit, f(1, 0) );
+    }
+}
+
+//7.3.2.12 Byte alignment syntax
+void structure(h265_byte_alignment)(bs_t* b)
+{
+    value( alignment_bit_equal_to_one, f(1, 1) );
+
+    while( !bs_byte_aligned(b) )
+    {
+        value( alignment_bit_equal_to_zero, f(1, 0) );
+    }
+}
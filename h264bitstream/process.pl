@@ -38,11 +38,43 @@ print $preamble;
 
 $code =~ s{#function_declarations}{$decl};
 
+# the table of names of the values read_debug_* output, if the source says where
+$names_table = '';
+if ($code =~ s{\#debug_names \s+ (\w+) [^\n]* \n}{}x) { $names_table = $1; }
+@names = ();
+%name_ids = ();
+
+# groups of values the skip_* functions store when asked to, by structure, if the source lists any
+%extract_groups = ();
+while ($code =~ s{\#extract \s+ (\w+) ([^\n]*) \n}{}x)
+{
+    my $group = $1;
+    foreach my $s (split(' ', $2)) { $extract_groups{$s} = $group; }
+}
+
+# values that the code looks at other than to read or write them, which skip_* must always store
+%kept = ();
+if (%extract_groups)
+{
+    my $rest = $code;
+    $rest =~ s{^ \s* value \s* \( \s* [^,]* , ([^\n]*) $}{$1}xmg;
+    $rest = &base_name($rest);
+    while ($code =~ m{^ \s* value \s* \( \s* ([^,]*) ,}xmg)
+    {
+        my $s = $1;
+        my $base = &base_name($s);
+        $kept{$s} = 1 if ($rest =~ m{(?<!\w)\Q$base\E(?!\w)});
+    }
+}
+
 $code_read = $code;
 $code_read =~ s{^(\s*) value \s* \( \s* ([^,]*) , (.*) \);}{ &proc_value_read($2, $3, $1) }exmg;
 $code_read =~ s{structure\( (\w+) \)}{read_$1}xg;
 $code_read =~ s{is_reading}{1}g;
 $code_read =~ s{is_writing}{0}g;
+$code_read =~ s{is_debugging}{0}g;
+$code_read =~ s{is_skipping}{0}g;
+$code_read =~ s{extracted}{H264_EXTRACT_ALL}g;
 print $code_read;
 
 $code_write = $code;
@@ -50,6 +82,9 @@ $code_write =~ s{^(\s*) value \s* \( \s* ([^,]*) , (.*) \);}{ &proc_value_write(
 $code_write =~ s{structure\( (\w+) \)}{write_$1}xg;
 $code_write =~ s{is_reading}{0}g;
 $code_write =~ s{is_writing}{1}g;
+$code_write =~ s{is_debugging}{0}g;
+$code_write =~ s{is_skipping}{0}g;
+$code_write =~ s{extracted}{H264_EXTRACT_ALL}g;
 print $code_write;
 
 $code_read_debug = $code;
@@ -57,8 +92,48 @@ $code_read_debug =~ s{^(\s*) value \s* \( \s* ([^,]*) , (.*) \);}{ &proc_value_r
 $code_read_debug =~ s{structure\( (\w+) \)}{read_debug_$1}xg;
 $code_read_debug =~ s{is_reading}{1}g;
 $code_read_debug =~ s{is_writing}{0}g;
+$code_read_debug =~ s{is_debugging}{1}g;
+$code_read_debug =~ s{is_skipping}{0}g;
+$code_read_debug =~ s{extracted}{H264_EXTRACT_ALL}g;
 print $code_read_debug;
 
+if (%extract_groups)
+{
+    my @lines = split(/\n/, $code, -1);
+    my $group;
+    foreach my $line (@lines)
+    {
+        if ($line =~ m{^ \w+ [\w\s\*]* structure\( (\w+) \)}x) { $group = $extract_groups{$1}; }
+        $line =~ s{^(\s*) value \s* \( \s* ([^,]*) , (.*) \);}{ &proc_value_skip($2, $3, $1, $group) }ex;
+    }
+    $code_skip = join("\n", @lines);
+    # extract goes after the first argument, as in skip_nal_unit(h, extract, buf, size)
+    $code_skip =~ s{^(\w+ [\w\ \t\*]*?) structure\( (\w+) \) \( \s* ([^,()]*?) \s* ([,)])}{$1skip_$2($3, int extract$4}xmg;
+    $code_skip =~ s{structure\( (\w+) \) \( \s* ([^,()]*?) \s* ([,)])}{skip_$1($2, extract$3}xg;
+    $code_skip =~ s{is_reading}{1}g;
+    $code_skip =~ s{is_writing}{0}g;
+    $code_skip =~ s{is_debugging}{0}g;
+    $code_skip =~ s{is_skipping}{1}g;
+    $code_skip =~ s{extracted}{extract}g;
+    print $code_skip;
+}
+
+if ($names_table ne '')
+{
+    print "\nconst h264_debug_name_t ${names_table}[] =\n{\n";
+    foreach $name (@names) { printf("    { 0x%08X, \"%s\" },\n", $name_ids{$name}, $name); }
+    print "    { 0, NULL }\n};\n";
+}
+
+# 32-bit FNV-1a of a value's name, its id in the binary debug output
+sub name_id
+{
+    my ($name) = @_;
+    my $h = 0x811c9dc5;
+    foreach my $c (unpack("C*", $name)) { $h = (($h ^ $c) * 0x01000193) & 0xffffffff; }
+    return $h;
+}
+
 sub proc_value_read
 {
     my ($s, $values, $indent) = @_;
@@ -80,6 +155,38 @@ sub proc_value_read
     return $indent . $code;
 }
 
+# a value's name with the array indexes and the spaces around -> and . taken out
+sub base_name
+{
+    my ($s) = @_;
+    1 while ($s =~ s{\s* \[ [^\[\]]* \]}{}xg);
+    $s =~ s{\s* (->|\.) \s*}{$1}xg;
+    $s =~ s{^\s+|\s+$}{}g;
+    return $s;
+}
+
+sub proc_value_skip
+{
+    my ($s, $values, $indent, $group) = @_;
+    $values =~ s{^\s*}{};
+    $values =~ s{\s*$}{};
+
+    my $code;
+    if ($values =~ m{u\((.*)\)}) { $code = "bs_skip_u(b, $1);"; }
+    elsif ($values =~ m{(u1)}) { $code = "bs_skip_u1(b);"; }
+    elsif ($values =~ m{(u8)}) { $code = "bs_skip_u(b, 8);"; }
+    elsif ($values =~ m{^(ue|se)$}) { $code = "bs_skip_ue(b);"; }
+
+    # values in structures without a group, values the code looks at, and anything not simply skipped are read
+    if (!defined($group) || $kept{$s} || !defined($code) || $values =~ m{f\(})
+    {
+        return &proc_value_read($s, $values, $indent);
+    }
+
+    my $read = &proc_value_read($s, $values, '');
+    return $indent . "if (extract & $group) { $read } else { $code }";
+}
+
 sub proc_value_read_debug
 {
     my ($s, $values, $indent) = @_;
@@ -98,9 +205,19 @@ sub proc_value_read_debug
         $code = "if (cabac) { $s = bs_read_ae(b); }" . "\n${indent}" . "else { $code }";
     }
 
-    $code = "printf(\"\%d.\%d: \", b->p - b->start, b->bits_left); ".
+    if ($code =~ m{^// ERROR}) { return $indent . $code; }
+
+    if (!exists $name_ids{$s})
+    {
+        $name_ids{$s} = &name_id($s);
+        foreach my $other (@names) { die "debug name ids of $other and $s are the same\n" if ($name_ids{$other} == $name_ids{$s}); }
+        push @names, $s;
+    }
+    my $id = sprintf("0x%08Xu", $name_ids{$s});
+
+    $code = "{ long _pos = (long int)(b->p - b->start - b->epb_count); int _bits_left = b->bits_left; ".
         $code .
-        " printf(\"$s: \%d \\n\", $s); ";
+        " h264_debug_value(_pos, _bits_left, $id, \"$s\", $s); }";
 
     return $indent . $code;
 }
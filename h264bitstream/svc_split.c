@@ -6,9 +6,12 @@
 //  Copyright © 2016 qiwa. All rights reserved.
 //
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
 
 #include "h264_stream.h"
+#include "h264_nal_reader.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -20,9 +23,8 @@
 
 int main(int argc, char *argv[])
 {
-    uint8_t* buf = (uint8_t*)malloc( BUFSIZE );
-    
     h264_stream_t* h = h264_new();
+    h->parse_depth = H264_PARSE_HEADERS;
     
     FILE* infile = fopen(argv[1], "rb");
     if (infile == NULL) { fprintf( stderr, "!! Error: could not open file: %s \n", strerror(errno)); exit(EXIT_FAILURE); }
@@ -46,140 +48,118 @@ int main(int argc, char *argv[])
 
     if (h264_dbgfile == NULL) { h264_dbgfile = stdout; }
     
-    size_t rsz = 0;
-    size_t sz = 0;
-    int64_t off = 0;
-    uint8_t* p = buf;
-    
-    int nal_start, nal_end;
+    nal_reader_t* reader = nal_reader_new_fd(fileno(infile), BUFSIZE);
+    if (reader == NULL) { fprintf( stderr, "!! Error: could not allocate the read buffer \n"); exit(EXIT_FAILURE); }
+
+    nal_view_t nal;
+    int rc, i;
     
     //this is to identify whether pps is written or not
     char *pps_buf[32];
     int pps_buf_size[32];
     
-    while (1)
+    while ((rc = nal_reader_next(reader, &nal)) != NAL_READER_END)
     {
-        rsz = fread(buf + sz, 1, BUFSIZE - sz, infile);
-        if (rsz == 0)
+        if (rc == NAL_READER_ERROR) { fprintf( stderr, "!! Error: read failed: %s \n", strerror(errno)); break; }
+
+        if (rc == NAL_READER_DISCARDED)
         {
-            if (ferror(infile)) { fprintf( stderr, "!! Error: read failed: %s \n", strerror(errno)); break; }
-            break;  // if (feof(infile))
+            fprintf( stderr, "!! Did not find any NALs between offset %lld (0x%04llX), size %lld (0x%04llX), discarding \n",
+                    (long long int)nal.offset,
+                    (long long int)nal.offset,
+                    (long long int)nal.offset + nal.size,
+                    (long long int)nal.offset + nal.size);
+            continue;
         }
-        
-        sz += rsz;
-        
-        while (find_nal_unit(p, sz, &nal_start, &nal_end) > 0)
+
+        fprintf( h264_dbgfile, "!! Found NAL at offset %lld (0x%04llX), size %lld (0x%04llX) \n",
+                    (long long int)nal.offset,
+                    (long long int)nal.offset,
+                    (long long int)nal.size,
+                    (long long int)nal.size );
+    
+        fprintf( h264_dbgfile, "XX ");
+        debug_bytes(nal.data - nal.prefix_size, nal.size >= 16 ? 16: nal.size);
+    
+        read_debug_nal_unit(h, nal.data, nal.size);
+    
+        //check nal type
+        switch (h->nal->nal_unit_type)
         {
-            fprintf( h264_dbgfile, "!! Found NAL at offset %lld (0x%04llX), size %lld (0x%04llX) \n",
-                        (long long int)(off + (p - buf) + nal_start),
-                        (long long int)(off + (p - buf) + nal_start),
-                        (long long int)(nal_end - nal_start),
-                        (long long int)(nal_end - nal_start) );
+            case NAL_UNIT_TYPE_CODED_SLICE_IDR:
+            case NAL_UNIT_TYPE_CODED_SLICE_NON_IDR:
+            case NAL_UNIT_TYPE_CODED_SLICE_AUX:
+                if (h264_pps_slot(h, h->sh->pic_parameter_set_id) == NULL) { break; }
+                printf("reference pps: %d & sps: %d\n", h->sh->pic_parameter_set_id,
+                       h264_pps_slot(h, h->sh->pic_parameter_set_id)->seq_parameter_set_id);
             
-            fprintf( h264_dbgfile, "XX ");
-            debug_bytes(p, nal_end - nal_start >= 16 ? 16: nal_end - nal_start);
+                if (pps_buf[h->sh->pic_parameter_set_id] != NULL)
+                {
+                    fwrite(pps_buf[h->sh->pic_parameter_set_id], 1, pps_buf_size[h->sh->pic_parameter_set_id], outfile_base);
+                    free(pps_buf[h->sh->pic_parameter_set_id]);
+                    pps_buf[h->sh->pic_parameter_set_id] = NULL;
+                }
             
-            p += nal_start;
-            read_debug_nal_unit(h, p, nal_end - nal_start);
+                //start saving the slices
+                fwrite(nal.data - nal.prefix_size, 1, nal.prefix_size + nal.size, outfile_base);
             
-            //check nal type
-            switch (h->nal->nal_unit_type)
-            {
-                case NAL_UNIT_TYPE_CODED_SLICE_IDR:
-                case NAL_UNIT_TYPE_CODED_SLICE_NON_IDR:
-                case NAL_UNIT_TYPE_CODED_SLICE_AUX:
-                    printf("reference pps: %d & sps: %d\n", h->sh->pic_parameter_set_id,
-                           h->pps_table[h->sh->pic_parameter_set_id]->seq_parameter_set_id);
-                    
-                    if (pps_buf[h->sh->pic_parameter_set_id] != NULL)
-                    {
-                        fwrite(pps_buf[h->sh->pic_parameter_set_id], 1, pps_buf_size[h->sh->pic_parameter_set_id], outfile_base);
-                        free(pps_buf[h->sh->pic_parameter_set_id]);
-                        pps_buf[h->sh->pic_parameter_set_id] = NULL;
-                    }
-                    
-                    //start saving the slices
-                    fwrite(p - nal_start, 1, nal_end, outfile_base);
-                    
-                    break;
-                    
-                case NAL_UNIT_TYPE_SPS:
-                    fwrite(p - nal_start, 1, nal_end, outfile_base);
-                    break;
-                    
-                case NAL_UNIT_TYPE_PPS:
-                    pps_buf[h->pps->pic_parameter_set_id] = malloc(nal_end);
-                    memcpy(pps_buf[h->pps->pic_parameter_set_id], p - nal_start, nal_end);
-                    pps_buf_size[h->pps->pic_parameter_set_id] = nal_end;
-                    
-                    break;
-                    
-                    //SVC support
-                case NAL_UNIT_TYPE_SUBSET_SPS:
-                    printf("sps_ext id: %d\n", h->sps_subset->sps->seq_parameter_set_id);
-                    memset(fname_buf, 0, 1024);
-                    sprintf(fname_buf, "%s.l_%d", argv[1], h->sps_subset->sps->seq_parameter_set_id);
-                    outfile_layers[h->sps_subset->sps->seq_parameter_set_id] = fopen(fname_buf, "wb");
-                    if (outfile_layers[h->sps_subset->sps->seq_parameter_set_id] == NULL) { fprintf( stderr, "!! Error: could not open file: %s \n", strerror(errno)); exit(EXIT_FAILURE); }
-                    
-                    fwrite(p - nal_start, 1, nal_end, outfile_layers[h->sps_subset->sps->seq_parameter_set_id]);
-                    break;
-                    
-                    //SVC support
-                case NAL_UNIT_TYPE_CODED_SLICE_SVC_EXTENSION:            
-                    printf("reference extension pps: %d & sps: %d\n", h->sh->pic_parameter_set_id,
-                           h->pps_table[h->sh->pic_parameter_set_id]->seq_parameter_set_id);
-                    
-                    if (pps_buf[h->sh->pic_parameter_set_id] != NULL)
-                    {
-                        fwrite(pps_buf[h->sh->pic_parameter_set_id], 1, pps_buf_size[h->sh->pic_parameter_set_id], outfile_layers[h->pps_table[h->sh->pic_parameter_set_id]->seq_parameter_set_id]);
-                        free(pps_buf[h->sh->pic_parameter_set_id]);
-                        pps_buf[h->sh->pic_parameter_set_id] = NULL;
-                    }
-                    
-                    //start saving the slices
-                    fwrite(p - nal_start, 1, nal_end, outfile_layers[h->pps_table[h->sh->pic_parameter_set_id]->seq_parameter_set_id]);
-                    break;
-                    
-                default:
-                    fwrite(p - nal_start, 1, nal_end, outfile_misc);
-                    break;
-            }
+                break;
             
-            //save nal to corresponding file
+            case NAL_UNIT_TYPE_SPS:
+                fwrite(nal.data - nal.prefix_size, 1, nal.prefix_size + nal.size, outfile_base);
+                break;
             
-            //skip to next NAL
-            p += (nal_end - nal_start);
-            sz -= nal_end;
+            case NAL_UNIT_TYPE_PPS:
+                pps_buf[h->pps->pic_parameter_set_id] = malloc(nal.prefix_size + nal.size);
+                memcpy(pps_buf[h->pps->pic_parameter_set_id], nal.data - nal.prefix_size, nal.prefix_size + nal.size);
+                pps_buf_size[h->pps->pic_parameter_set_id] = nal.prefix_size + nal.size;
             
-        }
-        
-        // if no NALs found in buffer, discard it
-        if (p == buf)
-        {
-            fprintf( stderr, "!! Did not find any NALs between offset %lld (0x%04llX), size %lld (0x%04llX), discarding \n",
-                    (long long int)off,
-                    (long long int)off,
-                    (long long int)off + sz,
-                    (long long int)off + sz);
+                break;
+            
+                //SVC support
+            case NAL_UNIT_TYPE_SUBSET_SPS:
+                printf("sps_ext id: %d\n", h->sps_subset->sps->seq_parameter_set_id);
+                memset(fname_buf, 0, 1024);
+                sprintf(fname_buf, "%s.l_%d", argv[1], h->sps_subset->sps->seq_parameter_set_id);
+                outfile_layers[h->sps_subset->sps->seq_parameter_set_id] = fopen(fname_buf, "wb");
+                if (outfile_layers[h->sps_subset->sps->seq_parameter_set_id] == NULL) { fprintf( stderr, "!! Error: could not open file: %s \n", strerror(errno)); exit(EXIT_FAILURE); }
+            
+                fwrite(nal.data - nal.prefix_size, 1, nal.prefix_size + nal.size, outfile_layers[h->sps_subset->sps->seq_parameter_set_id]);
+                break;
             
-            p = buf + sz;
-            sz = 0;
+                //SVC support
+            case NAL_UNIT_TYPE_CODED_SLICE_SVC_EXTENSION:            
+                if (h264_pps_slot(h, h->sh->pic_parameter_set_id) == NULL) { break; }
+                printf("reference extension pps: %d & sps: %d\n", h->sh->pic_parameter_set_id,
+                       h264_pps_slot(h, h->sh->pic_parameter_set_id)->seq_parameter_set_id);
+            
+                if (pps_buf[h->sh->pic_parameter_set_id] != NULL)
+                {
+                    fwrite(pps_buf[h->sh->pic_parameter_set_id], 1, pps_buf_size[h->sh->pic_parameter_set_id], outfile_layers[h264_pps_slot(h, h->sh->pic_parameter_set_id)->seq_parameter_set_id]);
+                    free(pps_buf[h->sh->pic_parameter_set_id]);
+                    pps_buf[h->sh->pic_parameter_set_id] = NULL;
+                }
+            
+                //start saving the slices
+                fwrite(nal.data - nal.prefix_size, 1, nal.prefix_size + nal.size, outfile_layers[h264_pps_slot(h, h->sh->pic_parameter_set_id)->seq_parameter_set_id]);
+                break;
+            
+            default:
+                fwrite(nal.data - nal.prefix_size, 1, nal.prefix_size + nal.size, outfile_misc);
+                break;
         }
-        
-        memmove(buf, p, sz);
-        off += p - buf;
-        p = buf;
+    
+        //save nal to corresponding file
     }
     
+    nal_reader_free(reader);
     h264_free(h);
-    free(buf);
     
     fclose(h264_dbgfile);
     fclose(infile);
     fclose(outfile_base);
     fclose(outfile_misc);
-    for(int i = 0; i < 32; i++) {
+    for(i = 0; i < 32; i++) {
         if (outfile_layers[i] != NULL)
             fclose(outfile_layers[i]);
     }
@@ -0,0 +1,343 @@
+/*
+ * Checks for the NTP timestamp SEI writer, reader and latency stats, run by ctest.
+ * Prints a line for each mismatch and exits with a failure if there was any.
+ */
+#include "h264_sei_ntp.h"
+#include "h264_sei_ntp_stats.h"
+#include "h264bitstream/h264_stream.h"
+#include "h264bitstream/h265_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAL_SIZE 1024
+
+/* timestamps whose bytes need escaping, and the extremes */
+static const uint64_t timestamps[] = {
+  0, 1, 0x300, 0x30000, 0x0000000300000000ULL, 0x0000010000000000ULL, 0x0100000000000000ULL,
+  1700000000000ULL, 1760000000123456789ULL, 0xFFFFFFFFFFFFFFFFULL
+};
+#define TIMESTAMPS (sizeof(timestamps) / sizeof(timestamps[0]))
+
+static uint32_t rnd_state = 12345;
+
+static uint32_t rnd() {
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 8;
+}
+
+/* the i-th timestamp to try: the fixed ones, then random ones with and without zero bytes */
+static uint64_t timestamp_at(int i) {
+  if(i < (int)TIMESTAMPS) {
+    return timestamps[i];
+  }
+  uint64_t t = ((uint64_t)rnd() << 40) ^ ((uint64_t)rnd() << 20) ^ rnd();
+  return (i % 2) ? t & 0xFF00FF0000FF00FFULL : t;
+}
+
+/* NTP timestamp payload of a version: uuid, the version byte for ns stamps, and the timestamp little endian */
+static int make_payload(uint8_t *payload, int version, uint64_t timestamp) {
+  uint8_t sei_uuid[] = H264_SEI_UUID_NTP_TIMESTAMP;
+  int n = 0;
+
+  memcpy(payload, sei_uuid, sizeof(sei_uuid));
+  n += sizeof(sei_uuid);
+  if(version == H264_SEI_NTP_VERSION_NS) {
+    payload[n++] = H264_SEI_NTP_VERSION_NS;
+  }
+  for(int i = 0; i < 8; i++) {
+    payload[n++] = (uint8_t)(timestamp >> (8 * i));
+  }
+  return n;
+}
+
+/* an SEI NAL with these messages, written by h264bitstream; H.265 if is_h265 */
+static int write_sei(uint8_t *buf, int is_h265, sei_t **messages, int count) {
+  int n;
+
+  if(is_h265) {
+    h265_stream_t *h = h265_new();
+    h->nal->nal_unit_type = H265_NAL_UNIT_TYPE_PREFIX_SEI;
+    h->nal->nuh_layer_id = 0;
+    h->nal->nuh_temporal_id_plus1 = 1;
+    h->seis = messages;
+    h->num_seis = count;
+    n = write_h265_nal_unit(h, buf, NAL_SIZE);
+    h->seis = NULL;
+    h->num_seis = 0;
+    h265_free(h);
+  } else {
+    h264_stream_t *h = h264_new();
+    h->nal->nal_ref_idc = NAL_REF_IDC_PRIORITY_DISPOSABLE;
+    h->nal->nal_unit_type = NAL_UNIT_TYPE_SEI;
+    h->seis = messages;
+    h->num_seis = count;
+    n = write_nal_unit(h, buf, NAL_SIZE);
+    h->seis = NULL;
+    h->num_seis = 0;
+    h264_free(h);
+  }
+  return n;
+}
+
+static sei_t *new_message(int payload_type, uint8_t *data, int size) {
+  sei_t *s = sei_new();
+  s->payloadType = payload_type;
+  s->payloadSize = size;
+  s->data = data;
+  return s;
+}
+
+/* data is the caller's */
+static void free_message(sei_t *s) {
+  s->data = NULL;
+  sei_free(s);
+}
+
+static size_t write_stamp_into(int is_h265, int version, uint8_t *buf, size_t size, uint64_t timestamp) {
+  if(is_h265) {
+    return (version == H264_SEI_NTP_VERSION_NS) ? h265_sei_ntp_write_ns(buf, size, timestamp)
+                                                : h265_sei_ntp_write(buf, size, timestamp);
+  }
+  return (version == H264_SEI_NTP_VERSION_NS) ? h264_sei_ntp_write_ns(buf, size, timestamp)
+                                              : h264_sei_ntp_write(buf, size, timestamp);
+}
+
+static size_t write_stamp(int is_h265, int version, uint8_t *buf, uint64_t timestamp) {
+  return write_stamp_into(is_h265, version, buf, NAL_SIZE, timestamp);
+}
+
+static bool find_stamp(int is_h265, const uint8_t *nal, size_t length, uint64_t *timestamp_ns, int *version) {
+  return is_h265 ? h265_sei_ntp_find_ns(nal, length, timestamp_ns, version)
+                 : h264_sei_ntp_find_ns(nal, length, timestamp_ns, version);
+}
+
+static h264_sei_ntp_status_t check_stamp(int is_h265, const uint8_t *nal, size_t length) {
+  int64_t delay_ns;
+  return is_h265 ? h265_sei_ntp_check(nal, length, &delay_ns) : h264_sei_ntp_check(nal, length, &delay_ns);
+}
+
+/* written from the template, byte for byte what write_nal_unit writes, and read back */
+static int check_round_trip(int is_h265, int version) {
+  const char *codec = is_h265 ? "H.265" : "H.264";
+  uint8_t payload[32];
+  uint8_t stamp[NAL_SIZE];
+  uint8_t nal[NAL_SIZE];
+  int errors = 0;
+
+  for(int i = 0; i < 10000; i++) {
+    uint64_t timestamp = timestamp_at(i);
+    uint64_t found;
+    int found_version;
+
+    size_t n = write_stamp(is_h265, version, stamp, timestamp);
+    if(n == 0 || n > H264_SEI_NTP_MAX_SIZE) {
+      errors++;
+      continue;
+    }
+
+    sei_t *message = new_message(SEI_TYPE_USER_DATA_UNREGISTERED, payload, make_payload(payload, version, timestamp));
+    int size = write_sei(nal, is_h265, &message, 1);
+    free_message(message);
+    if(size != (int)n || memcmp(nal, stamp, n) != 0) {
+      if(errors++ < 5) { fprintf(stderr, "!! %s v%d stamp %llx differs from write_nal_unit\n", codec, version, (unsigned long long)timestamp); }
+    }
+
+    uint64_t expected = (version == H264_SEI_NTP_VERSION_MS) ? timestamp * 1000000 : timestamp;
+    if(!find_stamp(is_h265, stamp, n, &found, &found_version) || found != expected || found_version != version) {
+      if(errors++ < 5) { fprintf(stderr, "!! %s v%d stamp %llx read back wrong\n", codec, version, (unsigned long long)timestamp); }
+    }
+    if(!is_h265 && version == H264_SEI_NTP_VERSION_MS &&
+       (!h264_sei_ntp_find(stamp, n, &found) || found != timestamp)) {
+      if(errors++ < 5) { fprintf(stderr, "!! H.264 stamp %llx read back wrong in ms\n", (unsigned long long)timestamp); }
+    }
+  }
+
+  /* too small a buffer is refused, H264_SEI_NTP_MAX_SIZE always does */
+  if(write_stamp_into(is_h265, version, stamp, 8, 1) != 0 ||
+     write_stamp_into(is_h265, version, stamp, H264_SEI_NTP_MAX_SIZE, 0x0000000300000000ULL) == 0) {
+    errors++;
+    fprintf(stderr, "!! %s v%d buffer size not checked\n", codec, version);
+  }
+  return errors;
+}
+
+/* the stamp among other messages: first, which the template matches, and between or after them, which it does not */
+static int check_among_messages(int is_h265) {
+  const char *codec = is_h265 ? "H.265" : "H.264";
+  uint8_t other_uuid[300];
+  uint8_t t35[3] = { 0x00, 0x00, 0x01 };
+  uint8_t payload[32];
+  uint8_t nal[NAL_SIZE];
+  int errors = 0;
+
+  /* another user_data_unregistered message, longer than 255 bytes so its size is ff_byte coded */
+  for(int i = 0; i < (int)sizeof(other_uuid); i++) {
+    other_uuid[i] = (uint8_t)(i * 7);
+  }
+
+  for(int version = 0; version < 2; version++) {
+    for(int position = 0; position < 3; position++) {
+      uint64_t timestamp = 0x0000000300000001ULL;
+      uint64_t found;
+      int found_version;
+      sei_t *messages[3];
+      int k = 0;
+
+      sei_t *stamp = new_message(SEI_TYPE_USER_DATA_UNREGISTERED, payload, make_payload(payload, version, timestamp));
+      if(position == 0) { messages[k++] = stamp; }
+      messages[k++] = new_message(SEI_TYPE_USER_DATA_UNREGISTERED, other_uuid, sizeof(other_uuid));
+      if(position == 1) { messages[k++] = stamp; }
+      messages[k++] = new_message(SEI_TYPE_USER_DATA_REGISTERED_ITU_T_T35, t35, sizeof(t35));
+      if(position == 2) { messages[k++] = stamp; }
+
+      int size = write_sei(nal, is_h265, messages, k);
+      for(int i = 0; i < k; i++) { free_message(messages[i]); }
+
+      uint64_t expected = (version == H264_SEI_NTP_VERSION_MS) ? timestamp * 1000000 : timestamp;
+      if(!find_stamp(is_h265, nal, size, &found, &found_version) || found != expected || found_version != version) {
+        errors++;
+        fprintf(stderr, "!! %s v%d stamp as message %d of 3 not found\n", codec, version, position + 1);
+      }
+
+      /* cut short anywhere, it is never read past the end, and as the last message it is not found until whole */
+      for(int n = 0; n < size; n++) {
+        h264_sei_ntp_status_t status = check_stamp(is_h265, nal, n);
+        if(status == H264_SEI_NTP_OK && position == 2 && n < size - 1) {
+          errors++;
+          fprintf(stderr, "!! %s v%d stamp as message %d found in the first %d of %d bytes\n", codec, version,
+                  position + 1, n, size);
+        }
+      }
+    }
+  }
+
+  /* another UUID */
+  uint64_t found;
+  int found_version;
+  make_payload(payload, H264_SEI_NTP_VERSION_MS, 1);
+  payload[15] ^= 0xFF;
+  sei_t *message = new_message(SEI_TYPE_USER_DATA_UNREGISTERED, payload, 24);
+  int size = write_sei(nal, is_h265, &message, 1);
+  free_message(message);
+  if(find_stamp(is_h265, nal, size, &found, &found_version)) {
+    errors++;
+    fprintf(stderr, "!! %s stamp with another UUID found\n", codec);
+  }
+  return errors;
+}
+
+/* what h264_sei_ntp_check tells apart */
+static int check_status(int is_h265) {
+  const char *codec = is_h265 ? "H.265" : "H.264";
+  uint8_t payload[32];
+  uint8_t nal[NAL_SIZE];
+  int64_t delay_ns;
+  int errors = 0;
+
+  /* a stamp taken now is in the past by the time it is checked */
+  size_t n = write_stamp(is_h265, H264_SEI_NTP_VERSION_NS, nal, h264_sei_ntp_now_ns());
+  if(check_stamp(is_h265, nal, n) != H264_SEI_NTP_OK) { errors++; }
+  if((is_h265 ? h265_sei_ntp_parse_ns(nal, n, &delay_ns) : h264_sei_ntp_parse_ns(nal, n, &delay_ns)) &&
+     (delay_ns < 0 || delay_ns > 1000000000)) { errors++; }
+
+  n = write_stamp(is_h265, H264_SEI_NTP_VERSION_NS, nal, h264_sei_ntp_now_ns() + 60000000000ULL);
+  if(check_stamp(is_h265, nal, n) != H264_SEI_NTP_FUTURE) { errors++; }
+
+  /* another UUID */
+  make_payload(payload, H264_SEI_NTP_VERSION_MS, 1);
+  payload[15] ^= 0xFF;
+  sei_t *message = new_message(SEI_TYPE_USER_DATA_UNREGISTERED, payload, 24);
+  n = write_sei(nal, is_h265, &message, 1);
+  if(check_stamp(is_h265, nal, n) != H264_SEI_NTP_NO_TIMESTAMP) { errors++; }
+
+  /* our UUID with a payload version from a newer writer */
+  make_payload(payload, H264_SEI_NTP_VERSION_NS, 1);
+  payload[16] = 7;
+  message->payloadSize = 25;
+  n = write_sei(nal, is_h265, &message, 1);
+  free_message(message);
+  if(check_stamp(is_h265, nal, n) != H264_SEI_NTP_UNKNOWN_VERSION) { errors++; }
+
+  /* a stamp cut in the timestamp */
+  n = write_stamp(is_h265, H264_SEI_NTP_VERSION_MS, nal, 1700000000000ULL);
+  if(check_stamp(is_h265, nal, n - 4) != H264_SEI_NTP_TRUNCATED) { errors++; }
+
+  /* not an SEI: an AUD */
+  nal[0] = is_h265 ? (H265_NAL_UNIT_TYPE_AUD << 1) : NAL_UNIT_TYPE_AUD;
+  if(check_stamp(is_h265, nal, n) != H264_SEI_NTP_NOT_SEI) { errors++; }
+
+  if(errors > 0) { fprintf(stderr, "!! %s h264_sei_ntp_check status wrong\n", codec); }
+  return errors;
+}
+
+/* percentile within the bucket error of the true value */
+static int near(uint64_t value, uint64_t expected) {
+  uint64_t tolerance = expected / 32 + 1;
+  return value + tolerance >= expected && value <= expected + tolerance;
+}
+
+static int check_stats() {
+  h264_sei_ntp_stats_snapshot_t s;
+  int errors = 0;
+
+  if(h264_sei_ntp_stats_new(0, 1) != NULL || h264_sei_ntp_stats_new(1000, 0) != NULL) { errors++; }
+
+  /* one long window, so that all of it is in the current one: 1 to 1000 us, uniformly */
+  h264_sei_ntp_stats_t *stats = h264_sei_ntp_stats_new(3600000000000ULL, 4);
+  for(int i = 1; i <= 1000; i++) {
+    h264_sei_ntp_stats_record(stats, (int64_t)i * 1000);
+  }
+  h264_sei_ntp_stats_record(stats, -5);
+  h264_sei_ntp_stats_fail(stats, H264_SEI_NTP_TRUNCATED);
+  h264_sei_ntp_stats_fail(stats, H264_SEI_NTP_OK);
+  h264_sei_ntp_stats_snapshot(stats, 0, &s);
+
+  if(s.count != 1000 || s.status[H264_SEI_NTP_OK] != 1000) { errors++; }
+  if(s.status[H264_SEI_NTP_FUTURE] != 1 || s.status[H264_SEI_NTP_TRUNCATED] != 1) { errors++; }
+  if(s.span_ns != 4 * 3600000000000ULL) { errors++; }
+  if(s.max_ns != 1000000) { errors++; }
+  if(!near(s.p50_ns, 500000) || !near(s.p90_ns, 900000) || !near(s.p99_ns, 990000) || !near(s.p999_ns, 999000)) {
+    errors++;
+    fprintf(stderr, "!! percentiles %llu %llu %llu %llu\n", (unsigned long long)s.p50_ns,
+            (unsigned long long)s.p90_ns, (unsigned long long)s.p99_ns, (unsigned long long)s.p999_ns);
+  }
+  if(s.p50_ns > s.p90_ns || s.p90_ns > s.p99_ns || s.p99_ns > s.p999_ns || s.p999_ns > s.max_ns) { errors++; }
+
+  /* clamped to the largest delay kept */
+  h264_sei_ntp_stats_record(stats, INT64_MAX);
+  h264_sei_ntp_stats_snapshot(stats, 1, &s);
+  if(s.count != 1001 || s.max_ns < H264_SEI_NTP_STATS_MAX_NS || !near(s.p50_ns, 500000)) { errors++; }
+  h264_sei_ntp_stats_free(stats);
+
+  /* short windows: what was recorded falls out of the snapshot once its windows have passed */
+  stats = h264_sei_ntp_stats_new(1000000, 2);
+  h264_sei_ntp_stats_record(stats, 5000);
+  uint64_t until = h264_sei_ntp_now_ns() + 5000000;
+  while(h264_sei_ntp_now_ns() < until) {}
+  h264_sei_ntp_stats_snapshot(stats, 0, &s);
+  if(s.count != 0 || s.status[H264_SEI_NTP_OK] != 1) { errors++; }
+  h264_sei_ntp_stats_free(stats);
+
+  if(errors > 0) { fprintf(stderr, "!! latency stats wrong\n"); }
+  return errors;
+}
+
+int main() {
+  int errors = 0;
+
+  for(int is_h265 = 0; is_h265 < 2; is_h265++) {
+    errors += check_round_trip(is_h265, H264_SEI_NTP_VERSION_MS);
+    errors += check_round_trip(is_h265, H264_SEI_NTP_VERSION_NS);
+    errors += check_among_messages(is_h265);
+    errors += check_status(is_h265);
+  }
+  errors += check_stats();
+
+  if(errors > 0) {
+    fprintf(stderr, "!! %d SEI NTP checks failed\n", errors);
+    return EXIT_FAILURE;
+  }
+  printf("SEI NTP checks passed\n");
+  return EXIT_SUCCESS;
+}